@@ -6,6 +6,7 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "Animations.h"
+#include "LevelSnapshot.h"
 #include "SceneObject.h"
 #include "Scene.h"
 #include "../resloading/TextureResource.h"
@@ -89,6 +90,72 @@ void BaseAnimation::SetCompletionCallback(std::function<void()> completionCallba
     mCompletionCallback = completionCallback;
 }
 
+bool BaseAnimation::WriteSnapshot(SnapshotWriter& writer) const
+{
+    writer.Write(VGetAnimationType());
+    writer.WriteResourceId(mTextureResourceId);
+    writer.WriteResourceId(mMeshResourceId);
+    writer.WriteResourceId(mShaderResourceId);
+    writer.Write(mScale);
+    writer.Write(mBodyRenderingEnabled);
+    writer.Write(mPaused);
+    
+    return VWriteSnapshotData(writer);
+}
+
+std::unique_ptr<BaseAnimation> BaseAnimation::CreateFromSnapshot(SnapshotReader& reader)
+{
+    const auto animationType = reader.Read<AnimationType>();
+    const auto textureResourceId = reader.Read<resources::ResourceId>();
+    const auto meshResourceId = reader.Read<resources::ResourceId>();
+    const auto shaderResourceId = reader.Read<resources::ResourceId>();
+    const auto scale = reader.Read<glm::vec3>();
+    const auto bodyRenderingEnabled = reader.Read<bool>();
+    const auto paused = reader.Read<bool>();
+    
+    if (!reader.IsValid())
+    {
+        return nullptr;
+    }
+    
+    // Animations get constructed with placeholder values for their own state, which gets overwritten right after
+    std::unique_ptr<BaseAnimation> animation;
+    switch (animationType)
+    {
+        case AnimationType::SINGLE_FRAME: animation = std::make_unique<SingleFrameAnimation>(textureResourceId, meshResourceId, shaderResourceId, scale, bodyRenderingEnabled); break;
+        case AnimationType::SINGLE_FRAME_WITH_EFFECT_TEXTURE: animation = std::make_unique<SingleFrameAnimationWithEffectTexture>(textureResourceId, 0, meshResourceId, shaderResourceId, scale, bodyRenderingEnabled); break;
+        case AnimationType::MULTI_FRAME: animation = std::make_unique<MultiFrameAnimation>(textureResourceId, meshResourceId, shaderResourceId, scale, 0.0f, 0, bodyRenderingEnabled); break;
+        case AnimationType::VARIABLE_TEXTURED: animation = std::make_unique<VariableTexturedAnimation>(std::vector<resources::ResourceId>{textureResourceId}, meshResourceId, shaderResourceId, scale, bodyRenderingEnabled); break;
+        case AnimationType::PULSING: animation = std::make_unique<PulsingAnimation>(textureResourceId, meshResourceId, shaderResourceId, scale, PulsingAnimation::PulsingMode::PULSE_CONTINUALLY, 0.0f, 0.0f, 0.0f, bodyRenderingEnabled); break;
+        case AnimationType::BEZIER_CURVE_PATH: animation = std::make_unique<BezierCurvePathAnimation>(textureResourceId, meshResourceId, shaderResourceId, scale, math::BezierCurve({}), 0.0f, bodyRenderingEnabled); break;
+        case AnimationType::SHINE: animation = std::make_unique<ShineAnimation>(nullptr, textureResourceId, 0, meshResourceId, shaderResourceId, scale, 0.0f, bodyRenderingEnabled); break;
+        case AnimationType::DISSOLVE: animation = std::make_unique<DissolveAnimation>(nullptr, textureResourceId, 0, meshResourceId, shaderResourceId, scale, 0.0f, bodyRenderingEnabled); break;
+        case AnimationType::PLAYER_SHIELD: animation = std::make_unique<PlayerShieldAnimation>(nullptr, textureResourceId, 0, meshResourceId, shaderResourceId, scale, bodyRenderingEnabled); break;
+        case AnimationType::NEBULA: animation = std::make_unique<NebulaAnimation>(nullptr, textureResourceId, meshResourceId, shaderResourceId, scale, 0.0f, bodyRenderingEnabled); break;
+        case AnimationType::ROTATION: animation = std::make_unique<RotationAnimation>(textureResourceId, meshResourceId, shaderResourceId, scale, RotationAnimation::RotationMode::ROTATE_CONTINUALLY, RotationAnimation::RotationAxis::X, 0.0f, 0.0f, bodyRenderingEnabled); break;
+        default:
+        {
+            Log(LogType::ERROR, "Unexpected animation type %d in snapshot", static_cast<int>(animationType));
+            reader.Invalidate();
+            return nullptr;
+        }
+    }
+    
+    animation->mPaused = paused;
+    animation->VReadSnapshotData(reader);
+    
+    return reader.IsValid() ? std::move(animation) : nullptr;
+}
+
+bool BaseAnimation::VWriteSnapshotData(SnapshotWriter&) const
+{
+    return true;
+}
+
+void BaseAnimation::VReadSnapshotData(SnapshotReader&)
+{
+}
+
 
 ///------------------------------------------------------------------------------------------------
 
@@ -102,6 +169,10 @@ std::unique_ptr<BaseAnimation> SingleFrameAnimation::VClone() const
     return std::make_unique<SingleFrameAnimation>(*this);
 }
 
+BaseAnimation::AnimationType SingleFrameAnimation::VGetAnimationType() const
+{
+    return AnimationType::SINGLE_FRAME;
+}
 
 ///------------------------------------------------------------------------------------------------
 
@@ -121,6 +192,22 @@ resources::ResourceId SingleFrameAnimationWithEffectTexture::VGetCurrentEffectTe
     return mEffectTextureResourceId;
 }
 
+BaseAnimation::AnimationType SingleFrameAnimationWithEffectTexture::VGetAnimationType() const
+{
+    return AnimationType::SINGLE_FRAME_WITH_EFFECT_TEXTURE;
+}
+
+bool SingleFrameAnimationWithEffectTexture::VWriteSnapshotData(SnapshotWriter& writer) const
+{
+    writer.WriteResourceId(mEffectTextureResourceId);
+    return true;
+}
+
+void SingleFrameAnimationWithEffectTexture::VReadSnapshotData(SnapshotReader& reader)
+{
+    mEffectTextureResourceId = reader.Read<resources::ResourceId>();
+}
+
 ///------------------------------------------------------------------------------------------------
 
 MultiFrameAnimation::MultiFrameAnimation(const resources::ResourceId textureResourceId, const resources::ResourceId meshResourceId, const resources::ResourceId shaderResourceId, const glm::vec3& scale, const float duration, const int textureSheetRow, const bool bodyRenderingEnabled)
@@ -165,6 +252,33 @@ float MultiFrameAnimation::VGetDurationMillis() const
     return mDuration;
 }
 
+BaseAnimation::AnimationType MultiFrameAnimation::VGetAnimationType() const
+{
+    return AnimationType::MULTI_FRAME;
+}
+
+bool MultiFrameAnimation::VWriteSnapshotData(SnapshotWriter& writer) const
+{
+    writer.Write(mDuration);
+    writer.Write(mAnimationTime);
+    writer.Write(mAnimationIndex);
+    writer.Write(mTextureSheetRow);
+    return true;
+}
+
+void MultiFrameAnimation::VReadSnapshotData(SnapshotReader& reader)
+{
+    mDuration = reader.Read<float>();
+    mAnimationTime = reader.Read<float>();
+    mAnimationIndex = reader.Read<int>();
+    mTextureSheetRow = reader.Read<int>();
+    
+    if (mAnimationIndex < 0 || mTextureSheetRow < 0)
+    {
+        reader.Invalidate();
+    }
+}
+
 ///------------------------------------------------------------------------------------------------
 
 VariableTexturedAnimation::VariableTexturedAnimation(const std::vector<resources::ResourceId>& potentialTextureResourceIds, const resources::ResourceId meshResourceId, const resources::ResourceId shaderResourceId, const glm::vec3& scale, const bool bodyRenderingEnabled)
@@ -178,6 +292,37 @@ std::unique_ptr<BaseAnimation> VariableTexturedAnimation::VClone() const
     return std::make_unique<VariableTexturedAnimation>(mPotentialTextureResourceIds, mMeshResourceId, mShaderResourceId, mScale, mBodyRenderingEnabled);
 }
 
+BaseAnimation::AnimationType VariableTexturedAnimation::VGetAnimationType() const
+{
+    return AnimationType::VARIABLE_TEXTURED;
+}
+
+bool VariableTexturedAnimation::VWriteSnapshotData(SnapshotWriter& writer) const
+{
+    writer.Write(static_cast<uint32_t>(mPotentialTextureResourceIds.size()));
+    for (const auto potentialTextureResourceId: mPotentialTextureResourceIds)
+    {
+        writer.WriteResourceId(potentialTextureResourceId);
+    }
+    return true;
+}
+
+void VariableTexturedAnimation::VReadSnapshotData(SnapshotReader& reader)
+{
+    mPotentialTextureResourceIds.clear();
+    
+    const auto potentialTextureCount = reader.ReadCount(sizeof(resources::ResourceId));
+    for (uint32_t i = 0; i < potentialTextureCount; ++i)
+    {
+        mPotentialTextureResourceIds.push_back(reader.Read<resources::ResourceId>());
+    }
+    
+    if (mPotentialTextureResourceIds.empty())
+    {
+        reader.Invalidate();
+    }
+}
+
 ///------------------------------------------------------------------------------------------------
 
 PulsingAnimation::PulsingAnimation(const resources::ResourceId textureResourceId, const resources::ResourceId meshResourceId, const resources::ResourceId shaderResourceId, const glm::vec3& scale, const PulsingMode pulsingMode, const float delayedStartMillis, const float pulsingSpeed, const float pulsingEnlargementFactor, const bool bodyRenderingEnabled)
@@ -251,6 +396,36 @@ float PulsingAnimation::VGetDurationMillis() const
     return mPulsingEnlargementFactor;
 }
 
+BaseAnimation::AnimationType PulsingAnimation::VGetAnimationType() const
+{
+    return AnimationType::PULSING;
+}
+
+bool PulsingAnimation::VWriteSnapshotData(SnapshotWriter& writer) const
+{
+    writer.Write(mOriginalScale);
+    writer.Write(mPulsingMode);
+    writer.Write(mDelayedStartMillis);
+    writer.Write(mPulsingSpeed);
+    writer.Write(mPulsingEnlargementFactor);
+    writer.Write(mPulsingDtAccum);
+    writer.Write(mCapturedOriginalScale);
+    writer.Write(mSignHasBeenReversed);
+    return true;
+}
+
+void PulsingAnimation::VReadSnapshotData(SnapshotReader& reader)
+{
+    mOriginalScale = reader.Read<glm::vec3>();
+    mPulsingMode = reader.Read<PulsingMode>();
+    mDelayedStartMillis = reader.Read<float>();
+    mPulsingSpeed = reader.Read<float>();
+    mPulsingEnlargementFactor = reader.Read<float>();
+    mPulsingDtAccum = reader.Read<float>();
+    mCapturedOriginalScale = reader.Read<bool>();
+    mSignHasBeenReversed = reader.Read<bool>();
+}
+
 ///------------------------------------------------------------------------------------------------
 
 BezierCurvePathAnimation::BezierCurvePathAnimation(const resources::ResourceId textureResourceId, const resources::ResourceId meshResourceId, const resources::ResourceId shaderResourceId, const glm::vec3& scale, const math::BezierCurve& pathCurve, const float curveTraversalSpeed, const bool bodyRenderingEnabled)
@@ -291,6 +466,45 @@ float BezierCurvePathAnimation::VGetCurveTraversalProgress() const
     return mCurveTraversalProgress;
 }
 
+BaseAnimation::AnimationType BezierCurvePathAnimation::VGetAnimationType() const
+{
+    return AnimationType::BEZIER_CURVE_PATH;
+}
+
+bool BezierCurvePathAnimation::VWriteSnapshotData(SnapshotWriter& writer) const
+{
+    const auto& controlPoints = mPathCurve.GetControlPoints();
+    writer.Write(static_cast<uint32_t>(controlPoints.size()));
+    for (const auto& controlPoint: controlPoints)
+    {
+        writer.Write(controlPoint);
+    }
+    
+    writer.Write(mCurveTraversalSpeed);
+    writer.Write(mCurveTraversalProgress);
+    return true;
+}
+
+void BezierCurvePathAnimation::VReadSnapshotData(SnapshotReader& reader)
+{
+    std::vector<glm::vec3> controlPoints;
+    
+    const auto controlPointCount = reader.ReadCount(sizeof(glm::vec3));
+    for (uint32_t i = 0; i < controlPointCount; ++i)
+    {
+        controlPoints.push_back(reader.Read<glm::vec3>());
+    }
+    
+    mPathCurve = math::BezierCurve(controlPoints);
+    mCurveTraversalSpeed = reader.Read<float>();
+    mCurveTraversalProgress = reader.Read<float>();
+    
+    if (controlPoints.empty())
+    {
+        reader.Invalidate();
+    }
+}
+
 ///------------------------------------------------------------------------------------------------
 
 ShineAnimation::ShineAnimation(SceneObject* sceneObject, const resources::ResourceId textureResourceId, const resources::ResourceId shineTextureResourceId, const resources::ResourceId meshResourceId, const resources::ResourceId shaderResourceId, const glm::vec3& scale, const float shineSpeed, const bool bodyRenderingEnabled)
@@ -335,6 +549,26 @@ float ShineAnimation::VGetDurationMillis() const
     return math::Abs(game_constants::SHINE_EFFECT_X_OFFSET_END_VAL - game_constants::SHINE_EFFECT_X_OFFSET_INIT_VAL)/mShineSpeed;
 }
 
+BaseAnimation::AnimationType ShineAnimation::VGetAnimationType() const
+{
+    return AnimationType::SHINE;
+}
+
+bool ShineAnimation::VWriteSnapshotData(SnapshotWriter& writer) const
+{
+    writer.WriteResourceId(mShineTextureResourceId);
+    writer.Write(mShineSpeed);
+    writer.Write(mShineXOffset);
+    return true;
+}
+
+void ShineAnimation::VReadSnapshotData(SnapshotReader& reader)
+{
+    mShineTextureResourceId = reader.Read<resources::ResourceId>();
+    mShineSpeed = reader.Read<float>();
+    mShineXOffset = reader.Read<float>();
+}
+
 ///------------------------------------------------------------------------------------------------
 
 DissolveAnimation::DissolveAnimation(SceneObject* sceneObject, const resources::ResourceId textureResourceId, const resources::ResourceId dissolveTextureResourceId, const resources::ResourceId meshResourceId, const resources::ResourceId shaderResourceId, const glm::vec3& scale, const float dissolveSpeed, const bool bodyRenderingEnabled)
@@ -370,6 +604,26 @@ float DissolveAnimation::VGetDurationMillis() const
     return game_constants::DISSOLVE_EFFECT_Y_INIT_VAL/mDissolveSpeed;
 }
 
+BaseAnimation::AnimationType DissolveAnimation::VGetAnimationType() const
+{
+    return AnimationType::DISSOLVE;
+}
+
+bool DissolveAnimation::VWriteSnapshotData(SnapshotWriter& writer) const
+{
+    writer.WriteResourceId(mDissolveTextureResourceId);
+    writer.Write(mDissolveSpeed);
+    writer.Write(mDissolveYOffset);
+    return true;
+}
+
+void DissolveAnimation::VReadSnapshotData(SnapshotReader& reader)
+{
+    mDissolveTextureResourceId = reader.Read<resources::ResourceId>();
+    mDissolveSpeed = reader.Read<float>();
+    mDissolveYOffset = reader.Read<float>();
+}
+
 ///------------------------------------------------------------------------------------------------
 
 PlayerShieldAnimation::PlayerShieldAnimation(SceneObject* sceneObject, const resources::ResourceId textureResourceId, const resources::ResourceId alphaMapTextureResourceId, const resources::ResourceId meshResourceId, const resources::ResourceId shaderResourceId, const glm::vec3& scale, const bool bodyRenderingEnabled)
@@ -439,6 +693,24 @@ resources::ResourceId PlayerShieldAnimation::VGetCurrentEffectTextureResourceId(
     return mAlphaMapTextureResourceId;
 }
 
+BaseAnimation::AnimationType PlayerShieldAnimation::VGetAnimationType() const
+{
+    return AnimationType::PLAYER_SHIELD;
+}
+
+bool PlayerShieldAnimation::VWriteSnapshotData(SnapshotWriter& writer) const
+{
+    writer.WriteResourceId(mAlphaMapTextureResourceId);
+    writer.Write(mDisolvingInProgress);
+    return true;
+}
+
+void PlayerShieldAnimation::VReadSnapshotData(SnapshotReader& reader)
+{
+    mAlphaMapTextureResourceId = reader.Read<resources::ResourceId>();
+    mDisolvingInProgress = reader.Read<bool>();
+}
+
 ///------------------------------------------------------------------------------------------------
 
 NebulaAnimation::NebulaAnimation(SceneObject* sceneObject, const resources::ResourceId noiseTextureResourceId, const resources::ResourceId meshResourceId, const resources::ResourceId shaderResourceId, const glm::vec3& scale, const float noiseMovementSpeed, const bool bodyRenderingEnabled)
@@ -466,6 +738,24 @@ void NebulaAnimation::VUpdate(const float dtMillis, SceneObject& sceneObject)
     sceneObject.mShaderFloatUniformValues[game_constants::TEXTURE_OFFSET_Y_UNIFORM_NAME] += dtMillis * mNoiseMovementDirection.y * game_constants::NEBULA_ANIMATION_SPEED;
 }
 
+BaseAnimation::AnimationType NebulaAnimation::VGetAnimationType() const
+{
+    return AnimationType::NEBULA;
+}
+
+bool NebulaAnimation::VWriteSnapshotData(SnapshotWriter& writer) const
+{
+    writer.Write(mNoiseMovementDirection);
+    writer.Write(mNoiseMovementSpeed);
+    return true;
+}
+
+void NebulaAnimation::VReadSnapshotData(SnapshotReader& reader)
+{
+    mNoiseMovementDirection = reader.Read<glm::vec2>();
+    mNoiseMovementSpeed = reader.Read<float>();
+}
+
 ///------------------------------------------------------------------------------------------------
 
 RotationAnimation::RotationAnimation(const resources::ResourceId textureResourceId, const resources::ResourceId meshResourceId, const resources::ResourceId shaderResourceId, const glm::vec3& scale, const RotationMode rotationMode, const RotationAxis rotationAxis, const float rotationDegrees, const float rotationSpeed, const bool bodyRenderingEnabled)
@@ -549,6 +839,36 @@ void RotationAnimation::OnSingleRotationFinished()
     mFinishedRotationOnce = true;
 }
 
+BaseAnimation::AnimationType RotationAnimation::VGetAnimationType() const
+{
+    return AnimationType::ROTATION;
+}
+
+bool RotationAnimation::VWriteSnapshotData(SnapshotWriter& writer) const
+{
+    writer.Write(mRotationMode);
+    writer.Write(mRotationAxis);
+    writer.Write(mRotationRadians);
+    writer.Write(mPreviousRotationRadians);
+    writer.Write(mRotationSpeed);
+    writer.Write(mRotationDtAccum);
+    writer.Write(mLeftHandRotation);
+    writer.Write(mFinishedRotationOnce);
+    return true;
+}
+
+void RotationAnimation::VReadSnapshotData(SnapshotReader& reader)
+{
+    mRotationMode = reader.Read<RotationMode>();
+    mRotationAxis = reader.Read<RotationAxis>();
+    mRotationRadians = reader.Read<float>();
+    mPreviousRotationRadians = reader.Read<float>();
+    mRotationSpeed = reader.Read<float>();
+    mRotationDtAccum = reader.Read<float>();
+    mLeftHandRotation = reader.Read<bool>();
+    mFinishedRotationOnce = reader.Read<bool>();
+}
+
 ///------------------------------------------------------------------------------------------------
 
 static const int HEALTH_PARTICLES_COUNT = 18;
@@ -603,7 +923,8 @@ HealthUpParticlesAnimation::HealthUpParticlesAnimation(Scene& scene, const glm::
 
 std::unique_ptr<BaseAnimation> HealthUpParticlesAnimation::VClone() const
 {
-    return std::make_unique<HealthUpParticlesAnimation>(*this);
+    // The particle flows capture the animation itself (and can't be copied anyway), so clones start over
+    return std::make_unique<HealthUpParticlesAnimation>(mScene, mOriginPosition);
 }
 
 void HealthUpParticlesAnimation::VUpdate(const float dtMillis, SceneObject& sceneObject)
@@ -644,4 +965,15 @@ float HealthUpParticlesAnimation::VGetDurationMillis() const
     return ANIMATION_DURATION;
 }
 
+BaseAnimation::AnimationType HealthUpParticlesAnimation::VGetAnimationType() const
+{
+    return AnimationType::HEALTH_UP_PARTICLES;
+}
+
+bool HealthUpParticlesAnimation::VWriteSnapshotData(SnapshotWriter&) const
+{
+    // The particles are driven by flows of the animation itself, which can't be captured
+    return false;
+}
+
 ///------------------------------------------------------------------------------------------------
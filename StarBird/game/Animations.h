@@ -23,6 +23,8 @@
 
 class Scene;
 class SceneObject;
+class SnapshotReader;
+class SnapshotWriter;
 class BaseAnimation
 {
 public:
@@ -45,6 +47,36 @@ public:
     void ChangeShaderResourceId(const resources::ResourceId shaderResourceId);
     void SetCompletionCallback(std::function<void()> completionCallback);
     
+    /// Writes the animation's type and full state for it to be recreated through CreateFromSnapshot.
+    /// Completion callbacks are not captured and need to be reattached by the animation's owner.
+    /// @returns false for animations that can't be captured.
+    bool WriteSnapshot(SnapshotWriter& writer) const;
+    
+    /// Recreates an animation written by WriteSnapshot.
+    /// @returns the animation, or nullptr if the snapshot data is invalid.
+    static std::unique_ptr<BaseAnimation> CreateFromSnapshot(SnapshotReader& reader);
+    
+protected:
+    enum class AnimationType : uint8_t
+    {
+        SINGLE_FRAME,
+        SINGLE_FRAME_WITH_EFFECT_TEXTURE,
+        MULTI_FRAME,
+        VARIABLE_TEXTURED,
+        PULSING,
+        BEZIER_CURVE_PATH,
+        SHINE,
+        DISSOLVE,
+        PLAYER_SHIELD,
+        NEBULA,
+        ROTATION,
+        HEALTH_UP_PARTICLES
+    };
+    
+    virtual AnimationType VGetAnimationType() const = 0;
+    virtual bool VWriteSnapshotData(SnapshotWriter& writer) const;
+    virtual void VReadSnapshotData(SnapshotReader& reader);
+    
 protected:
     resources::ResourceId mTextureResourceId;
     resources::ResourceId mMeshResourceId;
@@ -63,6 +95,9 @@ public:
     SingleFrameAnimation(const resources::ResourceId textureResourceId, const resources::ResourceId meshResourceId, const resources::ResourceId shaderResourceId, const glm::vec3& scale, const bool bodyRenderingEnabled);
     
     std::unique_ptr<BaseAnimation> VClone() const override;
+    
+protected:
+    AnimationType VGetAnimationType() const override;
 };
 
 ///------------------------------------------------------------------------------------------------
@@ -75,6 +110,11 @@ public:
     std::unique_ptr<BaseAnimation> VClone() const override;
     resources::ResourceId VGetCurrentEffectTextureResourceId() const override;
     
+protected:
+    AnimationType VGetAnimationType() const override;
+    bool VWriteSnapshotData(SnapshotWriter& writer) const override;
+    void VReadSnapshotData(SnapshotReader& reader) override;
+    
 private:
     resources::ResourceId mEffectTextureResourceId;
 };
@@ -90,6 +130,11 @@ public:
     void VUpdate(const float dtMillis, SceneObject& sceneObject) override;
     float VGetDurationMillis() const override;
     
+protected:
+    AnimationType VGetAnimationType() const override;
+    bool VWriteSnapshotData(SnapshotWriter& writer) const override;
+    void VReadSnapshotData(SnapshotReader& reader) override;
+    
 private:
     float mDuration;
     float mAnimationTime;
@@ -106,6 +151,11 @@ public:
     
     std::unique_ptr<BaseAnimation> VClone() const override;
     
+protected:
+    AnimationType VGetAnimationType() const override;
+    bool VWriteSnapshotData(SnapshotWriter& writer) const override;
+    void VReadSnapshotData(SnapshotReader& reader) override;
+    
 private:
     std::vector<resources::ResourceId> mPotentialTextureResourceIds;
 };
@@ -127,6 +177,11 @@ public:
 
     float VGetDurationMillis() const override;
     
+protected:
+    AnimationType VGetAnimationType() const override;
+    bool VWriteSnapshotData(SnapshotWriter& writer) const override;
+    void VReadSnapshotData(SnapshotReader& reader) override;
+    
 private:
     glm::vec3 mOriginalScale;
     PulsingMode mPulsingMode;
@@ -150,6 +205,11 @@ public:
     float VGetDurationMillis() const override;
     float VGetCurveTraversalProgress() const;
     
+protected:
+    AnimationType VGetAnimationType() const override;
+    bool VWriteSnapshotData(SnapshotWriter& writer) const override;
+    void VReadSnapshotData(SnapshotReader& reader) override;
+    
 private:
     math::BezierCurve mPathCurve;
     float mCurveTraversalSpeed;
@@ -168,6 +228,11 @@ public:
     resources::ResourceId VGetCurrentEffectTextureResourceId() const override;
     float VGetDurationMillis() const override;
     
+protected:
+    AnimationType VGetAnimationType() const override;
+    bool VWriteSnapshotData(SnapshotWriter& writer) const override;
+    void VReadSnapshotData(SnapshotReader& reader) override;
+    
 private:
     resources::ResourceId mShineTextureResourceId;
     float mShineSpeed;
@@ -186,6 +251,11 @@ public:
     resources::ResourceId VGetCurrentEffectTextureResourceId() const override;
     float VGetDurationMillis() const override;
     
+protected:
+    AnimationType VGetAnimationType() const override;
+    bool VWriteSnapshotData(SnapshotWriter& writer) const override;
+    void VReadSnapshotData(SnapshotReader& reader) override;
+    
 private:
     resources::ResourceId mDissolveTextureResourceId;
     float mDissolveSpeed;
@@ -206,6 +276,11 @@ public:
     void VResume() override;
     resources::ResourceId VGetCurrentEffectTextureResourceId() const override;
     
+protected:
+    AnimationType VGetAnimationType() const override;
+    bool VWriteSnapshotData(SnapshotWriter& writer) const override;
+    void VReadSnapshotData(SnapshotReader& reader) override;
+    
 private:
     resources::ResourceId mAlphaMapTextureResourceId;
     bool mDisolvingInProgress;
@@ -221,6 +296,11 @@ public:
     std::unique_ptr<BaseAnimation> VClone() const override;
     void VUpdate(const float dtMillis, SceneObject& sceneObject) override;
     
+protected:
+    AnimationType VGetAnimationType() const override;
+    bool VWriteSnapshotData(SnapshotWriter& writer) const override;
+    void VReadSnapshotData(SnapshotReader& reader) override;
+    
 private:
     glm::vec2 mNoiseMovementDirection;
     float mNoiseMovementSpeed;
@@ -249,6 +329,11 @@ public:
     void VUpdate(const float dtMillis, SceneObject& sceneObject) override;
     float VGetDurationMillis() const override;
     
+protected:
+    AnimationType VGetAnimationType() const override;
+    bool VWriteSnapshotData(SnapshotWriter& writer) const override;
+    void VReadSnapshotData(SnapshotReader& reader) override;
+    
 private:
     void OnSingleRotationFinished();
     
@@ -275,6 +360,10 @@ public:
     void VUpdate(const float dtMillis, SceneObject& sceneObject) override;
     float VGetDurationMillis() const override;
     
+protected:
+    AnimationType VGetAnimationType() const override;
+    bool VWriteSnapshotData(SnapshotWriter& writer) const override;
+    
 private:
     Scene& mScene;
     glm::vec3 mOriginPosition;
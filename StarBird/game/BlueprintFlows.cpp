@@ -11,7 +11,7 @@
 #include "Sounds.h"
 #include "ObjectTypeDefinitionRepository.h"
 #include "GameConstants.h"
-#include "GameSingletons.h"
+#include "GameContext.h"
 #include "PhysicsConstants.h"
 #include "../utils/ObjectiveCUtils.h"
 
@@ -22,7 +22,7 @@ namespace blueprint_flows
 
 ///------------------------------------------------------------------------------------------------
 
-static void CreateBulletAtPosition(const strutils::StringId& bulletType, const glm::vec3& position, Scene& scene, b2World& box2dWorld)
+static void CreateBulletAtPosition(const strutils::StringId& bulletType, const glm::vec3& position, Scene& scene)
 {
     auto bulletDefOpt = ObjectTypeDefinitionRepository::GetInstance().GetObjectTypeDefinition(bulletType);
     if (bulletDefOpt)
@@ -30,28 +30,23 @@ static void CreateBulletAtPosition(const strutils::StringId& bulletType, const g
         auto& bulletDef = bulletDefOpt->get();
         auto bulletPos = position;
         bulletPos.z = game_constants::BULLET_Z;
-        scene.AddSceneObject(scene_object_utils::CreateSceneObjectWithBody(bulletDef, position, box2dWorld, strutils::StringId()));
+        scene.AddSceneObject(scene_object_utils::CreateSceneObjectWithProjectile(bulletDef, position, scene.GetProjectileSystem()));
         objectiveC_utils::PlaySound(sounds::BULLET_SFX);
     }
 }
 
 ///------------------------------------------------------------------------------------------------
 
-void CreatePlayerBulletFlow(std::vector<RepeatableFlow>& flows, Scene& scene, b2World& box2dWorld, const std::unordered_set<strutils::StringId, strutils::StringIdHasher> blacklistedUpgradeFlows /* = {} */)
+RepeatableFlow CreatePlayerBulletFlow(Scene& scene, const std::unordered_set<strutils::StringId, strutils::StringIdHasher> blacklistedUpgradeFlows /* = {} */)
 {
-    if (!flows.empty())
-    {
-        flows.erase(std::find_if(flows.begin(), flows.end(), [](const RepeatableFlow& flow){ return flow.GetName() == game_constants::PLAYER_BULLET_FLOW_NAME; }));
-    }
-    
-    flows.emplace_back([&, blacklistedUpgradeFlows]()
+    return RepeatableFlow([&scene, blacklistedUpgradeFlows]()
     {
-        bool hasDoubleBulletUpgrade = GameSingletons::HasEquippedUpgrade(game_constants::DOUBLE_BULLET_UGPRADE_NAME) && blacklistedUpgradeFlows.count(game_constants::DOUBLE_BULLET_UGPRADE_NAME) == 0;
+        bool hasDoubleBulletUpgrade = scene.GetGameContext().HasEquippedUpgrade(game_constants::DOUBLE_BULLET_UGPRADE_NAME) && blacklistedUpgradeFlows.count(game_constants::DOUBLE_BULLET_UGPRADE_NAME) == 0;
         
-        bool hasMirrorImageUpgrade = GameSingletons::HasEquippedUpgrade(game_constants::MIRROR_IMAGE_UGPRADE_NAME) && blacklistedUpgradeFlows.count(game_constants::MIRROR_IMAGE_UGPRADE_NAME) == 0;
+        bool hasMirrorImageUpgrade = scene.GetGameContext().HasEquippedUpgrade(game_constants::MIRROR_IMAGE_UGPRADE_NAME) && blacklistedUpgradeFlows.count(game_constants::MIRROR_IMAGE_UGPRADE_NAME) == 0;
 
         auto playerOpt = scene.GetSceneObject(game_constants::PLAYER_SCENE_OBJECT_NAME);
-        if (playerOpt && GameSingletons::GetPlayerCurrentHealth() > 0.0f)
+        if (playerOpt && scene.GetGameContext().GetPlayerCurrentHealth() > 0.0f)
         {
             if (hasDoubleBulletUpgrade)
             {
@@ -59,11 +54,11 @@ void CreatePlayerBulletFlow(std::vector<RepeatableFlow>& flows, Scene& scene, b2
 
                 // Left Bullet
                 bulletPosition.x -= game_constants::PLAYER_BULLET_X_OFFSET;
-                CreateBulletAtPosition(game_constants::PLAYER_BULLET_TYPE, bulletPosition, scene, box2dWorld);
+                CreateBulletAtPosition(game_constants::PLAYER_BULLET_TYPE, bulletPosition, scene);
 
                 // Right Bullet
                 bulletPosition.x += 2 * game_constants::PLAYER_BULLET_X_OFFSET;
-                CreateBulletAtPosition(game_constants::PLAYER_BULLET_TYPE, bulletPosition, scene, box2dWorld);
+                CreateBulletAtPosition(game_constants::PLAYER_BULLET_TYPE, bulletPosition, scene);
 
                 if (hasMirrorImageUpgrade)
                 {
@@ -74,26 +69,26 @@ void CreatePlayerBulletFlow(std::vector<RepeatableFlow>& flows, Scene& scene, b2
                     {
                         auto bulletPosition = leftMirrorImageSoOpt->get().mPosition;
                         bulletPosition.x -= game_constants::MIRROR_IMAGE_BULLET_X_OFFSET;
-                        CreateBulletAtPosition(game_constants::MIRROR_IMAGE_BULLET_TYPE, bulletPosition, scene, box2dWorld);
+                        CreateBulletAtPosition(game_constants::MIRROR_IMAGE_BULLET_TYPE, bulletPosition, scene);
 
                         bulletPosition.x += 2 * game_constants::MIRROR_IMAGE_BULLET_X_OFFSET;
-                        CreateBulletAtPosition(game_constants::MIRROR_IMAGE_BULLET_TYPE, bulletPosition, scene, box2dWorld);
+                        CreateBulletAtPosition(game_constants::MIRROR_IMAGE_BULLET_TYPE, bulletPosition, scene);
                     }
 
                     if (rightMirrorImageSoOpt)
                     {
                         auto bulletPosition = rightMirrorImageSoOpt->get().mPosition;
                         bulletPosition.x -= game_constants::MIRROR_IMAGE_BULLET_X_OFFSET;
-                        CreateBulletAtPosition(game_constants::MIRROR_IMAGE_BULLET_TYPE, bulletPosition, scene, box2dWorld);
+                        CreateBulletAtPosition(game_constants::MIRROR_IMAGE_BULLET_TYPE, bulletPosition, scene);
 
                         bulletPosition.x += 2 * game_constants::MIRROR_IMAGE_BULLET_X_OFFSET;
-                        CreateBulletAtPosition(game_constants::MIRROR_IMAGE_BULLET_TYPE, bulletPosition, scene, box2dWorld);
+                        CreateBulletAtPosition(game_constants::MIRROR_IMAGE_BULLET_TYPE, bulletPosition, scene);
                     }
                 }
             }
             else
             {
-                CreateBulletAtPosition(game_constants::PLAYER_BULLET_TYPE, math::Box2dVec2ToGlmVec3(playerOpt->get().mBody->GetWorldCenter()), scene, box2dWorld);
+                CreateBulletAtPosition(game_constants::PLAYER_BULLET_TYPE, math::Box2dVec2ToGlmVec3(playerOpt->get().mBody->GetWorldCenter()), scene);
 
                 if (hasMirrorImageUpgrade)
                 {
@@ -102,17 +97,29 @@ void CreatePlayerBulletFlow(std::vector<RepeatableFlow>& flows, Scene& scene, b2
 
                     if (leftMirrorImageSoOpt)
                     {
-                        CreateBulletAtPosition(game_constants::MIRROR_IMAGE_BULLET_TYPE, leftMirrorImageSoOpt->get().mPosition, scene, box2dWorld);
+                        CreateBulletAtPosition(game_constants::MIRROR_IMAGE_BULLET_TYPE, leftMirrorImageSoOpt->get().mPosition, scene);
                     }
 
                     if (rightMirrorImageSoOpt)
                     {
-                        CreateBulletAtPosition(game_constants::MIRROR_IMAGE_BULLET_TYPE, rightMirrorImageSoOpt->get().mPosition, scene, box2dWorld);
+                        CreateBulletAtPosition(game_constants::MIRROR_IMAGE_BULLET_TYPE, rightMirrorImageSoOpt->get().mPosition, scene);
                     }
                 }
             }
         }
-    }, game_constants::BASE_PLAYER_BULLET_FLOW_DELAY_MILLIS / GameSingletons::GetPlayerBulletSpeedStat(), RepeatableFlow::RepeatPolicy::REPEAT, game_constants::PLAYER_BULLET_FLOW_NAME);
+    }, game_constants::BASE_PLAYER_BULLET_FLOW_DELAY_MILLIS / scene.GetGameContext().GetPlayerBulletSpeedStat(), RepeatableFlow::RepeatPolicy::REPEAT, game_constants::PLAYER_BULLET_FLOW_NAME);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void CreatePlayerBulletFlow(std::vector<RepeatableFlow>& flows, Scene& scene, const std::unordered_set<strutils::StringId, strutils::StringIdHasher> blacklistedUpgradeFlows /* = {} */)
+{
+    if (!flows.empty())
+    {
+        flows.erase(std::find_if(flows.begin(), flows.end(), [](const RepeatableFlow& flow){ return flow.GetName() == game_constants::PLAYER_BULLET_FLOW_NAME; }));
+    }
+    
+    flows.push_back(CreatePlayerBulletFlow(scene, blacklistedUpgradeFlows));
 }
 
 ///------------------------------------------------------------------------------------------------
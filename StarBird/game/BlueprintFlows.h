@@ -18,12 +18,12 @@
 ///------------------------------------------------------------------------------------------------
 
 class Scene;
-class b2World;
 
 namespace blueprint_flows
 {
 
-void CreatePlayerBulletFlow(std::vector<RepeatableFlow>& flows, Scene& scene, b2World& box2dWorld, const std::unordered_set<strutils::StringId, strutils::StringIdHasher> blacklistedUpgradeFlows = {});
+RepeatableFlow CreatePlayerBulletFlow(Scene& scene, const std::unordered_set<strutils::StringId, strutils::StringIdHasher> blacklistedUpgradeFlows = {});
+void CreatePlayerBulletFlow(std::vector<RepeatableFlow>& flows, Scene& scene, const std::unordered_set<strutils::StringId, strutils::StringIdHasher> blacklistedUpgradeFlows = {});
 
 }
 
@@ -14,6 +14,7 @@
 #include "../resloading/ResourceLoadingService.h"
 
 #include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 #include <unordered_set>
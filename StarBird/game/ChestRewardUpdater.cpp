@@ -39,6 +39,7 @@ static const strutils::StringId CONFIRMATION_BUTTON_TEXT_NAME = strutils::String
 static const strutils::StringId UPGRADE_TEXT_NAME = strutils::StringId("UPGRADE_TEXT");
 static const strutils::StringId REWARD_TITLE_NAME = strutils::StringId("REWARD_SCREEN_TITLE");
 static const strutils::StringId OVERLAY_NAME = strutils::StringId("REWARD_OVERLAY");
+static const strutils::StringId REWARD_OBJECTS_CREATION_WORK_NAME = strutils::StringId("chest_reward_objects_creation");
 
 static const glm::vec3 BACKGROUND_POSITION = glm::vec3(0.0f, 0.0f, -7.0f);
 static const glm::vec3 CHEST_BASE_POSITION = glm::vec3(0.0f, -1.576f, -4.20f);
@@ -90,6 +91,7 @@ ChestRewardUpdater::ChestRewardUpdater(Scene& scene, b2World& box2dWorld)
     , mChestPulseValueAccum(0.0f)
     , mChestAnimationTweenValue(0.0f)
     , mChestLightDtAccum(0.0f)
+    , mRewardObjectsCreationWorkHandle(INVALID_WORK_HANDLE)
 {
 #ifdef DEBUG
     mStateMachine.RegisterState<DebugConsoleGameState>();
@@ -143,7 +145,7 @@ ChestRewardUpdater::ChestRewardUpdater(Scene& scene, b2World& box2dWorld)
 
 ChestRewardUpdater::~ChestRewardUpdater()
 {
-    
+    FrameWorkScheduler::GetInstance().CancelWork(mRewardObjectsCreationWorkHandle);
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -237,7 +239,6 @@ PostStateUpdateDirective ChestRewardUpdater::VUpdate(std::vector<SceneObject>& s
                     mScreenOverlayController = std::make_unique<FullScreenOverlayController>(mScene, game_constants::FULL_SCREEN_OVERLAY_MENU_DARKENING_SPEED, game_constants::FULL_SCREEN_OVERLAY_MENU_MAX_ALPHA, true, [&]()
                     {
                         CreateRewardObjects();
-                        mRewardFlowState = RewardFlowState::REWARD_SELECTION;
                     }, nullptr, -1.0f, OVERLAY_NAME, false);
                 }
             }
@@ -513,16 +514,26 @@ void ChestRewardUpdater::CreateRewardObjects()
     
     mScene.AddSceneObject(std::move(rewardScreenTitleSo));
     
-    std::vector<resources::ResourceId> upgradeTextureIds;
-    for (const auto& upgradeEntry: GameSingletons::GetAvailableUpgrades())
+    // The unlocked upgrades' textures are loaded one per step over the next frames, with the
+    // carousel created (and the reward selection started) once they all have been
+    mRewardObjectsCreationWorkHandle = FrameWorkScheduler::GetInstance().SubmitWork(REWARD_OBJECTS_CREATION_WORK_NAME, WorkPriority::NORMAL, [this, upgradeIndex = size_t(0), upgradeTextureIds = std::vector<resources::ResourceId>()]() mutable
     {
-        if (upgradeEntry.mUnlocked)
+        const auto& availableUpgrades = GameSingletons::GetAvailableUpgrades();
+        if (upgradeIndex < availableUpgrades.size())
         {
-            upgradeTextureIds.push_back(resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + upgradeEntry.mTextureFileName));
+            const auto& upgradeEntry = availableUpgrades[upgradeIndex++];
+            if (upgradeEntry.mUnlocked)
+            {
+                upgradeTextureIds.push_back(resources::ResourceLoadingService::GetInstance().LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + upgradeEntry.mTextureFileName));
+            }
+            
+            return WorkStepResult::CONTINUE;
         }
-    }
-    
-    mCarouselController = std::make_unique<CarouselController>(mScene, upgradeTextureIds, [&](){ OnCarouselMovementStart(); }, [&](){ OnCarouselStationary(); }, 0.0f);
+        
+        mCarouselController = std::make_unique<CarouselController>(mScene, upgradeTextureIds, [&](){ OnCarouselMovementStart(); }, [&](){ OnCarouselStationary(); }, 0.0f);
+        mRewardFlowState = RewardFlowState::REWARD_SELECTION;
+        return WorkStepResult::FINISHED;
+    });
 }
 
 ///------------------------------------------------------------------------------------------------
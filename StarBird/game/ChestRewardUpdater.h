@@ -10,6 +10,7 @@
 
 ///------------------------------------------------------------------------------------------------
 
+#include "FrameWorkScheduler.h"
 #include "IUpdater.h"
 #include "UpgradeUnlockedHandler.h"
 #include "StateMachine.h"
@@ -71,6 +72,7 @@ private:
     float mChestPulseValueAccum;
     float mChestAnimationTweenValue;
     float mChestLightDtAccum;
+    WorkHandle mRewardObjectsCreationWorkHandle;
     
     std::unique_ptr<FullScreenOverlayController> mScreenOverlayController;
     std::unique_ptr<CarouselController> mCarouselController;
@@ -404,8 +404,8 @@ void EventUpdater::RegisterEvents()
             {
                 EventOption("Battle", END_STATE_INDEX, [&]()
                 {
-                    level_generation::GenerateLevel(GameSingletons::GetCurrentMapCoord(), { Map::NodeType::HARD_ENCOUNTER, {}, {} });
-                    mScene.ChangeScene(Scene::TransitionParameters(Scene::SceneType::LEVEL, objectiveC_utils::BuildLocalFileSaveLocation(GameSingletons::GetCurrentMapCoord().ToString()), true));
+                    const auto& levelDef = level_generation::GetOrGenerateLevel(GameSingletons::GetCurrentMapCoord(), { Map::NodeType::HARD_ENCOUNTER, {}, {} });
+                    mScene.ChangeScene(Scene::TransitionParameters(Scene::SceneType::LEVEL, levelDef.mLevelName.GetString(), true));
                     mTransitioning = true;
                 })
             },
@@ -0,0 +1,593 @@
+///------------------------------------------------------------------------------------------------
+///  FlowScheduler.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "FlowScheduler.h"
+#include "../utils/Logging.h"
+
+#include <algorithm>
+#include <random>
+#include <SDL.h>
+
+///------------------------------------------------------------------------------------------------
+
+static uint32_t GetNextGeneration(const uint32_t generation)
+{
+    // Generation 0 is skipped, so that no handle ever equals INVALID_FLOW_HANDLE
+    return generation == 0xFFFFFFFF ? 1 : generation + 1;
+}
+
+///------------------------------------------------------------------------------------------------
+
+FlowScheduler::FlowScheduler()
+{
+    mListHeads.fill(NONE);
+}
+
+///------------------------------------------------------------------------------------------------
+
+FlowScheduler::~FlowScheduler()
+{
+    Clear();
+}
+
+///------------------------------------------------------------------------------------------------
+
+FlowHandle FlowScheduler::AddFlow(RepeatableFlow&& flow)
+{
+    const auto expiryMillis = mNowMillis + flow.GetDuration();
+    return AddFlowExpiringAt(std::move(flow), expiryMillis);
+}
+
+///------------------------------------------------------------------------------------------------
+
+FlowHandle FlowScheduler::AddFlowExpiringAt(RepeatableFlow&& flow, const double expiryMillis)
+{
+    uint32_t entryIndex = NONE;
+    if (!mFreeEntries.empty())
+    {
+        entryIndex = mFreeEntries.back();
+        mFreeEntries.pop_back();
+    }
+    else
+    {
+        entryIndex = static_cast<uint32_t>(mEntries.size());
+        mEntries.emplace_back();
+    }
+
+    auto& entry = mEntries[entryIndex];
+    entry.mFlow.emplace(std::move(flow));
+    entry.mExpiryMillis = expiryMillis;
+    entry.mExpiryTick = static_cast<uint64_t>(std::max(0.0, entry.mExpiryMillis));
+    entry.mLastFiringUpdate = 0;
+    Schedule(entryIndex);
+
+    if (!entry.mFlow->GetName().isEmpty())
+    {
+        mEntriesByName[entry.mFlow->GetName()] = entryIndex;
+    }
+
+    mFlowCount++;
+    return (static_cast<FlowHandle>(entry.mGeneration) << 32) | entryIndex;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FlowScheduler::CancelFlow(const FlowHandle flowHandle)
+{
+    const auto entryIndex = GetEntryIndex(flowHandle);
+    if (entryIndex == NONE)
+    {
+        return;
+    }
+
+    // The firing flow is out of the wheel, so just flag it to not be rescheduled
+    if (entryIndex == mFiringEntry)
+    {
+        mEntries[entryIndex].mFlow->ForceFinish();
+        return;
+    }
+
+    Release(entryIndex);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FlowScheduler::CancelFlow(const strutils::StringId& flowName)
+{
+    auto findIter = mEntriesByName.find(flowName);
+    if (findIter != mEntriesByName.end())
+    {
+        const auto& entry = mEntries[findIter->second];
+        CancelFlow((static_cast<FlowHandle>(entry.mGeneration) << 32) | findIter->second);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::optional<std::reference_wrapper<RepeatableFlow>> FlowScheduler::GetFlow(const FlowHandle flowHandle)
+{
+    return GetRunningFlow(GetEntryIndex(flowHandle));
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::optional<std::reference_wrapper<RepeatableFlow>> FlowScheduler::GetFlow(const strutils::StringId& flowName)
+{
+    auto findIter = mEntriesByName.find(flowName);
+    return findIter == mEntriesByName.end() ? std::nullopt : GetRunningFlow(findIter->second);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FlowScheduler::Update(const float dtMillis)
+{
+    mNowMillis += dtMillis;
+    mUpdateCount++;
+    const auto targetTick = static_cast<uint64_t>(std::max(0.0, mNowMillis));
+
+    if (mFlowCount == 0)
+    {
+        mCurrentTick = std::max(mCurrentTick, targetTick);
+        return;
+    }
+
+    // The current tick is revisited on the next update, as flows expiring later within it can't fire yet
+    while (true)
+    {
+        // Going past the end of a level's slots brings the next slot of the level above down
+        // to the levels below (highest level first). Cascading twice for the same tick is a no-op.
+        if ((mCurrentTick & (SLOT_COUNT - 1)) == 0)
+        {
+            for (uint32_t level = LEVEL_COUNT - 1; level > 0; --level)
+            {
+                const auto levelShift = level * SLOT_BITS;
+                if ((mCurrentTick & ((1ULL << levelShift) - 1)) == 0)
+                {
+                    Cascade(level * SLOT_COUNT + ((mCurrentTick >> levelShift) & (SLOT_COUNT - 1)));
+                }
+            }
+        }
+
+        FireExpiringFlows(static_cast<uint32_t>(mCurrentTick & (SLOT_COUNT - 1)));
+
+        if (mCurrentTick >= targetTick)
+        {
+            break;
+        }
+
+        mCurrentTick++;
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FlowScheduler::ForEachRunningFlow(const std::function<void(const RepeatableFlow&, const double expiryMillis)>& visitor) const
+{
+    for (const auto& entry: mEntries)
+    {
+        if (entry.mFlow && entry.mFlow->IsRunning())
+        {
+            visitor(*entry.mFlow, entry.mExpiryMillis);
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FlowScheduler::Reset(const double nowMillis)
+{
+    Clear();
+    mNowMillis = nowMillis;
+    mCurrentTick = static_cast<uint64_t>(std::max(0.0, nowMillis));
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FlowScheduler::Clear()
+{
+    // Entries are kept around rather than cleared, so that their generations keep counting up
+    // and handles to the dropped flows can't match flows scheduled in the same entries later on
+    mFreeEntries.clear();
+    for (auto entryIndex = static_cast<uint32_t>(mEntries.size()); entryIndex-- > 0;)
+    {
+        auto& entry = mEntries[entryIndex];
+        if (entry.mFlow)
+        {
+            entry.mFlow.reset();
+            entry.mGeneration = GetNextGeneration(entry.mGeneration);
+        }
+        
+        entry.mList = NONE;
+        entry.mPrev = NONE;
+        entry.mNext = NONE;
+        mFreeEntries.push_back(entryIndex);
+    }
+    
+    mListHeads.fill(NONE);
+    mEntriesByName.clear();
+    mFlowCount = 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t FlowScheduler::GetFlowCount() const
+{
+    return mFlowCount;
+}
+
+///------------------------------------------------------------------------------------------------
+
+double FlowScheduler::GetNowMillis() const
+{
+    return mNowMillis;
+}
+
+///------------------------------------------------------------------------------------------------
+
+uint32_t FlowScheduler::GetEntryIndex(const FlowHandle flowHandle) const
+{
+    const auto entryIndex = static_cast<uint32_t>(flowHandle & 0xFFFFFFFF);
+    const auto generation = static_cast<uint32_t>(flowHandle >> 32);
+
+    if (flowHandle == INVALID_FLOW_HANDLE || entryIndex >= mEntries.size() || mEntries[entryIndex].mGeneration != generation || !mEntries[entryIndex].mFlow)
+    {
+        return NONE;
+    }
+
+    return entryIndex;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::optional<std::reference_wrapper<RepeatableFlow>> FlowScheduler::GetRunningFlow(const uint32_t entryIndex)
+{
+    if (entryIndex == NONE)
+    {
+        return std::nullopt;
+    }
+
+    auto& entry = mEntries[entryIndex];
+    if (!entry.mFlow->IsRunning())
+    {
+        if (entryIndex != mFiringEntry)
+        {
+            Release(entryIndex);
+        }
+        return std::nullopt;
+    }
+
+    // Timers aren't ticked, so this is the only place their ticks left need to be brought up to date
+    entry.mFlow->mTicksLeft = static_cast<float>(entry.mExpiryMillis - mNowMillis);
+    return std::optional<std::reference_wrapper<RepeatableFlow>>{*entry.mFlow};
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FlowScheduler::Schedule(const uint32_t entryIndex)
+{
+    const auto expiryTick = std::max(mEntries[entryIndex].mExpiryTick, mCurrentTick);
+
+    // A flow goes in the lowest level whose slots (along with the current tick) cover its expiry.
+    // Flows further away than the top level can cover are parked in it, and rescheduled when cascaded.
+    for (uint32_t level = 0; level < LEVEL_COUNT; ++level)
+    {
+        const auto levelShift = level * SLOT_BITS;
+        if (level == LEVEL_COUNT - 1 || (expiryTick >> (levelShift + SLOT_BITS)) == (mCurrentTick >> (levelShift + SLOT_BITS)))
+        {
+            Link(entryIndex, level * SLOT_COUNT + static_cast<uint32_t>((expiryTick >> levelShift) & (SLOT_COUNT - 1)));
+            return;
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FlowScheduler::Link(const uint32_t entryIndex, const uint32_t list)
+{
+    auto& entry = mEntries[entryIndex];
+    entry.mList = list;
+    entry.mPrev = NONE;
+    entry.mNext = mListHeads[list];
+
+    if (entry.mNext != NONE)
+    {
+        mEntries[entry.mNext].mPrev = entryIndex;
+    }
+
+    mListHeads[list] = entryIndex;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FlowScheduler::Unlink(const uint32_t entryIndex)
+{
+    auto& entry = mEntries[entryIndex];
+    if (entry.mList == NONE)
+    {
+        return;
+    }
+
+    if (entry.mPrev != NONE)
+    {
+        mEntries[entry.mPrev].mNext = entry.mNext;
+    }
+    else
+    {
+        mListHeads[entry.mList] = entry.mNext;
+    }
+
+    if (entry.mNext != NONE)
+    {
+        mEntries[entry.mNext].mPrev = entry.mPrev;
+    }
+
+    entry.mList = NONE;
+    entry.mPrev = NONE;
+    entry.mNext = NONE;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FlowScheduler::Release(const uint32_t entryIndex)
+{
+    Unlink(entryIndex);
+
+    auto& entry = mEntries[entryIndex];
+
+    auto nameIter = mEntriesByName.find(entry.mFlow->GetName());
+    if (nameIter != mEntriesByName.end() && nameIter->second == entryIndex)
+    {
+        mEntriesByName.erase(nameIter);
+    }
+
+    // Bumping the generation invalidates any outstanding handles to the entry
+    entry.mFlow.reset();
+    entry.mGeneration = GetNextGeneration(entry.mGeneration);
+    mFreeEntries.push_back(entryIndex);
+    mFlowCount--;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FlowScheduler::Cascade(const uint32_t list)
+{
+    auto entryIndex = mListHeads[list];
+    mListHeads[list] = NONE;
+
+    while (entryIndex != NONE)
+    {
+        auto& entry = mEntries[entryIndex];
+        const auto nextEntryIndex = entry.mNext;
+
+        entry.mList = NONE;
+        Schedule(entryIndex);
+
+        entryIndex = nextEntryIndex;
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FlowScheduler::FireExpiringFlows(const uint32_t list)
+{
+    if (mListHeads[list] == NONE)
+    {
+        return;
+    }
+
+    // The slot's flows are moved to a list of their own first, so that flows scheduled
+    // (or rescheduled) by the callbacks, which can land in this same slot, wait for the next update
+    for (auto entryIndex = mListHeads[list]; entryIndex != NONE; entryIndex = mEntries[entryIndex].mNext)
+    {
+        mEntries[entryIndex].mList = FIRING_LIST;
+    }
+    mListHeads[FIRING_LIST] = mListHeads[list];
+    mListHeads[list] = NONE;
+
+    // Callbacks are free to cancel any flow, so entries are popped off the list one at a time
+    while (mListHeads[FIRING_LIST] != NONE)
+    {
+        const auto entryIndex = mListHeads[FIRING_LIST];
+        Unlink(entryIndex);
+
+        auto& entry = mEntries[entryIndex];
+        auto& flow = *entry.mFlow;
+
+        if (!flow.IsRunning())
+        {
+            Release(entryIndex);
+            continue;
+        }
+
+        // Flows expiring later in the current tick wait, and so do (zero duration) flows that already fired this update
+        if (entry.mExpiryMillis > mNowMillis || entry.mLastFiringUpdate == mUpdateCount)
+        {
+            Link(entryIndex, list);
+            continue;
+        }
+
+        mFiringEntry = entryIndex;
+        entry.mLastFiringUpdate = mUpdateCount;
+        flow.mTicksLeft = 0.0f;
+        flow.mCallback();
+        mFiringEntry = NONE;
+
+        if (flow.IsRunning() && flow.mRepeatPolicy == RepeatableFlow::RepeatPolicy::REPEAT)
+        {
+            flow.mTicksLeft = flow.mTargetDuration;
+            entry.mExpiryMillis = mNowMillis + flow.mTargetDuration;
+            entry.mExpiryTick = static_cast<uint64_t>(std::max(0.0, entry.mExpiryMillis));
+            Schedule(entryIndex);
+        }
+        else
+        {
+            flow.ForceFinish();
+            Release(entryIndex);
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+namespace flow_scheduling
+{
+
+///------------------------------------------------------------------------------------------------
+
+static const float BENCHMARK_FRAME_MILLIS = 1000.0f/60.0f;
+static const float BENCHMARK_MIN_FLOW_DURATION_MILLIS = 100.0f;
+static const float BENCHMARK_MAX_FLOW_DURATION_MILLIS = 3000.0f;
+static const int BENCHMARK_LOOKUPS_PER_FRAME = 64;
+static const unsigned int BENCHMARK_SEED = 1337;
+
+///------------------------------------------------------------------------------------------------
+
+std::vector<std::string> BenchmarkFlowScheduling(const int flowCount, const int frameCount)
+{
+    // Replica of RepeatableFlow as it used to be run by LevelUpdater: a std::function callback
+    // ticked every frame, with finished flows erased and lookups searching by name
+    struct LegacyFlow
+    {
+        std::function<void()> mCallback;
+        float mTargetDuration;
+        float mTicksLeft;
+        bool mRepeating;
+        bool mIsRunning;
+        strutils::StringId mName;
+    };
+
+    std::vector<strutils::StringId> flowNames;
+    std::vector<float> flowDurations;
+    std::mt19937 flowRng(BENCHMARK_SEED);
+    std::uniform_real_distribution<float> durationDistribution(BENCHMARK_MIN_FLOW_DURATION_MILLIS, BENCHMARK_MAX_FLOW_DURATION_MILLIS);
+    for (int i = 0; i < flowCount; ++i)
+    {
+        flowNames.emplace_back("benchmark_flow_" + std::to_string(i));
+        flowDurations.push_back(durationDistribution(flowRng));
+    }
+
+    auto getMillisSince = [](const Uint64 startCounter)
+    {
+        return static_cast<double>(SDL_GetPerformanceCounter() - startCounter) * 1000.0/SDL_GetPerformanceFrequency();
+    };
+
+    // Even flows repeat, while odd ones fire once and get replaced by a fresh one (like the death/crystal
+    // flows), so that the flow count stays the same throughout. Lookups are of repeating flows only.
+    long long legacyFiredCount = 0;
+    int legacyFlowsToReplace = 0;
+    std::vector<LegacyFlow> legacyFlows;
+    legacyFlows.reserve(flowCount);
+
+    auto legacyStartCounter = SDL_GetPerformanceCounter();
+    for (int i = 0; i < flowCount; ++i)
+    {
+        const auto flowName = flowNames[i];
+        legacyFlows.push_back({ [&legacyFiredCount, &legacyFlowsToReplace, flowName, i]()
+        {
+            legacyFiredCount += flowName.isEmpty() ? 0 : 1;
+            legacyFlowsToReplace += i % 2;
+        }, flowDurations[i], flowDurations[i], i % 2 == 0, true, flowNames[i] });
+    }
+    const auto legacySetupMillis = getMillisSince(legacyStartCounter);
+
+    std::mt19937 legacyLookupRng(BENCHMARK_SEED);
+    legacyStartCounter = SDL_GetPerformanceCounter();
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+        for (size_t i = 0; i < legacyFlows.size(); ++i)
+        {
+            auto& flow = legacyFlows[i];
+            if (!flow.mIsRunning) continue;
+
+            flow.mTicksLeft -= BENCHMARK_FRAME_MILLIS;
+            if (flow.mTicksLeft <= 0.0f)
+            {
+                flow.mCallback();
+                if (flow.mRepeating) flow.mTicksLeft = flow.mTargetDuration;
+                else flow.mIsRunning = false;
+            }
+        }
+
+        legacyFlows.erase(std::remove_if(legacyFlows.begin(), legacyFlows.end(), [](const LegacyFlow& flow){ return !flow.mIsRunning; }), legacyFlows.end());
+
+        for (; legacyFlowsToReplace > 0; --legacyFlowsToReplace)
+        {
+            legacyFlows.push_back({ [&legacyFiredCount, &legacyFlowsToReplace, flowName = flowNames[1]]()
+            {
+                legacyFiredCount += flowName.isEmpty() ? 0 : 1;
+                legacyFlowsToReplace++;
+            }, flowDurations[1], flowDurations[1], false, true, strutils::StringId() });
+        }
+
+        for (int i = 0; i < BENCHMARK_LOOKUPS_PER_FRAME; ++i)
+        {
+            const auto& flowName = flowNames[(legacyLookupRng() % ((flowCount + 1)/2)) * 2];
+            auto findIter = std::find_if(legacyFlows.begin(), legacyFlows.end(), [&](const LegacyFlow& flow){ return flow.mName == flowName; });
+            legacyFiredCount -= findIter == legacyFlows.end() ? 1 : 0;
+        }
+    }
+    const auto legacyFrameMillis = getMillisSince(legacyStartCounter)/frameCount;
+
+    long long scheduledFiredCount = 0;
+    int scheduledFlowsToReplace = 0;
+    FlowScheduler flowScheduler;
+
+    auto scheduledStartCounter = SDL_GetPerformanceCounter();
+    for (int i = 0; i < flowCount; ++i)
+    {
+        const auto flowName = flowNames[i];
+        flowScheduler.AddFlow(RepeatableFlow([&scheduledFiredCount, &scheduledFlowsToReplace, flowName, i]()
+        {
+            scheduledFiredCount += flowName.isEmpty() ? 0 : 1;
+            scheduledFlowsToReplace += i % 2;
+        }, flowDurations[i], i % 2 == 0 ? RepeatableFlow::RepeatPolicy::REPEAT : RepeatableFlow::RepeatPolicy::ONCE, flowNames[i]));
+    }
+    const auto scheduledSetupMillis = getMillisSince(scheduledStartCounter);
+
+    std::mt19937 scheduledLookupRng(BENCHMARK_SEED);
+    scheduledStartCounter = SDL_GetPerformanceCounter();
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+        flowScheduler.Update(BENCHMARK_FRAME_MILLIS);
+
+        for (; scheduledFlowsToReplace > 0; --scheduledFlowsToReplace)
+        {
+            flowScheduler.AddFlow(RepeatableFlow([&scheduledFiredCount, &scheduledFlowsToReplace, flowName = flowNames[1]]()
+            {
+                scheduledFiredCount += flowName.isEmpty() ? 0 : 1;
+                scheduledFlowsToReplace++;
+            }, flowDurations[1], RepeatableFlow::RepeatPolicy::ONCE));
+        }
+
+        for (int i = 0; i < BENCHMARK_LOOKUPS_PER_FRAME; ++i)
+        {
+            const auto& flowName = flowNames[(scheduledLookupRng() % ((flowCount + 1)/2)) * 2];
+            scheduledFiredCount -= flowScheduler.GetFlow(flowName) ? 0 : 1;
+        }
+    }
+    const auto scheduledFrameMillis = getMillisSince(scheduledStartCounter)/frameCount;
+
+    std::vector<std::string> results =
+    {
+        "Legacy vector: " + strutils::FloatToString(static_cast<float>(legacyFrameMillis), 4) + " ms/frame (setup " + strutils::FloatToString(static_cast<float>(legacySetupMillis), 4) + " ms, " + std::to_string(legacyFiredCount) + " fired)",
+        "Timer wheel: " + strutils::FloatToString(static_cast<float>(scheduledFrameMillis), 4) + " ms/frame (setup " + strutils::FloatToString(static_cast<float>(scheduledSetupMillis), 4) + " ms, " + std::to_string(scheduledFiredCount) + " fired)",
+        "Speedup: " + strutils::FloatToString(static_cast<float>(legacyFrameMillis/std::max(scheduledFrameMillis, 1e-6)), 2) + "x"
+    };
+
+    for (const auto& result: results)
+    {
+        Log(LogType::INFO, "Flow scheduling benchmark (%d flows, %d frames) %s", flowCount, frameCount, result.c_str());
+    }
+
+    return results;
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
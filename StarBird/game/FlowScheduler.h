@@ -0,0 +1,141 @@
+///------------------------------------------------------------------------------------------------
+///  FlowScheduler.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef FlowScheduler_h
+#define FlowScheduler_h
+
+///------------------------------------------------------------------------------------------------
+
+#include "RepeatableFlow.h"
+#include "../utils/StringUtils.h"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+using FlowHandle = uint64_t;
+inline const FlowHandle INVALID_FLOW_HANDLE = 0;
+
+///------------------------------------------------------------------------------------------------
+
+/// Runs RepeatableFlows off a hierarchical timer wheel (4 levels of 64 slots, at a 1ms resolution)
+/// keyed by their expiry time, rather than ticking every flow's timer every frame. Scheduling and
+/// cancelling a flow are O(1), and so are lookups through handles or flow names, while each update
+/// only visits the flows actually expiring (plus the occasional cascade of a far away slot in to the
+/// lower levels). Flows behave as if ticked by RepeatableFlow::Update, i.e. they fire at most once per
+/// update, and repeating ones are rescheduled a whole duration (as set at the time) after firing.
+class FlowScheduler final
+{
+public:
+    FlowScheduler();
+    ~FlowScheduler();
+    FlowScheduler(const FlowScheduler&) = delete;
+    const FlowScheduler& operator = (const FlowScheduler&) = delete;
+
+    /// Schedules the flow to fire its duration from now. Names are expected to be unique among running
+    /// flows, with a flow scheduled under a name already in use taking the name over.
+    /// @param[in] flow the flow to schedule.
+    /// @returns a handle to the flow, for looking it up or cancelling it.
+    FlowHandle AddFlow(RepeatableFlow&& flow);
+    
+    /// Schedules the flow to fire at the given (scheduler) time instead, e.g. to resume a flow captured in a snapshot.
+    /// @param[in] flow the flow to schedule.
+    /// @param[in] expiryMillis when the flow should fire, in scheduler time (see GetNowMillis).
+    /// @returns a handle to the flow, for looking it up or cancelling it.
+    FlowHandle AddFlowExpiringAt(RepeatableFlow&& flow, const double expiryMillis);
+
+    /// Drops the flow. It's fine to cancel finished flows, invalid handles, or the flow currently firing.
+    void CancelFlow(const FlowHandle flowHandle);
+    void CancelFlow(const strutils::StringId& flowName);
+
+    /// Looks up a running flow. Force finished flows are no longer found (and get dropped on lookup).
+    /// References returned stay valid until the flow is dropped.
+    std::optional<std::reference_wrapper<RepeatableFlow>> GetFlow(const FlowHandle flowHandle);
+    std::optional<std::reference_wrapper<RepeatableFlow>> GetFlow(const strutils::StringId& flowName);
+
+    /// Advances time and fires all the flows that expire in the meantime.
+    void Update(const float dtMillis);
+
+    /// Visits all running flows, along with the (scheduler) time they expire at, in a stable order.
+    void ForEachRunningFlow(const std::function<void(const RepeatableFlow&, const double expiryMillis)>& visitor) const;
+    
+    /// Drops all flows and rewinds (or fast forwards) the scheduler's clock to the given time.
+    void Reset(const double nowMillis);
+    
+    void Clear();
+    size_t GetFlowCount() const;
+    double GetNowMillis() const;
+
+private:
+    static constexpr int SLOT_BITS = 6;
+    static constexpr uint32_t SLOT_COUNT = 1 << SLOT_BITS;
+    static constexpr uint32_t LEVEL_COUNT = 4;
+    static constexpr uint32_t FIRING_LIST = LEVEL_COUNT * SLOT_COUNT;
+    static constexpr uint32_t LIST_COUNT = FIRING_LIST + 1;
+    static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+    struct FlowEntry
+    {
+        std::optional<RepeatableFlow> mFlow;
+        double mExpiryMillis = 0.0;
+        uint64_t mExpiryTick = 0;
+        uint64_t mLastFiringUpdate = 0;
+        uint32_t mGeneration = 1;
+        uint32_t mPrev = NONE;
+        uint32_t mNext = NONE;
+        uint32_t mList = NONE;
+    };
+
+    uint32_t GetEntryIndex(const FlowHandle flowHandle) const;
+    std::optional<std::reference_wrapper<RepeatableFlow>> GetRunningFlow(const uint32_t entryIndex);
+    void Schedule(const uint32_t entryIndex);
+    void Link(const uint32_t entryIndex, const uint32_t list);
+    void Unlink(const uint32_t entryIndex);
+    void Release(const uint32_t entryIndex);
+    void Cascade(const uint32_t list);
+    void FireExpiringFlows(const uint32_t list);
+
+private:
+    std::deque<FlowEntry> mEntries; // deque so that entries (and the flows firing) never move when adding flows
+    std::vector<uint32_t> mFreeEntries;
+    std::array<uint32_t, LIST_COUNT> mListHeads;
+    std::unordered_map<strutils::StringId, uint32_t, strutils::StringIdHasher> mEntriesByName;
+    double mNowMillis = 0.0;
+    uint64_t mCurrentTick = 0;
+    uint64_t mUpdateCount = 0;
+    size_t mFlowCount = 0;
+    uint32_t mFiringEntry = NONE;
+};
+
+///------------------------------------------------------------------------------------------------
+
+namespace flow_scheduling
+{
+
+///------------------------------------------------------------------------------------------------
+/// Compares running the given number of concurrent flows (with random durations, half of them repeating)
+/// through the FlowScheduler against the legacy approach of ticking a vector of std::function based flows
+/// every frame and looking them up by name with a linear search.
+/// @param[in] flowCount how many concurrent flows to run.
+/// @param[in] frameCount how many 60fps frames to simulate.
+/// @returns the human readable results (also logged).
+std::vector<std::string> BenchmarkFlowScheduling(const int flowCount, const int frameCount);
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* FlowScheduler_h */
@@ -0,0 +1,123 @@
+///------------------------------------------------------------------------------------------------
+///  FrameTimeHistogram.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "FrameTimeHistogram.h"
+#include "PersistenceUtils.h"
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+///------------------------------------------------------------------------------------------------
+
+void FrameTimeHistogram::AddSample(const float frameMillis)
+{
+    const auto bucketIndex = frameMillis <= 0.0f ? 0 : static_cast<size_t>(frameMillis / BUCKET_WIDTH_MILLIS);
+    mBuckets[bucketIndex < BUCKET_COUNT ? bucketIndex : BUCKET_COUNT - 1]++;
+    mSampleCount++;
+    mTotalMillis += frameMillis;
+    mWorstMillis = frameMillis > mWorstMillis ? frameMillis : mWorstMillis;
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t FrameTimeHistogram::GetSampleCount() const
+{
+    return mSampleCount;
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t FrameTimeHistogram::GetBucketSampleCount(const size_t bucketIndex) const
+{
+    return mBuckets.at(bucketIndex);
+}
+
+///------------------------------------------------------------------------------------------------
+
+float FrameTimeHistogram::GetMeanMillis() const
+{
+    return mSampleCount == 0 ? 0.0f : static_cast<float>(mTotalMillis / mSampleCount);
+}
+
+///------------------------------------------------------------------------------------------------
+
+float FrameTimeHistogram::GetWorstMillis() const
+{
+    return mWorstMillis;
+}
+
+///------------------------------------------------------------------------------------------------
+
+float FrameTimeHistogram::GetPercentileMillis(const float percentile) const
+{
+    if (mSampleCount == 0)
+    {
+        return 0.0f;
+    }
+
+    // The overflow bucket has no upper edge, so the worst sample stands in for it
+    const auto targetSampleCount = static_cast<size_t>(std::ceil(percentile * mSampleCount));
+    auto accumulatedSampleCount = size_t(0);
+    for (size_t i = 0; i < BUCKET_COUNT - 1; ++i)
+    {
+        accumulatedSampleCount += mBuckets[i];
+        if (accumulatedSampleCount >= targetSampleCount)
+        {
+            return (i + 1) * BUCKET_WIDTH_MILLIS;
+        }
+    }
+
+    return mWorstMillis;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::string FrameTimeHistogram::GetSummary(const std::string& name) const
+{
+    std::stringstream summary;
+    summary << std::fixed << std::setprecision(2);
+    summary << name << ": " << mSampleCount << " frames, mean " << GetMeanMillis() << " millis, p50 <" << GetPercentileMillis(0.5f) << ", p90 <" << GetPercentileMillis(0.9f) << ", p99 <" << GetPercentileMillis(0.99f) << ", worst " << mWorstMillis;
+    return summary.str();
+}
+
+///------------------------------------------------------------------------------------------------
+
+namespace frame_time_histogram
+{
+
+///------------------------------------------------------------------------------------------------
+
+bool WriteCsv(const std::string& filePath, const std::vector<std::string>& names, const std::vector<const FrameTimeHistogram*>& histograms)
+{
+    std::stringstream csv;
+    csv << "bucket_start_millis";
+    for (const auto& name: names)
+    {
+        csv << "," << name;
+    }
+    csv << "\n";
+
+    for (size_t i = 0; i < FrameTimeHistogram::BUCKET_COUNT; ++i)
+    {
+        csv << i * FrameTimeHistogram::BUCKET_WIDTH_MILLIS;
+        for (const auto* histogram: histograms)
+        {
+            csv << "," << histogram->GetBucketSampleCount(i);
+        }
+        csv << "\n";
+    }
+
+    const auto csvString = csv.str();
+    return persistence_utils::WriteFileAtomically(filePath, reinterpret_cast<const unsigned char*>(csvString.data()), csvString.size());
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
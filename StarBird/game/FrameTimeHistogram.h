@@ -0,0 +1,68 @@
+///------------------------------------------------------------------------------------------------
+///  FrameTimeHistogram.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef FrameTimeHistogram_h
+#define FrameTimeHistogram_h
+
+///------------------------------------------------------------------------------------------------
+
+#include <array>
+#include <string>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+/// Frame times bucketed in fixed width buckets (with the last one catching everything above it), so
+/// that the histograms of replaying the same recording can be compared bucket by bucket across builds.
+class FrameTimeHistogram final
+{
+public:
+    static constexpr float BUCKET_WIDTH_MILLIS = 0.5f;
+    static constexpr size_t BUCKET_COUNT = 100;
+
+    void AddSample(const float frameMillis);
+
+    size_t GetSampleCount() const;
+    size_t GetBucketSampleCount(const size_t bucketIndex) const;
+    float GetMeanMillis() const;
+    float GetWorstMillis() const;
+
+    /// @param[in] percentile the percentile (0-1) to get.
+    /// @returns the upper edge of the bucket the given percentile of samples falls in.
+    float GetPercentileMillis(const float percentile) const;
+
+    /// @param[in] name the name to prefix the summary with.
+    /// @returns a single line summary (mean, percentiles and worst frame).
+    std::string GetSummary(const std::string& name) const;
+
+private:
+    std::array<size_t, BUCKET_COUNT> mBuckets = {};
+    size_t mSampleCount = 0;
+    double mTotalMillis = 0.0;
+    float mWorstMillis = 0.0f;
+};
+
+///------------------------------------------------------------------------------------------------
+
+namespace frame_time_histogram
+{
+
+///------------------------------------------------------------------------------------------------
+/// Writes the given histograms as CSV, with a row per bucket and a column per histogram.
+/// @param[in] filePath the path of the file to write.
+/// @param[in] names the column name of each histogram.
+/// @param[in] histograms the histograms to write (one per name).
+/// @returns whether the file could be written.
+bool WriteCsv(const std::string& filePath, const std::vector<std::string>& names, const std::vector<const FrameTimeHistogram*>& histograms);
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* FrameTimeHistogram_h */
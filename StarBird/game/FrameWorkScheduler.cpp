@@ -0,0 +1,216 @@
+///------------------------------------------------------------------------------------------------
+///  FrameWorkScheduler.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "FrameWorkScheduler.h"
+#include "../utils/Logging.h"
+#include "../utils/MathUtils.h"
+
+#include <algorithm>
+#include <limits>
+#include <SDL.h>
+
+///------------------------------------------------------------------------------------------------
+
+static const float TARGET_FRAME_MILLIS = 1000.0f/60.0f;
+static const float RENDER_RESERVE_MILLIS = 6.0f;
+static const float LATE_FRAME_DT_FACTOR = 1.5f;
+static const float MIN_SLICE_BUDGET_MILLIS = 1.0f;
+static const float MAX_SLICE_BUDGET_MILLIS = 6.0f;
+
+///------------------------------------------------------------------------------------------------
+
+static float GetMillisSince(const Uint64 startCounter)
+{
+    return static_cast<float>((SDL_GetPerformanceCounter() - startCounter) * 1000.0/SDL_GetPerformanceFrequency());
+}
+
+///------------------------------------------------------------------------------------------------
+
+FrameWorkScheduler& FrameWorkScheduler::GetInstance()
+{
+    // One per game instance (i.e. per thread running one)
+    static thread_local FrameWorkScheduler instance;
+    return instance;
+}
+
+///------------------------------------------------------------------------------------------------
+
+WorkHandle FrameWorkScheduler::SubmitWork(const strutils::StringId& workName, const WorkPriority priority, WorkStep step)
+{
+    const auto workHandle = mNextWorkHandle++;
+    mPendingWork[static_cast<size_t>(priority)].push_back({ workHandle, workName, std::move(step), 0.0f });
+    return workHandle;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FrameWorkScheduler::CancelWork(const WorkHandle workHandle)
+{
+    if (workHandle == INVALID_WORK_HANDLE)
+    {
+        return;
+    }
+
+    // The running step is out of the queues, so just flag it to not be requeued
+    if (workHandle == mRunningWorkHandle)
+    {
+        mRunningWorkCancelled = true;
+        return;
+    }
+
+    for (auto& workQueue: mPendingWork)
+    {
+        auto workIter = std::find_if(workQueue.begin(), workQueue.end(), [=](const PendingWork& work){ return work.mHandle == workHandle; });
+        if (workIter != workQueue.end())
+        {
+            workQueue.erase(workIter);
+            return;
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool FrameWorkScheduler::IsWorkPending(const WorkHandle workHandle) const
+{
+    if (workHandle != INVALID_WORK_HANDLE && workHandle == mRunningWorkHandle)
+    {
+        return !mRunningWorkCancelled;
+    }
+
+    for (const auto& workQueue: mPendingWork)
+    {
+        if (std::any_of(workQueue.cbegin(), workQueue.cend(), [=](const PendingWork& work){ return work.mHandle == workHandle; }))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t FrameWorkScheduler::GetPendingWorkCount() const
+{
+    size_t pendingWorkCount = 0;
+    for (const auto& workQueue: mPendingWork)
+    {
+        pendingWorkCount += workQueue.size();
+    }
+
+    return pendingWorkCount;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FrameWorkScheduler::RunFrameSlice(const float frameDtMillis, const float frameElapsedMillis)
+{
+    if (GetPendingWorkCount() == 0)
+    {
+        return;
+    }
+
+    const auto sliceStartCounter = SDL_GetPerformanceCounter();
+    const auto sliceBudgetMillis = ComputeSliceBudgetMillis(frameDtMillis, frameElapsedMillis);
+
+    auto sliceMillis = 0.0f;
+    auto sliceStepCount = 0;
+    strutils::StringId lastStepWorkName;
+
+    while (sliceMillis < sliceBudgetMillis)
+    {
+        auto workQueueIter = std::find_if(mPendingWork.begin(), mPendingWork.end(), [](const std::deque<PendingWork>& workQueue){ return !workQueue.empty(); });
+        if (workQueueIter == mPendingWork.end())
+        {
+            break;
+        }
+
+        // Don't start a step that's not expected to fit in what's left of the budget (judging by the work's previous step)
+        if (sliceStepCount > 0 && sliceMillis + workQueueIter->front().mLastStepMillis > sliceBudgetMillis)
+        {
+            break;
+        }
+
+        // Steps are run off the queue, as they are free to submit (or cancel) work themselves
+        auto work = std::move(workQueueIter->front());
+        workQueueIter->pop_front();
+
+        mRunningWorkHandle = work.mHandle;
+        mRunningWorkCancelled = false;
+
+        const auto stepStartCounter = SDL_GetPerformanceCounter();
+        const auto stepResult = work.mStep();
+        work.mLastStepMillis = GetMillisSince(stepStartCounter);
+        lastStepWorkName = work.mName;
+
+        mRunningWorkHandle = INVALID_WORK_HANDLE;
+        mStats.mStepsRun++;
+        sliceStepCount++;
+
+        // Unfinished work goes back to the front of its queue, to be resumed before anything else of its priority
+        if (stepResult == WorkStepResult::CONTINUE && !mRunningWorkCancelled)
+        {
+            workQueueIter->push_front(std::move(work));
+        }
+
+        sliceMillis = GetMillisSince(sliceStartCounter);
+    }
+
+    mStats.mSlicesRun++;
+    mStats.mLastSliceBudgetMillis = sliceBudgetMillis;
+    mStats.mLastSliceMillis = sliceMillis;
+
+    if (sliceMillis > sliceBudgetMillis)
+    {
+        // Only the last step of a slice can take it over budget, by either being the first step
+        // of the slice or taking longer than its work's previous step
+        const auto overrunMillis = sliceMillis - sliceBudgetMillis;
+
+        mStats.mBudgetOverruns++;
+        if (overrunMillis > mStats.mWorstOverrunMillis)
+        {
+            mStats.mWorstOverrunMillis = overrunMillis;
+            mStats.mWorstOverrunWorkName = lastStepWorkName;
+        }
+
+        Log(LogType::WARNING, "Frame work slice overran its %.3f millis budget by %.3f millis (%d steps, last one of %s)", sliceBudgetMillis, overrunMillis, sliceStepCount, lastStepWorkName.GetString().c_str());
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FrameWorkScheduler::SetUnbudgeted(const bool unbudgeted)
+{
+    mUnbudgeted = unbudgeted;
+}
+
+///------------------------------------------------------------------------------------------------
+
+const FrameWorkStats& FrameWorkScheduler::GetStats() const
+{
+    return mStats;
+}
+
+///------------------------------------------------------------------------------------------------
+
+float FrameWorkScheduler::ComputeSliceBudgetMillis(const float frameDtMillis, const float frameElapsedMillis) const
+{
+    if (mUnbudgeted)
+    {
+        return std::numeric_limits<float>::max();
+    }
+
+    if (frameDtMillis > TARGET_FRAME_MILLIS * LATE_FRAME_DT_FACTOR)
+    {
+        return MIN_SLICE_BUDGET_MILLIS;
+    }
+
+    return math::Max(MIN_SLICE_BUDGET_MILLIS, math::Min(MAX_SLICE_BUDGET_MILLIS, TARGET_FRAME_MILLIS - RENDER_RESERVE_MILLIS - frameElapsedMillis));
+}
+
+///------------------------------------------------------------------------------------------------
@@ -0,0 +1,122 @@
+///------------------------------------------------------------------------------------------------
+///  FrameWorkScheduler.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef FrameWorkScheduler_h
+#define FrameWorkScheduler_h
+
+///------------------------------------------------------------------------------------------------
+
+#include "../utils/StringUtils.h"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+///------------------------------------------------------------------------------------------------
+
+enum class WorkPriority
+{
+    HIGH, NORMAL, LOW, COUNT
+};
+
+enum class WorkStepResult
+{
+    CONTINUE, FINISHED
+};
+
+using WorkHandle = uint64_t;
+inline const WorkHandle INVALID_WORK_HANDLE = 0;
+
+///------------------------------------------------------------------------------------------------
+
+struct FrameWorkStats
+{
+    long long mSlicesRun = 0LL;
+    long long mStepsRun = 0LL;
+    long long mBudgetOverruns = 0LL;
+    float mLastSliceBudgetMillis = 0.0f;
+    float mLastSliceMillis = 0.0f;
+    float mWorstOverrunMillis = 0.0f;
+    strutils::StringId mWorstOverrunWorkName;
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// Cooperative scheduler for heavy, one off work (wave spawning, building menus etc..) that would
+/// otherwise hitch whichever frame triggered it. Work is submitted as a resumable step that gets
+/// called repeatedly until it reports it's finished, with each frame running as many steps as
+/// fit in its budget: highest priority first, and first come first served within a priority.
+/// Steps themselves are never interrupted, so they should be kept small.
+class FrameWorkScheduler final
+{
+public:
+    using WorkStep = std::function<WorkStepResult()>;
+
+    /// The default method of getting a hold of this singleton.
+    /// @returns a reference to the single instance of this class on the calling thread (i.e. of the game instance running on it).
+    static FrameWorkScheduler& GetInstance();
+
+    ~FrameWorkScheduler() = default;
+    FrameWorkScheduler(const FrameWorkScheduler&) = delete;
+    FrameWorkScheduler(FrameWorkScheduler&&) = delete;
+    const FrameWorkScheduler& operator = (const FrameWorkScheduler&) = delete;
+    FrameWorkScheduler& operator = (FrameWorkScheduler&&) = delete;
+
+    /// Queues up work to be run over the next frames.
+    /// @param[in] workName name of the work, used when reporting budget overruns.
+    /// @param[in] priority the priority of the work.
+    /// @param[in] step the step of the work, called once per run until it returns WorkStepResult::FINISHED.
+    /// @returns a handle to the work, for querying or cancelling it.
+    WorkHandle SubmitWork(const strutils::StringId& workName, const WorkPriority priority, WorkStep step);
+
+    /// Drops pending work. Owners of work capturing themselves need to cancel it before they are destroyed.
+    /// It's fine to cancel finished work, invalid handles, or the work currently running.
+    void CancelWork(const WorkHandle workHandle);
+    bool IsWorkPending(const WorkHandle workHandle) const;
+    size_t GetPendingWorkCount() const;
+
+    /// Runs pending work for (roughly) this frame's budget. Called once per frame, after the scene
+    /// has been updated. The budget is whatever's left of the target frame time after the frame's
+    /// update and a reserve for rendering, clamped to a sane range, and cut down to the minimum on
+    /// frames following one that was already late. At least one step runs every frame, so that
+    /// work can't starve.
+    /// @param[in] frameDtMillis the (uncapped) delta since the last frame.
+    /// @param[in] frameElapsedMillis the time spent on the current frame so far.
+    void RunFrameSlice(const float frameDtMillis, const float frameElapsedMillis);
+
+    /// Lifts the frame budget, so that each slice runs all pending work, e.g. for runs that need to
+    /// play out identically regardless of frame timings.
+    void SetUnbudgeted(const bool unbudgeted);
+
+    const FrameWorkStats& GetStats() const;
+
+private:
+    FrameWorkScheduler() = default;
+
+    struct PendingWork
+    {
+        WorkHandle mHandle;
+        strutils::StringId mName;
+        WorkStep mStep;
+        float mLastStepMillis;
+    };
+
+    float ComputeSliceBudgetMillis(const float frameDtMillis, const float frameElapsedMillis) const;
+
+private:
+    std::array<std::deque<PendingWork>, static_cast<size_t>(WorkPriority::COUNT)> mPendingWork;
+    FrameWorkStats mStats;
+    WorkHandle mNextWorkHandle = INVALID_WORK_HANDLE + 1;
+    WorkHandle mRunningWorkHandle = INVALID_WORK_HANDLE;
+    bool mRunningWorkCancelled = false;
+    bool mUnbudgeted = false;
+};
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* FrameWorkScheduler_h */
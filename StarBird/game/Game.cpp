@@ -5,12 +5,20 @@
 ///  Created by Alex Koukoulas on 27/01/2023                                                       
 ///------------------------------------------------------------------------------------------------
 
+#include "FrameWorkScheduler.h"
 #include "Game.h"
 #include "GameSingletons.h"
 #include "InputContext.h"
+#include "InputRecording.h"
+#include "LevelGeneration.h"
+#include "LevelSnapshot.h"
+#include "LevelUpdater.h"
 #include "PersistenceUtils.h"
+#include "PhysicsConstants.h"
 #include "Scene.h"
+#include "SimulationProfiler.h"
 
+#include "dataloaders/GameDataBundle.h"
 #include "dataloaders/UpgradesLoader.h"
 
 #include "datarepos/FontRepository.h"
@@ -26,23 +34,84 @@
 #include "../utils/OpenGL.h"
 #include "../utils/OSMessageBox.h"
 
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
 #include <SDL.h>
+#include <sstream>
 #include <unordered_map>
 
 ///------------------------------------------------------------------------------------------------
 
+// Headless runs lay out levels as if on a (portrait) iPhone screen
+static const int HEADLESS_WINDOW_WIDTH = 1170;
+static const int HEADLESS_WINDOW_HEIGHT = 2532;
+
+///------------------------------------------------------------------------------------------------
+
+static std::optional<uint64_t> ComputeLevelSimulationDigest(const Scene& scene)
+{
+    const auto* levelUpdater = dynamic_cast<const LevelUpdater*>(scene.GetSceneUpdater());
+    return levelUpdater ? std::make_optional(levelUpdater->ComputeSimulationDigest()) : std::nullopt;
+}
+
+///------------------------------------------------------------------------------------------------
+
+// iOS only grants a short window to finish up once the app is being backgrounded or terminated, and these
+// events are only delivered on time to event watchers (rather than through the event queue)
+static int FlushPendingSavesOnAppLifecycleEvent(void*, SDL_Event* event)
+{
+    switch (event->type)
+    {
+        case SDL_APP_TERMINATING:
+        case SDL_APP_WILLENTERBACKGROUND:
+        case SDL_APP_DIDENTERBACKGROUND:
+        {
+            persistence_utils::FlushPendingProgressSaves();
+        } break;
+    }
+    
+    return 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
 Game::Game()
     : mIsFinished(false)
 {
+    GameSingletons::SetGameContext(&mGameContext);
+    
     if (!InitSystems()) return;
     Run();
 }
 
 ///------------------------------------------------------------------------------------------------
 
+Game::Game(const HeadlessParameters& headlessParameters)
+    : mIsFinished(false)
+{
+    GameSingletons::SetGameContext(&mGameContext);
+    
+    if (!InitHeadlessSystems()) return;
+    RunHeadless(headlessParameters);
+}
+
+///------------------------------------------------------------------------------------------------
+
 Game::~Game()
 {
-    SDL_Quit();
+    persistence_utils::FlushPendingProgressSaves();
+    
+    // Headless instances may be running side by side, and share SDL for the lifetime of the process
+    if (!mGameContext.IsHeadless())
+    {
+        SDL_DelEventWatch(FlushPendingSavesOnAppLifecycleEvent, nullptr);
+        SDL_Quit();
+    }
+    
+    GameSingletons::SetGameContext(nullptr);
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -85,8 +154,8 @@ bool Game::InitSystems()
         return false;
     }
     
-    GameSingletons::SetWindow(window);
-    GameSingletons::SetWindowDimensions(windowWidth, windowHeight);
+    mGameContext.SetWindow(window);
+    mGameContext.SetWindowDimensions(windowWidth, windowHeight);
     
     // Set OpenGL desired attributes
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
@@ -118,7 +187,10 @@ bool Game::InitSystems()
     {
         ospopups::ShowMessageBox(ospopups::MessageBoxType::ERROR, "SDL could not initialize joystick/accelerometer!", SDL_GetError());
     }
-    GameSingletons::SetInputContextJoystick(accelerometer);
+    mGameContext.SetInputContextJoystick(accelerometer);
+    
+    // Make sure no save is lost when the app gets backgrounded or terminated
+    SDL_AddEventWatch(FlushPendingSavesOnAppLifecycleEvent, nullptr);
     
     // Init resource service
     resources::ResourceLoadingService::GetInstance();
@@ -131,9 +203,36 @@ bool Game::InitSystems()
 
 ///------------------------------------------------------------------------------------------------
 
+bool Game::InitHeadlessSystems()
+{
+    // No window, GL context or audio (which also leaves all sound and haptics calls as no-ops).
+    // SDL's init isn't thread safe, so it only happens once for all headless instances.
+    static std::once_flag sdlInitializedFlag;
+    static bool sdlInitialized = false;
+    std::call_once(sdlInitializedFlag, []()
+    {
+        sdlInitialized = SDL_Init(0) >= 0;
+        if (!sdlInitialized)
+        {
+            std::cerr << "SDL could not initialize! " << SDL_GetError() << std::endl;
+        }
+    });
+    
+    mGameContext.SetHeadless(true);
+    mGameContext.SetWindowDimensions(HEADLESS_WINDOW_WIDTH, HEADLESS_WINDOW_HEIGHT);
+    
+    // Needs to be headless before any resource gets loaded
+    resources::ResourceLoadingService::GetInstance().SetHeadless(true);
+    
+    return sdlInitialized;
+}
+
+///------------------------------------------------------------------------------------------------
+
 void Game::Run()
 {
     InitPersistentData();
+    InputReplayer::GetInstance().LoadQueued();
     
     auto fileNames = fileutils::GetAllFilenamesInDirectory(resources::ResourceLoadingService::RES_SOUNDS_ROOT);
     for (const auto& fileName: fileNames)
@@ -144,27 +243,40 @@ void Game::Run()
         }
     }
     
-    Scene scene;
+    Scene scene(mGameContext);
     scene.ChangeScene(Scene::TransitionParameters(Scene::SceneType::CHEST_REWARD, "test_level_with_boss", false));
     
     SDL_Event e;
     
-    auto lastFrameMillisSinceInit         = 0.0f;
+    auto lastFrameCounter                 = SDL_GetPerformanceCounter();
+    auto simulationAccumulatorMillis      = 0.0f;
     auto secsAccumulator                  = 0.0f;
     auto framesAccumulator                = 0LL;
     
-    GameSingletons::SetInputContextEvent(SDL_FINGERUP);
+    mGameContext.SetInputContextEvent(SDL_FINGERUP);
     
     std::unordered_map<SDL_FingerID, glm::vec2> multiTouchMotionframeFingerIDsToTouchPositions;
     
+    auto& inputRecorder = InputRecorder::GetInstance();
+    auto& inputReplayer = InputReplayer::GetInstance();
+    
     //While application is running
     while(!mIsFinished)
     {
+        const auto frameStartCounter = SDL_GetPerformanceCounter();
+        
+        if (inputReplayer.HasPendingReplay())
+        {
+            scene.ChangeScene(Scene::TransitionParameters(Scene::SceneType::LEVEL, inputReplayer.BeginReplay(), false));
+        }
+        
+        // Recordings and replays work off the changes each frame's input events make to the input context
+        const auto preEventsInputContext = inputRecorder.IsRecording() || inputReplayer.IsReplaying() ? mGameContext.GetInputContext() : InputContext();
+        
         // Calculate frame delta
-        const auto currentMillisSinceInit = static_cast<float>(SDL_GetTicks());        // the number of milliseconds since the SDL library
-        const auto dtMillis = currentMillisSinceInit - lastFrameMillisSinceInit; // millis diff between current and last frame
+        const auto dtMillis = static_cast<float>((frameStartCounter - lastFrameCounter) * 1000.0/SDL_GetPerformanceFrequency()); // millis diff between current and last frame
         
-        lastFrameMillisSinceInit = currentMillisSinceInit;
+        lastFrameCounter = frameStartCounter;
         framesAccumulator++;
         secsAccumulator += dtMillis * 0.001f; // dt in seconds;
         
@@ -186,12 +298,12 @@ void Game::Run()
                 case SDL_FINGERUP:
                 case SDL_FINGERMOTION:
                 {
-                    GameSingletons::SetInputContextEvent(e.type);
-                    GameSingletons::SetInputContextTouchPos(glm::vec2(e.tfinger.x, e.tfinger.y));
+                    mGameContext.SetInputContextEvent(e.type);
+                    mGameContext.SetInputContextTouchPos(glm::vec2(e.tfinger.x, e.tfinger.y));
                     
                     if (e.type == SDL_FINGERUP)
                     {
-                        GameSingletons::SetInputContextMultiGestureActive(false);
+                        mGameContext.SetInputContextMultiGestureActive(false);
                     }
                     else
                     {
@@ -203,22 +315,24 @@ void Game::Run()
                 {
                     const auto keyCode = e.key.keysym.scancode;
                     
-                    GameSingletons::SetInputContextEvent(e.type);
-                    GameSingletons::SetInputContextKey(keyCode);
+                    mGameContext.SetInputContextEvent(e.type);
+                    mGameContext.SetInputContextKey(keyCode);
                     
                     if (keyCode == SDL_SCANCODE_BACKSPACE)
                     {
-                        const auto& currentText = GameSingletons::GetInputContext().mText;
+                        const auto& currentText = mGameContext.GetInputContext().mText;
                         if (!currentText.empty())
                         {
-                            GameSingletons::SetInputContextText(currentText.substr(0, currentText.size() - 1));
+                            mGameContext.SetInputContextText(currentText.substr(0, currentText.size() - 1));
                         }
                     }
-                    else if (keyCode != SDL_SCANCODE_RETURN && keyCode != SDL_SCANCODE_UP && keyCode != SDL_SCANCODE_DOWN && !SDL_IsScreenKeyboardShown(GameSingletons::GetWindow()))
+                    else if (keyCode != SDL_SCANCODE_RETURN && keyCode != SDL_SCANCODE_UP && keyCode != SDL_SCANCODE_DOWN && !SDL_IsScreenKeyboardShown(mGameContext.GetWindow()))
                     {
                         if (keyCode == SDL_SCANCODE_GRAVE)
                         {
 #ifdef DEBUG
+                            // Whatever gets done through the console can't be replayed
+                            inputRecorder.Stop(ComputeLevelSimulationDigest(scene));
                             scene.OpenDebugConsole();
 #endif
                         }
@@ -264,7 +378,7 @@ void Game::Run()
                 } break;
                 case SDL_KEYUP:
                 {
-                    GameSingletons::SetInputContextEvent(e.type);
+                    mGameContext.SetInputContextEvent(e.type);
                 } break;
                     
                 case SDL_TEXTINPUT:
@@ -301,16 +415,27 @@ void Game::Run()
                     if (maxFoundPinchDistance < pointDistance)
                     {
                         maxFoundPinchDistance = pointDistance;
-                        GameSingletons::SetInputContextMultiGestureActive(true);
+                        mGameContext.SetInputContextMultiGestureActive(true);
                     }
                 }
             }
         }
         
-        GameSingletons::SetInputContextPinchDistance(maxFoundPinchDistance);
+        mGameContext.SetInputContextPinchDistance(maxFoundPinchDistance);
+        
+        auto* accelerometer = mGameContext.GetInputContext().mJoystick;
+        mGameContext.SetInputContextRawAccelerometerValues(glm::vec2(SDL_JoystickGetAxis(accelerometer, 0), -SDL_JoystickGetAxis(accelerometer, 1)));
         
-        auto* accelerometer = GameSingletons::GetInputContext().mJoystick;
-        GameSingletons::SetInputContextRawAccelerometerValues(glm::vec2(SDL_JoystickGetAxis(accelerometer, 0), -SDL_JoystickGetAxis(accelerometer, 1)));
+        inputRecorder.RecordFrameInput(preEventsInputContext, mGameContext.GetInputContext(), lastAppForegroundBackgroundEvent);
+        
+        // Replays run on the recorded input and dt alone
+        auto replayDtMillis = 0.0f;
+        if (inputReplayer.IsReplaying())
+        {
+            inputReplayer.BeginFrame(preEventsInputContext);
+            lastAppForegroundBackgroundEvent = inputReplayer.GetFrameAppStateEvent();
+            replayDtMillis = inputReplayer.GetFrameDtMillis();
+        }
         
         if (secsAccumulator > 1.0f)
         {
@@ -324,37 +449,187 @@ void Game::Run()
         
         objectiveC_utils::UpdateAudio(propagatedDtMillis);
         
-        scene.UpdateScene(propagatedDtMillis);
-        scene.RenderScene();
+        // The simulation advances in fixed steps, as many as needed to catch up with real time (up to a cap),
+        // or exactly as many as were recorded when replaying
+        if (inputReplayer.IsReplaying())
+        {
+            for (auto i = 0; i < inputReplayer.GetFrameStepCount(); ++i)
+            {
+                scene.UpdateScene(physics_constants::WORLD_STEP_MILLIS);
+            }
+            
+            simulationAccumulatorMillis = 0.0f;
+        }
+        else
+        {
+            simulationAccumulatorMillis += dtMillis;
+            auto simulationSteps = 0;
+            while (simulationAccumulatorMillis >= physics_constants::WORLD_STEP_MILLIS && simulationSteps < physics_constants::MAX_WORLD_STEPS_PER_FRAME)
+            {
+                scene.UpdateScene(physics_constants::WORLD_STEP_MILLIS);
+                inputRecorder.OnSimulationStep();
+                simulationAccumulatorMillis -= physics_constants::WORLD_STEP_MILLIS;
+                simulationSteps++;
+            }
+        }
+        
+        // Steps that didn't make it in time are dropped rather than carried over, otherwise a long
+        // frame (or coming back from the background) would keep the simulation catching up for a while
+        if (simulationAccumulatorMillis >= physics_constants::WORLD_STEP_MILLIS)
+        {
+            simulationAccumulatorMillis = std::fmod(simulationAccumulatorMillis, physics_constants::WORLD_STEP_MILLIS);
+        }
+        
+        // Deferred work gets whatever's left of this frame's budget before rendering
+        FrameWorkScheduler::GetInstance().RunFrameSlice(inputReplayer.IsReplaying() ? replayDtMillis : dtMillis, static_cast<float>((SDL_GetPerformanceCounter() - frameStartCounter) * 1000.0/SDL_GetPerformanceFrequency()));
+        
+        const auto updateEndCounter = SDL_GetPerformanceCounter();
+        
+        // Replays don't keep any real time left over between steps, so they render the latest step as is
+        scene.RenderScene(inputReplayer.IsReplaying() ? 1.0f : simulationAccumulatorMillis/physics_constants::WORLD_STEP_MILLIS);
     
         if (lastAppForegroundBackgroundEvent)
         {
             scene.OnAppStateChange(lastAppForegroundBackgroundEvent);
         }
+        
+        if (inputRecorder.IsRecording())
+        {
+            inputRecorder.EndFrame(dtMillis);
+            if (scene.GetSceneChangeCount() != inputRecorder.GetLevelSceneChangeCount())
+            {
+                inputRecorder.Stop(ComputeLevelSimulationDigest(scene));
+            }
+        }
+        
+        if (inputReplayer.IsReplaying())
+        {
+            const auto frameEndCounter = SDL_GetPerformanceCounter();
+            inputReplayer.EndFrame(static_cast<float>((updateEndCounter - frameStartCounter) * 1000.0/SDL_GetPerformanceFrequency()), static_cast<float>((frameEndCounter - frameStartCounter) * 1000.0/SDL_GetPerformanceFrequency()));
+            
+            if (inputReplayer.IsAtEnd() || scene.GetSceneChangeCount() != inputReplayer.GetLevelSceneChangeCount())
+            {
+                // The replay ran off the recorded player's state, so the player's own progress gets reloaded
+                const auto simulationDigest = ComputeLevelSimulationDigest(scene);
+                persistence_utils::ResetProgress();
+                persistence_utils::LoadFromProgressSaveFile();
+                scene.ChangeScene(Scene::TransitionParameters(Scene::SceneType::MAIN_MENU, "", false));
+                inputReplayer.Finish(simulationDigest);
+            }
+        }
     }
 }
 
 ///------------------------------------------------------------------------------------------------
 
-void Game::InitPersistentData()
+void Game::RunHeadless(const HeadlessParameters& headlessParameters)
 {
-    auto& waveBlocksRepo = WaveBlocksRepository::GetInstance();
-    waveBlocksRepo.LoadWaveBlocks();
+    LoadGameData();
     
-    UpgradesLoader loader;
-    const auto& allUpgrades = loader.LoadAllUpgrades();
+    // Start off a fresh game fully determined by the given seed, leaving the player's saves untouched
+    persistence_utils::ResetProgress();
+    mGameContext.SetMapGenerationSeed(headlessParameters.mSeed);
+    mGameContext.SetBackgroundIndex(headlessParameters.mSeed % game_constants::BACKGROUND_COUNT);
+    mGameContext.SetCurrentMapCoord(headlessParameters.mMapCoord);
+    math::SetControlSeed(headlessParameters.mSeed);
+    math::GetRandomEngine().seed(headlessParameters.mSeed);
     
-    std::vector<UpgradeDefinition> availableUpgrades;
-    std::vector<UpgradeDefinition> eventOnlyUpgrades;
+    const auto& levelDef = level_generation::GetOrGenerateLevel(headlessParameters.mMapCoord, { headlessParameters.mNodeType, {}, {} });
     
-    std::copy_if(allUpgrades.begin(), allUpgrades.end(), std::back_inserter(availableUpgrades), [](const UpgradeDefinition& def) { return def.mEventOnly == false; });
-    std::copy_if(allUpgrades.begin(), allUpgrades.end(), std::back_inserter(eventOnlyUpgrades), [](const UpgradeDefinition& def) { return def.mEventOnly == true; });
+    Scene scene(mGameContext);
+    scene.ChangeScene(Scene::TransitionParameters(Scene::SceneType::LEVEL, levelDef.mLevelName.GetString(), false));
+    
+    // Every way out of a level goes through a scene change
+    const auto levelSceneChangeCount = scene.GetSceneChangeCount();
+    
+    mGameContext.SetInputContextEvent(SDL_FINGERUP);
+    
+    auto& profiler = SimulationProfiler::GetInstance();
+    profiler.Reset();
+    profiler.SetEnabled(true);
+    
+    // All deferred work runs in the frame it's due, so that runs don't depend on the speed of the host
+    auto& frameWorkScheduler = FrameWorkScheduler::GetInstance();
+    frameWorkScheduler.SetUnbudgeted(true);
+    
+    const auto runStartCounter = SDL_GetPerformanceCounter();
+    auto worstFrameMillis = 0.0;
+    auto simulatedFrameCount = 0;
+    
+    while (simulatedFrameCount < headlessParameters.mFrameCount && scene.GetSceneChangeCount() == levelSceneChangeCount)
+    {
+        const auto frameStartCounter = SDL_GetPerformanceCounter();
+        
+        scene.UpdateScene(physics_constants::WORLD_STEP_MILLIS);
+        
+        {
+            SimulationProfiler::ScopedTimer frameWorkTimer(SimulationSubsystem::FRAME_WORK);
+            frameWorkScheduler.RunFrameSlice(physics_constants::WORLD_STEP_MILLIS, 0.0f);
+        }
+        
+        worstFrameMillis = math::Max(worstFrameMillis, (SDL_GetPerformanceCounter() - frameStartCounter) * 1000.0/SDL_GetPerformanceFrequency());
+        simulatedFrameCount++;
+    }
+    
+    const auto runMillis = (SDL_GetPerformanceCounter() - runStartCounter) * 1000.0/SDL_GetPerformanceFrequency();
+    const auto frameDivisor = static_cast<double>(math::Max(1, simulatedFrameCount));
+    
+    profiler.SetEnabled(false);
+    frameWorkScheduler.SetUnbudgeted(false);
+    
+    // Logging is compiled out of release builds, which are the ones worth profiling
+    std::stringstream report;
+    report << std::fixed << std::setprecision(4);
+    report << "Headless run of " << levelDef.mLevelName.GetString() << " (seed " << headlessParameters.mSeed << ", node " << headlessParameters.mMapCoord.ToString() << ")\n";
+    report << "Simulated " << simulatedFrameCount << "/" << headlessParameters.mFrameCount << " frames in " << runMillis << " millis (" << runMillis/frameDivisor << " per frame, worst " << worstFrameMillis << ")";
+    report << (scene.GetSceneChangeCount() == levelSceneChangeCount ? "" : ", stopped early on leaving the level") << "\n";
+    
+    auto subsystemsMillis = 0.0;
+    for (size_t i = 0; i < static_cast<size_t>(SimulationSubsystem::COUNT); ++i)
+    {
+        const auto subsystem = static_cast<SimulationSubsystem>(i);
+        const auto& timings = profiler.GetTimings(subsystem);
+        subsystemsMillis += timings.mTotalMillis;
+        
+        report << "  " << std::left << std::setw(20) << SimulationProfiler::GetSubsystemName(subsystem) << std::right;
+        report << " total " << std::setw(12) << timings.mTotalMillis << " | per frame " << std::setw(10) << timings.mTotalMillis/frameDivisor << " | worst " << std::setw(10) << timings.mWorstMillis << "\n";
+    }
+    
+    report << "  " << std::left << std::setw(20) << "other" << std::right << " total " << std::setw(12) << math::Max(0.0, runMillis - subsystemsMillis) << "\n";
+    
+    mHeadlessResult.mSimulatedFrameCount = simulatedFrameCount;
+    mHeadlessResult.mSceneObjectsDigest = level_snapshot::DigestSceneObjects(scene.GetSceneObjects());
+    mHeadlessResult.mSimulationDigest = ComputeLevelSimulationDigest(scene);
+    
+    report << std::hex << std::setfill('0');
+    report << "Scene objects digest: " << std::setw(16) << mHeadlessResult.mSceneObjectsDigest << "\n";
+    report << "Simulation digest:    ";
+    if (mHeadlessResult.mSimulationDigest)
+    {
+        report << std::setw(16) << *mHeadlessResult.mSimulationDigest << "\n";
+    }
+    else
+    {
+        report << "n/a (not in the level anymore)\n";
+    }
     
-    GameSingletons::SetAvailableUpgrades(availableUpgrades);
-    GameSingletons::SetEventOnlyUpgrades(eventOnlyUpgrades);
+    mHeadlessResult.mReport = report.str();
+}
+
+///------------------------------------------------------------------------------------------------
+
+const Game::HeadlessResult& Game::GetHeadlessResult() const
+{
+    return mHeadlessResult;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void Game::InitPersistentData()
+{
+    const auto loadStartCounter = SDL_GetPerformanceCounter();
     
-    auto& typeDefRepo = ObjectTypeDefinitionRepository::GetInstance();
-    typeDefRepo.LoadObjectTypeDefinition(game_constants::PLAYER_OBJECT_TYPE_DEF_NAME);
+    LoadGameData();
     
     if (!persistence_utils::ProgressSaveFileExists())
     {
@@ -364,14 +639,55 @@ void Game::InitPersistentData()
     {
         persistence_utils::LoadFromProgressSaveFile();
     }
+    
+    Log(LogType::INFO, "Loaded persistent data in %.3f millis", (SDL_GetPerformanceCounter() - loadStartCounter) * 1000.0/SDL_GetPerformanceFrequency());
+}
+
+///------------------------------------------------------------------------------------------------
+
+void Game::LoadGameData()
+{
+    // The bundle and the repositories are shared by all game instances in the process, so only
+    // the first one to get here loads them. They are read-only from then on.
+    static std::once_flag sharedGameDataLoadedFlag;
+    std::call_once(sharedGameDataLoadedFlag, []()
+    {
+        std::string gameDataBundleError;
+        if (GameDataBundle::GetInstance().Mount(resources::ResourceLoadingService::RES_DATA_ROOT + game_data_bundle::GAME_DATA_BUNDLE_FILE_NAME, gameDataBundleError))
+        {
+            Log(LogType::INFO, "Mounted game data bundle %s", (resources::ResourceLoadingService::RES_DATA_ROOT + game_data_bundle::GAME_DATA_BUNDLE_FILE_NAME).c_str());
+        }
+        else
+        {
+            Log(LogType::WARNING, "Loading game data from XML (%s)", gameDataBundleError.c_str());
+        }
+        
+        auto& waveBlocksRepo = WaveBlocksRepository::GetInstance();
+        waveBlocksRepo.LoadWaveBlocks();
+        
+        auto& typeDefRepo = ObjectTypeDefinitionRepository::GetInstance();
+        typeDefRepo.LoadObjectTypeDefinition(game_constants::PLAYER_OBJECT_TYPE_DEF_NAME);
+    });
+    
+    UpgradesLoader loader;
+    const auto& allUpgrades = loader.LoadAllUpgrades();
+    
+    std::vector<UpgradeDefinition> availableUpgrades;
+    std::vector<UpgradeDefinition> eventOnlyUpgrades;
+    
+    std::copy_if(allUpgrades.begin(), allUpgrades.end(), std::back_inserter(availableUpgrades), [](const UpgradeDefinition& def) { return def.mEventOnly == false; });
+    std::copy_if(allUpgrades.begin(), allUpgrades.end(), std::back_inserter(eventOnlyUpgrades), [](const UpgradeDefinition& def) { return def.mEventOnly == true; });
+    
+    mGameContext.SetAvailableUpgrades(availableUpgrades);
+    mGameContext.SetEventOnlyUpgrades(eventOnlyUpgrades);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void Game::OnTextInput(const std::string& text)
 {
-    GameSingletons::SetInputContextEvent(SDL_TEXTINPUT);
-    GameSingletons::SetInputContextText(GameSingletons::GetInputContext().mText + text);
+    mGameContext.SetInputContextEvent(SDL_TEXTINPUT);
+    mGameContext.SetInputContextText(mGameContext.GetInputContext().mText + text);
 }
 
 ///------------------------------------------------------------------------------------------------
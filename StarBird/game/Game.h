@@ -10,25 +10,62 @@
 
 ///------------------------------------------------------------------------------------------------
 
+#include "GameContext.h"
+#include "Map.h"
+
+#include <cstdint>
+#include <optional>
 #include <string>
 
 ///------------------------------------------------------------------------------------------------
 
 class Game final
 {
+public:
+    /// What a headless run simulates (see Game::RunHeadless).
+    struct HeadlessParameters
+    {
+        int mSeed;
+        int mFrameCount;
+        MapCoord mMapCoord;
+        Map::NodeType mNodeType;
+    };
+    
+    /// What a headless run ended up with.
+    struct HeadlessResult
+    {
+        std::string mReport;
+        std::optional<uint64_t> mSimulationDigest;
+        uint64_t mSceneObjectsDigest = 0;
+        int mSimulatedFrameCount = 0;
+    };
+    
 public:
     Game();
+    explicit Game(const HeadlessParameters& headlessParameters);
     ~Game();
     
+    const HeadlessResult& GetHeadlessResult() const;
+    
 private:
     bool InitSystems();
+    bool InitHeadlessSystems();
     void Run();
     
+    /// Simulates the level of the given map node (generated from the given seed) for the given number of
+    /// frames at a fixed step and as fast as possible, without any input, then reports the time spent per
+    /// subsystem and hashes of the final state (see GetHeadlessResult). The run stops early if the level is
+    /// left (e.g. the player dies).
+    void RunHeadless(const HeadlessParameters& headlessParameters);
+    
 private:
     void OnTextInput(const std::string& text);
     void InitPersistentData();
+    void LoadGameData();
     
 private:
+    GameContext mGameContext;
+    HeadlessResult mHeadlessResult;
     bool mIsFinished;
 };
 
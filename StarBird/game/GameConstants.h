@@ -152,6 +152,7 @@ inline const std::string ENEMY_PROJECTILE_FLOW_POSTFIX = std::string("_PROJECTIL
 inline const int BACKGROUND_COUNT = 24;
 inline const int DEFAULT_MAP_COORD_COL = 0;
 inline const int DEFAULT_MAP_COORD_ROW = 2;
+inline const glm::ivec2 MAP_DIMENSIONS = glm::ivec2(9, 5);
 
 inline const float UPGRADE_MOVEMENT_SPEED = 1.0f/400.0f;
 
@@ -202,6 +203,7 @@ inline const float MAP_NODE_PULSING_SPEED = 0.005f;
 inline const float MAP_NODE_PULSING_ENLARGEMENT_FACTOR = 1.0f/200.0f;
 
 inline const float LEVEL_WAVE_VISIBLE_Y = 20.0f;
+inline const float LEVEL_WAVE_SPAWN_Y = 24.0f;
 
 inline const float DEFAULT_PLAYER_ATTACK = 10.0f;
 inline const float DEFAULT_PLAYER_HEALTH = 100.0f;
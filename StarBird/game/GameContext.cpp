@@ -0,0 +1,532 @@
+///------------------------------------------------------------------------------------------------
+///  GameContext.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "GameContext.h"
+#include "GameConstants.h"
+
+#include <algorithm>
+
+///------------------------------------------------------------------------------------------------
+
+GameContext::GameContext()
+    : mInputContext()
+    , mWindow(nullptr)
+    , mWindowDimensions(0.0f)
+    , mCurrentMapCoord(game_constants::DEFAULT_MAP_COORD_COL, game_constants::DEFAULT_MAP_COORD_ROW)
+    , mMapGenerationSeed(0)
+    , mMapLevel(0)
+    , mBackgroundIndex(0)
+    , mResearchCostMultiplier(1)
+    , mCrystalCount(0)
+    , mDisplayedCrystalCount(0.0f)
+    , mGameSpeedMultiplier(1.0f)
+    , mBossMaxHealth(0.0f)
+    , mBossCurrentHealth(1.0f)
+    , mPlayerShieldHealth(0.0f)
+    , mPlayerMaxHealth(1.0f)
+    , mPlayerCurrentHealth(1.0f)
+    , mPlayerDisplayedHealth(1.0f)
+    , mPlayerAttackStat(0.0f)
+    , mPlayerBulletSpeedStat(0.0f)
+    , mPlayerMovementStat(0.0f)
+    , mGodMode(false)
+    , mErasedLabsOnCurrentMap(false)
+    , mAccelerometerControl(false)
+    , mHeadless(false)
+{
+}
+
+///------------------------------------------------------------------------------------------------
+
+const InputContext& GameContext::GetInputContext() const
+{
+    return mInputContext;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetInputContextEvent(Uint32 event)
+{
+    mInputContext.mEventType = event;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetInputContextTouchPos(const glm::vec2& touchPos)
+{
+    mInputContext.mTouchPos = touchPos;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetInputContextText(const std::string& text)
+{
+    mInputContext.mText = text;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetInputContextKey(const SDL_Scancode keyCode)
+{
+    mInputContext.mKeyCode = keyCode;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetInputContextPinchDistance(const float pinchDistance)
+{
+    mInputContext.mPinchDistance = pinchDistance;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetInputContextJoystick(SDL_Joystick* joystick)
+{
+    mInputContext.mJoystick = joystick;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetInputContextRawAccelerometerValues(const glm::vec2& accelerometerValues)
+{
+    mInputContext.mRawAccelerometerValues = accelerometerValues;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetInputContextMultiGestureActive(const bool multiGestureActive)
+{
+    mInputContext.mMultiGestureActive = multiGestureActive;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::ConsumeInput()
+{
+    SetInputContextEvent(SDL_FINGERUP);
+}
+
+///------------------------------------------------------------------------------------------------
+
+SDL_Window* GameContext::GetWindow()
+{
+    return mWindow;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetWindow(SDL_Window* window)
+{
+    mWindow = window;
+}
+
+///------------------------------------------------------------------------------------------------
+
+const glm::vec2& GameContext::GetWindowDimensions() const
+{
+    return mWindowDimensions;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetWindowDimensions(int windowWidth, int windowHeight)
+{
+    mWindowDimensions.x = windowWidth;
+    mWindowDimensions.y = windowHeight;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::optional<std::reference_wrapper<Camera>> GameContext::GetCameraForSceneObjectType(const SceneObjectType sceneObjectType)
+{
+    auto findIter = mSceneObjectTypeToCameraMap.find(sceneObjectType);
+    if (findIter != mSceneObjectTypeToCameraMap.end())
+    {
+        return std::optional<std::reference_wrapper<Camera>>{findIter->second};
+    }
+    return std::nullopt;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetCameraForSceneObjectType(const SceneObjectType sceneObjectType, Camera&& camera)
+{
+    mSceneObjectTypeToCameraMap[sceneObjectType] = camera;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::unordered_set<size_t>& GameContext::GetSeenEventIndices()
+{
+    return mSeenEventIndices;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool GameContext::HasSeenEventIndex(const size_t eventIndex) const
+{
+    return mSeenEventIndices.count(eventIndex) != 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::vector<UpgradeDefinition>& GameContext::GetEquippedUpgrades()
+{
+    return mEquippedUpgrades;
+}
+
+///------------------------------------------------------------------------------------------------
+
+const std::vector<UpgradeDefinition>& GameContext::GetEquippedUpgrades() const
+{
+    return mEquippedUpgrades;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::vector<UpgradeDefinition>& GameContext::GetAvailableUpgrades()
+{
+    return mAvailableUpgrades;
+}
+
+///------------------------------------------------------------------------------------------------
+
+const std::vector<UpgradeDefinition>& GameContext::GetAvailableUpgrades() const
+{
+    return mAvailableUpgrades;
+}
+
+///------------------------------------------------------------------------------------------------
+
+const std::vector<UpgradeDefinition>& GameContext::GetEventOnlyUpgrades() const
+{
+    return mEventOnlyUpgrades;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetEquippedUpgrades(const std::vector<UpgradeDefinition>& upgrades)
+{
+    mEquippedUpgrades = upgrades;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetAvailableUpgrades(const std::vector<UpgradeDefinition>& upgrades)
+{
+    mAvailableUpgrades = upgrades;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetEventOnlyUpgrades(const std::vector<UpgradeDefinition>& upgrades)
+{
+    mEventOnlyUpgrades = upgrades;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool GameContext::HasEquippedUpgrade(const strutils::StringId& upgradeNameId) const
+{
+    return std::find_if(mEquippedUpgrades.cbegin(), mEquippedUpgrades.cend(), [&](const UpgradeDefinition& upgradeDefinition){ return upgradeDefinition.mUpgradeNameId == upgradeNameId; }) != mEquippedUpgrades.cend();
+}
+
+///------------------------------------------------------------------------------------------------
+
+float GameContext::GetGameSpeedMultiplier() const
+{
+    return mGameSpeedMultiplier;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetGameSpeedMultiplier(const float gameSpeedMultiplier)
+{
+    mGameSpeedMultiplier = gameSpeedMultiplier;
+}
+
+///------------------------------------------------------------------------------------------------
+
+float GameContext::GetBossMaxHealth() const
+{
+    return mBossMaxHealth;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetBossMaxHealth(const float bossMaxHealth)
+{
+    mBossMaxHealth = bossMaxHealth;
+}
+
+///------------------------------------------------------------------------------------------------
+
+float GameContext::GetBossCurrentHealth() const
+{
+    return mBossCurrentHealth;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetBossCurrentHealth(const float bossCurrentHealth)
+{
+    mBossCurrentHealth = bossCurrentHealth;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetPlayerShieldHealth(const float playerShieldHealth)
+{
+    mPlayerShieldHealth = playerShieldHealth;
+}
+
+///------------------------------------------------------------------------------------------------
+
+float GameContext::GetPlayerShieldHealth() const
+{
+    return mPlayerShieldHealth;
+}
+
+///------------------------------------------------------------------------------------------------
+
+float GameContext::GetPlayerMaxHealth() const
+{
+    return mPlayerMaxHealth;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetPlayerMaxHealth(const float playerMaxHealth)
+{
+    mPlayerMaxHealth = playerMaxHealth;
+}
+
+///------------------------------------------------------------------------------------------------
+
+float GameContext::GetPlayerCurrentHealth() const
+{
+    return mPlayerCurrentHealth;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetPlayerCurrentHealth(const float playerCurrentHealth)
+{
+    mPlayerCurrentHealth = playerCurrentHealth;
+}
+
+///------------------------------------------------------------------------------------------------
+
+float GameContext::GetPlayerDisplayedHealth() const
+{
+    return mPlayerDisplayedHealth;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetPlayerDisplayedHealth(const float playerDisplayedHealth)
+{
+    mPlayerDisplayedHealth = playerDisplayedHealth;
+}
+
+///------------------------------------------------------------------------------------------------
+
+float GameContext::GetPlayerAttackStat() const
+{
+    return mPlayerAttackStat;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetPlayerAttackStat(const float playerAttackStat)
+{
+    mPlayerAttackStat = playerAttackStat;
+}
+
+///------------------------------------------------------------------------------------------------
+
+float GameContext::GetPlayerBulletSpeedStat() const
+{
+    return mPlayerBulletSpeedStat;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetPlayerBulletSpeedStat(const float playerBulletSpeedStat)
+{
+    mPlayerBulletSpeedStat = playerBulletSpeedStat;
+}
+
+///------------------------------------------------------------------------------------------------
+
+float GameContext::GetPlayerMovementSpeedStat() const
+{
+    return mPlayerMovementStat;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetPlayerMovementSpeedStat(const float playerMovementStat)
+{
+    mPlayerMovementStat = playerMovementStat;
+}
+
+///------------------------------------------------------------------------------------------------
+
+long GameContext::GetCrystalCount() const
+{
+    return mCrystalCount;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetCrystalCount(const long crystalCount)
+{
+    mCrystalCount = crystalCount;
+}
+
+///------------------------------------------------------------------------------------------------
+
+float GameContext::GetDisplayedCrystalCount() const
+{
+    return mDisplayedCrystalCount;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetDisplayedCrystalCount(const float displayedCrystalCount)
+{
+    mDisplayedCrystalCount = displayedCrystalCount;
+}
+
+///------------------------------------------------------------------------------------------------
+
+MapCoord GameContext::GetCurrentMapCoord() const
+{
+    return mCurrentMapCoord;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetCurrentMapCoord(const MapCoord &mapCoord)
+{
+    mCurrentMapCoord = mapCoord;
+}
+
+///------------------------------------------------------------------------------------------------
+
+int GameContext::GetMapGenerationSeed() const
+{
+    return mMapGenerationSeed;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetMapGenerationSeed(const int mapGenerationSeed)
+{
+    mMapGenerationSeed = mapGenerationSeed;
+}
+
+///------------------------------------------------------------------------------------------------
+
+int GameContext::GetMapLevel() const
+{
+    return mMapLevel;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetMapLevel(const int mapLevel)
+{
+    mMapLevel = mapLevel;
+}
+
+///------------------------------------------------------------------------------------------------
+
+int GameContext::GetBackgroundIndex() const
+{
+    return mBackgroundIndex;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetBackgroundIndex(const int backgroundIndex)
+{
+    mBackgroundIndex = backgroundIndex;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool GameContext::GetGodeMode() const
+{
+    return mGodMode;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetGodMode(const bool godMode)
+{
+    mGodMode = godMode;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool GameContext::GetErasedLabsOnCurrentMap() const
+{
+    return mErasedLabsOnCurrentMap;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetErasedLabsOnCurrentMap(const bool erasedLabsOnCurrentMap)
+{
+    mErasedLabsOnCurrentMap = erasedLabsOnCurrentMap;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool GameContext::GetAccelerometerControl() const
+{
+    return mAccelerometerControl;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetAccelerometerControl(const bool accelerometerControl)
+{
+    mAccelerometerControl = accelerometerControl;
+}
+
+///------------------------------------------------------------------------------------------------
+
+int GameContext::GetResearchCostMultiplier() const
+{
+    return mResearchCostMultiplier;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetResearchCostMultiplier(const int researchCostMultiplier)
+{
+    mResearchCostMultiplier = researchCostMultiplier;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool GameContext::IsHeadless() const
+{
+    return mHeadless;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameContext::SetHeadless(const bool headless)
+{
+    mHeadless = headless;
+}
+
+///------------------------------------------------------------------------------------------------
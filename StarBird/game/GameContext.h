@@ -0,0 +1,178 @@
+///------------------------------------------------------------------------------------------------
+///  GameContext.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef GameContext_h
+#define GameContext_h
+
+///------------------------------------------------------------------------------------------------
+
+#include "Camera.h"
+#include "InputContext.h"
+#include "Map.h"
+#include "SceneObject.h"
+#include "UpgradeDefinition.h"
+#include "../utils/MathUtils.h"
+#include "../utils/StringUtils.h"
+
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+struct SDL_Window;
+
+///------------------------------------------------------------------------------------------------
+
+/// The state of a single game instance (input, window, cameras, upgrades, player stats, map progress
+/// and game settings). Each Game owns one and hands it to its Scene, so that several independent
+/// instances can run side by side in the same process, each on its own thread.
+class GameContext final
+{
+public:
+    GameContext();
+    ~GameContext() = default;
+    GameContext(const GameContext&) = delete;
+    GameContext(GameContext&&) = delete;
+    const GameContext& operator = (const GameContext&) = delete;
+    GameContext& operator = (GameContext&&) = delete;
+
+    const InputContext& GetInputContext() const;
+    void SetInputContextEvent(Uint32 event);
+    void SetInputContextTouchPos(const glm::vec2& touchPos);
+    void SetInputContextText(const std::string& text);
+    void SetInputContextKey(const SDL_Scancode keyCode);
+    void SetInputContextPinchDistance(const float pinchDistance);
+    void SetInputContextJoystick(SDL_Joystick* joystick);
+    void SetInputContextRawAccelerometerValues(const glm::vec2& accelerometerValues);
+    void SetInputContextMultiGestureActive(const bool multiGestureActive);
+    void ConsumeInput();
+
+    SDL_Window* GetWindow();
+    void SetWindow(SDL_Window* window);
+
+    const glm::vec2& GetWindowDimensions() const;
+    void SetWindowDimensions(const int windowWidth, const int windowHeight);
+
+    std::optional<std::reference_wrapper<Camera>> GetCameraForSceneObjectType(const SceneObjectType sceneObjectType);
+    void SetCameraForSceneObjectType(const SceneObjectType sceneObjectType, Camera&& camera);
+
+    std::vector<UpgradeDefinition>& GetEquippedUpgrades();
+    const std::vector<UpgradeDefinition>& GetEquippedUpgrades() const;
+    std::vector<UpgradeDefinition>& GetAvailableUpgrades();
+    const std::vector<UpgradeDefinition>& GetAvailableUpgrades() const;
+    const std::vector<UpgradeDefinition>& GetEventOnlyUpgrades() const;
+    void SetEquippedUpgrades(const std::vector<UpgradeDefinition>& upgrades);
+    void SetAvailableUpgrades(const std::vector<UpgradeDefinition>& upgrades);
+    void SetEventOnlyUpgrades(const std::vector<UpgradeDefinition>& upgrades);
+    bool HasEquippedUpgrade(const strutils::StringId& upgradeNameId) const;
+
+    std::unordered_set<size_t>& GetSeenEventIndices();
+    bool HasSeenEventIndex(const size_t eventIndex) const;
+
+    float GetGameSpeedMultiplier() const;
+    void SetGameSpeedMultiplier(const float gameSpeedMultiplier);
+
+    float GetBossMaxHealth() const;
+    void SetBossMaxHealth(const float bossMaxHealth);
+
+    float GetBossCurrentHealth() const;
+    void SetBossCurrentHealth(const float bossCurrentHealth);
+
+    float GetPlayerShieldHealth() const;
+    void SetPlayerShieldHealth(const float playerShieldHealth);
+
+    float GetPlayerMaxHealth() const;
+    void SetPlayerMaxHealth(const float playerMaxHealth);
+
+    float GetPlayerCurrentHealth() const;
+    void SetPlayerCurrentHealth(const float playerCurrentHealth);
+
+    float GetPlayerDisplayedHealth() const;
+    void SetPlayerDisplayedHealth(const float playerDisplayedHealth);
+
+    float GetPlayerAttackStat() const;
+    void SetPlayerAttackStat(const float playerAttackStat);
+
+    float GetPlayerBulletSpeedStat() const;
+    void SetPlayerBulletSpeedStat(const float playerBulletSpeedStat);
+
+    float GetPlayerMovementSpeedStat() const;
+    void SetPlayerMovementSpeedStat(const float playerMovementStat);
+
+    long GetCrystalCount() const;
+    void SetCrystalCount(const long crystalCount);
+
+    float GetDisplayedCrystalCount() const;
+    void SetDisplayedCrystalCount(const float displayedCrystalCount);
+
+    MapCoord GetCurrentMapCoord() const;
+    void SetCurrentMapCoord(const MapCoord& mapCoord);
+
+    int GetMapGenerationSeed() const;
+    void SetMapGenerationSeed(const int mapGenerationSeed);
+
+    int GetMapLevel() const;
+    void SetMapLevel(const int mapLevel);
+
+    int GetBackgroundIndex() const;
+    void SetBackgroundIndex(const int backgroundIndex);
+
+    bool GetGodeMode() const;
+    void SetGodMode(const bool godMode);
+
+    bool GetAccelerometerControl() const;
+    void SetAccelerometerControl(const bool accelerometerControl);
+
+    bool GetErasedLabsOnCurrentMap() const;
+    void SetErasedLabsOnCurrentMap(const bool erasedLabsOnCurrentMap);
+
+    int GetResearchCostMultiplier() const;
+    void SetResearchCostMultiplier(const int researchCostMultiplier);
+
+    /// Headless instances simulate levels without a window, GPU or audio, and must leave
+    /// the player's persisted progress/snapshots untouched.
+    bool IsHeadless() const;
+    void SetHeadless(const bool headless);
+
+private:
+    InputContext mInputContext;
+    SDL_Window* mWindow;
+    glm::vec2 mWindowDimensions;
+    std::unordered_map<SceneObjectType, Camera> mSceneObjectTypeToCameraMap;
+    std::unordered_set<size_t> mSeenEventIndices;
+    std::vector<UpgradeDefinition> mEquippedUpgrades;
+    std::vector<UpgradeDefinition> mAvailableUpgrades;
+    std::vector<UpgradeDefinition> mEventOnlyUpgrades;
+    MapCoord mCurrentMapCoord;
+    int mMapGenerationSeed;
+    int mMapLevel;
+    int mBackgroundIndex;
+    int mResearchCostMultiplier;
+    long mCrystalCount;
+    float mDisplayedCrystalCount;
+    float mGameSpeedMultiplier;
+    float mBossMaxHealth;
+    float mBossCurrentHealth;
+    float mPlayerShieldHealth;
+    float mPlayerMaxHealth;
+    float mPlayerCurrentHealth;
+    float mPlayerDisplayedHealth;
+    float mPlayerAttackStat;
+    float mPlayerBulletSpeedStat;
+    float mPlayerMovementStat;
+    bool mGodMode;
+    bool mErasedLabsOnCurrentMap;
+    bool mAccelerometerControl;
+    bool mHeadless;
+};
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* GameContext_h */
@@ -6,498 +6,495 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "GameSingletons.h"
-#include "GameConstants.h"
-
-///------------------------------------------------------------------------------------------------
-
-InputContext GameSingletons::mInputContext = {};
-SDL_Window* GameSingletons::mWindow = nullptr;
-glm::vec2 GameSingletons::mWindowDimensions = glm::vec2();
-std::unordered_map<SceneObjectType, Camera> GameSingletons::mSceneObjectTypeToCameraMap = {};
-std::unordered_set<size_t> GameSingletons::mSeenEventIndices = {};
-std::vector<UpgradeDefinition> GameSingletons::mEquippedUpgrades = {};
-std::vector<UpgradeDefinition> GameSingletons::mAvailableUpgrades = {};
-std::vector<UpgradeDefinition> GameSingletons::mEventOnlyUpgrades = {};
-MapCoord GameSingletons::mCurrentMapCoord = MapCoord(game_constants::DEFAULT_MAP_COORD_COL, game_constants::DEFAULT_MAP_COORD_ROW);
-int GameSingletons::mMapGenerationSeed = 0;
-int GameSingletons::mMapLevel = 0;
-int GameSingletons::mBackgroundIndex = 0;
-int GameSingletons::mResearchCostMultiplier = 1;
-long GameSingletons::mCrystalCount = 0;
-float GameSingletons::mDisplayedCrystalCount = 0;
-float GameSingletons::mGameSpeedMultiplier = 1.0f;
-float GameSingletons::mBossMaxHealth = 0.0f;
-float GameSingletons::mBossCurrentHealth = 1.0f;
-float GameSingletons::mPlayerShieldHealth = 0.0f;
-float GameSingletons::mPlayerMaxHealth = 1.0f;
-float GameSingletons::mPlayerCurrentHealth = 1.0f;
-float GameSingletons::mPlayerDisplayedHealth = 1.0f;
-float GameSingletons::mPlayerAttackStat = 0.0f;
-float GameSingletons::mPlayerBulletSpeedStat = 0.0f;
-float GameSingletons::mPlayerMovementStat = 0.0f;
-bool GameSingletons::mGodMode = false;
-bool GameSingletons::mErasedLabsOnCurrentMap = false;
-bool GameSingletons::mAccelerometerControl = false;
+
+#include <cassert>
+
+///------------------------------------------------------------------------------------------------
+
+static thread_local GameContext* sGameContext = nullptr;
+
+///------------------------------------------------------------------------------------------------
+
+GameContext& GameSingletons::GetGameContext()
+{
+    assert(sGameContext && "No game context bound to this thread");
+    return *sGameContext;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameSingletons::SetGameContext(GameContext* gameContext)
+{
+    sGameContext = gameContext;
+}
 
 ///------------------------------------------------------------------------------------------------
 
 const InputContext& GameSingletons::GetInputContext()
 {
-    return mInputContext;
+    return GetGameContext().GetInputContext();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetInputContextEvent(Uint32 event)
 {
-    mInputContext.mEventType = event;
+    GetGameContext().SetInputContextEvent(event);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetInputContextTouchPos(const glm::vec2& touchPos)
 {
-    mInputContext.mTouchPos = touchPos;
+    GetGameContext().SetInputContextTouchPos(touchPos);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetInputContextText(const std::string& text)
 {
-    mInputContext.mText = text;
+    GetGameContext().SetInputContextText(text);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetInputContextKey(const SDL_Scancode keyCode)
 {
-    mInputContext.mKeyCode = keyCode;
+    GetGameContext().SetInputContextKey(keyCode);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetInputContextPinchDistance(const float pinchDistance)
 {
-    mInputContext.mPinchDistance = pinchDistance;
+    GetGameContext().SetInputContextPinchDistance(pinchDistance);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetInputContextJoystick(SDL_Joystick* joystick)
 {
-    mInputContext.mJoystick = joystick;
+    GetGameContext().SetInputContextJoystick(joystick);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetInputContextRawAccelerometerValues(const glm::vec2& accelerometerValues)
 {
-    mInputContext.mRawAccelerometerValues = accelerometerValues;
+    GetGameContext().SetInputContextRawAccelerometerValues(accelerometerValues);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetInputContextMultiGestureActive(const bool multiGestureActive)
 {
-    mInputContext.mMultiGestureActive = multiGestureActive;
+    GetGameContext().SetInputContextMultiGestureActive(multiGestureActive);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::ConsumeInput()
 {
-    SetInputContextEvent(SDL_FINGERUP);
+    GetGameContext().ConsumeInput();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 SDL_Window* GameSingletons::GetWindow()
 {
-    return mWindow;
+    return GetGameContext().GetWindow();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetWindow(SDL_Window* window)
 {
-    mWindow = window;
+    GetGameContext().SetWindow(window);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 const glm::vec2& GameSingletons::GetWindowDimensions()
 {
-    return mWindowDimensions;
+    return GetGameContext().GetWindowDimensions();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetWindowDimensions(int windowWidth, int windowHeight)
 {
-    mWindowDimensions.x = windowWidth;
-    mWindowDimensions.y = windowHeight;
+    GetGameContext().SetWindowDimensions(windowWidth, windowHeight);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 std::optional<std::reference_wrapper<Camera>> GameSingletons::GetCameraForSceneObjectType(const SceneObjectType sceneObjectType)
 {
-    auto findIter = mSceneObjectTypeToCameraMap.find(sceneObjectType);
-    if (findIter != mSceneObjectTypeToCameraMap.end())
-    {
-        return std::optional<std::reference_wrapper<Camera>>{findIter->second};
-    }
-    return std::nullopt;
+    return GetGameContext().GetCameraForSceneObjectType(sceneObjectType);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetCameraForSceneObjectType(const SceneObjectType sceneObjectType, Camera&& camera)
 {
-    mSceneObjectTypeToCameraMap[sceneObjectType] = camera;
+    GetGameContext().SetCameraForSceneObjectType(sceneObjectType, std::move(camera));
 }
 
 ///------------------------------------------------------------------------------------------------
 
 std::unordered_set<size_t>& GameSingletons::GetSeenEventIndices()
 {
-    return mSeenEventIndices;
+    return GetGameContext().GetSeenEventIndices();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 bool GameSingletons::HasSeenEventIndex(const size_t eventIndex)
 {
-    return mSeenEventIndices.count(eventIndex) != 0;
+    return GetGameContext().HasSeenEventIndex(eventIndex);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 std::vector<UpgradeDefinition>& GameSingletons::GetEquippedUpgrades()
 {
-    return mEquippedUpgrades;
+    return GetGameContext().GetEquippedUpgrades();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 std::vector<UpgradeDefinition>& GameSingletons::GetAvailableUpgrades()
 {
-    return mAvailableUpgrades;
+    return GetGameContext().GetAvailableUpgrades();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 const std::vector<UpgradeDefinition>& GameSingletons::GetEventOnlyUpgrades()
 {
-    return mEventOnlyUpgrades;
+    return GetGameContext().GetEventOnlyUpgrades();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetEquippedUpgrades(const std::vector<UpgradeDefinition>& upgrades)
 {
-    mEquippedUpgrades = upgrades;
+    GetGameContext().SetEquippedUpgrades(upgrades);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetAvailableUpgrades(const std::vector<UpgradeDefinition>& upgrades)
 {
-    mAvailableUpgrades = upgrades;
+    GetGameContext().SetAvailableUpgrades(upgrades);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetEventOnlyUpgrades(const std::vector<UpgradeDefinition>& upgrades)
 {
-    mEventOnlyUpgrades = upgrades;
+    GetGameContext().SetEventOnlyUpgrades(upgrades);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 bool GameSingletons::HasEquippedUpgrade(const strutils::StringId& upgradeNameId)
 {
-    return std::find_if(mEquippedUpgrades.cbegin(), mEquippedUpgrades.cend(), [&](const UpgradeDefinition& upgradeDefinition){ return upgradeDefinition.mUpgradeNameId == upgradeNameId; }) != mEquippedUpgrades.cend();
+    return GetGameContext().HasEquippedUpgrade(upgradeNameId);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 float GameSingletons::GetGameSpeedMultiplier()
 {
-    return mGameSpeedMultiplier;
+    return GetGameContext().GetGameSpeedMultiplier();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetGameSpeedMultiplier(const float gameSpeedMultiplier)
 {
-    mGameSpeedMultiplier = gameSpeedMultiplier;
+    GetGameContext().SetGameSpeedMultiplier(gameSpeedMultiplier);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 float GameSingletons::GetBossMaxHealth()
 {
-    return mBossMaxHealth;
+    return GetGameContext().GetBossMaxHealth();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetBossMaxHealth(const float bossMaxHealth)
 {
-    mBossMaxHealth = bossMaxHealth;
+    GetGameContext().SetBossMaxHealth(bossMaxHealth);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 float GameSingletons::GetBossCurrentHealth()
 {
-    return mBossCurrentHealth;
+    return GetGameContext().GetBossCurrentHealth();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetBossCurrentHealth(const float bossCurrentHealth)
 {
-    mBossCurrentHealth = bossCurrentHealth;
+    GetGameContext().SetBossCurrentHealth(bossCurrentHealth);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetPlayerShieldHealth(const float playerShieldHealth)
 {
-    mPlayerShieldHealth = playerShieldHealth;
+    GetGameContext().SetPlayerShieldHealth(playerShieldHealth);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 float GameSingletons::GetPlayerShieldHealth()
 {
-    return mPlayerShieldHealth;
+    return GetGameContext().GetPlayerShieldHealth();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 float GameSingletons::GetPlayerMaxHealth()
 {
-    return mPlayerMaxHealth;
+    return GetGameContext().GetPlayerMaxHealth();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetPlayerMaxHealth(const float playerMaxHealth)
 {
-    mPlayerMaxHealth = playerMaxHealth;
+    GetGameContext().SetPlayerMaxHealth(playerMaxHealth);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 float GameSingletons::GetPlayerCurrentHealth()
 {
-    return mPlayerCurrentHealth;
+    return GetGameContext().GetPlayerCurrentHealth();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetPlayerCurrentHealth(const float playerCurrentHealth)
 {
-    mPlayerCurrentHealth = playerCurrentHealth;
+    GetGameContext().SetPlayerCurrentHealth(playerCurrentHealth);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 float GameSingletons::GetPlayerDisplayedHealth()
 {
-    return mPlayerDisplayedHealth;
+    return GetGameContext().GetPlayerDisplayedHealth();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetPlayerDisplayedHealth(const float playerDisplayedHealth)
 {
-    mPlayerDisplayedHealth = playerDisplayedHealth;
+    GetGameContext().SetPlayerDisplayedHealth(playerDisplayedHealth);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 float GameSingletons::GetPlayerAttackStat()
 {
-    return mPlayerAttackStat;
+    return GetGameContext().GetPlayerAttackStat();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetPlayerAttackStat(const float playerAttackStat)
 {
-    mPlayerAttackStat = playerAttackStat;
+    GetGameContext().SetPlayerAttackStat(playerAttackStat);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 float GameSingletons::GetPlayerBulletSpeedStat()
 {
-    return mPlayerBulletSpeedStat;
+    return GetGameContext().GetPlayerBulletSpeedStat();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetPlayerBulletSpeedStat(const float playerBulletSpeedStat)
 {
-    mPlayerBulletSpeedStat = playerBulletSpeedStat;
+    GetGameContext().SetPlayerBulletSpeedStat(playerBulletSpeedStat);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 float GameSingletons::GetPlayerMovementSpeedStat()
 {
-    return mPlayerMovementStat;
+    return GetGameContext().GetPlayerMovementSpeedStat();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetPlayerMovementSpeedStat(const float playerMovementStat)
 {
-    mPlayerMovementStat = playerMovementStat;
+    GetGameContext().SetPlayerMovementSpeedStat(playerMovementStat);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 long GameSingletons::GetCrystalCount()
 {
-    return mCrystalCount;
+    return GetGameContext().GetCrystalCount();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetCrystalCount(const long crystalCount)
 {
-    mCrystalCount = crystalCount;
+    GetGameContext().SetCrystalCount(crystalCount);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 float GameSingletons::GetDisplayedCrystalCount()
 {
-    return mDisplayedCrystalCount;
+    return GetGameContext().GetDisplayedCrystalCount();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetDisplayedCrystalCount(const float displayedCrystalCount)
 {
-    mDisplayedCrystalCount = displayedCrystalCount;
+    GetGameContext().SetDisplayedCrystalCount(displayedCrystalCount);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 MapCoord GameSingletons::GetCurrentMapCoord()
 {
-    return mCurrentMapCoord;
+    return GetGameContext().GetCurrentMapCoord();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetCurrentMapCoord(const MapCoord &mapCoord)
 {
-    mCurrentMapCoord = mapCoord;
+    GetGameContext().SetCurrentMapCoord(mapCoord);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 int GameSingletons::GetMapGenerationSeed()
 {
-    return mMapGenerationSeed;
+    return GetGameContext().GetMapGenerationSeed();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetMapGenerationSeed(const int mapGenerationSeed)
 {
-    mMapGenerationSeed = mapGenerationSeed;
+    GetGameContext().SetMapGenerationSeed(mapGenerationSeed);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 int GameSingletons::GetMapLevel()
 {
-    return mMapLevel;
+    return GetGameContext().GetMapLevel();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetMapLevel(const int mapLevel)
 {
-    mMapLevel = mapLevel;
+    GetGameContext().SetMapLevel(mapLevel);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 int GameSingletons::GetBackgroundIndex()
 {
-    return mBackgroundIndex;
+    return GetGameContext().GetBackgroundIndex();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetBackgroundIndex(const int backgroundIndex)
 {
-    mBackgroundIndex = backgroundIndex;
+    GetGameContext().SetBackgroundIndex(backgroundIndex);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 bool GameSingletons::GetGodeMode()
 {
-    return mGodMode;
+    return GetGameContext().GetGodeMode();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetGodMode(const bool godMode)
 {
-    mGodMode = godMode;
+    GetGameContext().SetGodMode(godMode);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 bool GameSingletons::GetErasedLabsOnCurrentMap()
 {
-    return mErasedLabsOnCurrentMap;
+    return GetGameContext().GetErasedLabsOnCurrentMap();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetErasedLabsOnCurrentMap(const bool erasedLabsOnCurrentMap)
 {
-    mErasedLabsOnCurrentMap = erasedLabsOnCurrentMap;
+    GetGameContext().SetErasedLabsOnCurrentMap(erasedLabsOnCurrentMap);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 bool GameSingletons::GetAccelerometerControl()
 {
-    return mAccelerometerControl;
+    return GetGameContext().GetAccelerometerControl();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetAccelerometerControl(const bool accelerometerControl)
 {
-    mAccelerometerControl = accelerometerControl;
+    GetGameContext().SetAccelerometerControl(accelerometerControl);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 int GameSingletons::GetResearchCostMultiplier()
 {
-    return mResearchCostMultiplier;
+    return GetGameContext().GetResearchCostMultiplier();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void GameSingletons::SetResearchCostMultiplier(const int researchCostMultiplier)
 {
-    mResearchCostMultiplier = researchCostMultiplier;
+    GetGameContext().SetResearchCostMultiplier(researchCostMultiplier);
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool GameSingletons::IsHeadless()
+{
+    return GetGameContext().IsHeadless();
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameSingletons::SetHeadless(const bool headless)
+{
+    GetGameContext().SetHeadless(headless);
 }
 
 ///------------------------------------------------------------------------------------------------
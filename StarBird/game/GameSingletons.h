@@ -10,25 +10,23 @@
 
 ///------------------------------------------------------------------------------------------------
 
-#include "Camera.h"
-#include "InputContext.h"
-#include "Map.h"
-#include "SceneObject.h"
-#include "UpgradeDefinition.h"
-#include "../utils/MathUtils.h"
-#include "../utils/StringUtils.h"
-
-#include <optional>
-#include <unordered_map>
-#include <unordered_set>
-#include <vector>
+#include "GameContext.h"
 
 ///------------------------------------------------------------------------------------------------
 
-struct SDL_Window;
+/// Static access to the GameContext of the game instance running on the calling thread, for code that
+/// has no Scene (or context) at hand. Each of the accessors below forwards to the same named one of
+/// the bound context.
 class GameSingletons
 {
 public:
+    /// @returns the context bound to the calling thread.
+    static GameContext& GetGameContext();
+    
+    /// Binds the given context to the calling thread. Games bind their own context on construction.
+    /// @param[in] gameContext the context to bind (or nullptr to unbind).
+    static void SetGameContext(GameContext* gameContext);
+    
     static const InputContext& GetInputContext();
     static void SetInputContextEvent(Uint32 event);
     static void SetInputContextTouchPos(const glm::vec2& touchPos);
@@ -120,35 +118,8 @@ public:
     static int GetResearchCostMultiplier();
     static void SetResearchCostMultiplier(const int researchCostMultiplier);
     
-private:
-    static InputContext mInputContext;
-    static SDL_Window* mWindow;
-    static glm::vec2 mWindowDimensions;
-    static std::unordered_map<SceneObjectType, Camera> mSceneObjectTypeToCameraMap;
-    static std::unordered_set<size_t> mSeenEventIndices;
-    static std::vector<UpgradeDefinition> mEquippedUpgrades;
-    static std::vector<UpgradeDefinition> mAvailableUpgrades;
-    static std::vector<UpgradeDefinition> mEventOnlyUpgrades;
-    static MapCoord mCurrentMapCoord;
-    static int mMapGenerationSeed;
-    static int mMapLevel;
-    static int mBackgroundIndex;
-    static int mResearchCostMultiplier;
-    static long mCrystalCount;
-    static float mDisplayedCrystalCount;
-    static float mGameSpeedMultiplier;
-    static float mBossMaxHealth;
-    static float mBossCurrentHealth;
-    static float mPlayerShieldHealth;
-    static float mPlayerMaxHealth;
-    static float mPlayerCurrentHealth;
-    static float mPlayerDisplayedHealth;
-    static float mPlayerAttackStat;
-    static float mPlayerBulletSpeedStat;
-    static float mPlayerMovementStat;
-    static bool mGodMode;
-    static bool mErasedLabsOnCurrentMap;
-    static bool mAccelerometerControl;
+    static bool IsHeadless();
+    static void SetHeadless(const bool headless);
 };
 
 ///------------------------------------------------------------------------------------------------
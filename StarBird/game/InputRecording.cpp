@@ -0,0 +1,639 @@
+///------------------------------------------------------------------------------------------------
+///  InputRecording.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "InputRecording.h"
+#include "FrameWorkScheduler.h"
+#include "GameSingletons.h"
+#include "LevelGeneration.h"
+#include "PersistenceUtils.h"
+#include "dataloaders/UpgradesLoader.h"
+#include "../utils/Logging.h"
+#include "../utils/MathUtils.h"
+#include "../utils/ObjectiveCUtils.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+///------------------------------------------------------------------------------------------------
+
+static const std::string RECORDING_FILE_NAME_PREFIX = "input_recording_";
+static const std::string RECORDING_FILE_EXTENSION = ".bin";
+static const std::string REPLAY_FRAME_TIMES_FILE_NAME_SUFFIX = "_frame_times.csv";
+
+static const uint32_t RECORDING_FILE_MAGIC = 0x52494253; // "SBIR"
+static const uint16_t RECORDING_FILE_VERSION = 1;
+
+// Bits of the input context fields that changed in a frame
+static const uint8_t TEXT_FIELD = 1 << 0;
+static const uint8_t TOUCH_POS_FIELD = 1 << 1;
+static const uint8_t ACCELEROMETER_FIELD = 1 << 2;
+static const uint8_t EVENT_TYPE_FIELD = 1 << 3;
+static const uint8_t KEY_CODE_FIELD = 1 << 4;
+static const uint8_t PINCH_DISTANCE_FIELD = 1 << 5;
+static const uint8_t MULTI_GESTURE_FIELD = 1 << 6;
+static const uint8_t APP_STATE_EVENT_FIELD = 1 << 7;
+static const uint8_t ALL_INPUT_CONTEXT_FIELDS = TEXT_FIELD | TOUCH_POS_FIELD | ACCELEROMETER_FIELD | EVENT_TYPE_FIELD | KEY_CODE_FIELD | PINCH_DISTANCE_FIELD | MULTI_GESTURE_FIELD;
+
+///------------------------------------------------------------------------------------------------
+
+static std::string BuildRecordingFilePath(const std::string& recordingName)
+{
+    return objectiveC_utils::BuildLocalFileSaveLocation(RECORDING_FILE_NAME_PREFIX + recordingName + RECORDING_FILE_EXTENSION);
+}
+
+///------------------------------------------------------------------------------------------------
+
+static uint8_t FindChangedInputContextFields(const InputContext& previousInputContext, const InputContext& inputContext)
+{
+    uint8_t changedFields = 0;
+    changedFields |= previousInputContext.mText != inputContext.mText ? TEXT_FIELD : 0;
+    changedFields |= previousInputContext.mTouchPos != inputContext.mTouchPos ? TOUCH_POS_FIELD : 0;
+    changedFields |= previousInputContext.mRawAccelerometerValues != inputContext.mRawAccelerometerValues ? ACCELEROMETER_FIELD : 0;
+    changedFields |= previousInputContext.mEventType != inputContext.mEventType ? EVENT_TYPE_FIELD : 0;
+    changedFields |= previousInputContext.mKeyCode != inputContext.mKeyCode ? KEY_CODE_FIELD : 0;
+    changedFields |= previousInputContext.mPinchDistance != inputContext.mPinchDistance ? PINCH_DISTANCE_FIELD : 0;
+    changedFields |= previousInputContext.mMultiGestureActive != inputContext.mMultiGestureActive ? MULTI_GESTURE_FIELD : 0;
+    return changedFields;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void WriteInputContextFields(SnapshotWriter& writer, const InputContext& inputContext, const uint8_t fields)
+{
+    if (fields & TEXT_FIELD) writer.WriteString(inputContext.mText);
+    if (fields & TOUCH_POS_FIELD) writer.Write(inputContext.mTouchPos);
+    if (fields & ACCELEROMETER_FIELD) writer.Write(inputContext.mRawAccelerometerValues);
+    if (fields & EVENT_TYPE_FIELD) writer.Write(inputContext.mEventType);
+    if (fields & KEY_CODE_FIELD) writer.Write(static_cast<int32_t>(inputContext.mKeyCode));
+    if (fields & PINCH_DISTANCE_FIELD) writer.Write(inputContext.mPinchDistance);
+    if (fields & MULTI_GESTURE_FIELD) writer.Write(inputContext.mMultiGestureActive);
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void ReadInputContextFields(SnapshotReader& reader, const uint8_t fields, InputContext& outInputContext)
+{
+    if (fields & TEXT_FIELD) outInputContext.mText = reader.ReadString();
+    if (fields & TOUCH_POS_FIELD) outInputContext.mTouchPos = reader.Read<glm::vec2>();
+    if (fields & ACCELEROMETER_FIELD) outInputContext.mRawAccelerometerValues = reader.Read<glm::vec2>();
+    if (fields & EVENT_TYPE_FIELD) outInputContext.mEventType = reader.Read<Uint32>();
+    if (fields & KEY_CODE_FIELD) outInputContext.mKeyCode = static_cast<SDL_Scancode>(reader.Read<int32_t>());
+    if (fields & PINCH_DISTANCE_FIELD) outInputContext.mPinchDistance = reader.Read<float>();
+    if (fields & MULTI_GESTURE_FIELD) outInputContext.mMultiGestureActive = reader.Read<bool>();
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void ApplyInputContext(const InputContext& inputContext)
+{
+    GameSingletons::SetInputContextText(inputContext.mText);
+    GameSingletons::SetInputContextTouchPos(inputContext.mTouchPos);
+    GameSingletons::SetInputContextRawAccelerometerValues(inputContext.mRawAccelerometerValues);
+    GameSingletons::SetInputContextEvent(inputContext.mEventType);
+    GameSingletons::SetInputContextKey(inputContext.mKeyCode);
+    GameSingletons::SetInputContextPinchDistance(inputContext.mPinchDistance);
+    GameSingletons::SetInputContextMultiGestureActive(inputContext.mMultiGestureActive);
+}
+
+///------------------------------------------------------------------------------------------------
+
+/// Everything (other than the level definition itself) that levels read from the player's progress
+static void WritePlayerState(SnapshotWriter& writer)
+{
+    writer.Write(GameSingletons::GetPlayerMaxHealth());
+    writer.Write(GameSingletons::GetPlayerCurrentHealth());
+    writer.Write(GameSingletons::GetPlayerDisplayedHealth());
+    writer.Write(GameSingletons::GetPlayerShieldHealth());
+    writer.Write(GameSingletons::GetPlayerAttackStat());
+    writer.Write(GameSingletons::GetPlayerMovementSpeedStat());
+    writer.Write(GameSingletons::GetPlayerBulletSpeedStat());
+    writer.Write(static_cast<int64_t>(GameSingletons::GetCrystalCount()));
+    writer.Write(GameSingletons::GetDisplayedCrystalCount());
+    writer.Write(GameSingletons::GetGameSpeedMultiplier());
+    writer.Write(GameSingletons::GetGodeMode());
+    writer.Write(GameSingletons::GetAccelerometerControl());
+    writer.Write(static_cast<int32_t>(GameSingletons::GetBackgroundIndex()));
+    writer.Write(static_cast<int32_t>(GameSingletons::GetMapLevel()));
+    writer.Write(static_cast<int32_t>(GameSingletons::GetCurrentMapCoord().mCol));
+    writer.Write(static_cast<int32_t>(GameSingletons::GetCurrentMapCoord().mRow));
+
+    const auto& equippedUpgrades = GameSingletons::GetEquippedUpgrades();
+    writer.Write(static_cast<uint32_t>(equippedUpgrades.size()));
+    for (const auto& equippedUpgrade: equippedUpgrades)
+    {
+        writer.WriteStringId(equippedUpgrade.mUpgradeNameId);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+/// Reads back a player state written by WritePlayerState, only applying it if asked to
+/// (so that it can also be validated up front).
+/// @returns whether the player state could be read.
+static bool ReadPlayerState(SnapshotReader& reader, const bool apply)
+{
+    const auto playerMaxHealth = reader.Read<float>();
+    const auto playerCurrentHealth = reader.Read<float>();
+    const auto playerDisplayedHealth = reader.Read<float>();
+    const auto playerShieldHealth = reader.Read<float>();
+    const auto playerAttackStat = reader.Read<float>();
+    const auto playerMovementSpeedStat = reader.Read<float>();
+    const auto playerBulletSpeedStat = reader.Read<float>();
+    const auto crystalCount = reader.Read<int64_t>();
+    const auto displayedCrystalCount = reader.Read<float>();
+    const auto gameSpeedMultiplier = reader.Read<float>();
+    const auto godMode = reader.Read<bool>();
+    const auto accelerometerControl = reader.Read<bool>();
+    const auto backgroundIndex = reader.Read<int32_t>();
+    const auto mapLevel = reader.Read<int32_t>();
+    const auto mapCoordCol = reader.Read<int32_t>();
+    const auto mapCoordRow = reader.Read<int32_t>();
+
+    UpgradesLoader loader;
+    const auto& allUpgrades = loader.LoadAllUpgrades();
+
+    std::vector<UpgradeDefinition> equippedUpgrades;
+    const auto equippedUpgradeCount = reader.ReadCount();
+    for (uint32_t i = 0; i < equippedUpgradeCount && reader.IsValid(); ++i)
+    {
+        const auto upgradeNameId = reader.ReadRawStringId();
+        const auto upgradeIter = std::find_if(allUpgrades.cbegin(), allUpgrades.cend(), [&](const UpgradeDefinition& upgradeDefinition){ return upgradeDefinition.mUpgradeNameId == upgradeNameId; });
+        if (upgradeIter == allUpgrades.cend())
+        {
+            Log(LogType::ERROR, "Unknown upgrade %s in input recording", upgradeNameId.GetString().c_str());
+            reader.Invalidate();
+            break;
+        }
+
+        equippedUpgrades.push_back(*upgradeIter);
+    }
+
+    if (!reader.IsValid() || !apply)
+    {
+        return reader.IsValid();
+    }
+
+    GameSingletons::SetPlayerMaxHealth(playerMaxHealth);
+    GameSingletons::SetPlayerCurrentHealth(playerCurrentHealth);
+    GameSingletons::SetPlayerDisplayedHealth(playerDisplayedHealth);
+    GameSingletons::SetPlayerShieldHealth(playerShieldHealth);
+    GameSingletons::SetPlayerAttackStat(playerAttackStat);
+    GameSingletons::SetPlayerMovementSpeedStat(playerMovementSpeedStat);
+    GameSingletons::SetPlayerBulletSpeedStat(playerBulletSpeedStat);
+    GameSingletons::SetCrystalCount(static_cast<long>(crystalCount));
+    GameSingletons::SetDisplayedCrystalCount(displayedCrystalCount);
+    GameSingletons::SetGameSpeedMultiplier(gameSpeedMultiplier);
+    GameSingletons::SetGodMode(godMode);
+    GameSingletons::SetAccelerometerControl(accelerometerControl);
+    GameSingletons::SetBackgroundIndex(backgroundIndex);
+    GameSingletons::SetMapLevel(mapLevel);
+    GameSingletons::SetCurrentMapCoord(MapCoord(mapCoordCol, mapCoordRow));
+    GameSingletons::SetEquippedUpgrades(equippedUpgrades);
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+InputRecorder& InputRecorder::GetInstance()
+{
+    static thread_local InputRecorder instance;
+    return instance;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void InputRecorder::Arm(const std::string& recordingName)
+{
+    mRecordingName = recordingName;
+    mArmed = true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool InputRecorder::IsArmed() const
+{
+    return mArmed;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool InputRecorder::IsRecording() const
+{
+    return mRecording;
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t InputRecorder::GetLevelSceneChangeCount() const
+{
+    return mLevelSceneChangeCount;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void InputRecorder::OnLevelStarted(const LevelDefinition& levelDefinition, const size_t sceneChangeCount)
+{
+    if (!mArmed)
+    {
+        return;
+    }
+
+    mArmed = false;
+
+    // Recorded levels run off a fresh seed, so that replays don't depend on anything that ran before them
+    const auto seed = static_cast<uint32_t>(math::RandomInt());
+    math::GetRandomEngine().seed(seed);
+    math::SetControlSeed(static_cast<int>(seed));
+
+    std::vector<unsigned char> serializedLevel;
+    level_generation::SerializeLevel(levelDefinition, serializedLevel);
+
+    SnapshotWriter playerStateWriter;
+    WritePlayerState(playerStateWriter);
+
+    mHeaderWriter = SnapshotWriter();
+    mHeaderWriter.Write(seed);
+    mHeaderWriter.WriteBytes(serializedLevel);
+    mHeaderWriter.Write(GameSingletons::GetWindowDimensions());
+    mHeaderWriter.WriteBytes(playerStateWriter.GetData());
+    WriteInputContextFields(mHeaderWriter, GameSingletons::GetInputContext(), ALL_INPUT_CONTEXT_FIELDS);
+
+    mFramesWriter = SnapshotWriter();
+    mFrameCount = 0;
+    mLevelSceneChangeCount = sceneChangeCount;
+    mRecording = true;
+
+    // The level starts midway through a frame, with the frame's input already in place
+    mFrameInProgress = true;
+    mFrameChangedFields = 0;
+    mFrameAppStateEvent = 0;
+    mFrameStepCount = 0;
+
+    // Deferred work needs to run on the very same frames when replaying
+    FrameWorkScheduler::GetInstance().SetUnbudgeted(true);
+
+    Log(LogType::INFO, "Recording input of level %s as %s", levelDefinition.mLevelName.GetString().c_str(), mRecordingName.c_str());
+}
+
+///------------------------------------------------------------------------------------------------
+
+void InputRecorder::RecordFrameInput(const InputContext& preEventsInputContext, const InputContext& inputContext, const Uint32 appStateEvent)
+{
+    if (!mRecording)
+    {
+        return;
+    }
+
+    mFrameInProgress = true;
+    mFrameChangedFields = FindChangedInputContextFields(preEventsInputContext, inputContext) | (appStateEvent != 0 ? APP_STATE_EVENT_FIELD : 0);
+    mFrameInputContext = inputContext;
+    mFrameAppStateEvent = appStateEvent;
+    mFrameStepCount = 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void InputRecorder::OnSimulationStep()
+{
+    if (mFrameInProgress)
+    {
+        mFrameStepCount++;
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void InputRecorder::EndFrame(const float dtMillis)
+{
+    if (!mFrameInProgress)
+    {
+        return;
+    }
+
+    mFramesWriter.Write(mFrameChangedFields);
+    WriteInputContextFields(mFramesWriter, mFrameInputContext, mFrameChangedFields);
+    if (mFrameChangedFields & APP_STATE_EVENT_FIELD)
+    {
+        mFramesWriter.Write(mFrameAppStateEvent);
+    }
+    mFramesWriter.Write(mFrameStepCount);
+    mFramesWriter.Write(dtMillis);
+
+    mFrameCount++;
+    mFrameInProgress = false;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void InputRecorder::Stop(const std::optional<uint64_t>& simulationDigest)
+{
+    mArmed = false;
+
+    if (!mRecording)
+    {
+        return;
+    }
+
+    mRecording = false;
+    mFrameInProgress = false;
+    FrameWorkScheduler::GetInstance().SetUnbudgeted(false);
+
+    SnapshotWriter recordingWriter;
+    recordingWriter.WriteBytes(mHeaderWriter.GetData());
+    recordingWriter.Write(mFrameCount);
+    recordingWriter.WriteBytes(mFramesWriter.GetData());
+    recordingWriter.Write(simulationDigest.has_value());
+    recordingWriter.Write(simulationDigest.value_or(0));
+
+    const auto& recording = recordingWriter.GetData();
+
+    SnapshotWriter fileWriter;
+    fileWriter.Write(RECORDING_FILE_MAGIC);
+    fileWriter.Write(RECORDING_FILE_VERSION);
+    fileWriter.Write(level_snapshot::HashBytes(recording.data(), recording.size()));
+    fileWriter.WriteBytes(recording);
+
+    const auto& fileData = fileWriter.GetData();
+    if (!persistence_utils::WriteFileAtomically(BuildRecordingFilePath(mRecordingName), fileData.data(), fileData.size()))
+    {
+        Log(LogType::ERROR, "Could not write input recording %s", mRecordingName.c_str());
+        return;
+    }
+
+    Log(LogType::INFO, "Saved input recording %s (%d frames, %d bytes)", mRecordingName.c_str(), mFrameCount, static_cast<int>(fileData.size()));
+}
+
+///------------------------------------------------------------------------------------------------
+
+InputReplayer& InputReplayer::GetInstance()
+{
+    static thread_local InputReplayer instance;
+    return instance;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool InputReplayer::Load(const std::string& recordingName)
+{
+    if (mReplaying)
+    {
+        Log(LogType::ERROR, "Can't load input recording %s while replaying %s", recordingName.c_str(), mRecordingName.c_str());
+        return false;
+    }
+
+    std::ifstream recordingFile(BuildRecordingFilePath(recordingName), std::ios::binary);
+    if (!recordingFile.good())
+    {
+        Log(LogType::ERROR, "Could not find input recording %s", recordingName.c_str());
+        return false;
+    }
+
+    const std::vector<unsigned char> fileData((std::istreambuf_iterator<char>(recordingFile)), std::istreambuf_iterator<char>());
+
+    SnapshotReader fileReader(fileData.data(), fileData.size());
+    const auto magic = fileReader.Read<uint32_t>();
+    const auto version = fileReader.Read<uint16_t>();
+    const auto checksum = fileReader.Read<uint64_t>();
+    const auto recording = fileReader.ReadBytes();
+
+    if (!fileReader.IsValid() || !fileReader.IsAtEnd() || magic != RECORDING_FILE_MAGIC || version != RECORDING_FILE_VERSION || checksum != level_snapshot::HashBytes(recording.data(), recording.size()))
+    {
+        Log(LogType::ERROR, "Input recording %s is corrupt or outdated", recordingName.c_str());
+        return false;
+    }
+
+    SnapshotReader recordingReader(recording.data(), recording.size());
+    const auto header = recordingReader.ReadBytes();
+    const auto frameCount = recordingReader.Read<uint32_t>();
+    auto framesData = recordingReader.ReadBytes();
+    const auto hasSimulationDigest = recordingReader.Read<bool>();
+    const auto simulationDigest = recordingReader.Read<uint64_t>();
+
+    SnapshotReader headerReader(header.data(), header.size());
+    const auto seed = headerReader.Read<uint32_t>();
+    const auto serializedLevel = headerReader.ReadBytes();
+    const auto windowDimensions = headerReader.Read<glm::vec2>();
+    auto playerStateData = headerReader.ReadBytes();
+
+    InputContext initialInputContext = {};
+    ReadInputContextFields(headerReader, ALL_INPUT_CONTEXT_FIELDS, initialInputContext);
+
+    LevelDefinition levelDefinition;
+    SnapshotReader playerStateReader(playerStateData.data(), playerStateData.size());
+
+    auto valid = recordingReader.IsValid() && recordingReader.IsAtEnd() && headerReader.IsValid() && headerReader.IsAtEnd();
+    valid = valid && level_generation::DeserializeLevel(serializedLevel.data(), serializedLevel.size(), levelDefinition);
+    valid = valid && ReadPlayerState(playerStateReader, false) && playerStateReader.IsAtEnd();
+
+    // Dry run through all frames, so that a replay never stops midway on bad data
+    SnapshotReader framesReader(framesData.data(), framesData.size());
+    for (uint32_t i = 0; i < frameCount && valid && framesReader.IsValid(); ++i)
+    {
+        InputContext frameInputContext = {};
+        const auto changedFields = framesReader.Read<uint8_t>();
+        ReadInputContextFields(framesReader, changedFields, frameInputContext);
+        if (changedFields & APP_STATE_EVENT_FIELD)
+        {
+            framesReader.Read<Uint32>();
+        }
+        framesReader.Read<uint16_t>();
+        framesReader.Read<float>();
+    }
+    valid = valid && framesReader.IsValid() && framesReader.IsAtEnd();
+
+    if (!valid)
+    {
+        Log(LogType::ERROR, "Input recording %s is corrupt", recordingName.c_str());
+        return false;
+    }
+
+    mRecordingName = recordingName;
+    mPlayerStateData = std::move(playerStateData);
+    mFramesData = std::move(framesData);
+    mFramesReader.reset();
+    mLevelDefinition = std::move(levelDefinition);
+    mInitialInputContext = initialInputContext;
+    mWindowDimensions = windowDimensions;
+    mRecordedSimulationDigest = hasSimulationDigest ? std::make_optional(simulationDigest) : std::nullopt;
+    mSeed = seed;
+    mFrameCount = frameCount;
+    mPendingReplay = true;
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void InputReplayer::QueueLoad(const std::string& recordingName)
+{
+    mQueuedRecordingName = recordingName;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void InputReplayer::LoadQueued()
+{
+    if (!mQueuedRecordingName.empty())
+    {
+        Load(mQueuedRecordingName);
+        mQueuedRecordingName.clear();
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool InputReplayer::HasPendingReplay() const
+{
+    return mPendingReplay;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool InputReplayer::IsReplaying() const
+{
+    return mReplaying;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::string InputReplayer::BeginReplay()
+{
+    mPendingReplay = false;
+    mReplaying = true;
+
+    // The player's own progress gets replaced by the recorded player's state for the duration of
+    // the replay, so it needs to be safely on disk first (see Game::Run for restoring it)
+    persistence_utils::FlushPendingProgressSaves();
+
+    // Levels are laid out relative to the screen, so recordings only replay identically on the same screen size
+    if (mWindowDimensions != GameSingletons::GetWindowDimensions())
+    {
+        Log(LogType::WARNING, "Input recording %s was made on a %dx%d screen, so its replay will diverge", mRecordingName.c_str(), static_cast<int>(mWindowDimensions.x), static_cast<int>(mWindowDimensions.y));
+    }
+
+    SnapshotReader playerStateReader(mPlayerStateData.data(), mPlayerStateData.size());
+    ReadPlayerState(playerStateReader, true);
+    ApplyInputContext(mInitialInputContext);
+
+    mFramesReader.emplace(mFramesData.data(), mFramesData.size());
+    mUpdateTimeHistogram = FrameTimeHistogram();
+    mFrameTimeHistogram = FrameTimeHistogram();
+    mReplayedFrameCount = 0;
+
+    Log(LogType::INFO, "Replaying input recording %s (%d frames)", mRecordingName.c_str(), mFrameCount);
+    return level_generation::CacheLevel(LevelDefinition(mLevelDefinition)).mLevelName.GetString();
+}
+
+///------------------------------------------------------------------------------------------------
+
+void InputReplayer::OnLevelStarted(const size_t sceneChangeCount)
+{
+    if (!mReplaying)
+    {
+        return;
+    }
+
+    math::GetRandomEngine().seed(mSeed);
+    math::SetControlSeed(static_cast<int>(mSeed));
+    mLevelSceneChangeCount = sceneChangeCount;
+
+    FrameWorkScheduler::GetInstance().SetUnbudgeted(true);
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t InputReplayer::GetLevelSceneChangeCount() const
+{
+    return mLevelSceneChangeCount;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void InputReplayer::BeginFrame(const InputContext& preEventsInputContext)
+{
+    auto& framesReader = *mFramesReader;
+
+    // Whatever the device's own input events did this frame gets discarded
+    auto inputContext = preEventsInputContext;
+    const auto changedFields = framesReader.Read<uint8_t>();
+    ReadInputContextFields(framesReader, changedFields, inputContext);
+    mFrameAppStateEvent = (changedFields & APP_STATE_EVENT_FIELD) ? framesReader.Read<Uint32>() : 0;
+    mFrameStepCount = framesReader.Read<uint16_t>();
+    mFrameDtMillis = framesReader.Read<float>();
+
+    ApplyInputContext(inputContext);
+}
+
+///------------------------------------------------------------------------------------------------
+
+Uint32 InputReplayer::GetFrameAppStateEvent() const
+{
+    return mFrameAppStateEvent;
+}
+
+///------------------------------------------------------------------------------------------------
+
+int InputReplayer::GetFrameStepCount() const
+{
+    return mFrameStepCount;
+}
+
+///------------------------------------------------------------------------------------------------
+
+float InputReplayer::GetFrameDtMillis() const
+{
+    return mFrameDtMillis;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void InputReplayer::EndFrame(const float updateMillis, const float frameMillis)
+{
+    mUpdateTimeHistogram.AddSample(updateMillis);
+    mFrameTimeHistogram.AddSample(frameMillis);
+    mReplayedFrameCount++;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool InputReplayer::IsAtEnd() const
+{
+    return mReplayedFrameCount >= mFrameCount;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void InputReplayer::Finish(const std::optional<uint64_t>& simulationDigest)
+{
+    if (!mReplaying)
+    {
+        return;
+    }
+
+    mReplaying = false;
+    mFramesReader.reset();
+    FrameWorkScheduler::GetInstance().SetUnbudgeted(false);
+
+    Log(LogType::INFO, "Replayed %d/%d frames of input recording %s", mReplayedFrameCount, mFrameCount, mRecordingName.c_str());
+    Log(LogType::INFO, "%s", mUpdateTimeHistogram.GetSummary("Update").c_str());
+    Log(LogType::INFO, "%s", mFrameTimeHistogram.GetSummary("Frame").c_str());
+
+    if (mReplayedFrameCount < mFrameCount || simulationDigest != mRecordedSimulationDigest)
+    {
+        Log(LogType::WARNING, "Replay of input recording %s diverged from the recorded session", mRecordingName.c_str());
+    }
+
+    const auto frameTimesFilePath = objectiveC_utils::BuildLocalFileSaveLocation(RECORDING_FILE_NAME_PREFIX + mRecordingName + REPLAY_FRAME_TIMES_FILE_NAME_SUFFIX);
+    if (!frame_time_histogram::WriteCsv(frameTimesFilePath, { "update", "frame" }, { &mUpdateTimeHistogram, &mFrameTimeHistogram }))
+    {
+        Log(LogType::ERROR, "Could not write replay frame times to %s", frameTimesFilePath.c_str());
+    }
+}
+
+///------------------------------------------------------------------------------------------------
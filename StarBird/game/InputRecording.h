@@ -0,0 +1,179 @@
+///------------------------------------------------------------------------------------------------
+///  InputRecording.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef InputRecording_h
+#define InputRecording_h
+
+///------------------------------------------------------------------------------------------------
+
+#include "FrameTimeHistogram.h"
+#include "InputContext.h"
+#include "LevelSnapshot.h"
+#include "definitions/LevelDefinition.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+/// Records a level being played, for InputReplayer to play it back exactly the same way. Recordings
+/// start along with a level, capturing everything it gets played from (its definition, the player's
+/// state, the input context and a fresh random seed), and then log each frame as the changes its input
+/// events made to the input context, its dt and the number of simulation steps it ran. They end (and
+/// get saved) once the level is left or the debug console gets opened (which isn't replayable).
+class InputRecorder final
+{
+public:
+    /// The default method of getting a hold of this singleton.
+    /// @returns a reference to the single instance of this class on the calling thread (i.e. of the game instance running on it).
+    static InputRecorder& GetInstance();
+
+    ~InputRecorder() = default;
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder(InputRecorder&&) = delete;
+    const InputRecorder& operator = (const InputRecorder&) = delete;
+    InputRecorder& operator = (InputRecorder&&) = delete;
+
+    /// Arms the recorder, for the recording to start along with the next level.
+    /// @param[in] recordingName the name to save the recording under.
+    void Arm(const std::string& recordingName);
+
+    bool IsArmed() const;
+    bool IsRecording() const;
+
+    /// @returns the scene change count (see Scene::GetSceneChangeCount) the recorded level started on.
+    size_t GetLevelSceneChangeCount() const;
+
+    /// Starts the armed recording, if any. Called at the very start of every level, before anything in it gets randomized.
+    /// @param[in] levelDefinition the definition of the level being started.
+    /// @param[in] sceneChangeCount the scene change count the level starts on.
+    void OnLevelStarted(const LevelDefinition& levelDefinition, const size_t sceneChangeCount);
+
+    /// Records the changes the current frame's input events made to the input context.
+    /// @param[in] preEventsInputContext the input context before handling the frame's input events.
+    /// @param[in] inputContext the input context after handling them.
+    /// @param[in] appStateEvent the app foreground/background event of the frame, if any (0 otherwise).
+    void RecordFrameInput(const InputContext& preEventsInputContext, const InputContext& inputContext, const Uint32 appStateEvent);
+
+    void OnSimulationStep();
+    void EndFrame(const float dtMillis);
+
+    /// Stops the recording in progress (if any) and saves it. Also disarms the recorder.
+    /// @param[in] simulationDigest the digest of the level at the end of the recording (if still in it), for replays to check against.
+    void Stop(const std::optional<uint64_t>& simulationDigest);
+
+private:
+    InputRecorder() = default;
+
+private:
+    std::string mRecordingName;
+    SnapshotWriter mHeaderWriter;
+    SnapshotWriter mFramesWriter;
+    InputContext mFrameInputContext = {};
+    Uint32 mFrameAppStateEvent = 0;
+    size_t mLevelSceneChangeCount = 0;
+    uint32_t mFrameCount = 0;
+    uint16_t mFrameStepCount = 0;
+    uint8_t mFrameChangedFields = 0;
+    bool mArmed = false;
+    bool mRecording = false;
+    bool mFrameInProgress = false;
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// Plays back a recording made by InputRecorder, replacing the input of each frame with the recorded one and
+/// running exactly as many simulation steps as were recorded, so that the level plays out identically no
+/// matter how long frames take. Frame times get collected in histograms, for comparing replays across builds.
+class InputReplayer final
+{
+public:
+    /// The default method of getting a hold of this singleton.
+    /// @returns a reference to the single instance of this class on the calling thread (i.e. of the game instance running on it).
+    static InputReplayer& GetInstance();
+
+    ~InputReplayer() = default;
+    InputReplayer(const InputReplayer&) = delete;
+    InputReplayer(InputReplayer&&) = delete;
+    const InputReplayer& operator = (const InputReplayer&) = delete;
+    InputReplayer& operator = (InputReplayer&&) = delete;
+
+    /// Loads (and validates) the given recording, for Game::Run to start replaying it on its next frame.
+    /// @param[in] recordingName the name the recording got saved under.
+    /// @returns whether the recording could be loaded.
+    bool Load(const std::string& recordingName);
+
+    /// Queues the given recording to be loaded once the game's data is (see LoadQueued), e.g. for replays requested on launch.
+    /// @param[in] recordingName the name the recording got saved under.
+    void QueueLoad(const std::string& recordingName);
+
+    /// Loads the queued recording, if any.
+    void LoadQueued();
+
+    bool HasPendingReplay() const;
+    bool IsReplaying() const;
+
+    /// Puts back everything the recorded level got played from, other than the random seed
+    /// (which only gets reseeded once the level starts, see OnLevelStarted).
+    /// @returns the name of the level to start.
+    std::string BeginReplay();
+
+    /// @param[in] sceneChangeCount the scene change count the level starts on.
+    void OnLevelStarted(const size_t sceneChangeCount);
+
+    /// @returns the scene change count (see Scene::GetSceneChangeCount) the replayed level started on.
+    size_t GetLevelSceneChangeCount() const;
+
+    /// Replaces the input of the current frame with the recorded one.
+    /// @param[in] preEventsInputContext the input context before handling the frame's input events.
+    void BeginFrame(const InputContext& preEventsInputContext);
+
+    Uint32 GetFrameAppStateEvent() const;
+    int GetFrameStepCount() const;
+    float GetFrameDtMillis() const;
+
+    /// @param[in] updateMillis the time the frame took up to (not including) rendering.
+    /// @param[in] frameMillis the time the whole frame took.
+    void EndFrame(const float updateMillis, const float frameMillis);
+
+    /// @returns whether all recorded frames have been replayed.
+    bool IsAtEnd() const;
+
+    /// Ends the replay, reporting (and saving) the frame time histograms.
+    /// @param[in] simulationDigest the digest of the level at the end of the replay (if still in it), checked against the recorded one.
+    void Finish(const std::optional<uint64_t>& simulationDigest);
+
+private:
+    InputReplayer() = default;
+
+private:
+    std::string mRecordingName;
+    std::string mQueuedRecordingName;
+    std::vector<unsigned char> mPlayerStateData;
+    std::vector<unsigned char> mFramesData;
+    std::optional<SnapshotReader> mFramesReader;
+    LevelDefinition mLevelDefinition;
+    InputContext mInitialInputContext = {};
+    glm::vec2 mWindowDimensions = glm::vec2(0.0f);
+    FrameTimeHistogram mUpdateTimeHistogram;
+    FrameTimeHistogram mFrameTimeHistogram;
+    std::optional<uint64_t> mRecordedSimulationDigest;
+    size_t mLevelSceneChangeCount = 0;
+    uint32_t mSeed = 0;
+    uint32_t mFrameCount = 0;
+    uint32_t mReplayedFrameCount = 0;
+    Uint32 mFrameAppStateEvent = 0;
+    float mFrameDtMillis = 0.0f;
+    uint16_t mFrameStepCount = 0;
+    bool mPendingReplay = false;
+    bool mReplaying = false;
+};
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* InputRecording_h */
@@ -7,16 +7,33 @@
 
 #include "GameSingletons.h"
 #include "LevelGeneration.h"
+#include "dataloaders/LevelDataLoader.h"
 #include "datarepos/WaveBlocksRepository.h"
 #include "definitions/WaveBlockDefinition.h"
 #include "../utils/Logging.h"
 #include "../utils/ObjectiveCUtils.h"
 
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <SDL.h>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
 
 ///------------------------------------------------------------------------------------------------
 
 static const float LEVEL_WAVE_Y_INCREMENT = 2.0f;
+static const float LEVEL_CAMERA_LENSE_HEIGHT = 30.0f;
+
+static const uint32_t SERIALIZED_LEVEL_MAGIC = 0x564C4253; // "SBLV"
+static const uint16_t SERIALIZED_LEVEL_VERSION = 1;
+static const uint16_t SERIALIZED_LEVEL_NO_STRING = 0xFFFF;
+
+static const char* BENCHMARK_LEVEL_FILE_NAME = "level_generation_benchmark";
 
 ///------------------------------------------------------------------------------------------------
 
@@ -25,85 +42,604 @@ namespace level_generation
 
 ///------------------------------------------------------------------------------------------------
 
-static void ExtendWaveBlockForDifficulty(const int difficulty, WaveBlockDefinition& waveBlock);
+/// Everything that goes in to generating a level, snapshotted on the main thread
+/// so that the generation itself can run on any thread.
+struct LevelGenerationParameters
+{
+    MapCoord mMapCoord;
+    Map::NodeType mNodeType;
+    int mMapGenerationSeed;
+    int mDifficulty;
+    strutils::StringId mLevelName;
+};
+
+///------------------------------------------------------------------------------------------------
+
+// Memoized levels keyed by their name, which encodes all of their generation parameters. Each game
+// instance runs on a thread of its own and generates the levels of its own map, hence a cache per thread.
+static thread_local std::unordered_map<strutils::StringId, LevelDefinition, strutils::StringIdHasher> sGeneratedLevels;
+static thread_local std::unordered_map<strutils::StringId, std::future<LevelDefinition>, strutils::StringIdHasher> sPendingLevels;
+static thread_local int sGeneratedLevelsMapGenerationSeed = 0;
+
+///------------------------------------------------------------------------------------------------
+
+static LevelGenerationParameters CreateLevelGenerationParameters(const MapCoord& mapCoord, const Map::NodeType nodeType);
+static int ComputeDifficulty(const MapCoord& mapCoord, const Map::NodeType nodeType, const int mapLevel);
+static math::RandomStream CreateLevelRandomStream(const int mapGenerationSeed, const MapCoord& mapCoord);
+static LevelDefinition CreateLevelDefinition(const LevelGenerationParameters& parameters);
+static std::string CreateLevelXml(const LevelDefinition& levelDefinition);
+static void AddWaveBlockEnemies(const WaveBlockDefinition& waveBlock, const int extraLineCount, math::RandomStream& randomStream, LevelWave& wave, LevelDefinition& levelDefinition);
 static float GetWaveBlockLineHeight(const WaveBlockLine& waveBlockLine);
 
 ///------------------------------------------------------------------------------------------------
 
-void GenerateLevel(const MapCoord& mapCoord, const Map::NodeData& nodeData)
+static void DiscardLevelsOfPreviousMaps()
+{
+    const auto mapGenerationSeed = GameSingletons::GetMapGenerationSeed();
+    if (mapGenerationSeed != sGeneratedLevelsMapGenerationSeed)
+    {
+        sGeneratedLevels.clear();
+        sPendingLevels.clear();
+        sGeneratedLevelsMapGenerationSeed = mapGenerationSeed;
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+const LevelDefinition& GetOrGenerateLevel(const MapCoord& mapCoord, const Map::NodeData& nodeData)
 {
+    DiscardLevelsOfPreviousMaps();
+    
+    const auto parameters = CreateLevelGenerationParameters(mapCoord, nodeData.mNodeType);
+    
+    auto findIter = sGeneratedLevels.find(parameters.mLevelName);
+    if (findIter != sGeneratedLevels.end())
+    {
+        return findIter->second;
+    }
+    
+    // Already being generated in the background
+    auto pendingIter = sPendingLevels.find(parameters.mLevelName);
+    if (pendingIter != sPendingLevels.end())
+    {
+        auto levelDefinition = pendingIter->second.get();
+        sPendingLevels.erase(pendingIter);
+        return sGeneratedLevels.emplace(parameters.mLevelName, std::move(levelDefinition)).first->second;
+    }
+    
     Log(LogType::INFO, "Generating level for map node %s", mapCoord.ToString().c_str());
+    return sGeneratedLevels.emplace(parameters.mLevelName, CreateLevelDefinition(parameters)).first->second;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void PrefetchLevels(const std::vector<MapCoord>& mapCoords, const Map& map)
+{
+    DiscardLevelsOfPreviousMaps();
     
-    std::stringstream levelXml;
-    levelXml <<
-    "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
-    "\n<Level>"
-    "\n<Camera type=\"world_cam\" lenseHeight=\"30.0f\"/>"
-    "\n<Camera type=\"gui_cam\" lenseHeight=\"30.0f\"/>";
+    for (const auto& mapCoord: mapCoords)
+    {
+        const auto parameters = CreateLevelGenerationParameters(mapCoord, map.GetNodeData(mapCoord).mNodeType);
+        if (sGeneratedLevels.count(parameters.mLevelName) || sPendingLevels.count(parameters.mLevelName))
+        {
+            continue;
+        }
+        
+        Log(LogType::INFO, "Generating level for map node %s in the background", mapCoord.ToString().c_str());
+        sPendingLevels.emplace(parameters.mLevelName, std::async(std::launch::async, [parameters]()
+        {
+            return CreateLevelDefinition(parameters);
+        }));
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void DiscardPendingLevels()
+{
+    for (auto& pendingLevel: sPendingLevels)
+    {
+        pendingLevel.second.wait();
+    }
+    
+    sPendingLevels.clear();
+}
+
+///------------------------------------------------------------------------------------------------
+
+const LevelDefinition* FindGeneratedLevel(const std::string& levelName)
+{
+    auto findIter = sGeneratedLevels.find(strutils::StringId(levelName));
+    return findIter != sGeneratedLevels.end() ? &findIter->second : nullptr;
+}
+
+///------------------------------------------------------------------------------------------------
+
+const LevelDefinition& CacheLevel(LevelDefinition&& levelDefinition)
+{
+    DiscardLevelsOfPreviousMaps();
+    
+    const auto levelName = levelDefinition.mLevelName;
+    return sGeneratedLevels.insert_or_assign(levelName, std::move(levelDefinition)).first->second;
+}
+
+///------------------------------------------------------------------------------------------------
+
+template<class T>
+static void WriteValue(const T& value, std::vector<unsigned char>& outData)
+{
+    const auto* valueBytes = reinterpret_cast<const unsigned char*>(&value);
+    outData.insert(outData.end(), valueBytes, valueBytes + sizeof(T));
+}
+
+///------------------------------------------------------------------------------------------------
+
+template<class T>
+static bool ReadValue(const unsigned char*& cursor, const unsigned char* end, T& outValue)
+{
+    if (static_cast<size_t>(end - cursor) < sizeof(T))
+    {
+        return false;
+    }
+    
+    std::memcpy(&outValue, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void SerializeLevel(const LevelDefinition& levelDefinition, std::vector<unsigned char>& outData)
+{
+    // All names (level, cameras, enemies, bosses) are written once in a string table and referenced by index
+    std::vector<strutils::StringId> stringTable;
+    std::unordered_map<strutils::StringId, uint16_t, strutils::StringIdHasher> stringIndices;
+    
+    auto getStringIndex = [&](const strutils::StringId& string)
+    {
+        if (string.isEmpty())
+        {
+            return SERIALIZED_LEVEL_NO_STRING;
+        }
+        
+        auto findIter = stringIndices.find(string);
+        if (findIter != stringIndices.end())
+        {
+            return findIter->second;
+        }
+        
+        const auto stringIndex = static_cast<uint16_t>(stringTable.size());
+        stringTable.push_back(string);
+        stringIndices[string] = stringIndex;
+        return stringIndex;
+    };
+    
+    std::vector<unsigned char> body;
+    WriteValue(getStringIndex(levelDefinition.mLevelName), body);
+    
+    WriteValue(static_cast<uint16_t>(levelDefinition.mCameras.size()), body);
+    for (const auto& camera: levelDefinition.mCameras)
+    {
+        WriteValue(getStringIndex(camera.mType), body);
+        WriteValue(camera.mLenseHeight, body);
+    }
+    
+    WriteValue(static_cast<uint16_t>(levelDefinition.mWaves.size()), body);
+    for (const auto& wave: levelDefinition.mWaves)
+    {
+        WriteValue(getStringIndex(wave.mBossName), body);
+        WriteValue(wave.mBossHealth, body);
+        WriteValue(static_cast<int32_t>(wave.mDebugBlockIndex), body);
+        WriteValue(static_cast<int32_t>(wave.mDebugDifficultyValue), body);
+        
+        WriteValue(static_cast<uint32_t>(wave.mEnemies.size()), body);
+        for (const auto& enemy: wave.mEnemies)
+        {
+            WriteValue(getStringIndex(enemy.mGameObjectEnemyType), body);
+            WriteValue(enemy.mPosition.x, body);
+            WriteValue(enemy.mPosition.y, body);
+        }
+    }
+    
+    outData.clear();
+    WriteValue(SERIALIZED_LEVEL_MAGIC, outData);
+    WriteValue(SERIALIZED_LEVEL_VERSION, outData);
+    WriteValue(static_cast<uint16_t>(stringTable.size()), outData);
+    for (const auto& string: stringTable)
+    {
+        const auto& stringValue = string.GetString();
+        WriteValue(static_cast<uint16_t>(stringValue.size()), outData);
+        outData.insert(outData.end(), stringValue.begin(), stringValue.end());
+    }
+    outData.insert(outData.end(), body.begin(), body.end());
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool DeserializeLevel(const unsigned char* data, const size_t dataSize, LevelDefinition& outLevelDefinition)
+{
+    const auto* cursor = data;
+    const auto* end = data + dataSize;
+    
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    if (!ReadValue(cursor, end, magic) || magic != SERIALIZED_LEVEL_MAGIC ||
+        !ReadValue(cursor, end, version) || version != SERIALIZED_LEVEL_VERSION)
+    {
+        return false;
+    }
+    
+    uint16_t stringCount = 0;
+    if (!ReadValue(cursor, end, stringCount)) return false;
+    
+    std::vector<strutils::StringId> stringTable;
+    stringTable.reserve(stringCount);
+    for (uint16_t i = 0; i < stringCount; ++i)
+    {
+        uint16_t stringLength = 0;
+        if (!ReadValue(cursor, end, stringLength) || static_cast<size_t>(end - cursor) < stringLength) return false;
+        
+        stringTable.emplace_back(std::string(reinterpret_cast<const char*>(cursor), stringLength));
+        cursor += stringLength;
+    }
+    
+    auto readString = [&](strutils::StringId& outString)
+    {
+        uint16_t stringIndex = 0;
+        if (!ReadValue(cursor, end, stringIndex)) return false;
+        if (stringIndex == SERIALIZED_LEVEL_NO_STRING)
+        {
+            outString = strutils::StringId();
+            return true;
+        }
+        if (stringIndex >= stringTable.size()) return false;
+        
+        outString = stringTable[stringIndex];
+        return true;
+    };
+    
+    LevelDefinition levelDefinition;
+    if (!readString(levelDefinition.mLevelName)) return false;
+    
+    uint16_t cameraCount = 0;
+    if (!ReadValue(cursor, end, cameraCount)) return false;
+    
+    levelDefinition.mCameras.resize(cameraCount);
+    for (auto& camera: levelDefinition.mCameras)
+    {
+        if (!readString(camera.mType) || !ReadValue(cursor, end, camera.mLenseHeight)) return false;
+    }
+    
+    uint16_t waveCount = 0;
+    if (!ReadValue(cursor, end, waveCount)) return false;
+    
+    levelDefinition.mWaves.resize(waveCount);
+    for (auto& wave: levelDefinition.mWaves)
+    {
+        int32_t blockIndex = 0, difficulty = 0;
+        uint32_t enemyCount = 0;
+        if (!readString(wave.mBossName) ||
+            !ReadValue(cursor, end, wave.mBossHealth) ||
+            !ReadValue(cursor, end, blockIndex) ||
+            !ReadValue(cursor, end, difficulty) ||
+            !ReadValue(cursor, end, enemyCount))
+        {
+            return false;
+        }
+        
+        wave.mDebugBlockIndex = blockIndex;
+        wave.mDebugDifficultyValue = difficulty;
+        
+        wave.mEnemies.resize(enemyCount);
+        for (auto& enemy: wave.mEnemies)
+        {
+            if (!readString(enemy.mGameObjectEnemyType) ||
+                !ReadValue(cursor, end, enemy.mPosition.x) ||
+                !ReadValue(cursor, end, enemy.mPosition.y))
+            {
+                return false;
+            }
+            
+            levelDefinition.mEnemyTypes.insert(enemy.mGameObjectEnemyType);
+        }
+    }
+    
+    outLevelDefinition = std::move(levelDefinition);
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::vector<std::string> BenchmarkLevelGeneration(const MapCoord& mapCoord, const Map::NodeData& nodeData, const int iterations)
+{
+    const auto parameters = CreateLevelGenerationParameters(mapCoord, nodeData.mNodeType);
+    
+    auto measureMillis = [&](const std::function<void()>& generateAndLoadLevel)
+    {
+        auto startTime = SDL_GetPerformanceCounter();
+        for (int i = 0; i < iterations; ++i)
+        {
+            generateAndLoadLevel();
+        }
+        auto currTime = SDL_GetPerformanceCounter();
+        
+        return static_cast<double>((currTime - startTime) / static_cast<double>(SDL_GetPerformanceFrequency())) * 1000.0/iterations;
+    };
+    
+    // Legacy path: generated XML text written to the save directory, then read back and re-parsed
+    const auto benchmarkLevelPath = objectiveC_utils::BuildLocalFileSaveLocation(BENCHMARK_LEVEL_FILE_NAME);
+    const auto xmlRoundTripMillis = measureMillis([&]()
+    {
+        std::ofstream outputFile(benchmarkLevelPath + ".xml");
+        outputFile << CreateLevelXml(CreateLevelDefinition(parameters));
+        outputFile.close();
+        
+        LevelDataLoader levelDataLoader;
+        levelDataLoader.LoadLevel(benchmarkLevelPath);
+    });
+    std::remove((benchmarkLevelPath + ".xml").c_str());
+    
+    // Current path: the definition is handed over as is
+    const auto inMemoryMillis = measureMillis([&]()
+    {
+        auto levelDefinition = CreateLevelDefinition(parameters);
+    });
+    
+    // Persisted path: definition round tripped through its binary form
+    size_t serializedSize = 0;
+    const auto binaryRoundTripMillis = measureMillis([&]()
+    {
+        std::vector<unsigned char> serializedLevel;
+        SerializeLevel(CreateLevelDefinition(parameters), serializedLevel);
+        serializedSize = serializedLevel.size();
+        
+        LevelDefinition levelDefinition;
+        DeserializeLevel(serializedLevel.data(), serializedLevel.size(), levelDefinition);
+    });
+    
+    std::vector<std::string> results =
+    {
+        "XML round trip: " + strutils::FloatToString(static_cast<float>(xmlRoundTripMillis), 4) + " ms/level",
+        "In memory: " + strutils::FloatToString(static_cast<float>(inMemoryMillis), 4) + " ms/level",
+        "Binary round trip: " + strutils::FloatToString(static_cast<float>(binaryRoundTripMillis), 4) + " ms/level (" + std::to_string(serializedSize) + " bytes)"
+    };
+    
+    for (const auto& result: results)
+    {
+        Log(LogType::INFO, "Level generation benchmark (%d iterations) %s", iterations, result.c_str());
+    }
+    
+    return results;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool VerifyGenerationDeterminism(const glm::ivec2& mapDimensions, std::vector<std::string>& outResults)
+{
+    std::vector<LevelGenerationParameters> levelParameters;
+    for (int col = 1; col < mapDimensions.x; ++col)
+    {
+        for (int row = 0; row < mapDimensions.y; ++row)
+        {
+            for (const auto nodeType: { Map::NodeType::NORMAL_ENCOUNTER, Map::NodeType::HARD_ENCOUNTER, Map::NodeType::BOSS_ENCOUNTER })
+            {
+                levelParameters.push_back(CreateLevelGenerationParameters(MapCoord(col, row), nodeType));
+            }
+        }
+    }
     
+    auto generateLevels = [&](std::vector<std::vector<unsigned char>>& outSerializedLevels, const size_t firstIndex, const size_t indexStride)
+    {
+        // Walked back to front, so that the parallel pass also visits nodes in a different order than the serial one
+        for (auto i = levelParameters.size() - 1 - firstIndex; i < levelParameters.size(); i -= indexStride)
+        {
+            SerializeLevel(CreateLevelDefinition(levelParameters[i]), outSerializedLevels[i]);
+        }
+    };
     
-    auto difficultyValue = mapCoord.mCol;
-    if (nodeData.mNodeType == Map::NodeType::BOSS_ENCOUNTER)
+    std::vector<std::vector<unsigned char>> serialLevels(levelParameters.size());
+    auto startTime = SDL_GetPerformanceCounter();
+    for (size_t i = 0; i < levelParameters.size(); ++i)
+    {
+        SerializeLevel(CreateLevelDefinition(levelParameters[i]), serialLevels[i]);
+    }
+    auto serialMillis = (SDL_GetPerformanceCounter() - startTime) * 1000.0/SDL_GetPerformanceFrequency();
+    
+    const auto workerCount = static_cast<size_t>(std::max(2u, std::thread::hardware_concurrency()));
+    std::vector<std::vector<unsigned char>> parallelLevels(levelParameters.size());
+    startTime = SDL_GetPerformanceCounter();
+    {
+        std::vector<std::future<void>> workers;
+        for (size_t i = 0; i < workerCount; ++i)
+        {
+            workers.push_back(std::async(std::launch::async, generateLevels, std::ref(parallelLevels), i, workerCount));
+        }
+    }
+    auto parallelMillis = (SDL_GetPerformanceCounter() - startTime) * 1000.0/SDL_GetPerformanceFrequency();
+    
+    size_t mismatchCount = 0;
+    for (size_t i = 0; i < levelParameters.size(); ++i)
+    {
+        if (serialLevels[i] != parallelLevels[i])
+        {
+            Log(LogType::ERROR, "Level %s differs between serial and parallel generation", levelParameters[i].mLevelName.GetString().c_str());
+            mismatchCount++;
+        }
+    }
+    
+    outResults =
+    {
+        "Levels: " + std::to_string(levelParameters.size()) + ", mismatches: " + std::to_string(mismatchCount),
+        "Serial: " + strutils::FloatToString(static_cast<float>(serialMillis), 2) + " ms",
+        "Parallel (" + std::to_string(workerCount) + " threads): " + strutils::FloatToString(static_cast<float>(parallelMillis), 2) + " ms"
+    };
+    
+    for (const auto& result: outResults)
+    {
+        Log(mismatchCount == 0 ? LogType::INFO : LogType::ERROR, "Level generation determinism check %s", result.c_str());
+    }
+    
+    return mismatchCount == 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
+LevelGenerationParameters CreateLevelGenerationParameters(const MapCoord& mapCoord, const Map::NodeType nodeType)
+{
+    const auto mapGenerationSeed = GameSingletons::GetMapGenerationSeed();
+    const auto difficulty = ComputeDifficulty(mapCoord, nodeType, GameSingletons::GetMapLevel());
+    const auto levelName = "level_" + std::to_string(mapGenerationSeed) + "_" + mapCoord.ToString() + "_" + std::to_string(static_cast<int>(nodeType)) + "_" + std::to_string(difficulty);
+    
+    return LevelGenerationParameters{ mapCoord, nodeType, mapGenerationSeed, difficulty, strutils::StringId(levelName) };
+}
+
+///------------------------------------------------------------------------------------------------
+
+int ComputeDifficulty(const MapCoord& mapCoord, const Map::NodeType nodeType, const int mapLevel)
+{
+    int difficultyValue = mapCoord.mCol;
+    if (nodeType == Map::NodeType::BOSS_ENCOUNTER)
     {
         difficultyValue *= 1.5f;
     }
-    else if (nodeData.mNodeType == Map::NodeType::HARD_ENCOUNTER)
+    else if (nodeType == Map::NodeType::HARD_ENCOUNTER)
     {
         difficultyValue *= 2.0f;
     }
     
-    difficultyValue += GameSingletons::GetMapLevel() * 10;
+    difficultyValue += mapLevel * 10;
     
-    auto waveCount = math::ControlledRandomInt(2,3) + (difficultyValue / 5);
+    return difficultyValue;
+}
+
+///------------------------------------------------------------------------------------------------
+
+math::RandomStream CreateLevelRandomStream(const int mapGenerationSeed, const MapCoord& mapCoord)
+{
+    const auto mapCoordKey = (static_cast<uint64_t>(static_cast<uint32_t>(mapCoord.mCol)) << 32) | static_cast<uint32_t>(mapCoord.mRow);
+    return math::RandomStream(static_cast<uint64_t>(static_cast<uint32_t>(mapGenerationSeed))).Split(mapCoordKey);
+}
+
+///------------------------------------------------------------------------------------------------
+
+LevelDefinition CreateLevelDefinition(const LevelGenerationParameters& parameters)
+{
+    // Each node draws from its own stream, so the resulting level does not depend on which other
+    // nodes have been generated before it (or concurrently with it)
+    auto randomStream = CreateLevelRandomStream(parameters.mMapGenerationSeed, parameters.mMapCoord);
+    
+    LevelDefinition levelDefinition;
+    levelDefinition.mLevelName = parameters.mLevelName;
+    
+    LevelCamera worldCamera;
+    worldCamera.mType = strutils::StringId("world_cam");
+    worldCamera.mLenseHeight = LEVEL_CAMERA_LENSE_HEIGHT;
+    levelDefinition.mCameras.push_back(worldCamera);
     
-    const auto& eligibleBlocks = WaveBlocksRepository::GetInstance().GetEligibleWaveBlocksForDifficulty(difficultyValue);
+    LevelCamera guiCamera;
+    guiCamera.mType = strutils::StringId("gui_cam");
+    guiCamera.mLenseHeight = LEVEL_CAMERA_LENSE_HEIGHT;
+    levelDefinition.mCameras.push_back(guiCamera);
     
-    if (eligibleBlocks.size() == 0) return;
+    const auto difficultyValue = parameters.mDifficulty;
+    
+    auto waveCount = randomStream.NextInt(2, 3) + (difficultyValue / 5);
+    
+    const auto& waveBlocksRepository = WaveBlocksRepository::GetInstance();
+    const auto& eligibleBlocks = waveBlocksRepository.GetEligibleWaveBlocksForDifficulty(difficultyValue);
+    
+    if (eligibleBlocks.mWaveBlockIndices.empty())
+    {
+        Log(LogType::WARNING, "No eligible wave blocks for difficulty %d", difficultyValue);
+        return levelDefinition;
+    }
     
     for (int j = 0; j < waveCount; ++j)
     {
-        levelXml << "\n    <Wave";
-        auto selectedBlockIndex = math::ControlledRandomInt(0, static_cast<int>(eligibleBlocks.size()) - 1);
-        auto selectedBlock = eligibleBlocks.at(selectedBlockIndex);
-        if (selectedBlock.mExtensible)
+        auto& wave = levelDefinition.mWaves.emplace_back();
+        
+        auto selectedBlockIndex = eligibleBlocks.Sample(randomStream);
+        const auto* selectedBlock = &waveBlocksRepository.GetWaveBlock(eligibleBlocks.mWaveBlockIndices[selectedBlockIndex]);
+        
+        // Extensible blocks get extra lines for each point of difficulty above their own
+        auto extraLineCount = selectedBlock->mExtensible ? difficultyValue - selectedBlock->mDifficulty : 0;
+        
+        wave.mDebugBlockIndex = static_cast<int>(selectedBlockIndex);
+        wave.mDebugDifficultyValue = difficultyValue;
+        
+        if (parameters.mNodeType == Map::NodeType::BOSS_ENCOUNTER && j == waveCount - 1)
         {
-            ExtendWaveBlockForDifficulty(difficultyValue, selectedBlock);
+            selectedBlock = &waveBlocksRepository.GetBossWaveBlock(strutils::StringId("Ka'thun"));
+            extraLineCount = 0;
+            wave.mBossName = selectedBlock->mBossName;
+            wave.mBossHealth = selectedBlock->mBossHealth;
         }
         
-        levelXml << " blockIndex=\"" << std::to_string(selectedBlockIndex) << "\" difficulty=\"" << std::to_string(difficultyValue) << "\"";
+        AddWaveBlockEnemies(*selectedBlock, extraLineCount, randomStream, wave, levelDefinition);
+    }
+    
+    return levelDefinition;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::string CreateLevelXml(const LevelDefinition& levelDefinition)
+{
+    std::stringstream levelXml;
+    levelXml << "<?xml version=\"1.0\" encoding=\"utf-8\"?>" "\n<Level>";
+    
+    for (const auto& camera: levelDefinition.mCameras)
+    {
+        levelXml << "\n<Camera type=\"" << camera.mType.GetString() << "\" lenseHeight=\"" << camera.mLenseHeight << "\"/>";
+    }
+    
+    for (const auto& wave: levelDefinition.mWaves)
+    {
+        levelXml << "\n    <Wave blockIndex=\"" << std::to_string(wave.mDebugBlockIndex) << "\" difficulty=\"" << std::to_string(wave.mDebugDifficultyValue) << "\"";
         
-        if (nodeData.mNodeType == Map::NodeType::BOSS_ENCOUNTER && j == waveCount - 1)
+        if (!wave.mBossName.isEmpty())
         {
-            selectedBlock = WaveBlocksRepository::GetInstance().GetBossWaveBlock(strutils::StringId("Ka'thun"));
-            levelXml << " bossName=\"" << selectedBlock.mBossName.GetString() << "\" bossHealth=\"" << selectedBlock.mBossHealth << "\"";
+            levelXml << " bossName=\"" << wave.mBossName.GetString() << "\" bossHealth=\"" << wave.mBossHealth << "\"";
         }
         
         levelXml << ">";
-        for (const auto& blockLine: selectedBlock.mWaveBlockLines)
+        for (const auto& enemy: wave.mEnemies)
         {
-            for (const auto& enemy: blockLine.mEnemies)
-            {
-                auto positionOffset = selectedBlock.mInflexible ? glm::vec2(0.0f, 0.0f) : glm::vec2(math::RandomFloat(-1.0f, 1.0f), math::RandomFloat(-1.0f, 1.0f));
-                levelXml << "\n        <Enemy position=\"" << enemy.mPosition.x + positionOffset.x << ", " << enemy.mPosition.y + positionOffset.y << "\" type=\"" << enemy.mGameObjectEnemyType.GetString() << "\"/>";
-            }
+            levelXml << "\n        <Enemy position=\"" << enemy.mPosition.x << ", " << enemy.mPosition.y << "\" type=\"" << enemy.mGameObjectEnemyType.GetString() << "\"/>";
         }
         
         levelXml << "\n    </Wave>";
     }
     
     levelXml << "\n</Level>";
-    
-    auto levelFileName = objectiveC_utils::BuildLocalFileSaveLocation(mapCoord.ToString() + ".xml");
-    std::ofstream outputFile(levelFileName);
-    outputFile << levelXml.str();
-    outputFile.close();
+    return levelXml.str();
 }
 
 ///------------------------------------------------------------------------------------------------
 
-void ExtendWaveBlockForDifficulty(const int difficulty, WaveBlockDefinition& waveBlock)
+void AddWaveBlockEnemies(const WaveBlockDefinition& waveBlock, const int extraLineCount, math::RandomStream& randomStream, LevelWave& wave, LevelDefinition& levelDefinition)
 {
-    if (difficulty == waveBlock.mDifficulty) return;
+    auto addEnemy = [&](const WaveBlockEnemy& enemy, const float enemyY)
+    {
+        auto positionOffset = waveBlock.mInflexible ? glm::vec2(0.0f, 0.0f) : glm::vec2(randomStream.NextFloat(-1.0f, 1.0f), randomStream.NextFloat(-1.0f, 1.0f));
+        
+        LevelEnemy levelEnemy;
+        levelEnemy.mGameObjectEnemyType = enemy.mGameObjectEnemyType;
+        levelEnemy.mPosition = glm::vec3(enemy.mPosition.x + positionOffset.x, enemyY + positionOffset.y, 0.0f);
+        
+        wave.mEnemies.push_back(levelEnemy);
+        levelDefinition.mEnemyTypes.insert(levelEnemy.mGameObjectEnemyType);
+    };
+    
+    for (const auto& blockLine: waveBlock.mWaveBlockLines)
+    {
+        for (const auto& enemy: blockLine.mEnemies)
+        {
+            addEnemy(enemy, enemy.mPosition.y);
+        }
+    }
+    
+    if (extraLineCount <= 0 || waveBlock.mWaveBlockLines.empty()) return;
     
     // Find largest y in block line enemies
     auto waveHeight = 0.0f;
@@ -119,33 +655,28 @@ void ExtendWaveBlockForDifficulty(const int difficulty, WaveBlockDefinition& wav
         riter++;
     }
     
+    // The extra lines repeat the block's lines, stacked above it, straight from
+    // the repository's definition rather than from an extended copy of it
     auto currentY = game_constants::LEVEL_WAVE_VISIBLE_Y + waveHeight + LEVEL_WAVE_Y_INCREMENT;
-    
-    std::vector<WaveBlockLine> additionalLines;
-    auto difficultyDiff = difficulty - waveBlock.mDifficulty;
-    for (int i = 0; i < difficultyDiff; ++i)
+    for (int i = 0; i < extraLineCount; ++i)
     {
-        auto targetLineCopy = waveBlock.mWaveBlockLines.at(i % waveBlock.mWaveBlockLines.size());
-        auto lineHeight = GetWaveBlockLineHeight(targetLineCopy);
+        const auto& targetLine = waveBlock.mWaveBlockLines[i % waveBlock.mWaveBlockLines.size()];
+        auto lineHeight = GetWaveBlockLineHeight(targetLine);
         
-        for (auto& enemy: targetLineCopy.mEnemies)
+        for (const auto& enemy: targetLine.mEnemies)
         {
-            enemy.mPosition.y = currentY + enemy.mPosition.y - game_constants::LEVEL_WAVE_VISIBLE_Y;
+            addEnemy(enemy, currentY + enemy.mPosition.y - game_constants::LEVEL_WAVE_VISIBLE_Y);
         }
         
         if (!waveBlock.mInflexible)
         {
-            currentY += lineHeight * math::Max(0.0f, (1.0f - difficultyDiff/20.0f));
+            currentY += lineHeight * math::Max(0.0f, (1.0f - extraLineCount/20.0f));
         }
         else
         {
             currentY += lineHeight;
         }
-        
-        additionalLines.push_back(targetLineCopy);
     }
-    
-    waveBlock.mWaveBlockLines.insert(waveBlock.mWaveBlockLines.end(), additionalLines.begin(), additionalLines.end());
 }
 
 ///------------------------------------------------------------------------------------------------
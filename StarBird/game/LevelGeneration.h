@@ -11,6 +11,10 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "Map.h"
+#include "definitions/LevelDefinition.h"
+
+#include <string>
+#include <vector>
 
 ///------------------------------------------------------------------------------------------------
 
@@ -18,8 +22,73 @@ namespace level_generation
 {
 
 ///------------------------------------------------------------------------------------------------
+/// Returns the level of the given map node, generating it on first request. Levels are memoized by
+/// map seed, node coordinate, node type and difficulty, and each is generated from its own random
+/// stream keyed by (map seed, node coordinate), so the result does not depend on the order (or the
+/// thread) nodes are generated in.
+/// @param[in] mapCoord the coordinate of the map node.
+/// @param[in] nodeData the data of the map node.
+/// @returns a reference to the cached level definition.
+const LevelDefinition& GetOrGenerateLevel(const MapCoord& mapCoord, const Map::NodeData& nodeData);
+
+///------------------------------------------------------------------------------------------------
+/// Starts generating the levels of the given map nodes on background threads. A later
+/// GetOrGenerateLevel call for any of them only waits on the remaining work, if any.
+/// @param[in] mapCoords the coordinates of the map nodes.
+/// @param[in] map the map the nodes belong to.
+void PrefetchLevels(const std::vector<MapCoord>& mapCoords, const Map& map);
+
+///------------------------------------------------------------------------------------------------
+/// Waits for all background generation started by PrefetchLevels to finish, and drops its results so
+/// that those levels get generated again on request. Needs to be called before mutating any data the
+/// background generation reads (e.g. reloading the wave blocks).
+void DiscardPendingLevels();
+
+///------------------------------------------------------------------------------------------------
+/// Looks up a previously generated level.
+/// @param[in] levelName the name of the level (i.e. the mLevelName of a definition returned by GetOrGenerateLevel).
+/// @returns a pointer to the cached level definition, or nullptr if no such level has been generated.
+const LevelDefinition* FindGeneratedLevel(const std::string& levelName);
+
+///------------------------------------------------------------------------------------------------
+/// Puts a level that didn't come from GetOrGenerateLevel (e.g. a deserialized one) in the generated level
+/// cache, replacing any cached level of the same name, so that it can be transitioned to by name.
+/// @param[in] levelDefinition the level to cache.
+/// @returns a reference to the cached level definition.
+const LevelDefinition& CacheLevel(LevelDefinition&& levelDefinition);
+
+///------------------------------------------------------------------------------------------------
+/// Serializes a level in to a compact binary form, for when a level needs to outlive the
+/// generated level cache (the cache itself is rebuilt from the map seed whenever the map is).
+/// @param[in] levelDefinition the level to serialize.
+/// @param[out] outData the serialized level.
+void SerializeLevel(const LevelDefinition& levelDefinition, std::vector<unsigned char>& outData);
+
+///------------------------------------------------------------------------------------------------
+/// Reconstructs a level from its binary form (see SerializeLevel).
+/// @param[in] data pointer to the serialized level.
+/// @param[in] dataSize size of the serialized level in bytes.
+/// @param[out] outLevelDefinition the reconstructed level.
+/// @returns whether the data was a valid serialized level.
+bool DeserializeLevel(const unsigned char* data, const size_t dataSize, LevelDefinition& outLevelDefinition);
+
+///------------------------------------------------------------------------------------------------
+/// Compares generating and then loading a level for the given map node via the legacy XML round trip
+/// (write file, re-parse with LevelDataLoader), the generated level cache and the binary form.
+/// @param[in] mapCoord the coordinate of the map node.
+/// @param[in] nodeData the data of the map node.
+/// @param[in] iterations how many levels to generate per path.
+/// @returns the human readable results (also logged).
+std::vector<std::string> BenchmarkLevelGeneration(const MapCoord& mapCoord, const Map::NodeData& nodeData, const int iterations);
 
-void GenerateLevel(const MapCoord& mapCoord, const Map::NodeData& nodeData);
+///------------------------------------------------------------------------------------------------
+/// Generates the levels of every encounter node type at every coordinate of a map of the given
+/// dimensions, once serially and once spread across worker threads in a different order, and
+/// checks that both passes produce bit identical (serialized) levels.
+/// @param[in] mapDimensions the dimensions of the map.
+/// @param[out] outResults the human readable results (also logged).
+/// @returns whether both passes produced identical levels.
+bool VerifyGenerationDeterminism(const glm::ivec2& mapDimensions, std::vector<std::string>& outResults);
 
 ///------------------------------------------------------------------------------------------------
 
@@ -0,0 +1,693 @@
+///------------------------------------------------------------------------------------------------
+///  LevelSnapshot.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "Animations.h"
+#include "LevelSnapshot.h"
+#include "PersistenceUtils.h"
+#include "SceneObject.h"
+#include "SceneObjectUtils.h"
+#include "../utils/Logging.h"
+#include "../utils/MathUtils.h"
+#include "../utils/ObjectiveCUtils.h"
+
+#include <algorithm>
+#include <Box2D/Box2D.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+///------------------------------------------------------------------------------------------------
+
+void SnapshotWriter::WriteBytes(const std::vector<unsigned char>& bytes)
+{
+    Write(static_cast<uint32_t>(bytes.size()));
+    mData.insert(mData.end(), bytes.begin(), bytes.end());
+}
+
+void SnapshotWriter::WriteString(const std::string& string)
+{
+    Write(static_cast<uint32_t>(string.size()));
+    mData.insert(mData.end(), string.begin(), string.end());
+}
+
+void SnapshotWriter::WriteStringId(const strutils::StringId& stringId)
+{
+    WriteString(stringId.GetString());
+}
+
+void SnapshotWriter::WriteResourceId(const resources::ResourceId resourceId)
+{
+    Write(resourceId);
+    if (mRecordedResourceIds.insert(resourceId).second)
+    {
+        mResourceIds.push_back(resourceId);
+    }
+}
+
+const std::vector<unsigned char>& SnapshotWriter::GetData() const
+{
+    return mData;
+}
+
+const std::vector<resources::ResourceId>& SnapshotWriter::GetResourceIds() const
+{
+    return mResourceIds;
+}
+
+///------------------------------------------------------------------------------------------------
+
+SnapshotReader::SnapshotReader(const unsigned char* data, const size_t dataSize)
+    : mData(data)
+    , mDataSize(dataSize)
+    , mOffset(0)
+    , mValid(true)
+{
+}
+
+uint32_t SnapshotReader::ReadCount(const size_t minElementSize /* 1 */)
+{
+    const auto count = Read<uint32_t>();
+    if (mValid && static_cast<size_t>(count) * minElementSize > mDataSize - mOffset)
+    {
+        mValid = false;
+    }
+
+    return mValid ? count : 0;
+}
+
+std::vector<unsigned char> SnapshotReader::ReadBytes()
+{
+    const auto byteCount = ReadCount();
+    if (!mValid) return {};
+
+    std::vector<unsigned char> bytes(mData + mOffset, mData + mOffset + byteCount);
+    mOffset += byteCount;
+    return bytes;
+}
+
+std::string SnapshotReader::ReadString()
+{
+    const auto stringLength = ReadCount();
+    if (!mValid) return std::string();
+
+    std::string string(reinterpret_cast<const char*>(mData + mOffset), stringLength);
+    mOffset += stringLength;
+    return string;
+}
+
+strutils::StringId SnapshotReader::ReadStringId()
+{
+    auto stringId = ReadRawStringId();
+
+    auto renameIter = mRenames.find(stringId);
+    return renameIter != mRenames.end() ? renameIter->second : stringId;
+}
+
+strutils::StringId SnapshotReader::ReadRawStringId()
+{
+    auto string = ReadString();
+    return string.empty() ? strutils::StringId() : strutils::StringId(string);
+}
+
+void SnapshotReader::AddRename(const strutils::StringId& oldName, const strutils::StringId& newName)
+{
+    mRenames[oldName] = newName;
+}
+
+void SnapshotReader::Invalidate()
+{
+    mValid = false;
+}
+
+bool SnapshotReader::IsValid() const
+{
+    return mValid;
+}
+
+bool SnapshotReader::IsAtEnd() const
+{
+    return mOffset == mDataSize;
+}
+
+///------------------------------------------------------------------------------------------------
+
+namespace level_snapshot
+{
+
+///------------------------------------------------------------------------------------------------
+
+static const std::string SNAPSHOT_FILE_NAME = "level_snapshot.bin";
+
+static const uint32_t SNAPSHOT_FILE_MAGIC = 0x534C4253; // "SBLS"
+static const uint16_t SNAPSHOT_FILE_VERSION = 1;
+
+///------------------------------------------------------------------------------------------------
+
+// Transient data the fixtures of a body get staged in, so that nothing gets created in the world
+// unless the whole body checks out
+struct FixtureData
+{
+    b2Shape::Type mShapeType = b2Shape::e_polygon;
+    b2PolygonShape mPolygonShape;
+    b2CircleShape mCircleShape;
+    b2FixtureDef mFixtureDef;
+};
+
+///------------------------------------------------------------------------------------------------
+
+template<class ValueT>
+static void WriteUniformValues(SnapshotWriter& writer, const std::unordered_map<strutils::StringId, ValueT, strutils::StringIdHasher>& uniformValues)
+{
+    // Sorted so that the same uniforms always get written out the same way
+    std::vector<std::pair<strutils::StringId, ValueT>> sortedUniformValues(uniformValues.begin(), uniformValues.end());
+    std::sort(sortedUniformValues.begin(), sortedUniformValues.end(), [](const std::pair<strutils::StringId, ValueT>& lhs, const std::pair<strutils::StringId, ValueT>& rhs)
+    {
+        return lhs.first < rhs.first;
+    });
+
+    writer.Write(static_cast<uint32_t>(sortedUniformValues.size()));
+    for (const auto& uniformEntry: sortedUniformValues)
+    {
+        writer.WriteStringId(uniformEntry.first);
+        writer.Write(uniformEntry.second);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+template<class ValueT>
+static void ReadUniformValues(SnapshotReader& reader, std::unordered_map<strutils::StringId, ValueT, strutils::StringIdHasher>& outUniformValues)
+{
+    const auto uniformCount = reader.ReadCount(sizeof(uint32_t) + sizeof(ValueT));
+    for (uint32_t i = 0; i < uniformCount && reader.IsValid(); ++i)
+    {
+        auto uniformName = reader.ReadRawStringId();
+        outUniformValues[uniformName] = reader.Read<ValueT>();
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+static bool WriteAnimation(SnapshotWriter& writer, const BaseAnimation* animation)
+{
+    writer.Write(animation != nullptr);
+    return animation == nullptr || animation->WriteSnapshot(writer);
+}
+
+///------------------------------------------------------------------------------------------------
+
+static std::unique_ptr<BaseAnimation> ReadAnimation(SnapshotReader& reader)
+{
+    if (!reader.Read<bool>())
+    {
+        return nullptr;
+    }
+
+    auto animation = BaseAnimation::CreateFromSnapshot(reader);
+    if (!animation)
+    {
+        reader.Invalidate();
+    }
+
+    return animation;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void WriteResourceTable(SnapshotWriter& writer, const std::vector<resources::ResourceId>& resourceIds)
+{
+    auto& resService = resources::ResourceLoadingService::GetInstance();
+
+    writer.Write(static_cast<uint32_t>(resourceIds.size()));
+    for (const auto resourceId: resourceIds)
+    {
+        writer.Write(resourceId);
+        writer.WriteString(resService.GetResourcePath(resourceId));
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool ReadResourceTable(SnapshotReader& reader)
+{
+    auto& resService = resources::ResourceLoadingService::GetInstance();
+
+    const auto resourceCount = reader.ReadCount(sizeof(resources::ResourceId) + sizeof(uint32_t));
+    for (uint32_t i = 0; i < resourceCount && reader.IsValid(); ++i)
+    {
+        const auto resourceId = reader.Read<resources::ResourceId>();
+        const auto resourcePath = reader.ReadString();
+
+        if (!reader.IsValid() || resService.HasLoadedResource(resourceId))
+        {
+            continue;
+        }
+
+        if (resourcePath.empty() || resService.LoadResource(resourcePath) != resourceId)
+        {
+            Log(LogType::ERROR, "Could not reload resource %s (%s) for level snapshot", std::to_string(resourceId).c_str(), resourcePath.c_str());
+            reader.Invalidate();
+        }
+    }
+
+    return reader.IsValid();
+}
+
+///------------------------------------------------------------------------------------------------
+
+void WriteBody(SnapshotWriter& writer, const b2Body& body)
+{
+    writer.Write(body.GetType());
+    writer.Write(body.GetTransform());
+    writer.Write(body.GetLinearVelocity());
+    writer.Write(body.GetAngularVelocity());
+    writer.Write(body.GetLinearDamping());
+    writer.Write(body.GetAngularDamping());
+    writer.Write(body.GetGravityScale());
+    writer.Write(body.IsBullet());
+    writer.Write(body.IsFixedRotation());
+    writer.Write(body.IsSleepingAllowed());
+    writer.Write(body.IsAwake());
+    writer.Write(body.IsActive());
+
+    // Fixtures get prepended to the body's fixture list, so they are written
+    // out in reverse for them to be recreated in their original order
+    std::vector<const b2Fixture*> fixtures;
+    for (const b2Fixture* fixture = body.GetFixtureList(); fixture; fixture = fixture->GetNext())
+    {
+        if (fixture->GetType() == b2Shape::e_polygon || fixture->GetType() == b2Shape::e_circle)
+        {
+            fixtures.push_back(fixture);
+        }
+        else
+        {
+            Log(LogType::WARNING, "Skipping unsupported fixture shape %d in level snapshot", static_cast<int>(fixture->GetType()));
+        }
+    }
+
+    writer.Write(static_cast<uint32_t>(fixtures.size()));
+    for (auto fixtureIter = fixtures.rbegin(); fixtureIter != fixtures.rend(); ++fixtureIter)
+    {
+        const auto* fixture = *fixtureIter;
+        writer.Write(fixture->GetType());
+
+        if (fixture->GetType() == b2Shape::e_polygon)
+        {
+            // The shape's internals are written as is, since recomputing the hull of the
+            // vertices could reorder them and change how the body gets simulated
+            const auto& polygonShape = *static_cast<const b2PolygonShape*>(fixture->GetShape());
+            writer.Write(polygonShape.m_count);
+            writer.Write(polygonShape.m_centroid);
+            for (int32 i = 0; i < polygonShape.m_count; ++i)
+            {
+                writer.Write(polygonShape.m_vertices[i]);
+                writer.Write(polygonShape.m_normals[i]);
+            }
+            writer.Write(polygonShape.m_radius);
+        }
+        else
+        {
+            const auto& circleShape = *static_cast<const b2CircleShape*>(fixture->GetShape());
+            writer.Write(circleShape.m_p);
+            writer.Write(circleShape.m_radius);
+        }
+
+        writer.Write(fixture->GetDensity());
+        writer.Write(fixture->GetFriction());
+        writer.Write(fixture->GetRestitution());
+        writer.Write(fixture->IsSensor());
+        writer.Write(fixture->GetFilterData());
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+b2Body* ReadBody(SnapshotReader& reader, b2World& box2dWorld)
+{
+    b2BodyDef bodyDef;
+    bodyDef.type = reader.Read<b2BodyType>();
+
+    const auto transform = reader.Read<b2Transform>();
+    bodyDef.position = transform.p;
+    bodyDef.angle = transform.q.GetAngle();
+    bodyDef.linearVelocity = reader.Read<b2Vec2>();
+    bodyDef.angularVelocity = reader.Read<float32>();
+    bodyDef.linearDamping = reader.Read<float32>();
+    bodyDef.angularDamping = reader.Read<float32>();
+    bodyDef.gravityScale = reader.Read<float32>();
+    bodyDef.bullet = reader.Read<bool>();
+    bodyDef.fixedRotation = reader.Read<bool>();
+    bodyDef.allowSleep = reader.Read<bool>();
+    bodyDef.awake = reader.Read<bool>();
+    bodyDef.active = reader.Read<bool>();
+
+    if (bodyDef.type != b2_staticBody && bodyDef.type != b2_kinematicBody && bodyDef.type != b2_dynamicBody)
+    {
+        reader.Invalidate();
+    }
+
+    const auto fixtureCount = reader.ReadCount(sizeof(b2Shape::Type));
+    std::vector<FixtureData> fixtures(fixtureCount);
+    for (auto& fixtureData: fixtures)
+    {
+        fixtureData.mShapeType = reader.Read<b2Shape::Type>();
+
+        if (fixtureData.mShapeType == b2Shape::e_polygon)
+        {
+            auto& polygonShape = fixtureData.mPolygonShape;
+            polygonShape.m_count = reader.Read<int32>();
+            if (polygonShape.m_count < 3 || polygonShape.m_count > b2_maxPolygonVertices)
+            {
+                reader.Invalidate();
+                break;
+            }
+
+            polygonShape.m_centroid = reader.Read<b2Vec2>();
+            for (int32 i = 0; i < polygonShape.m_count; ++i)
+            {
+                polygonShape.m_vertices[i] = reader.Read<b2Vec2>();
+                polygonShape.m_normals[i] = reader.Read<b2Vec2>();
+            }
+            polygonShape.m_radius = reader.Read<float32>();
+            fixtureData.mFixtureDef.shape = &polygonShape;
+        }
+        else if (fixtureData.mShapeType == b2Shape::e_circle)
+        {
+            fixtureData.mCircleShape.m_p = reader.Read<b2Vec2>();
+            fixtureData.mCircleShape.m_radius = reader.Read<float32>();
+            fixtureData.mFixtureDef.shape = &fixtureData.mCircleShape;
+        }
+        else
+        {
+            reader.Invalidate();
+            break;
+        }
+
+        fixtureData.mFixtureDef.density = reader.Read<float32>();
+        fixtureData.mFixtureDef.friction = reader.Read<float32>();
+        fixtureData.mFixtureDef.restitution = reader.Read<float32>();
+        fixtureData.mFixtureDef.isSensor = reader.Read<bool>();
+        fixtureData.mFixtureDef.filter = reader.Read<b2Filter>();
+    }
+
+    if (!reader.IsValid())
+    {
+        return nullptr;
+    }
+
+    b2Body* body = box2dWorld.CreateBody(&bodyDef);
+    for (const auto& fixtureData: fixtures)
+    {
+        body->CreateFixture(&fixtureData.mFixtureDef);
+    }
+
+    return body;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool WriteSceneObject(SnapshotWriter& writer, const SceneObject& sceneObject)
+{
+    writer.Write(sceneObject.mBody != nullptr && sceneObject.mName == scene_object_utils::GenerateSceneObjectName(sceneObject));
+    writer.WriteStringId(sceneObject.mName);
+    writer.WriteStringId(sceneObject.mObjectFamilyTypeName);
+    writer.WriteStringId(sceneObject.mStateName);
+    writer.WriteStringId(sceneObject.mFontName);
+    writer.WriteString(sceneObject.mText);
+
+    WriteUniformValues(writer, sceneObject.mShaderBoolUniformValues);
+    WriteUniformValues(writer, sceneObject.mShaderIntUniformValues);
+    WriteUniformValues(writer, sceneObject.mShaderFloatUniformValues);
+    WriteUniformValues(writer, sceneObject.mShaderFloatVec4UniformValues);
+    WriteUniformValues(writer, sceneObject.mShaderMat4UniformValues);
+
+    if (!WriteAnimation(writer, sceneObject.mAnimation.get()))
+    {
+        return false;
+    }
+
+    writer.Write(static_cast<uint32_t>(sceneObject.mExtraCompoundingAnimations.size()));
+    for (const auto& extraAnimation: sceneObject.mExtraCompoundingAnimations)
+    {
+        if (!WriteAnimation(writer, extraAnimation.get()))
+        {
+            return false;
+        }
+    }
+
+    writer.Write(sceneObject.mPosition);
+    writer.Write(sceneObject.mRotation);
+    writer.Write(sceneObject.mScale);
+    writer.Write(sceneObject.mBodyCustomScale);
+    writer.Write(sceneObject.mBodyCustomOffset);
+    writer.Write(sceneObject.mSceneObjectType);
+    writer.Write(sceneObject.mDormantMillis);
+    writer.Write(sceneObject.mHealth);
+    writer.Write(sceneObject.mInvisible);
+    writer.Write(sceneObject.mInvulnerable);
+    writer.Write(sceneObject.mCustomDrivenMovement);
+    writer.Write(sceneObject.mCrossSceneLifetime);
+
+    writer.Write(sceneObject.mBody != nullptr);
+    if (sceneObject.mBody)
+    {
+        writer.Write(sceneObject.mBody->GetUserData() != nullptr);
+        WriteBody(writer, *sceneObject.mBody);
+    }
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool ReadSceneObject(SnapshotReader& reader, b2World& box2dWorld, SceneObject& outSceneObject)
+{
+    const auto hasGeneratedName = reader.Read<bool>();
+    const auto snapshotName = reader.ReadRawStringId();
+
+    outSceneObject.mName = snapshotName;
+    outSceneObject.mObjectFamilyTypeName = reader.ReadRawStringId();
+    outSceneObject.mStateName = reader.ReadRawStringId();
+    outSceneObject.mFontName = reader.ReadRawStringId();
+    outSceneObject.mText = reader.ReadString();
+
+    ReadUniformValues(reader, outSceneObject.mShaderBoolUniformValues);
+    ReadUniformValues(reader, outSceneObject.mShaderIntUniformValues);
+    ReadUniformValues(reader, outSceneObject.mShaderFloatUniformValues);
+    ReadUniformValues(reader, outSceneObject.mShaderFloatVec4UniformValues);
+    ReadUniformValues(reader, outSceneObject.mShaderMat4UniformValues);
+
+    outSceneObject.mAnimation = ReadAnimation(reader);
+
+    const auto extraAnimationCount = reader.ReadCount();
+    for (uint32_t i = 0; i < extraAnimationCount && reader.IsValid(); ++i)
+    {
+        auto extraAnimation = ReadAnimation(reader);
+        if (extraAnimation)
+        {
+            outSceneObject.mExtraCompoundingAnimations.push_back(std::move(extraAnimation));
+        }
+    }
+
+    outSceneObject.mPosition = reader.Read<glm::vec3>();
+    outSceneObject.mRotation = reader.Read<glm::vec3>();
+    outSceneObject.mScale = reader.Read<glm::vec3>();
+    outSceneObject.mBodyCustomScale = reader.Read<glm::vec3>();
+    outSceneObject.mBodyCustomOffset = reader.Read<glm::vec3>();
+    outSceneObject.mSceneObjectType = reader.Read<SceneObjectType>();
+    outSceneObject.mDormantMillis = reader.Read<float>();
+    outSceneObject.mHealth = reader.Read<float>();
+    outSceneObject.mInvisible = reader.Read<bool>();
+    outSceneObject.mInvulnerable = reader.Read<bool>();
+    outSceneObject.mCustomDrivenMovement = reader.Read<bool>();
+    outSceneObject.mCrossSceneLifetime = reader.Read<bool>();
+
+    if (outSceneObject.mSceneObjectType != SceneObjectType::WorldGameObject && outSceneObject.mSceneObjectType != SceneObjectType::GUIObject)
+    {
+        reader.Invalidate();
+    }
+
+    if (reader.Read<bool>())
+    {
+        const auto hasUserData = reader.Read<bool>();
+        outSceneObject.mBody = ReadBody(reader, box2dWorld);
+
+        if (outSceneObject.mBody)
+        {
+            if (hasGeneratedName)
+            {
+                outSceneObject.mName = scene_object_utils::GenerateSceneObjectName(outSceneObject);
+                reader.AddRename(snapshotName, outSceneObject.mName);
+            }
+
+            if (hasUserData)
+            {
+                outSceneObject.mBody->SetUserData(new strutils::StringId(outSceneObject.mName));
+            }
+        }
+    }
+
+    return reader.IsValid();
+}
+
+///------------------------------------------------------------------------------------------------
+
+void WriteRandomEngine(SnapshotWriter& writer)
+{
+    std::stringstream randomEngineState;
+    randomEngineState << math::GetRandomEngine();
+    writer.WriteString(randomEngineState.str());
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool ReadRandomEngine(SnapshotReader& reader)
+{
+    std::stringstream randomEngineState(reader.ReadString());
+    if (!reader.IsValid())
+    {
+        return false;
+    }
+
+    std::mt19937 randomEngine;
+    randomEngineState >> randomEngine;
+    if (randomEngineState.fail())
+    {
+        reader.Invalidate();
+        return false;
+    }
+
+    math::GetRandomEngine() = randomEngine;
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+uint64_t HashBytes(const void* data, const size_t dataSize, const uint64_t hash /* FNV offset basis */)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+
+    auto result = hash;
+    for (size_t i = 0; i < dataSize; ++i)
+    {
+        result = (result ^ bytes[i]) * 1099511628211ull;
+    }
+    return result;
+}
+
+///------------------------------------------------------------------------------------------------
+
+uint64_t DigestSceneObjects(const std::vector<SceneObject>& sceneObjects)
+{
+    SnapshotWriter digestWriter;
+
+    for (const auto& sceneObject: sceneObjects)
+    {
+        if (sceneObject.mCrossSceneLifetime)
+        {
+            continue;
+        }
+
+        digestWriter.WriteStringId(sceneObject.mObjectFamilyTypeName);
+        digestWriter.WriteStringId(sceneObject.mStateName);
+        digestWriter.WriteString(sceneObject.mText);
+        digestWriter.Write(sceneObject.mPosition);
+        digestWriter.Write(sceneObject.mRotation);
+        digestWriter.Write(sceneObject.mScale);
+        digestWriter.Write(sceneObject.mDormantMillis);
+        digestWriter.Write(sceneObject.mHealth);
+        digestWriter.Write(sceneObject.mInvisible);
+        digestWriter.Write(sceneObject.mInvulnerable);
+        WriteUniformValues(digestWriter, sceneObject.mShaderFloatUniformValues);
+
+        if (!WriteAnimation(digestWriter, sceneObject.mAnimation.get()))
+        {
+            digestWriter.Write(static_cast<uint8_t>(0xFF));
+        }
+
+        for (const auto& extraAnimation: sceneObject.mExtraCompoundingAnimations)
+        {
+            if (!WriteAnimation(digestWriter, extraAnimation.get()))
+            {
+                digestWriter.Write(static_cast<uint8_t>(0xFF));
+            }
+        }
+
+        if (sceneObject.mBody)
+        {
+            digestWriter.Write(sceneObject.mBody->GetTransform());
+            digestWriter.Write(sceneObject.mBody->GetLinearVelocity());
+            digestWriter.Write(sceneObject.mBody->GetAngularVelocity());
+            digestWriter.Write(sceneObject.mBody->IsAwake());
+        }
+    }
+
+    const auto& digestData = digestWriter.GetData();
+    return HashBytes(digestData.data(), digestData.size());
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool SaveSnapshotFile(const std::vector<unsigned char>& snapshot)
+{
+    SnapshotWriter fileWriter;
+    fileWriter.Write(SNAPSHOT_FILE_MAGIC);
+    fileWriter.Write(SNAPSHOT_FILE_VERSION);
+    fileWriter.Write(HashBytes(snapshot.data(), snapshot.size()));
+    fileWriter.WriteBytes(snapshot);
+
+    const auto& fileData = fileWriter.GetData();
+    if (!persistence_utils::WriteFileAtomically(objectiveC_utils::BuildLocalFileSaveLocation(SNAPSHOT_FILE_NAME), fileData.data(), fileData.size()))
+    {
+        Log(LogType::ERROR, "Could not write level snapshot file");
+        return false;
+    }
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool LoadSnapshotFile(std::vector<unsigned char>& outSnapshot)
+{
+    std::ifstream snapshotFile(objectiveC_utils::BuildLocalFileSaveLocation(SNAPSHOT_FILE_NAME), std::ios::binary);
+    if (!snapshotFile.good())
+    {
+        return false;
+    }
+
+    const std::vector<unsigned char> fileData((std::istreambuf_iterator<char>(snapshotFile)), std::istreambuf_iterator<char>());
+
+    SnapshotReader fileReader(fileData.data(), fileData.size());
+    const auto magic = fileReader.Read<uint32_t>();
+    const auto version = fileReader.Read<uint16_t>();
+    const auto checksum = fileReader.Read<uint64_t>();
+    auto snapshot = fileReader.ReadBytes();
+
+    if (!fileReader.IsValid() || !fileReader.IsAtEnd() || magic != SNAPSHOT_FILE_MAGIC || version != SNAPSHOT_FILE_VERSION || checksum != HashBytes(snapshot.data(), snapshot.size()))
+    {
+        Log(LogType::WARNING, "Discarding corrupt or outdated level snapshot file");
+        return false;
+    }
+
+    outSnapshot = std::move(snapshot);
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void DeleteSnapshotFile()
+{
+    std::remove(objectiveC_utils::BuildLocalFileSaveLocation(SNAPSHOT_FILE_NAME).c_str());
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
@@ -0,0 +1,182 @@
+///------------------------------------------------------------------------------------------------
+///  LevelSnapshot.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef LevelSnapshot_h
+#define LevelSnapshot_h
+
+///------------------------------------------------------------------------------------------------
+
+#include "../resloading/ResourceLoadingService.h"
+#include "../utils/StringUtils.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+class b2Body;
+class b2World;
+struct SceneObject;
+
+///------------------------------------------------------------------------------------------------
+
+/// Appends values to a level snapshot blob. Values are written in their in memory representation,
+/// since snapshots are only ever restored by the same build on the same device.
+class SnapshotWriter final
+{
+public:
+    template<class T>
+    void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written as is");
+        const auto offset = mData.size();
+        mData.resize(offset + sizeof(T));
+        std::memcpy(mData.data() + offset, &value, sizeof(T));
+    }
+
+    void WriteBytes(const std::vector<unsigned char>& bytes);
+    void WriteString(const std::string& string);
+    void WriteStringId(const strutils::StringId& stringId);
+
+    /// Writes the resource id, also recording it so that the resource can be reloaded (if needed) before restoring.
+    void WriteResourceId(const resources::ResourceId resourceId);
+
+    const std::vector<unsigned char>& GetData() const;
+    const std::vector<resources::ResourceId>& GetResourceIds() const;
+
+private:
+    std::vector<unsigned char> mData;
+    std::vector<resources::ResourceId> mResourceIds;
+    std::unordered_set<resources::ResourceId, resources::ResourceIdHasher> mRecordedResourceIds;
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// Reads values back from a level snapshot blob. Reading past the end (or anything else failing
+/// validation along the way) invalidates the reader, with all subsequent reads returning default values,
+/// so that callers only need to check IsValid once they are done reading.
+class SnapshotReader final
+{
+public:
+    SnapshotReader(const unsigned char* data, const size_t dataSize);
+
+    template<class T>
+    T Read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read as is");
+        T value{};
+        if (!mValid || mDataSize - mOffset < sizeof(T))
+        {
+            mValid = false;
+            return value;
+        }
+
+        std::memcpy(&value, mData + mOffset, sizeof(T));
+        mOffset += sizeof(T);
+        return value;
+    }
+
+    /// Reads an element count, invalidating the reader if there aren't enough bytes left
+    /// for that many elements (of at least minElementSize bytes each).
+    uint32_t ReadCount(const size_t minElementSize = 1);
+
+    std::vector<unsigned char> ReadBytes();
+    std::string ReadString();
+
+    /// Reads a string id, mapping names of scene objects that got renamed while restoring to their new names.
+    strutils::StringId ReadStringId();
+
+    /// Reads a string id exactly as it was written.
+    strutils::StringId ReadRawStringId();
+
+    void AddRename(const strutils::StringId& oldName, const strutils::StringId& newName);
+
+    void Invalidate();
+    bool IsValid() const;
+    bool IsAtEnd() const;
+
+private:
+    const unsigned char* mData;
+    size_t mDataSize;
+    size_t mOffset;
+    std::unordered_map<strutils::StringId, strutils::StringId, strutils::StringIdHasher> mRenames;
+    bool mValid;
+};
+
+///------------------------------------------------------------------------------------------------
+
+namespace level_snapshot
+{
+
+///------------------------------------------------------------------------------------------------
+/// Writes the paths of the given resources, for ReadResourceTable to reload any that have been
+/// unloaded (or were never loaded in this session) by the time the snapshot gets restored.
+void WriteResourceTable(SnapshotWriter& writer, const std::vector<resources::ResourceId>& resourceIds);
+bool ReadResourceTable(SnapshotReader& reader);
+
+///------------------------------------------------------------------------------------------------
+/// Writes the body's definition, fixtures and full dynamic state (transform, velocities, sleep state).
+/// Contacts, the solver's warm starting impulses and accumulated forces are not captured.
+void WriteBody(SnapshotWriter& writer, const b2Body& body);
+
+///------------------------------------------------------------------------------------------------
+/// Recreates a body written by WriteBody in the given world.
+/// @returns the new body, or nullptr if the snapshot data is invalid.
+b2Body* ReadBody(SnapshotReader& reader, b2World& box2dWorld);
+
+///------------------------------------------------------------------------------------------------
+/// Writes the scene object with all its animations and its body. Completion callbacks of the animations
+/// are not captured, and need to be reattached by their owners after restoring.
+/// @returns false if the scene object can't be captured (see BaseAnimation::WriteSnapshot).
+bool WriteSceneObject(SnapshotWriter& writer, const SceneObject& sceneObject);
+
+///------------------------------------------------------------------------------------------------
+/// Recreates a scene object written by WriteSceneObject (with its body in the given world). Scene objects
+/// named after the address of their body get renamed after their new body, with the rename registered
+/// in the reader so that any later reads of the old name map to the new one.
+/// @returns whether the scene object could be read.
+bool ReadSceneObject(SnapshotReader& reader, b2World& box2dWorld, SceneObject& outSceneObject);
+
+///------------------------------------------------------------------------------------------------
+/// Writes/reads the state of the global random engine (see math::GetRandomEngine).
+void WriteRandomEngine(SnapshotWriter& writer);
+bool ReadRandomEngine(SnapshotReader& reader);
+
+///------------------------------------------------------------------------------------------------
+/// FNV-1a hash of the given bytes, optionally continuing a previous hash.
+uint64_t HashBytes(const void* data, const size_t dataSize, const uint64_t hash = 14695981039346656037ull);
+
+///------------------------------------------------------------------------------------------------
+/// Hashes the simulated state of all scene objects that don't outlive the scene, independently of their
+/// names (which can differ between runs), for checking that two runs of the same level played out identically.
+uint64_t DigestSceneObjects(const std::vector<SceneObject>& sceneObjects);
+
+///------------------------------------------------------------------------------------------------
+/// Persists a snapshot (checksummed and written atomically) so that it survives the app getting
+/// terminated while in the background.
+bool SaveSnapshotFile(const std::vector<unsigned char>& snapshot);
+
+///------------------------------------------------------------------------------------------------
+/// Loads a persisted snapshot.
+/// @returns false if there is no snapshot file, or it fails validation.
+bool LoadSnapshotFile(std::vector<unsigned char>& outSnapshot);
+
+///------------------------------------------------------------------------------------------------
+void DeleteSnapshotFile();
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* LevelSnapshot_h */
@@ -7,15 +7,20 @@
 
 #include "BlueprintFlows.h"
 #include "FontRepository.h"
+#include "FrameWorkScheduler.h"
 #include "GameConstants.h"
-#include "GameSingletons.h"
+#include "GameContext.h"
 #include "InputContext.h"
+#include "InputRecording.h"
+#include "LevelSnapshot.h"
 #include "LevelUpdater.h"
 #include "ObjectTypeDefinitionRepository.h"
 #include "PhysicsConstants.h"
 #include "PhysicsCollisionListener.h"
+#include "ProjectileSystem.h"
 #include "Scene.h"
 #include "SceneObjectUtils.h"
+#include "SimulationProfiler.h"
 #include "Sounds.h"
 
 #include "dataloaders/UpgradesLoader.h"
@@ -44,6 +49,14 @@
 
 static const std::string DROPPED_CRYSTAL_NAME_PREFIX = "DROPPED_CRYSTAL_";
 
+static const strutils::StringId PLAYER_BULLET_FLOW_KIND = strutils::StringId("player_bullet");
+static const strutils::StringId PLAYER_INVINCIBILITY_FLOW_KIND = strutils::StringId("player_invincibility");
+static const strutils::StringId WAVE_ENEMY_REMOVAL_FLOW_KIND = strutils::StringId("wave_enemy_removal");
+static const strutils::StringId DROPPED_CRYSTAL_FLOW_KIND = strutils::StringId("dropped_crystal");
+static const strutils::StringId ENEMY_PROJECTILE_FLOW_KIND = strutils::StringId("enemy_projectile");
+
+static const uint16_t LEVEL_SNAPSHOT_VERSION = 2;
+
 static const glm::vec4 ENEMY_TEXT_DAMAGE_COLOR = glm::vec4(1.0f, 1.0f, 1.0f, 0.8f);
 static const glm::vec4 PLAYER_TEXT_DAMAGE_COLOR = glm::vec4(1.0f, 0.3f, 0.3f, 0.8f);
 
@@ -88,32 +101,119 @@ static const float ACCELEROMETER_X_SENSITIVITY_FACTOR = 1000.0f;
 static const float ACCELEROMETER_Y_SENSITIVITY_FACTOR = 2000.0f;
 static const float ACCELEROMETER_ROLL_DIFF_THRESHOLD = 5.0f;
 
+static const std::vector<SceneObjectType> SNAPSHOT_CAMERA_TYPES = { SceneObjectType::WorldGameObject, SceneObjectType::GUIObject };
+
+///------------------------------------------------------------------------------------------------
+
+// Lights and flows of a snapshot, staged until the whole snapshot checks out
+struct SnapshotLight
+{
+    strutils::StringId mName;
+    glm::vec3 mPosition;
+    glm::vec4 mColor;
+    float mPower;
+};
+
+struct SnapshotFlow
+{
+    RepeatableFlow::RestoreTag mRestoreTag;
+    float mDurationMillis;
+    RepeatableFlow::RepeatPolicy mRepeatPolicy;
+    double mExpiryMillis;
+};
+
+///------------------------------------------------------------------------------------------------
+
+static uint64_t ComputeLevelFingerprint(const LevelDefinition& levelDef)
+{
+    SnapshotWriter fingerprintWriter;
+    fingerprintWriter.WriteStringId(levelDef.mLevelName);
+    fingerprintWriter.Write(static_cast<uint32_t>(levelDef.mWaves.size()));
+    
+    for (const auto& wave: levelDef.mWaves)
+    {
+        fingerprintWriter.WriteStringId(wave.mBossName);
+        fingerprintWriter.Write(wave.mBossHealth);
+        fingerprintWriter.Write(static_cast<uint32_t>(wave.mEnemies.size()));
+        
+        for (const auto& enemy: wave.mEnemies)
+        {
+            fingerprintWriter.WriteStringId(enemy.mGameObjectEnemyType);
+            fingerprintWriter.Write(enemy.mPosition);
+        }
+    }
+    
+    const auto& fingerprintData = fingerprintWriter.GetData();
+    return level_snapshot::HashBytes(fingerprintData.data(), fingerprintData.size());
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void WriteGameContext(const GameContext& gameContext, SnapshotWriter& writer)
+{
+    writer.Write(gameContext.GetBossMaxHealth());
+    writer.Write(gameContext.GetBossCurrentHealth());
+    writer.Write(gameContext.GetPlayerShieldHealth());
+    writer.Write(gameContext.GetPlayerMaxHealth());
+    writer.Write(gameContext.GetPlayerCurrentHealth());
+    writer.Write(gameContext.GetPlayerDisplayedHealth());
+    writer.Write(static_cast<int64_t>(gameContext.GetCrystalCount()));
+    writer.Write(gameContext.GetDisplayedCrystalCount());
+    
+    // The shield upgrade gets unequipped once the shield breaks
+    const auto& equippedUpgrades = gameContext.GetEquippedUpgrades();
+    writer.Write(static_cast<uint32_t>(equippedUpgrades.size()));
+    for (const auto& equippedUpgrade: equippedUpgrades)
+    {
+        writer.WriteStringId(equippedUpgrade.mUpgradeNameId);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void DestroySceneObjectBodies(std::vector<SceneObject>& sceneObjects, b2World& box2dWorld)
+{
+    for (auto& sceneObject: sceneObjects)
+    {
+        if (sceneObject.mBody)
+        {
+            delete static_cast<strutils::StringId*>(sceneObject.mBody->GetUserData());
+            box2dWorld.DestroyBody(sceneObject.mBody);
+            sceneObject.mBody = nullptr;
+        }
+    }
+}
+
 ///------------------------------------------------------------------------------------------------
 
 LevelUpdater::LevelUpdater(Scene& scene, b2World& box2dWorld, LevelDefinition&& levelDef)
     : mScene(scene)
+    , mGameContext(scene.GetGameContext())
     , mBox2dWorld(box2dWorld)
     , mUpgradesLogicHandler(scene)
     , mStateMachine(&scene, this, &mUpgradesLogicHandler, &mBox2dWorld)
     , mBossAIController(scene, *this, mStateMachine, mBox2dWorld)
-    , mAccelerometerCalibrationValues(-GameSingletons::GetInputContext().mRawAccelerometerValues)
+    , mLevelStartEquippedUpgrades(mGameContext.GetEquippedUpgrades())
+    , mAccelerometerCalibrationValues(-mGameContext.GetInputContext().mRawAccelerometerValues)
     , mCurrentWaveNumber(0)
     , mBossAnimatedHealthBarPerc(0.0f)
+    , mBackgroundOffset(0.0f)
     , mAllowInputControl(false)
     , mMovementRotationAllowed(false)
     , mBossPositioned(false)
+    , mSettingsMenuRequested(false)
+    , mSnapshotPersisted(false)
 {
     mLevel = levelDef;
     
-    blueprint_flows::CreatePlayerBulletFlow(mFlows, mScene, mBox2dWorld);
+    mFlowScheduler.AddFlow(CreatePlayerBulletFlow());
     
-    static PhysicsCollisionListener collisionListener;
-    collisionListener.RegisterCollisionCallback(UnorderedCollisionCategoryPair(physics_constants::ENEMY_CATEGORY_BIT, physics_constants::PLAYER_BULLET_CATEGORY_BIT), [&](b2Body* firstBody, b2Body* secondBody)
+    auto& projectileSystem = mScene.GetProjectileSystem();
+    projectileSystem.RegisterHitCallback(physics_constants::PLAYER_BULLET_CATEGORY_BIT, physics_constants::ENEMY_CATEGORY_BIT, [&](const strutils::StringId& bulletName, b2Body* enemyBody)
     {
-        const auto& enemyName = *static_cast<strutils::StringId*>(firstBody->GetUserData());
+        const auto& enemyName = *static_cast<strutils::StringId*>(enemyBody->GetUserData());
         auto enemySceneObjectOpt = mScene.GetSceneObject(enemyName);
         
-        const auto& bulletName = *static_cast<strutils::StringId*>(secondBody->GetUserData());
         auto bulletSceneObjectOpt = mScene.GetSceneObject(bulletName);
         
         if (enemySceneObjectOpt && bulletSceneObjectOpt)
@@ -126,8 +226,8 @@ LevelUpdater::LevelUpdater(Scene& scene, b2World& box2dWorld, LevelDefinition&&
             
             if (!enemySO.mInvulnerable)
             {
-                auto bulletDamage = GameSingletons::GetPlayerAttackStat();
-                if (GameSingletons::GetGodeMode())
+                auto bulletDamage = mGameContext.GetPlayerAttackStat();
+                if (mGameContext.GetGodeMode())
                 {
                     bulletDamage = GOD_MODE_DAMAGE;
                 }
@@ -145,7 +245,7 @@ LevelUpdater::LevelUpdater(Scene& scene, b2World& box2dWorld, LevelDefinition&&
                 
                 if (scene_object_utils::IsSceneObjectBossPart(enemySO))
                 {
-                    GameSingletons::SetBossCurrentHealth(math::Max(0.0f, GameSingletons::GetBossCurrentHealth() - bulletDamage));
+                    mGameContext.SetBossCurrentHealth(math::Max(0.0f, mGameContext.GetBossCurrentHealth() - bulletDamage));
                 }
                 else
                 {
@@ -165,32 +265,41 @@ LevelUpdater::LevelUpdater(Scene& scene, b2World& box2dWorld, LevelDefinition&&
                 
                 objectiveC_utils::PlaySound(sounds::ENEMY_EXPLOSION_SFX);
                 
-                mFlows.emplace_back([=]()
-                {
-                    RemoveWaveEnemy(enemyName);
-                }, enemySO.mAnimation->VGetDurationMillis(), RepeatableFlow::RepeatPolicy::ONCE);
+                mFlowScheduler.AddFlow(CreateWaveEnemyRemovalFlow(enemyName, enemySO.mAnimation->VGetDurationMillis()));
                 
                 mActiveLightNames.insert(enemyName);
                 mScene.GetLightRepository().AddLight(LightType::POINT_LIGHT, enemyName, game_constants::POINT_LIGHT_COLOR, enemySO.mPosition, EXPLOSION_LIGHT_POWER);
             }
             
-            // Erase bullet collision mask so that it doesn't also contribute to other
-            // enemy damage until it is removed from b2World
-            auto bulletFilter = secondBody->GetFixtureList()[0].GetFilterData();
-            bulletFilter.maskBits = 0;
-            secondBody->GetFixtureList()[0].SetFilterData(bulletFilter);
-
+            // Spent, so that it doesn't also contribute to other enemy damage until it is removed
             mScene.RemoveAllSceneObjectsWithName(bulletName);
+            return true;
         }
+        
+        return false;
     });
     
+    projectileSystem.RegisterHitCallback(physics_constants::ENEMY_BULLET_CATEGORY_BIT, physics_constants::PLAYER_CATEGORY_BIT, [&](const strutils::StringId& enemyBulletName, b2Body*)
+    {
+        return OnPlayerHitByEnemyBullet(enemyBulletName);
+    });
+    
+    projectileSystem.RegisterHitCallback(physics_constants::PLAYER_BULLET_CATEGORY_BIT, physics_constants::BULLET_ONLY_WALL_CATEGORY_BIT, [&](const strutils::StringId& playerBulletName, b2Body*)
+    {
+        RemoveWaveEnemy(playerBulletName);
+        return true;
+    });
+    
+    projectileSystem.RegisterHitCallback(physics_constants::ENEMY_BULLET_CATEGORY_BIT, physics_constants::ENEMY_ONLY_WALL_CATEGORY_BIT, [&](const strutils::StringId& enemyBulletName, b2Body*)
+    {
+        RemoveWaveEnemy(enemyBulletName);
+        return true;
+    });
+    
+    auto& collisionListener = mScene.GetCollisionListener();
     collisionListener.RegisterCollisionCallback(UnorderedCollisionCategoryPair(physics_constants::PLAYER_CATEGORY_BIT, physics_constants::ENEMY_CATEGORY_BIT), [&](b2Body* firstBody, b2Body* secondBody)
     {
-        auto iter = std::find_if(mFlows.begin(), mFlows.end(), [](const RepeatableFlow& flow)
-        {
-            return flow.GetName() == game_constants::PLAYER_DAMAGE_INVINCIBILITY_FLOW_NAME;
-        });
-        if (iter != mFlows.end()) return;
+        if (mFlowScheduler.GetFlow(game_constants::PLAYER_DAMAGE_INVINCIBILITY_FLOW_NAME)) return;
         
         auto playerSceneObjectOpt = mScene.GetSceneObject(game_constants::PLAYER_SCENE_OBJECT_NAME);
         
@@ -206,27 +315,27 @@ LevelUpdater::LevelUpdater(Scene& scene, b2World& box2dWorld, LevelDefinition&&
             if (!playerSO.mInvulnerable)
             {
                 // Remove player shield/damage player flow
-                auto incomingDamage = GameSingletons::GetGodeMode() ? 0.0f : (enemySceneObjectTypeDef.mDamage - GameSingletons::GetPlayerShieldHealth());
+                auto incomingDamage = mGameContext.GetGodeMode() ? 0.0f : (enemySceneObjectTypeDef.mDamage - mGameContext.GetPlayerShieldHealth());
                 
-                if (GameSingletons::GetPlayerShieldHealth() > 0.0f)
+                if (mGameContext.GetPlayerShieldHealth() > 0.0f)
                 {
-                    GameSingletons::SetPlayerShieldHealth(GameSingletons::GetPlayerShieldHealth() - enemySceneObjectTypeDef.mDamage);
+                    mGameContext.SetPlayerShieldHealth(mGameContext.GetPlayerShieldHealth() - enemySceneObjectTypeDef.mDamage);
                     
-                    if (GameSingletons::GetPlayerShieldHealth() <= 0.0f)
+                    if (mGameContext.GetPlayerShieldHealth() <= 0.0f)
                     {
                         auto playerShieldOpt = mScene.GetSceneObject(game_constants::PLAYER_SHIELD_SCENE_OBJECT_NAME);
                         if (playerShieldOpt)
                         {
                             playerShieldOpt->get().mAnimation->VResume();
-                            GameSingletons::SetPlayerShieldHealth(0);
-                            GameSingletons::GetEquippedUpgrades().erase(std::find_if(GameSingletons::GetEquippedUpgrades().begin(), GameSingletons::GetEquippedUpgrades().end(), [&](const UpgradeDefinition& upgradeDefinition){ return upgradeDefinition.mUpgradeNameId == game_constants::PLAYER_SHIELD_UPGRADE_NAME; }));
+                            mGameContext.SetPlayerShieldHealth(0);
+                            mGameContext.GetEquippedUpgrades().erase(std::find_if(mGameContext.GetEquippedUpgrades().begin(), mGameContext.GetEquippedUpgrades().end(), [&](const UpgradeDefinition& upgradeDefinition){ return upgradeDefinition.mUpgradeNameId == game_constants::PLAYER_SHIELD_UPGRADE_NAME; }));
                         }
                     }
                 }
                 
                 if (incomingDamage > 0.0f)
                 {
-                    GameSingletons::SetPlayerCurrentHealth(GameSingletons::GetPlayerCurrentHealth() - incomingDamage);
+                    mGameContext.SetPlayerCurrentHealth(mGameContext.GetPlayerCurrentHealth() - incomingDamage);
                     OnPlayerDamaged();
                     CreateTextOnDamage(playerSO.mName, math::Box2dVec2ToGlmVec3(playerSO.mBody->GetWorldCenter()), incomingDamage);
                     objectiveC_utils::PlaySound(sounds::PLAYER_DAMAGED_SFX);
@@ -237,93 +346,31 @@ LevelUpdater::LevelUpdater(Scene& scene, b2World& box2dWorld, LevelDefinition&&
                 {
                     scene_object_utils::ChangeSceneObjectState(enemySO, enemySceneObjectTypeDef, game_constants::DYING_SCENE_OBJECT_STATE);
                     
-                    mFlows.emplace_back([=]()
-                                        {
-                        RemoveWaveEnemy(enemyName);
-                    }, enemySO.mAnimation->VGetDurationMillis(), RepeatableFlow::RepeatPolicy::ONCE);
+                    mFlowScheduler.AddFlow(CreateWaveEnemyRemovalFlow(enemyName, enemySO.mAnimation->VGetDurationMillis()));
                     
                     mActiveLightNames.insert(enemyName);
                     mScene.GetLightRepository().AddLight(LightType::POINT_LIGHT, enemyName, game_constants::POINT_LIGHT_COLOR, enemySO.mPosition, EXPLOSION_LIGHT_POWER);
                 }
                 
                 // Enable invincibility flow
-                mFlows.emplace_back([]()
-                                    {
-                }, game_constants::PLAYER_INVINCIBILITY_FLOW_DELAY_MILLIS, RepeatableFlow::RepeatPolicy::ONCE, game_constants::PLAYER_DAMAGE_INVINCIBILITY_FLOW_NAME);
+                mFlowScheduler.AddFlow(CreatePlayerInvincibilityFlow());
             }
         }
     });
     
+    // Boss bullets are bodies, rather than projectiles
     collisionListener.RegisterCollisionCallback(UnorderedCollisionCategoryPair(physics_constants::PLAYER_CATEGORY_BIT, physics_constants::ENEMY_BULLET_CATEGORY_BIT), [&](b2Body* firstBody, b2Body* secondBody)
     {
-        auto iter = std::find_if(mFlows.begin(), mFlows.end(), [](const RepeatableFlow& flow)
-        {
-            return flow.GetName() == game_constants::PLAYER_DAMAGE_INVINCIBILITY_FLOW_NAME;
-        });
-        if (iter != mFlows.end()) return;
-        
-        auto playerSceneObjectOpt = mScene.GetSceneObject(game_constants::PLAYER_SCENE_OBJECT_NAME);
-        
-        const auto& enemyBulletName = *static_cast<strutils::StringId*>(secondBody->GetUserData());
-        auto enemyBulletSceneObjectOpt = mScene.GetSceneObject(enemyBulletName);
-        
-        if (playerSceneObjectOpt && enemyBulletSceneObjectOpt)
+        if (OnPlayerHitByEnemyBullet(*static_cast<strutils::StringId*>(secondBody->GetUserData())))
         {
-            auto& playerSO = playerSceneObjectOpt->get();
-            auto& enemyBulletSO = enemyBulletSceneObjectOpt->get();
-            
-            if (!playerSO.mInvulnerable)
-            {
-                auto enemyBulletSceneObjectTypeDef = ObjectTypeDefinitionRepository::GetInstance().GetObjectTypeDefinition(enemyBulletSO.mObjectFamilyTypeName)->get();
-                
-                // Remove player shield/damage player flow
-                auto incomingDamage = GameSingletons::GetGodeMode() ? 0.0f : (enemyBulletSceneObjectTypeDef.mDamage - GameSingletons::GetPlayerShieldHealth());
-                
-                if (GameSingletons::GetPlayerShieldHealth() > 0.0f)
-                {
-                    GameSingletons::SetPlayerShieldHealth(GameSingletons::GetPlayerShieldHealth() - enemyBulletSceneObjectTypeDef.mDamage);
-                    
-                    if (GameSingletons::GetPlayerShieldHealth() <= 0.0f)
-                    {
-                        auto playerShieldOpt = mScene.GetSceneObject(game_constants::PLAYER_SHIELD_SCENE_OBJECT_NAME);
-                        if (playerShieldOpt)
-                        {
-                            playerShieldOpt->get().mAnimation->VResume();
-                            GameSingletons::SetPlayerShieldHealth(0);
-                            GameSingletons::GetEquippedUpgrades().erase(std::find_if(GameSingletons::GetEquippedUpgrades().begin(), GameSingletons::GetEquippedUpgrades().end(), [&](const UpgradeDefinition& upgradeDefinition){ return upgradeDefinition.mUpgradeNameId == game_constants::PLAYER_SHIELD_UPGRADE_NAME; }));
-                        }
-                    }
-                }
-                
-                if (incomingDamage > 0.0f)
-                {
-                    GameSingletons::SetPlayerCurrentHealth(GameSingletons::GetPlayerCurrentHealth() - incomingDamage);
-                    OnPlayerDamaged();
-                    CreateTextOnDamage(playerSO.mName, math::Box2dVec2ToGlmVec3(playerSO.mBody->GetWorldCenter()), incomingDamage);
-                    objectiveC_utils::PlaySound(sounds::PLAYER_DAMAGED_SFX);
-                }
-                
-                mFlows.emplace_back([]()
-                {
-                }, game_constants::PLAYER_INVINCIBILITY_FLOW_DELAY_MILLIS, RepeatableFlow::RepeatPolicy::ONCE, game_constants::PLAYER_DAMAGE_INVINCIBILITY_FLOW_NAME);
-                
-                // Erase bullet collision mask so that it doesn't also contribute to other
-                // enemy damage until it is removed from b2World
-                auto bulletFilter = secondBody->GetFixtureList()[0].GetFilterData();
-                bulletFilter.maskBits = 0;
-                secondBody->GetFixtureList()[0].SetFilterData(bulletFilter);
-                
-                RemoveWaveEnemy(enemyBulletName);
-            }
+            // Erase bullet collision mask so that it doesn't also contribute to other
+            // enemy damage until it is removed from b2World
+            auto bulletFilter = secondBody->GetFixtureList()[0].GetFilterData();
+            bulletFilter.maskBits = 0;
+            secondBody->GetFixtureList()[0].SetFilterData(bulletFilter);
         }
     });
     
-    collisionListener.RegisterCollisionCallback(UnorderedCollisionCategoryPair(physics_constants::PLAYER_BULLET_CATEGORY_BIT, physics_constants::BULLET_ONLY_WALL_CATEGORY_BIT), [&](b2Body* firstBody, b2Body* secondBody)
-    {
-        const auto& playerBulletName = *static_cast<strutils::StringId*>(firstBody->GetUserData());
-        RemoveWaveEnemy(playerBulletName);
-    });
-
     collisionListener.RegisterCollisionCallback(UnorderedCollisionCategoryPair(physics_constants::ENEMY_CATEGORY_BIT, physics_constants::ENEMY_ONLY_WALL_CATEGORY_BIT), [&](b2Body* firstBody, b2Body* secondBody)
     {
         const auto& enemyName = *static_cast<strutils::StringId*>(firstBody->GetUserData());
@@ -336,8 +383,6 @@ LevelUpdater::LevelUpdater(Scene& scene, b2World& box2dWorld, LevelDefinition&&
         RemoveWaveEnemy(enemyBulletName);
     });
     
-    mBox2dWorld.SetContactListener(&collisionListener);
-    
 #ifdef DEBUG
     mStateMachine.RegisterState<DebugConsoleGameState>();
 #endif
@@ -353,6 +398,14 @@ LevelUpdater::LevelUpdater(Scene& scene, b2World& box2dWorld, LevelDefinition&&
     mWaveEnemies.clear();
     mCurrentWaveNumber = 0;
     mStateMachine.InitStateMachine(WaveIntroGameState::STATE_NAME);
+    
+    // A snapshot persisted when the app last went to the background gets resumed on the first update,
+    // provided it was taken from this very level (see ResumePersistedSnapshot). Headless runs, recordings and replays
+    // always start afresh.
+    if (!mGameContext.IsHeadless() && !InputRecorder::GetInstance().IsRecording() && !InputReplayer::GetInstance().IsReplaying())
+    {
+        level_snapshot::LoadSnapshotFile(mPersistedSnapshot);
+    }
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -366,6 +419,9 @@ void LevelUpdater::VOnAppStateChange(Uint32 event)
         case SDL_APP_WILLENTERBACKGROUND:
         case SDL_APP_DIDENTERBACKGROUND:
         {
+            // The app might get terminated while in the background
+            PersistSnapshot();
+            
 #ifdef DEBUG
             hasLeftForegroundOnce = true;
 #else
@@ -392,6 +448,25 @@ void LevelUpdater::VOnAppStateChange(Uint32 event)
 ///------------------------------------------------------------------------------------------------
 
 PostStateUpdateDirective LevelUpdater::VUpdate(std::vector<SceneObject>& sceneObjects, const float dtMillis)
+{
+    if (!mPersistedSnapshot.empty())
+    {
+        ResumePersistedSnapshot();
+    }
+    
+#ifdef DEBUG
+    if (mSnapshotRoundTrip)
+    {
+        return UpdateSnapshotRoundTrip(sceneObjects, dtMillis);
+    }
+#endif
+    
+    return UpdateLevel(sceneObjects, dtMillis);
+}
+
+///------------------------------------------------------------------------------------------------
+
+PostStateUpdateDirective LevelUpdater::UpdateLevel(std::vector<SceneObject>& sceneObjects, const float dtMillis)
 {
     // State machines empties out once the level is finished
     if (mStateMachine.IsEmpty())
@@ -399,17 +474,46 @@ PostStateUpdateDirective LevelUpdater::VUpdate(std::vector<SceneObject>& sceneOb
         return PostStateUpdateDirective::BLOCK_UPDATE;
     }
     
+    if (mSettingsMenuRequested)
+    {
+        mSettingsMenuRequested = false;
+        PersistSnapshot();
+        mStateMachine.PushState(SettingsMenuGameState::STATE_NAME);
+    }
+    
     // A BLOCK_UPDATE directive from the FSM signals a e.g. popup, the existence of which
     // makes it so that we should skip the rest of the world/SOs/Elements in the scene from updating below
-    mLastPostStateMachineUpdateDirective = mStateMachine.Update(dtMillis);
+    {
+        SimulationProfiler::ScopedTimer stateMachineTimer(SimulationSubsystem::STATE_MACHINE);
+        mLastPostStateMachineUpdateDirective = mStateMachine.Update(dtMillis);
+    }
+    
     if (mLastPostStateMachineUpdateDirective == PostStateUpdateDirective::BLOCK_UPDATE)
     {
         OnBlockedUpdate();
         return PostStateUpdateDirective::BLOCK_UPDATE;
     }
     
+    mSnapshotPersisted = false;
+    
     // Physics update
-    mBox2dWorld.Step(physics_constants::WORLD_STEP * GameSingletons::GetGameSpeedMultiplier(), physics_constants::WORLD_VELOCITY_ITERATIONS, physics_constants::WORLD_POSITION_ITERATIONS);
+    {
+        SimulationProfiler::ScopedTimer physicsTimer(SimulationSubsystem::PHYSICS);
+        mBox2dWorld.Step(physics_constants::WORLD_STEP * mGameContext.GetGameSpeedMultiplier(), physics_constants::WORLD_VELOCITY_ITERATIONS, physics_constants::WORLD_POSITION_ITERATIONS);
+    }
+    
+    // Bullets get tested against the bodies where the step left them
+    {
+        SimulationProfiler::ScopedTimer projectilesTimer(SimulationSubsystem::PROJECTILES);
+        mScene.GetProjectileSystem().Step(physics_constants::WORLD_STEP * mGameContext.GetGameSpeedMultiplier(), mBox2dWorld);
+    }
+    
+    // Collision responses of the step just taken
+    {
+        SimulationProfiler::ScopedTimer collisionsTimer(SimulationSubsystem::COLLISIONS);
+        mScene.GetCollisionListener().DispatchCollisionEvents();
+        mScene.GetProjectileSystem().DispatchHits();
+    }
     
     auto joystickSO = mScene.GetSceneObject(game_constants::JOYSTICK_SCENE_OBJECT_NAME);
     auto joystickBoundsSO = mScene.GetSceneObject(game_constants::JOYSTICK_BOUNDS_SCENE_OBJECT_NAME);
@@ -421,79 +525,79 @@ PostStateUpdateDirective LevelUpdater::VUpdate(std::vector<SceneObject>& sceneOb
         joystickBoundsSO->get().mInvisible = true;
     }
     
-    for (auto& sceneObject: sceneObjects)
     {
-        // Check if this scene object has a respective family object definition
-        auto sceneObjectTypeDefOpt = ObjectTypeDefinitionRepository::GetInstance().GetObjectTypeDefinition(sceneObject.mObjectFamilyTypeName);
-        if (sceneObjectTypeDefOpt && !sceneObject.mCustomDrivenMovement)
+        SimulationProfiler::ScopedTimer sceneObjectsTimer(SimulationSubsystem::SCENE_OBJECTS);
+        
+        for (auto& sceneObject: sceneObjects)
         {
-            // Update movement
-            auto& sceneObjectTypeDef = sceneObjectTypeDefOpt->get();
-            
-            auto temporaryMovementPattern = sceneObjectTypeDef.mMovementControllerPattern;
-            if (temporaryMovementPattern == MovementControllerPattern::CHASING_PLAYER)
+            // Check if this scene object has a respective family object definition
+            auto sceneObjectTypeDefOpt = ObjectTypeDefinitionRepository::GetInstance().GetObjectTypeDefinition(sceneObject.mObjectFamilyTypeName);
+            if (sceneObjectTypeDefOpt && !sceneObject.mCustomDrivenMovement)
             {
-                temporaryMovementPattern = MovementControllerPattern::CONSTANT_VELOCITY;
-                if (sceneObject.mBody && sceneObject.mBody->GetWorldCenter().y <= game_constants::LEVEL_WAVE_VISIBLE_Y)
+                // Update movement
+                auto& sceneObjectTypeDef = sceneObjectTypeDefOpt->get();
+                
+                auto temporaryMovementPattern = sceneObjectTypeDef.mMovementControllerPattern;
+                if (temporaryMovementPattern == MovementControllerPattern::CHASING_PLAYER)
                 {
-                    sceneObject.mDormantMillis -= dtMillis;
-                    if (sceneObject.mDormantMillis <= 0.0f)
+                    temporaryMovementPattern = MovementControllerPattern::CONSTANT_VELOCITY;
+                    if (sceneObject.mBody && sceneObject.mBody->GetWorldCenter().y <= game_constants::LEVEL_WAVE_VISIBLE_Y)
                     {
-                        sceneObject.mDormantMillis = 0.0f;
-                        temporaryMovementPattern = MovementControllerPattern::CHASING_PLAYER;
+                        sceneObject.mDormantMillis -= dtMillis;
+                        if (sceneObject.mDormantMillis <= 0.0f)
+                        {
+                            sceneObject.mDormantMillis = 0.0f;
+                            temporaryMovementPattern = MovementControllerPattern::CHASING_PLAYER;
+                        }
                     }
                 }
+                
+                float difficultySpeedFactor = GetWaveEnemySpeedFactor();
+                
+                switch (temporaryMovementPattern)
+                {
+                    case MovementControllerPattern::CONSTANT_VELOCITY:
+                    {
+                        if (sceneObjectTypeDef.mContactFilter.categoryBits != physics_constants::ENEMY_CATEGORY_BIT)
+                        {
+                            difficultySpeedFactor = 1.0f;
+                        }
+                        sceneObject.mBody->SetLinearVelocity(b2Vec2(sceneObjectTypeDef.mConstantLinearVelocity.x * difficultySpeedFactor, sceneObjectTypeDef.mConstantLinearVelocity.y * difficultySpeedFactor));
+                    } break;
+                        
+                    case MovementControllerPattern::CHASING_PLAYER:
+                    {
+                        if (playerSO)
+                        {
+                            b2Vec2 toAttractionPoint = playerSO->get().mBody->GetWorldCenter() - sceneObject.mBody->GetWorldCenter();
+                        
+                            toAttractionPoint.Normalize();
+                            toAttractionPoint.x *= dtMillis * sceneObjectTypeDef.mSpeed * difficultySpeedFactor;
+                            toAttractionPoint.y *= dtMillis * sceneObjectTypeDef.mSpeed * difficultySpeedFactor;
+                            sceneObject.mBody->ApplyForceToCenter(toAttractionPoint, true);
+                        }
+                    } break;
+                        
+                    case MovementControllerPattern::INPUT_CONTROLLED:
+                    {
+                        UpdateInputControlledSceneObject(sceneObject, sceneObjectTypeDef, dtMillis);
+                    } break;
+                        
+                    default: break;
+                }
             }
             
-            float difficultySpeedFactor = 1.0f;
-            if (mCurrentWaveNumber < mLevel.mWaves.size())
+            if (sceneObject.mAnimation && !sceneObject.mAnimation->VIsPaused())
             {
-                difficultySpeedFactor += mLevel.mWaves[mCurrentWaveNumber].mDebugDifficultyValue/20.0f;
+                sceneObject.mAnimation->VUpdate(dtMillis, sceneObject);
             }
             
-            switch (temporaryMovementPattern)
+            for (auto& extraAnimation: sceneObject.mExtraCompoundingAnimations)
             {
-                case MovementControllerPattern::CONSTANT_VELOCITY:
-                {
-                    if (sceneObjectTypeDef.mContactFilter.categoryBits != physics_constants::ENEMY_CATEGORY_BIT)
-                    {
-                        difficultySpeedFactor = 1.0f;
-                    }
-                    sceneObject.mBody->SetLinearVelocity(b2Vec2(sceneObjectTypeDef.mConstantLinearVelocity.x * difficultySpeedFactor, sceneObjectTypeDef.mConstantLinearVelocity.y * difficultySpeedFactor));
-                } break;
-                    
-                case MovementControllerPattern::CHASING_PLAYER:
-                {
-                    if (playerSO)
-                    {
-                        b2Vec2 toAttractionPoint = playerSO->get().mBody->GetWorldCenter() - sceneObject.mBody->GetWorldCenter();
-                    
-                        toAttractionPoint.Normalize();
-                        toAttractionPoint.x *= dtMillis * sceneObjectTypeDef.mSpeed * difficultySpeedFactor;
-                        toAttractionPoint.y *= dtMillis * sceneObjectTypeDef.mSpeed * difficultySpeedFactor;
-                        sceneObject.mBody->ApplyForceToCenter(toAttractionPoint, true);
-                    }
-                } break;
-                    
-                case MovementControllerPattern::INPUT_CONTROLLED:
+                if (!extraAnimation->VIsPaused())
                 {
-                    UpdateInputControlledSceneObject(sceneObject, sceneObjectTypeDef, dtMillis);
-                } break;
-                    
-                default: break;
-            }
-        }
-        
-        if (sceneObject.mAnimation && !sceneObject.mAnimation->VIsPaused())
-        {
-            sceneObject.mAnimation->VUpdate(dtMillis, sceneObject);
-        }
-        
-        for (auto& extraAnimation: sceneObject.mExtraCompoundingAnimations)
-        {
-            if (!extraAnimation->VIsPaused())
-            {
-                extraAnimation->VUpdate(dtMillis, sceneObject);
+                    extraAnimation->VUpdate(dtMillis, sceneObject);
+                }
             }
         }
     }
@@ -503,15 +607,29 @@ PostStateUpdateDirective LevelUpdater::VUpdate(std::vector<SceneObject>& sceneOb
         const auto& bossName = mLevel.mWaves.at(mCurrentWaveNumber).mBossName;
         if (!bossName.isEmpty())
         {
+            SimulationProfiler::ScopedTimer bossAITimer(SimulationSubsystem::BOSS_AI);
             mBossAIController.UpdateBossAI(bossName, dtMillis);
         }
     }
     
-    mUpgradesLogicHandler.Update(dtMillis);
-    ApplyShakeToNearlyDeadEntities(sceneObjects);
-    UpdateBackground(dtMillis);
-    UpdateBossHealthBar(dtMillis);
-    UpdateFlows(dtMillis);
+    {
+        SimulationProfiler::ScopedTimer upgradesTimer(SimulationSubsystem::UPGRADES);
+        mUpgradesLogicHandler.Update(dtMillis);
+    }
+    
+    {
+        SimulationProfiler::ScopedTimer presentationTimer(SimulationSubsystem::PRESENTATION);
+        ApplyShakeToNearlyDeadEntities(sceneObjects);
+        UpdateBackground(dtMillis);
+        UpdateBossHealthBar(dtMillis);
+    }
+    
+    {
+        SimulationProfiler::ScopedTimer flowsTimer(SimulationSubsystem::FLOWS);
+        UpdateFlows(dtMillis);
+    }
+    
+    SimulationProfiler::ScopedTimer presentationTimer(SimulationSubsystem::PRESENTATION);
     UpdateCameras(dtMillis);
     UpdateLights(dtMillis);
     UpdateTextDamage(dtMillis);
@@ -549,9 +667,23 @@ void LevelUpdater::AdvanceWave()
 
 ///------------------------------------------------------------------------------------------------
 
-void LevelUpdater::AddFlow(RepeatableFlow&& flow)
+FlowHandle LevelUpdater::AddFlow(RepeatableFlow&& flow)
+{
+    return mFlowScheduler.AddFlow(std::move(flow));
+}
+
+///------------------------------------------------------------------------------------------------
+
+FlowHandle LevelUpdater::ResumeFlow(RepeatableFlow&& flow, const float ticksLeft)
+{
+    return mFlowScheduler.AddFlowExpiringAt(std::move(flow), mFlowScheduler.GetNowMillis() + ticksLeft);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void LevelUpdater::CancelFlow(const FlowHandle flowHandle)
 {
-    mFlows.emplace_back(std::move(flow));
+    mFlowScheduler.CancelFlow(flowHandle);
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -568,11 +700,7 @@ void LevelUpdater::RemoveWaveEnemy(const strutils::StringId& enemyName)
     mWaveEnemies.erase(enemyName);
     mScene.RemoveAllSceneObjectsWithName(enemyName);
     
-    auto enemyBulletFlow = GetFlow(strutils::StringId(enemyName.GetString() + game_constants::ENEMY_PROJECTILE_FLOW_POSTFIX));
-    if (enemyBulletFlow)
-    {
-        enemyBulletFlow->get().ForceFinish();
-    }
+    mFlowScheduler.CancelFlow(strutils::StringId(enemyName.GetString() + game_constants::ENEMY_PROJECTILE_FLOW_POSTFIX));
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -587,52 +715,7 @@ void LevelUpdater::DropCrystals(const glm::vec3& deathPosition, const float enem
     {
         if ((crystalYieldValue <= 1.0f && math::RandomFloat() <= crystalYieldValue) || crystalYieldValue > 1.0f)
         {
-            mFlows.emplace_back([this, deathPosition, droppedCrystalCounter]()
-            {
-                auto& resService = resources::ResourceLoadingService::GetInstance();
-                
-                SceneObject crystalSo;
-                
-                glm::vec3 firstControlPoint(deathPosition + glm::vec3(math::RandomFloat(-DROPPED_CRYSTAL_FIRST_CONTROL_POINT_NOISE_MAG, DROPPED_CRYSTAL_FIRST_CONTROL_POINT_NOISE_MAG), math::RandomFloat(-DROPPED_CRYSTAL_FIRST_CONTROL_POINT_NOISE_MAG, DROPPED_CRYSTAL_FIRST_CONTROL_POINT_NOISE_MAG), 0.0f));
-                glm::vec3 thirdControlPoint(game_constants::GUI_CRYSTAL_POSITION);
-                glm::vec3 secondControlPoint((thirdControlPoint + firstControlPoint) * 0.5f + glm::vec3(math::RandomFloat(-DROPPED_CRYSTAL_SECOND_CONTROL_POINT_NOISE_MAG, DROPPED_CRYSTAL_SECOND_CONTROL_POINT_NOISE_MAG), math::RandomFloat(-DROPPED_CRYSTAL_SECOND_CONTROL_POINT_NOISE_MAG, DROPPED_CRYSTAL_SECOND_CONTROL_POINT_NOISE_MAG), 0.0f));
-                
-                firstControlPoint.z = game_constants::GUI_CRYSTAL_POSITION.z;
-                secondControlPoint.z = game_constants::GUI_CRYSTAL_POSITION.z;
-                thirdControlPoint.z = game_constants::GUI_CRYSTAL_POSITION.z;
-                
-                float speedNoise = math::RandomFloat(-DROPPED_CRYSTAL_SPEED/5, DROPPED_CRYSTAL_SPEED/5);
-                float speedMultiplier = DROPPED_CRYSTAL_DISTANCE_FACTOR/glm::distance(firstControlPoint, game_constants::GUI_CRYSTAL_POSITION);
-                
-                const strutils::StringId droppedCrystalName = strutils::StringId(DROPPED_CRYSTAL_NAME_PREFIX + std::to_string(SDL_GetPerformanceCounter()));
-                
-                crystalSo.mAnimation = std::make_unique<BezierCurvePathAnimation>(resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + game_constants::CRYSTALS_TEXTURE_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_MESHES_ROOT + game_constants::SMALL_CRYSTAL_MESH_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_SHADERS_ROOT + game_constants::BASIC_SHADER_FILE_NAME), glm::vec3(1.0f), math::BezierCurve({firstControlPoint, secondControlPoint, thirdControlPoint}), (DROPPED_CRYSTAL_SPEED + speedNoise) * speedMultiplier, false);
-                
-                crystalSo.mAnimation->SetCompletionCallback([droppedCrystalName, this]()
-                {
-                    auto crystalHolderSoOpt = mScene.GetSceneObject(game_constants::GUI_CRYSTAL_ICON_SCENE_OBJECT_NAME);
-                    if (crystalHolderSoOpt)
-                    {
-                        auto& crystalHolderSo = crystalHolderSoOpt->get();
-                        crystalHolderSo.mScale = game_constants::GUI_CRYSTAL_SCALE;
-                        
-                        crystalHolderSo.mExtraCompoundingAnimations.clear();
-                        crystalHolderSo.mExtraCompoundingAnimations.push_back(std::make_unique<PulsingAnimation>(crystalHolderSo.mAnimation->VGetCurrentTextureResourceId(), crystalHolderSo.mAnimation->VGetCurrentMeshResourceId(), crystalHolderSo.mAnimation->VGetCurrentShaderResourceId(), game_constants::GUI_CRYSTAL_SCALE, PulsingAnimation::PulsingMode::OUTER_PULSE_ONCE, 0.0f, COLLECTED_CRYSTAL_PULSING_SPEED, COLLECTED_CRYSTAL_PULSING_FACTOR, false));
-                    }
-                    
-                    objectiveC_utils::PlaySound(sounds::CRYSTALS_SFX);
-                    mScene.RemoveAllSceneObjectsWithName(droppedCrystalName);
-                    GameSingletons::SetCrystalCount(GameSingletons::GetCrystalCount() + 1);
-                });
-                
-                crystalSo.mExtraCompoundingAnimations.push_back(std::make_unique<RotationAnimation>(resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + game_constants::CRYSTALS_TEXTURE_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_MESHES_ROOT + game_constants::SMALL_CRYSTAL_MESH_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_SHADERS_ROOT + game_constants::BASIC_SHADER_FILE_NAME), glm::vec3(1.0f), RotationAnimation::RotationMode::ROTATE_CONTINUALLY, RotationAnimation::RotationAxis::Y, 0.0f, game_constants::GUI_CRYSTAL_ROTATION_SPEED, false));
-                
-                crystalSo.mSceneObjectType = SceneObjectType::GUIObject;
-                crystalSo.mPosition = firstControlPoint;
-                crystalSo.mScale = game_constants::GUI_CRYSTAL_SCALE;
-                crystalSo.mName = droppedCrystalName;
-                mScene.AddSceneObject(std::move(crystalSo));
-            }, droppedCrystalCounter * game_constants::DROPPED_CRYSTALS_CREATION_STAGGER_MILLIS + enemyDeathAnimationMillis, RepeatableFlow::RepeatPolicy::ONCE);
+            mFlowScheduler.AddFlow(CreateDroppedCrystalFlow(deathPosition, droppedCrystalCounter * game_constants::DROPPED_CRYSTALS_CREATION_STAGGER_MILLIS + enemyDeathAnimationMillis));
             
             droppedCrystalCounter++;
         }
@@ -670,18 +753,22 @@ size_t LevelUpdater::GetWaveEnemyCount() const
 
 ///------------------------------------------------------------------------------------------------
 
-std::optional<std::reference_wrapper<RepeatableFlow>> LevelUpdater::GetFlow(const strutils::StringId& flowName)
+float LevelUpdater::GetWaveEnemySpeedFactor() const
 {
-    auto findIter = std::find_if(mFlows.begin(), mFlows.end(), [&](const RepeatableFlow& flow)
-    {
-        return flow.GetName() == flowName;
-    });
-    
-    if (findIter != mFlows.end())
+    float difficultySpeedFactor = 1.0f;
+    if (mCurrentWaveNumber < mLevel.mWaves.size())
     {
-        return std::optional<std::reference_wrapper<RepeatableFlow>>{*findIter};
+        difficultySpeedFactor += mLevel.mWaves[mCurrentWaveNumber].mDebugDifficultyValue/20.0f;
     }
-    return std::nullopt;
+    
+    return difficultySpeedFactor;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::optional<std::reference_wrapper<RepeatableFlow>> LevelUpdater::GetFlow(const strutils::StringId& flowName)
+{
+    return mFlowScheduler.GetFlow(flowName);
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -707,7 +794,9 @@ void LevelUpdater::VOpenDebugConsole()
 
 void LevelUpdater::VOpenSettingsMenu()
 {
-    mStateMachine.PushState(SettingsMenuGameState::STATE_NAME);
+    // Deferred to the start of the next update, as the level can't be captured once behind the menu,
+    // nor midway through an update (see UpdateLevel)
+    mSettingsMenuRequested = true;
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -860,28 +949,432 @@ void LevelUpdater::CreateLevelWalls(const Camera& cam, const bool invisible)
 
 ///------------------------------------------------------------------------------------------------
 
-void LevelUpdater::LoadLevelInvariantObjects()
+RepeatableFlow LevelUpdater::CreateEnemyProjectileFlow(const strutils::StringId& enemyName, const strutils::StringId& enemyTypeName)
 {
-    mScene.GetLightRepository().AddLight(LightType::AMBIENT_LIGHT, game_constants::AMBIENT_LIGHT_NAME, game_constants::AMBIENT_LIGHT_COLOR, glm::vec3(0.0f), 0.0f);
+    auto projectileFlowName = strutils::StringId(enemyName.GetString() + game_constants::ENEMY_PROJECTILE_FLOW_POSTFIX);
+    const auto& enemyDef = ObjectTypeDefinitionRepository::GetInstance().GetObjectTypeDefinition(enemyTypeName)->get();
+    const auto projectileType = enemyDef.mProjectileType;
     
-    auto& resService = resources::ResourceLoadingService::GetInstance();
+    RepeatableFlow projectileFlow([this, enemyName, projectileType]()
+    {
+        auto bulletDefOpt = ObjectTypeDefinitionRepository::GetInstance().GetObjectTypeDefinition(projectileType);
+        auto sourceEnemySoOpt = mScene.GetSceneObject(enemyName);
+        
+        if (bulletDefOpt && sourceEnemySoOpt)
+        {
+            auto& bulletDef = bulletDefOpt->get();
+            auto& sourceEnemySo = sourceEnemySoOpt->get();
+            
+            auto bulletPosition = math::Box2dVec2ToGlmVec3(sourceEnemySo.mBody->GetWorldCenter());
+            bulletPosition.z = game_constants::BULLET_Z;
+            SceneObject bulletSceneObject = scene_object_utils::CreateSceneObjectWithProjectile(bulletDef, bulletPosition, mScene.GetProjectileSystem());
+            
+            AddWaveEnemy(bulletSceneObject.mName);
+            mScene.AddSceneObject(std::move(bulletSceneObject));
+        }
+        else
+        {
+            Log(LogType::INFO, "Flow %s%s is dead", enemyName.GetString().c_str(), game_constants::ENEMY_PROJECTILE_FLOW_POSTFIX.c_str());
+        }
+    }, enemyDef.mShootingFrequencyMillis, RepeatableFlow::RepeatPolicy::REPEAT, projectileFlowName);
     
-    // Background
+    projectileFlow.SetRestoreTag({ ENEMY_PROJECTILE_FLOW_KIND, enemyName, glm::vec3(0.0f) });
+    return projectileFlow;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool LevelUpdater::CaptureSnapshot(std::vector<unsigned char>& outSnapshot) const
+{
+    // Scene objects pending addition/removal, or a scene transition, would be lost
+    if (mScene.HasPendingChanges())
     {
-        SceneObject bgSO;
-        bgSO.mScale = game_constants::BACKGROUND_SCALE;
-        bgSO.mPosition.z = game_constants::BACKGROUND_Z;
-        bgSO.mAnimation = std::make_unique<SingleFrameAnimation>(resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + game_constants::BACKGROUND_TEXTURE_FILE_PATH + std::to_string(GameSingletons::GetBackgroundIndex()) + ".bmp"), resService.LoadResource(resources::ResourceLoadingService::RES_MESHES_ROOT + game_constants::QUAD_MESH_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_SHADERS_ROOT + game_constants::TEXTURE_OFFSET_SHADER_FILE_NAME), glm::vec3(1.0f), false);
-        bgSO.mSceneObjectType = SceneObjectType::GUIObject;
-        bgSO.mName = game_constants::BACKGROUND_SCENE_OBJECT_NAME;
-        bgSO.mShaderBoolUniformValues[game_constants::IS_AFFECTED_BY_LIGHT_UNIFORM_NAME] = true;
-        mScene.AddSceneObject(std::move(bgSO));
+        Log(LogType::WARNING, "Can't capture level snapshot midway through scene changes");
+        return false;
     }
     
-    // Player
+    SnapshotWriter writer;
+    
+    WriteGameContext(mGameContext, writer);
+    
+    for (const auto sceneObjectType: SNAPSHOT_CAMERA_TYPES)
     {
-        auto& typeDefRepo = ObjectTypeDefinitionRepository::GetInstance();
-        typeDefRepo.LoadObjectTypeDefinition(game_constants::PLAYER_OBJECT_TYPE_DEF_NAME);
+        const auto cameraOpt = mGameContext.GetCameraForSceneObjectType(sceneObjectType);
+        writer.Write(cameraOpt.has_value());
+        if (cameraOpt)
+        {
+            writer.Write(cameraOpt->get());
+        }
+    }
+    
+    const auto& sceneObjects = mScene.GetSceneObjects();
+    writer.Write(static_cast<uint32_t>(std::count_if(sceneObjects.cbegin(), sceneObjects.cend(), [](const SceneObject& so){ return !so.mCrossSceneLifetime; })));
+    for (const auto& sceneObject: sceneObjects)
+    {
+        if (!sceneObject.mCrossSceneLifetime && !level_snapshot::WriteSceneObject(writer, sceneObject))
+        {
+            Log(LogType::WARNING, "Can't capture level snapshot with scene object %s", sceneObject.mName.GetString().c_str());
+            return false;
+        }
+    }
+    
+    mScene.GetProjectileSystem().WriteSnapshot(writer);
+    
+    const auto& lightRepository = mScene.GetLightRepository();
+    writer.Write(static_cast<uint32_t>(mActiveLightNames.size()));
+    for (const auto& lightName: mActiveLightNames)
+    {
+        const auto lightIndex = lightRepository.GetLightIndex(lightName);
+        writer.WriteStringId(lightName);
+        writer.Write(lightRepository.GetLightPosition(lightIndex));
+        writer.Write(lightRepository.GetLightColor(lightIndex));
+        writer.Write(lightRepository.GetLightPower(lightIndex));
+    }
+    
+    writer.Write(static_cast<uint64_t>(mCurrentWaveNumber));
+    writer.Write(mBossAnimatedHealthBarPerc);
+    writer.Write(mPreviousMotionVec);
+    writer.Write(mMovementRotationAllowed);
+    writer.Write(mBossPositioned);
+    writer.Write(mBackgroundOffset);
+    
+    writer.Write(static_cast<uint32_t>(mWaveEnemies.size()));
+    for (const auto& waveEnemyName: mWaveEnemies)
+    {
+        writer.WriteStringId(waveEnemyName);
+    }
+    
+    writer.Write(static_cast<uint32_t>(mDamagedSceneObjectNameToTextSceneObject.size()));
+    for (const auto& damagedSceneObjectToTextEntry: mDamagedSceneObjectNameToTextSceneObject)
+    {
+        const auto freezeTimerIter = mDamagedSceneObjectNameToTextSceneObjectFreezeTimer.find(damagedSceneObjectToTextEntry.first);
+        writer.WriteStringId(damagedSceneObjectToTextEntry.first);
+        writer.WriteStringId(damagedSceneObjectToTextEntry.second);
+        writer.Write(freezeTimerIter != mDamagedSceneObjectNameToTextSceneObjectFreezeTimer.cend() ? freezeTimerIter->second : 0.0f);
+    }
+    
+    // Only flows carrying a restore tag are captured here, with the game states and boss AI capturing their own flows
+    std::vector<std::pair<const RepeatableFlow*, double>> taggedFlows;
+    mFlowScheduler.ForEachRunningFlow([&](const RepeatableFlow& flow, const double expiryMillis)
+    {
+        if (flow.GetRestoreTag())
+        {
+            taggedFlows.emplace_back(&flow, expiryMillis);
+        }
+    });
+    
+    writer.Write(mFlowScheduler.GetNowMillis());
+    writer.Write(static_cast<uint32_t>(taggedFlows.size()));
+    for (const auto& taggedFlow: taggedFlows)
+    {
+        const auto& restoreTag = *taggedFlow.first->GetRestoreTag();
+        writer.WriteStringId(restoreTag.mKind);
+        writer.WriteStringId(restoreTag.mSubjectName);
+        writer.Write(restoreTag.mPosition);
+        writer.Write(taggedFlow.first->GetDuration());
+        writer.Write(taggedFlow.first->GetRepeatPolicy());
+        writer.Write(taggedFlow.second);
+    }
+    
+    if (!mStateMachine.WriteSnapshot(writer))
+    {
+        return false;
+    }
+    
+    mBossAIController.WriteSnapshot(writer);
+    level_snapshot::WriteRandomEngine(writer);
+    
+    // The resources referenced are listed up front, so that they can all be loaded before anything gets restored
+    SnapshotWriter snapshotWriter;
+    snapshotWriter.Write(LEVEL_SNAPSHOT_VERSION);
+    snapshotWriter.Write(ComputeLevelFingerprint(mLevel));
+    level_snapshot::WriteResourceTable(snapshotWriter, writer.GetResourceIds());
+    snapshotWriter.WriteBytes(writer.GetData());
+    
+    outSnapshot = snapshotWriter.GetData();
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool LevelUpdater::RestoreSnapshot(const std::vector<unsigned char>& snapshot)
+{
+    const auto restoreStartCounter = SDL_GetPerformanceCounter();
+    
+    SnapshotReader snapshotReader(snapshot.data(), snapshot.size());
+    const auto version = snapshotReader.Read<uint16_t>();
+    const auto levelFingerprint = snapshotReader.Read<uint64_t>();
+    
+    if (!snapshotReader.IsValid() || version != LEVEL_SNAPSHOT_VERSION || levelFingerprint != ComputeLevelFingerprint(mLevel))
+    {
+        Log(LogType::WARNING, "Level snapshot was not taken from level %s", mLevel.mLevelName.GetString().c_str());
+        return false;
+    }
+    
+    const auto resourcesLoaded = level_snapshot::ReadResourceTable(snapshotReader);
+    const auto levelState = snapshotReader.ReadBytes();
+    
+    if (!resourcesLoaded || !snapshotReader.IsValid() || !snapshotReader.IsAtEnd())
+    {
+        Log(LogType::ERROR, "Corrupt level snapshot for level %s", mLevel.mLevelName.GetString().c_str());
+        return false;
+    }
+    
+    // Everything up to the game states gets staged first, so that the level is left untouched if any of it fails validation
+    SnapshotReader reader(levelState.data(), levelState.size());
+    
+    const auto bossMaxHealth = reader.Read<float>();
+    const auto bossCurrentHealth = reader.Read<float>();
+    const auto playerShieldHealth = reader.Read<float>();
+    const auto playerMaxHealth = reader.Read<float>();
+    const auto playerCurrentHealth = reader.Read<float>();
+    const auto playerDisplayedHealth = reader.Read<float>();
+    const auto crystalCount = reader.Read<int64_t>();
+    const auto displayedCrystalCount = reader.Read<float>();
+    
+    std::vector<UpgradeDefinition> equippedUpgrades;
+    const auto equippedUpgradeCount = reader.ReadCount();
+    for (uint32_t i = 0; i < equippedUpgradeCount && reader.IsValid(); ++i)
+    {
+        const auto upgradeNameId = reader.ReadRawStringId();
+        auto upgradeIter = std::find_if(mLevelStartEquippedUpgrades.cbegin(), mLevelStartEquippedUpgrades.cend(), [&](const UpgradeDefinition& upgradeDefinition){ return upgradeDefinition.mUpgradeNameId == upgradeNameId; });
+        if (upgradeIter == mLevelStartEquippedUpgrades.cend())
+        {
+            reader.Invalidate();
+            break;
+        }
+        
+        equippedUpgrades.push_back(*upgradeIter);
+    }
+    
+    std::vector<std::pair<SceneObjectType, Camera>> cameras;
+    for (const auto sceneObjectType: SNAPSHOT_CAMERA_TYPES)
+    {
+        if (reader.Read<bool>())
+        {
+            cameras.emplace_back(sceneObjectType, reader.Read<Camera>());
+        }
+    }
+    
+    // Scene objects get pushed even if they fail to read, so that any body they got to create gets destroyed
+    std::vector<SceneObject> sceneObjects;
+    const auto sceneObjectCount = reader.ReadCount();
+    for (uint32_t i = 0; i < sceneObjectCount && reader.IsValid(); ++i)
+    {
+        SceneObject sceneObject;
+        level_snapshot::ReadSceneObject(reader, mBox2dWorld, sceneObject);
+        sceneObjects.push_back(std::move(sceneObject));
+    }
+    
+    std::vector<ProjectileSystem::ProjectileState> projectiles;
+    uint32_t nextProjectileId = 0;
+    ProjectileSystem::ReadSnapshot(reader, projectiles, nextProjectileId);
+    
+    std::vector<SnapshotLight> lights;
+    const auto lightCount = reader.ReadCount();
+    for (uint32_t i = 0; i < lightCount && reader.IsValid(); ++i)
+    {
+        SnapshotLight light;
+        light.mName = reader.ReadStringId();
+        light.mPosition = reader.Read<glm::vec3>();
+        light.mColor = reader.Read<glm::vec4>();
+        light.mPower = reader.Read<float>();
+        lights.push_back(light);
+    }
+    
+    const auto currentWaveNumber = reader.Read<uint64_t>();
+    const auto bossAnimatedHealthBarPerc = reader.Read<float>();
+    const auto previousMotionVec = reader.Read<glm::vec3>();
+    const auto movementRotationAllowed = reader.Read<bool>();
+    const auto bossPositioned = reader.Read<bool>();
+    const auto backgroundOffset = reader.Read<float>();
+    
+    std::unordered_set<strutils::StringId, strutils::StringIdHasher> waveEnemies;
+    const auto waveEnemyCount = reader.ReadCount();
+    for (uint32_t i = 0; i < waveEnemyCount && reader.IsValid(); ++i)
+    {
+        waveEnemies.insert(reader.ReadStringId());
+    }
+    
+    std::unordered_map<strutils::StringId, strutils::StringId, strutils::StringIdHasher> damagedSceneObjectNameToTextSceneObject;
+    std::unordered_map<strutils::StringId, float, strutils::StringIdHasher> damagedSceneObjectNameToTextSceneObjectFreezeTimer;
+    const auto damageTextCount = reader.ReadCount();
+    for (uint32_t i = 0; i < damageTextCount && reader.IsValid(); ++i)
+    {
+        const auto damagedSceneObjectName = reader.ReadStringId();
+        damagedSceneObjectNameToTextSceneObject[damagedSceneObjectName] = reader.ReadStringId();
+        damagedSceneObjectNameToTextSceneObjectFreezeTimer[damagedSceneObjectName] = reader.Read<float>();
+    }
+    
+    const auto flowSchedulerNowMillis = reader.Read<double>();
+    std::vector<SnapshotFlow> flows;
+    const auto flowCount = reader.ReadCount();
+    for (uint32_t i = 0; i < flowCount && reader.IsValid(); ++i)
+    {
+        SnapshotFlow flow;
+        flow.mRestoreTag.mKind = reader.ReadRawStringId();
+        flow.mRestoreTag.mSubjectName = reader.ReadStringId();
+        flow.mRestoreTag.mPosition = reader.Read<glm::vec3>();
+        flow.mDurationMillis = reader.Read<float>();
+        flow.mRepeatPolicy = reader.Read<RepeatableFlow::RepeatPolicy>();
+        flow.mExpiryMillis = reader.Read<double>();
+        
+        if (flow.mRepeatPolicy != RepeatableFlow::RepeatPolicy::ONCE && flow.mRepeatPolicy != RepeatableFlow::RepeatPolicy::REPEAT)
+        {
+            reader.Invalidate();
+        }
+        
+        flows.push_back(flow);
+    }
+    
+    if (!reader.IsValid() || currentWaveNumber > mLevel.mWaves.size())
+    {
+        Log(LogType::ERROR, "Corrupt level snapshot for level %s", mLevel.mLevelName.GetString().c_str());
+        DestroySceneObjectBodies(sceneObjects, mBox2dWorld);
+        return false;
+    }
+    
+    // From here on the level's state gets replaced. States are torn down first, as some of them
+    // remove their scene objects on the way out
+    mStateMachine.Reset();
+    mFlowScheduler.Reset(flowSchedulerNowMillis);
+    
+    for (auto& sceneObject: sceneObjects)
+    {
+        OnSceneObjectRestored(sceneObject);
+    }
+    
+    const auto restoredSceneObjectCount = sceneObjects.size();
+    mScene.ReplaceSceneObjects(std::move(sceneObjects));
+    mScene.GetProjectileSystem().RestoreProjectiles(projectiles, nextProjectileId);
+    
+    mGameContext.SetBossMaxHealth(bossMaxHealth);
+    mGameContext.SetBossCurrentHealth(bossCurrentHealth);
+    mGameContext.SetPlayerShieldHealth(playerShieldHealth);
+    mGameContext.SetPlayerMaxHealth(playerMaxHealth);
+    mGameContext.SetPlayerCurrentHealth(playerCurrentHealth);
+    mGameContext.SetPlayerDisplayedHealth(playerDisplayedHealth);
+    mGameContext.SetCrystalCount(static_cast<long>(crystalCount));
+    mGameContext.SetDisplayedCrystalCount(displayedCrystalCount);
+    mGameContext.SetEquippedUpgrades(equippedUpgrades);
+    
+    for (auto& camera: cameras)
+    {
+        mGameContext.SetCameraForSceneObjectType(camera.first, std::move(camera.second));
+    }
+    
+    auto& lightRepository = mScene.GetLightRepository();
+    for (const auto& lightName: mActiveLightNames)
+    {
+        lightRepository.RemoveLight(lightName);
+    }
+    
+    mActiveLightNames.clear();
+    for (const auto& light: lights)
+    {
+        lightRepository.AddLight(LightType::POINT_LIGHT, light.mName, light.mColor, light.mPosition, light.mPower);
+        mActiveLightNames.insert(light.mName);
+    }
+    
+    mCurrentWaveNumber = static_cast<size_t>(currentWaveNumber);
+    mBossAnimatedHealthBarPerc = bossAnimatedHealthBarPerc;
+    mPreviousMotionVec = previousMotionVec;
+    mMovementRotationAllowed = movementRotationAllowed;
+    mBossPositioned = bossPositioned;
+    mBackgroundOffset = backgroundOffset;
+    mWaveEnemies = std::move(waveEnemies);
+    mDamagedSceneObjectNameToTextSceneObject = std::move(damagedSceneObjectNameToTextSceneObject);
+    mDamagedSceneObjectNameToTextSceneObjectFreezeTimer = std::move(damagedSceneObjectNameToTextSceneObjectFreezeTimer);
+    mLastPostStateMachineUpdateDirective = PostStateUpdateDirective::CONTINUE;
+    
+    // The joystick only reappears once a finger is put down again
+    mAllowInputControl = false;
+    
+    for (const auto& flow: flows)
+    {
+        auto recreatedFlowOpt = RecreateFlow(flow.mRestoreTag, flow.mDurationMillis);
+        if (!recreatedFlowOpt || recreatedFlowOpt->GetRepeatPolicy() != flow.mRepeatPolicy)
+        {
+            Log(LogType::WARNING, "Dropping %s flow of level snapshot", flow.mRestoreTag.mKind.GetString().c_str());
+            continue;
+        }
+        
+        recreatedFlowOpt->SetDuration(flow.mDurationMillis);
+        mFlowScheduler.AddFlowExpiringAt(std::move(*recreatedFlowOpt), flow.mExpiryMillis);
+    }
+    
+    const auto stateMachineRestored = mStateMachine.ReadSnapshot(reader);
+    const auto bossAIRestored = stateMachineRestored && mBossAIController.ReadSnapshot(reader);
+    const auto randomEngineRestored = bossAIRestored && level_snapshot::ReadRandomEngine(reader);
+    
+    if (!randomEngineRestored || !reader.IsAtEnd())
+    {
+        Log(LogType::ERROR, "Corrupt level snapshot for level %s, reloading level", mLevel.mLevelName.GetString().c_str());
+        mScene.ChangeScene(Scene::TransitionParameters(Scene::SceneType::LEVEL, mLevel.mLevelName.GetString(), true));
+        return false;
+    }
+    
+    const auto restoreMillis = (SDL_GetPerformanceCounter() - restoreStartCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+    Log(LogType::INFO, "Restored level snapshot (%d bytes, %d scene objects) in %.3f millis", static_cast<int>(snapshot.size()), static_cast<int>(restoredSceneObjectCount), restoreMillis);
+    
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+uint64_t LevelUpdater::ComputeSimulationDigest() const
+{
+    size_t runningFlowCount = 0;
+    mFlowScheduler.ForEachRunningFlow([&](const RepeatableFlow&, const double){ runningFlowCount++; });
+    
+    SnapshotWriter digestWriter;
+    digestWriter.Write(level_snapshot::DigestSceneObjects(mScene.GetSceneObjects()));
+    mScene.GetProjectileSystem().WriteSnapshot(digestWriter);
+    WriteGameContext(mGameContext, digestWriter);
+    digestWriter.Write(static_cast<uint64_t>(mCurrentWaveNumber));
+    digestWriter.Write(static_cast<uint64_t>(mWaveEnemies.size()));
+    digestWriter.Write(static_cast<uint64_t>(runningFlowCount));
+    digestWriter.WriteStringId(mStateMachine.GetActiveStateName());
+    level_snapshot::WriteRandomEngine(digestWriter);
+    
+    const auto& digestData = digestWriter.GetData();
+    return level_snapshot::HashBytes(digestData.data(), digestData.size());
+}
+
+///------------------------------------------------------------------------------------------------
+
+#ifdef DEBUG
+void LevelUpdater::BeginSnapshotRoundTrip(const int frameCount)
+{
+    mSnapshotRoundTrip = SnapshotRoundTrip();
+    mSnapshotRoundTrip->mFrameCount = frameCount;
+}
+#endif
+
+///------------------------------------------------------------------------------------------------
+
+void LevelUpdater::LoadLevelInvariantObjects()
+{
+    mScene.GetLightRepository().AddLight(LightType::AMBIENT_LIGHT, game_constants::AMBIENT_LIGHT_NAME, game_constants::AMBIENT_LIGHT_COLOR, glm::vec3(0.0f), 0.0f);
+    
+    auto& resService = resources::ResourceLoadingService::GetInstance();
+    
+    // Background
+    {
+        SceneObject bgSO;
+        bgSO.mScale = game_constants::BACKGROUND_SCALE;
+        bgSO.mPosition.z = game_constants::BACKGROUND_Z;
+        bgSO.mAnimation = std::make_unique<SingleFrameAnimation>(resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + game_constants::BACKGROUND_TEXTURE_FILE_PATH + std::to_string(mGameContext.GetBackgroundIndex()) + ".bmp"), resService.LoadResource(resources::ResourceLoadingService::RES_MESHES_ROOT + game_constants::QUAD_MESH_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_SHADERS_ROOT + game_constants::TEXTURE_OFFSET_SHADER_FILE_NAME), glm::vec3(1.0f), false);
+        bgSO.mSceneObjectType = SceneObjectType::GUIObject;
+        bgSO.mName = game_constants::BACKGROUND_SCENE_OBJECT_NAME;
+        bgSO.mShaderBoolUniformValues[game_constants::IS_AFFECTED_BY_LIGHT_UNIFORM_NAME] = true;
+        mScene.AddSceneObject(std::move(bgSO));
+    }
+    
+    // Player
+    {
+        auto& typeDefRepo = ObjectTypeDefinitionRepository::GetInstance();
+        typeDefRepo.LoadObjectTypeDefinition(game_constants::PLAYER_OBJECT_TYPE_DEF_NAME);
         typeDefRepo.LoadObjectTypeDefinition(game_constants::PLAYER_BULLET_TYPE);
         typeDefRepo.LoadObjectTypeDefinition(game_constants::MIRROR_IMAGE_BULLET_TYPE);
         
@@ -891,13 +1384,13 @@ void LevelUpdater::LoadLevelInvariantObjects()
         
         mScene.AddSceneObject(std::move(playerSO));
         
-        for (const auto& upgradeEntry: GameSingletons::GetEquippedUpgrades())
+        for (const auto& upgradeEntry: mGameContext.GetEquippedUpgrades())
         {
             mUpgradesLogicHandler.InitializeEquippedUpgrade(upgradeEntry.mUpgradeNameId);
         }
     }
     
-    const auto& worldCamOpt = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::WorldGameObject);
+    const auto& worldCamOpt = mGameContext.GetCameraForSceneObjectType(SceneObjectType::WorldGameObject);
     assert(worldCamOpt);
     const auto& worldCam = worldCamOpt->get();
     
@@ -930,17 +1423,17 @@ void LevelUpdater::LoadLevelInvariantObjects()
 
 void LevelUpdater::UpdateInputControlledSceneObject(SceneObject& sceneObject, const ObjectTypeDefinition& sceneObjectTypeDef, const float dtMillis)
 {
-    const auto& camOpt = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::GUIObject);
+    const auto& camOpt = mGameContext.GetCameraForSceneObjectType(SceneObjectType::GUIObject);
     assert(camOpt);
     const auto& guiCamera = camOpt->get();
     
     auto joystickSO = mScene.GetSceneObject(game_constants::JOYSTICK_SCENE_OBJECT_NAME);
     auto joystickBoundsSO = mScene.GetSceneObject(game_constants::JOYSTICK_BOUNDS_SCENE_OBJECT_NAME);
-    const auto& inputContext = GameSingletons::GetInputContext();
+    const auto& inputContext = mGameContext.GetInputContext();
     
-    if (GameSingletons::GetPlayerCurrentHealth() <= 0.0f)
+    if (mGameContext.GetPlayerCurrentHealth() <= 0.0f)
     {
-        if (joystickSO && joystickBoundsSO && (mAllowInputControl || GameSingletons::GetAccelerometerControl()))
+        if (joystickSO && joystickBoundsSO && (mAllowInputControl || mGameContext.GetAccelerometerControl()))
         {
             joystickSO->get().mInvisible = true;
             joystickBoundsSO->get().mInvisible = true;
@@ -950,24 +1443,24 @@ void LevelUpdater::UpdateInputControlledSceneObject(SceneObject& sceneObject, co
         return;
     }
     
-    if (GameSingletons::GetAccelerometerControl())
+    if (mGameContext.GetAccelerometerControl())
     {
         // Most likely not set for whatever reason
         if (glm::length(mAccelerometerCalibrationValues) < ACCELEROMETER_CALIBRATION_RESET_THRESHOLD)
         {
-            mAccelerometerCalibrationValues = -GameSingletons::GetInputContext().mRawAccelerometerValues;
+            mAccelerometerCalibrationValues = -mGameContext.GetInputContext().mRawAccelerometerValues;
         }
         
         // Adjust accelerometer values based on current calibration values (they get reset every time the level updater gets created)
-        const auto& accelerometerValues = GameSingletons::GetInputContext().mRawAccelerometerValues + mAccelerometerCalibrationValues;
+        const auto& accelerometerValues = mGameContext.GetInputContext().mRawAccelerometerValues + mAccelerometerCalibrationValues;
 
         auto normalizedXAxisValue = math::Min(ACCELEROMETER_X_SENSITIVITY_FACTOR, math::Max(-ACCELEROMETER_X_SENSITIVITY_FACTOR, accelerometerValues.x))/ACCELEROMETER_X_SENSITIVITY_FACTOR;
         auto normalizedYAxisValue = math::Min(ACCELEROMETER_Y_SENSITIVITY_FACTOR, math::Max(-ACCELEROMETER_Y_SENSITIVITY_FACTOR, accelerometerValues.y))/ACCELEROMETER_Y_SENSITIVITY_FACTOR;
         if (normalizedYAxisValue < 0.0f) normalizedYAxisValue = math::Max(-1.0f, normalizedYAxisValue * ACCELEROMETER_Y_COMPENSATION_FACTOR);
 
         glm::vec3 motionVec;
-        motionVec.x = normalizedXAxisValue * game_constants::BASE_PLAYER_SPEED * GameSingletons::GetPlayerMovementSpeedStat() * dtMillis;
-        motionVec.y = normalizedYAxisValue * game_constants::BASE_PLAYER_SPEED * GameSingletons::GetPlayerMovementSpeedStat() * dtMillis;
+        motionVec.x = normalizedXAxisValue * game_constants::BASE_PLAYER_SPEED * mGameContext.GetPlayerMovementSpeedStat() * dtMillis;
+        motionVec.y = normalizedYAxisValue * game_constants::BASE_PLAYER_SPEED * mGameContext.GetPlayerMovementSpeedStat() * dtMillis;
 
         if (math::Abs(mPreviousMotionVec.x - motionVec.x) > ACCELEROMETER_ROLL_DIFF_THRESHOLD)
         {
@@ -1000,7 +1493,7 @@ void LevelUpdater::UpdateInputControlledSceneObject(SceneObject& sceneObject, co
             {
                  if (joystickBoundsSO && joystickSO)
                  {
-                     joystickBoundsSO->get().mPosition = math::ComputeTouchCoordsInWorldSpace(GameSingletons::GetWindowDimensions(), inputContext.mTouchPos, guiCamera.GetViewMatrix(), guiCamera.GetProjMatrix());
+                     joystickBoundsSO->get().mPosition = math::ComputeTouchCoordsInWorldSpace(mGameContext.GetWindowDimensions(), inputContext.mTouchPos, guiCamera.GetViewMatrix(), guiCamera.GetProjMatrix());
                      joystickBoundsSO->get().mPosition.z = JOYSTICK_Z;
                      
                      joystickSO->get().mPosition = joystickBoundsSO->get().mPosition;
@@ -1022,7 +1515,7 @@ void LevelUpdater::UpdateInputControlledSceneObject(SceneObject& sceneObject, co
             {
                 if (joystickBoundsSO && joystickSO && mAllowInputControl)
                 {
-                    auto motionVec = math::ComputeTouchCoordsInWorldSpace(GameSingletons::GetWindowDimensions(), inputContext.mTouchPos, guiCamera.GetViewMatrix(), guiCamera.GetProjMatrix()) - joystickBoundsSO->get().mPosition;
+                    auto motionVec = math::ComputeTouchCoordsInWorldSpace(mGameContext.GetWindowDimensions(), inputContext.mTouchPos, guiCamera.GetViewMatrix(), guiCamera.GetProjMatrix()) - joystickBoundsSO->get().mPosition;
 
                     glm::vec3 norm = glm::normalize(motionVec);
                     if (glm::length(motionVec) > glm::length(norm))
@@ -1033,8 +1526,8 @@ void LevelUpdater::UpdateInputControlledSceneObject(SceneObject& sceneObject, co
                     joystickSO->get().mPosition = joystickBoundsSO->get().mPosition + motionVec;
                     joystickSO->get().mPosition.z = JOYSTICK_Z;
                     
-                    motionVec.x *= game_constants::BASE_PLAYER_SPEED * GameSingletons::GetPlayerMovementSpeedStat() * dtMillis;
-                    motionVec.y *= game_constants::BASE_PLAYER_SPEED * GameSingletons::GetPlayerMovementSpeedStat() * dtMillis;
+                    motionVec.x *= game_constants::BASE_PLAYER_SPEED * mGameContext.GetPlayerMovementSpeedStat() * dtMillis;
+                    motionVec.y *= game_constants::BASE_PLAYER_SPEED * mGameContext.GetPlayerMovementSpeedStat() * dtMillis;
                     
                     if (motionVec.x > 0.0f && mPreviousMotionVec.x <= 0.0f && mMovementRotationAllowed)
                     {
@@ -1079,14 +1572,13 @@ void LevelUpdater::UpdateInputControlledSceneObject(SceneObject& sceneObject, co
 
 void LevelUpdater::UpdateBackground(const float dtMillis)
 {
-    static float msAccum = 0.0f;
-    msAccum += dtMillis * game_constants::BACKGROUND_SPEED;
-    msAccum = std::fmod(msAccum, 1.0f);
+    mBackgroundOffset += dtMillis * game_constants::BACKGROUND_SPEED;
+    mBackgroundOffset = std::fmod(mBackgroundOffset, 1.0f);
     
     auto bgSO = mScene.GetSceneObject(game_constants::BACKGROUND_SCENE_OBJECT_NAME);
     if (bgSO)
     {
-       bgSO->get().mShaderFloatUniformValues[game_constants::GENERIC_TEXTURE_OFFSET_UNIFORM_NAME] = -msAccum;
+       bgSO->get().mShaderFloatUniformValues[game_constants::GENERIC_TEXTURE_OFFSET_UNIFORM_NAME] = -mBackgroundOffset;
     }
 }
 
@@ -1105,7 +1597,7 @@ void LevelUpdater::UpdateBossHealthBar(const float dtMillis)
         auto& healthBarSo = bossHealthBarSoOpt->get();
         auto& healthBarTextSo = bossHealthBarTextSoOpt->get();
         
-        if (GameSingletons::GetBossCurrentHealth()/GameSingletons::GetBossMaxHealth() <= 0.0f)
+        if (mGameContext.GetBossCurrentHealth()/mGameContext.GetBossMaxHealth() <= 0.0f)
         {
             healthBarFrameSo.mInvisible = true;
             healthBarSo.mInvisible = true;
@@ -1119,7 +1611,7 @@ void LevelUpdater::UpdateBossHealthBar(const float dtMillis)
             
             healthBarFrameSo.mPosition = game_constants::BOSS_HEALTH_BAR_POSITION;
             
-            double healthPerc = GameSingletons::GetBossCurrentHealth()/GameSingletons::GetBossMaxHealth();
+            double healthPerc = mGameContext.GetBossCurrentHealth()/mGameContext.GetBossMaxHealth();
             
             healthBarSo.mScale.x = game_constants::BOSS_HEALTH_BAR_SCALE.x * mBossAnimatedHealthBarPerc;
             healthBarSo.mPosition.x -= (1.0f - mBossAnimatedHealthBarPerc)/game_constants::BAR_POSITION_DIVISOR_MAGIC * game_constants::BOSS_HEALTH_BAR_SCALE.x;
@@ -1141,7 +1633,7 @@ void LevelUpdater::UpdateBossHealthBar(const float dtMillis)
                 }
             }
 
-            healthBarTextSo.mText = std::to_string(static_cast<int>(mBossAnimatedHealthBarPerc * GameSingletons::GetBossMaxHealth()));
+            healthBarTextSo.mText = std::to_string(static_cast<int>(mBossAnimatedHealthBarPerc * mGameContext.GetBossMaxHealth()));
             glm::vec2 botLeftRect, topRightRect;
             scene_object_utils::GetSceneObjectBoundingRect(healthBarTextSo, botLeftRect, topRightRect);
             healthBarTextSo.mPosition = game_constants::BOSS_HEALTH_BAR_POSITION + game_constants::BAR_TEXT_OFFSET;
@@ -1154,23 +1646,15 @@ void LevelUpdater::UpdateBossHealthBar(const float dtMillis)
 
 void LevelUpdater::UpdateFlows(const float dtMillis)
 {
-    for (size_t i = 0; i < mFlows.size(); ++i)
-    {
-        mFlows[i].Update(dtMillis);
-    }
-    
-    mFlows.erase(std::remove_if(mFlows.begin(), mFlows.end(), [](const RepeatableFlow& flow)
-    {
-        return !flow.IsRunning();
-    }), mFlows.end());
+    mFlowScheduler.Update(dtMillis);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void LevelUpdater::UpdateCameras(const float dtMillis)
 {
-    const auto& guiCamOpt = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::GUIObject);
-    const auto& worldCamOpt = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::WorldGameObject);
+    const auto& guiCamOpt = mGameContext.GetCameraForSceneObjectType(SceneObjectType::GUIObject);
+    const auto& worldCamOpt = mGameContext.GetCameraForSceneObjectType(SceneObjectType::WorldGameObject);
     
     if (guiCamOpt) guiCamOpt->get().Update(dtMillis);
     if (worldCamOpt) worldCamOpt->get().Update(dtMillis);
@@ -1301,8 +1785,8 @@ void LevelUpdater::OnPlayerDamaged()
 {
     objectiveC_utils::Vibrate();
     
-    const auto& guiCamOpt = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::GUIObject);
-    const auto& worldCamOpt = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::WorldGameObject);
+    const auto& guiCamOpt = mGameContext.GetCameraForSceneObjectType(SceneObjectType::GUIObject);
+    const auto& worldCamOpt = mGameContext.GetCameraForSceneObjectType(SceneObjectType::WorldGameObject);
     
     if (guiCamOpt) guiCamOpt->get().Shake();
     if (worldCamOpt) worldCamOpt->get().Shake();
@@ -1310,6 +1794,61 @@ void LevelUpdater::OnPlayerDamaged()
 
 ///------------------------------------------------------------------------------------------------
 
+bool LevelUpdater::OnPlayerHitByEnemyBullet(const strutils::StringId& enemyBulletName)
+{
+    if (mFlowScheduler.GetFlow(game_constants::PLAYER_DAMAGE_INVINCIBILITY_FLOW_NAME)) return false;
+    
+    auto playerSceneObjectOpt = mScene.GetSceneObject(game_constants::PLAYER_SCENE_OBJECT_NAME);
+    auto enemyBulletSceneObjectOpt = mScene.GetSceneObject(enemyBulletName);
+    
+    if (playerSceneObjectOpt && enemyBulletSceneObjectOpt)
+    {
+        auto& playerSO = playerSceneObjectOpt->get();
+        auto& enemyBulletSO = enemyBulletSceneObjectOpt->get();
+        
+        if (!playerSO.mInvulnerable)
+        {
+            auto enemyBulletSceneObjectTypeDef = ObjectTypeDefinitionRepository::GetInstance().GetObjectTypeDefinition(enemyBulletSO.mObjectFamilyTypeName)->get();
+            
+            // Remove player shield/damage player flow
+            auto incomingDamage = mGameContext.GetGodeMode() ? 0.0f : (enemyBulletSceneObjectTypeDef.mDamage - mGameContext.GetPlayerShieldHealth());
+            
+            if (mGameContext.GetPlayerShieldHealth() > 0.0f)
+            {
+                mGameContext.SetPlayerShieldHealth(mGameContext.GetPlayerShieldHealth() - enemyBulletSceneObjectTypeDef.mDamage);
+                
+                if (mGameContext.GetPlayerShieldHealth() <= 0.0f)
+                {
+                    auto playerShieldOpt = mScene.GetSceneObject(game_constants::PLAYER_SHIELD_SCENE_OBJECT_NAME);
+                    if (playerShieldOpt)
+                    {
+                        playerShieldOpt->get().mAnimation->VResume();
+                        mGameContext.SetPlayerShieldHealth(0);
+                        mGameContext.GetEquippedUpgrades().erase(std::find_if(mGameContext.GetEquippedUpgrades().begin(), mGameContext.GetEquippedUpgrades().end(), [&](const UpgradeDefinition& upgradeDefinition){ return upgradeDefinition.mUpgradeNameId == game_constants::PLAYER_SHIELD_UPGRADE_NAME; }));
+                    }
+                }
+            }
+            
+            if (incomingDamage > 0.0f)
+            {
+                mGameContext.SetPlayerCurrentHealth(mGameContext.GetPlayerCurrentHealth() - incomingDamage);
+                OnPlayerDamaged();
+                CreateTextOnDamage(playerSO.mName, math::Box2dVec2ToGlmVec3(playerSO.mBody->GetWorldCenter()), incomingDamage);
+                objectiveC_utils::PlaySound(sounds::PLAYER_DAMAGED_SFX);
+            }
+            
+            mFlowScheduler.AddFlow(CreatePlayerInvincibilityFlow());
+            
+            RemoveWaveEnemy(enemyBulletName);
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+///------------------------------------------------------------------------------------------------
+
 void LevelUpdater::OnBlockedUpdate()
 {
     mAllowInputControl = false;
@@ -1342,7 +1881,7 @@ void LevelUpdater::ApplyShakeToNearlyDeadEntities(std::vector<SceneObject>& scen
         // Player special case
         if (so.mName == game_constants::PLAYER_SCENE_OBJECT_NAME)
         {
-            auto healthRatio = GameSingletons::GetPlayerCurrentHealth()/GameSingletons::GetPlayerMaxHealth();
+            auto healthRatio = mGameContext.GetPlayerCurrentHealth()/mGameContext.GetPlayerMaxHealth();
             if (healthRatio <= SHAKE_ENTITY_HEALTH_RATIO_THRESHOLD)
             {
                 so.mBody->SetTransform(so.mBody->GetWorldCenter() + b2Vec2(math::RandomFloat(-SHAKE_ENTITY_RANDOM_MAG, SHAKE_ENTITY_RANDOM_MAG), math::RandomFloat(-SHAKE_ENTITY_RANDOM_MAG, SHAKE_ENTITY_RANDOM_MAG)), 0.0f);
@@ -1351,7 +1890,7 @@ void LevelUpdater::ApplyShakeToNearlyDeadEntities(std::vector<SceneObject>& scen
         else if (!scene_object_utils::IsSceneObjectBossPart(so))
         {
             auto objectDefOpt = ObjectTypeDefinitionRepository::GetInstance().GetObjectTypeDefinition(so.mObjectFamilyTypeName);
-            if (objectDefOpt)
+            if (objectDefOpt && so.mBody)
             {
                 auto healthRatio = so.mHealth/objectDefOpt->get().mHealth;
                 if (healthRatio <= SHAKE_ENTITY_HEALTH_RATIO_THRESHOLD)
@@ -1369,7 +1908,7 @@ void LevelUpdater::ApplyShakeToNearlyDeadEntities(std::vector<SceneObject>& scen
         
         for (auto& so: sceneObjects)
         {
-            if (scene_object_utils::IsSceneObjectBossPart(so) && GameSingletons::GetBossCurrentHealth()/GameSingletons::GetBossMaxHealth() <= SHAKE_ENTITY_HEALTH_RATIO_THRESHOLD && mBossPositioned)
+            if (scene_object_utils::IsSceneObjectBossPart(so) && mGameContext.GetBossCurrentHealth()/mGameContext.GetBossMaxHealth() <= SHAKE_ENTITY_HEALTH_RATIO_THRESHOLD && mBossPositioned)
             {
                 so.mBody->SetTransform(so.mBody->GetWorldCenter() + randomOffset, 0.0f);
             }
@@ -1378,3 +1917,279 @@ void LevelUpdater::ApplyShakeToNearlyDeadEntities(std::vector<SceneObject>& scen
 }
 
 ///------------------------------------------------------------------------------------------------
+
+RepeatableFlow LevelUpdater::CreatePlayerBulletFlow()
+{
+    auto playerBulletFlow = blueprint_flows::CreatePlayerBulletFlow(mScene);
+    playerBulletFlow.SetRestoreTag({ PLAYER_BULLET_FLOW_KIND, strutils::StringId(), glm::vec3(0.0f) });
+    return playerBulletFlow;
+}
+
+///------------------------------------------------------------------------------------------------
+
+RepeatableFlow LevelUpdater::CreatePlayerInvincibilityFlow()
+{
+    RepeatableFlow playerInvincibilityFlow([]()
+    {
+    }, game_constants::PLAYER_INVINCIBILITY_FLOW_DELAY_MILLIS, RepeatableFlow::RepeatPolicy::ONCE, game_constants::PLAYER_DAMAGE_INVINCIBILITY_FLOW_NAME);
+    
+    playerInvincibilityFlow.SetRestoreTag({ PLAYER_INVINCIBILITY_FLOW_KIND, strutils::StringId(), glm::vec3(0.0f) });
+    return playerInvincibilityFlow;
+}
+
+///------------------------------------------------------------------------------------------------
+
+RepeatableFlow LevelUpdater::CreateWaveEnemyRemovalFlow(const strutils::StringId& enemyName, const float delayMillis)
+{
+    RepeatableFlow waveEnemyRemovalFlow([this, enemyName]()
+    {
+        RemoveWaveEnemy(enemyName);
+    }, delayMillis, RepeatableFlow::RepeatPolicy::ONCE);
+    
+    waveEnemyRemovalFlow.SetRestoreTag({ WAVE_ENEMY_REMOVAL_FLOW_KIND, enemyName });
+    return waveEnemyRemovalFlow;
+}
+
+///------------------------------------------------------------------------------------------------
+
+RepeatableFlow LevelUpdater::CreateDroppedCrystalFlow(const glm::vec3& deathPosition, const float delayMillis)
+{
+    RepeatableFlow droppedCrystalFlow([this, deathPosition]()
+    {
+        CreateDroppedCrystal(deathPosition);
+    }, delayMillis, RepeatableFlow::RepeatPolicy::ONCE);
+    
+    droppedCrystalFlow.SetRestoreTag({ DROPPED_CRYSTAL_FLOW_KIND, strutils::StringId(), deathPosition });
+    return droppedCrystalFlow;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::optional<RepeatableFlow> LevelUpdater::RecreateFlow(const RepeatableFlow::RestoreTag& restoreTag, const float durationMillis)
+{
+    if (restoreTag.mKind == PLAYER_BULLET_FLOW_KIND)
+    {
+        return CreatePlayerBulletFlow();
+    }
+    else if (restoreTag.mKind == PLAYER_INVINCIBILITY_FLOW_KIND)
+    {
+        return CreatePlayerInvincibilityFlow();
+    }
+    else if (restoreTag.mKind == WAVE_ENEMY_REMOVAL_FLOW_KIND)
+    {
+        return CreateWaveEnemyRemovalFlow(restoreTag.mSubjectName, durationMillis);
+    }
+    else if (restoreTag.mKind == DROPPED_CRYSTAL_FLOW_KIND)
+    {
+        return CreateDroppedCrystalFlow(restoreTag.mPosition, durationMillis);
+    }
+    else if (restoreTag.mKind == ENEMY_PROJECTILE_FLOW_KIND)
+    {
+        // The enemy's type is looked up off its (already restored) scene object
+        auto enemySoOpt = mScene.GetSceneObject(restoreTag.mSubjectName);
+        if (enemySoOpt && ObjectTypeDefinitionRepository::GetInstance().GetObjectTypeDefinition(enemySoOpt->get().mObjectFamilyTypeName))
+        {
+            return CreateEnemyProjectileFlow(restoreTag.mSubjectName, enemySoOpt->get().mObjectFamilyTypeName);
+        }
+    }
+    
+    return std::nullopt;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void LevelUpdater::CreateDroppedCrystal(const glm::vec3& deathPosition)
+{
+    auto& resService = resources::ResourceLoadingService::GetInstance();
+    
+    SceneObject crystalSo;
+    
+    glm::vec3 firstControlPoint(deathPosition + glm::vec3(math::RandomFloat(-DROPPED_CRYSTAL_FIRST_CONTROL_POINT_NOISE_MAG, DROPPED_CRYSTAL_FIRST_CONTROL_POINT_NOISE_MAG), math::RandomFloat(-DROPPED_CRYSTAL_FIRST_CONTROL_POINT_NOISE_MAG, DROPPED_CRYSTAL_FIRST_CONTROL_POINT_NOISE_MAG), 0.0f));
+    glm::vec3 thirdControlPoint(game_constants::GUI_CRYSTAL_POSITION);
+    glm::vec3 secondControlPoint((thirdControlPoint + firstControlPoint) * 0.5f + glm::vec3(math::RandomFloat(-DROPPED_CRYSTAL_SECOND_CONTROL_POINT_NOISE_MAG, DROPPED_CRYSTAL_SECOND_CONTROL_POINT_NOISE_MAG), math::RandomFloat(-DROPPED_CRYSTAL_SECOND_CONTROL_POINT_NOISE_MAG, DROPPED_CRYSTAL_SECOND_CONTROL_POINT_NOISE_MAG), 0.0f));
+    
+    firstControlPoint.z = game_constants::GUI_CRYSTAL_POSITION.z;
+    secondControlPoint.z = game_constants::GUI_CRYSTAL_POSITION.z;
+    thirdControlPoint.z = game_constants::GUI_CRYSTAL_POSITION.z;
+    
+    float speedNoise = math::RandomFloat(-DROPPED_CRYSTAL_SPEED/5, DROPPED_CRYSTAL_SPEED/5);
+    float speedMultiplier = DROPPED_CRYSTAL_DISTANCE_FACTOR/glm::distance(firstControlPoint, game_constants::GUI_CRYSTAL_POSITION);
+    
+    crystalSo.mAnimation = std::make_unique<BezierCurvePathAnimation>(resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + game_constants::CRYSTALS_TEXTURE_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_MESHES_ROOT + game_constants::SMALL_CRYSTAL_MESH_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_SHADERS_ROOT + game_constants::BASIC_SHADER_FILE_NAME), glm::vec3(1.0f), math::BezierCurve({firstControlPoint, secondControlPoint, thirdControlPoint}), (DROPPED_CRYSTAL_SPEED + speedNoise) * speedMultiplier, false);
+    
+    crystalSo.mExtraCompoundingAnimations.push_back(std::make_unique<RotationAnimation>(resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + game_constants::CRYSTALS_TEXTURE_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_MESHES_ROOT + game_constants::SMALL_CRYSTAL_MESH_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_SHADERS_ROOT + game_constants::BASIC_SHADER_FILE_NAME), glm::vec3(1.0f), RotationAnimation::RotationMode::ROTATE_CONTINUALLY, RotationAnimation::RotationAxis::Y, 0.0f, game_constants::GUI_CRYSTAL_ROTATION_SPEED, false));
+    
+    crystalSo.mSceneObjectType = SceneObjectType::GUIObject;
+    crystalSo.mPosition = firstControlPoint;
+    crystalSo.mScale = game_constants::GUI_CRYSTAL_SCALE;
+    crystalSo.mName = strutils::StringId(DROPPED_CRYSTAL_NAME_PREFIX + std::to_string(SDL_GetPerformanceCounter()));
+    
+    SetDroppedCrystalCompletionCallback(crystalSo);
+    mScene.AddSceneObject(std::move(crystalSo));
+}
+
+///------------------------------------------------------------------------------------------------
+
+void LevelUpdater::SetDroppedCrystalCompletionCallback(SceneObject& droppedCrystalSo)
+{
+    const auto droppedCrystalName = droppedCrystalSo.mName;
+    
+    droppedCrystalSo.mAnimation->SetCompletionCallback([droppedCrystalName, this]()
+    {
+        auto crystalHolderSoOpt = mScene.GetSceneObject(game_constants::GUI_CRYSTAL_ICON_SCENE_OBJECT_NAME);
+        if (crystalHolderSoOpt)
+        {
+            auto& crystalHolderSo = crystalHolderSoOpt->get();
+            crystalHolderSo.mScale = game_constants::GUI_CRYSTAL_SCALE;
+            
+            crystalHolderSo.mExtraCompoundingAnimations.clear();
+            crystalHolderSo.mExtraCompoundingAnimations.push_back(std::make_unique<PulsingAnimation>(crystalHolderSo.mAnimation->VGetCurrentTextureResourceId(), crystalHolderSo.mAnimation->VGetCurrentMeshResourceId(), crystalHolderSo.mAnimation->VGetCurrentShaderResourceId(), game_constants::GUI_CRYSTAL_SCALE, PulsingAnimation::PulsingMode::OUTER_PULSE_ONCE, 0.0f, COLLECTED_CRYSTAL_PULSING_SPEED, COLLECTED_CRYSTAL_PULSING_FACTOR, false));
+        }
+        
+        objectiveC_utils::PlaySound(sounds::CRYSTALS_SFX);
+        mScene.RemoveAllSceneObjectsWithName(droppedCrystalName);
+        mGameContext.SetCrystalCount(mGameContext.GetCrystalCount() + 1);
+    });
+}
+
+///------------------------------------------------------------------------------------------------
+
+void LevelUpdater::OnSceneObjectRestored(SceneObject& sceneObject)
+{
+    if (sceneObject.mAnimation && strutils::StringStartsWith(sceneObject.mName.GetString(), DROPPED_CRYSTAL_NAME_PREFIX))
+    {
+        SetDroppedCrystalCompletionCallback(sceneObject);
+    }
+    
+    mUpgradesLogicHandler.OnSceneObjectRestored(sceneObject);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void LevelUpdater::PersistSnapshot()
+{
+    // Nothing got simulated since the last snapshot got persisted (e.g. the level is paused behind the settings menu),
+    // or the level isn't the player's own (i.e. headless runs and replays)
+    if (mSnapshotPersisted || mGameContext.IsHeadless() || InputReplayer::GetInstance().IsReplaying())
+    {
+        return;
+    }
+    
+    std::vector<unsigned char> snapshot;
+    if (CaptureSnapshot(snapshot) && level_snapshot::SaveSnapshotFile(snapshot))
+    {
+        mSnapshotPersisted = true;
+    }
+    else
+    {
+        // Better to start the level over than to resume a stale snapshot
+        level_snapshot::DeleteSnapshotFile();
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void LevelUpdater::ResumePersistedSnapshot()
+{
+    // Snapshots are only ever resumed once
+    const auto snapshot = std::move(mPersistedSnapshot);
+    mPersistedSnapshot.clear();
+    level_snapshot::DeleteSnapshotFile();
+    
+    if (!RestoreSnapshot(snapshot))
+    {
+        return;
+    }
+    
+    // The boss theme is normally kicked off by the boss intro
+    if (mBossPositioned && !LevelFinished() && !mLevel.mWaves.at(mCurrentWaveNumber).mBossName.isEmpty())
+    {
+        objectiveC_utils::PlaySound(sounds::BOSS_THEME);
+    }
+    
+#ifndef DEBUG
+    mStateMachine.PushState(SettingsMenuGameState::STATE_NAME);
+#endif
+}
+
+///------------------------------------------------------------------------------------------------
+
+#ifdef DEBUG
+PostStateUpdateDirective LevelUpdater::UpdateSnapshotRoundTrip(std::vector<SceneObject>& sceneObjects, const float dtMillis)
+{
+    auto& roundTrip = *mSnapshotRoundTrip;
+    auto& frameWorkScheduler = FrameWorkScheduler::GetInstance();
+    
+    if (roundTrip.mPhase == SnapshotRoundTrip::Phase::PENDING)
+    {
+        // Wait for the debug console (or any other menu) to be dismissed
+        const auto activeStateName = mStateMachine.GetActiveStateName();
+        if (activeStateName == DebugConsoleGameState::STATE_NAME || activeStateName == SettingsMenuGameState::STATE_NAME)
+        {
+            return UpdateLevel(sceneObjects, dtMillis);
+        }
+        
+        if (!CaptureSnapshot(roundTrip.mSnapshot))
+        {
+            FailSnapshotRoundTrip("Could not capture the level");
+            return UpdateLevel(sceneObjects, dtMillis);
+        }
+        
+        // The first run is the original level carrying on from the captured frame, the second one
+        // is the level restored from the snapshot. Both need to play out in the exact same frames,
+        // regardless of frame timings.
+        roundTrip.mCapturedDigest = ComputeSimulationDigest();
+        frameWorkScheduler.SetUnbudgeted(true);
+        roundTrip.mPhase = SnapshotRoundTrip::Phase::FIRST_RUN;
+        roundTrip.mFramesLeft = roundTrip.mFrameCount;
+    }
+    else if (roundTrip.mFramesLeft == 0 && roundTrip.mPhase == SnapshotRoundTrip::Phase::FIRST_RUN)
+    {
+        roundTrip.mFirstRunDigest = ComputeSimulationDigest();
+        roundTrip.mPhase = SnapshotRoundTrip::Phase::SECOND_RUN;
+        roundTrip.mFramesLeft = roundTrip.mFrameCount;
+        
+        if (!RestoreSnapshot(roundTrip.mSnapshot))
+        {
+            FailSnapshotRoundTrip("Could not restore the level");
+            return UpdateLevel(sceneObjects, dtMillis);
+        }
+        
+        if (ComputeSimulationDigest() != roundTrip.mCapturedDigest)
+        {
+            FailSnapshotRoundTrip("The restored level differs from the captured one");
+            return UpdateLevel(sceneObjects, dtMillis);
+        }
+    }
+    else if (roundTrip.mFramesLeft == 0)
+    {
+        const auto secondRunDigest = ComputeSimulationDigest();
+        if (secondRunDigest != roundTrip.mFirstRunDigest)
+        {
+            FailSnapshotRoundTrip("The original and restored levels diverged after " + std::to_string(roundTrip.mFrameCount) + " frames (digests " + std::to_string(roundTrip.mFirstRunDigest) + " vs " + std::to_string(secondRunDigest) + ")");
+            return UpdateLevel(sceneObjects, dtMillis);
+        }
+        
+        Log(LogType::INFO, "Snapshot round trip: the original and restored levels were identical after %d frames (%d byte snapshot)", roundTrip.mFrameCount, static_cast<int>(roundTrip.mSnapshot.size()));
+        frameWorkScheduler.SetUnbudgeted(false);
+        mSnapshotRoundTrip.reset();
+        return UpdateLevel(sceneObjects, dtMillis);
+    }
+    
+    roundTrip.mFramesLeft--;
+    return UpdateLevel(sceneObjects, dtMillis);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void LevelUpdater::FailSnapshotRoundTrip(const std::string& failureText)
+{
+    Log(LogType::ERROR, "Snapshot round trip: %s", failureText.c_str());
+    ospopups::ShowMessageBox(ospopups::MessageBoxType::ERROR, "Snapshot round trip failed", failureText);
+    
+    FrameWorkScheduler::GetInstance().SetUnbudgeted(false);
+    mSnapshotRoundTrip.reset();
+}
+#endif
+
+///------------------------------------------------------------------------------------------------
@@ -14,12 +14,14 @@
 #include "BossAIController.h"
 #include "SceneObject.h"
 #include "LevelDefinition.h"
+#include "FlowScheduler.h"
 #include "RepeatableFlow.h"
 #include "UpgradeDefinition.h"
 #include "UpgradesLevelLogicHandler.h"
 #include "StateMachine.h"
 #include "../utils/StringUtils.h"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <unordered_set>
@@ -29,6 +31,7 @@
 
 ///------------------------------------------------------------------------------------------------
 
+class GameContext;
 class ObjectTypeDefinition;
 class Scene;
 class b2World;
@@ -49,7 +52,11 @@ public:
     void VOpenSettingsMenu() override;
     
     void AdvanceWave();
-    void AddFlow(RepeatableFlow&& flow);
+    FlowHandle AddFlow(RepeatableFlow&& flow);
+    
+    /// Schedules a flow recreated by its owner when restoring a snapshot, to fire once the ticks it had left have elapsed.
+    FlowHandle ResumeFlow(RepeatableFlow&& flow, const float ticksLeft);
+    void CancelFlow(const FlowHandle flowHandle);
     void AddWaveEnemy(const strutils::StringId& enemyName);
     void RemoveWaveEnemy(const strutils::StringId& enemyName);
     void DropCrystals(const glm::vec3& deathPosition, const float enemyDeathAnimationMillis, float crystalYieldValue);
@@ -58,14 +65,57 @@ public:
     bool LevelFinished() const;
     size_t GetCurrentWaveNumber() const;
     size_t GetWaveEnemyCount() const;
+    float GetWaveEnemySpeedFactor() const;
     std::optional<std::reference_wrapper<RepeatableFlow>> GetFlow(const strutils::StringId& flowName);
     const std::unordered_set<strutils::StringId, strutils::StringIdHasher>& GetWaveEnemyNames() const;
     void OnBossPositioned();
     
     void CreateLevelWalls(const Camera& cam, const bool invisible);
+    RepeatableFlow CreateEnemyProjectileFlow(const strutils::StringId& enemyName, const strutils::StringId& enemyTypeName);
+    
+    /// Captures the full state of the running level (scene objects and their bodies, flows, game states,
+    /// boss AI, per level progress etc..) in to a single blob.
+    /// @param[out] outSnapshot the captured snapshot.
+    /// @returns false if the level is in a state that can't be captured (e.g. mid transition, or behind a menu).
+    bool CaptureSnapshot(std::vector<unsigned char>& outSnapshot) const;
+    
+    /// Restores a snapshot captured by CaptureSnapshot, in place of the current state of the level.
+    /// Snapshots of other levels (or builds) are rejected without touching anything, whereas if the snapshot
+    /// fails validation only midway through restoring it, the level gets reloaded from scratch.
+    /// @param[in] snapshot the snapshot to restore.
+    /// @returns whether the snapshot got restored.
+    bool RestoreSnapshot(const std::vector<unsigned char>& snapshot);
+    
+    /// @returns a digest of the simulated state of the level, for checking that two runs played out identically.
+    uint64_t ComputeSimulationDigest() const;
+    
+#ifdef DEBUG
+    /// Verifies snapshots on the next frames (once no menus are open): captures the level, restores the
+    /// snapshot and checks nothing changed, then plays the given number of frames (at a fixed step) twice
+    /// from the restored snapshot, checking that both runs end up in the exact same state. Results are logged.
+    void BeginSnapshotRoundTrip(const int frameCount);
+#endif
     
 private:
     void LoadLevelInvariantObjects();
+    PostStateUpdateDirective UpdateLevel(std::vector<SceneObject>& sceneObjects, const float dtMillis);
+    
+    RepeatableFlow CreatePlayerBulletFlow();
+    RepeatableFlow CreatePlayerInvincibilityFlow();
+    RepeatableFlow CreateWaveEnemyRemovalFlow(const strutils::StringId& enemyName, const float delayMillis);
+    RepeatableFlow CreateDroppedCrystalFlow(const glm::vec3& deathPosition, const float delayMillis);
+    std::optional<RepeatableFlow> RecreateFlow(const RepeatableFlow::RestoreTag& restoreTag, const float durationMillis);
+    
+    void CreateDroppedCrystal(const glm::vec3& deathPosition);
+    void SetDroppedCrystalCompletionCallback(SceneObject& droppedCrystalSo);
+    void OnSceneObjectRestored(SceneObject& sceneObject);
+    void PersistSnapshot();
+    void ResumePersistedSnapshot();
+    
+#ifdef DEBUG
+    PostStateUpdateDirective UpdateSnapshotRoundTrip(std::vector<SceneObject>& sceneObjects, const float dtMillis);
+    void FailSnapshotRoundTrip(const std::string& failureText);
+#endif
     
     void UpdateInputControlledSceneObject(SceneObject& sceneObject, const ObjectTypeDefinition& sceneObjectTypeDef, const float dtMillis);
     void UpdateBackground(const float dtMillis);
@@ -77,31 +127,59 @@ private:
     
     void CreateTextOnDamage(const strutils::StringId& damagedSceneObjectName, const glm::vec3& textOriginPos, const int damage);
     void OnPlayerDamaged();
+    
+    /// @returns whether the enemy bullet is spent, i.e. it got to damage the player (or their shield).
+    bool OnPlayerHitByEnemyBullet(const strutils::StringId& enemyBulletName);
     void OnBlockedUpdate();
     
     void ApplyShakeToNearlyDeadEntities(std::vector<SceneObject>& sceneObjects);
     
 private:
     Scene& mScene;
+    GameContext& mGameContext;
     b2World& mBox2dWorld;
     LevelDefinition mLevel;
     UpgradesLevelLogicHandler mUpgradesLogicHandler;
     StateMachine mStateMachine;
     BossAIController mBossAIController;
     PostStateUpdateDirective mLastPostStateMachineUpdateDirective;
-    std::vector<RepeatableFlow> mFlows;
+    FlowScheduler mFlowScheduler;
     std::unordered_map<strutils::StringId, strutils::StringId, strutils::StringIdHasher> mDamagedSceneObjectNameToTextSceneObject;
     std::unordered_map<strutils::StringId, float, strutils::StringIdHasher> mDamagedSceneObjectNameToTextSceneObjectFreezeTimer;
     std::unordered_set<strutils::StringId, strutils::StringIdHasher> mWaveEnemies;
     std::unordered_set<strutils::StringId, strutils::StringIdHasher> mActiveLightNames;
+    std::vector<UpgradeDefinition> mLevelStartEquippedUpgrades;
+    std::vector<unsigned char> mPersistedSnapshot;
+    
+#ifdef DEBUG
+    struct SnapshotRoundTrip
+    {
+        enum class Phase
+        {
+            PENDING, FIRST_RUN, SECOND_RUN
+        };
+        
+        std::vector<unsigned char> mSnapshot;
+        uint64_t mCapturedDigest = 0;
+        uint64_t mFirstRunDigest = 0;
+        int mFrameCount = 0;
+        int mFramesLeft = 0;
+        Phase mPhase = Phase::PENDING;
+    };
+    
+    std::optional<SnapshotRoundTrip> mSnapshotRoundTrip;
+#endif
     
     glm::vec3 mPreviousMotionVec;
     glm::vec2 mAccelerometerCalibrationValues;
     size_t mCurrentWaveNumber;
     float mBossAnimatedHealthBarPerc;
+    float mBackgroundOffset;
     bool mAllowInputControl;
     bool mMovementRotationAllowed;
     bool mBossPositioned;
+    bool mSettingsMenuRequested;
+    bool mSnapshotPersisted;
 };
 
 ///------------------------------------------------------------------------------------------------
@@ -8,16 +8,13 @@
 #include "Map.h"
 #include "GameConstants.h"
 #include "GameSingletons.h"
-#include "LevelGeneration.h"
 #include "ObjectiveCUtils.h"
 #include "SceneObject.h"
 #include "Scene.h"
 #include "datarepos/WaveBlocksRepository.h"
 #include "../resloading/ResourceLoadingService.h"
-#include "../utils/Logging.h"
 
-#include <SDL.h>
-#include <fstream>
+#include <cassert>
 #include <unordered_set>
 
 ///------------------------------------------------------------------------------------------------
@@ -45,11 +42,14 @@ Map::Map(Scene& scene, const int generationSeed, const glm::ivec2& mapDimensions
     , mCurrentMapCoord(currentMapCoord)
     , mGenerationSeed(generationSeed)
     , mHasSingleEntryPoint(singleEntryPoint)
+    , mNodes(mapDimensions.x * mapDimensions.y)
+    , mColumnNodeRowMasks(mapDimensions.x, 0)
 {
+    assert(mapDimensions.y <= NodeLinks::MAX_ROWS);
+    
     math::SetControlSeed(generationSeed);
     GenerateMapData();
     CreateMapSceneObjects();
-    CreateLevelFiles();
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -61,16 +61,73 @@ int Map::GetCurrentGenerationSeed() const
 
 ///------------------------------------------------------------------------------------------------
 
-const std::map<MapCoord, Map::NodeData>& Map::GetMapData() const
+const glm::ivec2& Map::GetMapDimensions() const
 {
-    return mMapData;
+    return mMapDimensions;
 }
 
 ///------------------------------------------------------------------------------------------------
 
-const glm::ivec2& Map::GetMapDimensions() const
+bool Map::HasNode(const MapCoord& mapCoord) const
 {
-    return mMapDimensions;
+    if (mapCoord.mCol < 0 || mapCoord.mCol >= mMapDimensions.x || mapCoord.mRow < 0 || mapCoord.mRow >= mMapDimensions.y)
+    {
+        return false;
+    }
+    
+    return (mColumnNodeRowMasks[mapCoord.mCol] & (1u << mapCoord.mRow)) != 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
+const Map::NodeData& Map::GetNodeData(const MapCoord& mapCoord) const
+{
+    assert(HasNode(mapCoord));
+    return mNodes[GetNodeIndex(mapCoord)];
+}
+
+///------------------------------------------------------------------------------------------------
+
+const strutils::StringId& Map::GetNodeSceneObjectName(const MapCoord& mapCoord) const
+{
+    return mNodeSceneObjectNames[GetNodeIndex(mapCoord)];
+}
+
+///------------------------------------------------------------------------------------------------
+
+const strutils::StringId& Map::GetPlanetRingSceneObjectName(const MapCoord& mapCoord) const
+{
+    return mPlanetRingSceneObjectNames[GetNodeIndex(mapCoord)];
+}
+
+///------------------------------------------------------------------------------------------------
+
+const std::vector<strutils::StringId>& Map::GetPathSegmentSceneObjectNames(const MapCoord& mapCoord, const MapCoord& linkedCoord) const
+{
+    assert(GetNodeData(mapCoord).mNodeLinks.contains(linkedCoord));
+    return mPathSegmentSceneObjectNames[GetNodeIndex(mapCoord) * mMapDimensions.y + linkedCoord.mRow];
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t Map::GetNodeIndex(const MapCoord& mapCoord) const
+{
+    assert(mapCoord.mCol >= 0 && mapCoord.mCol < mMapDimensions.x && mapCoord.mRow >= 0 && mapCoord.mRow < mMapDimensions.y);
+    return static_cast<size_t>(mapCoord.mCol * mMapDimensions.y + mapCoord.mRow);
+}
+
+///------------------------------------------------------------------------------------------------
+
+Map::NodeData& Map::GetOrCreateNodeData(const MapCoord& mapCoord)
+{
+    auto& nodeData = mNodes[GetNodeIndex(mapCoord)];
+    if (!HasNode(mapCoord))
+    {
+        mColumnNodeRowMasks[mapCoord.mCol] |= 1u << mapCoord.mRow;
+        nodeData = NodeData{ NodeType::NORMAL_ENCOUNTER, glm::vec3(0.0f), NodeLinks(mapCoord.mCol + 1) };
+    }
+    
+    return nodeData;
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -82,8 +139,8 @@ void Map::GenerateMapData()
     for (int i = 0; i < iterations; ++i)
     {
         auto currentCoordinate = mHasSingleEntryPoint ? MapCoord(0, mMapDimensions.y/2) : MapCoord(0, math::ControlledRandomInt(0, mMapDimensions.y - 1));
-        mMapData[currentCoordinate].mPosition = GenerateNodePositionForCoord(currentCoordinate);
-        mMapData[currentCoordinate].mNodeType = SelectNodeTypeForCoord(currentCoordinate);
+        GetOrCreateNodeData(currentCoordinate).mPosition = GenerateNodePositionForCoord(currentCoordinate);
+        GetOrCreateNodeData(currentCoordinate).mNodeType = SelectNodeTypeForCoord(currentCoordinate);
         
         for (int col = 1; col < mMapDimensions.x; ++col)
         {
@@ -94,22 +151,23 @@ void Map::GenerateMapData()
                 targetCoord = RandomlySelectNextMapCoord(currentCoordinate);
             }
             
-            mMapData[currentCoordinate].mNodeLinks.insert(targetCoord);
+            GetOrCreateNodeData(currentCoordinate).mNodeLinks.insert(targetCoord);
             currentCoordinate = targetCoord;
-            mMapData[currentCoordinate].mPosition = GenerateNodePositionForCoord(currentCoordinate);
-            mMapData[currentCoordinate].mNodeType = SelectNodeTypeForCoord(currentCoordinate);
+            GetOrCreateNodeData(currentCoordinate).mPosition = GenerateNodePositionForCoord(currentCoordinate);
+            GetOrCreateNodeData(currentCoordinate).mNodeType = SelectNodeTypeForCoord(currentCoordinate);
         }
     }
     
     // Handle map distortions
     if (GameSingletons::GetErasedLabsOnCurrentMap())
     {
-        for (auto& mapNodeEntry: mMapData)
+        for (const auto& mapCoord: GetNodeCoords())
         {
-            if (mapNodeEntry.second.mNodeType == NodeType::LAB)
+            auto& nodeData = mNodes[GetNodeIndex(mapCoord)];
+            if (nodeData.mNodeType == NodeType::LAB)
             {
                 // Replace labs with either normal, hard, or event nodes
-                mapNodeEntry.second.mNodeType = static_cast<NodeType>(math::ControlledRandomInt(0, 2));
+                nodeData.mNodeType = static_cast<NodeType>(math::ControlledRandomInt(0, 2));
             }
         }
     }
@@ -134,14 +192,28 @@ void Map::CreateMapSceneObjects()
         mScene.AddSceneObject(std::move(bgSO));
     }
     
+    // Scene object names
+    mNodeSceneObjectNames.resize(mNodes.size());
+    mPlanetRingSceneObjectNames.resize(mNodes.size());
+    mPathSegmentSceneObjectNames.resize(mNodes.size() * mMapDimensions.y);
+    
+    const auto nodeCoords = GetNodeCoords();
+    for (const auto& mapCoord: nodeCoords)
+    {
+        mNodeSceneObjectNames[GetNodeIndex(mapCoord)] = strutils::StringId(mapCoord.ToString());
+        mPlanetRingSceneObjectNames[GetNodeIndex(mapCoord)] = strutils::StringId("PLANET_RING_" + mapCoord.ToString());
+    }
+    
     // All node meshes
-    for (const auto& mapNodeEntry: mMapData)
+    for (const auto& mapCoord: nodeCoords)
     {
+        const auto& nodeData = GetNodeData(mapCoord);
+        
         SceneObject nodeSo;
-        nodeSo.mName = strutils::StringId(mapNodeEntry.first.ToString());
-        nodeSo.mPosition = mapNodeEntry.second.mPosition;
+        nodeSo.mName = GetNodeSceneObjectName(mapCoord);
+        nodeSo.mPosition = nodeData.mPosition;
         
-        switch (mapNodeEntry.second.mNodeType)
+        switch (nodeData.mNodeType)
         {
             case NodeType::STARTING_LOCATION:
             {
@@ -153,18 +225,18 @@ void Map::CreateMapSceneObjects()
             {
                 SceneObject planetRingSO;
                 
-                auto shaderNameToUse = mapNodeEntry.first.mCol <= mCurrentMapCoord.mCol ? game_constants::GRAYSCALE_SHADER_FILE_NAME : game_constants::BASIC_SHADER_FILE_NAME;
+                auto shaderNameToUse = mapCoord.mCol <= mCurrentMapCoord.mCol ? game_constants::GRAYSCALE_SHADER_FILE_NAME : game_constants::BASIC_SHADER_FILE_NAME;
                 planetRingSO.mAnimation = std::make_unique<SingleFrameAnimation>(resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + game_constants::MAP_PLANET_RING_TEXTURE_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_MESHES_ROOT + game_constants::MAP_PLANET_RING_MESH_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_SHADERS_ROOT + shaderNameToUse), glm::vec3(1.0f), false);
                 planetRingSO.mShaderBoolUniformValues[game_constants::IS_AFFECTED_BY_LIGHT_UNIFORM_NAME] = false;
                 planetRingSO.mSceneObjectType = SceneObjectType::WorldGameObject;
                 planetRingSO.mScale = glm::vec3(1.0f);
                 planetRingSO.mRotation.x = math::ControlledRandomFloat(MAP_PLANET_RING_MIN_X_ROTATION, MAP_PLANET_RING_MAX_X_ROTATION);
                 planetRingSO.mRotation.y += math::ControlledRandomFloat(MAP_PLANET_RING_MIN_Y_ROTATION, MAP_PLANET_RING_MAX_Y_ROTATION);
-                planetRingSO.mPosition = mapNodeEntry.second.mPosition;
-                planetRingSO.mName = strutils::StringId("PLANET_RING_" + mapNodeEntry.first.ToString());
+                planetRingSO.mPosition = nodeData.mPosition;
+                planetRingSO.mName = GetPlanetRingSceneObjectName(mapCoord);
                 
                 // Add also pulsing animation if node is active
-                if (mMapData.at(mCurrentMapCoord).mNodeLinks.contains(mapNodeEntry.first))
+                if (GetNodeData(mCurrentMapCoord).mNodeLinks.contains(mapCoord))
                 {
                     planetRingSO.mExtraCompoundingAnimations.push_back( std::make_unique<PulsingAnimation>(planetRingSO.mAnimation->VGetCurrentTextureResourceId(), planetRingSO.mAnimation->VGetCurrentMeshResourceId(), planetRingSO.mAnimation->VGetCurrentShaderResourceId(), planetRingSO.mAnimation->VGetScale(),  PulsingAnimation::PulsingMode::PULSE_CONTINUALLY, 0.0f, game_constants::MAP_NODE_PULSING_SPEED, game_constants::MAP_NODE_PULSING_ENLARGEMENT_FACTOR, false));
                 }
@@ -173,7 +245,7 @@ void Map::CreateMapSceneObjects()
             } // Intentional Fallthrough
             case NodeType::NORMAL_ENCOUNTER:
             {
-                bool shouldRotate = mapNodeEntry.first.mCol > mCurrentMapCoord.mCol;
+                bool shouldRotate = mapCoord.mCol > mCurrentMapCoord.mCol;
                 
                 nodeSo.mAnimation = std::make_unique<RotationAnimation>(resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + game_constants::MAP_PLANET_TEXTURE_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_MESHES_ROOT + game_constants::MAP_PLANET_MESH_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_SHADERS_ROOT + (shouldRotate ? game_constants::HUE_SHIFT_SHADER_FILE_NAME : game_constants::GRAYSCALE_SHADER_FILE_NAME)), glm::vec3(1.0f), RotationAnimation::RotationMode::ROTATE_CONTINUALLY, RotationAnimation::RotationAxis::Y, 0.0f,  shouldRotate ? game_constants::MAP_NODE_ROTATION_SPEED : 0.0f, false);
                 
@@ -183,14 +255,14 @@ void Map::CreateMapSceneObjects()
             
             case NodeType::EVENT:
             {
-                bool shouldUseGrayscale = mapNodeEntry.first.mCol <= mCurrentMapCoord.mCol;
+                bool shouldUseGrayscale = mapCoord.mCol <= mCurrentMapCoord.mCol;
                 nodeSo.mAnimation = std::make_unique<SingleFrameAnimation>(resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + EVENT_TEXTURE_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_MESHES_ROOT + game_constants::QUAD_MESH_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_SHADERS_ROOT + (shouldUseGrayscale ? game_constants::GRAYSCALE_SHADER_FILE_NAME : game_constants::BASIC_SHADER_FILE_NAME)), EVENT_SCALE, false);
                 nodeSo.mScale = EVENT_SCALE;
             } break;
                 
             case NodeType::LAB:
             {
-                bool shouldUseGrayscale = mapNodeEntry.first.mCol <= mCurrentMapCoord.mCol;
+                bool shouldUseGrayscale = mapCoord.mCol <= mCurrentMapCoord.mCol;
                 nodeSo.mAnimation = std::make_unique<SingleFrameAnimation>(resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + LAB_TEXTURE_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_MESHES_ROOT + game_constants::QUAD_MESH_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_SHADERS_ROOT + (shouldUseGrayscale ? game_constants::GRAYSCALE_SHADER_FILE_NAME : game_constants::BASIC_SHADER_FILE_NAME)), LAB_SCALE, false);
                 nodeSo.mScale = LAB_SCALE;
             } break;
@@ -212,7 +284,7 @@ void Map::CreateMapSceneObjects()
         }
         
         // Add also pulsing animation if node is active
-        if (mMapData.at(mCurrentMapCoord).mNodeLinks.contains(mapNodeEntry.first))
+        if (GetNodeData(mCurrentMapCoord).mNodeLinks.contains(mapCoord))
         {
             nodeSo.mExtraCompoundingAnimations.push_back(std::make_unique<PulsingAnimation>(nodeSo.mAnimation->VGetCurrentTextureResourceId(), nodeSo.mAnimation->VGetCurrentMeshResourceId(), nodeSo.mAnimation->VGetCurrentShaderResourceId(), nodeSo.mAnimation->VGetScale(),  PulsingAnimation::PulsingMode::PULSE_CONTINUALLY, 0.0f, game_constants::MAP_NODE_PULSING_SPEED, game_constants::MAP_NODE_PULSING_ENLARGEMENT_FACTOR, false));
         }
@@ -220,18 +292,23 @@ void Map::CreateMapSceneObjects()
         mScene.AddSceneObject(std::move(nodeSo));
     }
 
-    for (const auto& mapNodeEntry: mMapData)
+    for (const auto& mapCoord: nodeCoords)
     {
-        for (const auto& linkedCoord: mapNodeEntry.second.mNodeLinks)
+        const auto& nodeData = GetNodeData(mapCoord);
+        
+        for (const auto& linkedCoord: nodeData.mNodeLinks)
         {
-            glm::vec3 dirToNext = mMapData.at(linkedCoord).mPosition - mMapData.at(mapNodeEntry.first).mPosition;
+            glm::vec3 dirToNext = GetNodeData(linkedCoord).mPosition - nodeData.mPosition;
             
+            auto& pathSegmentNames = mPathSegmentSceneObjectNames[GetNodeIndex(mapCoord) * mMapDimensions.y + linkedCoord.mRow];
             auto pathSegments = 2 * static_cast<int>(glm::length(dirToNext));
             for (int i = 0; i < pathSegments; ++i)
             {
+                pathSegmentNames.emplace_back(mapCoord.ToString() + "-" + linkedCoord.ToString() + "_" + std::to_string(i) + MAP_PATH_NAME_SUFFIX);
+                
                 SceneObject pathSO;
                 
-                if (mapNodeEntry.first == mCurrentMapCoord)
+                if (mapCoord == mCurrentMapCoord)
                 {
                     pathSO.mAnimation = std::make_unique<PulsingAnimation>(resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + game_constants::MAP_STAR_PATH_TEXTURE_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_MESHES_ROOT + game_constants::QUAD_MESH_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_SHADERS_ROOT + game_constants::BASIC_SHADER_FILE_NAME), game_constants::MAP_STAR_PATH_SCALE,  PulsingAnimation::PulsingMode::PULSE_CONTINUALLY, game_constants::MAP_STAR_PATH_PULSING_DELAY_MILLIS * i, game_constants::MAP_STAR_PATH_PULSING_SPEED, game_constants::MAP_STAR_PATH_PULSING_ENLARGEMENT_FACTOR, false);
                 }
@@ -242,9 +319,9 @@ void Map::CreateMapSceneObjects()
                 
                 
                 pathSO.mSceneObjectType = SceneObjectType::WorldGameObject;
-                pathSO.mPosition = mMapData.at(mapNodeEntry.first).mPosition + dirToNext * (i/static_cast<float>(pathSegments));
+                pathSO.mPosition = nodeData.mPosition + dirToNext * (i/static_cast<float>(pathSegments));
                 pathSO.mScale = game_constants::MAP_STAR_PATH_SCALE;
-                pathSO.mName = strutils::StringId(mapNodeEntry.first.ToString() + "-" + linkedCoord.ToString() + "_" + std::to_string(i) + MAP_PATH_NAME_SUFFIX);
+                pathSO.mName = pathSegmentNames.back();
                 pathSO.mShaderBoolUniformValues[game_constants::IS_AFFECTED_BY_LIGHT_UNIFORM_NAME] = false;
                 mScene.AddSceneObject(std::move(pathSO));
             }
@@ -254,29 +331,19 @@ void Map::CreateMapSceneObjects()
 
 ///------------------------------------------------------------------------------------------------
 
-void Map::CreateLevelFiles()
+std::vector<MapCoord> Map::GetNodeCoords() const
 {
-    auto startTime = SDL_GetPerformanceCounter();
-    
-    for (const auto& mapNodeEntry: mMapData)
+    // Col-major order. Random values are drawn per node in this order during map
+    // generation and scene object creation, so changing it would alter existing maps.
+    std::vector<MapCoord> nodeCoords;
+    for (int col = 0; col < mMapDimensions.x; ++col)
     {
-        switch (mapNodeEntry.second.mNodeType)
+        for (auto rowMask = mColumnNodeRowMasks[col]; rowMask != 0; rowMask &= rowMask - 1)
         {
-            case NodeType::NORMAL_ENCOUNTER:
-            case NodeType::HARD_ENCOUNTER:
-            case NodeType::BOSS_ENCOUNTER: level_generation::GenerateLevel(mapNodeEntry.first, mapNodeEntry.second);
-            
-            default: break;
+            nodeCoords.emplace_back(col, std::countr_zero(rowMask));
         }
     }
-    
-    auto currTime = SDL_GetPerformanceCounter();
-    
-    double elapsedTime = static_cast<double>(
-      (currTime - startTime) / static_cast<double>(SDL_GetPerformanceFrequency())
-    );
-    
-    Log(LogType::INFO, "Level generation finished in %.6f millis", elapsedTime * 1000.0f);
+    return nodeCoords;
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -291,12 +358,12 @@ bool Map::DetectedCrossedEdge(const MapCoord& currentCoord, const MapCoord& targ
     if (currentCoordHasTopNeighbor && targetCoordHasBotNeighbor)
     {
         MapCoord currentTopNeighbor(currentCoord.mCol, currentCoord.mRow - 1);
-        if (mMapData.count(currentTopNeighbor) && mMapData.at(currentTopNeighbor).mNodeLinks.contains(MapCoord(targetTestCoord.mCol, targetTestCoord.mRow + 1))) return true;
+        if (HasNode(currentTopNeighbor) && GetNodeData(currentTopNeighbor).mNodeLinks.contains(MapCoord(targetTestCoord.mCol, targetTestCoord.mRow + 1))) return true;
     }
     if (currentCoordHasBotNeighbor && targetCoordHasTopNeighbor)
     {
         MapCoord currentBotNeighbor(currentCoord.mCol, currentCoord.mRow + 1);
-        if (mMapData.count(currentBotNeighbor) && mMapData.at(currentBotNeighbor).mNodeLinks.contains(MapCoord(targetTestCoord.mCol, targetTestCoord.mRow - 1))) return true;
+        if (HasNode(currentBotNeighbor) && GetNodeData(currentBotNeighbor).mNodeLinks.contains(MapCoord(targetTestCoord.mCol, targetTestCoord.mRow - 1))) return true;
     }
     
     return false;
@@ -360,14 +427,18 @@ Map::NodeType Map::SelectNodeTypeForCoord(const MapCoord& mapCoord) const
         }
          
         // Remove any node types from the immediate previous links except if they are
-        // normal encounters or events
-        for (const auto& mapEntry: mMapData)
+        // normal encounters or events. Only nodes of the previous column can link here.
+        for (int row = 0; row < mMapDimensions.y; ++row)
         {
-            if (mapEntry.second.mNodeType == NodeType::NORMAL_ENCOUNTER || mapEntry.second.mNodeType == NodeType::EVENT) continue;
+            const MapCoord previousColCoord(mapCoord.mCol - 1, row);
+            if (!HasNode(previousColCoord)) continue;
+            
+            const auto& previousColNodeData = GetNodeData(previousColCoord);
+            if (previousColNodeData.mNodeType == NodeType::NORMAL_ENCOUNTER || previousColNodeData.mNodeType == NodeType::EVENT) continue;
             
-            if (mapEntry.second.mNodeLinks.contains(mapCoord))
+            if (previousColNodeData.mNodeLinks.contains(mapCoord))
             {
-                availableNodeTypes.erase(mapEntry.second.mNodeType);
+                availableNodeTypes.erase(previousColNodeData.mNodeType);
             }
         }
         
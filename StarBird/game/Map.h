@@ -14,8 +14,11 @@
 #include "../utils/MathUtils.h"
 #include "../utils/StringUtils.h"
 
-#include <map>
-#include <unordered_set>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <vector>
 
 ///------------------------------------------------------------------------------------------------
 
@@ -54,12 +57,70 @@ struct MapCoordHasher
 {
     std::size_t operator()(const MapCoord& key) const
     {
-        return strutils::StringId(key.ToString()).GetStringId();
+        // Cols and rows are small and non negative, so packing them is collision free
+        return std::hash<uint64_t>()((static_cast<uint64_t>(static_cast<uint32_t>(key.mCol)) << 32) | static_cast<uint32_t>(key.mRow));
     }
 };
 
 ///------------------------------------------------------------------------------------------------
 
+/// The links of a map node. Nodes only ever link to nodes of the next column, so the links
+/// are stored as a bitmask over that column's rows. Mirrors the parts of the std::unordered_set
+/// interface that the map code uses, without ever allocating.
+class NodeLinks final
+{
+public:
+    static constexpr int MAX_ROWS = 32;
+    
+    class Iterator final
+    {
+    public:
+        Iterator(const int linkedCol, const uint32_t remainingRowMask)
+            : mLinkedCol(linkedCol)
+            , mRemainingRowMask(remainingRowMask)
+        {
+        }
+        
+        MapCoord operator * () const { return MapCoord(mLinkedCol, std::countr_zero(mRemainingRowMask)); }
+        Iterator& operator ++ () { mRemainingRowMask &= mRemainingRowMask - 1; return *this; }
+        bool operator != (const Iterator& rhs) const { return mRemainingRowMask != rhs.mRemainingRowMask; }
+        
+    private:
+        int mLinkedCol;
+        uint32_t mRemainingRowMask;
+    };
+    
+public:
+    NodeLinks() = default;
+    explicit NodeLinks(const int linkedCol)
+        : mLinkedCol(linkedCol)
+    {
+    }
+    
+    void insert(const MapCoord& mapCoord)
+    {
+        assert(mapCoord.mCol == mLinkedCol && mapCoord.mRow >= 0 && mapCoord.mRow < MAX_ROWS);
+        mRowMask |= 1u << mapCoord.mRow;
+    }
+    
+    bool contains(const MapCoord& mapCoord) const
+    {
+        return mapCoord.mCol == mLinkedCol && mapCoord.mRow >= 0 && mapCoord.mRow < MAX_ROWS && (mRowMask & (1u << mapCoord.mRow)) != 0;
+    }
+    
+    size_t size() const { return static_cast<size_t>(std::popcount(mRowMask)); }
+    bool empty() const { return mRowMask == 0; }
+    
+    Iterator begin() const { return Iterator(mLinkedCol, mRowMask); }
+    Iterator end() const { return Iterator(mLinkedCol, 0); }
+    
+private:
+    int mLinkedCol = 0;
+    uint32_t mRowMask = 0;
+};
+
+///------------------------------------------------------------------------------------------------
+
 class Scene;
 class Map final
 {
@@ -79,20 +140,31 @@ public:
     {
         NodeType mNodeType;
         glm::vec3 mPosition;
-        std::unordered_set<MapCoord, MapCoordHasher> mNodeLinks;
+        NodeLinks mNodeLinks;
     };
     
 public:
     Map(Scene& scene, const int generationSeed, const glm::ivec2& mapDimensions, const MapCoord& currentMapCoord, const bool singleEntryPoint);
     
     int GetCurrentGenerationSeed() const;
-    const std::map<MapCoord, Map::NodeData>& GetMapData() const;
     const glm::ivec2& GetMapDimensions() const;
     
+    bool HasNode(const MapCoord& mapCoord) const;
+    const NodeData& GetNodeData(const MapCoord& mapCoord) const;
+    
+    /// Scene object names of the various parts of a node, built once on
+    /// map creation so that selection queries don't need to construct them.
+    const strutils::StringId& GetNodeSceneObjectName(const MapCoord& mapCoord) const;
+    const strutils::StringId& GetPlanetRingSceneObjectName(const MapCoord& mapCoord) const;
+    const std::vector<strutils::StringId>& GetPathSegmentSceneObjectNames(const MapCoord& mapCoord, const MapCoord& linkedCoord) const;
+    
 private:
+    size_t GetNodeIndex(const MapCoord& mapCoord) const;
+    NodeData& GetOrCreateNodeData(const MapCoord& mapCoord);
+    std::vector<MapCoord> GetNodeCoords() const;
+    
     void GenerateMapData();
     void CreateMapSceneObjects();
-    void CreateLevelFiles();
     
     bool DetectedCrossedEdge(const MapCoord& mapCoord, const MapCoord& targetTestCoord) const;
     glm::vec3 GenerateNodePositionForCoord(const MapCoord& mapCoord) const;
@@ -105,7 +177,14 @@ private:
     const MapCoord mCurrentMapCoord;
     const int mGenerationSeed;
     const bool mHasSingleEntryPoint;
-    std::map<MapCoord, NodeData> mMapData;
+    
+    // Dense col-major grid of nodes, along with a bitmask of the occupied rows of each column
+    std::vector<NodeData> mNodes;
+    std::vector<uint32_t> mColumnNodeRowMasks;
+    
+    std::vector<strutils::StringId> mNodeSceneObjectNames;
+    std::vector<strutils::StringId> mPlanetRingSceneObjectNames;
+    std::vector<std::vector<strutils::StringId>> mPathSegmentSceneObjectNames;
 };
 
 
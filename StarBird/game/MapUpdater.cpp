@@ -43,7 +43,6 @@ static const std::unordered_map<Map::NodeType, Scene::SceneType> NODE_TYPE_TO_SC
 static const strutils::StringId CONFIRMATION_BUTTON_NAME = strutils::StringId("CONFIRMATION_BUTTON");
 static const strutils::StringId CONFIRMATION_BUTTON_TEXT_NAME = strutils::StringId("CONFIRMATION_BUTTON_TEXT");
 
-static const char* MAP_PATH_NAME_SUFFIX = "_PATH";
 static const char* CONFIRMATION_BUTTON_TEXTURE_FILE_NAME = "confirmation_button_mm.bmp";
 
 static const glm::vec3 CONFIRMATION_BUTTON_POSITION = glm::vec3(0.0f, -8.0f, 0.0f);
@@ -71,7 +70,7 @@ static const float MIN_CAMERA_VELOCITY_TO_START_MOVEMENT = 0.0001f;
 MapUpdater::MapUpdater(Scene& scene)
     : mScene(scene)
     , mStateMachine(&scene, nullptr, nullptr, nullptr)
-    , mMap(scene, GameSingletons::GetMapGenerationSeed(), glm::ivec2(9, 5), GameSingletons::GetCurrentMapCoord(), true)
+    , mMap(scene, GameSingletons::GetMapGenerationSeed(), game_constants::MAP_DIMENSIONS, GameSingletons::GetCurrentMapCoord(), true)
     , mSelectedMapCoord(MapCoord(0, 0))
     , mCurrentMapCoord(GameSingletons::GetCurrentMapCoord())
     , mLastInputContextEventType(0)
@@ -88,14 +87,26 @@ MapUpdater::MapUpdater(Scene& scene)
     auto& worldCamera = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::WorldGameObject)->get();
     
     // Center camera to the midpoint of all available nodes
-    glm::vec3 positionAccum = mMap.GetMapData().at(GameSingletons::GetCurrentMapCoord()).mPosition;
-    const auto& activeCoords = mMap.GetMapData().at(GameSingletons::GetCurrentMapCoord()).mNodeLinks;
-    for (auto& linkedCoord: activeCoords)
+    glm::vec3 positionAccum = mMap.GetNodeData(GameSingletons::GetCurrentMapCoord()).mPosition;
+    const auto& activeCoords = mMap.GetNodeData(GameSingletons::GetCurrentMapCoord()).mNodeLinks;
+    for (const auto& linkedCoord: activeCoords)
     {
-        positionAccum += mMap.GetMapData().at(linkedCoord).mPosition;
+        positionAccum += mMap.GetNodeData(linkedCoord).mPosition;
     }
     
     worldCamera.SetPosition(glm::vec3(positionAccum.x/(activeCoords.size() + 1), positionAccum.y/(activeCoords.size() + 1), 0.0f));
+    
+    // Only the reachable encounters' levels are generated ahead of time, in the background
+    std::vector<MapCoord> reachableEncounterCoords;
+    for (const auto& linkedCoord: activeCoords)
+    {
+        const auto linkedNodeType = mMap.GetNodeData(linkedCoord).mNodeType;
+        if (NODE_TYPE_TO_SCENE_TYPE.contains(linkedNodeType) && NODE_TYPE_TO_SCENE_TYPE.at(linkedNodeType) == Scene::SceneType::LEVEL)
+        {
+            reachableEncounterCoords.push_back(linkedCoord);
+        }
+    }
+    level_generation::PrefetchLevels(reachableEncounterCoords, mMap);
     worldCamera.SetZoomFactor(CAMERA_INIT_ZOOM_FACTOR);
     
     auto& resService = resources::ResourceLoadingService::GetInstance();
@@ -189,7 +200,7 @@ PostStateUpdateDirective MapUpdater::VUpdate(std::vector<SceneObject>& sceneObje
                     GameSingletons::SetCurrentMapCoord(mSelectedMapCoord);
                     mTransitioning = true;
                     
-                    auto selectedNodeType = mMap.GetMapData().at(mSelectedMapCoord).mNodeType;
+                    auto selectedNodeType = mMap.GetNodeData(mSelectedMapCoord).mNodeType;
                     
                     assert(NODE_TYPE_TO_SCENE_TYPE.contains(selectedNodeType));
                     auto nextSceneType = NODE_TYPE_TO_SCENE_TYPE.at(selectedNodeType);
@@ -200,7 +211,7 @@ PostStateUpdateDirective MapUpdater::VUpdate(std::vector<SceneObject>& sceneObje
                     }
                     else
                     {
-                        mScene.ChangeScene(Scene::TransitionParameters(nextSceneType, nextSceneType == Scene::SceneType::LEVEL ? (objectiveC_utils::BuildLocalFileSaveLocation(mSelectedMapCoord.ToString())) : "", true));
+                        mScene.ChangeScene(Scene::TransitionParameters(nextSceneType, nextSceneType == Scene::SceneType::LEVEL ? level_generation::GetOrGenerateLevel(mSelectedMapCoord, mMap.GetNodeData(mSelectedMapCoord)).mLevelName.GetString() : "", true));
                     }
                     
                     objectiveC_utils::PlaySound(sounds::BUTTON_PRESS_SFX);
@@ -412,9 +423,9 @@ void MapUpdater::VOpenSettingsMenu()
 bool MapUpdater::CheckForActiveLevelSelection(const glm::vec3& touchPos)
 {
     const auto& currentMapCoord = GameSingletons::GetCurrentMapCoord();
-    for (const auto& linkedMapCoord: mMap.GetMapData().at(currentMapCoord).mNodeLinks)
+    for (const auto& linkedMapCoord: mMap.GetNodeData(currentMapCoord).mNodeLinks)
     {
-        if (scene_object_utils::IsPointInsideSceneObject(mScene.GetSceneObject(strutils::StringId(linkedMapCoord.ToString()))->get(), glm::vec2(touchPos.x, touchPos.y)))
+        if (scene_object_utils::IsPointInsideSceneObject(mScene.GetSceneObject(mMap.GetNodeSceneObjectName(linkedMapCoord))->get(), glm::vec2(touchPos.x, touchPos.y)))
         {
             mSelectedMapCoord = linkedMapCoord;
             objectiveC_utils::PlaySound(sounds::WHOOSH_SFX);
@@ -429,8 +440,7 @@ bool MapUpdater::CheckForActiveLevelSelection(const glm::vec3& touchPos)
 
 void MapUpdater::OnLevelSelection()
 {
-    const auto& mapData = mMap.GetMapData();
-    const auto& previousMapNode = mapData.at(mCurrentMapCoord);
+    const auto& previousMapNode = mMap.GetNodeData(mCurrentMapCoord);
     
     auto& resService = resources::ResourceLoadingService::GetInstance();
     
@@ -438,8 +448,8 @@ void MapUpdater::OnLevelSelection()
     {
         if (linkedCoord == mSelectedMapCoord) continue;
         
-        auto nodeSoOpt = mScene.GetSceneObject(strutils::StringId(linkedCoord.ToString()));
-        auto nodeRingSoOpt = mScene.GetSceneObject(strutils::StringId("PLANET_RING_" + linkedCoord.ToString()));
+        auto nodeSoOpt = mScene.GetSceneObject(mMap.GetNodeSceneObjectName(linkedCoord));
+        auto nodeRingSoOpt = mScene.GetSceneObject(mMap.GetPlanetRingSceneObjectName(linkedCoord));
         
         if (nodeSoOpt)
         {
@@ -467,11 +477,8 @@ void MapUpdater::OnLevelSelection()
             }
         }
         
-        glm::vec3 dirToNext = mapData.at(linkedCoord).mPosition - previousMapNode.mPosition;
-        auto pathSegments = 2 * static_cast<int>(glm::length(dirToNext));
-        for (int i = 0; i < pathSegments; ++i)
+        for (const auto& pathSegmentName: mMap.GetPathSegmentSceneObjectNames(mCurrentMapCoord, linkedCoord))
         {
-            auto pathSegmentName = strutils::StringId(mCurrentMapCoord.ToString() + "-" + linkedCoord.ToString() + "_" + std::to_string(i) + MAP_PATH_NAME_SUFFIX);
             auto pathSegmentSoOpt = mScene.GetSceneObject(pathSegmentName);
             if (pathSegmentSoOpt)
             {
@@ -487,8 +494,7 @@ void MapUpdater::OnLevelSelection()
 
 void MapUpdater::OnLevelDeselection()
 {
-    const auto& mapData = mMap.GetMapData();
-    const auto& previousMapNode = mapData.at(mCurrentMapCoord);
+    const auto& previousMapNode = mMap.GetNodeData(mCurrentMapCoord);
     
     auto& resService = resources::ResourceLoadingService::GetInstance();
     
@@ -496,8 +502,8 @@ void MapUpdater::OnLevelDeselection()
     {
         if (linkedCoord == mSelectedMapCoord) continue;
         
-        auto nodeSoOpt = mScene.GetSceneObject(strutils::StringId(linkedCoord.ToString()));
-        auto nodeRingSoOpt = mScene.GetSceneObject(strutils::StringId("PLANET_RING_" + linkedCoord.ToString()));
+        auto nodeSoOpt = mScene.GetSceneObject(mMap.GetNodeSceneObjectName(linkedCoord));
+        auto nodeRingSoOpt = mScene.GetSceneObject(mMap.GetPlanetRingSceneObjectName(linkedCoord));
         
         if (nodeSoOpt)
         {
@@ -505,7 +511,7 @@ void MapUpdater::OnLevelDeselection()
             
             nodeSo.mAnimation->VResume();
             
-            switch (mapData.at(linkedCoord).mNodeType)
+            switch (mMap.GetNodeData(linkedCoord).mNodeType)
             {
                 case Map::NodeType::NORMAL_ENCOUNTER:
                 case Map::NodeType::HARD_ENCOUNTER:
@@ -542,11 +548,8 @@ void MapUpdater::OnLevelDeselection()
             }
         }
         
-        glm::vec3 dirToNext = mapData.at(linkedCoord).mPosition - previousMapNode.mPosition;
-        auto pathSegments = 2 * static_cast<int>(glm::length(dirToNext));
-        for (int i = 0; i < pathSegments; ++i)
+        for (const auto& pathSegmentName: mMap.GetPathSegmentSceneObjectNames(mCurrentMapCoord, linkedCoord))
         {
-            auto pathSegmentName = strutils::StringId(mCurrentMapCoord.ToString() + "-" + linkedCoord.ToString() + "_" + std::to_string(i) + MAP_PATH_NAME_SUFFIX);
             auto pathSegmentSoOpt = mScene.GetSceneObject(pathSegmentName);
             if (pathSegmentSoOpt)
             {
@@ -610,8 +613,8 @@ void MapUpdater::OnEventNodeSelected()
             
         case 1:
         {
-            level_generation::GenerateLevel(mSelectedMapCoord, mMap.GetMapData().at(mSelectedMapCoord));
-            mScene.ChangeScene(Scene::TransitionParameters(Scene::SceneType::LEVEL, objectiveC_utils::BuildLocalFileSaveLocation(mSelectedMapCoord.ToString()), true));
+            const auto& levelDef = level_generation::GetOrGenerateLevel(mSelectedMapCoord, mMap.GetNodeData(mSelectedMapCoord));
+            mScene.ChangeScene(Scene::TransitionParameters(Scene::SceneType::LEVEL, levelDef.mLevelName.GetString(), true));
         } break;
             
         case 2:
@@ -5,6 +5,7 @@
 ///  Created by Alex Koukoulas on 24/04/2023                                                       
 ///------------------------------------------------------------------------------------------------
 
+#include "../utils/Logging.h"
 #include "../utils/ObjectiveCUtils.h"
 #include "../utils/OSMessageBox.h"
 #include "../utils/MathUtils.h"
@@ -17,8 +18,22 @@
 #include "datarepos/ObjectTypeDefinitionRepository.h"
 
 #include <rapidxml/rapidxml.hpp>
+#include <SDL.h>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
 #include <fstream>
+#include <iterator>
+#include <mutex>
+#include <optional>
 #include <sstream>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
 ///------------------------------------------------------------------------------------------------
 
@@ -28,17 +43,711 @@ namespace persistence_utils
 ///------------------------------------------------------------------------------------------------
 
 static const char* PROGRESS_SAVE_FILE_NAME = "progress_save";
+static const std::string BINARY_SAVE_FILE_EXTENSION = ".bin";
+static const std::string XML_SAVE_FILE_EXTENSION = ".xml";
+static const std::string TEMPORARY_SAVE_FILE_EXTENSION = ".tmp";
+
+static const uint32_t BINARY_SAVE_MAGIC = 0x56534253; // "SBSV"
+static const uint16_t BINARY_SAVE_VERSION = 1;
+static const uint32_t FNV_OFFSET_BASIS = 2166136261u;
+static const uint32_t FNV_PRIME = 16777619u;
+
+///------------------------------------------------------------------------------------------------
+
+// The binary save is made up of sections that are encoded (and checksummed) independently, so that
+// saving only needs to re-encode the sections whose contents changed since the previous save
+enum class SaveSection: uint16_t
+{
+    MAP_PROGRESS,
+    PLAYER_STATS,
+    EQUIPPED_UPGRADES,
+    AVAILABLE_UPGRADES,
+    SEEN_EVENTS,
+    COUNT
+};
+
+static constexpr size_t SAVE_SECTION_COUNT = static_cast<size_t>(SaveSection::COUNT);
+
+///------------------------------------------------------------------------------------------------
+
+static uint32_t CalculateChecksum(const unsigned char* data, const size_t dataSize, uint32_t checksum = FNV_OFFSET_BASIS)
+{
+    for (size_t i = 0; i < dataSize; ++i)
+    {
+        checksum ^= data[i];
+        checksum *= FNV_PRIME;
+    }
+    return checksum;
+}
+
+///------------------------------------------------------------------------------------------------
+
+template<class T>
+static void WriteValue(const T& value, std::vector<unsigned char>& outData)
+{
+    const auto* valueBytes = reinterpret_cast<const unsigned char*>(&value);
+    outData.insert(outData.end(), valueBytes, valueBytes + sizeof(T));
+}
+
+///------------------------------------------------------------------------------------------------
+
+template<class T>
+static bool ReadValue(const unsigned char*& cursor, const unsigned char* end, T& outValue)
+{
+    if (static_cast<size_t>(end - cursor) < sizeof(T))
+    {
+        return false;
+    }
+    
+    std::memcpy(&outValue, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static bool ReadString(const unsigned char*& cursor, const unsigned char* end, strutils::StringId& outString)
+{
+    uint16_t stringLength = 0;
+    if (!ReadValue(cursor, end, stringLength) || static_cast<size_t>(end - cursor) < stringLength)
+    {
+        return false;
+    }
+    
+    outString = strutils::StringId(std::string(reinterpret_cast<const char*>(cursor), stringLength));
+    cursor += stringLength;
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+/// Writes section values out in their binary form.
+class SectionEncoder
+{
+public:
+    SectionEncoder(std::vector<unsigned char>& outData) : mData(outData) {}
+    
+    template<class T>
+    void Value(const T& value) { WriteValue(value, mData); }
+    
+    void String(const strutils::StringId& string)
+    {
+        const auto& stringValue = string.GetString();
+        WriteValue(static_cast<uint16_t>(stringValue.size()), mData);
+        mData.insert(mData.end(), stringValue.begin(), stringValue.end());
+    }
+    
+private:
+    std::vector<unsigned char>& mData;
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// Cheaply hashes the same values a SectionEncoder would write (strings through their precomputed
+/// ids), to find out whether a section needs re-encoding at all.
+class SectionFingerprinter
+{
+public:
+    template<class T>
+    void Value(const T& value)
+    {
+        const auto* valueBytes = reinterpret_cast<const unsigned char*>(&value);
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            mFingerprint = (mFingerprint ^ valueBytes[i]) * 1099511628211ull;
+        }
+    }
+    
+    void String(const strutils::StringId& string) { Value(static_cast<uint64_t>(string.GetStringId())); }
+    
+    uint64_t GetFingerprint() const { return mFingerprint; }
+    
+private:
+    uint64_t mFingerprint = 14695981039346656037ull;
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// Flat, self contained copy of the persisted progress. Captured on the main thread for the save worker
+/// to encode, and staged when loading so that nothing gets applied unless the whole save file checks out.
+struct ProgressSnapshot
+{
+    int32_t mSeed = 0;
+    int32_t mMapCoordCol = 0;
+    int32_t mMapCoordRow = 0;
+    int32_t mMapLevel = 0;
+    uint8_t mErasedLabsOnCurrentMap = 0;
+    uint8_t mAccelerometerControl = 0;
+    int32_t mResearchCostMultiplier = 1;
+    float mPlayerMaxHealth = 0.0f;
+    float mPlayerCurrentHealth = 0.0f;
+    float mPlayerAttackStat = 0.0f;
+    float mPlayerMovementSpeedStat = 0.0f;
+    float mPlayerBulletSpeedStat = 0.0f;
+    float mPlayerShieldHealth = 0.0f;
+    int64_t mCrystalCount = 0;
+    std::vector<strutils::StringId> mEquippedUpgradeNames;
+    struct AvailableUpgradeProgress
+    {
+        strutils::StringId mUpgradeName;
+        int32_t mCrystalUnlockProgress;
+        uint8_t mUnlocked;
+    };
+    std::vector<AvailableUpgradeProgress> mAvailableUpgradeProgress;
+    std::vector<uint32_t> mSeenEventIndices; // sorted, so that the same set always encodes the same way
+};
+
+///------------------------------------------------------------------------------------------------
+
+static ProgressSnapshot CaptureProgressSnapshot()
+{
+    ProgressSnapshot snapshot;
+    snapshot.mSeed = GameSingletons::GetMapGenerationSeed();
+    snapshot.mMapCoordCol = GameSingletons::GetCurrentMapCoord().mCol;
+    snapshot.mMapCoordRow = GameSingletons::GetCurrentMapCoord().mRow;
+    snapshot.mMapLevel = GameSingletons::GetMapLevel();
+    snapshot.mErasedLabsOnCurrentMap = GameSingletons::GetErasedLabsOnCurrentMap();
+    snapshot.mAccelerometerControl = GameSingletons::GetAccelerometerControl();
+    snapshot.mResearchCostMultiplier = GameSingletons::GetResearchCostMultiplier();
+    snapshot.mPlayerMaxHealth = GameSingletons::GetPlayerMaxHealth();
+    snapshot.mPlayerCurrentHealth = GameSingletons::GetPlayerCurrentHealth();
+    snapshot.mPlayerAttackStat = GameSingletons::GetPlayerAttackStat();
+    snapshot.mPlayerMovementSpeedStat = GameSingletons::GetPlayerMovementSpeedStat();
+    snapshot.mPlayerBulletSpeedStat = GameSingletons::GetPlayerBulletSpeedStat();
+    snapshot.mPlayerShieldHealth = GameSingletons::GetPlayerShieldHealth();
+    snapshot.mCrystalCount = GameSingletons::GetCrystalCount();
+    
+    for (const auto& equippedUpgrade: GameSingletons::GetEquippedUpgrades())
+    {
+        snapshot.mEquippedUpgradeNames.push_back(equippedUpgrade.mUpgradeNameId);
+    }
+    
+    for (const auto& availableUpgrade: GameSingletons::GetAvailableUpgrades())
+    {
+        snapshot.mAvailableUpgradeProgress.push_back({ availableUpgrade.mUpgradeNameId, static_cast<int32_t>(availableUpgrade.mCrystalUnlockProgress), static_cast<uint8_t>(availableUpgrade.mUnlocked) });
+    }
+    
+    const auto& seenEventIndices = GameSingletons::GetSeenEventIndices();
+    snapshot.mSeenEventIndices.assign(seenEventIndices.begin(), seenEventIndices.end());
+    std::sort(snapshot.mSeenEventIndices.begin(), snapshot.mSeenEventIndices.end());
+    
+    return snapshot;
+}
+
+///------------------------------------------------------------------------------------------------
+
+template<class SerializerT>
+static void SerializeSection(const SaveSection section, const ProgressSnapshot& snapshot, SerializerT& serializer)
+{
+    switch (section)
+    {
+        case SaveSection::MAP_PROGRESS:
+        {
+            serializer.Value(snapshot.mSeed);
+            serializer.Value(snapshot.mMapCoordCol);
+            serializer.Value(snapshot.mMapCoordRow);
+            serializer.Value(snapshot.mMapLevel);
+            serializer.Value(snapshot.mErasedLabsOnCurrentMap);
+            serializer.Value(snapshot.mAccelerometerControl);
+            serializer.Value(snapshot.mResearchCostMultiplier);
+        } break;
+            
+        case SaveSection::PLAYER_STATS:
+        {
+            serializer.Value(snapshot.mPlayerMaxHealth);
+            serializer.Value(snapshot.mPlayerCurrentHealth);
+            serializer.Value(snapshot.mPlayerAttackStat);
+            serializer.Value(snapshot.mPlayerMovementSpeedStat);
+            serializer.Value(snapshot.mPlayerBulletSpeedStat);
+            serializer.Value(snapshot.mPlayerShieldHealth);
+            serializer.Value(snapshot.mCrystalCount);
+        } break;
+            
+        case SaveSection::EQUIPPED_UPGRADES:
+        {
+            serializer.Value(static_cast<uint16_t>(snapshot.mEquippedUpgradeNames.size()));
+            for (const auto& upgradeName: snapshot.mEquippedUpgradeNames)
+            {
+                serializer.String(upgradeName);
+            }
+        } break;
+            
+        case SaveSection::AVAILABLE_UPGRADES:
+        {
+            serializer.Value(static_cast<uint16_t>(snapshot.mAvailableUpgradeProgress.size()));
+            for (const auto& upgradeProgress: snapshot.mAvailableUpgradeProgress)
+            {
+                serializer.String(upgradeProgress.mUpgradeName);
+                serializer.Value(upgradeProgress.mCrystalUnlockProgress);
+                serializer.Value(upgradeProgress.mUnlocked);
+            }
+        } break;
+            
+        case SaveSection::SEEN_EVENTS:
+        {
+            serializer.Value(static_cast<uint32_t>(snapshot.mSeenEventIndices.size()));
+            for (const auto seenEventIndex: snapshot.mSeenEventIndices)
+            {
+                serializer.Value(seenEventIndex);
+            }
+        } break;
+            
+        case SaveSection::COUNT: break;
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+static bool DecodeSection(const SaveSection section, const unsigned char* cursor, const unsigned char* end, ProgressSnapshot& outProgress)
+{
+    switch (section)
+    {
+        case SaveSection::MAP_PROGRESS:
+        {
+            if (!ReadValue(cursor, end, outProgress.mSeed) ||
+                !ReadValue(cursor, end, outProgress.mMapCoordCol) ||
+                !ReadValue(cursor, end, outProgress.mMapCoordRow) ||
+                !ReadValue(cursor, end, outProgress.mMapLevel) ||
+                !ReadValue(cursor, end, outProgress.mErasedLabsOnCurrentMap) ||
+                !ReadValue(cursor, end, outProgress.mAccelerometerControl) ||
+                !ReadValue(cursor, end, outProgress.mResearchCostMultiplier))
+            {
+                return false;
+            }
+        } break;
+            
+        case SaveSection::PLAYER_STATS:
+        {
+            if (!ReadValue(cursor, end, outProgress.mPlayerMaxHealth) ||
+                !ReadValue(cursor, end, outProgress.mPlayerCurrentHealth) ||
+                !ReadValue(cursor, end, outProgress.mPlayerAttackStat) ||
+                !ReadValue(cursor, end, outProgress.mPlayerMovementSpeedStat) ||
+                !ReadValue(cursor, end, outProgress.mPlayerBulletSpeedStat) ||
+                !ReadValue(cursor, end, outProgress.mPlayerShieldHealth) ||
+                !ReadValue(cursor, end, outProgress.mCrystalCount))
+            {
+                return false;
+            }
+        } break;
+            
+        case SaveSection::EQUIPPED_UPGRADES:
+        {
+            uint16_t upgradeCount = 0;
+            if (!ReadValue(cursor, end, upgradeCount)) return false;
+            
+            outProgress.mEquippedUpgradeNames.resize(upgradeCount);
+            for (auto& upgradeName: outProgress.mEquippedUpgradeNames)
+            {
+                if (!ReadString(cursor, end, upgradeName)) return false;
+            }
+        } break;
+            
+        case SaveSection::AVAILABLE_UPGRADES:
+        {
+            uint16_t upgradeCount = 0;
+            if (!ReadValue(cursor, end, upgradeCount)) return false;
+            
+            outProgress.mAvailableUpgradeProgress.resize(upgradeCount);
+            for (auto& upgradeProgress: outProgress.mAvailableUpgradeProgress)
+            {
+                if (!ReadString(cursor, end, upgradeProgress.mUpgradeName) ||
+                    !ReadValue(cursor, end, upgradeProgress.mCrystalUnlockProgress) ||
+                    !ReadValue(cursor, end, upgradeProgress.mUnlocked))
+                {
+                    return false;
+                }
+            }
+        } break;
+            
+        case SaveSection::SEEN_EVENTS:
+        {
+            uint32_t seenEventCount = 0;
+            if (!ReadValue(cursor, end, seenEventCount) || static_cast<size_t>(end - cursor) / sizeof(uint32_t) < seenEventCount) return false;
+            
+            outProgress.mSeenEventIndices.resize(seenEventCount);
+            for (auto& seenEventIndex: outProgress.mSeenEventIndices)
+            {
+                if (!ReadValue(cursor, end, seenEventIndex)) return false;
+            }
+        } break;
+            
+        case SaveSection::COUNT: return false;
+    }
+    
+    return cursor == end;
+}
+
+///------------------------------------------------------------------------------------------------
+
+/// Validates the whole binary save (magic, version, file and section checksums) before decoding any of it.
+static bool DecodeBinarySave(const std::vector<unsigned char>& saveData, ProgressSnapshot& outProgress)
+{
+    const auto* cursor = saveData.data();
+    const auto* end = saveData.data() + saveData.size();
+    
+    uint32_t magic = 0, fileChecksum = 0;
+    uint16_t version = 0, sectionCount = 0;
+    if (!ReadValue(cursor, end, magic) || magic != BINARY_SAVE_MAGIC ||
+        !ReadValue(cursor, end, version) || version != BINARY_SAVE_VERSION ||
+        !ReadValue(cursor, end, sectionCount) ||
+        !ReadValue(cursor, end, fileChecksum) ||
+        CalculateChecksum(cursor, end - cursor) != fileChecksum)
+    {
+        return false;
+    }
+    
+    std::array<bool, SAVE_SECTION_COUNT> decodedSections = {};
+    for (uint16_t i = 0; i < sectionCount; ++i)
+    {
+        uint16_t sectionId = 0;
+        uint32_t sectionSize = 0, sectionChecksum = 0;
+        if (!ReadValue(cursor, end, sectionId) ||
+            !ReadValue(cursor, end, sectionSize) ||
+            !ReadValue(cursor, end, sectionChecksum) ||
+            static_cast<size_t>(end - cursor) < sectionSize ||
+            CalculateChecksum(cursor, sectionSize) != sectionChecksum)
+        {
+            return false;
+        }
+        
+        // Sections unknown to this version are skipped over
+        if (sectionId < SAVE_SECTION_COUNT)
+        {
+            if (!DecodeSection(static_cast<SaveSection>(sectionId), cursor, cursor + sectionSize, outProgress)) return false;
+            decodedSections[sectionId] = true;
+        }
+        
+        cursor += sectionSize;
+    }
+    
+    return std::all_of(decodedSections.cbegin(), decodedSections.cend(), [](const bool decoded){ return decoded; });
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void ApplyProgressSnapshot(const ProgressSnapshot& progress)
+{
+    GameSingletons::SetMapGenerationSeed(progress.mSeed);
+    GameSingletons::SetBackgroundIndex(GameSingletons::GetMapGenerationSeed() % game_constants::BACKGROUND_COUNT);
+    GameSingletons::SetCurrentMapCoord(MapCoord(progress.mMapCoordCol, progress.mMapCoordRow));
+    GameSingletons::SetMapLevel(progress.mMapLevel);
+    GameSingletons::SetErasedLabsOnCurrentMap(progress.mErasedLabsOnCurrentMap != 0);
+    GameSingletons::SetAccelerometerControl(progress.mAccelerometerControl != 0);
+    GameSingletons::SetResearchCostMultiplier(progress.mResearchCostMultiplier);
+    
+    GameSingletons::SetPlayerMaxHealth(progress.mPlayerMaxHealth);
+    GameSingletons::SetPlayerCurrentHealth(progress.mPlayerCurrentHealth);
+    GameSingletons::SetPlayerDisplayedHealth(progress.mPlayerCurrentHealth);
+    GameSingletons::SetPlayerAttackStat(progress.mPlayerAttackStat);
+    GameSingletons::SetPlayerMovementSpeedStat(progress.mPlayerMovementSpeedStat);
+    GameSingletons::SetPlayerBulletSpeedStat(progress.mPlayerBulletSpeedStat);
+    GameSingletons::SetPlayerShieldHealth(progress.mPlayerShieldHealth);
+    GameSingletons::SetCrystalCount(static_cast<long>(progress.mCrystalCount));
+    
+    auto& equippedUpgrades = GameSingletons::GetEquippedUpgrades();
+    auto& availableUpgrades = GameSingletons::GetAvailableUpgrades();
+    for (const auto& upgradeNameId: progress.mEquippedUpgradeNames)
+    {
+        const auto availableUpgradeIter = std::find_if(availableUpgrades.begin(), availableUpgrades.end(), [&](const UpgradeDefinition& upgradeDefinition){ return upgradeDefinition.mUpgradeNameId == upgradeNameId; });
+        
+        if (availableUpgradeIter == availableUpgrades.end())
+        {
+            ospopups::ShowMessageBox(ospopups::MessageBoxType::WARNING, "Unknown upgrade", "Unknown equipped upgrade name " + upgradeNameId.GetString() + " found in save file. Ignoring");
+            continue;
+        }
+        
+        equippedUpgrades.push_back(*availableUpgradeIter);
+        
+        if (availableUpgradeIter->mIntransient == false)
+        {
+            availableUpgrades.erase(availableUpgradeIter);
+        }
+    }
+    
+    for (const auto& upgradeProgress: progress.mAvailableUpgradeProgress)
+    {
+        const auto availableUpgradeIter = std::find_if(availableUpgrades.begin(), availableUpgrades.end(), [&](const UpgradeDefinition& upgradeDefinition){ return upgradeDefinition.mUpgradeNameId == upgradeProgress.mUpgradeName; });
+        
+        if (availableUpgradeIter == availableUpgrades.end())
+        {
+            ospopups::ShowMessageBox(ospopups::MessageBoxType::WARNING, "Unknown upgrade", "Unknown upgrade name " + upgradeProgress.mUpgradeName.GetString() + " found in save file. Ignoring");
+        }
+        else
+        {
+            availableUpgradeIter->mCrystalUnlockProgress = upgradeProgress.mCrystalUnlockProgress;
+            availableUpgradeIter->mUnlocked = upgradeProgress.mUnlocked != 0;
+        }
+    }
+    
+    auto& seenEventIndices = GameSingletons::GetSeenEventIndices();
+    seenEventIndices.insert(progress.mSeenEventIndices.begin(), progress.mSeenEventIndices.end());
+}
+
+///------------------------------------------------------------------------------------------------
+
+/// Writes the contents to a temporary file first, which is synced to disk and then replaces the target file
+/// in one go. A crash (or the app getting killed) mid-write can therefore only ever lose the temporary file,
+/// never the save.
+bool WriteFileAtomically(const std::string& filePath, const unsigned char* data, const size_t dataSize)
+{
+    const auto temporaryFilePath = filePath + TEMPORARY_SAVE_FILE_EXTENSION;
+    
+    const auto fileDescriptor = open(temporaryFilePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    auto writeSucceeded = fileDescriptor >= 0;
+    
+    size_t bytesWritten = 0;
+    while (writeSucceeded && bytesWritten < dataSize)
+    {
+        const auto result = write(fileDescriptor, data + bytesWritten, dataSize - bytesWritten);
+        writeSucceeded = result > 0 || (result < 0 && errno == EINTR);
+        bytesWritten += result > 0 ? result : 0;
+    }
+    
+    writeSucceeded = writeSucceeded && fsync(fileDescriptor) == 0;
+    if (fileDescriptor >= 0)
+    {
+        writeSucceeded = close(fileDescriptor) == 0 && writeSucceeded;
+    }
+    
+    if (!writeSucceeded || std::rename(temporaryFilePath.c_str(), filePath.c_str()) != 0)
+    {
+        Log(LogType::ERROR, "Could not write %s", filePath.c_str());
+        std::remove(temporaryFilePath.c_str());
+        return false;
+    }
+    
+    // Make the rename itself durable too
+    const auto directoryDescriptor = open(filePath.substr(0, filePath.rfind('/') + 1).c_str(), O_RDONLY);
+    if (directoryDescriptor >= 0)
+    {
+        fsync(directoryDescriptor);
+        close(directoryDescriptor);
+    }
+    
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+/// Encodes and writes binary saves on a thread of its own, so that no save file I/O happens on the main
+/// thread. Save requests hand over an immutable snapshot of the progress, and a request made while another
+/// is still waiting replaces it, so bursts of saves are coalesced in to writing just the latest progress.
+/// The encoded sections (and the file state) are only ever touched by the worker thread.
+class ProgressSaveWorker final
+{
+public:
+    static ProgressSaveWorker& GetInstance()
+    {
+        static ProgressSaveWorker instance;
+        return instance;
+    }
+    
+    ~ProgressSaveWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mShuttingDown = true;
+        }
+        mConditionVariable.notify_all();
+        
+        if (mThread.joinable())
+        {
+            mThread.join();
+        }
+    }
+    
+    ProgressSaveWorker(const ProgressSaveWorker&) = delete;
+    ProgressSaveWorker(ProgressSaveWorker&&) = delete;
+    const ProgressSaveWorker& operator = (const ProgressSaveWorker&) = delete;
+    ProgressSaveWorker& operator = (ProgressSaveWorker&&) = delete;
+    
+    void RequestSave(ProgressSnapshot&& snapshot, const std::string& saveFilePath)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mPendingSnapshot)
+            {
+                mCoalescedRequestCount++;
+            }
+            
+            mPendingSnapshot = std::move(snapshot);
+            mSaveFilePath = saveFilePath;
+            
+            if (!mThread.joinable())
+            {
+                mThread = std::thread(&ProgressSaveWorker::WorkerLoop, this);
+            }
+        }
+        mConditionVariable.notify_all();
+    }
+    
+    /// Blocks until all requested saves have made it to disk.
+    void Flush()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mConditionVariable.wait(lock, [this](){ return !mPendingSnapshot && !mSaving; });
+    }
+    
+    /// Makes the next save re-encode all sections and rewrite the file, e.g. after loading a save from disk.
+    void InvalidateEncodedSections()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEncodedSectionsInvalidated = true;
+    }
+    
+private:
+    struct EncodedSection
+    {
+        std::vector<unsigned char> mData;
+        uint64_t mFingerprint = 0;
+        uint32_t mChecksum = 0;
+        bool mValid = false;
+    };
+    
+    ProgressSaveWorker() = default;
+    
+    void WorkerLoop()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true)
+        {
+            mConditionVariable.wait(lock, [this](){ return mPendingSnapshot || mShuttingDown; });
+            if (!mPendingSnapshot)
+            {
+                return;
+            }
+            
+            auto snapshot = std::move(*mPendingSnapshot);
+            mPendingSnapshot.reset();
+            
+            const auto saveFilePath = mSaveFilePath;
+            const auto coalescedRequestCount = mCoalescedRequestCount;
+            const auto encodedSectionsInvalidated = mEncodedSectionsInvalidated;
+            mCoalescedRequestCount = 0;
+            mEncodedSectionsInvalidated = false;
+            mSaving = true;
+            lock.unlock();
+            
+            if (encodedSectionsInvalidated)
+            {
+                for (auto& encodedSection: mEncodedSections) encodedSection.mValid = false;
+                mSaveFileUpToDate = false;
+            }
+            
+            const auto saveStartCounter = SDL_GetPerformanceCounter();
+            if (Save(snapshot, saveFilePath))
+            {
+                Log(LogType::INFO, "Saved progress in %.3f millis (%d earlier requests coalesced)", (SDL_GetPerformanceCounter() - saveStartCounter) * 1000.0/SDL_GetPerformanceFrequency(), static_cast<int>(coalescedRequestCount));
+            }
+            
+            lock.lock();
+            mSaving = false;
+            mConditionVariable.notify_all();
+        }
+    }
+    
+    /// @returns whether anything was written.
+    bool Save(const ProgressSnapshot& snapshot, const std::string& saveFilePath)
+    {
+        // Only sections whose fingerprint changed since they were last encoded get re-encoded
+        auto anySectionChanged = false;
+        for (size_t i = 0; i < SAVE_SECTION_COUNT; ++i)
+        {
+            const auto section = static_cast<SaveSection>(i);
+            auto& encodedSection = mEncodedSections[i];
+            
+            SectionFingerprinter fingerprinter;
+            SerializeSection(section, snapshot, fingerprinter);
+            
+            if (encodedSection.mValid && encodedSection.mFingerprint == fingerprinter.GetFingerprint())
+            {
+                continue;
+            }
+            
+            encodedSection.mData.clear();
+            SectionEncoder encoder(encodedSection.mData);
+            SerializeSection(section, snapshot, encoder);
+            
+            encodedSection.mFingerprint = fingerprinter.GetFingerprint();
+            encodedSection.mChecksum = CalculateChecksum(encodedSection.mData.data(), encodedSection.mData.size());
+            encodedSection.mValid = true;
+            anySectionChanged = true;
+        }
+        
+        if (!anySectionChanged && mSaveFileUpToDate)
+        {
+            return false;
+        }
+        
+        std::vector<unsigned char> sectionTable;
+        for (size_t i = 0; i < SAVE_SECTION_COUNT; ++i)
+        {
+            const auto& encodedSection = mEncodedSections[i];
+            WriteValue(static_cast<uint16_t>(i), sectionTable);
+            WriteValue(static_cast<uint32_t>(encodedSection.mData.size()), sectionTable);
+            WriteValue(encodedSection.mChecksum, sectionTable);
+            sectionTable.insert(sectionTable.end(), encodedSection.mData.begin(), encodedSection.mData.end());
+        }
+        
+        std::vector<unsigned char> saveData;
+        saveData.reserve(sizeof(uint32_t) * 2 + sizeof(uint16_t) * 2 + sectionTable.size());
+        WriteValue(BINARY_SAVE_MAGIC, saveData);
+        WriteValue(BINARY_SAVE_VERSION, saveData);
+        WriteValue(static_cast<uint16_t>(SAVE_SECTION_COUNT), saveData);
+        WriteValue(CalculateChecksum(sectionTable.data(), sectionTable.size()), saveData);
+        saveData.insert(saveData.end(), sectionTable.begin(), sectionTable.end());
+        
+        mSaveFileUpToDate = WriteFileAtomically(saveFilePath, saveData.data(), saveData.size());
+        return mSaveFileUpToDate;
+    }
+    
+private:
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mConditionVariable;
+    std::optional<ProgressSnapshot> mPendingSnapshot;
+    std::string mSaveFilePath;
+    size_t mCoalescedRequestCount = 0;
+    bool mEncodedSectionsInvalidated = false;
+    bool mSaving = false;
+    bool mShuttingDown = false;
+    
+    std::array<EncodedSection, SAVE_SECTION_COUNT> mEncodedSections;
+    bool mSaveFileUpToDate = false;
+};
+
+///------------------------------------------------------------------------------------------------
+
+static void ResetUpgradesAndEvents()
+{
+    UpgradesLoader loader;
+    const auto& allUpgrades = loader.LoadAllUpgrades();
+    
+    std::vector<UpgradeDefinition> availableUpgrades;
+    std::vector<UpgradeDefinition> eventOnlyUpgrades;
+    
+    std::copy_if(allUpgrades.begin(), allUpgrades.end(), std::back_inserter(availableUpgrades), [](const UpgradeDefinition& def) { return def.mEventOnly == false; });
+    std::copy_if(allUpgrades.begin(), allUpgrades.end(), std::back_inserter(eventOnlyUpgrades), [](const UpgradeDefinition& def) { return def.mEventOnly == true; });
+    
+    GameSingletons::SetAvailableUpgrades(availableUpgrades);
+    GameSingletons::SetEventOnlyUpgrades(eventOnlyUpgrades);
+    GameSingletons::GetEquippedUpgrades().clear();
+    GameSingletons::GetSeenEventIndices().clear();
+}
 
 ///------------------------------------------------------------------------------------------------
 
 bool ProgressSaveFileExists()
 {
-    return std::ifstream(objectiveC_utils::BuildLocalFileSaveLocation(PROGRESS_SAVE_FILE_NAME + std::string(".xml"))).good();
+    return std::ifstream(objectiveC_utils::BuildLocalFileSaveLocation(PROGRESS_SAVE_FILE_NAME + BINARY_SAVE_FILE_EXTENSION)).good() ||
+           std::ifstream(objectiveC_utils::BuildLocalFileSaveLocation(PROGRESS_SAVE_FILE_NAME + XML_SAVE_FILE_EXTENSION)).good();
 }
 
 ///------------------------------------------------------------------------------------------------
 
-void LoadFromProgressSaveFile()
+/// Loads the XML form of the progress save on top of the current progress.
+/// @returns false if the save file was found to be corrupted.
+static bool LoadFromProgressSaveXmlFile()
 {
     class ProgressLoader: public BaseGameDataLoader
     {
@@ -54,7 +763,7 @@ void LoadFromProgressSaveFile()
                 auto* seedValue = node->first_attribute("value");
                 if (seedValue)
                 {
-                    GameSingletons::SetMapGenerationSeed(std::stoi(seedValue->value()));
+                    GameSingletons::SetMapGenerationSeed(strutils::StringToInt(seedValue->value()));
                     GameSingletons::SetBackgroundIndex(GameSingletons::GetMapGenerationSeed() % game_constants::BACKGROUND_COUNT);
                     
                     if (GameSingletons::GetMapGenerationSeed() == 0)
@@ -71,13 +780,13 @@ void LoadFromProgressSaveFile()
                 auto* colValue = node->first_attribute("col");
                 if (colValue)
                 {
-                    GameSingletons::SetCurrentMapCoord(MapCoord(std::stoi(colValue->value()), GameSingletons::GetCurrentMapCoord().mRow));
+                    GameSingletons::SetCurrentMapCoord(MapCoord(strutils::StringToInt(colValue->value()), GameSingletons::GetCurrentMapCoord().mRow));
                 }
                 
                 auto* rowValue = node->first_attribute("row");
                 if (rowValue)
                 {
-                    GameSingletons::SetCurrentMapCoord(MapCoord(GameSingletons::GetCurrentMapCoord().mCol, std::stoi(rowValue->value())));
+                    GameSingletons::SetCurrentMapCoord(MapCoord(GameSingletons::GetCurrentMapCoord().mCol, strutils::StringToInt(rowValue->value())));
                 }
             });
             
@@ -88,7 +797,7 @@ void LoadFromProgressSaveFile()
                 auto* mapLevel = node->first_attribute("level");
                 if (mapLevel)
                 {
-                    GameSingletons::SetMapLevel(std::stoi(mapLevel->value()));
+                    GameSingletons::SetMapLevel(strutils::StringToInt(mapLevel->value()));
                 }
             });
             
@@ -121,7 +830,7 @@ void LoadFromProgressSaveFile()
                 auto* value = node->first_attribute("value");
                 if (value)
                 {
-                    GameSingletons::SetResearchCostMultiplier(std::stoi(value->value()));
+                    GameSingletons::SetResearchCostMultiplier(strutils::StringToInt(value->value()));
                 }
             });
                                                    
@@ -132,38 +841,38 @@ void LoadFromProgressSaveFile()
                 auto* maxHealth = node->first_attribute("maxHealth");
                 if (maxHealth)
                 {
-                    GameSingletons::SetPlayerMaxHealth(std::stof(maxHealth->value()));
+                    GameSingletons::SetPlayerMaxHealth(strutils::StringToFloat(maxHealth->value()));
                 }
                 
                 auto* health = node->first_attribute("health");
                 if (health)
                 {
-                    GameSingletons::SetPlayerCurrentHealth(std::stof(health->value()));
-                    GameSingletons::SetPlayerDisplayedHealth(std::stof(health->value()));
+                    GameSingletons::SetPlayerCurrentHealth(strutils::StringToFloat(health->value()));
+                    GameSingletons::SetPlayerDisplayedHealth(strutils::StringToFloat(health->value()));
                 }
                 
                 auto* attack = node->first_attribute("attack");
                 if (attack)
                 {
-                    GameSingletons::SetPlayerAttackStat(std::stof(attack->value()));
+                    GameSingletons::SetPlayerAttackStat(strutils::StringToFloat(attack->value()));
                 }
                 
                 auto* movement = node->first_attribute("movement");
                 if (movement)
                 {
-                    GameSingletons::SetPlayerMovementSpeedStat(std::stof(movement->value()));
+                    GameSingletons::SetPlayerMovementSpeedStat(strutils::StringToFloat(movement->value()));
                 }
                 
                 auto* bulletSpeed = node->first_attribute("bulletSpeed");
                 if (bulletSpeed)
                 {
-                    GameSingletons::SetPlayerBulletSpeedStat(std::stof(bulletSpeed->value()));
+                    GameSingletons::SetPlayerBulletSpeedStat(strutils::StringToFloat(bulletSpeed->value()));
                 }
                 
                 auto* crystals = node->first_attribute("crystals");
                 if (crystals)
                 {
-                    GameSingletons::SetCrystalCount(std::stof(crystals->value()));
+                    GameSingletons::SetCrystalCount(strutils::StringToFloat(crystals->value()));
                 }
             });
             
@@ -174,7 +883,7 @@ void LoadFromProgressSaveFile()
                 auto* eventIndexValue = node->first_attribute("value");
                 if (eventIndexValue)
                 {
-                    GameSingletons::GetSeenEventIndices().insert(std::stoi(eventIndexValue->value()));
+                    GameSingletons::GetSeenEventIndices().insert(strutils::StringToInt(eventIndexValue->value()));
                 }
             });
             
@@ -203,7 +912,7 @@ void LoadFromProgressSaveFile()
                     
                     if (upgradeNameId == game_constants::PLAYER_SHIELD_UPGRADE_NAME)
                     {
-                        GameSingletons::SetPlayerShieldHealth(std::stof(node->first_attribute("shieldHealth")->value()));
+                        GameSingletons::SetPlayerShieldHealth(strutils::StringToFloat(node->first_attribute("shieldHealth")->value()));
                     }
                 }
             });
@@ -228,7 +937,7 @@ void LoadFromProgressSaveFile()
                     else
                     {
                         auto& upgradeDefinition = *availableUpgradeIter;
-                        upgradeDefinition.mCrystalUnlockProgress = std::stoi(node->first_attribute("crystalUnlockProgress")->value());
+                        upgradeDefinition.mCrystalUnlockProgress = strutils::StringToInt(node->first_attribute("crystalUnlockProgress")->value());
                         upgradeDefinition.mUnlocked = strcmp(node->first_attribute("unlocked")->value(), "true") == 0;
                     }
                 }
@@ -241,33 +950,62 @@ void LoadFromProgressSaveFile()
     ProgressLoader pl;
     pl.Load();
     
-    if (pl.mCorruptedSaveFlag)
+    return !pl.mCorruptedSaveFlag;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void HandleCorruptedSaveFile()
+{
+    ospopups::ShowMessageBox(ospopups::MessageBoxType::WARNING, "Corrupted Save File", "Found corrupted save file with seed " + std::to_string(GameSingletons::GetMapGenerationSeed()) + ". Cleaning up persistent files.");
+    GenerateNewProgressSaveFile();
+}
+
+///------------------------------------------------------------------------------------------------
+
+void LoadFromProgressSaveFile()
+{
+    // Make sure there's no save still on its way to disk, and that the next one rewrites the whole file
+    auto& progressSaveWorker = ProgressSaveWorker::GetInstance();
+    progressSaveWorker.Flush();
+    progressSaveWorker.InvalidateEncodedSections();
+    
+    std::ifstream binarySaveFile(objectiveC_utils::BuildLocalFileSaveLocation(PROGRESS_SAVE_FILE_NAME + BINARY_SAVE_FILE_EXTENSION), std::ios::binary);
+    if (binarySaveFile.good())
     {
-        ospopups::ShowMessageBox(ospopups::MessageBoxType::WARNING, "Corrupted Save File", "Found corrupted save file with seed " + std::to_string(GameSingletons::GetMapGenerationSeed()) + ". Cleaning up persistent files.");
-        GenerateNewProgressSaveFile();
+        std::vector<unsigned char> saveData((std::istreambuf_iterator<char>(binarySaveFile)), std::istreambuf_iterator<char>());
+        
+        ProgressSnapshot progress;
+        if (!DecodeBinarySave(saveData, progress) || progress.mSeed == 0)
+        {
+            GameSingletons::SetMapGenerationSeed(progress.mSeed);
+            HandleCorruptedSaveFile();
+            return;
+        }
+        
+        ApplyProgressSnapshot(progress);
+        return;
     }
+    
+    // Saves predating the binary format are migrated over on their first load
+    if (!LoadFromProgressSaveXmlFile())
+    {
+        HandleCorruptedSaveFile();
+        return;
+    }
+    
+    BuildProgressSaveFile();
 }
 
 ///------------------------------------------------------------------------------------------------
 
-void GenerateNewProgressSaveFile()
+void ResetProgress()
 {
     auto& typeDefRepo = ObjectTypeDefinitionRepository::GetInstance();
     typeDefRepo.LoadObjectTypeDefinition(game_constants::PLAYER_OBJECT_TYPE_DEF_NAME);
     auto& playerDef = typeDefRepo.GetObjectTypeDefinition(game_constants::PLAYER_OBJECT_TYPE_DEF_NAME)->get();
     
-    UpgradesLoader loader;
-    const auto& allUpgrades = loader.LoadAllUpgrades();
-    
-    std::vector<UpgradeDefinition> availableUpgrades;
-    std::vector<UpgradeDefinition> eventOnlyUpgrades;
-    
-    std::copy_if(allUpgrades.begin(), allUpgrades.end(), std::back_inserter(availableUpgrades), [](const UpgradeDefinition& def) { return def.mEventOnly == false; });
-    std::copy_if(allUpgrades.begin(), allUpgrades.end(), std::back_inserter(eventOnlyUpgrades), [](const UpgradeDefinition& def) { return def.mEventOnly == true; });
-    
-    GameSingletons::SetAvailableUpgrades(availableUpgrades);
-    GameSingletons::SetEventOnlyUpgrades(eventOnlyUpgrades);
-    GameSingletons::GetEquippedUpgrades().clear();
+    ResetUpgradesAndEvents();
     GameSingletons::SetMapGenerationSeed(math::RandomInt());
     GameSingletons::SetPlayerDisplayedHealth(game_constants::DEFAULT_PLAYER_HEALTH);
     GameSingletons::SetPlayerMaxHealth(game_constants::DEFAULT_PLAYER_HEALTH);
@@ -283,8 +1021,13 @@ void GenerateNewProgressSaveFile()
     GameSingletons::SetBackgroundIndex(GameSingletons::GetMapGenerationSeed() % game_constants::BACKGROUND_COUNT);
     GameSingletons::SetErasedLabsOnCurrentMap(false);
     GameSingletons::SetResearchCostMultiplier(1);
-    GameSingletons::GetSeenEventIndices().clear();
-    
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GenerateNewProgressSaveFile()
+{
+    ResetProgress();
     BuildProgressSaveFile();
 }
 
@@ -292,8 +1035,20 @@ void GenerateNewProgressSaveFile()
 
 void BuildProgressSaveFile()
 {
-    std::ofstream progressSaveFile(objectiveC_utils::BuildLocalFileSaveLocation(PROGRESS_SAVE_FILE_NAME + std::string(".xml")));
-    
+    ProgressSaveWorker::GetInstance().RequestSave(CaptureProgressSnapshot(), objectiveC_utils::BuildLocalFileSaveLocation(PROGRESS_SAVE_FILE_NAME + BINARY_SAVE_FILE_EXTENSION));
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FlushPendingProgressSaves()
+{
+    ProgressSaveWorker::GetInstance().Flush();
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool ExportProgressSaveFileXml()
+{
     std::stringstream progressSaveFileXml;
     progressSaveFileXml << "<?xml version=\"1.0\" encoding=\"utf-8\"?>";
     progressSaveFileXml << "\n<SaveData>";
@@ -343,8 +1098,32 @@ void BuildProgressSaveFile()
     progressSaveFileXml << "\n</SaveData>";
     
     const auto& progressSaveFileContents = progressSaveFileXml.str();
-    progressSaveFile << progressSaveFileContents;
-    progressSaveFile.close();
+    return WriteFileAtomically(objectiveC_utils::BuildLocalFileSaveLocation(PROGRESS_SAVE_FILE_NAME + XML_SAVE_FILE_EXTENSION), reinterpret_cast<const unsigned char*>(progressSaveFileContents.data()), progressSaveFileContents.size());
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool ImportProgressSaveFileXml()
+{
+    if (!std::ifstream(objectiveC_utils::BuildLocalFileSaveLocation(PROGRESS_SAVE_FILE_NAME + XML_SAVE_FILE_EXTENSION)).good())
+    {
+        return false;
+    }
+    
+    // The XML form only lists what differs from a fresh run's upgrades and events
+    ResetUpgradesAndEvents();
+    GameSingletons::SetPlayerShieldHealth(0);
+    ProgressSaveWorker::GetInstance().Flush();
+    ProgressSaveWorker::GetInstance().InvalidateEncodedSections();
+    
+    if (!LoadFromProgressSaveXmlFile())
+    {
+        HandleCorruptedSaveFile();
+        return false;
+    }
+    
+    BuildProgressSaveFile();
+    return true;
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -10,12 +10,37 @@
 
 ///------------------------------------------------------------------------------------------------
 
+#include <cstddef>
+#include <string>
+
+///------------------------------------------------------------------------------------------------
+
 namespace persistence_utils
 {
     bool ProgressSaveFileExists();
     void LoadFromProgressSaveFile();
     void GenerateNewProgressSaveFile();
+    
+    /// Resets all progress to that of a fresh game, without saving it.
+    void ResetProgress();
+    
+    /// Snapshots the current progress and hands it over to the background save worker, returning right away.
     void BuildProgressSaveFile();
+    
+    /// Blocks until all progress saves requested so far have been written (and synced) to disk.
+    void FlushPendingProgressSaves();
+
+    /// Debug round trip of the progress save through its (human readable) XML form. The export
+    /// writes progress_save.xml next to the binary save, and the import replaces the current
+    /// progress with its contents (and saves them in the binary form).
+    /// @returns whether the export/import succeeded.
+    bool ExportProgressSaveFileXml();
+    bool ImportProgressSaveFileXml();
+    
+    /// Writes the given contents to a temporary file that is synced to disk and then renamed over
+    /// the target, so that the target is either left untouched or fully replaced.
+    /// @returns whether the write succeeded.
+    bool WriteFileAtomically(const std::string& filePath, const unsigned char* data, const size_t dataSize);
 }
 
 ///------------------------------------------------------------------------------------------------
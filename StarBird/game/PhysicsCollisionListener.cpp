@@ -7,19 +7,100 @@
 
 #include "PhysicsCollisionListener.h"
 #include "Logging.h"
+#include "../utils/StringUtils.h"
+
+#include <bit>
+#include <cassert>
+#include <functional>
+#include <map>
+#include <random>
+#include <SDL.h>
+
+///------------------------------------------------------------------------------------------------
+
+// Enough for the busiest of waves, so that recording events never allocates mid-step
+static const size_t INITIAL_COLLISION_EVENTS_CAPACITY = 256;
+
+static const PhysicsCollisionListener::CollisionHandler NO_COLLISION_HANDLER = {};
+
+///------------------------------------------------------------------------------------------------
+
+static bool FixturesStillCollide(const b2Fixture* firstFixture, const b2Fixture* secondFixture)
+{
+    const auto& firstFilter = firstFixture->GetFilterData();
+    const auto& secondFilter = secondFixture->GetFilterData();
+    return (firstFilter.maskBits & secondFilter.categoryBits) != 0 && (secondFilter.maskBits & firstFilter.categoryBits) != 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t PhysicsCollisionListener::GetCollisionCategoryIndex(const uint16 collisionCategory)
+{
+    if (!std::has_single_bit(collisionCategory))
+    {
+        return COLLISION_CATEGORY_COUNT;
+    }
+    
+    const auto bitIndex = static_cast<size_t>(std::countr_zero(collisionCategory));
+    return bitIndex < COLLISION_CATEGORY_COUNT ? bitIndex : COLLISION_CATEGORY_COUNT;
+}
 
 ///------------------------------------------------------------------------------------------------
 
 PhysicsCollisionListener::PhysicsCollisionListener()
-    : mCollisionPair(0, 0)
 {
+    mCollisionEvents.reserve(INITIAL_COLLISION_EVENTS_CAPACITY);
 }
 
 ///------------------------------------------------------------------------------------------------
 
-void PhysicsCollisionListener::RegisterCollisionCallback(UnorderedCollisionCategoryPair &&collisionCategoryPair, CollisionCallback callback)
+void PhysicsCollisionListener::SetCollisionCallback(const UnorderedCollisionCategoryPair& collisionCategoryPair, CollisionCallback&& callback)
 {
-    mCollisionCallbacks[collisionCategoryPair] = callback;
+    const auto firstIndex = GetCollisionCategoryIndex(collisionCategoryPair.mFirstCollisionCategory);
+    const auto secondIndex = GetCollisionCategoryIndex(collisionCategoryPair.mSecondCollisionCategory);
+    assert(firstIndex < COLLISION_CATEGORY_COUNT && secondIndex < COLLISION_CATEGORY_COUNT);
+    
+    const auto pairIndex = firstIndex * COLLISION_CATEGORY_COUNT + secondIndex;
+    const auto reversePairIndex = secondIndex * COLLISION_CATEGORY_COUNT + firstIndex;
+    
+    // A callback registered for the reverse pair before is replaced as well
+    mCollisionCallbacks[reversePairIndex] = nullptr;
+    mCollisionCallbacks[pairIndex] = std::move(callback);
+    
+    mCollisionHandlers[pairIndex] = { &mCollisionCallbacks[pairIndex], false };
+    if (reversePairIndex != pairIndex)
+    {
+        mCollisionHandlers[reversePairIndex] = { &mCollisionCallbacks[pairIndex], true };
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void PhysicsCollisionListener::ClearCollisionCallbacks()
+{
+    // Pending events point to the callbacks being cleared
+    mCollisionEvents.clear();
+    
+    for (auto& collisionCallback: mCollisionCallbacks)
+    {
+        collisionCallback = nullptr;
+    }
+    
+    mCollisionHandlers.fill(CollisionHandler());
+}
+
+///------------------------------------------------------------------------------------------------
+
+const PhysicsCollisionListener::CollisionHandler& PhysicsCollisionListener::FindCollisionHandler(const uint16 firstCollisionCategory, const uint16 secondCollisionCategory) const
+{
+    const auto firstIndex = GetCollisionCategoryIndex(firstCollisionCategory);
+    const auto secondIndex = GetCollisionCategoryIndex(secondCollisionCategory);
+    if (firstIndex == COLLISION_CATEGORY_COUNT || secondIndex == COLLISION_CATEGORY_COUNT)
+    {
+        return NO_COLLISION_HANDLER;
+    }
+    
+    return mCollisionHandlers[firstIndex * COLLISION_CATEGORY_COUNT + secondIndex];
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -28,29 +109,183 @@ void PhysicsCollisionListener::PreSolve(b2Contact* contact, const b2Manifold* ol
 {
     (void)oldManifold;
     
-    mCollisionPair.mFirstCollisionCategory  = contact->GetFixtureA()->GetFilterData().categoryBits;
-    mCollisionPair.mSecondCollisionCategory = contact->GetFixtureB()->GetFilterData().categoryBits;
+    auto* firstFixture = contact->GetFixtureA();
+    auto* secondFixture = contact->GetFixtureB();
+    auto firstCollisionCategory = firstFixture->GetFilterData().categoryBits;
+    auto secondCollisionCategory = secondFixture->GetFilterData().categoryBits;
+    
+    const auto& collisionHandler = FindCollisionHandler(firstCollisionCategory, secondCollisionCategory);
+    if (!collisionHandler.mCallback)
+    {
+        return;
+    }
+    
+    if (collisionHandler.mSwapBodies)
+    {
+        std::swap(firstFixture, secondFixture);
+        std::swap(firstCollisionCategory, secondCollisionCategory);
+    }
+    
+    // A pair of bodies can be in contact through several fixtures, and can be presolved more than once
+    // per step (i.e. on time of impact sub-steps), but only gets its collision response once per step.
+    // There are only a handful of events per step, hence the linear search.
+    const auto* firstBody = firstFixture->GetBody();
+    const auto* secondBody = secondFixture->GetBody();
+    for (const auto& collisionEvent: mCollisionEvents)
+    {
+        if (collisionEvent.mFirstFixture->GetBody() == firstBody && collisionEvent.mSecondFixture->GetBody() == secondBody)
+        {
+            return;
+        }
+    }
+    
+    b2WorldManifold worldManifold;
+    contact->GetWorldManifold(&worldManifold);
+    
+    mCollisionEvents.push_back({ collisionHandler.mCallback, firstFixture, secondFixture, firstCollisionCategory, secondCollisionCategory, worldManifold.points[0] });
+}
+
+///------------------------------------------------------------------------------------------------
+
+void PhysicsCollisionListener::DispatchCollisionEvents()
+{
+    // Indexed iteration, since callbacks are free to clear the collision callbacks (and with them the pending events)
+    for (size_t i = 0; i < mCollisionEvents.size(); ++i)
+    {
+        const auto collisionEvent = mCollisionEvents[i];
+        if (FixturesStillCollide(collisionEvent.mFirstFixture, collisionEvent.mSecondFixture))
+        {
+            (*collisionEvent.mCallback)(collisionEvent.mFirstFixture->GetBody(), collisionEvent.mSecondFixture->GetBody());
+        }
+    }
+    
+    mCollisionEvents.clear();
+}
 
-    auto findIter = mCollisionCallbacks.find(mCollisionPair);
-    if (findIter != mCollisionCallbacks.end())
+///------------------------------------------------------------------------------------------------
+
+namespace collision_dispatch
+{
+
+///------------------------------------------------------------------------------------------------
+
+static const unsigned int BENCHMARK_SEED = 1337;
+
+///------------------------------------------------------------------------------------------------
+
+std::vector<std::string> BenchmarkCollisionDispatch(const int contactCount)
+{
+    // Replica of PhysicsCollisionListener as it used to be: std::function callbacks in a std::map keyed
+    // by the ordered category pair, looked up once more with the pair reversed on a miss
+    using LegacyCategoryPair = std::pair<uint16, uint16>;
+    using LegacyCollisionCallback = std::function<void(b2Body* firstBody, b2Body* secondBody)>;
+    
+    // The pairs LevelUpdater responds to
+    const std::vector<LegacyCategoryPair> registeredPairs =
+    {
+        { physics_constants::ENEMY_CATEGORY_BIT, physics_constants::PLAYER_BULLET_CATEGORY_BIT },
+        { physics_constants::PLAYER_CATEGORY_BIT, physics_constants::ENEMY_CATEGORY_BIT },
+        { physics_constants::PLAYER_CATEGORY_BIT, physics_constants::ENEMY_BULLET_CATEGORY_BIT },
+        { physics_constants::PLAYER_BULLET_CATEGORY_BIT, physics_constants::BULLET_ONLY_WALL_CATEGORY_BIT },
+        { physics_constants::ENEMY_CATEGORY_BIT, physics_constants::ENEMY_ONLY_WALL_CATEGORY_BIT },
+        { physics_constants::ENEMY_BULLET_CATEGORY_BIT, physics_constants::ENEMY_ONLY_WALL_CATEGORY_BIT }
+    };
+    
+    // Contacts are between random categories, reported in random order (like Box2D does)
+    std::vector<LegacyCategoryPair> contacts;
+    contacts.reserve(contactCount);
+    std::mt19937 contactRng(BENCHMARK_SEED);
+    for (int i = 0; i < contactCount; ++i)
+    {
+        contacts.emplace_back(static_cast<uint16>(1 << (contactRng() % PhysicsCollisionListener::COLLISION_CATEGORY_COUNT)), static_cast<uint16>(1 << (contactRng() % PhysicsCollisionListener::COLLISION_CATEGORY_COUNT)));
+    }
+    
+    // Callbacks tally the bodies they get, so that dispatching in the wrong order would show in the results
+    b2Body* firstBody = reinterpret_cast<b2Body*>(static_cast<uintptr_t>(0x10));
+    b2Body* secondBody = reinterpret_cast<b2Body*>(static_cast<uintptr_t>(0x20));
+    
+    auto getMillisSince = [](const Uint64 startCounter)
+    {
+        return static_cast<double>(SDL_GetPerformanceCounter() - startCounter) * 1000.0/SDL_GetPerformanceFrequency();
+    };
+    
+    long long legacyDispatchedCount = 0;
+    long long legacyBodyTally = 0;
+    std::map<LegacyCategoryPair, LegacyCollisionCallback> legacyCallbacks;
+    for (const auto& registeredPair: registeredPairs)
+    {
+        legacyCallbacks[registeredPair] = [&legacyDispatchedCount, &legacyBodyTally](b2Body* first, b2Body* second)
+        {
+            legacyDispatchedCount++;
+            legacyBodyTally += reinterpret_cast<uintptr_t>(first) - reinterpret_cast<uintptr_t>(second);
+        };
+    }
+    
+    auto legacyStartCounter = SDL_GetPerformanceCounter();
+    for (const auto& contact: contacts)
     {
-        findIter->second(contact->GetFixtureA()->GetBody(), contact->GetFixtureB()->GetBody());
+        auto findIter = legacyCallbacks.find(contact);
+        if (findIter != legacyCallbacks.end())
+        {
+            findIter->second(firstBody, secondBody);
+            continue;
+        }
         
-        // If the user mistakenly adds a reverse pair collision response this avoids resolving the collision twice
-        return;
+        findIter = legacyCallbacks.find(LegacyCategoryPair(contact.second, contact.first));
+        if (findIter != legacyCallbacks.end())
+        {
+            findIter->second(secondBody, firstBody);
+        }
+    }
+    const auto legacyMillis = getMillisSince(legacyStartCounter);
+    
+    long long tableDispatchedCount = 0;
+    long long tableBodyTally = 0;
+    PhysicsCollisionListener collisionListener;
+    for (const auto& registeredPair: registeredPairs)
+    {
+        collisionListener.RegisterCollisionCallback(UnorderedCollisionCategoryPair(registeredPair.first, registeredPair.second), [&tableDispatchedCount, &tableBodyTally](b2Body* first, b2Body* second)
+        {
+            tableDispatchedCount++;
+            tableBodyTally += reinterpret_cast<uintptr_t>(first) - reinterpret_cast<uintptr_t>(second);
+        });
     }
     
-    auto temp = mCollisionPair.mFirstCollisionCategory;
-    mCollisionPair.mFirstCollisionCategory = mCollisionPair.mSecondCollisionCategory;
-    mCollisionPair.mSecondCollisionCategory = temp;
+    auto tableStartCounter = SDL_GetPerformanceCounter();
+    for (const auto& contact: contacts)
+    {
+        const auto& collisionHandler = collisionListener.FindCollisionHandler(contact.first, contact.second);
+        if (collisionHandler.mCallback)
+        {
+            if (collisionHandler.mSwapBodies)
+            {
+                (*collisionHandler.mCallback)(secondBody, firstBody);
+            }
+            else
+            {
+                (*collisionHandler.mCallback)(firstBody, secondBody);
+            }
+        }
+    }
+    const auto tableMillis = getMillisSince(tableStartCounter);
     
-    findIter = mCollisionCallbacks.find(mCollisionPair);
-    if (findIter != mCollisionCallbacks.end())
+    std::vector<std::string> results =
     {
-        // If the user mistakenly adds a reverse pair collision response this avoids resolving the collision twice
-        findIter->second(contact->GetFixtureB()->GetBody(), contact->GetFixtureA()->GetBody());
-        return;
+        "Legacy map: " + strutils::FloatToString(static_cast<float>(legacyMillis), 4) + " ms (" + std::to_string(legacyDispatchedCount) + " dispatched, tally " + std::to_string(legacyBodyTally) + ")",
+        "Dense table: " + strutils::FloatToString(static_cast<float>(tableMillis), 4) + " ms (" + std::to_string(tableDispatchedCount) + " dispatched, tally " + std::to_string(tableBodyTally) + ")",
+        "Speedup: " + strutils::FloatToString(static_cast<float>(legacyMillis/std::max(tableMillis, 1e-6)), 2) + "x"
+    };
+    
+    for (const auto& result: results)
+    {
+        Log(LogType::INFO, "Collision dispatch benchmark (%d contacts) %s", contactCount, result.c_str());
     }
+    
+    return results;
+}
+
+///------------------------------------------------------------------------------------------------
+
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -11,9 +11,12 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "PhysicsConstants.h"
+#include "../utils/SmallFunction.h"
 
+#include <array>
 #include <Box2D/Box2D.h>
-#include <map>
+#include <string>
+#include <vector>
 
 ///------------------------------------------------------------------------------------------------
 
@@ -26,20 +29,6 @@ public:
     : mFirstCollisionCategory(firstCollisionCategory)
     , mSecondCollisionCategory(secondCollisionCategory) {}
     
-    struct Comparator
-    {
-        bool operator()(const UnorderedCollisionCategoryPair& lhs, const UnorderedCollisionCategoryPair& rhs) const
-        {
-            if (lhs.mFirstCollisionCategory != rhs.mFirstCollisionCategory)
-            {
-                return lhs.mFirstCollisionCategory < rhs.mFirstCollisionCategory;
-            }
-            else
-            {
-                return lhs.mSecondCollisionCategory < rhs.mSecondCollisionCategory;
-            }
-        }
-    };
 private:
     uint16 mFirstCollisionCategory;
     uint16 mSecondCollisionCategory;
@@ -47,22 +36,91 @@ private:
 
 ///------------------------------------------------------------------------------------------------
 
+/// Collision callbacks are not invoked from within b2World::Step. Contacts of registered category pairs
+/// only get recorded (once per pair of bodies) while stepping, and are then dispatched in one batch
+/// via DispatchCollisionEvents, after the step is over.
+///
+/// Callbacks live in a dense table indexed by the bit positions of the two (single bit) categories in
+/// contact, which is filled in both orders on registration, so that resolving a contact's callback
+/// is a single lookup regardless of the order Box2D reports its fixtures in.
 class PhysicsCollisionListener : public b2ContactListener
 {
 public:
-    using CollisionCallback = std::function<void(b2Body* firstBody, b2Body* secondBody)>;
+    // Collision callbacks only ever capture their owner, so they are always stored in place
+    static constexpr size_t COLLISION_CALLBACK_BUFFER_SIZE = 16;
+    static constexpr size_t COLLISION_CATEGORY_COUNT = 8;
+    
+    using CollisionCallback = SmallFunction<void(b2Body* firstBody, b2Body* secondBody), COLLISION_CALLBACK_BUFFER_SIZE>;
+    
+    struct CollisionHandler
+    {
+        CollisionCallback* mCallback = nullptr;
+        bool mSwapBodies = false; // Whether the callback was registered for the reverse category pair
+    };
+    
+    struct CollisionEvent
+    {
+        CollisionCallback* mCallback;
+        b2Fixture* mFirstFixture;
+        b2Fixture* mSecondFixture;
+        uint16 mFirstCollisionCategory;
+        uint16 mSecondCollisionCategory;
+        b2Vec2 mContactPoint;
+    };
+    
+    /// @returns the bit position of the given category, or COLLISION_CATEGORY_COUNT for anything but a single (known) category bit.
+    static size_t GetCollisionCategoryIndex(const uint16 collisionCategory);
     
     PhysicsCollisionListener();
     
-    void RegisterCollisionCallback(UnorderedCollisionCategoryPair&& collisionCategoryPair, CollisionCallback callback);
+    /// Registers the callback to respond to collisions of the given category pair (in either order), replacing
+    /// any callback registered for it (or the reverse pair) before. Both categories need to be single bits.
+    /// @param[in] collisionCategoryPair the pair of categories to respond to, in the order the callback expects its bodies in.
+    /// @param[in] callback the callback to invoke with the bodies in contact.
+    template<typename CallbackT>
+    void RegisterCollisionCallback(UnorderedCollisionCategoryPair&& collisionCategoryPair, CallbackT&& callback)
+    {
+        static_assert(CollisionCallback::IsStoredInPlace<std::decay_t<CallbackT>>(), "Collision callbacks should only capture their owner");
+        SetCollisionCallback(collisionCategoryPair, CollisionCallback(std::forward<CallbackT>(callback)));
+    }
+    
+    void ClearCollisionCallbacks();
+    
+    /// @returns the handler of collisions between the given categories (with a null callback if there is none).
+    const CollisionHandler& FindCollisionHandler(const uint16 firstCollisionCategory, const uint16 secondCollisionCategory) const;
     
     void PreSolve(b2Contact* contact, const b2Manifold* oldManifold) override;
     
+    /// Invokes the callbacks of the collision events recorded since the last dispatch, in the order they got recorded.
+    /// Events whose fixtures no longer collide by the time they get dispatched (e.g. a bullet whose collision
+    /// mask got erased by the callback of an earlier event) get dropped.
+    void DispatchCollisionEvents();
+    
+private:
+    void SetCollisionCallback(const UnorderedCollisionCategoryPair& collisionCategoryPair, CollisionCallback&& callback);
+    
 private:
-    std::map<UnorderedCollisionCategoryPair, CollisionCallback, UnorderedCollisionCategoryPair::Comparator> mCollisionCallbacks;
-    UnorderedCollisionCategoryPair mCollisionPair;
+    std::array<CollisionCallback, COLLISION_CATEGORY_COUNT * COLLISION_CATEGORY_COUNT> mCollisionCallbacks;
+    std::array<CollisionHandler, COLLISION_CATEGORY_COUNT * COLLISION_CATEGORY_COUNT> mCollisionHandlers;
+    std::vector<CollisionEvent> mCollisionEvents;
 };
 
+///------------------------------------------------------------------------------------------------
+
+namespace collision_dispatch
+{
+
+///------------------------------------------------------------------------------------------------
+/// Compares resolving and invoking the callbacks of the given number of synthetic contacts (between random
+/// categories, both registered pairs and not) through PhysicsCollisionListener's handler table, against the
+/// legacy approach of looking up each pair (and then the reverse pair) in a std::map of std::function callbacks.
+/// @param[in] contactCount how many contacts to dispatch.
+/// @returns the human readable results (also logged).
+std::vector<std::string> BenchmarkCollisionDispatch(const int contactCount);
+
+///------------------------------------------------------------------------------------------------
+
+}
 
 ///------------------------------------------------------------------------------------------------
 
@@ -31,6 +31,10 @@ static constexpr uint16 ENEMY_ONLY_WALL_CATEGORY_BIT = 0x80;
 static constexpr int WORLD_VELOCITY_ITERATIONS = 6;
 static constexpr int WORLD_POSITION_ITERATIONS = 2;
 static const float WORLD_STEP = 1.0f / 60.0f;
+static const float WORLD_STEP_MILLIS = WORLD_STEP * 1000.0f;
+
+// Past this many simulation steps in a single frame the game slows down instead of trying to catch up
+static constexpr int MAX_WORLD_STEPS_PER_FRAME = 4;
 
 ///------------------------------------------------------------------------------------------------
 
@@ -0,0 +1,764 @@
+///------------------------------------------------------------------------------------------------
+///  ProjectileSystem.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "ProjectileSystem.h"
+#include "LevelSnapshot.h"
+#include "PhysicsConstants.h"
+#include "../utils/Logging.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <SDL.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+///------------------------------------------------------------------------------------------------
+
+static const std::string PROJECTILE_NAME_PREFIX = "PROJECTILE_";
+
+// Enough for a screenful of bullets, so that firing them never allocates mid-level
+static const size_t INITIAL_PROJECTILES_CAPACITY = 256;
+
+// Cells are roughly the size of a wave enemy, but grow as needed to keep the grid small for targets spread far apart
+static const float GRID_CELL_SIZE = 2.0f;
+static const int MAX_GRID_CELLS_PER_AXIS = 64;
+
+///------------------------------------------------------------------------------------------------
+
+// Not b2TestOverlap, as its GJK bumps Box2D's global (unsynchronized) call statistics, which races
+// between game instances stepping on different threads. The circle manifolds touch no globals.
+static bool IsCircleOverlappingFixture(const b2CircleShape& circle, const b2Transform& circleTransform, const b2Fixture& fixture, const b2Transform& fixtureTransform)
+{
+    b2Manifold manifold;
+    
+    switch (fixture.GetType())
+    {
+        case b2Shape::e_circle:
+        {
+            b2CollideCircles(&manifold, static_cast<const b2CircleShape*>(fixture.GetShape()), fixtureTransform, &circle, circleTransform);
+            return manifold.pointCount > 0;
+        }
+        case b2Shape::e_polygon:
+        {
+            b2CollidePolygonAndCircle(&manifold, static_cast<const b2PolygonShape*>(fixture.GetShape()), fixtureTransform, &circle, circleTransform);
+            return manifold.pointCount > 0;
+        }
+        default:
+        {
+            // No edge or chain fixtures in the game, anything else keeps the box test's answer
+            return true;
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+ProjectileSystem::ProjectileSystem()
+    : mGridOrigin(0.0f)
+    , mGridCellSize(GRID_CELL_SIZE)
+    , mGridColumns(0)
+    , mGridRows(0)
+    , mTargetCategories(0)
+    , mNextProjectileId(0)
+{
+    mPositionsX.reserve(INITIAL_PROJECTILES_CAPACITY);
+    mPositionsY.reserve(INITIAL_PROJECTILES_CAPACITY);
+    mVelocitiesX.reserve(INITIAL_PROJECTILES_CAPACITY);
+    mVelocitiesY.reserve(INITIAL_PROJECTILES_CAPACITY);
+    mRadii.reserve(INITIAL_PROJECTILES_CAPACITY);
+    mCategoryBits.reserve(INITIAL_PROJECTILES_CAPACITY);
+    mMaskBits.reserve(INITIAL_PROJECTILES_CAPACITY);
+    mNames.reserve(INITIAL_PROJECTILES_CAPACITY);
+    mHitTargetCategories.fill(0);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::SetHitCallback(const uint16 projectileCategory, const uint16 targetCategory, HitCallback&& callback)
+{
+    const auto projectileIndex = PhysicsCollisionListener::GetCollisionCategoryIndex(projectileCategory);
+    const auto targetIndex = PhysicsCollisionListener::GetCollisionCategoryIndex(targetCategory);
+    assert(projectileIndex < CATEGORY_COUNT && targetIndex < CATEGORY_COUNT);
+
+    mHitCallbacks[projectileIndex * CATEGORY_COUNT + targetIndex] = std::move(callback);
+    mHitTargetCategories[projectileIndex] |= targetCategory;
+    mTargetCategories |= targetCategory;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::ClearHitCallbacks()
+{
+    // Pending hits are for the callbacks being cleared
+    mHits.clear();
+
+    for (auto& hitCallback: mHitCallbacks)
+    {
+        hitCallback = nullptr;
+    }
+
+    mHitTargetCategories.fill(0);
+    mTargetCategories = 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
+strutils::StringId ProjectileSystem::AddProjectile(const glm::vec2& position, const glm::vec2& velocity, const float radius, const b2Filter& filter)
+{
+    // Named after a running id rather than an address (like scene objects with bodies are), so that they are the same across replays
+    const auto projectileName = strutils::StringId(PROJECTILE_NAME_PREFIX + std::to_string(mNextProjectileId++));
+
+    mIndicesByName[projectileName] = static_cast<uint32_t>(mNames.size());
+    mPositionsX.push_back(position.x);
+    mPositionsY.push_back(position.y);
+    mVelocitiesX.push_back(velocity.x);
+    mVelocitiesY.push_back(velocity.y);
+    mRadii.push_back(radius);
+    mCategoryBits.push_back(filter.categoryBits);
+    mMaskBits.push_back(filter.maskBits);
+    mNames.push_back(projectileName);
+
+    return projectileName;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::RemoveProjectile(const strutils::StringId& projectileName)
+{
+    auto findIter = mIndicesByName.find(projectileName);
+    if (findIter != mIndicesByName.end())
+    {
+        RemoveProjectileAt(findIter->second);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::RemoveAllProjectiles()
+{
+    mPositionsX.clear();
+    mPositionsY.clear();
+    mVelocitiesX.clear();
+    mVelocitiesY.clear();
+    mRadii.clear();
+    mCategoryBits.clear();
+    mMaskBits.clear();
+    mNames.clear();
+    mIndicesByName.clear();
+    mHits.clear();
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool ProjectileSystem::HasProjectile(const strutils::StringId& projectileName) const
+{
+    return mIndicesByName.count(projectileName) != 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t ProjectileSystem::GetProjectileCount() const
+{
+    return mNames.size();
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::Step(const float dtSeconds, b2World& box2dWorld)
+{
+    Integrate(dtSeconds);
+    GatherTargets(box2dWorld);
+    FindHits();
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::Integrate(const float dtSeconds)
+{
+    const auto projectileCount = mNames.size();
+    auto* positionsX = mPositionsX.data();
+    auto* positionsY = mPositionsY.data();
+    const auto* velocitiesX = mVelocitiesX.data();
+    const auto* velocitiesY = mVelocitiesY.data();
+
+    size_t i = 0;
+
+#if defined(__ARM_NEON)
+    for (; i + 4 <= projectileCount; i += 4)
+    {
+        vst1q_f32(positionsX + i, vmlaq_n_f32(vld1q_f32(positionsX + i), vld1q_f32(velocitiesX + i), dtSeconds));
+        vst1q_f32(positionsY + i, vmlaq_n_f32(vld1q_f32(positionsY + i), vld1q_f32(velocitiesY + i), dtSeconds));
+    }
+#elif defined(__SSE__)
+    const auto dtVector = _mm_set1_ps(dtSeconds);
+    for (; i + 4 <= projectileCount; i += 4)
+    {
+        _mm_storeu_ps(positionsX + i, _mm_add_ps(_mm_loadu_ps(positionsX + i), _mm_mul_ps(_mm_loadu_ps(velocitiesX + i), dtVector)));
+        _mm_storeu_ps(positionsY + i, _mm_add_ps(_mm_loadu_ps(positionsY + i), _mm_mul_ps(_mm_loadu_ps(velocitiesY + i), dtVector)));
+    }
+#endif
+
+    for (; i < projectileCount; ++i)
+    {
+        positionsX[i] += velocitiesX[i] * dtSeconds;
+        positionsY[i] += velocitiesY[i] * dtSeconds;
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::GatherTargets(b2World& box2dWorld)
+{
+    mTargets.clear();
+
+    if (mTargetCategories != 0 && !mNames.empty())
+    {
+        for (auto* body = box2dWorld.GetBodyList(); body; body = body->GetNext())
+        {
+            if (!body->IsActive())
+            {
+                continue;
+            }
+
+            for (auto* fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext())
+            {
+                const auto& filter = fixture->GetFilterData();
+                if ((filter.categoryBits & mTargetCategories) == 0)
+                {
+                    continue;
+                }
+
+                b2AABB aabb;
+                fixture->GetShape()->ComputeAABB(&aabb, body->GetTransform(), 0);
+                mTargets.push_back({ glm::vec2(aabb.lowerBound.x, aabb.lowerBound.y), glm::vec2(aabb.upperBound.x, aabb.upperBound.y), body, fixture, filter.categoryBits, filter.maskBits });
+            }
+        }
+    }
+
+    BuildGrid();
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::SetTargets(const std::vector<Target>& targets)
+{
+    mTargets = targets;
+    BuildGrid();
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::BuildGrid()
+{
+    if (mTargets.empty())
+    {
+        mGridColumns = 0;
+        mGridRows = 0;
+        return;
+    }
+
+    // Targets are spread over every cell they could be hit from, i.e. grown by the biggest projectile radius,
+    // so that projectiles only need to look at the cell their center falls in
+    const auto maxRadius = mRadii.empty() ? 0.0f : *std::max_element(mRadii.cbegin(), mRadii.cend());
+
+    auto gridMin = mTargets.front().mMin;
+    auto gridMax = mTargets.front().mMax;
+    for (const auto& target: mTargets)
+    {
+        gridMin = glm::min(gridMin, target.mMin);
+        gridMax = glm::max(gridMax, target.mMax);
+    }
+
+    gridMin -= glm::vec2(maxRadius);
+    gridMax += glm::vec2(maxRadius);
+
+    const auto gridExtent = gridMax - gridMin;
+    mGridOrigin = gridMin;
+    mGridCellSize = math::Max(GRID_CELL_SIZE, math::Max(gridExtent.x, gridExtent.y)/MAX_GRID_CELLS_PER_AXIS);
+    mGridColumns = math::Max(1, static_cast<int>(std::ceil(gridExtent.x/mGridCellSize)));
+    mGridRows = math::Max(1, static_cast<int>(std::ceil(gridExtent.y/mGridCellSize)));
+
+    const auto cellCount = static_cast<size_t>(mGridColumns * mGridRows);
+    const auto inverseCellSize = 1.0f/mGridCellSize;
+
+    auto forEachTargetCell = [&](const Target& target, auto cellFunction)
+    {
+        const auto minColumn = math::Max(0, static_cast<int>((target.mMin.x - maxRadius - mGridOrigin.x) * inverseCellSize));
+        const auto maxColumn = math::Min(mGridColumns - 1, static_cast<int>((target.mMax.x + maxRadius - mGridOrigin.x) * inverseCellSize));
+        const auto minRow = math::Max(0, static_cast<int>((target.mMin.y - maxRadius - mGridOrigin.y) * inverseCellSize));
+        const auto maxRow = math::Min(mGridRows - 1, static_cast<int>((target.mMax.y + maxRadius - mGridOrigin.y) * inverseCellSize));
+
+        for (auto row = minRow; row <= maxRow; ++row)
+        {
+            for (auto column = minColumn; column <= maxColumn; ++column)
+            {
+                cellFunction(static_cast<size_t>(row * mGridColumns + column));
+            }
+        }
+    };
+
+    // Counting sort of the targets into their cells
+    mCellTargetOffsets.assign(cellCount + 1, 0);
+    for (const auto& target: mTargets)
+    {
+        forEachTargetCell(target, [&](const size_t cellIndex){ mCellTargetOffsets[cellIndex + 1]++; });
+    }
+
+    for (size_t i = 0; i < cellCount; ++i)
+    {
+        mCellTargetOffsets[i + 1] += mCellTargetOffsets[i];
+    }
+
+    mCellTargetIndices.resize(mCellTargetOffsets[cellCount]);
+    mCellTargetCursors.assign(mCellTargetOffsets.cbegin(), mCellTargetOffsets.cend() - 1);
+    for (size_t i = 0; i < mTargets.size(); ++i)
+    {
+        forEachTargetCell(mTargets[i], [&](const size_t cellIndex){ mCellTargetIndices[mCellTargetCursors[cellIndex]++] = static_cast<uint32_t>(i); });
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::FindHits()
+{
+    if (mGridColumns == 0 || mGridRows == 0)
+    {
+        return;
+    }
+
+    const auto inverseCellSize = 1.0f/mGridCellSize;
+    const auto projectileCount = mNames.size();
+
+    b2CircleShape projectileShape;
+    b2Transform projectileTransform;
+    projectileTransform.SetIdentity();
+
+    for (size_t i = 0; i < projectileCount; ++i)
+    {
+        // Spent projectiles have no mask left
+        const auto projectileMaskBits = mMaskBits[i];
+        if (projectileMaskBits == 0)
+        {
+            continue;
+        }
+
+        const auto projectileCategoryIndex = PhysicsCollisionListener::GetCollisionCategoryIndex(mCategoryBits[i]);
+        if (projectileCategoryIndex == CATEGORY_COUNT || mHitTargetCategories[projectileCategoryIndex] == 0)
+        {
+            continue;
+        }
+
+        const auto x = mPositionsX[i];
+        const auto y = mPositionsY[i];
+        const auto column = static_cast<int>(std::floor((x - mGridOrigin.x) * inverseCellSize));
+        const auto row = static_cast<int>(std::floor((y - mGridOrigin.y) * inverseCellSize));
+        if (column < 0 || column >= mGridColumns || row < 0 || row >= mGridRows)
+        {
+            continue;
+        }
+
+        const auto hittableCategories = static_cast<uint16>(projectileMaskBits & mHitTargetCategories[projectileCategoryIndex]);
+        const auto radiusSquared = mRadii[i] * mRadii[i];
+        const auto cellIndex = static_cast<size_t>(row * mGridColumns + column);
+
+        for (auto j = mCellTargetOffsets[cellIndex]; j < mCellTargetOffsets[cellIndex + 1]; ++j)
+        {
+            const auto& target = mTargets[mCellTargetIndices[j]];
+            if ((target.mCategoryBits & hittableCategories) == 0 || (target.mMaskBits & mCategoryBits[i]) == 0)
+            {
+                continue;
+            }
+
+            // Circle against box, i.e. the distance of the projectile to the closest point of the target
+            const auto dx = math::Max(target.mMin.x, math::Min(x, target.mMax.x)) - x;
+            const auto dy = math::Max(target.mMin.y, math::Min(y, target.mMax.y)) - y;
+            if (dx * dx + dy * dy > radiusSquared)
+            {
+                continue;
+            }
+
+            // Then against the actual shape, which for round ships and angled walls can be a lot smaller than its box
+            if (target.mFixture)
+            {
+                projectileShape.m_radius = mRadii[i];
+                projectileTransform.p.Set(x, y);
+                if (!IsCircleOverlappingFixture(projectileShape, projectileTransform, *target.mFixture, target.mBody->GetTransform()))
+                {
+                    continue;
+                }
+            }
+
+            mHits.push_back({ mNames[i], mCellTargetIndices[j] });
+            break;
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::DispatchHits()
+{
+    // Indexed iteration, since callbacks are free to clear the hit callbacks (and with them the pending hits)
+    for (size_t i = 0; i < mHits.size(); ++i)
+    {
+        const auto hit = mHits[i];
+        auto indexIter = mIndicesByName.find(hit.mProjectileName);
+        if (indexIter == mIndicesByName.end() || mMaskBits[indexIter->second] == 0)
+        {
+            continue;
+        }
+
+        const auto& target = mTargets[hit.mTargetIndex];
+        const auto projectileCategoryIndex = PhysicsCollisionListener::GetCollisionCategoryIndex(mCategoryBits[indexIter->second]);
+        const auto targetCategoryIndex = PhysicsCollisionListener::GetCollisionCategoryIndex(target.mCategoryBits);
+
+        auto& hitCallback = mHitCallbacks[projectileCategoryIndex * CATEGORY_COUNT + targetCategoryIndex];
+        if (!hitCallback || !hitCallback(hit.mProjectileName, target.mBody))
+        {
+            continue;
+        }
+
+        // Spent projectiles stop hitting anything until their owner gets around to removing them
+        indexIter = mIndicesByName.find(hit.mProjectileName);
+        if (indexIter != mIndicesByName.end())
+        {
+            mMaskBits[indexIter->second] = 0;
+        }
+    }
+
+    mHits.clear();
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t ProjectileSystem::GetPendingHitCount() const
+{
+    return mHits.size();
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::SyncSceneObjects(std::vector<SceneObject>& sceneObjects) const
+{
+    if (mIndicesByName.empty())
+    {
+        return;
+    }
+
+    for (auto& sceneObject: sceneObjects)
+    {
+        if (sceneObject.mBody)
+        {
+            continue;
+        }
+
+        auto indexIter = mIndicesByName.find(sceneObject.mName);
+        if (indexIter != mIndicesByName.cend())
+        {
+            sceneObject.mPreviousBodyPosition = sceneObject.mPosition;
+            sceneObject.mHasPreviousBodyPosition = true;
+            sceneObject.mPosition.x = mPositionsX[indexIter->second] - sceneObject.mBodyCustomOffset.x;
+            sceneObject.mPosition.y = mPositionsY[indexIter->second] - sceneObject.mBodyCustomOffset.y;
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::WriteSnapshot(SnapshotWriter& writer) const
+{
+    writer.Write(mNextProjectileId);
+    writer.Write(static_cast<uint32_t>(mNames.size()));
+    for (size_t i = 0; i < mNames.size(); ++i)
+    {
+        writer.WriteStringId(mNames[i]);
+        writer.Write(glm::vec2(mPositionsX[i], mPositionsY[i]));
+        writer.Write(glm::vec2(mVelocitiesX[i], mVelocitiesY[i]));
+        writer.Write(mRadii[i]);
+        writer.Write(mCategoryBits[i]);
+        writer.Write(mMaskBits[i]);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::ReadSnapshot(SnapshotReader& reader, std::vector<ProjectileState>& outProjectiles, uint32_t& outNextProjectileId)
+{
+    outNextProjectileId = reader.Read<uint32_t>();
+
+    const auto projectileCount = reader.ReadCount(sizeof(glm::vec2) * 2);
+    for (uint32_t i = 0; i < projectileCount && reader.IsValid(); ++i)
+    {
+        ProjectileState projectile;
+        projectile.mName = reader.ReadStringId();
+        projectile.mPosition = reader.Read<glm::vec2>();
+        projectile.mVelocity = reader.Read<glm::vec2>();
+        projectile.mRadius = reader.Read<float>();
+        projectile.mCategoryBits = reader.Read<uint16>();
+        projectile.mMaskBits = reader.Read<uint16>();
+        outProjectiles.push_back(projectile);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::RestoreProjectiles(const std::vector<ProjectileState>& projectiles, const uint32_t nextProjectileId)
+{
+    RemoveAllProjectiles();
+
+    for (const auto& projectile: projectiles)
+    {
+        mIndicesByName[projectile.mName] = static_cast<uint32_t>(mNames.size());
+        mPositionsX.push_back(projectile.mPosition.x);
+        mPositionsY.push_back(projectile.mPosition.y);
+        mVelocitiesX.push_back(projectile.mVelocity.x);
+        mVelocitiesY.push_back(projectile.mVelocity.y);
+        mRadii.push_back(projectile.mRadius);
+        mCategoryBits.push_back(projectile.mCategoryBits);
+        mMaskBits.push_back(projectile.mMaskBits);
+        mNames.push_back(projectile.mName);
+    }
+
+    mNextProjectileId = nextProjectileId;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ProjectileSystem::RemoveProjectileAt(const size_t projectileIndex)
+{
+    // The last projectile takes the place of the one removed
+    const auto lastIndex = mNames.size() - 1;
+    mIndicesByName.erase(mNames[projectileIndex]);
+
+    if (projectileIndex != lastIndex)
+    {
+        mPositionsX[projectileIndex] = mPositionsX[lastIndex];
+        mPositionsY[projectileIndex] = mPositionsY[lastIndex];
+        mVelocitiesX[projectileIndex] = mVelocitiesX[lastIndex];
+        mVelocitiesY[projectileIndex] = mVelocitiesY[lastIndex];
+        mRadii[projectileIndex] = mRadii[lastIndex];
+        mCategoryBits[projectileIndex] = mCategoryBits[lastIndex];
+        mMaskBits[projectileIndex] = mMaskBits[lastIndex];
+        mNames[projectileIndex] = mNames[lastIndex];
+        mIndicesByName[mNames[projectileIndex]] = static_cast<uint32_t>(projectileIndex);
+    }
+
+    mPositionsX.pop_back();
+    mPositionsY.pop_back();
+    mVelocitiesX.pop_back();
+    mVelocitiesY.pop_back();
+    mRadii.pop_back();
+    mCategoryBits.pop_back();
+    mMaskBits.pop_back();
+    mNames.pop_back();
+}
+
+///------------------------------------------------------------------------------------------------
+
+namespace projectile_simulation
+{
+
+///------------------------------------------------------------------------------------------------
+
+static const float BENCHMARK_STEP_SECONDS = 1.0f/60.0f;
+static const float BENCHMARK_PROJECTILE_SPEED = 16.0f;
+static const float BENCHMARK_PROJECTILE_RADIUS = 0.25f;
+static const float BENCHMARK_FIELD_HALF_WIDTH = 10.0f;
+static const float BENCHMARK_FIELD_MIN_Y = -15.0f;
+static const float BENCHMARK_FIELD_MAX_Y = 20.0f;
+static const float BENCHMARK_ENEMY_HALF_SIZE = 1.0f;
+static const int BENCHMARK_ENEMY_COLUMNS = 6;
+static const int BENCHMARK_ENEMY_ROWS = 4;
+static const unsigned int BENCHMARK_SEED = 1337;
+
+///------------------------------------------------------------------------------------------------
+
+std::vector<std::string> BenchmarkProjectileSimulation(const int projectileCount, const int stepCount)
+{
+    // A wave of enemies halfway up the field and a bullet only wall at the top of it, with projectiles
+    // fired upwards from all over the field. Projectiles hitting anything get replaced by new ones
+    // at the bottom of the field, so that the projectile count stays the same throughout.
+    std::vector<glm::vec2> enemyPositions;
+    for (int row = 0; row < BENCHMARK_ENEMY_ROWS; ++row)
+    {
+        for (int column = 0; column < BENCHMARK_ENEMY_COLUMNS; ++column)
+        {
+            enemyPositions.emplace_back(-7.5f + column * 3.0f, 5.0f + row * 2.5f);
+        }
+    }
+
+    b2Filter projectileFilter;
+    projectileFilter.categoryBits = physics_constants::PLAYER_BULLET_CATEGORY_BIT;
+    projectileFilter.maskBits = physics_constants::ENEMY_CATEGORY_BIT | physics_constants::BULLET_ONLY_WALL_CATEGORY_BIT;
+
+    b2Filter enemyFilter;
+    enemyFilter.categoryBits = physics_constants::ENEMY_CATEGORY_BIT;
+    enemyFilter.maskBits = physics_constants::PLAYER_BULLET_CATEGORY_BIT;
+
+    b2Filter wallFilter;
+    wallFilter.categoryBits = physics_constants::BULLET_ONLY_WALL_CATEGORY_BIT;
+    wallFilter.maskBits = physics_constants::PLAYER_BULLET_CATEGORY_BIT;
+
+    std::mt19937 projectileRng(BENCHMARK_SEED);
+    std::uniform_real_distribution<float> xDistribution(-BENCHMARK_FIELD_HALF_WIDTH, BENCHMARK_FIELD_HALF_WIDTH);
+    std::uniform_real_distribution<float> yDistribution(BENCHMARK_FIELD_MIN_Y, BENCHMARK_FIELD_MAX_Y);
+
+    std::vector<glm::vec2> initialPositions;
+    std::vector<float> respawnXs;
+    for (int i = 0; i < projectileCount; ++i)
+    {
+        initialPositions.emplace_back(xDistribution(projectileRng), yDistribution(projectileRng));
+        respawnXs.push_back(xDistribution(projectileRng));
+    }
+
+    auto getMillisSince = [](const Uint64 startCounter)
+    {
+        return static_cast<double>(SDL_GetPerformanceCounter() - startCounter) * 1000.0/SDL_GetPerformanceFrequency();
+    };
+
+    // Box2D: every projectile a dynamic body, with hits coming in through the collision listener
+    long long box2dHitCount = 0;
+    double box2dMillis = 0.0;
+    {
+        b2World box2dWorld(b2Vec2(0.0f, 0.0f));
+        PhysicsCollisionListener collisionListener;
+        box2dWorld.SetContactListener(&collisionListener);
+
+        std::vector<b2Body*> spentBodies;
+        auto onBox2dHit = [&spentBodies, &box2dHitCount](b2Body*, b2Body* projectileBody)
+        {
+            auto projectileFilter = projectileBody->GetFixtureList()[0].GetFilterData();
+            projectileFilter.maskBits = 0;
+            projectileBody->GetFixtureList()[0].SetFilterData(projectileFilter);
+            spentBodies.push_back(projectileBody);
+            box2dHitCount++;
+        };
+        collisionListener.RegisterCollisionCallback(UnorderedCollisionCategoryPair(physics_constants::ENEMY_CATEGORY_BIT, physics_constants::PLAYER_BULLET_CATEGORY_BIT), onBox2dHit);
+        collisionListener.RegisterCollisionCallback(UnorderedCollisionCategoryPair(physics_constants::BULLET_ONLY_WALL_CATEGORY_BIT, physics_constants::PLAYER_BULLET_CATEGORY_BIT), onBox2dHit);
+
+        auto createBody = [&box2dWorld](const b2BodyType bodyType, const glm::vec2& position, const glm::vec2& halfSize, const b2Filter& filter)
+        {
+            b2BodyDef bodyDef;
+            bodyDef.type = bodyType;
+            bodyDef.position.Set(position.x, position.y);
+
+            b2PolygonShape shape;
+            shape.SetAsBox(halfSize.x, halfSize.y);
+
+            b2FixtureDef fixtureDef;
+            fixtureDef.shape = &shape;
+            fixtureDef.filter = filter;
+            fixtureDef.density = 0.01f;
+
+            auto* body = box2dWorld.CreateBody(&bodyDef);
+            body->CreateFixture(&fixtureDef);
+            body->SetLinearVelocity(b2Vec2(0.0f, bodyType == b2_dynamicBody ? BENCHMARK_PROJECTILE_SPEED : 0.0f));
+            return body;
+        };
+
+        for (const auto& enemyPosition: enemyPositions)
+        {
+            createBody(b2_kinematicBody, enemyPosition, glm::vec2(BENCHMARK_ENEMY_HALF_SIZE), enemyFilter);
+        }
+        createBody(b2_staticBody, glm::vec2(0.0f, BENCHMARK_FIELD_MAX_Y), glm::vec2(BENCHMARK_FIELD_HALF_WIDTH * 2.0f, 0.1f), wallFilter);
+
+        for (const auto& initialPosition: initialPositions)
+        {
+            createBody(b2_dynamicBody, initialPosition, glm::vec2(BENCHMARK_PROJECTILE_RADIUS), projectileFilter);
+        }
+
+        size_t respawnIndex = 0;
+        const auto startCounter = SDL_GetPerformanceCounter();
+        for (int step = 0; step < stepCount; ++step)
+        {
+            box2dWorld.Step(BENCHMARK_STEP_SECONDS, physics_constants::WORLD_VELOCITY_ITERATIONS, physics_constants::WORLD_POSITION_ITERATIONS);
+            collisionListener.DispatchCollisionEvents();
+
+            for (auto* spentBody: spentBodies)
+            {
+                box2dWorld.DestroyBody(spentBody);
+                createBody(b2_dynamicBody, glm::vec2(respawnXs[respawnIndex++ % respawnXs.size()], BENCHMARK_FIELD_MIN_Y), glm::vec2(BENCHMARK_PROJECTILE_RADIUS), projectileFilter);
+            }
+            spentBodies.clear();
+        }
+        box2dMillis = getMillisSince(startCounter);
+    }
+
+    // Projectile system: the same projectiles against the same targets
+    long long projectileHitCount = 0;
+    double projectileMillis = 0.0;
+    {
+        ProjectileSystem projectileSystem;
+
+        std::vector<strutils::StringId> spentProjectiles;
+        auto onProjectileHit = [&spentProjectiles, &projectileHitCount](const strutils::StringId& projectileName, b2Body*)
+        {
+            spentProjectiles.push_back(projectileName);
+            projectileHitCount++;
+            return true;
+        };
+        projectileSystem.RegisterHitCallback(physics_constants::PLAYER_BULLET_CATEGORY_BIT, physics_constants::ENEMY_CATEGORY_BIT, onProjectileHit);
+        projectileSystem.RegisterHitCallback(physics_constants::PLAYER_BULLET_CATEGORY_BIT, physics_constants::BULLET_ONLY_WALL_CATEGORY_BIT, onProjectileHit);
+
+        std::vector<ProjectileSystem::Target> targets;
+        for (const auto& enemyPosition: enemyPositions)
+        {
+            targets.push_back({ enemyPosition - glm::vec2(BENCHMARK_ENEMY_HALF_SIZE), enemyPosition + glm::vec2(BENCHMARK_ENEMY_HALF_SIZE), nullptr, nullptr, enemyFilter.categoryBits, enemyFilter.maskBits });
+        }
+        targets.push_back({ glm::vec2(-BENCHMARK_FIELD_HALF_WIDTH * 2.0f, BENCHMARK_FIELD_MAX_Y - 0.1f), glm::vec2(BENCHMARK_FIELD_HALF_WIDTH * 2.0f, BENCHMARK_FIELD_MAX_Y + 0.1f), nullptr, nullptr, wallFilter.categoryBits, wallFilter.maskBits });
+
+        for (const auto& initialPosition: initialPositions)
+        {
+            projectileSystem.AddProjectile(initialPosition, glm::vec2(0.0f, BENCHMARK_PROJECTILE_SPEED), BENCHMARK_PROJECTILE_RADIUS, projectileFilter);
+        }
+
+        size_t respawnIndex = 0;
+        const auto startCounter = SDL_GetPerformanceCounter();
+        for (int step = 0; step < stepCount; ++step)
+        {
+            // Targets get rebuilt every step, as they would be from a world with moving enemies
+            projectileSystem.Integrate(BENCHMARK_STEP_SECONDS);
+            projectileSystem.SetTargets(targets);
+            projectileSystem.FindHits();
+            projectileSystem.DispatchHits();
+
+            for (const auto& spentProjectile: spentProjectiles)
+            {
+                projectileSystem.RemoveProjectile(spentProjectile);
+                projectileSystem.AddProjectile(glm::vec2(respawnXs[respawnIndex++ % respawnXs.size()], BENCHMARK_FIELD_MIN_Y), glm::vec2(0.0f, BENCHMARK_PROJECTILE_SPEED), BENCHMARK_PROJECTILE_RADIUS, projectileFilter);
+            }
+            spentProjectiles.clear();
+        }
+        projectileMillis = getMillisSince(startCounter);
+    }
+
+    std::vector<std::string> results =
+    {
+        "Box2D bodies: " + strutils::FloatToString(static_cast<float>(box2dMillis/stepCount), 4) + " ms/step (" + std::to_string(box2dHitCount) + " hits)",
+        "Projectile system: " + strutils::FloatToString(static_cast<float>(projectileMillis/stepCount), 4) + " ms/step (" + std::to_string(projectileHitCount) + " hits)",
+        "Speedup: " + strutils::FloatToString(static_cast<float>(box2dMillis/std::max(projectileMillis, 1e-6)), 2) + "x"
+    };
+
+    for (const auto& result: results)
+    {
+        Log(LogType::INFO, "Projectile simulation benchmark (%d projectiles, %d steps) %s", projectileCount, stepCount, result.c_str());
+    }
+
+    return results;
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
@@ -0,0 +1,203 @@
+///------------------------------------------------------------------------------------------------
+///  ProjectileSystem.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef ProjectileSystem_h
+#define ProjectileSystem_h
+
+///------------------------------------------------------------------------------------------------
+
+#include "PhysicsCollisionListener.h"
+#include "SceneObject.h"
+#include "../utils/MathUtils.h"
+#include "../utils/SmallFunction.h"
+#include "../utils/StringUtils.h"
+
+#include <array>
+#include <Box2D/Box2D.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+class SnapshotReader;
+class SnapshotWriter;
+
+///------------------------------------------------------------------------------------------------
+
+/// Simulates bullets outside of Box2D. Bullets only ever move in straight lines at a constant velocity,
+/// and only ever need to know what they hit, so they are kept in flat arrays (position, velocity, radius
+/// and team, i.e. contact filter), moved a handful at a time with SIMD, and tested against the fixtures of
+/// the b2World (ships, bosses and walls) through a uniform grid of their boxes, followed by the exact shape
+/// test for the ones whose box they overlap. Hits are reported to the callback registered
+/// for the projectile's and the target's categories, after the step is over.
+///
+/// Projectiles are named like scene objects are, with the scene object of a projectile (carrying its
+/// animation) being moved along by SyncSceneObjects.
+class ProjectileSystem final
+{
+public:
+    // Hit callbacks only ever capture their owner, so they are always stored in place
+    static constexpr size_t HIT_CALLBACK_BUFFER_SIZE = 16;
+
+    /// Invoked with the name of the projectile and the body of the target it hit.
+    /// Returns whether the projectile is spent, in which case it won't hit anything else.
+    using HitCallback = SmallFunction<bool(const strutils::StringId& projectileName, b2Body* targetBody), HIT_CALLBACK_BUFFER_SIZE>;
+
+    /// A fixture projectiles can hit, bounded by its (world space) box. Targets without a fixture are hit
+    /// anywhere in their box, while the ones with a fixture need its actual shape to be overlapped.
+    struct Target
+    {
+        glm::vec2 mMin;
+        glm::vec2 mMax;
+        b2Body* mBody;
+        const b2Fixture* mFixture;
+        uint16 mCategoryBits;
+        uint16 mMaskBits;
+    };
+
+    struct ProjectileState
+    {
+        strutils::StringId mName;
+        glm::vec2 mPosition;
+        glm::vec2 mVelocity;
+        float mRadius;
+        uint16 mCategoryBits;
+        uint16 mMaskBits;
+    };
+
+    ProjectileSystem();
+
+    ProjectileSystem(const ProjectileSystem&) = delete;
+    ProjectileSystem(ProjectileSystem&&) = delete;
+    const ProjectileSystem& operator = (const ProjectileSystem&) = delete;
+    ProjectileSystem& operator = (ProjectileSystem&&) = delete;
+
+    /// Registers the callback to respond to projectiles of the given category hitting targets of the other one,
+    /// replacing any callback registered for them before. Both categories need to be single bits.
+    template<typename CallbackT>
+    void RegisterHitCallback(const uint16 projectileCategory, const uint16 targetCategory, CallbackT&& callback)
+    {
+        static_assert(HitCallback::IsStoredInPlace<std::decay_t<CallbackT>>(), "Hit callbacks should only capture their owner");
+        SetHitCallback(projectileCategory, targetCategory, HitCallback(std::forward<CallbackT>(callback)));
+    }
+
+    void ClearHitCallbacks();
+
+    /// @param[in] position the starting position of the projectile.
+    /// @param[in] velocity the velocity (per second) the projectile moves at.
+    /// @param[in] radius the radius of the projectile.
+    /// @param[in] filter the contact filter of the projectile, with the same semantics as Box2D's.
+    /// @returns the name of the projectile added.
+    strutils::StringId AddProjectile(const glm::vec2& position, const glm::vec2& velocity, const float radius, const b2Filter& filter);
+
+    void RemoveProjectile(const strutils::StringId& projectileName);
+    void RemoveAllProjectiles();
+
+    bool HasProjectile(const strutils::StringId& projectileName) const;
+    size_t GetProjectileCount() const;
+
+    /// Moves all projectiles, and finds the ones hitting any of the fixtures of the given world (for DispatchHits).
+    /// @param[in] dtSeconds the duration of the step.
+    /// @param[in] box2dWorld the world the targets of the projectiles live in.
+    void Step(const float dtSeconds, b2World& box2dWorld);
+
+    /// Moves all projectiles by their velocity over the given duration.
+    void Integrate(const float dtSeconds);
+
+    /// Replaces the targets with the fixtures of the given world that any projectile could hit.
+    void GatherTargets(b2World& box2dWorld);
+
+    /// Replaces the targets with the given ones.
+    void SetTargets(const std::vector<Target>& targets);
+
+    /// Finds the (first) target each projectile overlaps, if any, out of the ones it could hit.
+    void FindHits();
+
+    /// Invokes the callbacks of the hits found since the last dispatch, in the order of the projectiles that made them.
+    void DispatchHits();
+
+    /// @returns the number of hits pending dispatch.
+    size_t GetPendingHitCount() const;
+
+    /// Moves the scene objects of projectiles to them, with their previous positions
+    /// kept for rendering them in between simulation steps.
+    void SyncSceneObjects(std::vector<SceneObject>& sceneObjects) const;
+
+    void WriteSnapshot(SnapshotWriter& writer) const;
+
+    /// Reads the projectiles written by WriteSnapshot, for RestoreProjectiles to put them back.
+    /// @param[out] outProjectiles the projectiles read.
+    /// @param[out] outNextProjectileId the id the next projectile added gets named after.
+    static void ReadSnapshot(SnapshotReader& reader, std::vector<ProjectileState>& outProjectiles, uint32_t& outNextProjectileId);
+
+    /// Replaces all projectiles with the given ones.
+    void RestoreProjectiles(const std::vector<ProjectileState>& projectiles, const uint32_t nextProjectileId);
+
+private:
+    void SetHitCallback(const uint16 projectileCategory, const uint16 targetCategory, HitCallback&& callback);
+    void RemoveProjectileAt(const size_t projectileIndex);
+    void BuildGrid();
+
+private:
+    static constexpr size_t CATEGORY_COUNT = PhysicsCollisionListener::COLLISION_CATEGORY_COUNT;
+
+    struct Hit
+    {
+        strutils::StringId mProjectileName; // Callbacks are free to remove projectiles, so hits don't hold on to their indices
+        uint32_t mTargetIndex;
+    };
+
+    // Projectiles, one array per attribute (the positions and velocities being the ones integrated)
+    std::vector<float> mPositionsX;
+    std::vector<float> mPositionsY;
+    std::vector<float> mVelocitiesX;
+    std::vector<float> mVelocitiesY;
+    std::vector<float> mRadii;
+    std::vector<uint16> mCategoryBits;
+    std::vector<uint16> mMaskBits;
+    std::vector<strutils::StringId> mNames;
+    std::unordered_map<strutils::StringId, uint32_t, strutils::StringIdHasher> mIndicesByName;
+
+    // Targets, and the uniform grid of the cells they overlap (as offsets into the flat list of target indices per cell)
+    std::vector<Target> mTargets;
+    std::vector<uint32_t> mCellTargetOffsets;
+    std::vector<uint32_t> mCellTargetIndices;
+    std::vector<uint32_t> mCellTargetCursors;
+    glm::vec2 mGridOrigin;
+    float mGridCellSize;
+    int mGridColumns;
+    int mGridRows;
+
+    std::array<HitCallback, CATEGORY_COUNT * CATEGORY_COUNT> mHitCallbacks;
+    std::array<uint16, CATEGORY_COUNT> mHitTargetCategories; // Per projectile category, the target categories it has callbacks for
+    std::vector<Hit> mHits;
+    uint16 mTargetCategories;
+    uint32_t mNextProjectileId;
+};
+
+///------------------------------------------------------------------------------------------------
+
+namespace projectile_simulation
+{
+
+///------------------------------------------------------------------------------------------------
+/// Compares simulating the given number of live projectiles (fired upwards from random positions, against a
+/// wave's worth of enemy targets and a wall) through the ProjectileSystem, against the same projectiles
+/// being dynamic bodies of a b2World.
+/// @param[in] projectileCount how many projectiles to keep alive.
+/// @param[in] stepCount how many 60fps simulation steps to run.
+/// @returns the human readable results (also logged).
+std::vector<std::string> BenchmarkProjectileSimulation(const int projectileCount, const int stepCount);
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* ProjectileSystem_h */
@@ -10,8 +10,12 @@
 
 ///------------------------------------------------------------------------------------------------
 
+#include "../utils/MathUtils.h"
+#include "../utils/SmallFunction.h"
 #include "../utils/StringUtils.h"
 
+#include <optional>
+
 ///------------------------------------------------------------------------------------------------
 
 class RepeatableFlow
@@ -22,10 +26,21 @@ public:
         ONCE, REPEAT
     };
     
-    using CallbackT = std::function<void()>;
+    // Sized to fit the captures of the most numerous flows (e.g. enemy projectile flows) in place
+    static constexpr size_t CALLBACK_BUFFER_SIZE = 96;
+    using CallbackT = SmallFunction<void(), CALLBACK_BUFFER_SIZE>;
+    
+    // Callbacks can't be serialized, so flows that need to survive a level snapshot carry a description
+    // of what they do instead, from which their owner can recreate them (see LevelUpdater::RecreateFlow)
+    struct RestoreTag
+    {
+        strutils::StringId mKind;
+        strutils::StringId mSubjectName;
+        glm::vec3 mPosition = glm::vec3(0.0f);
+    };
     
     RepeatableFlow(CallbackT callback, float durationMillis, RepeatPolicy repeatPolicy, strutils::StringId name = strutils::StringId()):
-          mCallback(callback)
+          mCallback(std::move(callback))
         , mTargetDuration(durationMillis)
         , mTicksLeft(durationMillis)
         , mRepeatPolicy(repeatPolicy)
@@ -37,6 +52,10 @@ public:
     inline const strutils::StringId& GetName() const { return mName; }
     inline float GetDuration() const { return mTargetDuration; }
     inline float GetTicksLeft() const { return mTicksLeft; }
+    inline RepeatPolicy GetRepeatPolicy() const { return mRepeatPolicy; }
+    inline const std::optional<RestoreTag>& GetRestoreTag() const { return mRestoreTag; }
+    
+    inline void SetRestoreTag(const RestoreTag& restoreTag) { mRestoreTag = restoreTag; }
     
     inline void ForceFinish() { mIsRunning = false; }
     inline void SetDuration(float durationMillis) { mTargetDuration = durationMillis; }
@@ -61,12 +80,15 @@ public:
     }
     
 private:
+    friend class FlowScheduler;
+    
     CallbackT mCallback;
     float mTargetDuration;
     float mTicksLeft;
     RepeatPolicy mRepeatPolicy;
     bool mIsRunning;
     strutils::StringId mName;
+    std::optional<RestoreTag> mRestoreTag;
 };
 
 ///------------------------------------------------------------------------------------------------
@@ -35,6 +35,7 @@ static const strutils::StringId UPGRADE_TEXT_NAME = strutils::StringId("UPGRADE_
 static const strutils::StringId UNLOCK_BAR_NAME = strutils::StringId("UNLOCK_BAR");
 static const strutils::StringId UNLOCK_BAR_FRAME_NAME = strutils::StringId("UNLOCK_BAR_FRAME");
 static const strutils::StringId UNLOCK_BAR_TEXT_NAME = strutils::StringId("UNLOCK_BAR_TEXT");
+static const strutils::StringId RESEARCH_OPTIONS_CREATION_WORK_NAME = strutils::StringId("research_options_creation");
 
 static const char* LEFT_NAVIGATION_ARROW_TEXTURE_FILE_NAME = "left_navigation_arrow_mm.bmp";
 static const char* CONFIRMATION_BUTTON_TEXTURE_FILE_NAME = "confirmation_button_mm.bmp";
@@ -78,11 +79,12 @@ static const float UNLOCKED_UPGRADE_SHINE_SPEED = 1.0f/200.0f;
 ResearchUpdater::ResearchUpdater(Scene& scene)
     : mScene(scene)
     , mStateMachine(&scene, nullptr, nullptr, nullptr)
-    , mOptionSelectionState(OptionSelectionState::OPTION_NOT_SELECTED)
+    , mOptionSelectionState(OptionSelectionState::CREATING_OPTIONS)
     , mSelectedUpgrade()
     , mCurrentOperationCrystalCost(0)
     , mOptionShakeMagnitude(1.0f)
     , mCarouselMoving(false)
+    , mOptionsCreationWorkHandle(INVALID_WORK_HANDLE)
 {
 #ifdef DEBUG
     mStateMachine.RegisterState<DebugConsoleGameState>();
@@ -90,13 +92,13 @@ ResearchUpdater::ResearchUpdater(Scene& scene)
     mStateMachine.RegisterState<SettingsMenuGameState>();
     
     CreateSceneObjects();
-    OnCarouselStationary();
 }
 
 ///------------------------------------------------------------------------------------------------
 
 ResearchUpdater::~ResearchUpdater()
 {
+    FrameWorkScheduler::GetInstance().CancelWork(mOptionsCreationWorkHandle);
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -108,8 +110,15 @@ PostStateUpdateDirective ResearchUpdater::VUpdate(std::vector<SceneObject>& scen
         return PostStateUpdateDirective::BLOCK_UPDATE;
     }
     
+    // Nothing to interact with (or animate) until the options are in place
+    if (mOptionSelectionState == OptionSelectionState::CREATING_OPTIONS)
+    {
+        return PostStateUpdateDirective::CONTINUE;
+    }
+    
     switch (mOptionSelectionState)
     {
+        case OptionSelectionState::CREATING_OPTIONS: break;
         case OptionSelectionState::OPTION_NOT_SELECTED:
         {
             auto camOpt = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::WorldGameObject);
@@ -380,23 +389,29 @@ void ResearchUpdater::CreateSceneObjects()
         mScene.AddSceneObject(std::move(arrowSo));
     }
 
-    // Options
-    std::vector<resources::ResourceId> researchOptionTextures;
-    std::unordered_set<size_t> lockedIndices;
-    
-    for (size_t i = 0; i < GameSingletons::GetAvailableUpgrades().size(); ++i)
+    // Options. Their textures are loaded one per step over the next frames, with the
+    // carousel created (and the option selection started) once they all have been
+    mOptionsCreationWorkHandle = FrameWorkScheduler::GetInstance().SubmitWork(RESEARCH_OPTIONS_CREATION_WORK_NAME, WorkPriority::NORMAL, [this, researchOptionTextures = std::vector<resources::ResourceId>(), lockedIndices = std::unordered_set<size_t>()]() mutable
     {
-        auto& availableUpgrade = GameSingletons::GetAvailableUpgrades().at(i);
-        if (!availableUpgrade.mUnlocked)
+        const auto& availableUpgrades = GameSingletons::GetAvailableUpgrades();
+        if (mUpgrades.size() < availableUpgrades.size())
         {
-            lockedIndices.insert(i);
+            const auto& availableUpgrade = availableUpgrades.at(mUpgrades.size());
+            if (!availableUpgrade.mUnlocked)
+            {
+                lockedIndices.insert(mUpgrades.size());
+            }
+            
+            mUpgrades.push_back(availableUpgrade.mUpgradeNameId);
+            researchOptionTextures.push_back(resources::ResourceLoadingService::GetInstance().LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + availableUpgrade.mTextureFileName));
+            return WorkStepResult::CONTINUE;
         }
         
-        mUpgrades.push_back(availableUpgrade.mUpgradeNameId);
-        researchOptionTextures.push_back(resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + availableUpgrade.mTextureFileName));
-    }
-    
-    mCarouselController = std::make_unique<CarouselController>(mScene, researchOptionTextures, [&](){ OnCarouselMovementStart(); }, [&](){ OnCarouselStationary(); }, 2.0f, lockedIndices);
+        mCarouselController = std::make_unique<CarouselController>(mScene, researchOptionTextures, [&](){ OnCarouselMovementStart(); }, [&](){ OnCarouselStationary(); }, 2.0f, lockedIndices);
+        mOptionSelectionState = OptionSelectionState::OPTION_NOT_SELECTED;
+        OnCarouselStationary();
+        return WorkStepResult::FINISHED;
+    });
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -12,6 +12,7 @@
 
 #include "RepeatableFlow.h"
 #include "IUpdater.h"
+#include "FrameWorkScheduler.h"
 #include "StateMachine.h"
 #include "UpgradeUnlockedHandler.h"
 
@@ -53,7 +54,7 @@ private:
 private:
     enum class OptionSelectionState
     {
-        OPTION_NOT_SELECTED, EXPEND_CRYSTALS, UNLOCK_SHAKE, UNLOCK_TEXTURE_TRANSITION, TRANSITIONING_TO_NEXT_SCREEN
+        CREATING_OPTIONS, OPTION_NOT_SELECTED, EXPEND_CRYSTALS, UNLOCK_SHAKE, UNLOCK_TEXTURE_TRANSITION, TRANSITIONING_TO_NEXT_SCREEN
     };
     
     Scene& mScene;
@@ -69,6 +70,7 @@ private:
     long mCurrentOperationCrystalCost;
     float mOptionShakeMagnitude;
     bool mCarouselMoving;
+    WorkHandle mOptionsCreationWorkHandle;
 };
 
 
@@ -11,7 +11,10 @@
 #include "ChestRewardUpdater.h"
 #include "EventUpdater.h"
 #include "GameConstants.h"
+#include "InputRecording.h"
 #include "LabUpdater.h"
+#include "LevelGeneration.h"
+#include "LevelSnapshot.h"
 #include "MainMenuUpdater.h"
 #include "MapUpdater.h"
 #include "LevelUpdater.h"
@@ -19,6 +22,7 @@
 #include "PhysicsConstants.h"
 #include "ResearchUpdater.h"
 #include "SceneObjectUtils.h"
+#include "SimulationProfiler.h"
 #include "StatsUpgradeUpdater.h"
 #include "Sounds.h"
 #include "ObjectTypeDefinitionRepository.h"
@@ -71,11 +75,15 @@ static const std::unordered_set<strutils::StringId, strutils::StringIdHasher> GU
 
 ///------------------------------------------------------------------------------------------------
 
-Scene::Scene()
-    : mBox2dWorld(b2Vec2(0.0f, 0.0f))
+Scene::Scene(GameContext& gameContext)
+    : mGameContext(gameContext)
+    , mBox2dWorld(b2Vec2(0.0f, 0.0f))
+    , mCollisionListener()
+    , mProjectileSystem()
     , mSceneUpdater(nullptr)
     , mTransitionParameters(nullptr)
     , mSceneRenderer(mBox2dWorld)
+    , mSceneChangeCount(0)
     , mPreFirstUpdate(true)
     , mSceneEditMode(false)
     , mProgressResetFlag(false)
@@ -83,8 +91,10 @@ Scene::Scene()
     FontRepository::GetInstance().LoadFont(game_constants::DEFAULT_FONT_NAME);
     FontRepository::GetInstance().LoadFont(game_constants::DEFAULT_FONT_MM_NAME);
     
-    GameSingletons::SetCameraForSceneObjectType(SceneObjectType::WorldGameObject, Camera());
-    GameSingletons::SetCameraForSceneObjectType(SceneObjectType::GUIObject, Camera());
+    mGameContext.SetCameraForSceneObjectType(SceneObjectType::WorldGameObject, Camera());
+    mGameContext.SetCameraForSceneObjectType(SceneObjectType::GUIObject, Camera());
+    
+    mBox2dWorld.SetContactListener(&mCollisionListener);
     
     // Set fallback assets
     resources::ResourceLoadingService::GetInstance().SetFallbackTexture(resources::ResourceLoadingService::RES_TEXTURES_ROOT + "debug.bmp");
@@ -99,6 +109,11 @@ Scene::Scene()
 Scene::~Scene()
 {
     HandleProgressReset();
+    
+    for (const auto resourceId: mAccumulatedResourcesForScene)
+    {
+        resources::ResourceLoadingService::GetInstance().ReleaseResource(resourceId);
+    }
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -110,6 +125,20 @@ std::string Scene::GetSceneStateDescription() const
 
 ///------------------------------------------------------------------------------------------------
 
+GameContext& Scene::GetGameContext()
+{
+    return mGameContext;
+}
+
+///------------------------------------------------------------------------------------------------
+
+const GameContext& Scene::GetGameContext() const
+{
+    return mGameContext;
+}
+
+///------------------------------------------------------------------------------------------------
+
 std::optional<std::reference_wrapper<SceneObject>> Scene::GetSceneObject(const b2Body* body)
 {
     auto findIter = std::find_if(mSceneObjects.begin(), mSceneObjects.end(), [&](SceneObject& so)
@@ -256,14 +285,23 @@ const LightRepository& Scene::GetLightRepository() const
 
 ///------------------------------------------------------------------------------------------------
 
+PhysicsCollisionListener& Scene::GetCollisionListener()
+{
+    return mCollisionListener;
+}
+
+///------------------------------------------------------------------------------------------------
+
+ProjectileSystem& Scene::GetProjectileSystem()
+{
+    return mProjectileSystem;
+}
+
+///------------------------------------------------------------------------------------------------
+
 void Scene::AddSceneObject(SceneObject&& sceneObject)
 {
-    if (sceneObject.mAnimation)
-    {
-        mAccumulatedResourcesForScene.insert(sceneObject.mAnimation->VGetCurrentTextureResourceId());
-        mAccumulatedResourcesForScene.insert(sceneObject.mAnimation->VGetCurrentMeshResourceId());
-        mAccumulatedResourcesForScene.insert(sceneObject.mAnimation->VGetCurrentShaderResourceId());
-    }
+    AccumulateSceneObjectResources(sceneObject);
     
     if (mPreFirstUpdate)
     {
@@ -285,6 +323,48 @@ void Scene::RemoveAllSceneObjectsWithName(const strutils::StringId& name)
 
 ///------------------------------------------------------------------------------------------------
 
+void Scene::ReplaceSceneObjects(std::vector<SceneObject>&& sceneObjects)
+{
+    std::vector<SceneObject> crossSceneSceneObjects;
+    
+    for (auto* sceneObjectList: { &mSceneObjects, &mSceneObjectsToAdd })
+    {
+        for (auto& so: *sceneObjectList)
+        {
+            if (so.mCrossSceneLifetime)
+            {
+                crossSceneSceneObjects.push_back(std::move(so));
+            }
+            else if (so.mBody)
+            {
+                delete static_cast<strutils::StringId*>(so.mBody->GetUserData());
+                mBox2dWorld.DestroyBody(so.mBody);
+            }
+        }
+    }
+    
+    mSceneObjects = std::move(sceneObjects);
+    mSceneObjectsToAdd.clear();
+    mNamesOfSceneObjectsToRemove.clear();
+    mProjectileSystem.RemoveAllProjectiles();
+    
+    for (const auto& so: mSceneObjects)
+    {
+        AccumulateSceneObjectResources(so);
+    }
+    
+    std::move(crossSceneSceneObjects.begin(), crossSceneSceneObjects.end(), std::back_inserter(mSceneObjects));
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool Scene::HasPendingChanges() const
+{
+    return mOverlayController || !mSceneObjectsToAdd.empty() || !mNamesOfSceneObjectsToRemove.empty();
+}
+
+///------------------------------------------------------------------------------------------------
+
 void Scene::SetProgressResetFlag()
 {
     mProgressResetFlag = true;
@@ -298,10 +378,20 @@ void Scene::ChangeScene(const TransitionParameters& transitionParameters)
     // the scene creation needs to be deferred, and we don't want the stored lambda
     // to have an invalid reference to this temporary
     mTransitionParameters = std::make_unique<TransitionParameters>(transitionParameters.mSceneType, transitionParameters.mSceneNameToTransitionTo, transitionParameters.mUseOverlay);
+    mSceneChangeCount++;
+    
+    // A level snapshot is only meant to resume the level it was taken from, so leaving
+    // the level (finishing it, dying, quitting etc..) discards it. Headless runs and replays
+    // never persist one, so they must not discard the player's either.
+    if (dynamic_cast<LevelUpdater*>(mSceneUpdater.get()) && !mGameContext.IsHeadless() && !InputReplayer::GetInstance().IsReplaying())
+    {
+        level_snapshot::DeleteSnapshotFile();
+    }
     
     auto sceneCreationLambda = [&]()
     {
         HandleProgressReset();
+        LogSceneTextureMemoryUsage();
         
         std::vector<SceneObject> crossSceneSceneObjects;
         std::unordered_set<resources::ResourceId> lockedResourceIds;
@@ -330,25 +420,35 @@ void Scene::ChangeScene(const TransitionParameters& transitionParameters)
             }
         }
         
+        // Resources of the cross scene objects stay acquired by this scene. The rest only get
+        // unloaded if no other scene (i.e. another game instance) still holds them.
+        std::unordered_set<resources::ResourceId> retainedResourceIds;
         for (const auto resourceId: mAccumulatedResourcesForScene)
         {
             if (lockedResourceIds.count(resourceId) == 0)
             {
-                resources::ResourceLoadingService::GetInstance().UnloadResource(resourceId);
+                resources::ResourceLoadingService::GetInstance().ReleaseResource(resourceId);
+            }
+            else
+            {
+                retainedResourceIds.insert(resourceId);
             }
         }
         
         mSceneObjects.clear();
         mSceneObjectsToAdd.clear();
-        mAccumulatedResourcesForScene.clear();
+        mAccumulatedResourcesForScene = std::move(retainedResourceIds);
         
         mLightRepository.RemoveAllLights();
+        mCollisionListener.ClearCollisionCallbacks();
+        mProjectileSystem.ClearHitCallbacks();
+        mProjectileSystem.RemoveAllProjectiles();
         
         FontRepository::GetInstance().LoadFont(game_constants::DEFAULT_FONT_NAME);
         FontRepository::GetInstance().LoadFont(game_constants::DEFAULT_FONT_MM_NAME);
         
-        GameSingletons::SetCameraForSceneObjectType(SceneObjectType::WorldGameObject, Camera());
-        GameSingletons::SetCameraForSceneObjectType(SceneObjectType::GUIObject, Camera());
+        mGameContext.SetCameraForSceneObjectType(SceneObjectType::WorldGameObject, Camera());
+        mGameContext.SetCameraForSceneObjectType(SceneObjectType::GUIObject, Camera());
         
         resources::ResourceLoadingService::GetInstance().SetFallbackTexture(resources::ResourceLoadingService::RES_TEXTURES_ROOT + "debug.bmp");
         resources::ResourceLoadingService::GetInstance().SetFallbackMesh(resources::ResourceLoadingService::RES_MESHES_ROOT + "quad.obj");
@@ -393,8 +493,20 @@ void Scene::ChangeScene(const TransitionParameters& transitionParameters)
                 
             case SceneType::LEVEL:
             {
-                LevelDataLoader levelDataLoader;
-                auto levelDef = levelDataLoader.LoadLevel(mTransitionParameters->mSceneNameToTransitionTo);
+                // Generated levels are served straight from the generation cache, with static
+                // (e.g. test) levels still loaded from their data files
+                LevelDefinition levelDef;
+                const auto* generatedLevelDef = level_generation::FindGeneratedLevel(mTransitionParameters->mSceneNameToTransitionTo);
+                if (generatedLevelDef)
+                {
+                    levelDef = *generatedLevelDef;
+                }
+                else
+                {
+                    LevelDataLoader levelDataLoader;
+                    levelDef = levelDataLoader.LoadLevel(mTransitionParameters->mSceneNameToTransitionTo);
+                }
+                
                 auto& objectTypeDefRepo = ObjectTypeDefinitionRepository::GetInstance();
                 
                 for (auto& enemyType: levelDef.mEnemyTypes)
@@ -406,14 +518,24 @@ void Scene::ChangeScene(const TransitionParameters& transitionParameters)
                 {
                     if (camera.mType == strutils::StringId("world_cam"))
                     {
-                        GameSingletons::SetCameraForSceneObjectType(SceneObjectType::WorldGameObject, Camera(camera.mLenseHeight));
+                        mGameContext.SetCameraForSceneObjectType(SceneObjectType::WorldGameObject, Camera(camera.mLenseHeight));
                     }
                     else if (camera.mType == strutils::StringId("gui_cam"))
                     {
-                        GameSingletons::SetCameraForSceneObjectType(SceneObjectType::GUIObject, Camera(camera.mLenseHeight));
+                        mGameContext.SetCameraForSceneObjectType(SceneObjectType::GUIObject, Camera(camera.mLenseHeight));
                     }
                 }
                 
+                // Input recordings (and their replays) start along with the level, before anything in it gets randomized
+                if (InputReplayer::GetInstance().IsReplaying())
+                {
+                    InputReplayer::GetInstance().OnLevelStarted(mSceneChangeCount);
+                }
+                else
+                {
+                    InputRecorder::GetInstance().OnLevelStarted(levelDef, mSceneChangeCount);
+                }
+                
                 mSceneUpdater = std::make_unique<LevelUpdater>(*this, mBox2dWorld, std::move(levelDef));
             } break;
         }
@@ -455,6 +577,20 @@ void Scene::ChangeScene(const TransitionParameters& transitionParameters)
 
 ///------------------------------------------------------------------------------------------------
 
+size_t Scene::GetSceneChangeCount() const
+{
+    return mSceneChangeCount;
+}
+
+///------------------------------------------------------------------------------------------------
+
+const IUpdater* Scene::GetSceneUpdater() const
+{
+    return mSceneUpdater.get();
+}
+
+///------------------------------------------------------------------------------------------------
+
 void Scene::OnAppStateChange(Uint32 event)
 {
     HandleProgressReset();
@@ -471,6 +607,15 @@ void Scene::UpdateScene(const float dtMillis)
 {
     mPreFirstUpdate = false;
     
+    for (auto& so: mSceneObjects)
+    {
+        if (so.mBody)
+        {
+            so.mPreviousBodyPosition = math::Box2dVec2ToGlmVec3(so.mBody->GetWorldCenter(), so.mPosition.z);
+            so.mHasPreviousBodyPosition = true;
+        }
+    }
+    
     if (mOverlayController)
     {
         mOverlayController->Update(dtMillis);
@@ -489,15 +634,19 @@ void Scene::UpdateScene(const float dtMillis)
     {
         if (mSceneUpdater)
         {
-            if (mSceneUpdater->VUpdate(mSceneObjects, dtMillis * GameSingletons::GetGameSpeedMultiplier()) == PostStateUpdateDirective::CONTINUE)
+            if (mSceneUpdater->VUpdate(mSceneObjects, dtMillis * mGameContext.GetGameSpeedMultiplier()) == PostStateUpdateDirective::CONTINUE)
             {
                 UpdateCrossSceneInterfaceObjects(dtMillis);
             }
         }
     }
     
+    SimulationProfiler::ScopedTimer bookkeepingTimer(SimulationSubsystem::SCENE_BOOKKEEPING);
+    
     for (const auto& name: mNamesOfSceneObjectsToRemove)
     {
+        mProjectileSystem.RemoveProjectile(name);
+        
         do
         {
             auto iter = std::find_if(mSceneObjects.begin(), mSceneObjects.end(), [&](const SceneObject& so)
@@ -527,6 +676,8 @@ void Scene::UpdateScene(const float dtMillis)
     
     std::move(mSceneObjectsToAdd.begin(), mSceneObjectsToAdd.end(), std::back_inserter(mSceneObjects));
     mSceneObjectsToAdd.clear();
+    
+    mProjectileSystem.SyncSceneObjects(mSceneObjects);
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -549,29 +700,29 @@ void Scene::UpdateCrossSceneInterfaceObjects(const float dtMillis)
         
         healthBarFrameSo.mPosition = game_constants::PLAYER_HEALTH_BAR_POSITION;
         
-        float healthPerc =  GameSingletons::GetPlayerCurrentHealth()/GameSingletons::GetPlayerMaxHealth();
+        float healthPerc =  mGameContext.GetPlayerCurrentHealth()/mGameContext.GetPlayerMaxHealth();
         
         if (healthPerc > 0.0f)
         {
-            auto displayedHealthPercentage = GameSingletons::GetPlayerDisplayedHealth()/GameSingletons::GetPlayerMaxHealth();
+            auto displayedHealthPercentage = mGameContext.GetPlayerDisplayedHealth()/mGameContext.GetPlayerMaxHealth();
             
             healthBarSo.mScale.x = game_constants::PLAYER_HEALTH_BAR_SCALE.x * displayedHealthPercentage;
             healthBarSo.mPosition.x -= (1.0f - displayedHealthPercentage)/game_constants::BAR_POSITION_DIVISOR_MAGIC * game_constants::PLAYER_HEALTH_BAR_SCALE.x;
             
             if (healthPerc < displayedHealthPercentage)
             {
-                GameSingletons::SetPlayerDisplayedHealth((displayedHealthPercentage - game_constants::HEALTH_LOST_SPEED * dtMillis) * GameSingletons::GetPlayerMaxHealth());
-                if (GameSingletons::GetPlayerDisplayedHealth()/GameSingletons::GetPlayerMaxHealth() <= healthPerc)
+                mGameContext.SetPlayerDisplayedHealth((displayedHealthPercentage - game_constants::HEALTH_LOST_SPEED * dtMillis) * mGameContext.GetPlayerMaxHealth());
+                if (mGameContext.GetPlayerDisplayedHealth()/mGameContext.GetPlayerMaxHealth() <= healthPerc)
                 {
-                    GameSingletons::SetPlayerDisplayedHealth(healthPerc * GameSingletons::GetPlayerMaxHealth());
+                    mGameContext.SetPlayerDisplayedHealth(healthPerc * mGameContext.GetPlayerMaxHealth());
                 }
             }
             else if (healthPerc > displayedHealthPercentage)
             {
-                GameSingletons::SetPlayerDisplayedHealth((displayedHealthPercentage + game_constants::HEALTH_LOST_SPEED/3 * dtMillis) * GameSingletons::GetPlayerMaxHealth());
-                if (GameSingletons::GetPlayerDisplayedHealth()/GameSingletons::GetPlayerMaxHealth() >= healthPerc)
+                mGameContext.SetPlayerDisplayedHealth((displayedHealthPercentage + game_constants::HEALTH_LOST_SPEED/3 * dtMillis) * mGameContext.GetPlayerMaxHealth());
+                if (mGameContext.GetPlayerDisplayedHealth()/mGameContext.GetPlayerMaxHealth() >= healthPerc)
                 {
-                    GameSingletons::SetPlayerDisplayedHealth(healthPerc * GameSingletons::GetPlayerMaxHealth());
+                    mGameContext.SetPlayerDisplayedHealth(healthPerc * mGameContext.GetPlayerMaxHealth());
                 }
             }
         }
@@ -583,11 +734,11 @@ void Scene::UpdateCrossSceneInterfaceObjects(const float dtMillis)
             return;
         }
         
-        healthBarTextSo.mText = std::to_string(static_cast<int>(GameSingletons::GetPlayerDisplayedHealth()));
+        healthBarTextSo.mText = std::to_string(static_cast<int>(mGameContext.GetPlayerDisplayedHealth()));
         
-        if (GameSingletons::GetPlayerShieldHealth() > 0.0f)
+        if (mGameContext.GetPlayerShieldHealth() > 0.0f)
         {
-            healthBarTextSo.mText += "<" + std::to_string(static_cast<int>(GameSingletons::GetPlayerShieldHealth())) + ">";
+            healthBarTextSo.mText += "<" + std::to_string(static_cast<int>(mGameContext.GetPlayerShieldHealth())) + ">";
         }
         
         glm::vec2 botLeftRect, topRightRect;
@@ -602,34 +753,34 @@ void Scene::UpdateCrossSceneInterfaceObjects(const float dtMillis)
     if (crystalCountSoOpt)
     {
         auto& crystalCountSo = crystalCountSoOpt->get();
-        if (GameSingletons::GetDisplayedCrystalCount() > GameSingletons::GetCrystalCount())
+        if (mGameContext.GetDisplayedCrystalCount() > mGameContext.GetCrystalCount())
         {
-            GameSingletons::SetDisplayedCrystalCount(GameSingletons::GetDisplayedCrystalCount() - game_constants::CRYSTAL_COUNT_CHANGE_SPEED * dtMillis);
-            if (GameSingletons::GetDisplayedCrystalCount() <= GameSingletons::GetCrystalCount())
+            mGameContext.SetDisplayedCrystalCount(mGameContext.GetDisplayedCrystalCount() - game_constants::CRYSTAL_COUNT_CHANGE_SPEED * dtMillis);
+            if (mGameContext.GetDisplayedCrystalCount() <= mGameContext.GetCrystalCount())
             {
-                GameSingletons::SetDisplayedCrystalCount(GameSingletons::GetCrystalCount());
+                mGameContext.SetDisplayedCrystalCount(mGameContext.GetCrystalCount());
             }
         }
-        else if (GameSingletons::GetDisplayedCrystalCount() < GameSingletons::GetCrystalCount())
+        else if (mGameContext.GetDisplayedCrystalCount() < mGameContext.GetCrystalCount())
         {
-            GameSingletons::SetDisplayedCrystalCount(GameSingletons::GetDisplayedCrystalCount() + game_constants::CRYSTAL_COUNT_CHANGE_SPEED * dtMillis);
-            if (GameSingletons::GetDisplayedCrystalCount() <= GameSingletons::GetCrystalCount())
+            mGameContext.SetDisplayedCrystalCount(mGameContext.GetDisplayedCrystalCount() + game_constants::CRYSTAL_COUNT_CHANGE_SPEED * dtMillis);
+            if (mGameContext.GetDisplayedCrystalCount() <= mGameContext.GetCrystalCount())
             {
-                GameSingletons::SetDisplayedCrystalCount(GameSingletons::GetCrystalCount());
+                mGameContext.SetDisplayedCrystalCount(mGameContext.GetCrystalCount());
             }
         }
         
-        crystalCountSo.mText = std::to_string(static_cast<int>(GameSingletons::GetDisplayedCrystalCount()));
+        crystalCountSo.mText = std::to_string(static_cast<int>(mGameContext.GetDisplayedCrystalCount()));
         crystalCountSo.mPosition = GUI_CRYSTAL_COUNT_POSITION;
         crystalCountSo.mPosition.x -= (crystalCountSo.mText.size() * 0.5f)/3.0;
     }
     
     // Settings button press check
     auto settingsButtonSoOpt = GetSceneObject(game_constants::GUI_SETTINGS_ICON_SCENE_OBJECT_NAME);
-    const auto guiCameraOpt = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::GUIObject);
-    if (settingsButtonSoOpt && guiCameraOpt && GameSingletons::GetInputContext().mEventType == SDL_FINGERDOWN)
+    const auto guiCameraOpt = mGameContext.GetCameraForSceneObjectType(SceneObjectType::GUIObject);
+    if (settingsButtonSoOpt && guiCameraOpt && mGameContext.GetInputContext().mEventType == SDL_FINGERDOWN)
     {
-        auto touchPos = math::ComputeTouchCoordsInWorldSpace(GameSingletons::GetWindowDimensions(), GameSingletons::GetInputContext().mTouchPos, guiCameraOpt->get().GetViewMatrix(), guiCameraOpt->get().GetProjMatrix());
+        auto touchPos = math::ComputeTouchCoordsInWorldSpace(mGameContext.GetWindowDimensions(), mGameContext.GetInputContext().mTouchPos, guiCameraOpt->get().GetViewMatrix(), guiCameraOpt->get().GetProjMatrix());
         if (scene_object_utils::IsPointInsideSceneObject(*settingsButtonSoOpt, touchPos))
         {
             if (mSceneUpdater)
@@ -689,7 +840,7 @@ void Scene::UpdateCrossSceneInterfaceObjects(const float dtMillis)
 
 void Scene::UpdateOnSceneEditModeOn(const float dtMillis)
 {
-    auto& inputContext = GameSingletons::GetInputContext();
+    auto& inputContext = mGameContext.GetInputContext();
     static float previousPinchDistance = 0.0f;
     static bool previousMultiGestureActive = false;
     static glm::vec3 worldInitTouchPos, guiInitTouchPos;
@@ -699,15 +850,15 @@ void Scene::UpdateOnSceneEditModeOn(const float dtMillis)
     {
         std::vector<strutils::StringId> touchedSceneObjectNames;
         
-        auto worldCamOpt = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::WorldGameObject);
+        auto worldCamOpt = mGameContext.GetCameraForSceneObjectType(SceneObjectType::WorldGameObject);
         auto& worldCamera = worldCamOpt->get();
         
-        auto guiCamOpt = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::GUIObject);
+        auto guiCamOpt = mGameContext.GetCameraForSceneObjectType(SceneObjectType::GUIObject);
         auto& guiCamera = guiCamOpt->get();
         
-        worldInitTouchPos = math::ComputeTouchCoordsInWorldSpace(GameSingletons::GetWindowDimensions(), inputContext.mTouchPos, worldCamera.GetViewMatrix(), worldCamera.GetProjMatrix());
+        worldInitTouchPos = math::ComputeTouchCoordsInWorldSpace(mGameContext.GetWindowDimensions(), inputContext.mTouchPos, worldCamera.GetViewMatrix(), worldCamera.GetProjMatrix());
         
-        guiInitTouchPos = math::ComputeTouchCoordsInWorldSpace(GameSingletons::GetWindowDimensions(), inputContext.mTouchPos, guiCamera.GetViewMatrix(), guiCamera.GetProjMatrix());
+        guiInitTouchPos = math::ComputeTouchCoordsInWorldSpace(mGameContext.GetWindowDimensions(), inputContext.mTouchPos, guiCamera.GetViewMatrix(), guiCamera.GetProjMatrix());
             
         for (int i = 0; i < mSceneObjects.size(); ++i)
         {
@@ -763,11 +914,11 @@ void Scene::UpdateOnSceneEditModeOn(const float dtMillis)
             {
                 if (so.mText.empty())
                 {
-                    so.mScale += dtMillis * (GameSingletons::GetInputContext().mPinchDistance - previousPinchDistance) * 0.3f;
+                    so.mScale += dtMillis * (mGameContext.GetInputContext().mPinchDistance - previousPinchDistance) * 0.3f;
                 }
                 else
                 {
-                    so.mScale += dtMillis * (GameSingletons::GetInputContext().mPinchDistance - previousPinchDistance) * 0.03f;
+                    so.mScale += dtMillis * (mGameContext.GetInputContext().mPinchDistance - previousPinchDistance) * 0.03f;
                 }
                 
                 SetSceneEditResultMessage(so.mPosition, so.mScale);
@@ -775,8 +926,8 @@ void Scene::UpdateOnSceneEditModeOn(const float dtMillis)
             // Translate selected object
             else if (inputContext.mMultiGestureActive == false && previousMultiGestureActive == false)
             {
-                auto& camera = GameSingletons::GetCameraForSceneObjectType(so.mSceneObjectType)->get();
-                auto touchPos = math::ComputeTouchCoordsInWorldSpace(GameSingletons::GetWindowDimensions(), inputContext.mTouchPos, camera.GetViewMatrix(), camera.GetProjMatrix());
+                auto& camera = mGameContext.GetCameraForSceneObjectType(so.mSceneObjectType)->get();
+                auto touchPos = math::ComputeTouchCoordsInWorldSpace(mGameContext.GetWindowDimensions(), inputContext.mTouchPos, camera.GetViewMatrix(), camera.GetProjMatrix());
                 
                 if (so.mBody)
                 {
@@ -792,7 +943,7 @@ void Scene::UpdateOnSceneEditModeOn(const float dtMillis)
             }
             
             // Keep track of previous finger pinch distance
-            previousPinchDistance = GameSingletons::GetInputContext().mPinchDistance;
+            previousPinchDistance = mGameContext.GetInputContext().mPinchDistance;
         }
     }
     
@@ -801,9 +952,9 @@ void Scene::UpdateOnSceneEditModeOn(const float dtMillis)
 
 ///------------------------------------------------------------------------------------------------
 
-void Scene::RenderScene()
+void Scene::RenderScene(const float interpolationAlpha)
 {
-    mSceneRenderer.Render(mSceneObjects, mLightRepository);
+    mSceneRenderer.Render(mSceneObjects, mLightRepository, interpolationAlpha);
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -937,7 +1088,7 @@ void Scene::CreateCrossSceneInterfaceObjects()
         healthBarTextSo.mFontName = game_constants::DEFAULT_FONT_MM_NAME;
         healthBarTextSo.mSceneObjectType = SceneObjectType::GUIObject;
         healthBarTextSo.mName = game_constants::PLAYER_HEALTH_BAR_TEXT_SCENE_OBJECT_NAME;
-        healthBarTextSo.mText = std::to_string(static_cast<int>(GameSingletons::GetPlayerDisplayedHealth()));
+        healthBarTextSo.mText = std::to_string(static_cast<int>(mGameContext.GetPlayerDisplayedHealth()));
         healthBarTextSo.mShaderFloatUniformValues[game_constants::CUSTOM_ALPHA_UNIFORM_NAME] = 1.0f;
         healthBarTextSo.mCrossSceneLifetime = true;
         AddSceneObject(std::move(healthBarTextSo));
@@ -978,7 +1129,7 @@ void Scene::CreateCrossSceneInterfaceObjects()
         crystalCountSo.mFontName = game_constants::DEFAULT_FONT_MM_NAME;
         crystalCountSo.mSceneObjectType = SceneObjectType::GUIObject;
         crystalCountSo.mName = game_constants::GUI_CRYSTAL_COUNT_SCENE_OBJECT_NAME;
-        crystalCountSo.mText = std::to_string(GameSingletons::GetCrystalCount());
+        crystalCountSo.mText = std::to_string(mGameContext.GetCrystalCount());
         crystalCountSo.mShaderFloatUniformValues[game_constants::CUSTOM_ALPHA_UNIFORM_NAME] = 1.0f;
         crystalCountSo.mCrossSceneLifetime = true;
         AddSceneObject(std::move(crystalCountSo));
@@ -1031,3 +1182,49 @@ void Scene::HandleProgressReset()
 }
 
 ///------------------------------------------------------------------------------------------------
+
+void Scene::AccumulateSceneObjectResources(const SceneObject& sceneObject)
+{
+    if (!sceneObject.mAnimation)
+    {
+        return;
+    }
+    
+    for (const auto resourceId: { sceneObject.mAnimation->VGetCurrentTextureResourceId(), sceneObject.mAnimation->VGetCurrentMeshResourceId(), sceneObject.mAnimation->VGetCurrentShaderResourceId() })
+    {
+        if (mAccumulatedResourcesForScene.insert(resourceId).second)
+        {
+            resources::ResourceLoadingService::GetInstance().AcquireResource(resourceId);
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void Scene::LogSceneTextureMemoryUsage() const
+{
+    auto& resService = resources::ResourceLoadingService::GetInstance();
+    
+    size_t gpuMemoryBytes = 0;
+    size_t rgba8EquivalentMemoryBytes = 0;
+    
+    for (const auto resourceId: mAccumulatedResourcesForScene)
+    {
+        if (!resService.HasLoadedResource(resourceId)) continue;
+        
+        auto* textureResource = dynamic_cast<resources::TextureResource*>(&resService.GetResource<resources::IResource>(resourceId));
+        if (textureResource)
+        {
+            gpuMemoryBytes += textureResource->GetGPUMemoryBytes();
+            rgba8EquivalentMemoryBytes += textureResource->GetRGBA8EquivalentMemoryBytes();
+        }
+    }
+    
+    // Mip chains of narrow formats (and atlas members, which report their share of the page) can
+    // take more than their RGBA8 estimate, in which case the saving is negative
+    const auto savedMemoryBytes = static_cast<long long>(rgba8EquivalentMemoryBytes) - static_cast<long long>(gpuMemoryBytes);
+    
+    Log(LogType::INFO, "Scene texture memory: %zu KB (%zu KB as RGBA8, %lld KB saved)", gpuMemoryBytes/1024, rgba8EquivalentMemoryBytes/1024, savedMemoryBytes/1024);
+}
+
+///------------------------------------------------------------------------------------------------
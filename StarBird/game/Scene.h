@@ -12,6 +12,8 @@
 
 #include "FullScreenOverlayController.h"
 #include "IUpdater.h"
+#include "PhysicsCollisionListener.h"
+#include "ProjectileSystem.h"
 #include "SceneObject.h"
 #include "SceneRenderer.h"
 
@@ -27,6 +29,7 @@
 
 ///------------------------------------------------------------------------------------------------
 
+class GameContext;
 class IUpdater;
 class Scene final
 {
@@ -53,9 +56,13 @@ public:
     };
     
 public:
-    Scene();
+    explicit Scene(GameContext& gameContext);
     ~Scene();
     
+    /// @returns the context of the game instance this scene belongs to.
+    GameContext& GetGameContext();
+    const GameContext& GetGameContext() const;
+    
     std::string GetSceneStateDescription() const;
     
     std::optional<std::reference_wrapper<SceneObject>> GetSceneObject(const b2Body* body);
@@ -67,21 +74,40 @@ public:
     const LightRepository& GetLightRepository() const;
     LightRepository& GetLightRepository();
     
+    /// @returns the contact listener of the scene's world. Collision callbacks get dropped on every scene change, so each scene updater registers its own.
+    PhysicsCollisionListener& GetCollisionListener();
+    
+    /// @returns the projectiles of the scene, stepped by the scene updaters alongside the scene's world. Like collision callbacks, hit callbacks and projectiles get dropped on every scene change.
+    ProjectileSystem& GetProjectileSystem();
+    
     void AddOverlayController(const float darkeningSpeed, const float maxDarkeningValue, const bool pauseAtMidPoint, FullScreenOverlayController::CallbackType midwayCallback = nullptr, FullScreenOverlayController::CallbackType completionCallback = nullptr);
     void ResumeOverlayController();
     
     void AddSceneObject(SceneObject&& sceneObject);
     void RemoveAllSceneObjectsWithName(const strutils::StringId& name);
+    
+    /// Replaces all scene objects (other than the ones outliving the scene) with the given ones, e.g.
+    /// when restoring a level snapshot. Pending additions and removals are dropped.
+    void ReplaceSceneObjects(std::vector<SceneObject>&& sceneObjects);
+    
+    /// @returns whether there are any scene object additions/removals pending until the end of the update, or an overlay transition running.
+    bool HasPendingChanges() const;
 
     void SetProgressResetFlag();
     void ChangeScene(const TransitionParameters& transitionParameters);
     
+    /// @returns how many scene changes have been requested so far (including one still pending behind its overlay).
+    size_t GetSceneChangeCount() const;
+    
+    const IUpdater* GetSceneUpdater() const;
+    
     void OnAppStateChange(Uint32 event);
     void UpdateScene(const float dtMillis);
     void UpdateCrossSceneInterfaceObjects(const float dtMillis);
     void UpdateOnSceneEditModeOn(const float dtMillis);
     
-    void RenderScene();
+    /// @param[in] interpolationAlpha how far (0-1) real time is in to the next simulation step, for interpolating body positions.
+    void RenderScene(const float interpolationAlpha);
     
     void SetSceneRendererPhysicsDebugMode(const bool debugMode);
     void SetSceneEditMode(const bool editMode);
@@ -95,9 +121,14 @@ private:
     void CreateCrossSceneInterfaceObjects();
     void SetHUDVisibility(const bool visibility);
     void HandleProgressReset();
+    void AccumulateSceneObjectResources(const SceneObject& sceneObject);
+    void LogSceneTextureMemoryUsage() const;
     
 private:
+    GameContext& mGameContext;
     b2World mBox2dWorld;
+    PhysicsCollisionListener mCollisionListener;
+    ProjectileSystem mProjectileSystem;
     std::unordered_set<resources::ResourceId> mAccumulatedResourcesForScene;
     std::vector<SceneObject> mSceneObjects;
     std::vector<SceneObject> mSceneObjectsToAdd;
@@ -107,6 +138,7 @@ private:
     std::unique_ptr<FullScreenOverlayController> mOverlayController;
     std::unique_ptr<TransitionParameters> mTransitionParameters;
     SceneRenderer mSceneRenderer;
+    size_t mSceneChangeCount;
     bool mPreFirstUpdate;
     bool mSceneEditMode;
     bool mProgressResetFlag;
@@ -78,6 +78,9 @@ struct SceneObject // 472b
     glm::vec3 mBodyCustomScale = glm::vec3(1.0f, 1.0f, 1.0f);
     glm::vec3 mBodyCustomOffset = glm::vec3(0.0f, 0.0f, 0.0f);
     
+    // Body position as of the start of the latest simulation step, for rendering the body interpolated between steps
+    glm::vec3 mPreviousBodyPosition = glm::vec3(0.0f, 0.0f, 0.0f);
+    
     // Scene object type World/GUI
     SceneObjectType mSceneObjectType = SceneObjectType::WorldGameObject;
     
@@ -101,6 +104,9 @@ struct SceneObject // 472b
     
     // Whether or not this scene object has been selected in edit mode
     bool mDebugEditSelected = false;
+    
+    // Whether or not the above previous body position has been recorded yet
+    bool mHasPreviousBodyPosition = false;
 };
 
 ///------------------------------------------------------------------------------------------------
@@ -243,6 +243,35 @@ SceneObject CreateSceneObjectWithBody(const ObjectTypeDefinition& objectDef, con
 
 ///------------------------------------------------------------------------------------------------
 
+SceneObject CreateSceneObjectWithProjectile(const ObjectTypeDefinition& objectDef, const glm::vec3& position, ProjectileSystem& projectileSystem)
+{
+    SceneObject so;
+    so.mAnimation = objectDef.mAnimations.at(game_constants::DEFAULT_SCENE_OBJECT_STATE)->VClone();
+    
+    so.mStateName = game_constants::DEFAULT_SCENE_OBJECT_STATE;
+    so.mBodyCustomOffset = objectDef.mBodyCustomOffset;
+    so.mBodyCustomScale = objectDef.mBodyCustomScale;
+    
+    // Projectiles are circles, fitting in the box the body would have been
+    auto& mesh = resources::ResourceLoadingService::GetInstance().GetResource<resources::MeshResource>(so.mAnimation->VGetCurrentMeshResourceId());
+    const auto bodyWidth = mesh.GetDimensions().x * math::Abs(so.mAnimation->VGetScale().x) * math::Abs(objectDef.mBodyCustomScale.x);
+    const auto bodyHeight = mesh.GetDimensions().y * math::Abs(so.mAnimation->VGetScale().y) * math::Abs(objectDef.mBodyCustomScale.y);
+    
+    so.mName = projectileSystem.AddProjectile(glm::vec2(position.x + objectDef.mBodyCustomOffset.x, position.y + objectDef.mBodyCustomOffset.y), objectDef.mConstantLinearVelocity, math::Min(bodyWidth, bodyHeight)/2, objectDef.mContactFilter);
+    so.mObjectFamilyTypeName = objectDef.mName;
+    so.mHealth = objectDef.mHealth;
+    so.mSceneObjectType = SceneObjectType::WorldGameObject;
+    so.mScale = so.mAnimation->VGetScale();
+    so.mCustomDrivenMovement = true;
+    
+    so.mPosition = position;
+    so.mShaderBoolUniformValues[game_constants::IS_AFFECTED_BY_LIGHT_UNIFORM_NAME] = true;
+    
+    return so;
+}
+
+///------------------------------------------------------------------------------------------------
+
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -18,6 +18,7 @@
 struct SceneObject;
 struct ObjectTypeDefinition;
 class b2World;
+class ProjectileSystem;
 
 ///------------------------------------------------------------------------------------------------
 
@@ -65,6 +66,15 @@ strutils::StringId GenerateSceneObjectName(const SceneObject& sceneObject);
 /// @param[in] sceneObjectName (optional) if this is supplied, the scene object wil be named this, rather than
 /// a generated name based on its body pointer.
 SceneObject CreateSceneObjectWithBody(const ObjectTypeDefinition& objectDef, const glm::vec3& position, b2World& box2dWorld, const strutils::StringId sceneObjectName = strutils::StringId());
+
+///-----------------------------------------------------------------------------------------------
+/// Creates a scene object moved along by a projectile (rather than a body), flying at the object
+/// definition's constant velocity.
+/// @param[in] objectDef the object definition to draw most fields from
+/// @param[in] position the position to initially set for the scene object
+/// @param[in] projectileSystem ref to the projectile system, needed for projectile creation
+/// @returns the scene object, named after its projectile.
+SceneObject CreateSceneObjectWithProjectile(const ObjectTypeDefinition& objectDef, const glm::vec3& position, ProjectileSystem& projectileSystem);
                                         
 ///------------------------------------------------------------------------------------------------
 
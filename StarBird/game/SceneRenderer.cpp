@@ -63,7 +63,7 @@ SceneRenderer::SceneRenderer(b2World& box2dWorld)
 
 ///------------------------------------------------------------------------------------------------
 
-void SceneRenderer::Render(std::vector<SceneObject>& sceneObjects, const LightRepository& lightRepository)
+void SceneRenderer::Render(std::vector<SceneObject>& sceneObjects, const LightRepository& lightRepository, const float interpolationAlpha)
 {
     auto& resService = resources::ResourceLoadingService::GetInstance();
     
@@ -87,8 +87,11 @@ void SceneRenderer::Render(std::vector<SceneObject>& sceneObjects, const LightRe
     resources::ResourceId currentMeshReourceId = resources::ResourceId();
     resources::ResourceId currentShaderResourceId = resources::ResourceId();
     resources::ResourceId currentTextureResourceId = resources::ResourceId();
+    resources::GLuint currentGLTextureId = 0;
+    resources::GLuint currentVertexArrayObject = 0;
     resources::MeshResource* currentMesh = nullptr;
     resources::ShaderResource* currentShader = nullptr;
+    resources::TextureResource* currentTexture = nullptr;
     
     for (auto& so: sceneObjects)
     {
@@ -100,7 +103,6 @@ void SceneRenderer::Render(std::vector<SceneObject>& sceneObjects, const LightRe
         {
             currentMeshReourceId = so.mAnimation->VGetCurrentMeshResourceId();
             currentMesh = &(resService.GetResource<resources::MeshResource>(currentMeshReourceId));
-            GL_CALL(glBindVertexArray(currentMesh->GetVertexArrayObject()));
         }
         
         if (so.mAnimation->VGetCurrentShaderResourceId() != currentShaderResourceId)
@@ -110,6 +112,14 @@ void SceneRenderer::Render(std::vector<SceneObject>& sceneObjects, const LightRe
             GL_CALL(glUseProgram(currentShader->GetProgramId()));
         }
         
+        // Meshes only stream their normals to the shaders that read them
+        const auto vertexArrayObject = currentMesh->GetVertexArrayObject(*currentShader);
+        if (vertexArrayObject != currentVertexArrayObject)
+        {
+            currentVertexArrayObject = vertexArrayObject;
+            GL_CALL(glBindVertexArray(currentVertexArrayObject));
+        }
+        
         for (size_t i = 0; i < currentShader->GetUniformSamplerNames().size(); ++i)
         {
             currentShader->SetInt(currentShader->GetUniformSamplerNames().at(i), static_cast<int>(i));
@@ -129,8 +139,15 @@ void SceneRenderer::Render(std::vector<SceneObject>& sceneObjects, const LightRe
         if (so.mAnimation->VGetCurrentTextureResourceId() == 0 || so.mAnimation->VGetCurrentTextureResourceId() != currentTextureResourceId)
         {
             currentTextureResourceId = so.mAnimation->VGetCurrentTextureResourceId();
-            GL_CALL(glActiveTexture(GL_TEXTURE0));
-            GL_CALL(glBindTexture(GL_TEXTURE_2D, resService.GetResource<resources::TextureResource>(currentTextureResourceId).GetGLTextureId()));
+            currentTexture = &(resService.GetResource<resources::TextureResource>(currentTextureResourceId));
+            
+            // Textures packed in the same atlas page share their GL texture
+            if (currentTexture->GetGLTextureId() != currentGLTextureId)
+            {
+                currentGLTextureId = currentTexture->GetGLTextureId();
+                GL_CALL(glActiveTexture(GL_TEXTURE0));
+                GL_CALL(glBindTexture(GL_TEXTURE_2D, currentGLTextureId));
+            }
         }
         
         if (so.mAnimation->VGetCurrentEffectTextureResourceId() != 0)
@@ -203,7 +220,15 @@ void SceneRenderer::Render(std::vector<SceneObject>& sceneObjects, const LightRe
         // If a b2Body is active then take its transform
         else if (so.mBody && so.mAnimation->VGetBodyRenderingEnabled())
         {
-            world = glm::translate(world, math::Box2dVec2ToGlmVec3(so.mBody->GetWorldCenter(), so.mPosition.z) - so.mBodyCustomOffset);
+            auto bodyPosition = math::Box2dVec2ToGlmVec3(so.mBody->GetWorldCenter(), so.mPosition.z);
+            
+            // Bodies move in fixed simulation steps, so they are rendered in between their last two positions
+            if (so.mHasPreviousBodyPosition)
+            {
+                bodyPosition = math::Lerp(so.mPreviousBodyPosition, bodyPosition, interpolationAlpha);
+            }
+            
+            world = glm::translate(world, bodyPosition - so.mBodyCustomOffset);
             
             world = glm::rotate(world, so.mRotation.x, math::X_AXIS);
             world = glm::rotate(world, so.mRotation.y, math::Y_AXIS);
@@ -214,7 +239,8 @@ void SceneRenderer::Render(std::vector<SceneObject>& sceneObjects, const LightRe
         // Otherwise from its custom set one
         else
         {
-            world = glm::translate(world, so.mPosition);
+            // Projectiles also move in fixed simulation steps (see ProjectileSystem::SyncSceneObjects)
+            world = glm::translate(world, so.mHasPreviousBodyPosition ? math::Lerp(so.mPreviousBodyPosition, so.mPosition, interpolationAlpha) : so.mPosition);
             world = glm::rotate(world, so.mRotation.x, math::X_AXIS);
             world = glm::rotate(world, so.mRotation.y, math::Y_AXIS);
             world = glm::rotate(world, so.mRotation.z, math::Z_AXIS);
@@ -245,20 +271,35 @@ void SceneRenderer::Render(std::vector<SceneObject>& sceneObjects, const LightRe
         for (const auto& mat4Entry: so.mShaderMat4UniformValues)
             currentShader->SetMatrix4fv(mat4Entry.first, mat4Entry.second);
         
+        // Atlas packed textures sample their own region of the atlas page via the texture sheet uniforms.
+        // Only applies to single texture shaders, since effect textures are sampled with the same uvs.
+        const auto* atlasRegion = currentTexture->GetAtlasRegion();
+        if (atlasRegion && !so.mShaderBoolUniformValues.at(game_constants::IS_TEXTURE_SHEET_UNIFORM_NAME) && currentShader->GetUniformSamplerNames().size() == 1)
+        {
+            currentShader->SetBool(game_constants::IS_TEXTURE_SHEET_UNIFORM_NAME, true);
+            currentShader->SetFloat(game_constants::MIN_U_UNIFORM_NAME, atlasRegion->minU);
+            currentShader->SetFloat(game_constants::MIN_V_UNIFORM_NAME, atlasRegion->minV);
+            currentShader->SetFloat(game_constants::MAX_U_UNIFORM_NAME, atlasRegion->maxU);
+            currentShader->SetFloat(game_constants::MAX_V_UNIFORM_NAME, atlasRegion->maxV);
+        }
+        
         GL_CALL(glDrawElements(GL_TRIANGLES, currentMesh->GetElementCount(), GL_UNSIGNED_SHORT, (void*)0));
         
         if (so.mDebugEditSelected)
         {
             currentMeshReourceId = resources::ResourceLoadingService::FALLBACK_MESH_ID;
             currentMesh = &(resService.GetResource<resources::MeshResource>(currentMeshReourceId));
-            GL_CALL(glBindVertexArray(currentMesh->GetVertexArrayObject()));
             
             currentShaderResourceId = resService.GetResourceIdFromPath(resources::ResourceLoadingService::RES_SHADERS_ROOT + game_constants::BASIC_SHADER_FILE_NAME);
             currentShader = &(resService.GetResource<resources::ShaderResource>(currentShaderResourceId));
             
             GL_CALL(glUseProgram(currentShader->GetProgramId()));
             
+            currentVertexArrayObject = currentMesh->GetVertexArrayObject(*currentShader);
+            GL_CALL(glBindVertexArray(currentVertexArrayObject));
+            
             currentTextureResourceId = resources::ResourceLoadingService::FALLBACK_TEXTURE_ID;
+            currentGLTextureId = 0;
             GL_CALL(glActiveTexture(GL_TEXTURE0));
             GL_CALL(glBindTexture(GL_TEXTURE_2D, resService.GetResource<resources::TextureResource>( resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + EDIT_MODE_SELECTED_SO_OUTLINE_TEXTURE_FILE_NAME)).GetGLTextureId()));
     
@@ -296,14 +337,17 @@ void SceneRenderer::Render(std::vector<SceneObject>& sceneObjects, const LightRe
         {
             currentMeshReourceId = resources::ResourceLoadingService::FALLBACK_MESH_ID;
             currentMesh = &(resService.GetResource<resources::MeshResource>(currentMeshReourceId));
-            GL_CALL(glBindVertexArray(currentMesh->GetVertexArrayObject()));
             
             currentShaderResourceId = resService.GetResourceIdFromPath(resources::ResourceLoadingService::RES_SHADERS_ROOT + game_constants::CUSTOM_COLOR_SHADER_FILE_NAME);
             currentShader = &(resService.GetResource<resources::ShaderResource>(currentShaderResourceId));
             
             GL_CALL(glUseProgram(currentShader->GetProgramId()));
             
+            currentVertexArrayObject = currentMesh->GetVertexArrayObject(*currentShader);
+            GL_CALL(glBindVertexArray(currentVertexArrayObject));
+            
             currentTextureResourceId = resources::ResourceLoadingService::FALLBACK_TEXTURE_ID;
+            currentGLTextureId = 0;
             GL_CALL(glActiveTexture(GL_TEXTURE0));
             GL_CALL(glBindTexture(GL_TEXTURE_2D, resService.GetResource<resources::TextureResource>(currentTextureResourceId).GetGLTextureId()));
             
@@ -24,7 +24,7 @@ class SceneRenderer final: public b2Draw
 public:
     SceneRenderer(b2World& box2dWorld);
     
-    void Render(std::vector<SceneObject>& sceneObjects, const LightRepository& lightRepository);
+    void Render(std::vector<SceneObject>& sceneObjects, const LightRepository& lightRepository, const float interpolationAlpha);
     
     void SetPhysicsDebugMode(const bool physicsDebugMode);
     
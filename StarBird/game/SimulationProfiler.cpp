@@ -0,0 +1,101 @@
+///------------------------------------------------------------------------------------------------
+///  SimulationProfiler.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "SimulationProfiler.h"
+
+#include <SDL.h>
+
+///------------------------------------------------------------------------------------------------
+
+SimulationProfiler::ScopedTimer::ScopedTimer(const SimulationSubsystem subsystem)
+    : mSubsystem(subsystem)
+    , mStartCounter(SimulationProfiler::GetInstance().IsEnabled() ? SDL_GetPerformanceCounter() : 0)
+{
+}
+
+///------------------------------------------------------------------------------------------------
+
+SimulationProfiler::ScopedTimer::~ScopedTimer()
+{
+    auto& profiler = SimulationProfiler::GetInstance();
+
+    // Enabling the profiler mid scope would otherwise attribute the whole run up to now to this sample
+    if (profiler.IsEnabled() && mStartCounter != 0)
+    {
+        profiler.AddSample(mSubsystem, (SDL_GetPerformanceCounter() - mStartCounter) * 1000.0/SDL_GetPerformanceFrequency());
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+SimulationProfiler& SimulationProfiler::GetInstance()
+{
+    // One per game instance (i.e. per thread running one)
+    static thread_local SimulationProfiler instance;
+    return instance;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void SimulationProfiler::SetEnabled(const bool enabled)
+{
+    mEnabled = enabled;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool SimulationProfiler::IsEnabled() const
+{
+    return mEnabled;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void SimulationProfiler::Reset()
+{
+    mTimings.fill(SubsystemTimings());
+}
+
+///------------------------------------------------------------------------------------------------
+
+void SimulationProfiler::AddSample(const SimulationSubsystem subsystem, const double millis)
+{
+    auto& timings = mTimings[static_cast<size_t>(subsystem)];
+    timings.mTotalMillis += millis;
+    timings.mWorstMillis = millis > timings.mWorstMillis ? millis : timings.mWorstMillis;
+    timings.mSampleCount++;
+}
+
+///------------------------------------------------------------------------------------------------
+
+const SubsystemTimings& SimulationProfiler::GetTimings(const SimulationSubsystem subsystem) const
+{
+    return mTimings[static_cast<size_t>(subsystem)];
+}
+
+///------------------------------------------------------------------------------------------------
+
+const char* SimulationProfiler::GetSubsystemName(const SimulationSubsystem subsystem)
+{
+    switch (subsystem)
+    {
+        case SimulationSubsystem::STATE_MACHINE: return "state_machine";
+        case SimulationSubsystem::PHYSICS: return "physics";
+        case SimulationSubsystem::PROJECTILES: return "projectiles";
+        case SimulationSubsystem::COLLISIONS: return "collisions";
+        case SimulationSubsystem::SCENE_OBJECTS: return "scene_objects";
+        case SimulationSubsystem::BOSS_AI: return "boss_ai";
+        case SimulationSubsystem::UPGRADES: return "upgrades";
+        case SimulationSubsystem::FLOWS: return "flows";
+        case SimulationSubsystem::PRESENTATION: return "presentation";
+        case SimulationSubsystem::SCENE_BOOKKEEPING: return "scene_bookkeeping";
+        case SimulationSubsystem::FRAME_WORK: return "frame_work";
+        default: return "unknown";
+    }
+}
+
+///------------------------------------------------------------------------------------------------
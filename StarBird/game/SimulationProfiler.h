@@ -0,0 +1,97 @@
+///------------------------------------------------------------------------------------------------
+///  SimulationProfiler.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef SimulationProfiler_h
+#define SimulationProfiler_h
+
+///------------------------------------------------------------------------------------------------
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+///------------------------------------------------------------------------------------------------
+
+enum class SimulationSubsystem
+{
+    STATE_MACHINE,
+    PHYSICS,
+    PROJECTILES,
+    COLLISIONS,
+    SCENE_OBJECTS,
+    BOSS_AI,
+    UPGRADES,
+    FLOWS,
+    PRESENTATION,
+    SCENE_BOOKKEEPING,
+    FRAME_WORK,
+    COUNT
+};
+
+///------------------------------------------------------------------------------------------------
+
+struct SubsystemTimings
+{
+    double mTotalMillis = 0.0;
+    double mWorstMillis = 0.0;
+    long long mSampleCount = 0LL;
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// Accumulates the time spent in each subsystem of the simulation, e.g. for headless runs to
+/// report on. Disabled by default, in which case timing a subsystem costs a single branch.
+class SimulationProfiler final
+{
+public:
+    /// Times the enclosing scope, adding it as a sample of the given subsystem.
+    class ScopedTimer final
+    {
+    public:
+        explicit ScopedTimer(const SimulationSubsystem subsystem);
+        ~ScopedTimer();
+        ScopedTimer(const ScopedTimer&) = delete;
+        const ScopedTimer& operator = (const ScopedTimer&) = delete;
+
+    private:
+        const SimulationSubsystem mSubsystem;
+        const uint64_t mStartCounter;
+    };
+
+public:
+    /// The default method of getting a hold of this singleton.
+    /// @returns a reference to the single instance of this class on the calling thread (i.e. of the game instance running on it).
+    static SimulationProfiler& GetInstance();
+
+    ~SimulationProfiler() = default;
+    SimulationProfiler(const SimulationProfiler&) = delete;
+    SimulationProfiler(SimulationProfiler&&) = delete;
+    const SimulationProfiler& operator = (const SimulationProfiler&) = delete;
+    SimulationProfiler& operator = (SimulationProfiler&&) = delete;
+
+    void SetEnabled(const bool enabled);
+    bool IsEnabled() const;
+
+    /// Drops all timings accumulated so far.
+    void Reset();
+
+    void AddSample(const SimulationSubsystem subsystem, const double millis);
+    const SubsystemTimings& GetTimings(const SimulationSubsystem subsystem) const;
+
+    static const char* GetSubsystemName(const SimulationSubsystem subsystem);
+
+private:
+    SimulationProfiler() = default;
+
+private:
+    std::array<SubsystemTimings, static_cast<size_t>(SimulationSubsystem::COUNT)> mTimings;
+    bool mEnabled = false;
+};
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* SimulationProfiler_h */
@@ -102,14 +102,13 @@ UpgradeUnlockedHandler::UpgradeUnlockedHandler(Scene& scene, b2World& box2dWorld
         mScene.AddSceneObject(std::move(so));
     }
     
-    static PhysicsCollisionListener collisionListener;
-    collisionListener.RegisterCollisionCallback(UnorderedCollisionCategoryPair(physics_constants::PLAYER_BULLET_CATEGORY_BIT, physics_constants::BULLET_ONLY_WALL_CATEGORY_BIT), [&](b2Body* firstBody, b2Body* secondBody)
+    auto& projectileSystem = mScene.GetProjectileSystem();
+    projectileSystem.RegisterHitCallback(physics_constants::PLAYER_BULLET_CATEGORY_BIT, physics_constants::BULLET_ONLY_WALL_CATEGORY_BIT, [&](const strutils::StringId& playerBulletName, b2Body*)
     {
-        const auto& playerBulletName = *static_cast<strutils::StringId*>(firstBody->GetUserData());
         mScene.RemoveAllSceneObjectsWithName(playerBulletName);
+        return true;
     });
     
-    mBox2dWorld.SetContactListener(&collisionListener);
     mScene.GetLightRepository().AddLight(LightType::AMBIENT_LIGHT, game_constants::AMBIENT_LIGHT_NAME, game_constants::AMBIENT_LIGHT_COLOR, glm::vec3(0.0f), 0.0f);
     
 }
@@ -193,6 +192,9 @@ void UpgradeUnlockedHandler::OnUpgradeGained(const strutils::StringId& upgradeNa
 UpgradeUnlockedHandler::UpgradeAnimationState UpgradeUnlockedHandler::Update(const float dtMillis)
 {
     mBox2dWorld.Step(physics_constants::WORLD_STEP * GameSingletons::GetGameSpeedMultiplier(), physics_constants::WORLD_VELOCITY_ITERATIONS, physics_constants::WORLD_POSITION_ITERATIONS);
+    mScene.GetCollisionListener().DispatchCollisionEvents();
+    mScene.GetProjectileSystem().Step(physics_constants::WORLD_STEP * GameSingletons::GetGameSpeedMultiplier(), mBox2dWorld);
+    mScene.GetProjectileSystem().DispatchHits();
     
     for (size_t i = 0; i < mFlows.size(); ++i)
     {
@@ -508,7 +510,7 @@ UpgradeUnlockedHandler::UpgradeAnimationState UpgradeUnlockedHandler::UpdateMirr
         
         if (shouldStartMirrorImageBulletFlow)
         {
-            blueprint_flows::CreatePlayerBulletFlow(mFlows, mScene, mBox2dWorld);
+            blueprint_flows::CreatePlayerBulletFlow(mFlows, mScene);
             
             mFlows.emplace_back([&]()
             {
@@ -526,7 +528,7 @@ UpgradeUnlockedHandler::UpgradeAnimationState UpgradeUnlockedHandler::UpdateMirr
         {
             playerSo.mShaderFloatUniformValues[game_constants::CUSTOM_ALPHA_UNIFORM_NAME] = 1.0f;
             
-            blueprint_flows::CreatePlayerBulletFlow(mFlows, mScene, mBox2dWorld, { game_constants::MIRROR_IMAGE_UGPRADE_NAME });
+            blueprint_flows::CreatePlayerBulletFlow(mFlows, mScene, { game_constants::MIRROR_IMAGE_UGPRADE_NAME });
             
             mFlows.emplace_back([&]()
             {
@@ -601,7 +603,7 @@ UpgradeUnlockedHandler::UpgradeAnimationState UpgradeUnlockedHandler::UpdateDoub
         {
             playerSo.mShaderFloatUniformValues[game_constants::CUSTOM_ALPHA_UNIFORM_NAME] = 1.0f;
             
-            blueprint_flows::CreatePlayerBulletFlow(mFlows, mScene, mBox2dWorld, { game_constants::DOUBLE_BULLET_UGPRADE_NAME });
+            blueprint_flows::CreatePlayerBulletFlow(mFlows, mScene, { game_constants::DOUBLE_BULLET_UGPRADE_NAME });
             
             mFlows.emplace_back([&]()
             {
@@ -611,7 +613,7 @@ UpgradeUnlockedHandler::UpgradeAnimationState UpgradeUnlockedHandler::UpdateDoub
     }
     else if (mSecondStageAnimation)
     {
-        blueprint_flows::CreatePlayerBulletFlow(mFlows, mScene, mBox2dWorld);
+        blueprint_flows::CreatePlayerBulletFlow(mFlows, mScene);
         
         mFlows.emplace_back([&]()
         {
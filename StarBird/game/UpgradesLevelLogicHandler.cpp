@@ -7,7 +7,7 @@
 
 #include "UpgradesLevelLogicHandler.h"
 #include "GameConstants.h"
-#include "GameSingletons.h"
+#include "GameContext.h"
 #include "Scene.h"
 #include "Sounds.h"
 #include "datarepos/ObjectTypeDefinitionRepository.h"
@@ -62,8 +62,8 @@ void UpgradesLevelLogicHandler::InitializeEquippedUpgrade(const strutils::String
 
 void UpgradesLevelLogicHandler::Update(const float dtMillis)
 {
-    bool mirrorImageEquipped = GameSingletons::HasEquippedUpgrade(game_constants::MIRROR_IMAGE_UGPRADE_NAME);
-    bool shieldEquipped = GameSingletons::HasEquippedUpgrade(game_constants::PLAYER_SHIELD_UPGRADE_NAME);
+    bool mirrorImageEquipped = mScene.GetGameContext().HasEquippedUpgrade(game_constants::MIRROR_IMAGE_UGPRADE_NAME);
+    bool shieldEquipped = mScene.GetGameContext().HasEquippedUpgrade(game_constants::PLAYER_SHIELD_UPGRADE_NAME);
     
     if (mirrorImageEquipped)
     {
@@ -77,6 +77,16 @@ void UpgradesLevelLogicHandler::Update(const float dtMillis)
 
 ///------------------------------------------------------------------------------------------------
 
+void UpgradesLevelLogicHandler::OnSceneObjectRestored(SceneObject& sceneObject)
+{
+    if (sceneObject.mName == game_constants::PLAYER_SHIELD_SCENE_OBJECT_NAME && sceneObject.mAnimation)
+    {
+        SetPlayerShieldCompletionCallback(sceneObject);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
 void UpgradesLevelLogicHandler::CreateMirrorImageSceneObjects()
 {
     auto& resService = resources::ResourceLoadingService::GetInstance();
@@ -116,10 +126,7 @@ void UpgradesLevelLogicHandler::CreatePlayerShieldSceneObject()
         SceneObject playerShieldSo;
         
         playerShieldSo.mAnimation = std::make_unique<PlayerShieldAnimation>(&playerShieldSo, resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + PLAYER_SHIELD_TEXTURE_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + PLAYER_SHIELD_EFFECT_TEXTURE_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_MESHES_ROOT + PLAYER_SHIELD_MESH_FILE_NAME), resService.LoadResource(resources::ResourceLoadingService::RES_SHADERS_ROOT + game_constants::PLAYER_SHIELD_SHADER_FILE_NAME), glm::vec3(1.0f), false);
-        playerShieldSo.mAnimation->SetCompletionCallback([&]()
-        {
-            mScene.RemoveAllSceneObjectsWithName(game_constants::PLAYER_SHIELD_SCENE_OBJECT_NAME);
-        });
+        SetPlayerShieldCompletionCallback(playerShieldSo);
         
         playerShieldSo.mSceneObjectType = SceneObjectType::WorldGameObject;
         playerShieldSo.mPosition = math::Box2dVec2ToGlmVec3(playerSoOpt->get().mBody->GetWorldCenter()) + PLAYER_SHIELD_POSITION_OFFSET;
@@ -189,3 +196,13 @@ void UpgradesLevelLogicHandler::UpdatePlayerShield(const float dtMillis)
 }
 
 ///------------------------------------------------------------------------------------------------
+
+void UpgradesLevelLogicHandler::SetPlayerShieldCompletionCallback(SceneObject& playerShieldSo)
+{
+    playerShieldSo.mAnimation->SetCompletionCallback([&]()
+    {
+        mScene.RemoveAllSceneObjectsWithName(game_constants::PLAYER_SHIELD_SCENE_OBJECT_NAME);
+    });
+}
+
+///------------------------------------------------------------------------------------------------
@@ -15,6 +15,7 @@
 ///------------------------------------------------------------------------------------------------
 
 class Scene;
+struct SceneObject;
 
 ///------------------------------------------------------------------------------------------------
 
@@ -26,10 +27,14 @@ public:
     void InitializeEquippedUpgrade(const strutils::StringId& upgradeId);
     
     void Update(const float dtMillis);
+    
+    /// Reattaches the animation completion callbacks of upgrade scene objects restored from a level snapshot.
+    void OnSceneObjectRestored(SceneObject& sceneObject);
 
 private:
     void CreateMirrorImageSceneObjects();
     void CreatePlayerShieldSceneObject();
+    void SetPlayerShieldCompletionCallback(SceneObject& playerShieldSo);
     
     void UpdateMirrorImages(const float dtMillis);
     void UpdatePlayerShield(const float dtMillis);
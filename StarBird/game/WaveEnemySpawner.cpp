@@ -0,0 +1,275 @@
+///------------------------------------------------------------------------------------------------
+///  WaveEnemySpawner.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "WaveEnemySpawner.h"
+#include "GameConstants.h"
+#include "GameContext.h"
+#include "LevelSnapshot.h"
+#include "LevelUpdater.h"
+#include "ObjectTypeDefinitionRepository.h"
+#include "PhysicsConstants.h"
+#include "Scene.h"
+#include "SceneObjectUtils.h"
+
+#include <algorithm>
+#include <Box2D/Box2D.h>
+
+///------------------------------------------------------------------------------------------------
+
+static const strutils::StringId ENEMY_SPAWNING_WORK_NAME = strutils::StringId("wave_enemy_spawning");
+
+///------------------------------------------------------------------------------------------------
+
+WaveEnemySpawner::WaveEnemySpawner(Scene& scene, LevelUpdater& levelUpdater, b2World& box2dWorld)
+    : mScene(scene)
+    , mLevelUpdater(levelUpdater)
+    , mBox2dWorld(box2dWorld)
+{
+}
+
+///------------------------------------------------------------------------------------------------
+
+WaveEnemySpawner::~WaveEnemySpawner()
+{
+    Cancel();
+}
+
+///------------------------------------------------------------------------------------------------
+
+void WaveEnemySpawner::BeginWave(const LevelWave& wave)
+{
+    Cancel();
+
+    mWave = &wave;
+
+    auto& objectTypeDefRepo = ObjectTypeDefinitionRepository::GetInstance();
+    const auto difficultySpeedFactor = mLevelUpdater.GetWaveEnemySpeedFactor();
+
+    for (const auto& enemy: wave.mEnemies)
+    {
+        const auto& enemyDefOpt = objectTypeDefRepo.GetObjectTypeDefinition(enemy.mGameObjectEnemyType);
+        if (!enemyDefOpt) continue;
+        const auto& enemyDef = enemyDefOpt->get();
+
+        PendingEnemy pendingEnemy = { &enemy, enemy.mPosition, glm::vec2(0.0f, 0.0f), enemyDef.mLinearDamping };
+
+        // Chasing enemies also move at their constant velocity until they become visible (see LevelUpdater::VUpdate),
+        // so the held back position of both kinds can be tracked exactly. Boss parts are positioned by their AI instead.
+        const auto approachesAtConstantVelocity = enemyDef.mMovementControllerPattern == MovementControllerPattern::CONSTANT_VELOCITY || enemyDef.mMovementControllerPattern == MovementControllerPattern::CHASING_PLAYER;
+        if (wave.mBossName.isEmpty() && approachesAtConstantVelocity)
+        {
+            const auto speedFactor = enemyDef.mContactFilter.categoryBits == physics_constants::ENEMY_CATEGORY_BIT ? difficultySpeedFactor : 1.0f;
+            pendingEnemy.mVelocity = enemyDef.mConstantLinearVelocity * speedFactor;
+        }
+
+        mPendingEnemies.push_back(pendingEnemy);
+    }
+
+    ScheduleDueEnemies();
+}
+
+///------------------------------------------------------------------------------------------------
+
+void WaveEnemySpawner::Update()
+{
+    // Mirror the world step that follows this update (including the velocity damping Box2D applies
+    // before integrating positions), so that held back enemies get spawned exactly where they'd be
+    const auto worldStep = physics_constants::WORLD_STEP * mScene.GetGameContext().GetGameSpeedMultiplier();
+    for (auto& pendingEnemy: mPendingEnemies)
+    {
+        if (!IsDue(pendingEnemy))
+        {
+            const auto dampedVelocity = pendingEnemy.mVelocity / (1.0f + worldStep * pendingEnemy.mLinearDamping);
+            pendingEnemy.mPosition.x += dampedVelocity.x * worldStep;
+            pendingEnemy.mPosition.y += dampedVelocity.y * worldStep;
+        }
+    }
+
+    ScheduleDueEnemies();
+
+    for (auto iter = mDormantShooters.begin(); iter != mDormantShooters.end();)
+    {
+        auto enemySoOpt = mScene.GetSceneObject(iter->mEnemyName);
+        if (!enemySoOpt)
+        {
+            iter = mDormantShooters.erase(iter);
+        }
+        else if (enemySoOpt->get().mBody && enemySoOpt->get().mBody->GetWorldCenter().y <= game_constants::LEVEL_WAVE_VISIBLE_Y)
+        {
+            ActivateProjectileFlow(iter->mEnemyName, iter->mEnemyTypeName);
+            iter = mDormantShooters.erase(iter);
+        }
+        else
+        {
+            iter++;
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void WaveEnemySpawner::Cancel()
+{
+    FrameWorkScheduler::GetInstance().CancelWork(mSpawningWorkHandle);
+    mSpawningWorkHandle = INVALID_WORK_HANDLE;
+    mPendingEnemies.clear();
+    mDormantShooters.clear();
+    mWave = nullptr;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool WaveEnemySpawner::IsFinished() const
+{
+    return mPendingEnemies.empty();
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool WaveEnemySpawner::WriteSnapshot(SnapshotWriter& writer) const
+{
+    writer.Write(static_cast<uint32_t>(mPendingEnemies.size()));
+    for (const auto& pendingEnemy: mPendingEnemies)
+    {
+        writer.Write(static_cast<uint32_t>(pendingEnemy.mEnemy - mWave->mEnemies.data()));
+        writer.Write(pendingEnemy.mPosition);
+        writer.Write(pendingEnemy.mVelocity);
+        writer.Write(pendingEnemy.mLinearDamping);
+    }
+
+    writer.Write(static_cast<uint32_t>(mDormantShooters.size()));
+    for (const auto& dormantShooter: mDormantShooters)
+    {
+        writer.WriteStringId(dormantShooter.mEnemyName);
+        writer.WriteStringId(dormantShooter.mEnemyTypeName);
+    }
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void WaveEnemySpawner::ReadSnapshot(SnapshotReader& reader, const LevelWave& wave)
+{
+    Cancel();
+
+    mWave = &wave;
+
+    const auto pendingEnemyCount = reader.ReadCount(sizeof(uint32_t) + sizeof(PendingEnemy::mPosition) + sizeof(PendingEnemy::mVelocity) + sizeof(PendingEnemy::mLinearDamping));
+    for (uint32_t i = 0; i < pendingEnemyCount && reader.IsValid(); ++i)
+    {
+        const auto enemyIndex = reader.Read<uint32_t>();
+        if (enemyIndex >= wave.mEnemies.size())
+        {
+            reader.Invalidate();
+            break;
+        }
+
+        PendingEnemy pendingEnemy = { &wave.mEnemies[enemyIndex], glm::vec3(0.0f), glm::vec2(0.0f), 0.0f };
+        pendingEnemy.mPosition = reader.Read<glm::vec3>();
+        pendingEnemy.mVelocity = reader.Read<glm::vec2>();
+        pendingEnemy.mLinearDamping = reader.Read<float>();
+        mPendingEnemies.push_back(pendingEnemy);
+    }
+
+    const auto dormantShooterCount = reader.ReadCount();
+    for (uint32_t i = 0; i < dormantShooterCount && reader.IsValid(); ++i)
+    {
+        DormantShooter dormantShooter;
+        dormantShooter.mEnemyName = reader.ReadStringId();
+        dormantShooter.mEnemyTypeName = reader.ReadRawStringId();
+        mDormantShooters.push_back(dormantShooter);
+    }
+
+    if (!reader.IsValid())
+    {
+        Cancel();
+        return;
+    }
+
+    ScheduleDueEnemies();
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool WaveEnemySpawner::IsDue(const PendingEnemy& pendingEnemy) const
+{
+    // Enemies not moving towards the screen would never reach the spawn line
+    return pendingEnemy.mVelocity.y >= 0.0f || pendingEnemy.mPosition.y <= game_constants::LEVEL_WAVE_SPAWN_Y;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void WaveEnemySpawner::ScheduleDueEnemies()
+{
+    auto& frameWorkScheduler = FrameWorkScheduler::GetInstance();
+    if (frameWorkScheduler.IsWorkPending(mSpawningWorkHandle))
+    {
+        return;
+    }
+
+    if (std::any_of(mPendingEnemies.cbegin(), mPendingEnemies.cend(), [this](const PendingEnemy& pendingEnemy){ return IsDue(pendingEnemy); }))
+    {
+        mSpawningWorkHandle = frameWorkScheduler.SubmitWork(ENEMY_SPAWNING_WORK_NAME, WorkPriority::HIGH, [this](){ return SpawnNextDueEnemy(); });
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+WorkStepResult WaveEnemySpawner::SpawnNextDueEnemy()
+{
+    // Due enemies closest to the screen go first
+    auto nextEnemyIter = mPendingEnemies.end();
+    for (auto iter = mPendingEnemies.begin(); iter != mPendingEnemies.end(); ++iter)
+    {
+        if (IsDue(*iter) && (nextEnemyIter == mPendingEnemies.end() || iter->mPosition.y < nextEnemyIter->mPosition.y))
+        {
+            nextEnemyIter = iter;
+        }
+    }
+
+    if (nextEnemyIter == mPendingEnemies.end())
+    {
+        return WorkStepResult::FINISHED;
+    }
+
+    const auto pendingEnemy = *nextEnemyIter;
+    mPendingEnemies.erase(nextEnemyIter);
+
+    const auto& enemyDef = ObjectTypeDefinitionRepository::GetInstance().GetObjectTypeDefinition(pendingEnemy.mEnemy->mGameObjectEnemyType)->get();
+
+    SceneObject so = scene_object_utils::CreateSceneObjectWithBody(enemyDef, pendingEnemy.mPosition, mBox2dWorld, mWave->mBossName.isEmpty() ? strutils::StringId() : enemyDef.mName);
+
+    auto enemyName = so.mName;
+
+    mLevelUpdater.AddWaveEnemy(enemyName);
+    mScene.AddSceneObject(std::move(so));
+
+    if (!enemyDef.mProjectileType.isEmpty())
+    {
+        // Boss parts are choreographed by their AI, so they start shooting right away
+        if (!mWave->mBossName.isEmpty() || pendingEnemy.mPosition.y <= game_constants::LEVEL_WAVE_VISIBLE_Y)
+        {
+            ActivateProjectileFlow(enemyName, pendingEnemy.mEnemy->mGameObjectEnemyType);
+        }
+        else
+        {
+            mDormantShooters.push_back({ enemyName, pendingEnemy.mEnemy->mGameObjectEnemyType });
+        }
+    }
+
+    return std::any_of(mPendingEnemies.cbegin(), mPendingEnemies.cend(), [this](const PendingEnemy& pendingEnemy){ return IsDue(pendingEnemy); }) ? WorkStepResult::CONTINUE : WorkStepResult::FINISHED;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void WaveEnemySpawner::ActivateProjectileFlow(const strutils::StringId& enemyName, const strutils::StringId& enemyTypeName)
+{
+    mLevelUpdater.AddFlow(mLevelUpdater.CreateEnemyProjectileFlow(enemyName, enemyTypeName));
+}
+
+///------------------------------------------------------------------------------------------------
@@ -0,0 +1,100 @@
+///------------------------------------------------------------------------------------------------
+///  WaveEnemySpawner.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef WaveEnemySpawner_h
+#define WaveEnemySpawner_h
+
+///------------------------------------------------------------------------------------------------
+
+#include "FrameWorkScheduler.h"
+#include "../utils/MathUtils.h"
+#include "../utils/StringUtils.h"
+
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+class b2World;
+class LevelUpdater;
+class Scene;
+class SnapshotReader;
+class SnapshotWriter;
+struct LevelEnemy;
+struct LevelWave;
+
+///------------------------------------------------------------------------------------------------
+
+/// Streams a wave's enemies in to the scene, rather than creating all of them on wave start. Enemies
+/// approaching the screen from above are held back until their trigger line (their position in the
+/// wave definition) would have scrolled down to the spawn line, and then created at exactly the
+/// position they would have reached by then. Enemies that don't approach the screen at a constant
+/// velocity (and all enemies of boss waves) have no meaningful trigger line and are due immediately.
+/// Due enemies are created one per step through the FrameWorkScheduler, so that large batches are
+/// spread across frames. Shooting enemies only get their projectile flow once they are visible.
+class WaveEnemySpawner final
+{
+public:
+    WaveEnemySpawner(Scene& scene, LevelUpdater& levelUpdater, b2World& box2dWorld);
+    ~WaveEnemySpawner();
+    WaveEnemySpawner(const WaveEnemySpawner&) = delete;
+    const WaveEnemySpawner& operator = (const WaveEnemySpawner&) = delete;
+
+    /// Queues up all the enemies of the given wave. The wave needs to outlive the spawner.
+    void BeginWave(const LevelWave& wave);
+
+    /// Advances held back enemies by one world step, schedules the spawning of
+    /// the ones that have become due, and activates the projectile flows of
+    /// spawned enemies that have become visible. Called once per world step.
+    void Update();
+
+    /// Drops all enemies that haven't been spawned yet.
+    void Cancel();
+
+    /// @returns whether all the wave's enemies have been spawned.
+    bool IsFinished() const;
+
+    /// Writes the enemies yet to be spawned and the spawned ones yet to start shooting.
+    /// @returns true, as the spawner can be captured at any point.
+    bool WriteSnapshot(SnapshotWriter& writer) const;
+
+    /// Restores a spawner written by WriteSnapshot, in place of BeginWave. Enemies that were being
+    /// spawned at the time get rescheduled. The wave needs to outlive the spawner.
+    void ReadSnapshot(SnapshotReader& reader, const LevelWave& wave);
+
+private:
+    struct PendingEnemy
+    {
+        const LevelEnemy* mEnemy;
+        glm::vec3 mPosition;
+        glm::vec2 mVelocity;
+        float mLinearDamping;
+    };
+
+    struct DormantShooter
+    {
+        strutils::StringId mEnemyName;
+        strutils::StringId mEnemyTypeName;
+    };
+
+    bool IsDue(const PendingEnemy& pendingEnemy) const;
+    void ScheduleDueEnemies();
+    WorkStepResult SpawnNextDueEnemy();
+    void ActivateProjectileFlow(const strutils::StringId& enemyName, const strutils::StringId& enemyTypeName);
+
+private:
+    Scene& mScene;
+    LevelUpdater& mLevelUpdater;
+    b2World& mBox2dWorld;
+    const LevelWave* mWave = nullptr;
+    std::vector<PendingEnemy> mPendingEnemies;
+    std::vector<DormantShooter> mDormantShooters;
+    WorkHandle mSpawningWorkHandle = INVALID_WORK_HANDLE;
+};
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* WaveEnemySpawner_h */
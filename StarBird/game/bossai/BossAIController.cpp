@@ -7,8 +7,12 @@
 
 #include "BossAIController.h"
 #include "KathunBossAI.h"
+#include "../LevelSnapshot.h"
 #include "../../utils/OSMessageBox.h"
 
+#include <algorithm>
+#include <vector>
+
 ///------------------------------------------------------------------------------------------------
 
 BossAIController::BossAIController(Scene& scene, LevelUpdater& levelUpdater, StateMachine& stateMachine, b2World& box2dWorld)
@@ -41,6 +45,45 @@ void BossAIController::UpdateBossAI(const strutils::StringId& bossName, const fl
 
 ///------------------------------------------------------------------------------------------------
 
+void BossAIController::WriteSnapshot(SnapshotWriter& writer) const
+{
+    std::vector<strutils::StringId> bossNames;
+    for (const auto& entry: mBossAIs)
+    {
+        bossNames.push_back(entry.first);
+    }
+    std::sort(bossNames.begin(), bossNames.end(), [](const strutils::StringId& lhs, const strutils::StringId& rhs){ return lhs.GetString() < rhs.GetString(); });
+    
+    writer.Write(static_cast<uint32_t>(bossNames.size()));
+    for (const auto& bossName: bossNames)
+    {
+        writer.WriteStringId(bossName);
+        mBossAIs.at(bossName)->VWriteSnapshot(writer);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool BossAIController::ReadSnapshot(SnapshotReader& reader)
+{
+    const auto bossAICount = reader.ReadCount();
+    for (uint32_t i = 0; i < bossAICount && reader.IsValid(); ++i)
+    {
+        auto targetAIIter = mBossAIs.find(reader.ReadRawStringId());
+        if (targetAIIter == mBossAIs.end())
+        {
+            reader.Invalidate();
+            break;
+        }
+        
+        targetAIIter->second->VReadSnapshot(reader);
+    }
+    
+    return reader.IsValid();
+}
+
+///------------------------------------------------------------------------------------------------
+
 void BossAIController::RegisterBossAIs()
 {
     mBossAIs[KathunBossAI::BOSS_NAME] = std::make_unique<KathunBossAI>(mScene, mLevelUpdater, mStateMachine, mBox2dWorld);
@@ -18,6 +18,8 @@
 ///------------------------------------------------------------------------------------------------
 
 class Scene;
+class SnapshotReader;
+class SnapshotWriter;
 class LevelUpdater;
 class StateMachine;
 class IBossAI;
@@ -30,6 +32,13 @@ public:
     
     void UpdateBossAI(const strutils::StringId& bossName, const float dtMillis);
     
+    /// Writes the state of all boss AIs, for level snapshots.
+    void WriteSnapshot(SnapshotWriter& writer) const;
+    
+    /// Restores the boss AIs written by WriteSnapshot.
+    /// @returns whether the boss AIs could be read.
+    bool ReadSnapshot(SnapshotReader& reader);
+    
 private:
     void RegisterBossAIs();
     
@@ -15,6 +15,8 @@
 ///------------------------------------------------------------------------------------------------
 
 class Scene;
+class SnapshotReader;
+class SnapshotWriter;
 class LevelUpdater;
 class StateMachine;
 class b2World;
@@ -30,6 +32,10 @@ public:
     virtual ~IBossAI() = default;
     virtual void VUpdateBossAI(const float dtMillis) = 0;
     
+    /// Writes/reads the AI's state (and resumes any flows it owns) for level snapshots.
+    virtual void VWriteSnapshot(SnapshotWriter& writer) const = 0;
+    virtual void VReadSnapshot(SnapshotReader& reader) = 0;
+    
 protected:
     Scene& mScene;
     LevelUpdater& mLevelUpdater;
@@ -6,11 +6,12 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "KathunBossAI.h"
+#include "../LevelSnapshot.h"
 #include "../LevelUpdater.h"
 #include "../Scene.h"
 #include "../Sounds.h"
 #include "../GameConstants.h"
-#include "../GameSingletons.h"
+#include "../GameContext.h"
 #include "../datarepos/ObjectTypeDefinitionRepository.h"
 #include "../SceneObjectUtils.h"
 #include "../states/StateMachine.h"
@@ -45,6 +46,7 @@ const std::unordered_map<KathunBossAI::State, float> KathunBossAI::MIN_HEALTH_PE
 
 static const float KATHUN_POSITIONED_Y = 8.0f;
 static const std::string KATHUN_ABILITY_FLOW_NAME_POST_FIX = "_ABILITY_FLOW";
+static const strutils::StringId KATHUN_SHAKE_END_FLOW_NAME = strutils::StringId("KATHUN_SHAKE_END_FLOW");
 static const strutils::StringId KATHUN_BODY_NAME = strutils::StringId("enemies/boss_1/body");
 static const strutils::StringId KATHUN_SLOW_CHASER_ENEMY_TYPE = strutils::StringId("enemies/medium_enemy_chasing");
 static const strutils::StringId KATHUN_FAST_CHASER_ENEMY_TYPE = strutils::StringId("enemies/small_enemy_chasing");
@@ -151,7 +153,7 @@ void KathunBossAI::VUpdateBossAI(const float dtMillis)
                 }
             });
             
-            const auto currentBossHealthPerc = GameSingletons::GetBossCurrentHealth()/GameSingletons::GetBossMaxHealth();
+            const auto currentBossHealthPerc = mScene.GetGameContext().GetBossCurrentHealth()/mScene.GetGameContext().GetBossMaxHealth();
             auto currentStateMinHealthPerc = MIN_HEALTH_PERCENTAGE_PER_STATE.at(mState);
             
             // If we cross the health threshold for next phase change to it
@@ -190,6 +192,79 @@ void KathunBossAI::VUpdateBossAI(const float dtMillis)
 
 ///------------------------------------------------------------------------------------------------
 
+void KathunBossAI::VWriteSnapshot(SnapshotWriter& writer) const
+{
+    writer.Write(mState);
+    writer.Write(mShaking);
+    
+    const auto writeFlow = [&](const strutils::StringId& flowName)
+    {
+        auto flowOpt = mLevelUpdater.GetFlow(flowName);
+        writer.Write(flowOpt.has_value());
+        if (flowOpt)
+        {
+            writer.Write(flowOpt->get().GetDuration());
+            writer.Write(flowOpt->get().GetTicksLeft());
+        }
+    };
+    
+    for (auto i = 0; i < static_cast<int>(Ability::COUNT); ++i)
+    {
+        writeFlow(strutils::StringId(std::to_string(i) + KATHUN_ABILITY_FLOW_NAME_POST_FIX));
+    }
+    writeFlow(KATHUN_SHAKE_END_FLOW_NAME);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void KathunBossAI::VReadSnapshot(SnapshotReader& reader)
+{
+    mState = reader.Read<State>();
+    mShaking = reader.Read<bool>();
+    if (static_cast<int>(mState) > static_cast<int>(State::COUNT))
+    {
+        reader.Invalidate();
+        return;
+    }
+    
+    // Flows are resumed with the duration they had, as phase changes adjust the cooldowns of running ability flows
+    for (auto i = 0; i < static_cast<int>(Ability::COUNT); ++i)
+    {
+        if (reader.Read<bool>())
+        {
+            const auto cooldownMillis = reader.Read<float>();
+            const auto ticksLeft = reader.Read<float>();
+            mLevelUpdater.ResumeFlow(CreateAbilityFlow(static_cast<Ability>(i), cooldownMillis), ticksLeft);
+        }
+    }
+    
+    if (reader.Read<bool>())
+    {
+        const auto durationMillis = reader.Read<float>();
+        const auto ticksLeft = reader.Read<float>();
+        mLevelUpdater.ResumeFlow(CreateShakeEndFlow(durationMillis), ticksLeft);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+RepeatableFlow KathunBossAI::CreateAbilityFlow(const Ability ability, const float cooldownMillis)
+{
+    return RepeatableFlow([this, ability]()
+    {
+        OnAbilityTrigger(ability);
+    }, cooldownMillis, RepeatableFlow::RepeatPolicy::REPEAT, strutils::StringId(std::to_string(static_cast<int>(ability)) + KATHUN_ABILITY_FLOW_NAME_POST_FIX));
+}
+
+///------------------------------------------------------------------------------------------------
+
+RepeatableFlow KathunBossAI::CreateShakeEndFlow(const float durationMillis)
+{
+    return RepeatableFlow([this](){ OnShakeEnd(); }, durationMillis, RepeatableFlow::RepeatPolicy::ONCE, KATHUN_SHAKE_END_FLOW_NAME);
+}
+
+///------------------------------------------------------------------------------------------------
+
 void KathunBossAI::OnAbilityTrigger(const Ability ability)
 {
     
@@ -238,7 +313,7 @@ void KathunBossAI::OnAbilityTrigger(const Ability ability)
                     
                 case Ability::DIAGONAL_BULLET:
                 {
-                    const auto& worldCamera = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::WorldGameObject)->get();
+                    const auto& worldCamera = mScene.GetGameContext().GetCameraForSceneObjectType(SceneObjectType::WorldGameObject)->get();
                     SpawnEnemyAt(bossPosition + KATHUN_VERTICAL_BULLET_SPAWN_POSITIONS[0], glm::normalize(glm::vec3(-worldCamera.GetCameraLenseWidth()/2, -worldCamera.GetCameraLenseHeight()/2, -0.5f) - bossPosition), KATHUN_BULLET_TYPE);
                     SpawnEnemyAt(bossPosition + KATHUN_VERTICAL_BULLET_SPAWN_POSITIONS[0], glm::normalize(glm::vec3(0.0f, 0.0f, -0.5f) - bossPosition), KATHUN_BULLET_TYPE);
                     SpawnEnemyAt(bossPosition + KATHUN_VERTICAL_BULLET_SPAWN_POSITIONS[0], glm::normalize(glm::vec3(worldCamera.GetCameraLenseWidth()/2, -worldCamera.GetCameraLenseHeight()/2, -0.5f) - bossPosition), KATHUN_BULLET_TYPE);
@@ -268,7 +343,7 @@ void KathunBossAI::OnAbilityTrigger(const Ability ability)
                 
                 case Ability::DIAGONAL_BULLET:
                 {
-                    const auto& worldCamera = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::WorldGameObject)->get();
+                    const auto& worldCamera = mScene.GetGameContext().GetCameraForSceneObjectType(SceneObjectType::WorldGameObject)->get();
                     SpawnEnemyAt(bossPosition + KATHUN_VERTICAL_BULLET_SPAWN_POSITIONS[0], glm::normalize(glm::vec3(-worldCamera.GetCameraLenseWidth()/2, -worldCamera.GetCameraLenseHeight()/2, -0.5f) - bossPosition), KATHUN_BULLET_TYPE);
                     SpawnEnemyAt(bossPosition + KATHUN_VERTICAL_BULLET_SPAWN_POSITIONS[0], glm::normalize(glm::vec3(-worldCamera.GetCameraLenseWidth()/4, -worldCamera.GetCameraLenseHeight()/2, -0.5f) - bossPosition), KATHUN_BULLET_TYPE);
                     SpawnEnemyAt(bossPosition + KATHUN_VERTICAL_BULLET_SPAWN_POSITIONS[0], glm::normalize(glm::vec3(0.0f, 0.0f, -0.5f) - bossPosition), KATHUN_BULLET_TYPE);
@@ -291,6 +366,21 @@ void KathunBossAI::OnAbilityTrigger(const Ability ability)
 
 ///------------------------------------------------------------------------------------------------
 
+void KathunBossAI::OnShakeEnd()
+{
+    mShaking = false;
+    for (const auto& flapName: KATHUN_FLAP_NAMES)
+    {
+        auto soOpt = mScene.GetSceneObject(flapName);
+        if (soOpt)
+        {
+            static_cast<RotationAnimation*>(soOpt->get().mAnimation.get())->SetRotationMode(RotationAnimation::RotationMode::ROTATE_TO_TARGET_AND_BACK_CONTINUALLY);
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
 void KathunBossAI::OnStateChange(const bool shakeCamera)
 {
     for (const auto& abilityStateMapEntry: ABILITY_COOLDOWNS_PER_STATE)
@@ -309,10 +399,7 @@ void KathunBossAI::OnStateChange(const bool shakeCamera)
         }
         else if (abilityStateMapEntry.second.count(mState))
         {
-            mLevelUpdater.AddFlow(RepeatableFlow([&]()
-            {
-                OnAbilityTrigger(abilityStateMapEntry.first);
-            }, abilityStateMapEntry.second.at(mState), RepeatableFlow::RepeatPolicy::REPEAT, flowName));
+            mLevelUpdater.AddFlow(CreateAbilityFlow(abilityStateMapEntry.first, abilityStateMapEntry.second.at(mState)));
         }
     }
     
@@ -327,18 +414,7 @@ void KathunBossAI::OnStateChange(const bool shakeCamera)
                 static_cast<RotationAnimation*>(soOpt->get().mAnimation.get())->SetRotationMode(RotationAnimation::RotationMode::ROTATE_TO_TARGET_ONCE);
             }
         }
-        mLevelUpdater.AddFlow(RepeatableFlow([&]()
-        {
-            mShaking = false;
-            for (const auto& flapName: KATHUN_FLAP_NAMES)
-            {
-                auto soOpt = mScene.GetSceneObject(flapName);
-                if (soOpt)
-                {
-                    static_cast<RotationAnimation*>(soOpt->get().mAnimation.get())->SetRotationMode(RotationAnimation::RotationMode::ROTATE_TO_TARGET_AND_BACK_CONTINUALLY);
-                }
-            }
-        }, game_constants::BOSS_INTRO_DURATION_MILLIS/2, RepeatableFlow::RepeatPolicy::ONCE));
+        mLevelUpdater.AddFlow(CreateShakeEndFlow(game_constants::BOSS_INTRO_DURATION_MILLIS/2));
         
         objectiveC_utils::PlaySound(sounds::BOSS_SCREAM_SFX);
     }
@@ -348,8 +424,8 @@ void KathunBossAI::OnStateChange(const bool shakeCamera)
 
 void KathunBossAI::CameraShake()
 {
-    const auto& guiCamOpt = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::GUIObject);
-    const auto& worldCamOpt = GameSingletons::GetCameraForSceneObjectType(SceneObjectType::WorldGameObject);
+    const auto& guiCamOpt = mScene.GetGameContext().GetCameraForSceneObjectType(SceneObjectType::GUIObject);
+    const auto& worldCamOpt = mScene.GetGameContext().GetCameraForSceneObjectType(SceneObjectType::WorldGameObject);
     
     if (guiCamOpt) guiCamOpt->get().Shake();
     if (worldCamOpt) worldCamOpt->get().Shake();
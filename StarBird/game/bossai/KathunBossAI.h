@@ -11,8 +11,10 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "IBossAI.h"
+#include "../RepeatableFlow.h"
 #include "../../utils/MathUtils.h"
 
+#include <cstdint>
 #include <unordered_map>
 
 ///------------------------------------------------------------------------------------------------
@@ -31,9 +33,11 @@ public:
     KathunBossAI(Scene& scene, LevelUpdater& levelUpdater, StateMachine& stateMachine, b2World& box2dWorld);
     
     void VUpdateBossAI(const float dtMillis) override;
+    void VWriteSnapshot(SnapshotWriter& writer) const override;
+    void VReadSnapshot(SnapshotReader& reader) override;
     
 private:
-    enum class State
+    enum class State : uint8_t
     {
         BOSS_MOVING_TO_POSITION = 0,
         BOSS_POSITIONED = 1,
@@ -56,7 +60,10 @@ private:
     static const std::unordered_map<State, float> MIN_HEALTH_PERCENTAGE_PER_STATE;
     
 private:
+    RepeatableFlow CreateAbilityFlow(const Ability ability, const float cooldownMillis);
+    RepeatableFlow CreateShakeEndFlow(const float durationMillis);
     void OnAbilityTrigger(const Ability ability);
+    void OnShakeEnd();
     void OnStateChange(const bool shakeCamera);
     void CameraShake();
     void SpawnEnemyAt(const glm::vec3& position, const glm::vec3& direction, const strutils::StringId& enemyType);
@@ -6,35 +6,58 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "BaseGameDataLoader.h"
-#include "../../resloading/DataFileResource.h"
+#include "GameDataBundle.h"
+#include "../../resloading/AssetArchive.h"
 #include "../../resloading/ResourceLoadingService.h"
-#include "../../utils/ObjectiveCUtils.h"
 #include "../../utils/Logging.h"
+#include "../../utils/ObjectiveCUtils.h"
+#include "../../utils/OSMessageBox.h"
 
+#include <algorithm>
 #include <rapidxml/rapidxml.hpp>
+#include <SDL.h>
+
+///------------------------------------------------------------------------------------------------
+
+static const size_t MIN_NODE_CALLBACK_TABLE_SIZE = 16;
 
 ///------------------------------------------------------------------------------------------------
 
-void ProcessNode(const rapidxml::xml_node<>* node, BaseGameDataLoader::NodeNameToCallbackType& callbackMap)
+static BaseGameDataLoader::NodeCallbackEntry& FindNodeCallbackSlot(BaseGameDataLoader::NodeCallbackTable& callbackTable, const size_t nodeNameHash)
 {
-    auto findIter = callbackMap.find(strutils::StringId(node->name()));
-    if (findIter != callbackMap.end())
+    const auto slotMask = callbackTable.size() - 1;
+    auto slotIndex = nodeNameHash & slotMask;
+    
+    while (callbackTable[slotIndex].mCallback && callbackTable[slotIndex].mNodeNameHash != nodeNameHash)
     {
-        findIter->second(node);
+        slotIndex = (slotIndex + 1) & slotMask;
     }
+    
+    return callbackTable[slotIndex];
 }
 
 ///------------------------------------------------------------------------------------------------
 
-void RecursivelyTraverseViewNodes(const rapidxml::xml_node<>* node, BaseGameDataLoader::NodeNameToCallbackType& callbackMap)
+static void ProcessNode(const rapidxml::xml_node<>* node, BaseGameDataLoader::NodeCallbackTable& callbackTable)
 {
-    if (node == nullptr || std::strlen(node->name()) == 0) return;
+    const auto& slot = FindNodeCallbackSlot(callbackTable, strutils::GetStringHash(std::string_view(node->name(), node->name_size())));
+    if (slot.mCallback)
+    {
+        slot.mCallback(node);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void RecursivelyTraverseViewNodes(const rapidxml::xml_node<>* node, BaseGameDataLoader::NodeCallbackTable& callbackTable)
+{
+    if (node == nullptr || node->name_size() == 0) return;
     
-    ProcessNode(node, callbackMap);
+    ProcessNode(node, callbackTable);
     
     for (auto childNode = node->first_node(); childNode; childNode = childNode->next_sibling())
     {
-        RecursivelyTraverseViewNodes(childNode, callbackMap);
+        RecursivelyTraverseViewNodes(childNode, callbackTable);
     }
 }
 
@@ -42,31 +65,78 @@ void RecursivelyTraverseViewNodes(const rapidxml::xml_node<>* node, BaseGameData
 
 void BaseGameDataLoader::SetCallbackForNode(const strutils::StringId& nodeName, NodeCallbackType callback)
 {
-    mNodeNameToCallbackMap[nodeName] = callback;
+    // Keep the table at most half full, so that probe sequences stay short
+    if ((mNodeCallbackCount + 1) * 2 > mNodeCallbackTable.size())
+    {
+        NodeCallbackTable resizedTable(std::max(MIN_NODE_CALLBACK_TABLE_SIZE, mNodeCallbackTable.size() * 2));
+        for (auto& entry: mNodeCallbackTable)
+        {
+            if (entry.mCallback)
+            {
+                FindNodeCallbackSlot(resizedTable, entry.mNodeNameHash) = std::move(entry);
+            }
+        }
+        mNodeCallbackTable = std::move(resizedTable);
+    }
+    
+    auto& slot = FindNodeCallbackSlot(mNodeCallbackTable, nodeName.GetStringId());
+    if (!slot.mCallback)
+    {
+        mNodeCallbackCount++;
+    }
+    
+    slot.mNodeNameHash = nodeName.GetStringId();
+    slot.mCallback = callback;
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void BaseGameDataLoader::LoadData(const std::string& dataFileName, bool printOutDataFile /* = false */)
 {
-    auto& resService = resources::ResourceLoadingService::GetInstance();
-    auto resourceId = resService.LoadResource(strutils::StringStartsWith(dataFileName, objectiveC_utils::GetLocalFileSaveLocation()) ? (dataFileName + ".xml") : (resources::ResourceLoadingService::RES_DATA_ROOT + dataFileName + ".xml"));
-    auto& xmlLevel = resService.GetResource<resources::DataFileResource>(resourceId);
-    auto xmlContents = xmlLevel.GetContents();
+    if (mNodeCallbackTable.empty())
+    {
+        return;
+    }
     
-    if (printOutDataFile)
+    const auto isLocalSaveFile = strutils::StringStartsWith(dataFileName, objectiveC_utils::GetLocalFileSaveLocation());
+    
+    // Shipped game data comes pre-parsed from the bundle, when one is mounted
+    if (!isLocalSaveFile && !printOutDataFile)
+    {
+        rapidxml::xml_document<> doc;
+        if (GameDataBundle::GetInstance().BuildDocument(dataFileName + ".xml", doc))
+        {
+            RecursivelyTraverseViewNodes(doc.first_node(), mNodeCallbackTable);
+            return;
+        }
+    }
+    
+    const auto loadStartCounter = SDL_GetPerformanceCounter();
+    
+    // Parse in place over a private, writable view of the file, rather than copying its contents
+    // in to a resource and then again in to a mutable buffer for rapidxml
+    const auto filePath = isLocalSaveFile ? (dataFileName + ".xml") : (resources::ResourceLoadingService::RES_DATA_ROOT + dataFileName + ".xml");
+    resources::MutableResourceFile file(filePath);
+    
+    if (!file.IsValid())
     {
-        Log(LogType::INFO, "Loaded file:\n%s", xmlContents.c_str());
+        ospopups::ShowMessageBox(ospopups::MessageBoxType::ERROR, "File could not be found", filePath.c_str());
+        return;
     }
     
-    resService.UnloadResource(resourceId);
+    if (printOutDataFile)
+    {
+        Log(LogType::INFO, "Loaded file:\n%s", file.GetData());
+    }
     
     rapidxml::xml_document<> doc;
-    doc.parse<0>(&xmlContents[0]);
+    doc.parse<0>(file.GetData());
         
     auto node = doc.first_node();
     
-    RecursivelyTraverseViewNodes(node, mNodeNameToCallbackMap);
+    RecursivelyTraverseViewNodes(node, mNodeCallbackTable);
+    
+    Log(LogType::INFO, "Loaded data file %s (%zu bytes) in %.3f millis", filePath.c_str(), file.GetSize(), (SDL_GetPerformanceCounter() - loadStartCounter) * 1000.0/SDL_GetPerformanceFrequency());
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -14,7 +14,7 @@
 
 #include <string>
 #include <functional>
-#include <unordered_map>
+#include <vector>
 
 ///------------------------------------------------------------------------------------------------
 
@@ -22,7 +22,16 @@ class BaseGameDataLoader
 {
 public:
     using NodeCallbackType = std::function<void(const void*)>;
-    using NodeNameToCallbackType = std::unordered_map<strutils::StringId, NodeCallbackType, strutils::StringIdHasher>;
+    
+    /// Single slot of the node name to callback table. The table is an open addressing
+    /// hash table (linear probing, power of two slot count) keyed by the hash of the node name,
+    /// so that visiting a node needs no allocation for the lookup. Empty slots have no callback.
+    struct NodeCallbackEntry
+    {
+        size_t mNodeNameHash = 0;
+        NodeCallbackType mCallback;
+    };
+    using NodeCallbackTable = std::vector<NodeCallbackEntry>;
     
 protected:
     BaseGameDataLoader() = default;
@@ -31,7 +40,8 @@ protected:
     void LoadData(const std::string& dataFileName, bool printOutDataFile = false);
     
 private:
-    NodeNameToCallbackType mNodeNameToCallbackMap;
+    NodeCallbackTable mNodeCallbackTable;
+    size_t mNodeCallbackCount = 0;
 };
 
 ///------------------------------------------------------------------------------------------------
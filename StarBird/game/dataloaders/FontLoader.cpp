@@ -24,19 +24,19 @@ FontLoader::FontLoader()
         auto* width = node->first_attribute("width");
         if (width)
         {
-            glyph.mWidthPixels = std::stoi(width->value());
+            glyph.mWidthPixels = strutils::StringToInt(width->value());
         }
         
         auto* height = node->first_attribute("height");
         if (height)
         {
-            glyph.mHeightPixels = std::stoi(height->value());
+            glyph.mHeightPixels = strutils::StringToInt(height->value());
         }
         
         auto* x = node->first_attribute("x");
         if (x)
         {
-            auto normalizedU = std::stof(x->value()) / mConstructedFont.mFontTextureDimensions.x;
+            auto normalizedU = strutils::StringToFloat(x->value()) / mConstructedFont.mFontTextureDimensions.x;
             glyph.minU = normalizedU;
             glyph.maxU = normalizedU + glyph.mWidthPixels / mConstructedFont.mFontTextureDimensions.x;
         }
@@ -44,7 +44,7 @@ FontLoader::FontLoader()
         auto* y = node->first_attribute("y");
         if (y)
         {
-            auto normalizedV = (mConstructedFont.mFontTextureDimensions.y - std::stof(y->value())) / mConstructedFont.mFontTextureDimensions.y;
+            auto normalizedV = (mConstructedFont.mFontTextureDimensions.y - strutils::StringToFloat(y->value())) / mConstructedFont.mFontTextureDimensions.y;
             glyph.minV = normalizedV - glyph.mHeightPixels / mConstructedFont.mFontTextureDimensions.y;
             glyph.maxV = normalizedV;
         }
@@ -52,13 +52,13 @@ FontLoader::FontLoader()
         auto* yOffset = node->first_attribute("origin-y");
         if (yOffset)
         {
-            glyph.mYOffsetPixels = std::stof(yOffset->value());
+            glyph.mYOffsetPixels = strutils::StringToFloat(yOffset->value());
         }
         
         auto* advance = node->first_attribute("advance");
         if (advance)
         {
-            glyph.mAdvancePixels = std::stof(advance->value());
+            glyph.mAdvancePixels = strutils::StringToFloat(advance->value());
         }
         
         auto* text = node->first_attribute("text");
@@ -35,18 +35,20 @@ GUISceneLoader::GUISceneLoader()
         auto* position = node->first_attribute("position");
         if (position)
         {
-            auto positionComponents = strutils::StringSplit(std::string(position->value()), ',');
-            guiElement.mPosition.x = std::stof(positionComponents[0]);
-            guiElement.mPosition.y = std::stof(positionComponents[1]);
-            guiElement.mPosition.z = std::stof(positionComponents[2]);
+            std::array<std::string_view, 3> positionComponents;
+            strutils::StringSplitView(position->value(), ',', positionComponents);
+            guiElement.mPosition.x = strutils::StringToFloat(positionComponents[0]);
+            guiElement.mPosition.y = strutils::StringToFloat(positionComponents[1]);
+            guiElement.mPosition.z = strutils::StringToFloat(positionComponents[2]);
         }
         
         auto* scale = node->first_attribute("scale");
         if (scale)
         {
-            auto scaleComponents = strutils::StringSplit(std::string(scale->value()), ',');
-            guiElement.mScale.x = std::stof(scaleComponents[0]);
-            guiElement.mScale.y = std::stof(scaleComponents[1]);
+            std::array<std::string_view, 2> scaleComponents;
+            strutils::StringSplitView(scale->value(), ',', scaleComponents);
+            guiElement.mScale.x = strutils::StringToFloat(scaleComponents[0]);
+            guiElement.mScale.y = strutils::StringToFloat(scaleComponents[1]);
             guiElement.mScale.z = 1.0f;
         }
         
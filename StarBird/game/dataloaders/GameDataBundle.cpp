@@ -0,0 +1,522 @@
+///------------------------------------------------------------------------------------------------
+///  GameDataBundle.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "GameDataBundle.h"
+#include "../../resloading/AssetArchive.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+
+///------------------------------------------------------------------------------------------------
+
+// Every record's fields, in order. Needs to be updated alongside the record structs.
+static const char* GAME_DATA_BUNDLE_SCHEMA =
+    "string{u32 offset;u32 length}"
+    "header{u32 magic;u32 version;u64 schemaHash;u32 fileSlotCount;u32 nodeCount;u32 attributeCount;u32 stringSectionSize}"
+    "file{u64 pathHash;u64 sourceHash;string path;u32 firstNode;u32 nodeCount}"
+    "node{string name;string value;u32 parentIndex;u32 firstAttribute;u32 attributeCount}"
+    "attribute{string name;string value}";
+
+///------------------------------------------------------------------------------------------------
+
+// Strings are referenced in place as NUL terminated, so the terminator has to be in the section too
+static bool IsValidString(const GameDataBundleString& string, const char* strings, const uint32_t stringSectionSize)
+{
+    return static_cast<uint64_t>(string.mOffset) + string.mLength < stringSectionSize && strings[string.mOffset + string.mLength] == '\0';
+}
+
+///------------------------------------------------------------------------------------------------
+
+// Checks every record BuildDocument follows for the given file, so that a corrupt bundle is
+// refused on mount rather than read out of bounds later on
+static bool IsValidFile(const GameDataBundleFile& file, const GameDataBundleHeader& header, const GameDataBundleNode* nodes, const GameDataBundleAttribute* attributes, const char* strings)
+{
+    if (!IsValidString(file.mPath, strings, header.mStringSectionSize) || static_cast<uint64_t>(file.mFirstNode) + file.mNodeCount > header.mNodeCount)
+    {
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < file.mNodeCount; ++i)
+    {
+        const auto& node = nodes[file.mFirstNode + i];
+        
+        // Nodes are in pre-order, so a parent (if any) is always an earlier node of the same file
+        if (!IsValidString(node.mName, strings, header.mStringSectionSize) ||
+            !IsValidString(node.mValue, strings, header.mStringSectionSize) ||
+            (node.mParentIndex != game_data_bundle::NO_PARENT_NODE && node.mParentIndex >= i) ||
+            static_cast<uint64_t>(node.mFirstAttribute) + node.mAttributeCount > header.mAttributeCount)
+        {
+            return false;
+        }
+        
+        for (uint32_t j = 0; j < node.mAttributeCount; ++j)
+        {
+            const auto& attribute = attributes[node.mFirstAttribute + j];
+            if (!IsValidString(attribute.mName, strings, header.mStringSectionSize) || !IsValidString(attribute.mValue, strings, header.mStringSectionSize))
+            {
+                return false;
+            }
+        }
+    }
+    
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+GameDataBundle& GameDataBundle::GetInstance()
+{
+    static GameDataBundle instance;
+    return instance;
+}
+
+///------------------------------------------------------------------------------------------------
+
+GameDataBundle::~GameDataBundle()
+{
+    Unmount();
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool GameDataBundle::Mount(const std::string& bundlePath, std::string& outError)
+{
+    Unmount();
+
+    auto bundleFile = std::make_unique<resources::ResourceFile>(bundlePath);
+    if (!bundleFile->IsValid())
+    {
+        outError = "Bundle not found";
+        return false;
+    }
+
+    const auto* data = bundleFile->GetData();
+    const auto dataSize = bundleFile->GetSize();
+
+    if (dataSize < sizeof(GameDataBundleHeader))
+    {
+        outError = "Bundle is truncated";
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const GameDataBundleHeader*>(data);
+    if (header->mMagic != game_data_bundle::GAME_DATA_BUNDLE_MAGIC || header->mVersion != game_data_bundle::GAME_DATA_BUNDLE_VERSION)
+    {
+        outError = "Unrecognized bundle format or version";
+        return false;
+    }
+
+    if (header->mSchemaHash != game_data_bundle::GetSchemaHash())
+    {
+        outError = "Bundle was compiled against a different schema";
+        return false;
+    }
+
+    if (header->mFileSlotCount == 0 || (header->mFileSlotCount & (header->mFileSlotCount - 1)) != 0)
+    {
+        outError = "Bundle file directory is corrupt";
+        return false;
+    }
+
+    const auto expectedSize =
+        sizeof(GameDataBundleHeader) +
+        header->mFileSlotCount * sizeof(GameDataBundleFile) +
+        header->mNodeCount * sizeof(GameDataBundleNode) +
+        header->mAttributeCount * sizeof(GameDataBundleAttribute) +
+        header->mStringSectionSize;
+
+    if (dataSize < expectedSize)
+    {
+        outError = "Bundle is truncated";
+        return false;
+    }
+
+    const auto* files = reinterpret_cast<const GameDataBundleFile*>(data + sizeof(GameDataBundleHeader));
+    const auto* nodes = reinterpret_cast<const GameDataBundleNode*>(files + header->mFileSlotCount);
+    const auto* attributes = reinterpret_cast<const GameDataBundleAttribute*>(nodes + header->mNodeCount);
+    const auto* strings = reinterpret_cast<const char*>(attributes + header->mAttributeCount);
+    
+    for (uint32_t i = 0; i < header->mFileSlotCount; ++i)
+    {
+        if (files[i].mPathHash != 0 && !IsValidFile(files[i], *header, nodes, attributes, strings))
+        {
+            outError = "Bundle records are corrupt";
+            return false;
+        }
+    }
+
+    mHeader = header;
+    mFiles = files;
+    mNodes = nodes;
+    mAttributes = attributes;
+    mStrings = strings;
+    mDataRootDirectory = bundlePath.substr(0, bundlePath.find_last_of('/') + 1);
+    mBundleFile = std::move(bundleFile);
+    
+    RefreshStaleFiles();
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameDataBundle::Unmount()
+{
+    mBundleFile = nullptr;
+    mHeader = nullptr;
+    mFiles = nullptr;
+    mNodes = nullptr;
+    mAttributes = nullptr;
+    mStrings = nullptr;
+    mDataRootDirectory.clear();
+    mStaleFiles.clear();
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool GameDataBundle::IsMounted() const
+{
+    return mHeader != nullptr;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameDataBundle::SetHotReloadEnabled(const bool hotReloadEnabled)
+{
+    mHotReloadEnabled = hotReloadEnabled;
+    
+    // The sources may well have been edited while the bundle was bypassed
+    if (!mHotReloadEnabled && IsMounted())
+    {
+        RefreshStaleFiles();
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool GameDataBundle::IsHotReloadEnabled() const
+{
+    return mHotReloadEnabled;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool GameDataBundle::BuildDocument(const std::string& relativeFilePath, rapidxml::xml_document<>& outDocument) const
+{
+    if (!IsMounted() || mHotReloadEnabled)
+    {
+        return false;
+    }
+
+    const auto* file = FindFile(relativeFilePath);
+    if (!file)
+    {
+        return false;
+    }
+
+    if (mStaleFiles[file - mFiles])
+    {
+        return false;
+    }
+
+    // Names & values are referenced in place (they are NUL terminated in the bundle), so
+    // the document only allocates the node and attribute objects themselves from its pool
+    std::vector<rapidxml::xml_node<>*> fileNodes(file->mNodeCount);
+    for (uint32_t i = 0; i < file->mNodeCount; ++i)
+    {
+        const auto& bundleNode = mNodes[file->mFirstNode + i];
+
+        auto* node = outDocument.allocate_node(rapidxml::node_element);
+        node->name(mStrings + bundleNode.mName.mOffset, bundleNode.mName.mLength);
+        node->value(mStrings + bundleNode.mValue.mOffset, bundleNode.mValue.mLength);
+
+        for (uint32_t j = 0; j < bundleNode.mAttributeCount; ++j)
+        {
+            const auto& bundleAttribute = mAttributes[bundleNode.mFirstAttribute + j];
+
+            auto* attribute = outDocument.allocate_attribute();
+            attribute->name(mStrings + bundleAttribute.mName.mOffset, bundleAttribute.mName.mLength);
+            attribute->value(mStrings + bundleAttribute.mValue.mOffset, bundleAttribute.mValue.mLength);
+            node->append_attribute(attribute);
+        }
+
+        if (bundleNode.mParentIndex == game_data_bundle::NO_PARENT_NODE)
+        {
+            outDocument.append_node(node);
+        }
+        else
+        {
+            fileNodes[bundleNode.mParentIndex]->append_node(node);
+        }
+
+        fileNodes[i] = node;
+    }
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GameDataBundle::RefreshStaleFiles()
+{
+    // Hashing the (memory mapped) sources is still far cheaper than parsing them, and guards against
+    // a bundle that wasn't recompiled after a data file changed. Entries without a source shipped
+    // next to the bundle can't be stale.
+    mStaleFiles.assign(mHeader->mFileSlotCount, false);
+    for (uint32_t i = 0; i < mHeader->mFileSlotCount; ++i)
+    {
+        if (mFiles[i].mPathHash == 0)
+        {
+            continue;
+        }
+        
+        const resources::ResourceFile sourceFile(mDataRootDirectory + std::string(mStrings + mFiles[i].mPath.mOffset, mFiles[i].mPath.mLength));
+        mStaleFiles[i] = sourceFile.IsValid() && resources::asset_archive::HashPath(sourceFile.GetContents()) != mFiles[i].mSourceHash;
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+const GameDataBundleFile* GameDataBundle::FindFile(const std::string& relativeFilePath) const
+{
+    const auto pathHash = resources::asset_archive::HashPath(relativeFilePath);
+    const auto slotMask = mHeader->mFileSlotCount - 1;
+
+    for (uint32_t probe = 0, slot = static_cast<uint32_t>(pathHash) & slotMask; probe < mHeader->mFileSlotCount; ++probe, slot = (slot + 1) & slotMask)
+    {
+        const auto& file = mFiles[slot];
+        if (file.mPathHash == 0)
+        {
+            return nullptr;
+        }
+
+        // Paths are compared in full, so that a hash collision can't hand out another file's tree
+        if (file.mPathHash == pathHash && std::string_view(mStrings + file.mPath.mOffset, file.mPath.mLength) == relativeFilePath)
+        {
+            return &file;
+        }
+    }
+
+    return nullptr;
+}
+
+///------------------------------------------------------------------------------------------------
+
+namespace game_data_bundle
+{
+
+///------------------------------------------------------------------------------------------------
+
+uint64_t GetSchemaHash()
+{
+    return resources::asset_archive::HashPath(GAME_DATA_BUNDLE_SCHEMA);
+}
+
+///------------------------------------------------------------------------------------------------
+
+class BundleWriter
+{
+public:
+    GameDataBundleString AddString(const char* str, const size_t length)
+    {
+        const std::string key(str, length);
+
+        auto findIter = mStringOffsets.find(key);
+        if (findIter == mStringOffsets.end())
+        {
+            findIter = mStringOffsets.emplace(key, static_cast<uint32_t>(mStrings.size())).first;
+            mStrings.insert(mStrings.end(), key.begin(), key.end());
+            mStrings.push_back('\0');
+        }
+
+        return { findIter->second, static_cast<uint32_t>(length) };
+    }
+
+    void AddNodeTree(const rapidxml::xml_node<>* node, const uint32_t fileFirstNode, const uint32_t parentIndex)
+    {
+        const auto nodeIndex = static_cast<uint32_t>(mNodes.size()) - fileFirstNode;
+
+        GameDataBundleNode bundleNode;
+        bundleNode.mName = AddString(node->name(), node->name_size());
+        bundleNode.mValue = AddString(node->value(), node->value_size());
+        bundleNode.mParentIndex = parentIndex;
+        bundleNode.mFirstAttribute = static_cast<uint32_t>(mAttributes.size());
+        bundleNode.mAttributeCount = 0;
+
+        for (auto* attribute = node->first_attribute(); attribute; attribute = attribute->next_attribute())
+        {
+            mAttributes.push_back({ AddString(attribute->name(), attribute->name_size()), AddString(attribute->value(), attribute->value_size()) });
+            bundleNode.mAttributeCount++;
+        }
+
+        mNodes.push_back(bundleNode);
+
+        for (auto* childNode = node->first_node(); childNode; childNode = childNode->next_sibling())
+        {
+            // Only elements are ever visited by the loaders
+            if (childNode->type() == rapidxml::node_element)
+            {
+                AddNodeTree(childNode, fileFirstNode, nodeIndex);
+            }
+        }
+    }
+
+    void AddFile(const std::string& relativeFilePath, const uint64_t sourceHash, const rapidxml::xml_node<>* rootNode)
+    {
+        GameDataBundleFile file;
+        file.mPathHash = resources::asset_archive::HashPath(relativeFilePath);
+        file.mSourceHash = sourceHash;
+        file.mPath = AddString(relativeFilePath.c_str(), relativeFilePath.size());
+        file.mFirstNode = static_cast<uint32_t>(mNodes.size());
+        AddNodeTree(rootNode, file.mFirstNode, NO_PARENT_NODE);
+        file.mNodeCount = static_cast<uint32_t>(mNodes.size()) - file.mFirstNode;
+        mFiles.push_back(file);
+    }
+
+    bool Write(const std::string& bundlePath) const
+    {
+        std::ofstream bundleFile(bundlePath, std::ios::binary | std::ios::trunc);
+        if (!bundleFile)
+        {
+            return false;
+        }
+
+        // Keep the directory at most half full, so that probe sequences stay short
+        uint32_t slotCount = 1;
+        while (slotCount < mFiles.size() * 2)
+        {
+            slotCount <<= 1;
+        }
+
+        std::vector<GameDataBundleFile> directory(slotCount, GameDataBundleFile{ 0, 0, { 0, 0 }, 0, 0 });
+        for (const auto& file: mFiles)
+        {
+            auto slot = static_cast<uint32_t>(file.mPathHash) & (slotCount - 1);
+            while (directory[slot].mPathHash != 0)
+            {
+                slot = (slot + 1) & (slotCount - 1);
+            }
+            directory[slot] = file;
+        }
+
+        GameDataBundleHeader header;
+        header.mMagic = GAME_DATA_BUNDLE_MAGIC;
+        header.mVersion = GAME_DATA_BUNDLE_VERSION;
+        header.mSchemaHash = GetSchemaHash();
+        header.mFileSlotCount = slotCount;
+        header.mNodeCount = static_cast<uint32_t>(mNodes.size());
+        header.mAttributeCount = static_cast<uint32_t>(mAttributes.size());
+        header.mStringSectionSize = static_cast<uint32_t>(mStrings.size());
+
+        bundleFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        bundleFile.write(reinterpret_cast<const char*>(directory.data()), directory.size() * sizeof(GameDataBundleFile));
+        bundleFile.write(reinterpret_cast<const char*>(mNodes.data()), mNodes.size() * sizeof(GameDataBundleNode));
+        bundleFile.write(reinterpret_cast<const char*>(mAttributes.data()), mAttributes.size() * sizeof(GameDataBundleAttribute));
+        bundleFile.write(mStrings.data(), mStrings.size());
+
+        return static_cast<bool>(bundleFile);
+    }
+
+private:
+    std::vector<GameDataBundleFile> mFiles;
+    std::vector<GameDataBundleNode> mNodes;
+    std::vector<GameDataBundleAttribute> mAttributes;
+    std::vector<char> mStrings;
+    std::unordered_map<std::string, uint32_t> mStringOffsets;
+};
+
+///------------------------------------------------------------------------------------------------
+
+static void ValidateNodeTree(const std::string& relativeFilePath, const rapidxml::xml_node<>* node, std::vector<std::string>& outErrors)
+{
+    std::unordered_set<std::string> attributeNames;
+    for (auto* attribute = node->first_attribute(); attribute; attribute = attribute->next_attribute())
+    {
+        if (!attributeNames.insert(attribute->name()).second)
+        {
+            outErrors.push_back(relativeFilePath + ": attribute '" + attribute->name() + "' repeated on element <" + node->name() + ">");
+        }
+    }
+
+    for (auto* childNode = node->first_node(); childNode; childNode = childNode->next_sibling())
+    {
+        if (childNode->type() == rapidxml::node_element)
+        {
+            ValidateNodeTree(relativeFilePath, childNode, outErrors);
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool CompileGameDataBundle(const std::string& bundlePath, const std::string& dataRootDirectory, const std::vector<std::string>& relativeFilePaths, std::vector<std::string>& outErrors)
+{
+    BundleWriter writer;
+
+    for (const auto& relativeFilePath: relativeFilePaths)
+    {
+        std::ifstream xmlFile(dataRootDirectory + relativeFilePath, std::ios::binary);
+        if (!xmlFile)
+        {
+            outErrors.push_back(relativeFilePath + ": could not be opened");
+            continue;
+        }
+
+        std::vector<char> xmlContents((std::istreambuf_iterator<char>(xmlFile)), std::istreambuf_iterator<char>());
+        const auto sourceHash = resources::asset_archive::HashPath(std::string_view(xmlContents.data(), xmlContents.size()));
+        xmlContents.push_back('\0');
+
+        // Same parse flags as BaseGameDataLoader
+        rapidxml::xml_document<> doc;
+        try
+        {
+            doc.parse<0>(xmlContents.data());
+        }
+        catch (const rapidxml::parse_error& e)
+        {
+            outErrors.push_back(relativeFilePath + ": " + e.what() + " (at byte " + std::to_string(e.where<char>() - xmlContents.data()) + ")");
+            continue;
+        }
+
+        auto* rootNode = doc.first_node();
+        if (!rootNode || rootNode->type() != rapidxml::node_element)
+        {
+            outErrors.push_back(relativeFilePath + ": no root element");
+            continue;
+        }
+
+        const auto errorCount = outErrors.size();
+        ValidateNodeTree(relativeFilePath, rootNode, outErrors);
+
+        if (outErrors.size() == errorCount)
+        {
+            writer.AddFile(relativeFilePath, sourceHash, rootNode);
+        }
+    }
+
+    if (!outErrors.empty())
+    {
+        return false;
+    }
+
+    if (!writer.Write(bundlePath))
+    {
+        outErrors.push_back(bundlePath + ": could not be written");
+        return false;
+    }
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
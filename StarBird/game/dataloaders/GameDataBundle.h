@@ -0,0 +1,165 @@
+///------------------------------------------------------------------------------------------------
+///  GameDataBundle.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef GameDataBundle_h
+#define GameDataBundle_h
+
+///------------------------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <memory>
+#include <rapidxml/rapidxml.hpp>
+#include <string>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+namespace resources { class ResourceFile; }
+
+///------------------------------------------------------------------------------------------------
+
+/// Offset & length (excluding the NUL terminator) of a string in the bundle's string section.
+struct GameDataBundleString
+{
+    uint32_t mOffset;
+    uint32_t mLength;
+};
+
+struct GameDataBundleHeader
+{
+    uint32_t mMagic;
+    uint32_t mVersion;
+    uint64_t mSchemaHash;
+    uint32_t mFileSlotCount;
+    uint32_t mNodeCount;
+    uint32_t mAttributeCount;
+    uint32_t mStringSectionSize;
+};
+
+/// Single slot of the bundle's file directory. Like the asset archive's, the directory is an
+/// open addressing hash table (linear probing, power of two slot count) keyed by the hash of
+/// each file's path. Empty slots have a path hash of 0.
+struct GameDataBundleFile
+{
+    uint64_t mPathHash;
+    uint64_t mSourceHash;
+    GameDataBundleString mPath;
+    uint32_t mFirstNode;
+    uint32_t mNodeCount;
+};
+
+/// A single element of a data file. The nodes of each file are stored in pre-order,
+/// so parents always precede their children.
+struct GameDataBundleNode
+{
+    GameDataBundleString mName;
+    GameDataBundleString mValue;
+    uint32_t mParentIndex;
+    uint32_t mFirstAttribute;
+    uint32_t mAttributeCount;
+};
+
+struct GameDataBundleAttribute
+{
+    GameDataBundleString mName;
+    GameDataBundleString mValue;
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// All XML game data files, validated and pre-parsed offline by the DataCompiler tool
+/// in to a single binary bundle. Instead of reading, copying and parsing a data file,
+/// loaders get a rapidxml tree that is stitched together straight from the bundle's
+/// records, with all names and values pointing in to the (memory mapped) bundle itself.
+class GameDataBundle final
+{
+public:
+    /// The default method of getting a hold of this singleton.
+    /// @returns a reference to the single instance of this class.
+    static GameDataBundle& GetInstance();
+
+    ~GameDataBundle();
+    GameDataBundle(const GameDataBundle&) = delete;
+    GameDataBundle(GameDataBundle&&) = delete;
+    const GameDataBundle& operator = (const GameDataBundle&) = delete;
+    GameDataBundle& operator = (GameDataBundle&&) = delete;
+
+    /// Mounts the bundle found at the given path, served from the asset archive if packed in there.
+    /// @param[in] bundlePath the path to the bundle.
+    /// @param[out] outError description of the failure, if any.
+    /// @returns whether the bundle was found, was valid for this build's schema, and all of its records were in bounds.
+    bool Mount(const std::string& bundlePath, std::string& outError);
+    void Unmount();
+    bool IsMounted() const;
+
+    /// While hot reloading is enabled the bundle is bypassed, so that every data file
+    /// is (re)loaded from its XML source.
+    void SetHotReloadEnabled(const bool hotReloadEnabled);
+    bool IsHotReloadEnabled() const;
+
+    /// Builds the element tree of a bundled data file. Entries compiled from a different version
+    /// of the XML source than the one shipped next to the bundle are stale, and are treated as missing.
+    /// Staleness is checked on mount, and again whenever hot reloading gets disabled.
+    /// @param[in] relativeFilePath the path of the XML data file, relative to the data root (e.g. enemies/enemy_bullet.xml).
+    /// @param[out] outDocument the document to append the tree to. It must not outlive the bundle's mount.
+    /// @returns whether an up to date entry for the file was found in the bundle (and hot reloading is disabled).
+    bool BuildDocument(const std::string& relativeFilePath, rapidxml::xml_document<>& outDocument) const;
+
+private:
+    GameDataBundle() = default;
+    
+    void RefreshStaleFiles();
+    const GameDataBundleFile* FindFile(const std::string& relativeFilePath) const;
+
+private:
+    std::unique_ptr<resources::ResourceFile> mBundleFile;
+    const GameDataBundleHeader* mHeader = nullptr;
+    const GameDataBundleFile* mFiles = nullptr;
+    const GameDataBundleNode* mNodes = nullptr;
+    const GameDataBundleAttribute* mAttributes = nullptr;
+    const char* mStrings = nullptr;
+    std::string mDataRootDirectory;
+    std::vector<bool> mStaleFiles;
+    bool mHotReloadEnabled = false;
+};
+
+///------------------------------------------------------------------------------------------------
+
+namespace game_data_bundle
+{
+
+///------------------------------------------------------------------------------------------------
+
+inline const std::string GAME_DATA_BUNDLE_FILE_NAME = "game_data.bin";
+inline const uint32_t GAME_DATA_BUNDLE_MAGIC = 0x42444253; // "SBDB"
+inline const uint32_t GAME_DATA_BUNDLE_VERSION = 2;
+inline const uint32_t NO_PARENT_NODE = 0xFFFFFFFF;
+
+///------------------------------------------------------------------------------------------------
+/// Hash of the layout of all bundle records. Bundles built against a different
+/// layout than the running game's are rejected rather than misread.
+/// @returns the schema hash.
+uint64_t GetSchemaHash();
+
+///------------------------------------------------------------------------------------------------
+/// Validates the given XML data files and compiles them in to a new bundle. Each file has to be
+/// well formed, have a root element, and not repeat an attribute on the same element (loaders
+/// only ever see the first one).
+/// @param[in] bundlePath the path to write the bundle to.
+/// @param[in] dataRootDirectory the directory the given file paths are relative to.
+/// @param[in] relativeFilePaths the paths of the XML data files to compile.
+/// @param[out] outErrors descriptions of every validation failure found, if any.
+/// @returns whether all files were valid and the bundle was written successfully.
+bool CompileGameDataBundle(const std::string& bundlePath, const std::string& dataRootDirectory, const std::vector<std::string>& relativeFilePaths, std::vector<std::string>& outErrors);
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* GameDataBundle_h */
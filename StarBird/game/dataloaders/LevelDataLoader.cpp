@@ -29,7 +29,7 @@ LevelDataLoader::LevelDataLoader()
         auto* lenseHeight = node->first_attribute("lenseHeight");
         if (lenseHeight)
         {
-            camera.mLenseHeight = std::stof(lenseHeight->value());
+            camera.mLenseHeight = strutils::StringToFloat(lenseHeight->value());
         }
         
         mConstructedLevel.mCameras.push_back(camera);
@@ -47,17 +47,17 @@ LevelDataLoader::LevelDataLoader()
         
         if (node->first_attribute("bossHealth"))
         {
-            mConstructedLevel.mWaves.back().mBossHealth = std::stof(node->first_attribute("bossHealth")->value());
+            mConstructedLevel.mWaves.back().mBossHealth = strutils::StringToFloat(node->first_attribute("bossHealth")->value());
         }
         
         if (node->first_attribute("blockIndex"))
         {
-            mConstructedLevel.mWaves.back().mDebugBlockIndex = std::stoi(node->first_attribute("blockIndex")->value());
+            mConstructedLevel.mWaves.back().mDebugBlockIndex = strutils::StringToInt(node->first_attribute("blockIndex")->value());
         }
         
         if (node->first_attribute("difficulty"))
         {
-            mConstructedLevel.mWaves.back().mDebugDifficultyValue = std::stoi(node->first_attribute("difficulty")->value());
+            mConstructedLevel.mWaves.back().mDebugDifficultyValue = strutils::StringToInt(node->first_attribute("difficulty")->value());
         }
     });
     
@@ -70,9 +70,10 @@ LevelDataLoader::LevelDataLoader()
         auto* position = node->first_attribute("position");
         if (position)
         {
-            auto positionComponents = strutils::StringSplit(std::string(position->value()), ',');
-            enemy.mPosition.x = std::stof(positionComponents[0]);
-            enemy.mPosition.y = std::stof(positionComponents[1]);
+            std::array<std::string_view, 2> positionComponents;
+            strutils::StringSplitView(position->value(), ',', positionComponents);
+            enemy.mPosition.x = strutils::StringToFloat(positionComponents[0]);
+            enemy.mPosition.y = strutils::StringToFloat(positionComponents[1]);
         }
         
         auto* enemyType = node->first_attribute("type");
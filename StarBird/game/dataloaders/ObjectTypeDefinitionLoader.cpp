@@ -81,14 +81,15 @@ glm::vec3 LoadScale(const rapidxml::xml_node<>* node)
     auto* scale = node->first_attribute("scale");
     if (scale)
     {
-        auto scaleComponents = strutils::StringSplit(std::string(scale->value()), ',');
-        if (scaleComponents.size() == 1)
+        std::array<std::string_view, 2> scaleComponents;
+        const auto scaleComponentCount = strutils::StringSplitView(scale->value(), ',', scaleComponents);
+        if (scaleComponentCount == 1)
         {
-            return glm::vec3(std::stof(scaleComponents[0]), std::stof(scaleComponents[0]), 1.0f);
+            return glm::vec3(strutils::StringToFloat(scaleComponents[0]), strutils::StringToFloat(scaleComponents[0]), 1.0f);
         }
         else
         {
-            return glm::vec3(std::stof(scaleComponents[0]), std::stof(scaleComponents[1]), 1.0f);
+            return glm::vec3(strutils::StringToFloat(scaleComponents[0]), strutils::StringToFloat(scaleComponents[1]), 1.0f);
         }
     }
     else
@@ -108,59 +109,62 @@ ObjectTypeDefinitionLoader::ObjectTypeDefinitionLoader()
         auto* bodyScale = node->first_attribute("bodyScale");
         if (bodyScale)
         {
-            auto bodyScaleComponents = strutils::StringSplit(std::string(bodyScale->value()), ',');
-            if (bodyScaleComponents.size() == 1)
+            std::array<std::string_view, 2> bodyScaleComponents;
+            const auto bodyScaleComponentCount = strutils::StringSplitView(bodyScale->value(), ',', bodyScaleComponents);
+            if (bodyScaleComponentCount == 1)
             {
-                mConstructedObjectTypeDef.mBodyCustomScale.x = std::stof(bodyScaleComponents[0]);
-                mConstructedObjectTypeDef.mBodyCustomScale.y = std::stof(bodyScaleComponents[0]);
+                mConstructedObjectTypeDef.mBodyCustomScale.x = strutils::StringToFloat(bodyScaleComponents[0]);
+                mConstructedObjectTypeDef.mBodyCustomScale.y = strutils::StringToFloat(bodyScaleComponents[0]);
             }
             else
             {
-                mConstructedObjectTypeDef.mBodyCustomScale.x = std::stof(bodyScaleComponents[0]);
-                mConstructedObjectTypeDef.mBodyCustomScale.y = std::stof(bodyScaleComponents[1]);
+                mConstructedObjectTypeDef.mBodyCustomScale.x = strutils::StringToFloat(bodyScaleComponents[0]);
+                mConstructedObjectTypeDef.mBodyCustomScale.y = strutils::StringToFloat(bodyScaleComponents[1]);
             }
         }
         
         auto* bodyOffset = node->first_attribute("bodyOffset");
         if (bodyOffset)
         {
-            auto bodyOffsetComponents = strutils::StringSplit(std::string(bodyOffset->value()), ',');
-            if (bodyOffsetComponents.size() == 1)
+            std::array<std::string_view, 2> bodyOffsetComponents;
+            const auto bodyOffsetComponentCount = strutils::StringSplitView(bodyOffset->value(), ',', bodyOffsetComponents);
+            if (bodyOffsetComponentCount == 1)
             {
-                mConstructedObjectTypeDef.mBodyCustomOffset.x = std::stof(bodyOffsetComponents[0]);
-                mConstructedObjectTypeDef.mBodyCustomOffset.y = std::stof(bodyOffsetComponents[0]);
+                mConstructedObjectTypeDef.mBodyCustomOffset.x = strutils::StringToFloat(bodyOffsetComponents[0]);
+                mConstructedObjectTypeDef.mBodyCustomOffset.y = strutils::StringToFloat(bodyOffsetComponents[0]);
             }
             else
             {
-                mConstructedObjectTypeDef.mBodyCustomOffset.x = std::stof(bodyOffsetComponents[0]);
-                mConstructedObjectTypeDef.mBodyCustomOffset.y = std::stof(bodyOffsetComponents[1]);
+                mConstructedObjectTypeDef.mBodyCustomOffset.x = strutils::StringToFloat(bodyOffsetComponents[0]);
+                mConstructedObjectTypeDef.mBodyCustomOffset.y = strutils::StringToFloat(bodyOffsetComponents[1]);
             }
         }
         
         auto* linearDamping = node->first_attribute("linearDamping");
         if (linearDamping)
         {
-            mConstructedObjectTypeDef.mLinearDamping = std::stof(linearDamping->value());
+            mConstructedObjectTypeDef.mLinearDamping = strutils::StringToFloat(linearDamping->value());
         }
         
         auto* density = node->first_attribute("density");
         if (density)
         {
-            mConstructedObjectTypeDef.mDensity = std::stof(density->value());
+            mConstructedObjectTypeDef.mDensity = strutils::StringToFloat(density->value());
         }
         
         auto* linearSpeed = node->first_attribute("speed");
         if (linearSpeed)
         {
-            mConstructedObjectTypeDef.mSpeed = std::stof(linearSpeed->value());
+            mConstructedObjectTypeDef.mSpeed = strutils::StringToFloat(linearSpeed->value());
         }
         
         auto* constantLinearVelocity = node->first_attribute("constantVelocity");
         if (constantLinearVelocity)
         {
-            auto constantLinearVelocityComponents = strutils::StringSplit(std::string(constantLinearVelocity->value()), ',');
-            mConstructedObjectTypeDef.mConstantLinearVelocity.x = std::stof(constantLinearVelocityComponents[0]);
-            mConstructedObjectTypeDef.mConstantLinearVelocity.y = std::stof(constantLinearVelocityComponents[1]);
+            std::array<std::string_view, 2> constantLinearVelocityComponents;
+            strutils::StringSplitView(constantLinearVelocity->value(), ',', constantLinearVelocityComponents);
+            mConstructedObjectTypeDef.mConstantLinearVelocity.x = strutils::StringToFloat(constantLinearVelocityComponents[0]);
+            mConstructedObjectTypeDef.mConstantLinearVelocity.y = strutils::StringToFloat(constantLinearVelocityComponents[1]);
         }
 
         auto* category = node->first_attribute("category");
@@ -214,22 +218,24 @@ ObjectTypeDefinitionLoader::ObjectTypeDefinitionLoader()
         auto* textureText = node->first_attribute("texture");
         if (textureText)
         {
-            std::string textureName(textureText->value());
-            if (textureName.back() == '}')
+            std::string_view textureName(textureText->value(), textureText->value_size());
+            if (!textureName.empty() && textureName.back() == '}')
             {
-                auto textureNameSplitByLBrace = strutils::StringSplit(textureName, '{');
+                std::array<std::string_view, 2> textureNameSplitByLBrace;
+                strutils::StringSplitView(textureName, '{', textureNameSplitByLBrace);
                 auto textureRangeStr = textureNameSplitByLBrace[1];
-                textureRangeStr.pop_back();
+                textureRangeStr.remove_suffix(1);
                 
-                auto rangeComponents = strutils::StringSplit(textureRangeStr, ':');
-                auto minTextureNumber = std::stoi(rangeComponents[0]);
-                auto maxTextureNumber = std::stoi(rangeComponents[1]);
+                std::array<std::string_view, 2> rangeComponents;
+                strutils::StringSplitView(textureRangeStr, ':', rangeComponents);
+                auto minTextureNumber = strutils::StringToInt(rangeComponents[0]);
+                auto maxTextureNumber = strutils::StringToInt(rangeComponents[1]);
                 
                 std::vector<resources::ResourceId> potentialTextureResourceIds;
                 
                 for (int i = minTextureNumber; i <= maxTextureNumber; ++i)
                 {
-                    potentialTextureResourceIds.push_back(resources::ResourceLoadingService::GetInstance().LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + textureNameSplitByLBrace[0] + std::to_string(i) + ".bmp"));
+                    potentialTextureResourceIds.push_back(resources::ResourceLoadingService::GetInstance().LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + std::string(textureNameSplitByLBrace[0]) + std::to_string(i) + ".bmp"));
                 }
                 
                 animation = new VariableTexturedAnimation(potentialTextureResourceIds, LoadMesh(node), LoadShader(node), LoadScale(node), LoadBodyRenderingEnabled(node));
@@ -240,13 +246,13 @@ ObjectTypeDefinitionLoader::ObjectTypeDefinitionLoader()
         auto* textureSheetRowText = node->first_attribute("textureSheetRow");
         if (textureSheetRowText)
         {
-            int textureSheetRow = std::stoi(textureSheetRowText->value());
+            int textureSheetRow = strutils::StringToInt(textureSheetRowText->value());
             float duration = 0.0f;
             
             auto* durationText = node->first_attribute("duration");
             if (durationText)
             {
-                duration = std::stof(durationText->value());
+                duration = strutils::StringToFloat(durationText->value());
             }
             
             animation = new MultiFrameAnimation(LoadTexture(node), LoadMesh(node), LoadShader(node), LoadScale(node), duration, textureSheetRow, LoadBodyRenderingEnabled(node));
@@ -262,7 +268,7 @@ ObjectTypeDefinitionLoader::ObjectTypeDefinitionLoader()
             auto* dissolveSpeedText = node->first_attribute("dissolveSpeed");
             if (dissolveSpeedText)
             {
-                dissolveSpeed = std::stof(dissolveSpeedText->value());
+                dissolveSpeed = strutils::StringToFloat(dissolveSpeedText->value());
             }
             
             animation = new DissolveAnimation(nullptr, LoadTexture(node), dissolveTextureResourceId, LoadMesh(node), LoadShader(node), LoadScale(node), dissolveSpeed, LoadBodyRenderingEnabled(node));
@@ -294,8 +300,8 @@ ObjectTypeDefinitionLoader::ObjectTypeDefinitionLoader()
                 rotationAxisEnumValue = RotationAnimation::RotationAxis::Y;
             }
             
-            auto rotationDegrees = std::stof(node->first_attribute("rotationDegrees")->value());
-            auto rotationSpeed = std::stof(node->first_attribute("rotationSpeed")->value());
+            auto rotationDegrees = strutils::StringToFloat(node->first_attribute("rotationDegrees")->value());
+            auto rotationSpeed = strutils::StringToFloat(node->first_attribute("rotationSpeed")->value());
             
             animation = new RotationAnimation(LoadTexture(node), LoadMesh(node), LoadShader(node), LoadScale(node), rotationModeEnumValue, rotationAxisEnumValue, rotationDegrees, rotationSpeed, LoadBodyRenderingEnabled(node));
         }
@@ -341,19 +347,19 @@ ObjectTypeDefinitionLoader::ObjectTypeDefinitionLoader()
         auto* health = node->first_attribute("health");
         if (health)
         {
-            mConstructedObjectTypeDef.mHealth = std::stof(health->value());
+            mConstructedObjectTypeDef.mHealth = strutils::StringToFloat(health->value());
         }
         
         auto* damage = node->first_attribute("damage");
         if (damage)
         {
-            mConstructedObjectTypeDef.mDamage = std::stof(damage->value());
+            mConstructedObjectTypeDef.mDamage = strutils::StringToFloat(damage->value());
         }
         
         auto* shootingFrequency = node->first_attribute("shootingFrequency");
         if (shootingFrequency)
         {
-            mConstructedObjectTypeDef.mShootingFrequencyMillis = std::stof(shootingFrequency->value());
+            mConstructedObjectTypeDef.mShootingFrequencyMillis = strutils::StringToFloat(shootingFrequency->value());
         }
         
         auto* projectile = node->first_attribute("projectile");
@@ -366,7 +372,7 @@ ObjectTypeDefinitionLoader::ObjectTypeDefinitionLoader()
         auto* crystalYield = node->first_attribute("crystalYield");
         if (crystalYield)
         {
-            mConstructedObjectTypeDef.mCrystalYield = std::stof(crystalYield->value());
+            mConstructedObjectTypeDef.mCrystalYield = strutils::StringToFloat(crystalYield->value());
         }
     });
 }
@@ -59,7 +59,7 @@ UpgradesLoader::UpgradesLoader()
         auto* unlockCost = node->first_attribute("unlockCost");
         if (unlockCost)
         {
-            upgrade.mDefaultUnlockCost = std::stoi(unlockCost->value());
+            upgrade.mDefaultUnlockCost = strutils::StringToInt(unlockCost->value());
             upgrade.mCrystalUnlockProgress = 0;
         }
         
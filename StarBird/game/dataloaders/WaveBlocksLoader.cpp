@@ -26,12 +26,17 @@ WaveBlocksLoader::WaveBlocksLoader()
         
         if (node->first_attribute("bossHealth"))
         {
-            mWaveBlocks.back().mBossHealth = std::stof(node->first_attribute("bossHealth")->value());
+            mWaveBlocks.back().mBossHealth = strutils::StringToFloat(node->first_attribute("bossHealth")->value());
         }
         
         if (node->first_attribute("difficulty"))
         {
-            mWaveBlocks.back().mDifficulty = std::stoi(node->first_attribute("difficulty")->value());
+            mWaveBlocks.back().mDifficulty = strutils::StringToInt(node->first_attribute("difficulty")->value());
+        }
+        
+        if (node->first_attribute("weight"))
+        {
+            mWaveBlocks.back().mWeight = strutils::StringToFloat(node->first_attribute("weight")->value());
         }
         
         if (node->first_attribute("inflexible"))
@@ -59,9 +64,10 @@ WaveBlocksLoader::WaveBlocksLoader()
         auto* position = node->first_attribute("position");
         if (position)
         {
-            auto positionComponents = strutils::StringSplit(std::string(position->value()), ',');
-            enemy.mPosition.x = std::stof(positionComponents[0]);
-            enemy.mPosition.y = std::stof(positionComponents[1]);
+            std::array<std::string_view, 2> positionComponents;
+            strutils::StringSplitView(position->value(), ',', positionComponents);
+            enemy.mPosition.x = strutils::StringToFloat(positionComponents[0]);
+            enemy.mPosition.y = strutils::StringToFloat(positionComponents[1]);
         }
         
         auto* enemyType = node->first_attribute("type");
@@ -78,6 +84,7 @@ WaveBlocksLoader::WaveBlocksLoader()
 
 std::vector<WaveBlockDefinition>& WaveBlocksLoader::LoadAllWaveBlocks()
 {
+    mWaveBlocks.clear();
     BaseGameDataLoader::LoadData("wave_blocks");
     
     return mWaveBlocks;
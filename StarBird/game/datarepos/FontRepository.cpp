@@ -6,6 +6,7 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "FontRepository.h"
+#include "../dataloaders/GameDataBundle.h"
 #include "../../utils/OSMessageBox.h"
 
 ///------------------------------------------------------------------------------------------------
@@ -20,10 +21,13 @@ FontRepository& FontRepository::GetInstance()
 
 std::optional<std::reference_wrapper<const FontDefinition>> FontRepository::GetFont(const strutils::StringId& fontName) const
 {
-    auto findIter = mFontMap.find(fontName);
-    if (findIter != mFontMap.end())
     {
-        return std::optional<std::reference_wrapper<const FontDefinition>>{findIter->second};
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto findIter = mFontMap.find(fontName);
+        if (findIter != mFontMap.end())
+        {
+            return std::optional<std::reference_wrapper<const FontDefinition>>{findIter->second};
+        }
     }
     
     ospopups::ShowMessageBox(ospopups::MessageBoxType::ERROR, "Cannot find font", fontName.GetString().c_str());
@@ -34,7 +38,18 @@ std::optional<std::reference_wrapper<const FontDefinition>> FontRepository::GetF
 
 void FontRepository::LoadFont(const strutils::StringId& fontName)
 {
-    mFontMap[fontName] = mLoader.LoadFont(fontName.GetString());
+    std::lock_guard<std::mutex> lock(mMutex);
+    
+    auto findIter = mFontMap.find(fontName);
+    if (findIter == mFontMap.end() || GameDataBundle::GetInstance().IsHotReloadEnabled())
+    {
+        mFontMap[fontName] = mLoader.LoadFont(fontName.GetString());
+    }
+    else
+    {
+        // Scene changes may have unloaded the font's texture since
+        resources::ResourceLoadingService::GetInstance().LoadResource(resources::ResourceLoadingService::RES_TEXTURES_ROOT + fontName.GetString() + ".bmp");
+    }
 }
 
 ///------------------------------------------------------------------------------------------------
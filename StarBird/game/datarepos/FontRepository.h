@@ -14,11 +14,14 @@
 #include "../dataloaders/FontLoader.h"
 #include "../../utils/StringUtils.h"
 
+#include <mutex>
 #include <optional>
 #include <unordered_map>
 
 ///------------------------------------------------------------------------------------------------
 
+/// Fonts are shared by all game instances in the process, and are loaded once. While game data
+/// hot reloading is enabled they are re-parsed (under the repository's lock) on every load instead.
 class FontRepository final
 {
 public:
@@ -37,6 +40,7 @@ private:
     FontRepository() = default;
     
 private:
+    mutable std::mutex mMutex;
     FontLoader mLoader;
     std::unordered_map<strutils::StringId, FontDefinition, strutils::StringIdHasher> mFontMap;
 };
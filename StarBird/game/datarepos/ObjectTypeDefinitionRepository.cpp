@@ -6,6 +6,7 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "ObjectTypeDefinitionRepository.h"
+#include "../dataloaders/GameDataBundle.h"
 #include "../../utils/OSMessageBox.h"
 
 ///------------------------------------------------------------------------------------------------
@@ -18,20 +19,9 @@ ObjectTypeDefinitionRepository& ObjectTypeDefinitionRepository::GetInstance()
 
 ///------------------------------------------------------------------------------------------------
 
-std::optional<std::reference_wrapper<ObjectTypeDefinition>> ObjectTypeDefinitionRepository::GetMutableObjectTypeDefinition(const strutils::StringId& objectTypeDefName)
-{
-    auto findIter = mObjectTypeDefinitionsMap.find(objectTypeDefName);
-    if (findIter != mObjectTypeDefinitionsMap.end())
-    {
-        return std::optional<std::reference_wrapper<ObjectTypeDefinition>>{findIter->second};
-    }
-    return std::nullopt;
-}
-
-///------------------------------------------------------------------------------------------------
-
 std::optional<std::reference_wrapper<const ObjectTypeDefinition>> ObjectTypeDefinitionRepository::GetObjectTypeDefinition(const strutils::StringId& objectTypeDefName) const
 {
+    std::lock_guard<std::mutex> lock(mMutex);
     auto findIter = mObjectTypeDefinitionsMap.find(objectTypeDefName);
     if (findIter != mObjectTypeDefinitionsMap.end())
     {
@@ -46,7 +36,31 @@ std::optional<std::reference_wrapper<const ObjectTypeDefinition>> ObjectTypeDefi
 void ObjectTypeDefinitionRepository::LoadObjectTypeDefinition(const strutils::StringId& objectTypeDefName)
 {
     std::unordered_set<strutils::StringId, strutils::StringIdHasher> subObjectsFound;
-    mObjectTypeDefinitionsMap[objectTypeDefName] = mLoader.LoadObjectTypeDefinition(objectTypeDefName.GetString(), &subObjectsFound);
+    
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto findIter = mObjectTypeDefinitionsMap.find(objectTypeDefName);
+        if (findIter == mObjectTypeDefinitionsMap.end())
+        {
+            mObjectTypeDefinitionsMap[objectTypeDefName] = mLoader.LoadObjectTypeDefinition(objectTypeDefName.GetString(), &subObjectsFound);
+        }
+        else if (GameDataBundle::GetInstance().IsHotReloadEnabled())
+        {
+            // Re-parse the edited XML and swap the contents of the existing entry, so that
+            // references already handed out see the new definition. Scene objects only ever
+            // hold clones of the animations, so the old ones can go.
+            for (auto& animation: findIter->second.mAnimations)
+            {
+                delete animation.second;
+            }
+            
+            findIter->second = mLoader.LoadObjectTypeDefinition(objectTypeDefName.GetString(), &subObjectsFound);
+        }
+        else
+        {
+            return;
+        }
+    }
     
     for (const auto& subObjectTypeDefName: subObjectsFound)
     {
@@ -14,11 +14,17 @@
 #include "../definitions/ObjectTypeDefinition.h"
 #include "../../utils/StringUtils.h"
 
+#include <mutex>
 #include <optional>
 #include <unordered_map>
 
 ///------------------------------------------------------------------------------------------------
 
+/// Object type definitions are shared by all game instances in the process. Each one is loaded
+/// the first time it is asked for and never moves after that, so references handed out stay
+/// valid for the lifetime of the process. Definitions only change when loaded again while game
+/// data hot reloading is enabled (a debug console feature of the single interactive instance),
+/// in which case the entry is re-parsed and swapped in place under the repository's lock.
 class ObjectTypeDefinitionRepository final
 {
 public:
@@ -29,7 +35,6 @@ public:
     const ObjectTypeDefinitionRepository& operator = (const ObjectTypeDefinitionRepository&) = delete;
     ObjectTypeDefinitionRepository& operator = (ObjectTypeDefinitionRepository&&) = delete;
     
-    std::optional<std::reference_wrapper<ObjectTypeDefinition>> GetMutableObjectTypeDefinition(const strutils::StringId& objectTypeDefName);
     std::optional<std::reference_wrapper<const ObjectTypeDefinition>> GetObjectTypeDefinition(const strutils::StringId& objectTypeDefName) const;
     void LoadObjectTypeDefinition(const strutils::StringId& objectTypeDefName);
     
@@ -38,6 +43,7 @@ private:
     ~ObjectTypeDefinitionRepository();
     
 private:
+    mutable std::mutex mMutex;
     ObjectTypeDefinitionLoader mLoader;
     std::unordered_map<strutils::StringId, ObjectTypeDefinition, strutils::StringIdHasher> mObjectTypeDefinitionsMap;
 };
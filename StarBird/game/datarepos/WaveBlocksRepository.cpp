@@ -8,6 +8,75 @@
 #include "WaveBlocksRepository.h"
 #include "../../utils/OSMessageBox.h"
 
+#include <algorithm>
+#include <numeric>
+
+///------------------------------------------------------------------------------------------------
+
+static const EligibleWaveBlocks NO_ELIGIBLE_WAVE_BLOCKS = {};
+static const WaveBlockDefinition EMPTY_WAVE_BLOCK = {};
+
+///------------------------------------------------------------------------------------------------
+
+static void CreateAliasTable(const std::vector<WaveBlockDefinition>& waveBlocks, EligibleWaveBlocks& eligibleWaveBlocks)
+{
+    const auto blockCount = eligibleWaveBlocks.mWaveBlockIndices.size();
+    
+    auto weightSum = 0.0;
+    for (const auto waveBlockIndex: eligibleWaveBlocks.mWaveBlockIndices)
+    {
+        weightSum += waveBlocks[waveBlockIndex].mWeight;
+    }
+    
+    // Until proven otherwise, each column only ever yields its own block
+    eligibleWaveBlocks.mAliasProbabilities.assign(blockCount, 1.0f);
+    eligibleWaveBlocks.mAliases.resize(blockCount);
+    std::iota(eligibleWaveBlocks.mAliases.begin(), eligibleWaveBlocks.mAliases.end(), 0);
+    
+    if (weightSum <= 0.0)
+    {
+        return;
+    }
+    
+    std::vector<double> scaledProbabilities(blockCount);
+    std::vector<size_t> smallBlocks, largeBlocks;
+    for (size_t i = 0; i < blockCount; ++i)
+    {
+        scaledProbabilities[i] = waveBlocks[eligibleWaveBlocks.mWaveBlockIndices[i]].mWeight * blockCount / weightSum;
+        (scaledProbabilities[i] < 1.0 ? smallBlocks : largeBlocks).push_back(i);
+    }
+    
+    while (!smallBlocks.empty() && !largeBlocks.empty())
+    {
+        const auto smallBlock = smallBlocks.back(); smallBlocks.pop_back();
+        const auto largeBlock = largeBlocks.back(); largeBlocks.pop_back();
+        
+        eligibleWaveBlocks.mAliasProbabilities[smallBlock] = static_cast<float>(scaledProbabilities[smallBlock]);
+        eligibleWaveBlocks.mAliases[smallBlock] = largeBlock;
+        
+        scaledProbabilities[largeBlock] -= 1.0 - scaledProbabilities[smallBlock];
+        (scaledProbabilities[largeBlock] < 1.0 ? smallBlocks : largeBlocks).push_back(largeBlock);
+    }
+    
+    // Whatever is left over (only due to rounding errors for small blocks) keeps a probability of 1
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t EligibleWaveBlocks::Sample(math::RandomStream& randomStream) const
+{
+    const auto column = static_cast<size_t>(randomStream.NextInt(0, static_cast<int>(mWaveBlockIndices.size()) - 1));
+    
+    // Columns that are never aliased (e.g. all of them when the weights are equal) don't need the
+    // second draw, which also keeps levels identical to those of plain uniform selection
+    if (mAliasProbabilities[column] >= 1.0f)
+    {
+        return column;
+    }
+    
+    return randomStream.NextFloat() < mAliasProbabilities[column] ? column : mAliases[column];
+}
+
 ///------------------------------------------------------------------------------------------------
 
 WaveBlocksRepository& WaveBlocksRepository::GetInstance()
@@ -18,30 +87,34 @@ WaveBlocksRepository& WaveBlocksRepository::GetInstance()
 
 ///------------------------------------------------------------------------------------------------
 
-std::vector<WaveBlockDefinition> WaveBlocksRepository::GetEligibleWaveBlocksForDifficulty(int difficultyValue) const
+const EligibleWaveBlocks& WaveBlocksRepository::GetEligibleWaveBlocksForDifficulty(const int difficultyValue) const
 {
-    std::vector<WaveBlockDefinition> result;
-    for (const auto& waveBlockDef: mWaveBlocks)
+    auto bucketIter = std::upper_bound(mDifficultyBucketThresholds.begin(), mDifficultyBucketThresholds.end(), difficultyValue);
+    if (bucketIter == mDifficultyBucketThresholds.begin())
     {
-        if (waveBlockDef.mDifficulty <= difficultyValue)
-        {
-            result.push_back(waveBlockDef);
-        }
+        return NO_ELIGIBLE_WAVE_BLOCKS;
     }
     
-    return result;
+    return mDifficultyBuckets[std::distance(mDifficultyBucketThresholds.begin(), bucketIter) - 1];
 }
 
 ///------------------------------------------------------------------------------------------------
 
-WaveBlockDefinition WaveBlocksRepository::GetBossWaveBlock(const strutils::StringId& bossName) const
+const WaveBlockDefinition& WaveBlocksRepository::GetWaveBlock(const size_t waveBlockIndex) const
+{
+    return mWaveBlocks.at(waveBlockIndex);
+}
+
+///------------------------------------------------------------------------------------------------
+
+const WaveBlockDefinition& WaveBlocksRepository::GetBossWaveBlock(const strutils::StringId& bossName) const
 {
     auto findIter = std::find_if(mWaveBlocks.begin(), mWaveBlocks.end(), [&](const WaveBlockDefinition& waveBlockDefinition)
     {
         return waveBlockDefinition.mBossName == bossName;
     });
     
-    return findIter != mWaveBlocks.end() ? *findIter : WaveBlockDefinition();
+    return findIter != mWaveBlocks.end() ? *findIter : EMPTY_WAVE_BLOCK;
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -49,6 +122,37 @@ WaveBlockDefinition WaveBlocksRepository::GetBossWaveBlock(const strutils::Strin
 void WaveBlocksRepository::LoadWaveBlocks()
 {
     mWaveBlocks = mLoader.LoadAllWaveBlocks();
+    CreateDifficultyIndex();
+}
+
+///------------------------------------------------------------------------------------------------
+
+void WaveBlocksRepository::CreateDifficultyIndex()
+{
+    mDifficultyBucketThresholds.clear();
+    mDifficultyBuckets.clear();
+    
+    for (const auto& waveBlockDef: mWaveBlocks)
+    {
+        mDifficultyBucketThresholds.push_back(waveBlockDef.mDifficulty);
+    }
+    
+    std::sort(mDifficultyBucketThresholds.begin(), mDifficultyBucketThresholds.end());
+    mDifficultyBucketThresholds.erase(std::unique(mDifficultyBucketThresholds.begin(), mDifficultyBucketThresholds.end()), mDifficultyBucketThresholds.end());
+    
+    for (const auto difficultyThreshold: mDifficultyBucketThresholds)
+    {
+        auto& bucket = mDifficultyBuckets.emplace_back();
+        for (size_t i = 0; i < mWaveBlocks.size(); ++i)
+        {
+            if (mWaveBlocks[i].mDifficulty <= difficultyThreshold)
+            {
+                bucket.mWaveBlockIndices.push_back(i);
+            }
+        }
+        
+        CreateAliasTable(mWaveBlocks, bucket);
+    }
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -19,6 +19,23 @@
 
 ///------------------------------------------------------------------------------------------------
 
+/// The wave blocks eligible for a difficulty value (i.e. all blocks of up to that difficulty),
+/// as indices in to the repository's wave blocks, in their load order. Comes with a (Vose) alias
+/// table over the blocks' weights so that picking one of them is O(1).
+struct EligibleWaveBlocks
+{
+    /// Picks one of the eligible blocks at random, respecting their weights.
+    /// @param[in] randomStream the stream to draw random numbers from.
+    /// @returns the position of the picked block in mWaveBlockIndices.
+    size_t Sample(math::RandomStream& randomStream) const;
+    
+    std::vector<size_t> mWaveBlockIndices;
+    std::vector<float> mAliasProbabilities;
+    std::vector<size_t> mAliases;
+};
+
+///------------------------------------------------------------------------------------------------
+
 class WaveBlocksRepository final
 {
 public:
@@ -29,17 +46,25 @@ public:
     const WaveBlocksRepository& operator = (const WaveBlocksRepository&) = delete;
     WaveBlocksRepository& operator = (WaveBlocksRepository&&) = delete;
     
-    std::vector<WaveBlockDefinition> GetEligibleWaveBlocksForDifficulty(int difficultyValue) const;
-    WaveBlockDefinition GetBossWaveBlock(const strutils::StringId& bossName) const;
+    const EligibleWaveBlocks& GetEligibleWaveBlocksForDifficulty(const int difficultyValue) const;
+    const WaveBlockDefinition& GetWaveBlock(const size_t waveBlockIndex) const;
+    const WaveBlockDefinition& GetBossWaveBlock(const strutils::StringId& bossName) const;
     
     void LoadWaveBlocks();
     
 private:
     WaveBlocksRepository() = default;
     
+    void CreateDifficultyIndex();
+    
 private:
     WaveBlocksLoader mLoader;
     std::vector<WaveBlockDefinition> mWaveBlocks;
+    
+    // Eligible blocks per distinct block difficulty (ascending). A difficulty value
+    // maps to the bucket of the largest block difficulty not exceeding it.
+    std::vector<int> mDifficultyBucketThresholds;
+    std::vector<EligibleWaveBlocks> mDifficultyBuckets;
 };
 
 ///------------------------------------------------------------------------------------------------
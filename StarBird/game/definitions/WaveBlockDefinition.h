@@ -37,6 +37,7 @@ struct WaveBlockDefinition
     std::vector<WaveBlockLine> mWaveBlockLines;
     strutils::StringId mBossName = strutils::StringId();
     float mBossHealth = 0.0f;
+    float mWeight = 1.0f;
     int mDifficulty = 0;
     bool mInflexible = true;
     bool mExtensible = false;
@@ -23,6 +23,8 @@ enum class PostStateUpdateDirective
 ///------------------------------------------------------------------------------------------------
 
 class Scene;
+class SnapshotReader;
+class SnapshotWriter;
 class LevelUpdater;
 class UpgradesLevelLogicHandler;
 class b2World;
@@ -39,10 +41,19 @@ public:
     {
     }
     
+    virtual ~BaseGameState() = default;
+    
     virtual void VInitialize() {}
     virtual PostStateUpdateDirective VUpdate(const float dtMillis) { return PostStateUpdateDirective::CONTINUE; }
     virtual void VDestroy() {}
     
+    /// Writes whatever the state needs to pick up where it left off when restored from a level snapshot.
+    /// @returns false if the state can't be captured at this point (e.g. mid way through a cutscene).
+    virtual bool VWriteSnapshot(SnapshotWriter&) const { return false; }
+    
+    /// Restores a state written by VWriteSnapshot, in place of VInitialize.
+    virtual void VReadSnapshot(SnapshotReader&) {}
+    
     bool IsComplete() const { return !mNextStateName.isEmpty(); }
     const strutils::StringId& GetNextStateName() const { return mNextStateName; }
     
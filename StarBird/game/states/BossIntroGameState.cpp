@@ -9,10 +9,11 @@
 #include "FightingWaveGameState.h"
 #include "SceneObjectUtils.h"
 #include "../Scene.h"
+#include "../LevelSnapshot.h"
 #include "../Sounds.h"
 #include "../LevelUpdater.h"
 #include "../GameConstants.h"
-#include "../GameSingletons.h"
+#include "../GameContext.h"
 #include "../datarepos/FontRepository.h"
 #include "../datarepos/ObjectTypeDefinitionRepository.h"
 #include "../../utils/ObjectiveCUtils.h"
@@ -86,13 +87,7 @@ void BossIntroGameState::VInitialize()
     
     mScene->AddSceneObject(std::move(healthBarTextSo));
     
-    mLevelUpdater->AddFlow(RepeatableFlow([&]()
-    {
-        mScene->RemoveAllSceneObjectsWithName(game_constants::BOSS_INTRO_TEXT_SCENE_OBJECT_NAME);
-        mSubState = SubState::BOSS_HEALTH_BAR_ANIMATION;
-        GameSingletons::SetBossCurrentHealth(1.0f);
-        GameSingletons::SetBossMaxHealth(mLevelUpdater->GetCurrentLevelDefinition().mWaves.at(mLevelUpdater->GetCurrentWaveNumber()).mBossHealth);
-    }, game_constants::BOSS_INTRO_DURATION_MILLIS, RepeatableFlow::RepeatPolicy::ONCE, game_constants::BOSS_INTRO_FLOW_NAME));
+    mLevelUpdater->AddFlow(CreateBossNameDisplayFlow(game_constants::BOSS_INTRO_DURATION_MILLIS));
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -130,10 +125,10 @@ PostStateUpdateDirective BossIntroGameState::VUpdate(const float dtMillis)
             mScene->GetSceneObject(game_constants::BOSS_HEALTH_BAR_FRAME_SCENE_OBJECT_NAME)->get().mInvisible = false;
             mScene->GetSceneObject(game_constants::BOSS_HEALTH_BAR_TEXT_SCENE_OBJECT_NAME)->get().mInvisible = false;
             
-            GameSingletons::SetBossCurrentHealth(GameSingletons::GetBossCurrentHealth() + (GameSingletons::GetBossMaxHealth()/100.0f) * game_constants::BOSS_INTRO_ANIMATED_HEALTH_SPEED * dtMillis);
-            if (GameSingletons::GetBossCurrentHealth() >= GameSingletons::GetBossMaxHealth())
+            mScene->GetGameContext().SetBossCurrentHealth(mScene->GetGameContext().GetBossCurrentHealth() + (mScene->GetGameContext().GetBossMaxHealth()/100.0f) * game_constants::BOSS_INTRO_ANIMATED_HEALTH_SPEED * dtMillis);
+            if (mScene->GetGameContext().GetBossCurrentHealth() >= mScene->GetGameContext().GetBossMaxHealth())
             {
-                GameSingletons::SetBossCurrentHealth(GameSingletons::GetBossMaxHealth());
+                mScene->GetGameContext().SetBossCurrentHealth(mScene->GetGameContext().GetBossMaxHealth());
                 Complete();
             }
         } break;
@@ -150,3 +145,57 @@ void BossIntroGameState::VDestroy()
 }
 
 ///------------------------------------------------------------------------------------------------
+
+bool BossIntroGameState::VWriteSnapshot(SnapshotWriter& writer) const
+{
+    // The boss intro's scene objects and the boss health are captured along with the rest of the level
+    writer.Write(mSubState);
+    
+    auto bossIntroFlowOpt = mLevelUpdater->GetFlow(game_constants::BOSS_INTRO_FLOW_NAME);
+    writer.Write(bossIntroFlowOpt.has_value());
+    if (bossIntroFlowOpt)
+    {
+        writer.Write(bossIntroFlowOpt->get().GetDuration());
+        writer.Write(bossIntroFlowOpt->get().GetTicksLeft());
+    }
+    
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void BossIntroGameState::VReadSnapshot(SnapshotReader& reader)
+{
+    mSubState = reader.Read<SubState>();
+    if (mSubState != SubState::BOSS_NAME_DISPLAY && mSubState != SubState::BOSS_HEALTH_BAR_ANIMATION)
+    {
+        reader.Invalidate();
+        return;
+    }
+    
+    if (reader.Read<bool>())
+    {
+        const auto durationMillis = reader.Read<float>();
+        const auto ticksLeft = reader.Read<float>();
+        mLevelUpdater->ResumeFlow(CreateBossNameDisplayFlow(durationMillis), ticksLeft);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+RepeatableFlow BossIntroGameState::CreateBossNameDisplayFlow(const float durationMillis)
+{
+    return RepeatableFlow([this](){ OnBossNameDisplayFinished(); }, durationMillis, RepeatableFlow::RepeatPolicy::ONCE, game_constants::BOSS_INTRO_FLOW_NAME);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void BossIntroGameState::OnBossNameDisplayFinished()
+{
+    mScene->RemoveAllSceneObjectsWithName(game_constants::BOSS_INTRO_TEXT_SCENE_OBJECT_NAME);
+    mSubState = SubState::BOSS_HEALTH_BAR_ANIMATION;
+    mScene->GetGameContext().SetBossCurrentHealth(1.0f);
+    mScene->GetGameContext().SetBossMaxHealth(mLevelUpdater->GetCurrentLevelDefinition().mWaves.at(mLevelUpdater->GetCurrentWaveNumber()).mBossHealth);
+}
+
+///------------------------------------------------------------------------------------------------
@@ -11,6 +11,9 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "BaseGameState.h"
+#include "../RepeatableFlow.h"
+
+#include <cstdint>
 
 ///------------------------------------------------------------------------------------------------
 
@@ -23,14 +26,19 @@ public:
     void VInitialize() override;
     PostStateUpdateDirective VUpdate(const float dtMillis) override;
     void VDestroy() override;
+    bool VWriteSnapshot(SnapshotWriter& writer) const override;
+    void VReadSnapshot(SnapshotReader& reader) override;
     
 private:
-    enum class SubState
+    enum class SubState : uint8_t
     {
         BOSS_NAME_DISPLAY,
         BOSS_HEALTH_BAR_ANIMATION
     };
     
+    RepeatableFlow CreateBossNameDisplayFlow(const float durationMillis);
+    void OnBossNameDisplayFinished();
+    
     SubState mSubState;
 };
 
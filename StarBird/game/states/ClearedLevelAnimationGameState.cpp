@@ -7,7 +7,7 @@
 
 #include "ClearedLevelAnimationGameState.h"
 #include "../GameConstants.h"
-#include "../GameSingletons.h"
+#include "../GameContext.h"
 #include "../LevelUpdater.h"
 #include "../PhysicsConstants.h"
 #include "../Scene.h"
@@ -33,11 +33,13 @@ PostStateUpdateDirective ClearedLevelAnimationGameState::VUpdate(const float dtM
         playerFilter.maskBits &= ~(physics_constants::BULLET_ONLY_WALL_CATEGORY_BIT);
         
         playerSo.mBody->GetFixtureList()[0].SetFilterData(playerFilter);
-        playerSo.mBody->SetLinearVelocity(b2Vec2(0.0f, game_constants::BASE_PLAYER_SPEED * GameSingletons::GetPlayerMovementSpeedStat() * dtMillis));
+        playerSo.mBody->SetLinearVelocity(b2Vec2(0.0f, game_constants::BASE_PLAYER_SPEED * mScene->GetGameContext().GetPlayerMovementSpeedStat() * dtMillis));
         
         if (playerSo.mBody->GetWorldCenter().y >= TRANSITION_Y_THRESHOLD)
         {
-            if (mLevelUpdater->GetCurrentLevelDefinition().mWaves.back().mBossName.isEmpty())
+            // Levels generated for a difficulty without any eligible wave blocks have no waves at all
+            const auto& levelWaves = mLevelUpdater->GetCurrentLevelDefinition().mWaves;
+            if (levelWaves.empty() || levelWaves.back().mBossName.isEmpty())
             {
                 mScene->ChangeScene(Scene::TransitionParameters(Scene::SceneType::MAP, "", true));
             }
@@ -53,3 +55,11 @@ PostStateUpdateDirective ClearedLevelAnimationGameState::VUpdate(const float dtM
 }
 
 ///------------------------------------------------------------------------------------------------
+
+bool ClearedLevelAnimationGameState::VWriteSnapshot(SnapshotWriter& /* writer */) const
+{
+    // Nothing to write, the animation is driven entirely off the player's body
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
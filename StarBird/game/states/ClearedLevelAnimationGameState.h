@@ -21,6 +21,7 @@ public:
     
 public:
     PostStateUpdateDirective VUpdate(const float dtMillis) override;
+    bool VWriteSnapshot(SnapshotWriter& writer) const override;
 };
 
 
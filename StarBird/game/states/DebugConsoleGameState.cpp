@@ -6,14 +6,23 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "DebugConsoleGameState.h"
+#include "../FlowScheduler.h"
+#include "../FrameWorkScheduler.h"
 #include "../GameConstants.h"
 #include "../GameSingletons.h"
+#include "../InputRecording.h"
+#include "../LevelGeneration.h"
 #include "../LevelUpdater.h"
+#include "../PersistenceUtils.h"
+#include "../PhysicsCollisionListener.h"
 #include "../PhysicsConstants.h"
+#include "../ProjectileSystem.h"
 #include "../Scene.h"
 #include "../SceneObject.h"
 #include "../SceneObjectUtils.h"
 #include "../datarepos/FontRepository.h"
+#include "../datarepos/WaveBlocksRepository.h"
+#include "../dataloaders/GameDataBundle.h"
 #include "../dataloaders/GUISceneLoader.h"
 #include "../../resloading/ResourceLoadingService.h"
 
@@ -24,6 +33,8 @@ const strutils::StringId DebugConsoleGameState::STATE_NAME("DebugConsoleGameStat
 static const glm::vec4 SUCCESS_COLOR(0.0f, 1.0f, 0.0f, 1.0f);
 static const glm::vec4 FAILURE_COLOR(1.0f, 0.0f, 0.0f, 1.0f);
 
+static const std::string DEFAULT_INPUT_RECORDING_NAME = "session";
+
 static const int SCROLL_LINE_THRESHOLD = 8;
 
 static const float BIRDS_EYE_VIEW_CAMERA_LENSE_HEIGHT = 90.0f;
@@ -542,6 +553,213 @@ void DebugConsoleGameState::RegisterCommands()
         return CommandExecutionResult(true, "Game speed: " + std::to_string(GameSingletons::GetGameSpeedMultiplier()));
     };
     
+    mCommandMap[strutils::StringId("level_gen_bench")] = [&](const std::vector<std::string>& commandComponents)
+    {
+        static const std::string USAGE_TEXT("Usage: level_gen_bench [<iterations>]");
+        
+        if (commandComponents.size() != 1 && commandComponents.size() != 2)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        const auto iterations = commandComponents.size() == 2 ? std::stoi(commandComponents[1]) : 100;
+        if (iterations <= 0)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        return CommandExecutionResult(true, level_generation::BenchmarkLevelGeneration(GameSingletons::GetCurrentMapCoord(), { Map::NodeType::HARD_ENCOUNTER, {}, {} }, iterations));
+    };
+    
+    mCommandMap[strutils::StringId("level_gen_determinism")] = [&](const std::vector<std::string>& commandComponents)
+    {
+        static const std::string USAGE_TEXT("Usage: level_gen_determinism");
+        
+        if (commandComponents.size() != 1)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        std::vector<std::string> results;
+        const auto deterministic = level_generation::VerifyGenerationDeterminism(game_constants::MAP_DIMENSIONS, results);
+        return CommandExecutionResult(deterministic, results);
+    };
+    
+    mCommandMap[strutils::StringId("hot_reload_data")] = [&](const std::vector<std::string>& commandComponents)
+    {
+        static const std::string USAGE_TEXT("Usage: hot_reload_data on|off");
+        
+        if (commandComponents.size() != 2 || (commandComponents[1] != "on" && commandComponents[1] != "off"))
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        // Everything loaded from here on reads the XML sources (or the bundle again). Object type
+        // definitions and fonts are re-parsed the next time a scene loads them, while the wave
+        // blocks which are only ever loaded on startup get reloaded right away. Background level
+        // generation reads the wave blocks, so it has to be done (and is redone) first.
+        auto& gameDataBundle = GameDataBundle::GetInstance();
+        gameDataBundle.SetHotReloadEnabled(commandComponents[1] == "on");
+        level_generation::DiscardPendingLevels();
+        WaveBlocksRepository::GetInstance().LoadWaveBlocks();
+        
+        return CommandExecutionResult(true, gameDataBundle.IsHotReloadEnabled() ? "Game data now loaded from XML" : (gameDataBundle.IsMounted() ? "Game data now loaded from the bundle" : "No game data bundle mounted, still loading from XML"));
+    };
+    
+    mCommandMap[strutils::StringId("progress_save_xml")] = [&](const std::vector<std::string>& commandComponents)
+    {
+        static const std::string USAGE_TEXT("Usage: progress_save_xml export|import");
+        
+        if (commandComponents.size() != 2 || (commandComponents[1] != "export" && commandComponents[1] != "import"))
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        if (commandComponents[1] == "export")
+        {
+            const auto exported = persistence_utils::ExportProgressSaveFileXml();
+            return CommandExecutionResult(exported, exported ? "Exported progress save to progress_save.xml" : "Could not export progress save");
+        }
+        
+        const auto imported = persistence_utils::ImportProgressSaveFileXml();
+        return CommandExecutionResult(imported, imported ? "Imported progress save from progress_save.xml" : "Could not import progress save");
+    };
+    
+    mCommandMap[strutils::StringId("flow_scheduling_bench")] = [&](const std::vector<std::string>& commandComponents)
+    {
+        static const std::string USAGE_TEXT("Usage: flow_scheduling_bench [<flows> [<frames>]]");
+        
+        if (commandComponents.size() > 3)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        const auto flowCount = commandComponents.size() >= 2 ? std::stoi(commandComponents[1]) : 10000;
+        const auto frameCount = commandComponents.size() == 3 ? std::stoi(commandComponents[2]) : 600;
+        if (flowCount <= 0 || frameCount <= 0)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        return CommandExecutionResult(true, flow_scheduling::BenchmarkFlowScheduling(flowCount, frameCount));
+    };
+    
+    mCommandMap[strutils::StringId("collision_dispatch_bench")] = [&](const std::vector<std::string>& commandComponents)
+    {
+        static const std::string USAGE_TEXT("Usage: collision_dispatch_bench [<contacts>]");
+        
+        if (commandComponents.size() != 1 && commandComponents.size() != 2)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        const auto contactCount = commandComponents.size() == 2 ? std::stoi(commandComponents[1]) : 1000000;
+        if (contactCount <= 0)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        return CommandExecutionResult(true, collision_dispatch::BenchmarkCollisionDispatch(contactCount));
+    };
+    
+    mCommandMap[strutils::StringId("projectile_sim_bench")] = [&](const std::vector<std::string>& commandComponents)
+    {
+        static const std::string USAGE_TEXT("Usage: projectile_sim_bench [<projectiles> [<steps>]]");
+        
+        if (commandComponents.size() < 1 || commandComponents.size() > 3)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        const auto projectileCount = commandComponents.size() >= 2 ? std::stoi(commandComponents[1]) : 10000;
+        const auto stepCount = commandComponents.size() == 3 ? std::stoi(commandComponents[2]) : 120;
+        if (projectileCount <= 0 || stepCount <= 0)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        return CommandExecutionResult(true, projectile_simulation::BenchmarkProjectileSimulation(projectileCount, stepCount));
+    };
+    
+    mCommandMap[strutils::StringId("frame_work_stats")] = [&](const std::vector<std::string>& commandComponents)
+    {
+        static const std::string USAGE_TEXT("Usage: frame_work_stats");
+        
+        if (commandComponents.size() != 1)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        const auto& frameWorkScheduler = FrameWorkScheduler::GetInstance();
+        const auto& stats = frameWorkScheduler.GetStats();
+        
+        std::vector<std::string> output;
+        output.push_back("Pending work: " + std::to_string(frameWorkScheduler.GetPendingWorkCount()));
+        output.push_back("Slices: " + std::to_string(stats.mSlicesRun) + " Steps: " + std::to_string(stats.mStepsRun));
+        output.push_back("Last slice: " + std::to_string(stats.mLastSliceMillis) + "/" + std::to_string(stats.mLastSliceBudgetMillis) + " millis");
+        output.push_back("Overruns: " + std::to_string(stats.mBudgetOverruns) + " Worst: " + std::to_string(stats.mWorstOverrunMillis) + " millis (" + stats.mWorstOverrunWorkName.GetString() + ")");
+        
+        return CommandExecutionResult(true, output);
+    };
+    
+    mCommandMap[strutils::StringId("input_record")] = [&](const std::vector<std::string>& commandComponents)
+    {
+        static const std::string USAGE_TEXT("Usage: input_record [<name>]");
+        
+        if (commandComponents.size() > 2)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        const auto recordingName = commandComponents.size() == 2 ? commandComponents[1] : DEFAULT_INPUT_RECORDING_NAME;
+        InputRecorder::GetInstance().Arm(recordingName);
+        return CommandExecutionResult(true, "Recording " + recordingName + " starts with the next level, and ends on leaving it or opening the console");
+    };
+    
+    mCommandMap[strutils::StringId("input_replay")] = [&](const std::vector<std::string>& commandComponents)
+    {
+        static const std::string USAGE_TEXT("Usage: input_replay [<name>]");
+        
+        if (commandComponents.size() > 2)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        const auto recordingName = commandComponents.size() == 2 ? commandComponents[1] : DEFAULT_INPUT_RECORDING_NAME;
+        if (!InputReplayer::GetInstance().Load(recordingName))
+        {
+            return CommandExecutionResult(false, "Could not load recording " + recordingName);
+        }
+        
+        return CommandExecutionResult(true, "Replaying " + recordingName + ", frame times get logged once it's over");
+    };
+    
+#ifdef DEBUG
+    mCommandMap[strutils::StringId("level_snapshot_roundtrip")] = [&](const std::vector<std::string>& commandComponents)
+    {
+        static const std::string USAGE_TEXT("Usage: level_snapshot_roundtrip [<frames>]");
+        
+        if (commandComponents.size() > 2)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        const auto frameCount = commandComponents.size() == 2 ? std::stoi(commandComponents[1]) : 120;
+        if (frameCount <= 0)
+        {
+            return CommandExecutionResult(false, USAGE_TEXT);
+        }
+        
+        if (!mLevelUpdater)
+        {
+            return CommandExecutionResult(false, "Not in a level");
+        }
+        
+        mLevelUpdater->BeginSnapshotRoundTrip(frameCount);
+        return CommandExecutionResult(true, "Snapshot round trip of " + std::to_string(frameCount) + " frames scheduled, results get logged once the console is closed");
+    };
+#endif
+    
     mCommandMap[strutils::StringId("visible_bodies")] = [&](const std::vector<std::string>& commandComponents)
     {
         static const std::string USAGE_TEXT("Usage: visible_bodies");
@@ -8,8 +8,9 @@
 #include "FightingWaveGameState.h"
 #include "WaveIntroGameState.h"
 
+#include "../LevelSnapshot.h"
 #include "../LevelUpdater.h"
-#include "../GameSingletons.h"
+#include "../GameContext.h"
 #include "../GameConstants.h"
 #include "../PersistenceUtils.h"
 #include "../PhysicsConstants.h"
@@ -38,51 +39,12 @@ void FightingWaveGameState::VInitialize()
 {
     mBossDeathAnimationActive = false;
     mPlayerDeathAnimationActive = false;
-    GameSingletons::SetBossCurrentHealth(1.0f);
+    mScene->GetGameContext().SetBossCurrentHealth(1.0f);
     
-    auto& objectTypeDefRepo = ObjectTypeDefinitionRepository::GetInstance();
+    // The wave's enemies are streamed in as they approach the screen, rather than all created on wave start
     const auto& currentWave = mLevelUpdater->GetCurrentLevelDefinition().mWaves[mLevelUpdater->GetCurrentWaveNumber()];
-    for (const auto& enemy: currentWave.mEnemies)
-    {
-        const auto& enemyDefOpt = objectTypeDefRepo.GetObjectTypeDefinition(enemy.mGameObjectEnemyType);
-        if (!enemyDefOpt) continue;
-        const auto& enemyDef = enemyDefOpt->get();
-        
-        SceneObject so = scene_object_utils::CreateSceneObjectWithBody(enemyDef, enemy.mPosition, *mBox2dWorld, currentWave.mBossName.isEmpty() ? strutils::StringId() : enemyDef.mName);
-        
-        auto enemyName = so.mName;
-        
-        if (!enemyDef.mProjectileType.isEmpty())
-        {
-            auto projectileFlowName = strutils::StringId(so.mName.GetString() + game_constants::ENEMY_PROJECTILE_FLOW_POSTFIX);
-            mLevelUpdater->AddFlow(RepeatableFlow([=]()
-            {
-                auto bulletDefOpt = ObjectTypeDefinitionRepository::GetInstance().GetObjectTypeDefinition(enemyDef.mProjectileType);
-                auto sourceEnemySoOpt = mScene->GetSceneObject(enemyName);
-                
-                if (bulletDefOpt && sourceEnemySoOpt)
-                {
-                    auto& bulletDef = bulletDefOpt->get();
-                    auto& sourceEnemySo = sourceEnemySoOpt->get();
-                    
-                    auto bulletPosition = math::Box2dVec2ToGlmVec3(sourceEnemySo.mBody->GetWorldCenter());
-                    bulletPosition.z = game_constants::BULLET_Z;
-                    SceneObject bulletSceneObject = scene_object_utils::CreateSceneObjectWithBody(bulletDef, bulletPosition, *mBox2dWorld);
-                    
-                    mLevelUpdater->AddWaveEnemy(bulletSceneObject.mName);
-                    mScene->AddSceneObject(std::move(bulletSceneObject));
-                }
-                else
-                {
-                    Log(LogType::INFO, "Flow %s is dead", projectileFlowName.GetString().c_str());
-                }
-            }, enemyDef.mShootingFrequencyMillis, RepeatableFlow::RepeatPolicy::REPEAT, projectileFlowName));
-        }
-                                   
-        mLevelUpdater->AddWaveEnemy(enemyName);
-        
-        mScene->AddSceneObject(std::move(so));
-    }
+    mEnemySpawner = std::make_unique<WaveEnemySpawner>(*mScene, *mLevelUpdater, *mBox2dWorld);
+    mEnemySpawner->BeginWave(currentWave);
     
     if (!currentWave.mBossName.isEmpty())
     {
@@ -94,6 +56,8 @@ void FightingWaveGameState::VInitialize()
 
 PostStateUpdateDirective FightingWaveGameState::VUpdate(const float dtMillis)
 {
+    mEnemySpawner->Update();
+    
     if (mBossDeathAnimationActive)
     {
         std::unordered_set<strutils::StringId, strutils::StringIdHasher> enemyNamesToRemove;
@@ -121,7 +85,7 @@ PostStateUpdateDirective FightingWaveGameState::VUpdate(const float dtMillis)
     }
     else if (!mLevelUpdater->GetCurrentLevelDefinition().mWaves.at(mLevelUpdater->GetCurrentWaveNumber()).mBossName.isEmpty())
     {
-        if (GameSingletons::GetBossCurrentHealth() <= 0.0f)
+        if (mScene->GetGameContext().GetBossCurrentHealth() <= 0.0f)
         {
             auto& objectTypeDefRepo = ObjectTypeDefinitionRepository::GetInstance();
             
@@ -202,7 +166,7 @@ PostStateUpdateDirective FightingWaveGameState::VUpdate(const float dtMillis)
             }
         }
     }
-    else if (GameSingletons::GetPlayerCurrentHealth()/GameSingletons::GetPlayerMaxHealth() <= 0.0f)
+    else if (mScene->GetGameContext().GetPlayerCurrentHealth()/mScene->GetGameContext().GetPlayerMaxHealth() <= 0.0f)
     {
         auto playerSoOpt = mScene->GetSceneObject(game_constants::PLAYER_SCENE_OBJECT_NAME);
         if (playerSoOpt)
@@ -220,7 +184,7 @@ PostStateUpdateDirective FightingWaveGameState::VUpdate(const float dtMillis)
         mScene->SetProgressResetFlag();
     }
     
-    if (mLevelUpdater->GetWaveEnemyCount() == 0 && GameSingletons::GetPlayerCurrentHealth() > 0.0f)
+    if (mLevelUpdater->GetWaveEnemyCount() == 0 && mEnemySpawner->IsFinished() && mScene->GetGameContext().GetPlayerCurrentHealth() > 0.0f)
     {
         mLevelUpdater->AdvanceWave();
         Complete(WaveIntroGameState::STATE_NAME);
@@ -231,6 +195,38 @@ PostStateUpdateDirective FightingWaveGameState::VUpdate(const float dtMillis)
 
 ///------------------------------------------------------------------------------------------------
 
+void FightingWaveGameState::VDestroy()
+{
+    mEnemySpawner = nullptr;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool FightingWaveGameState::VWriteSnapshot(SnapshotWriter& writer) const
+{
+    // The death animations distort the exploding entities' meshes in place, so can't be resumed
+    if (mBossDeathAnimationActive || mPlayerDeathAnimationActive)
+    {
+        return false;
+    }
+    
+    return mEnemySpawner->WriteSnapshot(writer);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void FightingWaveGameState::VReadSnapshot(SnapshotReader& reader)
+{
+    mBossDeathAnimationActive = false;
+    mPlayerDeathAnimationActive = false;
+    
+    const auto& currentWave = mLevelUpdater->GetCurrentLevelDefinition().mWaves[mLevelUpdater->GetCurrentWaveNumber()];
+    mEnemySpawner = std::make_unique<WaveEnemySpawner>(*mScene, *mLevelUpdater, *mBox2dWorld);
+    mEnemySpawner->ReadSnapshot(reader, currentWave);
+}
+
+///------------------------------------------------------------------------------------------------
+
 void FightingWaveGameState::UpdateExplodingSpecialEntity(const float dtMillis, SceneObject& sceneObject)
 {
     auto& mesh =  resources::ResourceLoadingService::GetInstance().GetResource<resources::MeshResource>(sceneObject.mAnimation->VGetCurrentMeshResourceId());
@@ -11,6 +11,9 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "BaseGameState.h"
+#include "../WaveEnemySpawner.h"
+
+#include <memory>
 
 ///------------------------------------------------------------------------------------------------
 
@@ -23,11 +26,15 @@ public:
 public:
     void VInitialize() override;
     PostStateUpdateDirective VUpdate(const float dtMillis) override;
+    void VDestroy() override;
+    bool VWriteSnapshot(SnapshotWriter& writer) const override;
+    void VReadSnapshot(SnapshotReader& reader) override;
     
 private:
     void UpdateExplodingSpecialEntity(const float dtMillis, SceneObject& sceneObject);
     
 private:
+    std::unique_ptr<WaveEnemySpawner> mEnemySpawner;
     bool mBossDeathAnimationActive;
     bool mPlayerDeathAnimationActive;
 };
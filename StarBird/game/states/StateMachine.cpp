@@ -5,10 +5,14 @@
 ///  Created by Alex Koukoulas on 16/02/2023                                                       
 ///------------------------------------------------------------------------------------------------
 
+#include "../../utils/Logging.h"
 #include "../../utils/OSMessageBox.h"
+#include "../LevelSnapshot.h"
 #include "BaseGameState.h"
 #include "StateMachine.h"
 
+#include <vector>
+
 ///------------------------------------------------------------------------------------------------
 
 bool StateMachine::IsEmpty() const
@@ -22,15 +26,8 @@ const strutils::StringId StateMachine::GetActiveStateName() const
 {
     if (mStateStack.empty()) return strutils::StringId();
     
-    for (const auto& entry: mStateNameToInstanceMap)
-    {
-        if (entry.second.get() == mStateStack.top())
-        {
-            return entry.first;
-        }
-    }
-    
-    return mStateNameToInstanceMap.begin()->first;
+    auto stateName = GetStateName(mStateStack.top());
+    return stateName.isEmpty() ? mStateNameToInstanceMap.begin()->first : stateName;
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -77,6 +74,67 @@ PostStateUpdateDirective StateMachine::Update(const float dtMillis)
 
 ///------------------------------------------------------------------------------------------------
 
+void StateMachine::Reset()
+{
+    while (!mStateStack.empty())
+    {
+        mStateStack.top()->VDestroy();
+        mStateStack.top()->mNextStateName = strutils::StringId();
+        mStateStack.pop();
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool StateMachine::WriteSnapshot(SnapshotWriter& writer) const
+{
+    std::vector<const BaseGameState*> states;
+    auto stateStack = mStateStack;
+    while (!stateStack.empty())
+    {
+        states.insert(states.begin(), stateStack.top());
+        stateStack.pop();
+    }
+    
+    writer.Write(static_cast<uint32_t>(states.size()));
+    for (const auto* state: states)
+    {
+        writer.WriteStringId(GetStateName(state));
+        writer.WriteStringId(state->mNextStateName);
+        if (!state->VWriteSnapshot(writer))
+        {
+            Log(LogType::INFO, "State %s can't be captured in a snapshot", GetStateName(state).GetString().c_str());
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool StateMachine::ReadSnapshot(SnapshotReader& reader)
+{
+    const auto stateCount = reader.ReadCount();
+    for (uint32_t i = 0; i < stateCount && reader.IsValid(); ++i)
+    {
+        auto iter = mStateNameToInstanceMap.find(reader.ReadRawStringId());
+        if (iter == mStateNameToInstanceMap.end())
+        {
+            reader.Invalidate();
+            break;
+        }
+        
+        mStateStack.push(iter->second.get());
+        mStateStack.top()->mNextStateName = reader.ReadRawStringId();
+        mStateStack.top()->VReadSnapshot(reader);
+    }
+    
+    return reader.IsValid();
+}
+
+///------------------------------------------------------------------------------------------------
+
 void StateMachine::SwitchToState(const strutils::StringId& nextStateName, bool pushOnTop)
 {
     auto iter = mStateNameToInstanceMap.find(nextStateName);
@@ -99,3 +157,18 @@ void StateMachine::SwitchToState(const strutils::StringId& nextStateName, bool p
 }
 
 ///------------------------------------------------------------------------------------------------
+
+strutils::StringId StateMachine::GetStateName(const BaseGameState* state) const
+{
+    for (const auto& entry: mStateNameToInstanceMap)
+    {
+        if (entry.second.get() == state)
+        {
+            return entry.first;
+        }
+    }
+    
+    return strutils::StringId();
+}
+
+///------------------------------------------------------------------------------------------------
@@ -22,6 +22,8 @@
 ///------------------------------------------------------------------------------------------------
 
 class Scene;
+class SnapshotReader;
+class SnapshotWriter;
 class LevelUpdater;
 class b2World;
 class UpgradesLevelLogicHandler;
@@ -51,8 +53,21 @@ public:
     void PushState(const strutils::StringId& stateName);
     PostStateUpdateDirective Update(const float dtMillis);
     
+    /// Destroys and pops all states.
+    void Reset();
+    
+    /// Writes the whole state stack (bottom to top) along with each state's snapshot data.
+    /// @returns false if any of the states can't be captured at this point.
+    bool WriteSnapshot(SnapshotWriter& writer) const;
+    
+    /// Rebuilds a state stack written by WriteSnapshot, on top of an empty state machine. States get
+    /// restored through BaseGameState::VReadSnapshot, rather than initialized.
+    /// @returns whether the state stack could be read.
+    bool ReadSnapshot(SnapshotReader& reader);
+    
 private:
     void SwitchToState(const strutils::StringId& nextStateName, const bool pushOnTop=false);
+    strutils::StringId GetStateName(const BaseGameState* state) const;
     
 private:
     Scene* mScene;
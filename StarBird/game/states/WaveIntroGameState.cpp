@@ -10,6 +10,7 @@
 #include "ClearedLevelAnimationGameState.h"
 #include "FightingWaveGameState.h"
 #include "../Scene.h"
+#include "../LevelSnapshot.h"
 #include "../LevelUpdater.h"
 #include "../GameConstants.h"
 #include "../datarepos/FontRepository.h"
@@ -52,19 +53,7 @@ void WaveIntroGameState::VInitialize()
     
     mScene->AddSceneObject(std::move(waveTextSO));
     
-    mLevelUpdater->AddFlow(RepeatableFlow([&]()
-    {
-        if (mLevelUpdater->LevelFinished())
-        {
-            mLevelUpdater->GetFlow(game_constants::PLAYER_BULLET_FLOW_NAME)->get().ForceFinish();
-            Complete(ClearedLevelAnimationGameState::STATE_NAME);
-        }
-        else
-        {
-            Complete(FightingWaveGameState::STATE_NAME);
-        }
-        
-    }, WAVE_INTRO_DURATION_MILLIS, RepeatableFlow::RepeatPolicy::ONCE, game_constants::WAVE_INTRO_FLOW_NAME));
+    mLevelUpdater->AddFlow(CreateIntroFlow(WAVE_INTRO_DURATION_MILLIS));
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -102,3 +91,53 @@ void WaveIntroGameState::VDestroy()
 }
 
 ///------------------------------------------------------------------------------------------------
+
+bool WaveIntroGameState::VWriteSnapshot(SnapshotWriter& writer) const
+{
+    // The intro text itself is captured along with the rest of the scene objects
+    auto waveIntroFlowOpt = mLevelUpdater->GetFlow(game_constants::WAVE_INTRO_FLOW_NAME);
+    writer.Write(waveIntroFlowOpt.has_value());
+    if (waveIntroFlowOpt)
+    {
+        writer.Write(waveIntroFlowOpt->get().GetDuration());
+        writer.Write(waveIntroFlowOpt->get().GetTicksLeft());
+    }
+    
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void WaveIntroGameState::VReadSnapshot(SnapshotReader& reader)
+{
+    if (reader.Read<bool>())
+    {
+        const auto durationMillis = reader.Read<float>();
+        const auto ticksLeft = reader.Read<float>();
+        mLevelUpdater->ResumeFlow(CreateIntroFlow(durationMillis), ticksLeft);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+RepeatableFlow WaveIntroGameState::CreateIntroFlow(const float durationMillis)
+{
+    return RepeatableFlow([this](){ OnIntroFinished(); }, durationMillis, RepeatableFlow::RepeatPolicy::ONCE, game_constants::WAVE_INTRO_FLOW_NAME);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void WaveIntroGameState::OnIntroFinished()
+{
+    if (mLevelUpdater->LevelFinished())
+    {
+        mLevelUpdater->GetFlow(game_constants::PLAYER_BULLET_FLOW_NAME)->get().ForceFinish();
+        Complete(ClearedLevelAnimationGameState::STATE_NAME);
+    }
+    else
+    {
+        Complete(FightingWaveGameState::STATE_NAME);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
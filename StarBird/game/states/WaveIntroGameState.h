@@ -11,6 +11,7 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "BaseGameState.h"
+#include "../RepeatableFlow.h"
 
 ///------------------------------------------------------------------------------------------------
 
@@ -23,6 +24,12 @@ public:
     void VInitialize() override;
     PostStateUpdateDirective VUpdate(const float dtMillis) override;
     void VDestroy() override;
+    bool VWriteSnapshot(SnapshotWriter& writer) const override;
+    void VReadSnapshot(SnapshotReader& reader) override;
+    
+private:
+    RepeatableFlow CreateIntroFlow(const float durationMillis);
+    void OnIntroFinished();
 };
 
 ///------------------------------------------------------------------------------------------------
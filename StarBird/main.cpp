@@ -6,10 +6,70 @@
 ///------------------------------------------------------------------------------------------------
 
 #include <SDL.h>
+#include <iostream>
+#include <string>
 #include "Game.h"
+#include "InputRecording.h"
+
+///------------------------------------------------------------------------------------------------
+
+static const std::string HEADLESS_ARG = "--headless";
+static const std::string HEADLESS_USAGE_TEXT = "Usage: --headless <frames> <seed> <col> <row> [normal|hard|boss]";
+static const std::string REPLAY_ARG = "--replay";
+
+///------------------------------------------------------------------------------------------------
+
+static bool ParseHeadlessParameters(int argc, char* args[], Game::HeadlessParameters& outHeadlessParameters)
+{
+    if (argc < 6 || argc > 7)
+    {
+        return false;
+    }
+
+    try
+    {
+        outHeadlessParameters.mFrameCount = std::stoi(args[2]);
+        outHeadlessParameters.mSeed = std::stoi(args[3]);
+        outHeadlessParameters.mMapCoord = MapCoord(std::stoi(args[4]), std::stoi(args[5]));
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    const std::string nodeType = argc == 7 ? args[6] : "normal";
+    if (nodeType == "normal") outHeadlessParameters.mNodeType = Map::NodeType::NORMAL_ENCOUNTER;
+    else if (nodeType == "hard") outHeadlessParameters.mNodeType = Map::NodeType::HARD_ENCOUNTER;
+    else if (nodeType == "boss") outHeadlessParameters.mNodeType = Map::NodeType::BOSS_ENCOUNTER;
+    else return false;
+
+    return outHeadlessParameters.mFrameCount > 0 && outHeadlessParameters.mSeed >= 0;
+}
+
+///------------------------------------------------------------------------------------------------
 
 int main( int argc, char* args[] )
 {
+    if (argc > 1 && args[1] == HEADLESS_ARG)
+    {
+        Game::HeadlessParameters headlessParameters = { 0, 0, MapCoord(0, 0), Map::NodeType::NORMAL_ENCOUNTER };
+        if (!ParseHeadlessParameters(argc, args, headlessParameters))
+        {
+            std::cerr << HEADLESS_USAGE_TEXT << std::endl;
+            return 1;
+        }
+
+        Game game(headlessParameters);
+        std::cout << game.GetHeadlessResult().mReport << std::flush;
+        return 0;
+    }
+
+    // The replay starts on the game's first frame (see InputReplayer)
+    if (argc == 3 && args[1] == REPLAY_ARG)
+    {
+        InputReplayer::GetInstance().QueueLoad(args[2]);
+    }
+    
     Game game;
     exit(0);
     return 0;
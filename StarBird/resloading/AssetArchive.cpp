@@ -0,0 +1,593 @@
+///------------------------------------------------------------------------------------------------
+///  AssetArchive.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "AssetArchive.h"
+#include "../utils/FileUtils.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+///------------------------------------------------------------------------------------------------
+
+namespace resources
+{
+
+///------------------------------------------------------------------------------------------------
+
+static const char ASSET_ARCHIVE_MAGIC[4] = { 'S', 'B', 'P', 'K' };
+static const uint32_t ASSET_ARCHIVE_VERSION = 1;
+static const uint64_t ASSET_DATA_ALIGNMENT = 16;
+
+///------------------------------------------------------------------------------------------------
+
+struct AssetArchiveHeader
+{
+    char mMagic[4];
+    uint32_t mVersion;
+    uint32_t mDirectorySlotCount;
+    uint32_t mEntryCount;
+    uint64_t mPathTableOffset;
+    uint64_t mDataOffset;
+};
+
+static_assert(sizeof(AssetArchiveHeader) == 32, "Asset archive header layout changed");
+static_assert(sizeof(AssetArchiveEntry) == 32, "Asset archive entry layout changed");
+
+///------------------------------------------------------------------------------------------------
+
+static uint64_t AlignUp(const uint64_t value, const uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+///------------------------------------------------------------------------------------------------
+
+static bool IsDirectoryValid(const unsigned char* mappedData, const size_t mappedSize, const uint32_t directorySlotCount)
+{
+    // Every path and file (plus its NUL terminator) the directory points to has to lie within
+    // the mapping, so that lookups never need to bounds check again.
+    const auto* header = reinterpret_cast<const AssetArchiveHeader*>(mappedData);
+    const auto* directory = reinterpret_cast<const AssetArchiveEntry*>(mappedData + sizeof(AssetArchiveHeader));
+
+    for (uint32_t i = 0; i < directorySlotCount; ++i)
+    {
+        const auto& entry = directory[i];
+        if (entry.mPathHash == 0)
+        {
+            continue;
+        }
+
+        if (entry.mPathOffset < header->mPathTableOffset ||
+            static_cast<uint64_t>(entry.mPathOffset) + entry.mPathLength > header->mDataOffset ||
+            entry.mOffset < header->mDataOffset ||
+            entry.mOffset > mappedSize ||
+            static_cast<uint64_t>(entry.mSize) >= mappedSize - entry.mOffset)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+AssetArchive& AssetArchive::GetInstance()
+{
+    static AssetArchive instance;
+    return instance;
+}
+
+///------------------------------------------------------------------------------------------------
+
+AssetArchive::~AssetArchive()
+{
+    Unmount();
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool AssetArchive::Mount(const std::string& archivePath, const std::string& mountRoot)
+{
+    Unmount();
+
+    const auto fileDescriptor = open(archivePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStats;
+    if (fstat(fileDescriptor, &fileStats) != 0 || static_cast<size_t>(fileStats.st_size) < sizeof(AssetArchiveHeader))
+    {
+        close(fileDescriptor);
+        return false;
+    }
+
+    const auto mappedSize = static_cast<size_t>(fileStats.st_size);
+    auto* mappedData = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+    // The mapping outlives the descriptor
+    close(fileDescriptor);
+
+    if (mappedData == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const auto* header = static_cast<const AssetArchiveHeader*>(mappedData);
+    const auto directorySize = static_cast<uint64_t>(header->mDirectorySlotCount) * sizeof(AssetArchiveEntry);
+
+    if (!std::equal(header->mMagic, header->mMagic + 4, ASSET_ARCHIVE_MAGIC) ||
+        header->mVersion != ASSET_ARCHIVE_VERSION ||
+        header->mDirectorySlotCount == 0 ||
+        (header->mDirectorySlotCount & (header->mDirectorySlotCount - 1)) != 0 ||
+        sizeof(AssetArchiveHeader) + directorySize > header->mPathTableOffset ||
+        header->mPathTableOffset > header->mDataOffset ||
+        header->mDataOffset > mappedSize ||
+        !IsDirectoryValid(static_cast<const unsigned char*>(mappedData), mappedSize, header->mDirectorySlotCount))
+    {
+        munmap(mappedData, mappedSize);
+        return false;
+    }
+
+    mMountRoot = mountRoot;
+    mMappedData = static_cast<const unsigned char*>(mappedData);
+    mMappedSize = mappedSize;
+    mDirectory = reinterpret_cast<const AssetArchiveEntry*>(mMappedData + sizeof(AssetArchiveHeader));
+    mDirectorySlotCount = header->mDirectorySlotCount;
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void AssetArchive::Unmount()
+{
+    if (mMappedData)
+    {
+        munmap(const_cast<unsigned char*>(mMappedData), mMappedSize);
+    }
+
+    mMountRoot.clear();
+    mMappedData = nullptr;
+    mMappedSize = 0;
+    mDirectory = nullptr;
+    mDirectorySlotCount = 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool AssetArchive::IsMounted() const
+{
+    return mMappedData != nullptr;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool AssetArchive::IsUnderMountRoot(const std::string& filePath) const
+{
+    return IsMounted() && filePath.compare(0, mMountRoot.size(), mMountRoot) == 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool AssetArchive::FindFile(const std::string& filePath, const char*& outData, size_t& outSize) const
+{
+    if (!IsUnderMountRoot(filePath))
+    {
+        return false;
+    }
+
+    const auto* entry = FindEntry(std::string_view(filePath).substr(mMountRoot.size()));
+    if (!entry)
+    {
+        return false;
+    }
+
+    outData = reinterpret_cast<const char*>(mMappedData + entry->mOffset);
+    outSize = entry->mSize;
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::vector<std::string> AssetArchive::GetFileNamesInDirectory(const std::string& directoryPath) const
+{
+    std::vector<std::string> fileNames;
+
+    if (!IsUnderMountRoot(directoryPath))
+    {
+        return fileNames;
+    }
+
+    auto relativeDirectoryPath = directoryPath.substr(mMountRoot.size());
+    if (!relativeDirectoryPath.empty() && relativeDirectoryPath.back() != '/')
+    {
+        relativeDirectoryPath += '/';
+    }
+
+    for (uint32_t i = 0; i < mDirectorySlotCount; ++i)
+    {
+        const auto& entry = mDirectory[i];
+        if (entry.mPathHash == 0)
+        {
+            continue;
+        }
+
+        const auto entryPath = std::string_view(reinterpret_cast<const char*>(mMappedData + entry.mPathOffset), entry.mPathLength);
+        if (entryPath.compare(0, relativeDirectoryPath.size(), relativeDirectoryPath) == 0 && entryPath.find('/', relativeDirectoryPath.size()) == std::string_view::npos)
+        {
+            fileNames.emplace_back(entryPath.substr(relativeDirectoryPath.size()));
+        }
+    }
+
+    std::sort(fileNames.begin(), fileNames.end());
+    return fileNames;
+}
+
+///------------------------------------------------------------------------------------------------
+
+const AssetArchiveEntry* AssetArchive::FindEntry(const std::string_view relativePath) const
+{
+    const auto pathHash = asset_archive::HashPath(relativePath);
+    const auto slotMask = mDirectorySlotCount - 1;
+
+    for (uint32_t probe = 0, slot = static_cast<uint32_t>(pathHash) & slotMask; probe < mDirectorySlotCount; ++probe, slot = (slot + 1) & slotMask)
+    {
+        const auto& entry = mDirectory[slot];
+        if (entry.mPathHash == 0)
+        {
+            return nullptr;
+        }
+
+        if (entry.mPathHash == pathHash && entry.mPathLength == relativePath.size() && std::memcmp(mMappedData + entry.mPathOffset, relativePath.data(), relativePath.size()) == 0)
+        {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+///------------------------------------------------------------------------------------------------
+
+ResourceFile::ResourceFile(const std::string& filePath)
+    : mData(nullptr)
+    , mSize(0)
+    , mValid(false)
+{
+    if (AssetArchive::GetInstance().FindFile(filePath, mData, mSize))
+    {
+        mValid = true;
+        return;
+    }
+
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.good())
+    {
+        return;
+    }
+
+    file.seekg(0, std::ios::end);
+    const auto fileSize = static_cast<size_t>(file.tellg());
+    file.seekg(0, std::ios::beg);
+
+    mOwnedData.resize(fileSize + 1, '\0');
+    file.read(mOwnedData.data(), fileSize);
+
+    mData = mOwnedData.data();
+    mSize = fileSize;
+    mValid = true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool ResourceFile::Exists(const std::string& filePath)
+{
+    const char* data = nullptr;
+    size_t size = 0;
+
+    // Same lookup order as the constructor (archive first, then loose files), so that
+    // whatever is reported as existing can also be opened and vice versa
+    if (AssetArchive::GetInstance().FindFile(filePath, data, size))
+    {
+        return true;
+    }
+
+    return std::ifstream(filePath).good();
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::vector<std::string> ResourceFile::GetFileNamesInDirectory(const std::string& directoryPath)
+{
+    auto fileNames = AssetArchive::GetInstance().GetFileNamesInDirectory(directoryPath);
+    const auto looseFileNames = fileutils::GetAllFilenamesInDirectory(directoryPath);
+
+    fileNames.insert(fileNames.end(), looseFileNames.begin(), looseFileNames.end());
+    std::sort(fileNames.begin(), fileNames.end());
+    fileNames.erase(std::unique(fileNames.begin(), fileNames.end()), fileNames.end());
+
+    return fileNames;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool ResourceFile::IsValid() const
+{
+    return mValid;
+}
+
+///------------------------------------------------------------------------------------------------
+
+const char* ResourceFile::GetData() const
+{
+    return mData;
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t ResourceFile::GetSize() const
+{
+    return mSize;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::string_view ResourceFile::GetContents() const
+{
+    return std::string_view(mData, mSize);
+}
+
+///------------------------------------------------------------------------------------------------
+
+MutableResourceFile::MutableResourceFile(const std::string& filePath)
+    : mData(nullptr)
+    , mSize(0)
+    , mMappedData(nullptr)
+    , mMappedSize(0)
+{
+    const char* packedData = nullptr;
+    size_t packedSize = 0;
+    if (AssetArchive::GetInstance().FindFile(filePath, packedData, packedSize))
+    {
+        mOwnedData.assign(packedData, packedData + packedSize);
+        mOwnedData.push_back('\0');
+        mData = mOwnedData.data();
+        mSize = packedSize;
+        return;
+    }
+
+    const auto fileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        return;
+    }
+
+    struct stat fileStats;
+    if (fstat(fileDescriptor, &fileStats) != 0)
+    {
+        close(fileDescriptor);
+        return;
+    }
+
+    const auto fileSize = static_cast<size_t>(fileStats.st_size);
+    const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+    // The tail of the last mapped page past the end of the file is zero filled, which
+    // gives the NUL terminator for free unless the file ends exactly on a page boundary
+    if (fileSize > 0 && fileSize % pageSize != 0)
+    {
+        auto* mappedData = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, 0);
+        if (mappedData != MAP_FAILED)
+        {
+            close(fileDescriptor);
+            mMappedData = mappedData;
+            mMappedSize = fileSize;
+            mData = static_cast<char*>(mappedData);
+            mSize = fileSize;
+            return;
+        }
+    }
+
+    mOwnedData.resize(fileSize + 1, '\0');
+    size_t bytesRead = 0;
+    while (bytesRead < fileSize)
+    {
+        const auto result = read(fileDescriptor, mOwnedData.data() + bytesRead, fileSize - bytesRead);
+        if (result <= 0)
+        {
+            break;
+        }
+        bytesRead += static_cast<size_t>(result);
+    }
+    close(fileDescriptor);
+
+    mData = mOwnedData.data();
+    mSize = bytesRead;
+    mOwnedData[bytesRead] = '\0';
+}
+
+///------------------------------------------------------------------------------------------------
+
+MutableResourceFile::~MutableResourceFile()
+{
+    if (mMappedData)
+    {
+        munmap(mMappedData, mMappedSize);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool MutableResourceFile::IsValid() const
+{
+    return mData != nullptr;
+}
+
+///------------------------------------------------------------------------------------------------
+
+char* MutableResourceFile::GetData()
+{
+    return mData;
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t MutableResourceFile::GetSize() const
+{
+    return mSize;
+}
+
+///------------------------------------------------------------------------------------------------
+
+namespace asset_archive
+{
+
+///------------------------------------------------------------------------------------------------
+
+uint64_t HashPath(const std::string_view relativePath)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (const auto c: relativePath)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+
+    return hash == 0 ? 1 : hash;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool WriteAssetArchive(const std::string& archivePath, const std::string& rootDirectory, const std::vector<std::string>& relativeFilePaths, std::string& outError)
+{
+    uint32_t slotCount = 1;
+    while (slotCount < relativeFilePaths.size() * 2)
+    {
+        slotCount <<= 1;
+    }
+
+    std::vector<AssetArchiveEntry> directory(slotCount, AssetArchiveEntry{ 0, 0, 0, 0, 0, 0 });
+    std::vector<std::vector<char>> fileContents(relativeFilePaths.size());
+    std::vector<uint32_t> fileSlots(relativeFilePaths.size());
+
+    AssetArchiveHeader header;
+    std::memcpy(header.mMagic, ASSET_ARCHIVE_MAGIC, 4);
+    header.mVersion = ASSET_ARCHIVE_VERSION;
+    header.mDirectorySlotCount = slotCount;
+    header.mEntryCount = static_cast<uint32_t>(relativeFilePaths.size());
+    header.mPathTableOffset = sizeof(AssetArchiveHeader) + slotCount * sizeof(AssetArchiveEntry);
+
+    uint64_t pathTableSize = 0;
+    for (const auto& relativeFilePath: relativeFilePaths)
+    {
+        pathTableSize += relativeFilePath.size();
+    }
+
+    header.mDataOffset = AlignUp(header.mPathTableOffset + pathTableSize, ASSET_DATA_ALIGNMENT);
+
+    uint64_t pathOffset = header.mPathTableOffset;
+    uint64_t dataOffset = header.mDataOffset;
+
+    for (size_t i = 0; i < relativeFilePaths.size(); ++i)
+    {
+        const auto& relativeFilePath = relativeFilePaths[i];
+
+        std::ifstream file(rootDirectory + relativeFilePath, std::ios::binary);
+        if (!file.good())
+        {
+            outError = "Could not read " + rootDirectory + relativeFilePath;
+            return false;
+        }
+
+        fileContents[i].assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        const auto pathHash = HashPath(relativeFilePath);
+        auto slot = static_cast<uint32_t>(pathHash) & (slotCount - 1);
+        while (directory[slot].mPathHash != 0)
+        {
+            if (directory[slot].mPathHash == pathHash)
+            {
+                outError = "Path hash collision for " + relativeFilePath;
+                return false;
+            }
+
+            slot = (slot + 1) & (slotCount - 1);
+        }
+
+        auto& entry = directory[slot];
+        entry.mPathHash = pathHash;
+        entry.mOffset = dataOffset;
+        entry.mSize = static_cast<uint32_t>(fileContents[i].size());
+        entry.mFlags = ASSET_FLAG_NUL_TERMINATED;
+        entry.mPathOffset = static_cast<uint32_t>(pathOffset);
+        entry.mPathLength = static_cast<uint32_t>(relativeFilePath.size());
+        fileSlots[i] = slot;
+
+        pathOffset += relativeFilePath.size();
+        dataOffset = AlignUp(dataOffset + entry.mSize + 1, ASSET_DATA_ALIGNMENT);
+    }
+
+    // Write to a temporary file first so that a failed pack never leaves a truncated archive behind
+    const auto temporaryArchivePath = archivePath + ".tmp";
+    std::ofstream archiveFile(temporaryArchivePath, std::ios::binary | std::ios::trunc);
+    if (!archiveFile.good())
+    {
+        outError = "Could not write " + temporaryArchivePath;
+        return false;
+    }
+
+    const auto writePadding = [&](const uint64_t targetOffset)
+    {
+        while (static_cast<uint64_t>(archiveFile.tellp()) < targetOffset)
+        {
+            archiveFile.put('\0');
+        }
+    };
+
+    archiveFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    archiveFile.write(reinterpret_cast<const char*>(directory.data()), directory.size() * sizeof(AssetArchiveEntry));
+
+    for (const auto& relativeFilePath: relativeFilePaths)
+    {
+        archiveFile.write(relativeFilePath.data(), relativeFilePath.size());
+    }
+
+    for (size_t i = 0; i < relativeFilePaths.size(); ++i)
+    {
+        writePadding(directory[fileSlots[i]].mOffset);
+        archiveFile.write(fileContents[i].data(), fileContents[i].size());
+        archiveFile.put('\0');
+    }
+
+    archiveFile.close();
+    if (!archiveFile.good() || std::rename(temporaryArchivePath.c_str(), archivePath.c_str()) != 0)
+    {
+        outError = "Could not finalize " + archivePath;
+        return false;
+    }
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
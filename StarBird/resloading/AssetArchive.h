@@ -0,0 +1,184 @@
+///------------------------------------------------------------------------------------------------
+///  AssetArchive.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef AssetArchive_h
+#define AssetArchive_h
+
+///------------------------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+namespace resources
+{
+
+///------------------------------------------------------------------------------------------------
+
+/// Single slot of the archive's directory. The directory is an open addressing
+/// hash table (linear probing, power of two slot count) keyed by the hash of each
+/// file's path relative to the archive root. Empty slots have a path hash of 0.
+struct AssetArchiveEntry
+{
+    uint64_t mPathHash;
+    uint64_t mOffset;
+    uint32_t mSize;
+    uint32_t mFlags;
+    uint32_t mPathOffset;
+    uint32_t mPathLength;
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// A read only, memory mapped pack of all game assets (.pak). File contents are
+/// stored uncompressed and 16 byte aligned, each followed by a NUL terminator,
+/// so that they can be consumed straight from the mapping without any copies.
+class AssetArchive final
+{
+public:
+    /// The default method of getting a hold of this singleton.
+    /// @returns a reference to the single instance of this class.
+    static AssetArchive& GetInstance();
+
+    ~AssetArchive();
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive(AssetArchive&&) = delete;
+    const AssetArchive& operator = (const AssetArchive&) = delete;
+    AssetArchive& operator = (AssetArchive&&) = delete;
+
+    /// Memory maps the archive found at the given path.
+    /// @param[in] archivePath the path to the .pak file.
+    /// @param[in] mountRoot the path prefix (e.g. res/) that the archive's file paths are relative to.
+    /// @returns whether the archive was found and was valid.
+    bool Mount(const std::string& archivePath, const std::string& mountRoot);
+    void Unmount();
+    bool IsMounted() const;
+
+    /// Checks whether the given path falls under the root the archive is mounted at.
+    /// @param[in] filePath the path of the file.
+    /// @returns whether the archive is mounted and is the authority on the given path.
+    bool IsUnderMountRoot(const std::string& filePath) const;
+
+    /// Looks up a file in the archive in O(1).
+    /// @param[in] filePath the path of the file, starting with the mount root.
+    /// @param[out] outData pointer to the (NUL terminated) contents of the file inside the mapping.
+    /// @param[out] outSize the size of the file in bytes.
+    /// @returns whether the file is part of the archive.
+    bool FindFile(const std::string& filePath, const char*& outData, size_t& outSize) const;
+
+    /// Lists the names of all files packed directly under the given directory.
+    /// @param[in] directoryPath the path of the directory, starting with the mount root.
+    /// @returns the sorted file names (not paths) found.
+    std::vector<std::string> GetFileNamesInDirectory(const std::string& directoryPath) const;
+
+private:
+    AssetArchive() = default;
+
+    const AssetArchiveEntry* FindEntry(const std::string_view relativePath) const;
+
+private:
+    std::string mMountRoot;
+    const unsigned char* mMappedData = nullptr;
+    size_t mMappedSize = 0;
+    const AssetArchiveEntry* mDirectory = nullptr;
+    uint32_t mDirectorySlotCount = 0;
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// Read only contents of a single resource file. Files packed in the mounted
+/// asset archive point straight in to its mapping, otherwise the loose file
+/// is read in to a buffer owned by this object. Either way the contents are NUL terminated.
+class ResourceFile final
+{
+public:
+    explicit ResourceFile(const std::string& filePath);
+    ResourceFile(const ResourceFile&) = delete;
+    const ResourceFile& operator = (const ResourceFile&) = delete;
+
+    static bool Exists(const std::string& filePath);
+    static std::vector<std::string> GetFileNamesInDirectory(const std::string& directoryPath);
+
+    bool IsValid() const;
+    const char* GetData() const;
+    size_t GetSize() const;
+    std::string_view GetContents() const;
+
+private:
+    std::vector<char> mOwnedData;
+    const char* mData;
+    size_t mSize;
+    bool mValid;
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// Writable, NUL terminated contents of a single resource file, for in place (destructive)
+/// parsing. Loose files are mapped copy on write, so only the pages actually written to
+/// get copied. Files packed in the archive (whose mapping is read only), empty files and
+/// files with no room left for a NUL terminator in their last mapped page are read in to
+/// a buffer owned by this object instead.
+class MutableResourceFile final
+{
+public:
+    explicit MutableResourceFile(const std::string& filePath);
+    ~MutableResourceFile();
+    MutableResourceFile(const MutableResourceFile&) = delete;
+    const MutableResourceFile& operator = (const MutableResourceFile&) = delete;
+
+    bool IsValid() const;
+    char* GetData();
+    size_t GetSize() const;
+
+private:
+    std::vector<char> mOwnedData;
+    char* mData;
+    size_t mSize;
+    void* mMappedData;
+    size_t mMappedSize;
+};
+
+///------------------------------------------------------------------------------------------------
+
+namespace asset_archive
+{
+
+///------------------------------------------------------------------------------------------------
+
+inline const std::string ASSET_ARCHIVE_FILE_NAME = "assets.pak";
+inline const uint32_t ASSET_FLAG_NUL_TERMINATED = 1 << 0;
+
+///------------------------------------------------------------------------------------------------
+/// Stable (FNV-1a) hash of a file path relative to the archive root. This needs to
+/// match between the pack tool and the game, hence not relying on std::hash.
+/// @param[in] relativePath the path to hash.
+/// @returns the path hash (never 0, as that marks empty directory slots).
+uint64_t HashPath(const std::string_view relativePath);
+
+///------------------------------------------------------------------------------------------------
+/// Packs the given files in to a new archive.
+/// @param[in] archivePath the path to write the .pak file to.
+/// @param[in] rootDirectory the directory the given file paths are relative to.
+/// @param[in] relativeFilePaths the paths of the files to pack.
+/// @param[out] outError description of the failure, if any.
+/// @returns whether the archive was written successfully.
+bool WriteAssetArchive(const std::string& archivePath, const std::string& rootDirectory, const std::vector<std::string>& relativeFilePaths, std::string& outError);
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* AssetArchive_h */
@@ -0,0 +1,862 @@
+///------------------------------------------------------------------------------------------------
+///  CookedTexture.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "AssetArchive.h"
+#include "CookedTexture.h"
+#include "../utils/StringUtils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+///------------------------------------------------------------------------------------------------
+
+namespace resources
+{
+
+///------------------------------------------------------------------------------------------------
+
+namespace texture_cooking
+{
+
+///------------------------------------------------------------------------------------------------
+
+static const char COOKED_TEXTURE_MAGIC[4] = { 'S', 'B', 'T', 'X' };
+static const uint32_t COOKED_TEXTURE_VERSION = 1;
+static const uint32_t MAX_COOKED_TEXTURE_DIMENSION = 16384;
+
+static const int BLOCK_DIMENSION = 4;
+static const int BLOCK_PIXEL_COUNT = BLOCK_DIMENSION * BLOCK_DIMENSION;
+
+// ETC1/ETC2 intensity modifier tables (indexed by pixel index msb * 2 + lsb)
+static const int ETC_MODIFIER_TABLES[8][4] =
+{
+    {  2,   8,  -2,   -8 },
+    {  5,  17,  -5,  -17 },
+    {  9,  29,  -9,  -29 },
+    { 13,  42, -13,  -42 },
+    { 18,  60, -18,  -60 },
+    { 24,  80, -24,  -80 },
+    { 33, 106, -33, -106 },
+    { 47, 183, -47, -183 }
+};
+
+// EAC alpha modifier tables
+static const int EAC_MODIFIER_TABLES[16][8] =
+{
+    { -3, -6,  -9, -15, 2, 5, 8, 14 },
+    { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5,  -8, -13, 1, 4, 7, 12 },
+    { -2, -4,  -6, -13, 1, 3, 5, 12 },
+    { -3, -6,  -8, -12, 2, 5, 7, 11 },
+    { -3, -7,  -9, -11, 2, 6, 8, 10 },
+    { -4, -7,  -8, -11, 3, 6, 7, 10 },
+    { -3, -5,  -8, -11, 2, 4, 7, 10 },
+    { -2, -6,  -8, -10, 1, 5, 7,  9 },
+    { -2, -5,  -8, -10, 1, 4, 7,  9 },
+    { -2, -4,  -8, -10, 1, 3, 7,  9 },
+    { -2, -5,  -7, -10, 1, 4, 6,  9 },
+    { -3, -4,  -7, -10, 2, 3, 6,  9 },
+    { -1, -2,  -3, -10, 0, 1, 2,  9 },
+    { -4, -6,  -8,  -9, 3, 5, 7,  8 },
+    { -3, -5,  -7,  -9, 2, 4, 6,  8 }
+};
+
+///------------------------------------------------------------------------------------------------
+
+static int Clamp255(const int value)
+{
+    return std::max(0, std::min(255, value));
+}
+
+///------------------------------------------------------------------------------------------------
+
+static uint32_t GetBlockCount(const uint32_t width, const uint32_t height)
+{
+    return ((width + BLOCK_DIMENSION - 1)/BLOCK_DIMENSION) * ((height + BLOCK_DIMENSION - 1)/BLOCK_DIMENSION);
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void WriteBigEndian64(const uint64_t value, unsigned char* dest)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        dest[i] = static_cast<unsigned char>((value >> (56 - i * 8)) & 0xFF);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+static uint64_t ReadBigEndian64(const unsigned char* src)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        value = (value << 8) | src[i];
+    }
+    return value;
+}
+
+///------------------------------------------------------------------------------------------------
+
+// Fetches the 4x4 block at the given block coordinates in column major order
+// (pixel index = x * 4 + y, as per the ETC bit layout), replicating the edge
+// pixels for blocks hanging off the image (mip levels smaller than 4x4 etc..)
+static void FetchBlock(const unsigned char* rgbaPixels, const uint32_t width, const uint32_t height, const uint32_t blockX, const uint32_t blockY, unsigned char outBlock[BLOCK_PIXEL_COUNT][4])
+{
+    for (int x = 0; x < BLOCK_DIMENSION; ++x)
+    {
+        for (int y = 0; y < BLOCK_DIMENSION; ++y)
+        {
+            const auto pixelX = std::min(blockX * BLOCK_DIMENSION + x, width - 1);
+            const auto pixelY = std::min(blockY * BLOCK_DIMENSION + y, height - 1);
+            const auto* pixel = &rgbaPixels[(pixelY * width + pixelX) * 4];
+            std::copy(pixel, pixel + 4, outBlock[x * BLOCK_DIMENSION + y]);
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+static bool IsPixelInFirstSubBlock(const int pixelIndex, const bool flip)
+{
+    // No flip: two 2x4 sub blocks side by side. Flip: two 4x2 sub blocks stacked
+    return flip ? (pixelIndex % BLOCK_DIMENSION) < 2 : (pixelIndex / BLOCK_DIMENSION) < 2;
+}
+
+///------------------------------------------------------------------------------------------------
+
+// Encodes the color channels of a block in ETC1 individual mode (a strict subset of ETC2),
+// trying both sub block orientations and all modifier tables per sub block.
+static uint64_t EncodeETC2ColorBlock(const unsigned char block[BLOCK_PIXEL_COUNT][4])
+{
+    uint64_t bestBlockBits = 0;
+    long bestBlockError = LONG_MAX;
+
+    for (int flip = 0; flip < 2; ++flip)
+    {
+        uint64_t blockBits = (static_cast<uint64_t>(flip) << 32);
+        long blockError = 0;
+
+        for (int subBlock = 0; subBlock < 2; ++subBlock)
+        {
+            int colorSum[3] = { 0, 0, 0 };
+            for (int i = 0; i < BLOCK_PIXEL_COUNT; ++i)
+            {
+                if (IsPixelInFirstSubBlock(i, flip) != (subBlock == 0)) continue;
+                for (int c = 0; c < 3; ++c) colorSum[c] += block[i][c];
+            }
+
+            int baseColor[3];
+            int quantizedColor[3];
+            for (int c = 0; c < 3; ++c)
+            {
+                quantizedColor[c] = Clamp255((colorSum[c] * 15 + (BLOCK_PIXEL_COUNT/2) * 255/2)/((BLOCK_PIXEL_COUNT/2) * 255));
+                quantizedColor[c] = std::min(15, quantizedColor[c]);
+                baseColor[c] = quantizedColor[c] | (quantizedColor[c] << 4);
+            }
+
+            int bestTable = 0;
+            long bestTableError = LONG_MAX;
+            uint32_t bestTableIndexBits = 0;
+
+            for (int table = 0; table < 8; ++table)
+            {
+                long tableError = 0;
+                uint32_t tableIndexBits = 0;
+
+                for (int i = 0; i < BLOCK_PIXEL_COUNT; ++i)
+                {
+                    if (IsPixelInFirstSubBlock(i, flip) != (subBlock == 0)) continue;
+
+                    long bestPixelError = LONG_MAX;
+                    int bestModifierIndex = 0;
+                    for (int modifierIndex = 0; modifierIndex < 4; ++modifierIndex)
+                    {
+                        long pixelError = 0;
+                        for (int c = 0; c < 3; ++c)
+                        {
+                            const auto diff = Clamp255(baseColor[c] + ETC_MODIFIER_TABLES[table][modifierIndex]) - block[i][c];
+                            pixelError += diff * diff;
+                        }
+
+                        if (pixelError < bestPixelError)
+                        {
+                            bestPixelError = pixelError;
+                            bestModifierIndex = modifierIndex;
+                        }
+                    }
+
+                    tableError += bestPixelError;
+                    tableIndexBits |= ((bestModifierIndex >> 1) & 0x1) << (16 + i);
+                    tableIndexBits |= (bestModifierIndex & 0x1) << i;
+                }
+
+                if (tableError < bestTableError)
+                {
+                    bestTableError = tableError;
+                    bestTable = table;
+                    bestTableIndexBits = tableIndexBits;
+                }
+            }
+
+            blockError += bestTableError;
+            blockBits |= bestTableIndexBits;
+            blockBits |= static_cast<uint64_t>(quantizedColor[0]) << (subBlock == 0 ? 60 : 56);
+            blockBits |= static_cast<uint64_t>(quantizedColor[1]) << (subBlock == 0 ? 52 : 48);
+            blockBits |= static_cast<uint64_t>(quantizedColor[2]) << (subBlock == 0 ? 44 : 40);
+            blockBits |= static_cast<uint64_t>(bestTable) << (subBlock == 0 ? 37 : 34);
+        }
+
+        if (blockError < bestBlockError)
+        {
+            bestBlockError = blockError;
+            bestBlockBits = blockBits;
+        }
+    }
+
+    return bestBlockBits;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static uint64_t EncodeEACAlphaBlock(const unsigned char block[BLOCK_PIXEL_COUNT][4])
+{
+    int minAlpha = 255, maxAlpha = 0;
+    for (int i = 0; i < BLOCK_PIXEL_COUNT; ++i)
+    {
+        minAlpha = std::min(minAlpha, static_cast<int>(block[i][3]));
+        maxAlpha = std::max(maxAlpha, static_cast<int>(block[i][3]));
+    }
+
+    const int baseAlpha = (minAlpha + maxAlpha + 1)/2;
+
+    uint64_t bestBlockBits = 0;
+    long bestBlockError = LONG_MAX;
+
+    for (int table = 0; table < 16 && bestBlockError > 0; ++table)
+    {
+        for (int multiplier = 1; multiplier < 16 && bestBlockError > 0; ++multiplier)
+        {
+            uint64_t blockBits = (static_cast<uint64_t>(baseAlpha) << 56) | (static_cast<uint64_t>(multiplier) << 52) | (static_cast<uint64_t>(table) << 48);
+            long blockError = 0;
+
+            for (int i = 0; i < BLOCK_PIXEL_COUNT; ++i)
+            {
+                long bestPixelError = LONG_MAX;
+                int bestModifierIndex = 0;
+                for (int modifierIndex = 0; modifierIndex < 8; ++modifierIndex)
+                {
+                    const auto diff = Clamp255(baseAlpha + EAC_MODIFIER_TABLES[table][modifierIndex] * multiplier) - block[i][3];
+                    if (diff * diff < bestPixelError)
+                    {
+                        bestPixelError = diff * diff;
+                        bestModifierIndex = modifierIndex;
+                    }
+                }
+
+                blockError += bestPixelError;
+                blockBits |= static_cast<uint64_t>(bestModifierIndex) << (45 - 3 * i);
+            }
+
+            if (blockError < bestBlockError)
+            {
+                bestBlockError = blockError;
+                bestBlockBits = blockBits;
+            }
+        }
+    }
+
+    return bestBlockBits;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void DecodeETC2ColorBlock(const uint64_t blockBits, unsigned char outBlock[BLOCK_PIXEL_COUNT][4])
+{
+    const bool flip = (blockBits >> 32) & 0x1;
+    const bool differential = (blockBits >> 33) & 0x1;
+
+    int baseColors[2][3];
+    if (!differential)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            const auto firstColor = static_cast<int>((blockBits >> (60 - c * 8)) & 0xF);
+            const auto secondColor = static_cast<int>((blockBits >> (56 - c * 8)) & 0xF);
+            baseColors[0][c] = firstColor | (firstColor << 4);
+            baseColors[1][c] = secondColor | (secondColor << 4);
+        }
+    }
+    else
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            const auto firstColor = static_cast<int>((blockBits >> (59 - c * 8)) & 0x1F);
+            auto delta = static_cast<int>((blockBits >> (56 - c * 8)) & 0x7);
+            if (delta >= 4) delta -= 8;
+
+            // Overflowing differential blocks denote the ETC2 T/H/planar modes, which are
+            // never emitted by the cooker. Clamp them so that they at least decode to something sane.
+            const auto secondColor = std::max(0, std::min(31, firstColor + delta));
+            baseColors[0][c] = (firstColor << 3) | (firstColor >> 2);
+            baseColors[1][c] = (secondColor << 3) | (secondColor >> 2);
+        }
+    }
+
+    const int tables[2] = { static_cast<int>((blockBits >> 37) & 0x7), static_cast<int>((blockBits >> 34) & 0x7) };
+
+    for (int i = 0; i < BLOCK_PIXEL_COUNT; ++i)
+    {
+        const auto subBlock = IsPixelInFirstSubBlock(i, flip) ? 0 : 1;
+        const auto modifierIndex = static_cast<int>((((blockBits >> (16 + i)) & 0x1) << 1) | ((blockBits >> i) & 0x1));
+        const auto modifier = ETC_MODIFIER_TABLES[tables[subBlock]][modifierIndex];
+
+        for (int c = 0; c < 3; ++c)
+        {
+            outBlock[i][c] = static_cast<unsigned char>(Clamp255(baseColors[subBlock][c] + modifier));
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void DecodeEACAlphaBlock(const uint64_t blockBits, unsigned char outBlock[BLOCK_PIXEL_COUNT][4])
+{
+    const auto baseAlpha = static_cast<int>((blockBits >> 56) & 0xFF);
+    const auto multiplier = static_cast<int>((blockBits >> 52) & 0xF);
+    const auto table = static_cast<int>((blockBits >> 48) & 0xF);
+
+    for (int i = 0; i < BLOCK_PIXEL_COUNT; ++i)
+    {
+        const auto modifierIndex = static_cast<int>((blockBits >> (45 - 3 * i)) & 0x7);
+        outBlock[i][3] = static_cast<unsigned char>(Clamp255(baseAlpha + EAC_MODIFIER_TABLES[table][modifierIndex] * multiplier));
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+static uint32_t QuantizeChannel(const unsigned char value, const uint32_t maxQuantizedValue)
+{
+    return (value * maxQuantizedValue + 127)/255;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static unsigned char ExpandChannel(const uint32_t quantizedValue, const uint32_t maxQuantizedValue)
+{
+    return static_cast<unsigned char>((quantizedValue * 255 + maxQuantizedValue/2)/maxQuantizedValue);
+}
+
+///------------------------------------------------------------------------------------------------
+
+static bool IsChannelLosslessInBits(const unsigned char value, const uint32_t maxQuantizedValue)
+{
+    return ExpandChannel(QuantizeChannel(value, maxQuantizedValue), maxQuantizedValue) == value;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static std::vector<unsigned char> CompressMipLevel(const unsigned char* rgbaPixels, const uint32_t width, const uint32_t height, const CookedTextureFormat format)
+{
+    const auto pixelCount = width * height;
+    switch (format)
+    {
+        case CookedTextureFormat::RGBA8: return std::vector<unsigned char>(rgbaPixels, rgbaPixels + pixelCount * 4);
+        case CookedTextureFormat::R8:
+        case CookedTextureFormat::A8:
+        {
+            const auto sourceChannel = format == CookedTextureFormat::R8 ? 0 : 3;
+            std::vector<unsigned char> convertedData(pixelCount);
+            for (uint32_t i = 0; i < pixelCount; ++i) convertedData[i] = rgbaPixels[i * 4 + sourceChannel];
+            return convertedData;
+        }
+        case CookedTextureFormat::RG8:
+        {
+            std::vector<unsigned char> convertedData(pixelCount * 2);
+            for (uint32_t i = 0; i < pixelCount; ++i)
+            {
+                convertedData[i * 2] = rgbaPixels[i * 4];
+                convertedData[i * 2 + 1] = rgbaPixels[i * 4 + 3];
+            }
+            return convertedData;
+        }
+        case CookedTextureFormat::RGB565:
+        case CookedTextureFormat::RGBA4444:
+        {
+            std::vector<unsigned char> convertedData(pixelCount * 2);
+            for (uint32_t i = 0; i < pixelCount; ++i)
+            {
+                const auto* pixel = &rgbaPixels[i * 4];
+                const uint16_t packedPixel = format == CookedTextureFormat::RGB565 ?
+                    static_cast<uint16_t>((QuantizeChannel(pixel[0], 31) << 11) | (QuantizeChannel(pixel[1], 63) << 5) | QuantizeChannel(pixel[2], 31)) :
+                    static_cast<uint16_t>((QuantizeChannel(pixel[0], 15) << 12) | (QuantizeChannel(pixel[1], 15) << 8) | (QuantizeChannel(pixel[2], 15) << 4) | QuantizeChannel(pixel[3], 15));
+                std::memcpy(&convertedData[i * 2], &packedPixel, sizeof(uint16_t));
+            }
+            return convertedData;
+        }
+        default: break;
+    }
+
+    const auto blockSize = format == CookedTextureFormat::ETC2_RGBA8_EAC ? 16 : 8;
+    const auto blocksX = (width + BLOCK_DIMENSION - 1)/BLOCK_DIMENSION;
+    const auto blocksY = (height + BLOCK_DIMENSION - 1)/BLOCK_DIMENSION;
+
+    std::vector<unsigned char> compressedData(GetMipLevelByteSize(format, width, height));
+    unsigned char block[BLOCK_PIXEL_COUNT][4];
+
+    // Blocks are laid out left to right, top to bottom
+    for (uint32_t blockY = 0; blockY < blocksY; ++blockY)
+    {
+        for (uint32_t blockX = 0; blockX < blocksX; ++blockX)
+        {
+            FetchBlock(rgbaPixels, width, height, blockX, blockY, block);
+
+            auto* dest = &compressedData[(blockY * blocksX + blockX) * blockSize];
+            if (format == CookedTextureFormat::ETC2_RGBA8_EAC)
+            {
+                WriteBigEndian64(EncodeEACAlphaBlock(block), dest);
+                dest += 8;
+            }
+
+            WriteBigEndian64(EncodeETC2ColorBlock(block), dest);
+        }
+    }
+
+    return compressedData;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static std::vector<unsigned char> DownsampleMipLevel(const std::vector<unsigned char>& rgbaPixels, const uint32_t width, const uint32_t height)
+{
+    const auto targetWidth = std::max(1u, width/2);
+    const auto targetHeight = std::max(1u, height/2);
+
+    std::vector<unsigned char> downsampledPixels(targetWidth * targetHeight * 4);
+    for (uint32_t y = 0; y < targetHeight; ++y)
+    {
+        for (uint32_t x = 0; x < targetWidth; ++x)
+        {
+            const uint32_t sourceX[2] = { std::min(x * 2, width - 1), std::min(x * 2 + 1, width - 1) };
+            const uint32_t sourceY[2] = { std::min(y * 2, height - 1), std::min(y * 2 + 1, height - 1) };
+
+            for (int c = 0; c < 4; ++c)
+            {
+                int channelSum = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    channelSum += rgbaPixels[(sourceY[i/2] * width + sourceX[i%2]) * 4 + c];
+                }
+                downsampledPixels[(y * targetWidth + x) * 4 + c] = static_cast<unsigned char>((channelSum + 2)/4);
+            }
+        }
+    }
+
+    return downsampledPixels;
+}
+
+///------------------------------------------------------------------------------------------------
+
+template<class T>
+static void WriteValue(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+///------------------------------------------------------------------------------------------------
+
+template<class T>
+static bool ReadValue(const char*& cursor, const char* end, T& value)
+{
+    if (cursor + sizeof(T) > end)
+    {
+        return false;
+    }
+    
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool ReadSheetMetadataFile(const std::string& metadataFilePath, std::vector<SheetRowDescriptor>& outSheetRows)
+{
+    ResourceFile file(metadataFilePath);
+    if (!file.IsValid())
+    {
+        return false;
+    }
+
+    std::istringstream metadataFile{std::string(file.GetContents())};
+
+    std::string line;
+    while (std::getline(metadataFile, line))
+    {
+        auto splitByComma = strutils::StringSplit(line, ',');
+        assert(splitByComma.size() == 3);
+        outSheetRows.push_back({ std::stoi(splitByComma[0]), std::stoi(splitByComma[1]), std::stoi(splitByComma[2]) });
+    }
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool ReadFormatOverrideFile(const std::string& formatOverrideFilePath, CookedTextureFormat& outFormat)
+{
+    static const std::unordered_map<std::string, CookedTextureFormat> FORMAT_NAMES =
+    {
+        { "rgba8", CookedTextureFormat::RGBA8 },
+        { "etc2_rgb8", CookedTextureFormat::ETC2_RGB8 },
+        { "etc2_rgba8", CookedTextureFormat::ETC2_RGBA8_EAC },
+        { "r8", CookedTextureFormat::R8 },
+        { "a8", CookedTextureFormat::A8 },
+        { "rg8", CookedTextureFormat::RG8 },
+        { "rgb565", CookedTextureFormat::RGB565 },
+        { "rgba4444", CookedTextureFormat::RGBA4444 }
+    };
+    
+    ResourceFile file(formatOverrideFilePath);
+    if (!file.IsValid())
+    {
+        return false;
+    }
+    
+    std::istringstream formatOverrideFile{std::string(file.GetContents())};
+    std::string formatName;
+    if (!(formatOverrideFile >> formatName))
+    {
+        return false;
+    }
+    
+    auto findIter = FORMAT_NAMES.find(strutils::StringToLower(formatName));
+    if (findIter == FORMAT_NAMES.end())
+    {
+        return false;
+    }
+    
+    outFormat = findIter->second;
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+CookedTextureFormat SelectNarrowestLosslessFormat(const unsigned char* rgbaPixels, const uint32_t width, const uint32_t height)
+{
+    bool opaque = true;
+    bool grayscale = true;
+    bool whiteWithAlpha = true;
+    bool losslessIn565 = true;
+    bool losslessIn4444 = true;
+    
+    for (uint32_t i = 0; i < width * height; ++i)
+    {
+        const auto* pixel = &rgbaPixels[i * 4];
+        
+        opaque &= pixel[3] == 0xFF;
+        grayscale &= pixel[0] == pixel[1] && pixel[1] == pixel[2];
+        
+        // A8 decodes to white, so every pixel's color has to be white, including the fully
+        // transparent ones (linear filtering and mip generation still blend them in)
+        whiteWithAlpha &= pixel[0] == 0xFF && pixel[1] == 0xFF && pixel[2] == 0xFF;
+        
+        losslessIn565 &= IsChannelLosslessInBits(pixel[0], 31) && IsChannelLosslessInBits(pixel[1], 63) && IsChannelLosslessInBits(pixel[2], 31);
+        losslessIn4444 &= IsChannelLosslessInBits(pixel[0], 15) && IsChannelLosslessInBits(pixel[1], 15) && IsChannelLosslessInBits(pixel[2], 15) && IsChannelLosslessInBits(pixel[3], 15);
+    }
+    
+    if (grayscale && opaque) return CookedTextureFormat::R8;
+    if (whiteWithAlpha && !opaque) return CookedTextureFormat::A8;
+    if (grayscale) return CookedTextureFormat::RG8;
+    if (losslessIn565 && opaque) return CookedTextureFormat::RGB565;
+    if (losslessIn4444) return CookedTextureFormat::RGBA4444;
+    
+    return CookedTextureFormat::RGBA8;
+}
+
+///------------------------------------------------------------------------------------------------
+
+uint32_t GetMipLevelByteSize(const CookedTextureFormat format, const uint32_t width, const uint32_t height)
+{
+    switch (format)
+    {
+        case CookedTextureFormat::RGBA8: return width * height * 4;
+        case CookedTextureFormat::ETC2_RGB8: return GetBlockCount(width, height) * 8;
+        case CookedTextureFormat::ETC2_RGBA8_EAC: return GetBlockCount(width, height) * 16;
+        case CookedTextureFormat::R8: return width * height;
+        case CookedTextureFormat::A8: return width * height;
+        case CookedTextureFormat::RG8: return width * height * 2;
+        case CookedTextureFormat::RGB565: return width * height * 2;
+        case CookedTextureFormat::RGBA4444: return width * height * 2;
+    }
+    
+    return 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool ReadCookedTexture(const std::string& cookedTexturePath, CookedTexture& outCookedTexture)
+{
+    ResourceFile file(cookedTexturePath);
+    if (!file.IsValid())
+    {
+        return false;
+    }
+
+    const char* cursor = file.GetData();
+    const char* end = file.GetData() + file.GetSize();
+
+    uint32_t version = 0, format = 0, mipCount = 0, sheetRowCount = 0;
+    if (file.GetSize() < 4 || !std::equal(cursor, cursor + 4, COOKED_TEXTURE_MAGIC))
+    {
+        return false;
+    }
+    
+    cursor += 4;
+    
+    if (!ReadValue(cursor, end, version) || version != COOKED_TEXTURE_VERSION)
+    {
+        return false;
+    }
+
+    if (!ReadValue(cursor, end, format) || !ReadValue(cursor, end, outCookedTexture.mWidth) || !ReadValue(cursor, end, outCookedTexture.mHeight) || !ReadValue(cursor, end, mipCount) || !ReadValue(cursor, end, sheetRowCount))
+    {
+        return false;
+    }
+
+    // Nothing in the header is trusted as read, since a stale or truncated container would otherwise
+    // have us allocate or copy (and later upload) well past its end
+    if (format > static_cast<uint32_t>(CookedTextureFormat::RGBA4444) ||
+        outCookedTexture.mWidth == 0 || outCookedTexture.mWidth > MAX_COOKED_TEXTURE_DIMENSION ||
+        outCookedTexture.mHeight == 0 || outCookedTexture.mHeight > MAX_COOKED_TEXTURE_DIMENSION)
+    {
+        return false;
+    }
+    
+    uint32_t fullMipChainCount = 1;
+    for (auto largestDimension = std::max(outCookedTexture.mWidth, outCookedTexture.mHeight); largestDimension > 1; largestDimension >>= 1)
+    {
+        ++fullMipChainCount;
+    }
+    
+    const auto sheetRowByteSize = 3 * sizeof(int32_t);
+    if (mipCount == 0 || mipCount > fullMipChainCount || sheetRowCount > outCookedTexture.mHeight || sheetRowCount > static_cast<size_t>(end - cursor) / sheetRowByteSize)
+    {
+        return false;
+    }
+    
+    outCookedTexture.mFormat = static_cast<CookedTextureFormat>(format);
+
+    outCookedTexture.mSheetRows.resize(sheetRowCount);
+    for (auto& sheetRow: outCookedTexture.mSheetRows)
+    {
+        if (!ReadValue(cursor, end, sheetRow.mElementWidth) || !ReadValue(cursor, end, sheetRow.mElementHeight) || !ReadValue(cursor, end, sheetRow.mElementCount))
+        {
+            return false;
+        }
+    }
+
+    outCookedTexture.mMipLevels.resize(mipCount);
+    for (size_t i = 0; i < outCookedTexture.mMipLevels.size(); ++i)
+    {
+        uint32_t mipWidth = 0, mipHeight = 0;
+        GetMipLevelDimensions(outCookedTexture, i, mipWidth, mipHeight);
+        
+        uint32_t mipLevelSize = 0;
+        if (!ReadValue(cursor, end, mipLevelSize) || mipLevelSize != GetMipLevelByteSize(outCookedTexture.mFormat, mipWidth, mipHeight) || mipLevelSize > static_cast<size_t>(end - cursor))
+        {
+            return false;
+        }
+
+        outCookedTexture.mMipLevels[i].assign(cursor, cursor + mipLevelSize);
+        cursor += mipLevelSize;
+    }
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool WriteCookedTexture(const std::string& cookedTexturePath, const CookedTexture& cookedTexture)
+{
+    std::ofstream file(cookedTexturePath, std::ios::binary | std::ios::trunc);
+    if (!file.good())
+    {
+        return false;
+    }
+
+    file.write(COOKED_TEXTURE_MAGIC, 4);
+    WriteValue(file, COOKED_TEXTURE_VERSION);
+    WriteValue(file, static_cast<uint32_t>(cookedTexture.mFormat));
+    WriteValue(file, cookedTexture.mWidth);
+    WriteValue(file, cookedTexture.mHeight);
+    WriteValue(file, static_cast<uint32_t>(cookedTexture.mMipLevels.size()));
+    WriteValue(file, static_cast<uint32_t>(cookedTexture.mSheetRows.size()));
+
+    for (const auto& sheetRow: cookedTexture.mSheetRows)
+    {
+        WriteValue(file, sheetRow.mElementWidth);
+        WriteValue(file, sheetRow.mElementHeight);
+        WriteValue(file, sheetRow.mElementCount);
+    }
+
+    for (const auto& mipLevel: cookedTexture.mMipLevels)
+    {
+        WriteValue(file, static_cast<uint32_t>(mipLevel.size()));
+        file.write(reinterpret_cast<const char*>(mipLevel.data()), mipLevel.size());
+    }
+
+    return file.good();
+}
+
+///------------------------------------------------------------------------------------------------
+
+CookedTexture CookTexture(const unsigned char* rgbaPixels, const uint32_t width, const uint32_t height, const CookedTextureFormat format, const bool generateMipMaps, const std::vector<SheetRowDescriptor>& sheetRows)
+{
+    CookedTexture cookedTexture;
+    cookedTexture.mFormat = format;
+    cookedTexture.mWidth = width;
+    cookedTexture.mHeight = height;
+    cookedTexture.mSheetRows = sheetRows;
+
+    std::vector<unsigned char> currentMipPixels(rgbaPixels, rgbaPixels + width * height * 4);
+    auto currentMipWidth = width;
+    auto currentMipHeight = height;
+
+    while (true)
+    {
+        cookedTexture.mMipLevels.push_back(CompressMipLevel(currentMipPixels.data(), currentMipWidth, currentMipHeight, format));
+
+        if (!generateMipMaps || (currentMipWidth == 1 && currentMipHeight == 1))
+        {
+            break;
+        }
+
+        currentMipPixels = DownsampleMipLevel(currentMipPixels, currentMipWidth, currentMipHeight);
+        currentMipWidth = std::max(1u, currentMipWidth/2);
+        currentMipHeight = std::max(1u, currentMipHeight/2);
+    }
+
+    return cookedTexture;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::vector<unsigned char> DecodeMipLevelToRGBA8(const CookedTexture& cookedTexture, const size_t mipLevel)
+{
+    uint32_t width = 0, height = 0;
+    GetMipLevelDimensions(cookedTexture, mipLevel, width, height);
+
+    const auto& mipLevelData = cookedTexture.mMipLevels.at(mipLevel);
+    const auto pixelCount = width * height;
+    
+    switch (cookedTexture.mFormat)
+    {
+        case CookedTextureFormat::RGBA8: return mipLevelData;
+        case CookedTextureFormat::R8:
+        case CookedTextureFormat::A8:
+        case CookedTextureFormat::RG8:
+        case CookedTextureFormat::RGB565:
+        case CookedTextureFormat::RGBA4444:
+        {
+            std::vector<unsigned char> rgbaPixels(pixelCount * 4);
+            for (uint32_t i = 0; i < pixelCount; ++i)
+            {
+                auto* pixel = &rgbaPixels[i * 4];
+                switch (cookedTexture.mFormat)
+                {
+                    case CookedTextureFormat::R8: pixel[0] = pixel[1] = pixel[2] = mipLevelData[i]; pixel[3] = 0xFF; break;
+                    case CookedTextureFormat::A8: pixel[0] = pixel[1] = pixel[2] = 0xFF; pixel[3] = mipLevelData[i]; break;
+                    case CookedTextureFormat::RG8: pixel[0] = pixel[1] = pixel[2] = mipLevelData[i * 2]; pixel[3] = mipLevelData[i * 2 + 1]; break;
+                    case CookedTextureFormat::RGB565:
+                    {
+                        uint16_t packedPixel;
+                        std::memcpy(&packedPixel, &mipLevelData[i * 2], sizeof(uint16_t));
+                        pixel[0] = ExpandChannel((packedPixel >> 11) & 0x1F, 31);
+                        pixel[1] = ExpandChannel((packedPixel >> 5) & 0x3F, 63);
+                        pixel[2] = ExpandChannel(packedPixel & 0x1F, 31);
+                        pixel[3] = 0xFF;
+                    } break;
+                    default:
+                    {
+                        uint16_t packedPixel;
+                        std::memcpy(&packedPixel, &mipLevelData[i * 2], sizeof(uint16_t));
+                        pixel[0] = ExpandChannel((packedPixel >> 12) & 0xF, 15);
+                        pixel[1] = ExpandChannel((packedPixel >> 8) & 0xF, 15);
+                        pixel[2] = ExpandChannel((packedPixel >> 4) & 0xF, 15);
+                        pixel[3] = ExpandChannel(packedPixel & 0xF, 15);
+                    } break;
+                }
+            }
+            return rgbaPixels;
+        }
+        default: break;
+    }
+
+    const auto hasAlphaBlock = cookedTexture.mFormat == CookedTextureFormat::ETC2_RGBA8_EAC;
+    const auto blockSize = hasAlphaBlock ? 16 : 8;
+    const auto blocksX = (width + BLOCK_DIMENSION - 1)/BLOCK_DIMENSION;
+    const auto blocksY = (height + BLOCK_DIMENSION - 1)/BLOCK_DIMENSION;
+
+    std::vector<unsigned char> rgbaPixels(pixelCount * 4);
+    unsigned char block[BLOCK_PIXEL_COUNT][4];
+
+    for (uint32_t blockY = 0; blockY < blocksY; ++blockY)
+    {
+        for (uint32_t blockX = 0; blockX < blocksX; ++blockX)
+        {
+            const auto* src = &mipLevelData[(blockY * blocksX + blockX) * blockSize];
+
+            for (int i = 0; i < BLOCK_PIXEL_COUNT; ++i) block[i][3] = 0xFF;
+            if (hasAlphaBlock)
+            {
+                DecodeEACAlphaBlock(ReadBigEndian64(src), block);
+                src += 8;
+            }
+
+            DecodeETC2ColorBlock(ReadBigEndian64(src), block);
+
+            for (int x = 0; x < BLOCK_DIMENSION; ++x)
+            {
+                for (int y = 0; y < BLOCK_DIMENSION; ++y)
+                {
+                    const auto pixelX = blockX * BLOCK_DIMENSION + x;
+                    const auto pixelY = blockY * BLOCK_DIMENSION + y;
+                    if (pixelX >= width || pixelY >= height) continue;
+
+                    std::copy(block[x * BLOCK_DIMENSION + y], block[x * BLOCK_DIMENSION + y] + 4, &rgbaPixels[(pixelY * width + pixelX) * 4]);
+                }
+            }
+        }
+    }
+
+    return rgbaPixels;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void GetMipLevelDimensions(const CookedTexture& cookedTexture, const size_t mipLevel, uint32_t& outWidth, uint32_t& outHeight)
+{
+    outWidth = std::max(1u, cookedTexture.mWidth >> mipLevel);
+    outHeight = std::max(1u, cookedTexture.mHeight >> mipLevel);
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
@@ -0,0 +1,156 @@
+///------------------------------------------------------------------------------------------------
+///  CookedTexture.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef CookedTexture_h
+#define CookedTexture_h
+
+///------------------------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+namespace resources
+{
+
+///------------------------------------------------------------------------------------------------
+
+enum class CookedTextureFormat : uint32_t
+{
+    RGBA8 = 0,           // Uncompressed, 4 bytes per pixel
+    ETC2_RGB8 = 1,       // 8 bytes per 4x4 block, fully opaque textures only
+    ETC2_RGBA8_EAC = 2,  // 16 bytes per 4x4 block (EAC alpha block + ETC2 color block)
+    R8 = 3,              // 1 byte per pixel, opaque grayscale (sampled as rrr1)
+    A8 = 4,              // 1 byte per pixel, white with alpha e.g. font atlases (sampled as 111r)
+    RG8 = 5,             // 2 bytes per pixel, grayscale with alpha (sampled as rrrg)
+    RGB565 = 6,          // 2 bytes per pixel, opaque
+    RGBA4444 = 7         // 2 bytes per pixel
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// A single line of a sprite sheet's .mtd file, i.e. the pixel
+/// dimensions of each element in that row and the number of elements.
+struct SheetRowDescriptor
+{
+    int32_t mElementWidth;
+    int32_t mElementHeight;
+    int32_t mElementCount;
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// Contents of a cooked texture container (.ctx). These are produced offline
+/// from the source .bmp files and hold the GPU ready payload of every mip level
+/// along with the sprite sheet metadata (if any) of the source texture.
+struct CookedTexture
+{
+    CookedTextureFormat mFormat = CookedTextureFormat::RGBA8;
+    uint32_t mWidth = 0;
+    uint32_t mHeight = 0;
+    std::vector<SheetRowDescriptor> mSheetRows;
+    std::vector<std::vector<unsigned char>> mMipLevels;
+};
+
+///------------------------------------------------------------------------------------------------
+
+namespace texture_cooking
+{
+
+///------------------------------------------------------------------------------------------------
+
+inline const std::string COOKED_TEXTURE_EXTENSION = "ctx";
+inline const std::string FORMAT_OVERRIDE_EXTENSION = "fmt";
+
+///------------------------------------------------------------------------------------------------
+/// Parses the sprite sheet metadata file (.mtd) found at the given path.
+/// @param[in] metadataFilePath the path to the .mtd file.
+/// @param[out] outSheetRows the parsed rows.
+/// @returns whether the metadata file was found.
+bool ReadSheetMetadataFile(const std::string& metadataFilePath, std::vector<SheetRowDescriptor>& outSheetRows);
+
+///------------------------------------------------------------------------------------------------
+/// Parses the per asset format override file (.fmt), which holds the name of
+/// one of the formats (e.g. "rgb565") that the texture should be stored in
+/// regardless of what the automatic format selection would pick.
+/// @param[in] formatOverrideFilePath the path to the .fmt file.
+/// @param[out] outFormat the overriden format.
+/// @returns whether a valid override file was found.
+bool ReadFormatOverrideFile(const std::string& formatOverrideFilePath, CookedTextureFormat& outFormat);
+
+///------------------------------------------------------------------------------------------------
+/// Analyzes the given pixels and picks the narrowest uncompressed format
+/// that can represent them without any loss.
+/// @param[in] rgbaPixels tightly packed RGBA8 pixel data of width * height pixels.
+/// @param[in] width the width of the image.
+/// @param[in] height the height of the image.
+/// @returns the narrowest lossless format.
+CookedTextureFormat SelectNarrowestLosslessFormat(const unsigned char* rgbaPixels, const uint32_t width, const uint32_t height);
+
+///------------------------------------------------------------------------------------------------
+/// Computes the size of the given format's data for a single mip level.
+/// @param[in] format the format to check.
+/// @param[in] width the width of the mip level.
+/// @param[in] height the height of the mip level.
+/// @returns the byte size of the mip level.
+uint32_t GetMipLevelByteSize(const CookedTextureFormat format, const uint32_t width, const uint32_t height);
+
+///------------------------------------------------------------------------------------------------
+/// Reads a cooked texture container from disk.
+/// @param[in] cookedTexturePath the path to the .ctx file.
+/// @param[out] outCookedTexture the deserialized container.
+/// @returns whether the container could be read and was valid.
+bool ReadCookedTexture(const std::string& cookedTexturePath, CookedTexture& outCookedTexture);
+
+///------------------------------------------------------------------------------------------------
+/// Writes a cooked texture container to disk.
+/// @param[in] cookedTexturePath the path to write the .ctx file to.
+/// @param[in] cookedTexture the container to serialize.
+/// @returns whether the container was written successfully.
+bool WriteCookedTexture(const std::string& cookedTexturePath, const CookedTexture& cookedTexture);
+
+///------------------------------------------------------------------------------------------------
+/// Cooks the given RGBA8 pixels in to the requested format, optionally baking the full mip chain.
+/// @param[in] rgbaPixels tightly packed RGBA8 pixel data of width * height pixels.
+/// @param[in] width the width of the source image.
+/// @param[in] height the height of the source image.
+/// @param[in] format the target format of all mip levels.
+/// @param[in] generateMipMaps whether to bake the full mip chain or not.
+/// @param[in] sheetRows the sprite sheet metadata to embed (can be empty).
+/// @returns the cooked texture.
+CookedTexture CookTexture(const unsigned char* rgbaPixels, const uint32_t width, const uint32_t height, const CookedTextureFormat format, const bool generateMipMaps, const std::vector<SheetRowDescriptor>& sheetRows);
+
+///------------------------------------------------------------------------------------------------
+/// Decodes a single mip level of a cooked texture back to tightly packed RGBA8. Used
+/// when the GL implementation lacks support for a cooked format, and for inspecting
+/// cooked assets on machines without a GPU.
+/// @param[in] cookedTexture the cooked texture.
+/// @param[in] mipLevel the mip level to decode.
+/// @returns the decoded RGBA8 pixels.
+std::vector<unsigned char> DecodeMipLevelToRGBA8(const CookedTexture& cookedTexture, const size_t mipLevel);
+
+///------------------------------------------------------------------------------------------------
+/// Computes the pixel dimensions of the given mip level.
+/// @param[in] cookedTexture the cooked texture.
+/// @param[in] mipLevel the mip level.
+/// @param[out] outWidth the width of the mip level.
+/// @param[out] outHeight the height of the mip level.
+void GetMipLevelDimensions(const CookedTexture& cookedTexture, const size_t mipLevel, uint32_t& outWidth, uint32_t& outHeight);
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* CookedTexture_h */
@@ -5,14 +5,12 @@
 ///  Created by Alex Koukoulas on 20/11/2019.
 ///-----------------------------------------------------------------------------------------------
 
+#include "AssetArchive.h"
 #include "DataFileLoader.h"
 #include "DataFileResource.h"
 #include "../utils/OSMessageBox.h"
 #include "../utils/StringUtils.h"
 
-#include <fstream>   // ifstream
-#include <streambuf> // istreambuf_iterator
-
 ///-----------------------------------------------------------------------------------------------
 
 namespace resources
@@ -27,22 +25,15 @@ void DataFileLoader::VInitialize()
 
 std::unique_ptr<IResource> DataFileLoader::VCreateAndLoadResource(const std::string& resourcePath) const
 {
-    std::ifstream file(resourcePath);
+    ResourceFile file(resourcePath);
     
-    if (!file.good())
+    if (!file.IsValid())
     {
         ospopups::ShowMessageBox(ospopups::MessageBoxType::ERROR, "File could not be found", resourcePath.c_str());
         return nullptr;
     }
     
-    std::string str;
-    
-    file.seekg(0, std::ios::end);
-    str.reserve(static_cast<size_t>(file.tellg()));
-    file.seekg(0, std::ios::beg);
-    
-    str.assign((std::istreambuf_iterator<char>(file)),
-               std::istreambuf_iterator<char>());
+    std::string str(file.GetContents());
     
     return std::unique_ptr<IResource>(new DataFileResource(str));
 }
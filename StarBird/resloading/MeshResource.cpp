@@ -6,6 +6,7 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "MeshResource.h"
+#include "ShaderResource.h"
 #include "../utils/OpenGL.h"
 
 ///------------------------------------------------------------------------------------------------
@@ -21,27 +22,69 @@ void MeshResource::ApplyDirectTransformToData(std::function<void(MeshData&)> tra
     {
         transform(*mMeshData);
         
-        GL_CALL(glBindVertexArray(mVertexArrayObject));
+        mVertexLayout.PackInterleavedData(mMeshData->mVertices, mMeshData->mTexCoords, mMeshData->mNormals, mMeshData->mInterleavedData);
         
-        // Bind and Buffer VBO
-        GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, mMeshData->mVertexBufferId));
-        GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, mMeshData->mVertices.size() * sizeof(glm::vec3), &mMeshData->mVertices[0]));
+        // Headless meshes have no GL buffers to update
+        if (mVertexArrayObject == 0)
+        {
+            return;
+        }
         
-        GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, mMeshData->mTexCoordBufferId));
-        GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, mMeshData->mTexCoords.size() * sizeof(glm::vec2), &mMeshData->mTexCoords[0]));
+        GL_CALL(glBindVertexArray(mVertexArrayObject));
         
-        GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, mMeshData->mNormalBufferId));
-        GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, mMeshData->mNormals.size() * sizeof(glm::vec3), &mMeshData->mNormals[0]));
+        // Bind and Buffer the interleaved VBO
+        GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, mMeshData->mVertexBufferId));
+        GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, mMeshData->mInterleavedData.size(), &mMeshData->mInterleavedData[0]));
         
         GL_CALL(glBindVertexArray(0));
+        
+        // Normals only need re-streaming once a shader has read them
+        if (mNormalsBufferObject != 0)
+        {
+            VertexLayout::PackSeparateAttributeData(VertexAttributeFormat::NORMALIZED_INT_2_10_10_10, mMeshData->mNormals, mPackedNormals);
+            
+            GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, mNormalsBufferObject));
+            GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, mPackedNormals.size(), &mPackedNormals[0]));
+        }
     }
 }
 
 ///------------------------------------------------------------------------------------------------
 
-GLuint MeshResource::GetVertexArrayObject() const
+GLuint MeshResource::GetVertexArrayObject(const ShaderResource& shader)
 {
-    return mVertexArrayObject;
+    if (mVertexArrayObject == 0 || !shader.ReadsVertexAttribute(VertexAttribute::NORMAL) || mVertexLayout.GetAttributeFormat(VertexAttribute::NORMAL) != VertexAttributeFormat::NONE)
+    {
+        return mVertexArrayObject;
+    }
+    
+    if (mNormalsVertexArrayObject == 0)
+    {
+        // Same vertices & indices as the main VAO, plus the normals from a buffer of their own
+        GL_CALL(glGenVertexArrays(1, &mNormalsVertexArrayObject));
+        GL_CALL(glGenBuffers(1, &mNormalsBufferObject));
+        
+        GL_CALL(glBindVertexArray(mNormalsVertexArrayObject));
+        
+        GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, mVertexBufferObject));
+        mVertexLayout.ApplyToBoundVertexArrayObject();
+        
+        GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, mNormalsBufferObject));
+        GL_CALL(glBufferData(GL_ARRAY_BUFFER, mPackedNormals.size(), &mPackedNormals[0], mMeshData ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW));
+        VertexLayout::ApplySeparateAttributeToBoundVertexArrayObject(VertexAttribute::NORMAL, VertexAttributeFormat::NORMALIZED_INT_2_10_10_10);
+        
+        GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBufferObject));
+        
+        GL_CALL(glBindVertexArray(0));
+        
+        // Dynamic meshes re-pack theirs on every transform, the static ones are done with them
+        if (!mMeshData)
+        {
+            std::vector<unsigned char>().swap(mPackedNormals);
+        }
+    }
+    
+    return mNormalsVertexArrayObject;
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -60,6 +103,13 @@ const glm::vec3& MeshResource::GetDimensions() const
 
 ///------------------------------------------------------------------------------------------------
 
+const VertexLayout& MeshResource::GetVertexLayout() const
+{
+    return mVertexLayout;
+}
+
+///------------------------------------------------------------------------------------------------
+
 const std::vector<glm::vec3>& MeshResource::GetMeshVertices() const
 {
     static std::vector<glm::vec3> emptyVertices;
@@ -86,10 +136,14 @@ const std::vector<glm::vec3>& MeshResource::GetMeshNormals() const
 
 ///------------------------------------------------------------------------------------------------
 
-MeshResource::MeshResource(const GLuint vertexArrayObject, const GLuint elementCount, const glm::vec3& meshDimensions, std::unique_ptr<MeshData> meshData /* = nullptr */)
+MeshResource::MeshResource(const GLuint vertexArrayObject, const GLuint vertexBufferObject, const GLuint indexBufferObject, const GLuint elementCount, const glm::vec3& meshDimensions, const VertexLayout& vertexLayout, std::vector<unsigned char>&& packedNormals, std::unique_ptr<MeshData> meshData /* = nullptr */)
     : mVertexArrayObject(vertexArrayObject)
+    , mVertexBufferObject(vertexBufferObject)
+    , mIndexBufferObject(indexBufferObject)
     , mElementCount(elementCount)
     , mDimensions(meshDimensions)
+    , mVertexLayout(vertexLayout)
+    , mPackedNormals(std::move(packedNormals))
     , mMeshData(std::move(meshData))
 {
 }
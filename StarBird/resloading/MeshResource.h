@@ -11,6 +11,7 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "IResource.h"
+#include "VertexLayout.h"
 #include "../utils/MathUtils.h"
 
 #include <memory>
@@ -24,6 +25,12 @@ namespace resources
 
 using GLuint = unsigned int;
 
+class ShaderResource;
+
+///------------------------------------------------------------------------------------------------
+
+/// Normals are kept out of the mesh's interleaved vertices. They are only streamed (from a buffer
+/// of their own, created on first use) to the shaders that actually read them.
 class MeshResource final: public IResource
 {
     friend class OBJMeshLoader;
@@ -31,10 +38,8 @@ class MeshResource final: public IResource
 public:
     struct MeshData
     {
-        MeshData(const GLuint vertexBufferId, const GLuint texCoordBufferId, const GLuint normalBufferId, const std::vector<glm::vec3>& orderedVertices, const std::vector<glm::vec2>& orderedTexCoords, const std::vector<glm::vec3>& orderedNormals)
+        MeshData(const GLuint vertexBufferId, const std::vector<glm::vec3>& orderedVertices, const std::vector<glm::vec2>& orderedTexCoords, const std::vector<glm::vec3>& orderedNormals)
             : mVertexBufferId(vertexBufferId)
-            , mTexCoordBufferId(texCoordBufferId)
-            , mNormalBufferId(normalBufferId)
             , mVertices(orderedVertices)
             , mTexCoords(orderedTexCoords)
             , mNormals(orderedNormals)
@@ -42,30 +47,40 @@ public:
         }
         
         const GLuint mVertexBufferId;
-        const GLuint mTexCoordBufferId;
-        const GLuint mNormalBufferId;
         std::vector<glm::vec3> mVertices;
         std::vector<glm::vec2> mTexCoords;
         std::vector<glm::vec3> mNormals;
+        
+        // Scratch buffer for re-interleaving the above on every transform
+        std::vector<unsigned char> mInterleavedData;
     };
     
 public:
     void ApplyDirectTransformToData(std::function<void(MeshData&)> transform);
     
-    GLuint GetVertexArrayObject() const;
+    /// @param[in] shader the shader the mesh is about to be drawn with.
+    /// @returns the VAO feeding the mesh's vertices to the given shader, with normals if it reads them.
+    GLuint GetVertexArrayObject(const ShaderResource& shader);
     GLuint GetElementCount() const;
     const glm::vec3& GetDimensions() const;
+    const VertexLayout& GetVertexLayout() const;
     const std::vector<glm::vec3>& GetMeshVertices() const;
     const std::vector<glm::vec3>& GetMeshNormals() const;
     
 private:
-    MeshResource(const GLuint vertexArrayObject, const GLuint elementCount, const glm::vec3& meshDimensions, std::unique_ptr<MeshData> meshData = nullptr);
+    MeshResource(const GLuint vertexArrayObject, const GLuint vertexBufferObject, const GLuint indexBufferObject, const GLuint elementCount, const glm::vec3& meshDimensions, const VertexLayout& vertexLayout, std::vector<unsigned char>&& packedNormals, std::unique_ptr<MeshData> meshData = nullptr);
     
 private:
     const GLuint mVertexArrayObject;
+    const GLuint mVertexBufferObject;
+    const GLuint mIndexBufferObject;
     const GLuint mElementCount;
     const glm::vec3 mDimensions;
+    const VertexLayout mVertexLayout;
+    std::vector<unsigned char> mPackedNormals;
     std::unique_ptr<MeshData> mMeshData;
+    GLuint mNormalsVertexArrayObject = 0;
+    GLuint mNormalsBufferObject = 0;
 };
 
 ///------------------------------------------------------------------------------------------------
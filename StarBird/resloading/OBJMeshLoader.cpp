@@ -5,13 +5,10 @@
 ///  Created by Alex Koukoulas on 20/11/2019.
 ///------------------------------------------------------------------------------------------------
 
-// Disable CRT_SECURE warnings for fopen, fscanf etc..
-#ifdef _WIN32
-#pragma warning(disable: 4996)
-#endif
-
+#include "AssetArchive.h"
 #include "OBJMeshLoader.h"
 #include "MeshResource.h"
+#include "ResourceLoadingService.h"
 #include "../utils/FileUtils.h"
 #include "../utils/MathUtils.h"
 #include "../utils/OpenGL.h"
@@ -19,7 +16,8 @@
 #include "../utils/StringUtils.h"
 
 #include <cassert>
-#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <vector>
 
 ///------------------------------------------------------------------------------------------------
@@ -29,6 +27,38 @@ namespace resources
 
 ///------------------------------------------------------------------------------------------------
 
+static bool LineStartsWith(const char* line, const char* lineHeader)
+{
+    const auto lineHeaderLength = std::strlen(lineHeader);
+    return std::strncmp(line, lineHeader, lineHeaderLength) == 0 && (line[lineHeaderLength] == ' ' || line[lineHeaderLength] == '\t');
+}
+
+///------------------------------------------------------------------------------------------------
+
+static float ParseFloat(const char*& cursor)
+{
+    char* parseEnd = nullptr;
+    const auto value = std::strtof(cursor, &parseEnd);
+    cursor = parseEnd;
+    return value;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static bool ParseFaceIndex(const char*& cursor, const char* lineEnd, unsigned int& outIndex)
+{
+    char* parseEnd = nullptr;
+    outIndex = static_cast<unsigned int>(std::strtoul(cursor, &parseEnd, 10));
+    
+    const auto parsed = parseEnd != cursor && parseEnd <= lineEnd;
+    cursor = parseEnd;
+    
+    if (*cursor == '/') ++cursor;
+    return parsed;
+}
+
+///------------------------------------------------------------------------------------------------
+
 void OBJMeshLoader::VInitialize()
 {
 }
@@ -52,9 +82,10 @@ std::unique_ptr<IResource> OBJMeshLoader::VCreateAndLoadResource(const std::stri
     
     float minX = 100.0f, maxX = -100.0f, minY = 100.0f, maxY = -100.0f, minZ = 100.0f, maxZ = -100.0f;
     
-    FILE * file = std::fopen(trimmedPath.c_str(), "r");
+    // Parsed in place, straight out of the (NUL terminated) file contents
+    ResourceFile file(trimmedPath);
     
-    if (!file)
+    if (!file.IsValid())
     {
         ospopups::ShowMessageBox(ospopups::MessageBoxType::ERROR, "File could not be found", path.c_str());
         return nullptr;
@@ -63,19 +94,23 @@ std::unique_ptr<IResource> OBJMeshLoader::VCreateAndLoadResource(const std::stri
     const auto fileNameWithoutExtension = fileutils::GetFileNameWithoutExtension(path);
     bool dynamicMesh = strutils::StringContains(fileNameWithoutExtension, "dynamic");
     
-    while(1)
+    const char* cursor = file.GetData();
+    const char* fileEnd = file.GetData() + file.GetSize();
+    
+    while (cursor < fileEnd)
     {
-        char lineHeader[128];
-        // read the first word of the line
-        int res = fscanf(file, "%s", lineHeader);
-        if (res == EOF)
-            break; // EOF = End Of File. Quit the loop.
+        const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', fileEnd - cursor));
+        if (!lineEnd) lineEnd = fileEnd;
         
-        if (strcmp(lineHeader, "v") == 0)
+        while (*cursor == ' ' || *cursor == '\t') ++cursor;
+        
+        if (LineStartsWith(cursor, "v"))
         {
+            cursor += 1;
             glm::vec3 vertex;
-            fscanf(file, "%f %f %f\n", &vertex.x, &vertex.y, &vertex.z );
-            //vertex.z = -vertex.z;
+            vertex.x = ParseFloat(cursor);
+            vertex.y = ParseFloat(cursor);
+            vertex.z = ParseFloat(cursor);
             tempVertices.push_back(vertex);
             
             if (vertex.x < minX) minX = vertex.x;
@@ -85,27 +120,39 @@ std::unique_ptr<IResource> OBJMeshLoader::VCreateAndLoadResource(const std::stri
             if (vertex.z < minZ) minZ = vertex.z;
             if (vertex.z > maxZ) maxZ = vertex.z;
         }
-        else if (strcmp(lineHeader, "vt") == 0)
+        else if (LineStartsWith(cursor, "vt"))
         {
+            cursor += 2;
             glm::vec2 uv;
-            fscanf(file, "%f %f\n", &uv.x, &uv.y );
+            uv.x = ParseFloat(cursor);
+            uv.y = ParseFloat(cursor);
             tempUvs.push_back(uv);
         }
-        else if (strcmp(lineHeader, "vn") == 0)
+        else if (LineStartsWith(cursor, "vn"))
         {
+            cursor += 2;
             glm::vec3 normal;
-            fscanf(file, "%f %f %f\n", &normal.x, &normal.y, &normal.z );
+            normal.x = ParseFloat(cursor);
+            normal.y = ParseFloat(cursor);
+            normal.z = ParseFloat(cursor);
             tempNormals.push_back(normal);
         }
-        else if (strcmp(lineHeader, "f") == 0)
+        else if (LineStartsWith(cursor, "f"))
         {
-            std::string vertex1, vertex2, vertex3;
+            cursor += 1;
             unsigned int vertexIndex[3], uvIndex[3], normalIndex[3];
-            int matches = fscanf(file, "%d/%d/%d %d/%d/%d %d/%d/%d\n", &vertexIndex[0], &uvIndex[0], &normalIndex[0], &vertexIndex[1], &uvIndex[1], &normalIndex[1], &vertexIndex[2], &uvIndex[2], &normalIndex[2] );
+            int matches = 0;
+            for (int i = 0; i < 3; ++i)
+            {
+                matches += ParseFaceIndex(cursor, lineEnd, vertexIndex[i]);
+                matches += ParseFaceIndex(cursor, lineEnd, uvIndex[i]);
+                matches += ParseFaceIndex(cursor, lineEnd, normalIndex[i]);
+            }
+            
             if (matches != 9)
             {
                 assert(false && "File can't be read by this simple parser");
-                fclose(file);
+                return nullptr;
             }
             
             vertexIndices.push_back(vertexIndex[0]);
@@ -120,12 +167,9 @@ std::unique_ptr<IResource> OBJMeshLoader::VCreateAndLoadResource(const std::stri
             normalIndices.push_back(normalIndex[1]);
             normalIndices.push_back(normalIndex[2]);
         }
-        else
-        {
-            // Probably a comment, eat up the rest of the line
-            char stupidBuffer[1000];
-            fgets(stupidBuffer, 1000, file);
-        }
+        
+        // Anything else is probably a comment, so skip the rest of the line either way
+        cursor = lineEnd + 1;
     }
     
     // For each vertex of each triangle
@@ -148,67 +192,58 @@ std::unique_ptr<IResource> OBJMeshLoader::VCreateAndLoadResource(const std::stri
         finalIndices.push_back(static_cast<unsigned short>(i));
     }
     
-    std::fclose(file);
-    
-    GLuint vertexArrayObject;
-    GLuint vertexBufferObject;
-    GLuint uvCoordsBufferObject;
-    GLuint normalsBufferObject;
-    GLuint indexBufferObject;
-    
-    GLenum usage = dynamicMesh ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
-    
-    // Create Buffers
-    GL_CALL(glGenVertexArrays(1, &vertexArrayObject));
-    GL_CALL(glGenBuffers(1, &vertexBufferObject));
-    GL_CALL(glGenBuffers(1, &uvCoordsBufferObject));
-    GL_CALL(glGenBuffers(1, &normalsBufferObject));
-    GL_CALL(glGenBuffers(1, &indexBufferObject));
-    
-    // Prepare VAO to record buffer state
-    GL_CALL(glBindVertexArray(vertexArrayObject));
-    
-    // Bind and Buffer VBO
-    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vertexBufferObject));
-    GL_CALL(glBufferData(GL_ARRAY_BUFFER, finalVertices.size() * sizeof(glm::vec3), &finalVertices[0], usage));
-    
-    // 1st attribute buffer : vertices
-    GL_CALL(glEnableVertexAttribArray(0));
-    GL_CALL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0));
+    // Normals are left out of the interleaved vertex, since most shaders don't read them. They are
+    // kept packed on the side instead, for the mesh to stream them only to the shaders that do.
+    const auto vertexLayout = VertexLayout::CreateCompactLayout(finalUvs, false);
     
-    // Bind and buffer TBO
-    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, uvCoordsBufferObject));
-    GL_CALL(glBufferData(GL_ARRAY_BUFFER, finalUvs.size() * sizeof(glm::vec2), &finalUvs[0], usage));
+    std::vector<unsigned char> interleavedData;
+    vertexLayout.PackInterleavedData(finalVertices, finalUvs, finalNormals, interleavedData);
     
-    // 2nd attribute buffer: tex coords
-    GL_CALL(glEnableVertexAttribArray(1));
-    GL_CALL(glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, (void*)0));
+    std::vector<unsigned char> packedNormals;
+    VertexLayout::PackSeparateAttributeData(VertexAttributeFormat::NORMALIZED_INT_2_10_10_10, finalNormals, packedNormals);
     
-    // Bind and Buffer NBO
-    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, normalsBufferObject));
-    GL_CALL(glBufferData(GL_ARRAY_BUFFER, finalNormals.size() * sizeof(glm::vec3), &finalNormals[0], usage));
+    GLuint vertexArrayObject = 0;
+    GLuint vertexBufferObject = 0;
+    GLuint indexBufferObject = 0;
     
-    // 3rd attribute buffer: normals
-    GL_CALL(glEnableVertexAttribArray(2));
-    GL_CALL(glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, (void*)0));
-    
-    // Bind and Buffer IBO
-    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferObject));
-    GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, finalIndices.size() * sizeof(unsigned short), &finalIndices[0], usage));
-    
-    GL_CALL(glBindVertexArray(0));
+    // Headless meshes keep their data and dimensions, just not any GL buffers
+    if (!ResourceLoadingService::GetInstance().IsHeadless())
+    {
+        GLenum usage = dynamicMesh ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
+        
+        // Create Buffers
+        GL_CALL(glGenVertexArrays(1, &vertexArrayObject));
+        GL_CALL(glGenBuffers(1, &vertexBufferObject));
+        GL_CALL(glGenBuffers(1, &indexBufferObject));
+        
+        // Prepare VAO to record buffer state
+        GL_CALL(glBindVertexArray(vertexArrayObject));
+        
+        // Bind and Buffer the interleaved VBO
+        GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vertexBufferObject));
+        GL_CALL(glBufferData(GL_ARRAY_BUFFER, interleavedData.size(), &interleavedData[0], usage));
+        
+        // Attribute pointers: vertices, tex coords, normals
+        vertexLayout.ApplyToBoundVertexArrayObject();
+        
+        // Bind and Buffer IBO
+        GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferObject));
+        GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, finalIndices.size() * sizeof(unsigned short), &finalIndices[0], usage));
+        
+        GL_CALL(glBindVertexArray(0));
+    }
     
     // Decide whether to forward all mesh data as well
     std::unique_ptr<MeshResource::MeshData> meshData = nullptr;
     
     if (dynamicMesh)
     {
-        meshData = std::make_unique<MeshResource::MeshData>(vertexBufferObject, uvCoordsBufferObject, normalsBufferObject, finalVertices, finalUvs, finalNormals);
+        meshData = std::make_unique<MeshResource::MeshData>(vertexBufferObject, finalVertices, finalUvs, finalNormals);
     }
     
     // Calculate dimensions
     glm::vec3 meshDimensions(math::Abs(minX - maxX), math::Abs(minY - maxY), math::Abs(minZ - maxZ));
-    return std::unique_ptr<MeshResource>(new MeshResource(vertexArrayObject, (GLuint)finalIndices.size(), meshDimensions, std::move(meshData)));
+    return std::unique_ptr<MeshResource>(new MeshResource(vertexArrayObject, vertexBufferObject, indexBufferObject, (GLuint)finalIndices.size(), meshDimensions, vertexLayout, std::move(packedNormals), std::move(meshData)));
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -6,6 +6,7 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "ResourceLoadingService.h"
+#include "AssetArchive.h"
 #include "DataFileLoader.h"
 #include "IResource.h"
 #include "OBJMeshLoader.h"
@@ -18,11 +19,8 @@
 #include "../utils/StringUtils.h"
 #include "../utils/TypeTraits.h"
 
-#include <fstream>
 #include <cassert>
 
-//#define UNZIP_FLOW
-
 ///------------------------------------------------------------------------------------------------
 
 namespace resources
@@ -45,14 +43,12 @@ const ResourceId ResourceLoadingService::FALLBACK_TEXTURE_ID = 0;
 const ResourceId ResourceLoadingService::FALLBACK_SHADER_ID  = 1;
 const ResourceId ResourceLoadingService::FALLBACK_MESH_ID    = 2;
 
-static const std::string ZIPPED_ASSETS_FILE_NAME = "assets.zip";
-
 ///------------------------------------------------------------------------------------------------
 
 ResourceLoadingService& ResourceLoadingService::GetInstance()
 {
     static ResourceLoadingService instance;
-    if (!instance.mInitialized) instance.Initialize();
+    std::call_once(instance.mInitializationFlag, [&](){ instance.Initialize(); });
     return instance;
 }
 
@@ -68,9 +64,12 @@ void ResourceLoadingService::Initialize()
 {
     using namespace strutils;
     
-#ifdef UNZIP_FLOW
-    objectiveC_utils::UnzipAssets((RES_ROOT + ZIPPED_ASSETS_FILE_NAME).c_str(), RES_ROOT.c_str());
-#endif
+    // Shipped builds pack all assets in a single memory mapped archive. Anything
+    // not found in there (or everything, when no archive is present) is read as a loose file.
+    if (AssetArchive::GetInstance().Mount(RES_ROOT + asset_archive::ASSET_ARCHIVE_FILE_NAME, RES_ROOT))
+    {
+        Log(LogType::INFO, "Mounted asset archive %s", (RES_ROOT + asset_archive::ASSET_ARCHIVE_FILE_NAME).c_str());
+    }
     
     // No make unique due to constructing the loaders with their private constructors
     // via friendship
@@ -81,6 +80,7 @@ void ResourceLoadingService::Initialize()
     
     // Map resource extensions to loaders
     mResourceExtensionsToLoadersMap[StringId("bmp")]  = mResourceLoaders[0].get();
+    mResourceExtensionsToLoadersMap[StringId("ctx")]  = mResourceLoaders[0].get();
     mResourceExtensionsToLoadersMap[StringId("json")] = mResourceLoaders[1].get();
     mResourceExtensionsToLoadersMap[StringId("dat")]  = mResourceLoaders[1].get();
     mResourceExtensionsToLoadersMap[StringId("lua")]  = mResourceLoaders[1].get();
@@ -93,8 +93,6 @@ void ResourceLoadingService::Initialize()
     {
         resourceLoader->VInitialize();
     }
-    
-    mInitialized = true;
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -111,6 +109,7 @@ ResourceId ResourceLoadingService::LoadResource(const std::string& resourcePath)
     const auto adjustedPath = AdjustResourcePath(resourcePath);
     const auto resourceId = strutils::GetStringHash(adjustedPath);
     
+    std::lock_guard<std::recursive_mutex> lock(mResourceMutex);
     if (mResourceMap.count(resourceId))
     {
         return resourceId;
@@ -136,9 +135,7 @@ void ResourceLoadingService::LoadResources(const std::vector<std::string>& resou
 
 bool ResourceLoadingService::DoesResourceExist(const std::string& resourcePath) const
 {
-    const auto adjustedPath = AdjustResourcePath(resourcePath);
-    std::fstream resourceFileCheck(resourcePath);
-    return resourceFileCheck.operator bool();
+    return ResourceFile::Exists(resourcePath);
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -148,16 +145,34 @@ bool ResourceLoadingService::HasLoadedResource(const std::string& resourcePath)
     const auto adjustedPath = AdjustResourcePath(resourcePath);
     const auto resourceId = strutils::GetStringHash(adjustedPath);
     
+    std::lock_guard<std::recursive_mutex> lock(mResourceMutex);
     return mResourceMap.count(resourceId) != 0;
 }
 
 ///------------------------------------------------------------------------------------------------
 
+bool ResourceLoadingService::HasLoadedResource(const ResourceId resourceId) const
+{
+    std::lock_guard<std::recursive_mutex> lock(mResourceMutex);
+    return mResourceMap.count(resourceId) != 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::string ResourceLoadingService::GetResourcePath(const ResourceId resourceId) const
+{
+    std::lock_guard<std::recursive_mutex> lock(mResourceMutex);
+    auto findIter = mResourcePaths.find(resourceId);
+    return findIter != mResourcePaths.end() ? findIter->second : std::string();
+}
+
+///------------------------------------------------------------------------------------------------
+
 void ResourceLoadingService::UnloadResource(const std::string& resourcePath)
 {
     const auto adjustedPath = AdjustResourcePath(resourcePath);
     const auto resourceId = strutils::GetStringHash(adjustedPath);
-    mResourceMap.erase(resourceId);
+    UnloadResource(resourceId);
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -165,31 +180,77 @@ void ResourceLoadingService::UnloadResource(const std::string& resourcePath)
 void ResourceLoadingService::UnloadResource(const ResourceId resourceId)
 {
     Log(LogType::INFO, "Unloading asset: %s", std::to_string(resourceId).c_str());
+    
+    std::lock_guard<std::recursive_mutex> lock(mResourceMutex);
     mResourceMap.erase(resourceId);
 }
 
 ///------------------------------------------------------------------------------------------------
 
+void ResourceLoadingService::AcquireResource(const ResourceId resourceId)
+{
+    std::lock_guard<std::recursive_mutex> lock(mResourceMutex);
+    
+    auto pathIter = mResourcePaths.find(resourceId);
+    if (mResourceMap.count(resourceId) == 0 && pathIter != mResourcePaths.end())
+    {
+        LoadResourceInternal(pathIter->second, resourceId);
+    }
+    
+    mResourceOwnerCounts[resourceId]++;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ResourceLoadingService::ReleaseResource(const ResourceId resourceId)
+{
+    std::lock_guard<std::recursive_mutex> lock(mResourceMutex);
+    
+    auto ownerCountIter = mResourceOwnerCounts.find(resourceId);
+    if (ownerCountIter == mResourceOwnerCounts.end() || --ownerCountIter->second <= 0)
+    {
+        if (ownerCountIter != mResourceOwnerCounts.end())
+        {
+            mResourceOwnerCounts.erase(ownerCountIter);
+        }
+        
+        UnloadResource(resourceId);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
 void ResourceLoadingService::SetFallbackTexture(const std::string& fallbackTexturePath)
 {
-    auto adjustedPath = AdjustResourcePath(fallbackTexturePath);
-    LoadResourceInternal(adjustedPath, FALLBACK_TEXTURE_ID);
+    SetFallbackResource(fallbackTexturePath, FALLBACK_TEXTURE_ID);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void ResourceLoadingService::SetFallbackShader(const std::string& fallbackShaderPath)
 {
-    auto adjustedPath = AdjustResourcePath(fallbackShaderPath);
-    LoadResourceInternal(adjustedPath, FALLBACK_SHADER_ID);
+    SetFallbackResource(fallbackShaderPath, FALLBACK_SHADER_ID);
 }
 
 ///------------------------------------------------------------------------------------------------
 
 void ResourceLoadingService::SetFallbackMesh(const std::string& fallbackMeshPath)
 {
-    auto adjustedPath = AdjustResourcePath(fallbackMeshPath);
-    LoadResourceInternal(adjustedPath, FALLBACK_MESH_ID);
+    SetFallbackResource(fallbackMeshPath, FALLBACK_MESH_ID);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void ResourceLoadingService::SetHeadless(const bool headless)
+{
+    mHeadless = headless;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool ResourceLoadingService::IsHeadless() const
+{
+    return mHeadless;
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -205,6 +266,15 @@ IResource& ResourceLoadingService::GetResource(const std::string& resourcePath)
 
 IResource& ResourceLoadingService::GetResource(const ResourceId resourceId)
 {
+    std::lock_guard<std::recursive_mutex> lock(mResourceMutex);
+    
+    // Resources used by one game instance may have been unloaded by another one's scene change
+    auto pathIter = mResourcePaths.find(resourceId);
+    if (mResourceMap.count(resourceId) == 0 && pathIter != mResourcePaths.end())
+    {
+        LoadResourceInternal(pathIter->second, resourceId);
+    }
+    
     if (mResourceMap.count(resourceId))
     {
         return *mResourceMap[resourceId];
@@ -216,6 +286,21 @@ IResource& ResourceLoadingService::GetResource(const ResourceId resourceId)
 
 ///------------------------------------------------------------------------------------------------
 
+void ResourceLoadingService::SetFallbackResource(const std::string& fallbackResourcePath, const ResourceId fallbackResourceId)
+{
+    // Every scene change sets the fallbacks again, which must not swap them out from under the other game instances
+    const auto adjustedPath = AdjustResourcePath(fallbackResourcePath);
+    
+    std::lock_guard<std::recursive_mutex> lock(mResourceMutex);
+    auto pathIter = mResourcePaths.find(fallbackResourceId);
+    if (mResourceMap.count(fallbackResourceId) == 0 || pathIter == mResourcePaths.end() || pathIter->second != adjustedPath)
+    {
+        LoadResourceInternal(adjustedPath, fallbackResourceId);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
 void ResourceLoadingService::LoadResourceInternal(const std::string& resourcePath, const ResourceId resourceId)
 {
     // Get resource extension
@@ -231,6 +316,7 @@ void ResourceLoadingService::LoadResourceInternal(const std::string& resourcePat
         auto localSaveFilePath = objectiveC_utils::GetLocalFileSaveLocation();
         auto loadedResource = selectedLoader->VCreateAndLoadResource(strutils::StringStartsWith(resourcePath, localSaveFilePath) ? resourcePath : (RES_ROOT + resourcePath));
         mResourceMap[resourceId] = std::move(loadedResource);
+        mResourcePaths[resourceId] = resourcePath;
         Log(LogType::INFO, "Loading asset: %s in %s", resourcePath.c_str(), std::to_string(resourceId).c_str());
     }
     else
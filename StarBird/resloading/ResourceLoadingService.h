@@ -12,7 +12,9 @@
 
 #include "../utils/StringUtils.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>        
 #include <unordered_map>
 #include <vector>
@@ -40,6 +42,8 @@ struct ResourceIdHasher
 
 ///------------------------------------------------------------------------------------------------
 /// A service class aimed at providing resource loading, simple file IO, etc.
+///
+/// Shared by all game instances in the process, so all of its methods are thread safe.
 class ResourceLoadingService final
 {
 public:
@@ -61,7 +65,7 @@ public:
     /// The default method of getting a hold of this singleton.
     ///
     /// The single instance of this class will be lazily initialized
-    /// the first time it is needed.
+    /// the first time it is needed (by whichever thread gets there first).
     /// @returns a reference to the single instance of this class.    
     static ResourceLoadingService& GetInstance();
 
@@ -110,6 +114,19 @@ public:
     /// @returns whether or not the resource has been loaded.
     bool HasLoadedResource(const std::string& resourcePath) const;
     
+    /// Checks whether a resource with the given id has been loaded.
+    /// @param[in] resourceId the id of the resource.
+    /// @returns whether or not the resource has been loaded.
+    bool HasLoadedResource(const ResourceId resourceId) const;
+    
+    /// Gets the (adjusted) path a resource was last loaded from.
+    ///
+    /// Used to reload resources referenced by id only (e.g. in level snapshots)
+    /// after they have been unloaded.
+    /// @param[in] resourceId the id of the resource.
+    /// @returns the path the resource was loaded from, or an empty string if it has never been loaded.
+    std::string GetResourcePath(const ResourceId resourceId) const;
+    
     /// Unloads the specified resource loaded based on the given path.
     ///
     /// Any subsequent calls to get that
@@ -128,6 +145,20 @@ public:
     /// @param[in] resourceId the id of the resource to unload.    
     void UnloadResource(const ResourceId resourceId);
     
+    /// Marks a resource as in use by one more owner (e.g. a scene), loading it
+    /// back first if it has been unloaded in the meantime.
+    ///
+    /// Acquired resources only get unloaded once every owner has released them,
+    /// so that a scene change in one game instance never pulls resources out from
+    /// under another one.
+    /// @param[in] resourceId the id of a resource that has been loaded at least once.
+    void AcquireResource(const ResourceId resourceId);
+    
+    /// Releases a resource acquired via AcquireResource, unloading it
+    /// if that was its last owner.
+    /// @param[in] resourceId the id of the resource to release.
+    void ReleaseResource(const ResourceId resourceId);
+    
     /// Sets the fallback texture to be used when one is not provided/can't be found
     ///
     /// @param[in] fallbackTexturePath the path of the debug texture file.
@@ -143,6 +174,17 @@ public:
     /// @param[in] fallbackShaderPath the path of the debug shader file.
     void SetFallbackShader(const std::string& fallbackShaderPath);
     
+    /// Sets whether the service runs headless (i.e. with no GL context around)
+    ///
+    /// Headless loaders skip all GPU uploads, with the loaded textures, meshes
+    /// and shaders keeping their dimensions and metadata but no GL objects.
+    /// @param[in] headless whether the service runs headless.
+    void SetHeadless(const bool headless);
+    
+    /// Checks whether the service runs headless (see SetHeadless).
+    /// @returns whether the service runs headless.
+    bool IsHeadless() const;
+    
     /// Gets the concrete type of the resource that was loaded based on the given path.
     ///    
     /// Both full paths, relative paths including the Resource Root, and relative
@@ -176,6 +218,7 @@ private:
 
     IResource& GetResource(const std::string& resourceRelativePath);
     IResource& GetResource(const ResourceId resourceId);    
+    void SetFallbackResource(const std::string& fallbackResourcePath, const ResourceId fallbackResourceId);
     void LoadResourceInternal(const std::string& resourceRelativePath, const ResourceId resourceId);
    
     // Strips the leading RES_ROOT from the resourcePath given, if present
@@ -183,9 +226,13 @@ private:
     
 private:
     std::unordered_map<ResourceId, std::unique_ptr<IResource>, ResourceIdHasher> mResourceMap;
+    std::unordered_map<ResourceId, std::string, ResourceIdHasher> mResourcePaths;
+    std::unordered_map<ResourceId, int, ResourceIdHasher> mResourceOwnerCounts;
     std::unordered_map<strutils::StringId, IResourceLoader*, strutils::StringIdHasher> mResourceExtensionsToLoadersMap;
     std::vector<std::unique_ptr<IResourceLoader>> mResourceLoaders;
-    bool mInitialized = false;
+    mutable std::recursive_mutex mResourceMutex;
+    std::once_flag mInitializationFlag;
+    std::atomic<bool> mHeadless = false;
 };
 
 ///------------------------------------------------------------------------------------------------
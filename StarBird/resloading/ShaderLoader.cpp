@@ -5,6 +5,7 @@
 ///  Created by Alex Koukoulas on 20/11/2019.
 ///------------------------------------------------------------------------------------------------
 
+#include "AssetArchive.h"
 #include "ShaderLoader.h"
 #include "ResourceLoadingService.h"
 #include "ShaderResource.h"
@@ -13,9 +14,7 @@
 #include "../utils/StringUtils.h"
 #include "../utils/OpenGL.h"
 
-
-#include <fstream>   // ifstream
-#include <streambuf> // istreambuf_iterator
+#include <sstream>   // stringstream
 
 ///------------------------------------------------------------------------------------------------
 
@@ -29,6 +28,7 @@ const std::string ShaderLoader::FRAGMENT_SHADER_FILE_EXTENSION = ".fs";
 
 ///------------------------------------------------------------------------------------------------
 
+static uint32_t GetActiveVertexAttributeMask(const GLuint programId);
 static void ExtractUniformFromLine(const std::string& line, const std::string& shaderName, const GLuint programId, std::unordered_map<strutils::StringId, GLuint, strutils::StringIdHasher>& outUniformNamesToLocations,     std::unordered_map<strutils::StringId, int, strutils::StringIdHasher>& outUniformArrayElementCounts, std::vector<strutils::StringId>& outSamplerNamesInOrder);
 
 ///------------------------------------------------------------------------------------------------
@@ -44,6 +44,12 @@ std::unique_ptr<IResource> ShaderLoader::VCreateAndLoadResource(const std::strin
         // Since the shader loading is signalled by the .vs or .fs extension, we need to trim it here after
     // being added by the ResourceLoadingService prior to this call
     const auto resourcePath = resourcePathWithExtension.substr(0, resourcePathWithExtension.size() - 3);
+    
+    // Headless shaders never get compiled, so there are no uniform locations to look up either
+    if (ResourceLoadingService::GetInstance().IsHeadless())
+    {
+        return std::make_unique<ShaderResource>(std::unordered_map<strutils::StringId, GLuint, strutils::StringIdHasher>(), std::unordered_map<strutils::StringId, int, strutils::StringIdHasher>(), std::vector<strutils::StringId>(), 0, 0);
+    }
 
     // Generate vertex shader id
     const auto vertexShaderId = GL_NO_CHECK_CALL(glCreateShader(GL_VERTEX_SHADER));
@@ -108,31 +114,22 @@ std::unique_ptr<IResource> ShaderLoader::VCreateAndLoadResource(const std::strin
   
     const auto uniformNamesToLocations = GetUniformNamesToLocationsMap(programId, resourcePath,  vertexShaderFileContents, fragmentShaderFileContents, uniformArrayElementCounts, samplerNamesInOrder);
     
-    return std::make_unique<ShaderResource>(uniformNamesToLocations, uniformArrayElementCounts, samplerNamesInOrder, programId);
+    return std::make_unique<ShaderResource>(uniformNamesToLocations, uniformArrayElementCounts, samplerNamesInOrder, programId, GetActiveVertexAttributeMask(programId));
 }
 
 ///------------------------------------------------------------------------------------------------
 
 std::string ShaderLoader::ReadFileContents(const std::string& filePath) const
 {
-    std::ifstream file(filePath);
+    ResourceFile file(filePath);
     
-    if (!file.good())
+    if (!file.IsValid())
     {
         ospopups::ShowMessageBox(ospopups::MessageBoxType::ERROR, "File could not be found", filePath.c_str());
-        return nullptr;
+        return std::string();
     }
     
-    std::string contents;
-    
-    file.seekg(0, std::ios::end);
-    contents.reserve(static_cast<size_t>(file.tellg()));
-    file.seekg(0, std::ios::beg);
-    
-    contents.assign((std::istreambuf_iterator<char>(file)),
-               std::istreambuf_iterator<char>());
-    
-    return contents;
+    return std::string(file.GetContents());
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -194,6 +191,34 @@ std::unordered_map<strutils::StringId, GLuint, strutils::StringIdHasher> ShaderL
 
 ///------------------------------------------------------------------------------------------------
 
+uint32_t GetActiveVertexAttributeMask(const GLuint programId)
+{
+    // Only attributes the linked program actually reads are reported as active, and
+    // they are matched by location so their names in the shader source don't matter
+    uint32_t activeVertexAttributeMask = 0;
+    
+    GLint activeAttributeCount = 0;
+    GL_CALL(glGetProgramiv(programId, GL_ACTIVE_ATTRIBUTES, &activeAttributeCount));
+    
+    for (GLint i = 0; i < activeAttributeCount; ++i)
+    {
+        GLchar attributeName[64];
+        GLint attributeSize = 0;
+        GLenum attributeType = 0;
+        GL_CALL(glGetActiveAttrib(programId, static_cast<GLuint>(i), sizeof(attributeName), nullptr, &attributeSize, &attributeType, attributeName));
+        
+        const auto attributeLocation = GL_NO_CHECK_CALL(glGetAttribLocation(programId, attributeName));
+        if (attributeLocation >= 0 && attributeLocation < static_cast<GLint>(VertexAttribute::COUNT))
+        {
+            activeVertexAttributeMask |= 1u << attributeLocation;
+        }
+    }
+    
+    return activeVertexAttributeMask;
+}
+
+///------------------------------------------------------------------------------------------------
+
 void ExtractUniformFromLine(const std::string& line, const std::string& shaderName, const GLuint programId, std::unordered_map<strutils::StringId, GLuint, strutils::StringIdHasher>& outUniformNamesToLocations, std::unordered_map<strutils::StringId, int, strutils::StringIdHasher>& outUniformArrayElementCounts, std::vector<strutils::StringId>& outSamplerNamesInOrder)
 {
     const auto uniformLineSplitBySpace = strutils::StringSplit(line, ' ');
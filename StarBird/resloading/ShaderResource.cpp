@@ -21,12 +21,14 @@ ShaderResource::ShaderResource
     const std::unordered_map<strutils::StringId, GLuint, strutils::StringIdHasher>& uniformNamesToLocations,
     const std::unordered_map<strutils::StringId, int, strutils::StringIdHasher>&   uniformArrayElementCounts,
     const std::vector<strutils::StringId>& uniformSamplerNamesInOrder,
-    const GLuint programId
+    const GLuint programId,
+    const uint32_t activeVertexAttributeMask
 )
     : mShaderUniformNamesToLocations(uniformNamesToLocations)
     , mUniformArrayElementCounts(uniformArrayElementCounts)
     , mUniformSamplerNamesInOrder(uniformSamplerNamesInOrder)
     , mProgramId(programId)
+    , mActiveVertexAttributeMask(activeVertexAttributeMask)
 {
     
 }
@@ -217,6 +219,13 @@ GLuint ShaderResource::GetProgramId() const
 
 ///------------------------------------------------------------------------------------------------
 
+bool ShaderResource::ReadsVertexAttribute(const VertexAttribute attribute) const
+{
+    return (mActiveVertexAttributeMask & (1u << static_cast<uint32_t>(attribute))) != 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
 const std::unordered_map<strutils::StringId, GLuint, strutils::StringIdHasher>& ShaderResource::GetUniformNamesToLocations() const
 {
     return mShaderUniformNamesToLocations;
@@ -236,6 +245,7 @@ void ShaderResource::CopyConstruction(const ShaderResource& rhs)
     mProgramId = rhs.GetProgramId();
     mShaderUniformNamesToLocations = rhs.GetUniformNamesToLocations();
     mUniformSamplerNamesInOrder = rhs.GetUniformSamplerNames();
+    mActiveVertexAttributeMask = rhs.mActiveVertexAttributeMask;
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -11,6 +11,7 @@
 ///------------------------------------------------------------------------------------------------
 
 #include "IResource.h"
+#include "VertexLayout.h"
 #include "../utils/MathUtils.h"
 #include "../utils/StringUtils.h"
 
@@ -38,7 +39,8 @@ public:
         const std::unordered_map<strutils::StringId, GLuint, strutils::StringIdHasher>& uniformNamesToLocations,
         const std::unordered_map<strutils::StringId, int, strutils::StringIdHasher>& uniformArrayElementCounts,
         const std::vector<strutils::StringId>& uniformSamplerNamesInOrder,
-        const GLuint programId
+        const GLuint programId,
+        const uint32_t activeVertexAttributeMask
     );
     ShaderResource& operator = (const ShaderResource&);
     ShaderResource(const ShaderResource&);
@@ -56,6 +58,10 @@ public:
     bool SetBool(const strutils::StringId& uniformName, const bool value) const;
 
     GLuint GetProgramId() const;    
+    
+    /// @param[in] attribute the vertex attribute to check.
+    /// @returns whether the linked program actually reads the given attribute (as reported by the driver).
+    bool ReadsVertexAttribute(const VertexAttribute attribute) const;
 
     const std::unordered_map<strutils::StringId, GLuint, strutils::StringIdHasher>& GetUniformNamesToLocations() const;
     const std::vector<strutils::StringId>& GetUniformSamplerNames() const;
@@ -67,6 +73,7 @@ private:
     std::vector<strutils::StringId> mUniformSamplerNamesInOrder;
     std::unordered_map<strutils::StringId, int, strutils::StringIdHasher> mUniformArrayElementCounts;
     GLuint mProgramId;    
+    uint32_t mActiveVertexAttributeMask = 0;
 };
 
 ///------------------------------------------------------------------------------------------------
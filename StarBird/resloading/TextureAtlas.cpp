@@ -0,0 +1,357 @@
+///------------------------------------------------------------------------------------------------
+///  TextureAtlas.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "AssetArchive.h"
+#include "TextureAtlas.h"
+#include "../utils/OpenGL.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstring>
+#include <numeric>
+#include <sstream>
+
+///------------------------------------------------------------------------------------------------
+
+namespace resources
+{
+
+///------------------------------------------------------------------------------------------------
+
+SkylineAtlasPacker::SkylineAtlasPacker(const int pageWidth, const int pageHeight, const int padding)
+    : mPageWidth(pageWidth)
+    , mPageHeight(pageHeight)
+    , mPadding(padding)
+{
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::vector<AtlasPlacement> SkylineAtlasPacker::Pack(const std::vector<glm::ivec2>& rectDimensions)
+{
+    std::vector<AtlasPlacement> placements(rectDimensions.size(), { -1, 0, 0 });
+
+    std::vector<size_t> packingOrder(rectDimensions.size());
+    std::iota(packingOrder.begin(), packingOrder.end(), 0);
+    std::stable_sort(packingOrder.begin(), packingOrder.end(), [&](const size_t lhs, const size_t rhs)
+    {
+        if (rectDimensions[lhs].y != rectDimensions[rhs].y) return rectDimensions[lhs].y > rectDimensions[rhs].y;
+        return rectDimensions[lhs].x > rectDimensions[rhs].x;
+    });
+
+    for (const auto rectIndex: packingOrder)
+    {
+        const auto paddedWidth = rectDimensions[rectIndex].x + 2 * mPadding;
+        const auto paddedHeight = rectDimensions[rectIndex].y + 2 * mPadding;
+
+        // Rects that can't even fit in an empty page are left unplaced
+        if (paddedWidth > mPageWidth || paddedHeight > mPageHeight)
+        {
+            continue;
+        }
+
+        int x = 0, y = 0;
+        auto pageIndex = 0;
+        for (; pageIndex < static_cast<int>(mPages.size()); ++pageIndex)
+        {
+            if (InsertInPage(mPages[pageIndex], paddedWidth, paddedHeight, x, y))
+            {
+                break;
+            }
+        }
+
+        if (pageIndex == static_cast<int>(mPages.size()))
+        {
+            mPages.push_back({{ 0, 0, mPageWidth }});
+            InsertInPage(mPages.back(), paddedWidth, paddedHeight, x, y);
+        }
+
+        placements[rectIndex] = { pageIndex, x + mPadding, y + mPadding };
+    }
+
+    return placements;
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t SkylineAtlasPacker::GetPageCount() const
+{
+    return mPages.size();
+}
+
+///------------------------------------------------------------------------------------------------
+
+glm::ivec2 SkylineAtlasPacker::GetPageUsedDimensions(const size_t pageIndex) const
+{
+    // Skyline nodes still at the bottom of the page span columns nothing got packed in to
+    glm::ivec2 usedDimensions(0);
+    for (const auto& node: mPages.at(pageIndex))
+    {
+        if (node.mY > 0)
+        {
+            usedDimensions.x = std::max(usedDimensions.x, node.mX + node.mWidth);
+            usedDimensions.y = std::max(usedDimensions.y, node.mY);
+        }
+    }
+
+    return usedDimensions;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool SkylineAtlasPacker::InsertInPage(Skyline& skyline, const int width, const int height, int& outX, int& outY) const
+{
+    // Pick the node resulting in the lowest bottom edge, breaking ties with the narrowest node
+    auto bestBottom = INT_MAX;
+    auto bestWidth = INT_MAX;
+    auto bestIndex = skyline.size();
+    auto bestY = 0;
+
+    for (size_t i = 0; i < skyline.size(); ++i)
+    {
+        int y = 0;
+        if (FitsAtNode(skyline, i, width, height, y))
+        {
+            const auto bottom = y + height;
+            if (bottom < bestBottom || (bottom == bestBottom && skyline[i].mWidth < bestWidth))
+            {
+                bestBottom = bottom;
+                bestWidth = skyline[i].mWidth;
+                bestIndex = i;
+                bestY = y;
+            }
+        }
+    }
+
+    if (bestIndex == skyline.size())
+    {
+        return false;
+    }
+
+    outX = skyline[bestIndex].mX;
+    outY = bestY;
+
+    skyline.insert(skyline.begin() + bestIndex, { outX, bestY + height, width });
+
+    // Trim (or remove) the nodes now shadowed by the new one
+    for (auto i = bestIndex + 1; i < skyline.size();)
+    {
+        const auto& previousNode = skyline[i - 1];
+        const auto previousNodeEnd = previousNode.mX + previousNode.mWidth;
+
+        if (skyline[i].mX >= previousNodeEnd)
+        {
+            break;
+        }
+
+        const auto shrinkAmount = previousNodeEnd - skyline[i].mX;
+        skyline[i].mX += shrinkAmount;
+        skyline[i].mWidth -= shrinkAmount;
+
+        if (skyline[i].mWidth > 0)
+        {
+            break;
+        }
+
+        skyline.erase(skyline.begin() + i);
+    }
+
+    // Merge neighbouring nodes of the same height
+    for (size_t i = 0; i + 1 < skyline.size();)
+    {
+        if (skyline[i].mY == skyline[i + 1].mY)
+        {
+            skyline[i].mWidth += skyline[i + 1].mWidth;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+bool SkylineAtlasPacker::FitsAtNode(const Skyline& skyline, const size_t nodeIndex, const int width, const int height, int& outY) const
+{
+    if (skyline[nodeIndex].mX + width > mPageWidth)
+    {
+        return false;
+    }
+
+    auto widthLeft = width;
+    auto y = skyline[nodeIndex].mY;
+
+    for (auto i = nodeIndex; widthLeft > 0; ++i)
+    {
+        if (i == skyline.size())
+        {
+            return false;
+        }
+
+        y = std::max(y, skyline[i].mY);
+        if (y + height > mPageHeight)
+        {
+            return false;
+        }
+
+        widthLeft -= skyline[i].mWidth;
+    }
+
+    outY = y;
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+TextureAtlas::~TextureAtlas()
+{
+    for (const auto& page: mPages)
+    {
+        if (page.mGLTextureId != 0)
+        {
+            GL_CALL(glDeleteTextures(1, &page.mGLTextureId));
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+const TextureAtlasEntry* TextureAtlas::GetEntry(const std::string& texturePath) const
+{
+    auto findIter = mEntries.find(texturePath);
+    return findIter != mEntries.end() ? &findIter->second : nullptr;
+}
+
+///------------------------------------------------------------------------------------------------
+
+const TextureAtlasPage& TextureAtlas::GetPage(const size_t pageIndex) const
+{
+    return mPages.at(pageIndex);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void TextureAtlas::AddPage(const TextureAtlasPage& page)
+{
+    mPages.push_back(page);
+}
+
+///------------------------------------------------------------------------------------------------
+
+void TextureAtlas::AddEntry(const std::string& texturePath, const TextureAtlasEntry& entry)
+{
+    assert(entry.mPageIndex < mPages.size());
+    mEntries[texturePath] = entry;
+}
+
+///------------------------------------------------------------------------------------------------
+
+namespace texture_atlas
+{
+
+///------------------------------------------------------------------------------------------------
+
+bool ReadAtlasManifestFile(const std::string& manifestFilePath, std::vector<std::string>& outTexturePaths)
+{
+    ResourceFile file(manifestFilePath);
+    if (!file.IsValid())
+    {
+        return false;
+    }
+
+    std::istringstream manifestFile{std::string(file.GetContents())};
+
+    std::string line;
+    while (std::getline(manifestFile, line))
+    {
+        line.erase(std::remove_if(line.begin(), line.end(), [](const char c){ return c == ' ' || c == '\t' || c == '\r'; }), line.end());
+
+        if (!line.empty() && line[0] != '#')
+        {
+            outTexturePaths.push_back(line);
+        }
+    }
+
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void BlitToPage(const unsigned char* rgbaPixels, const glm::ivec2& dimensions, const AtlasPlacement& placement, const int padding, const glm::ivec2& pageDimensions, std::vector<unsigned char>& pagePixels)
+{
+    assert(placement.mX - padding >= 0 && placement.mX + dimensions.x + padding <= pageDimensions.x);
+    assert(placement.mY - padding >= 0 && placement.mY + dimensions.y + padding <= pageDimensions.y);
+    assert(pagePixels.size() == static_cast<size_t>(pageDimensions.x * pageDimensions.y * 4));
+
+    for (auto y = -padding; y < dimensions.y + padding; ++y)
+    {
+        const auto sourceY = std::clamp(y, 0, dimensions.y - 1);
+        const auto* sourceRow = rgbaPixels + sourceY * dimensions.x * 4;
+        auto* pageRow = &pagePixels[((placement.mY + y) * pageDimensions.x + placement.mX) * 4];
+
+        std::memcpy(pageRow, sourceRow, dimensions.x * 4);
+
+        for (auto x = 1; x <= padding; ++x)
+        {
+            std::memcpy(pageRow - x * 4, sourceRow, 4);
+            std::memcpy(pageRow + (dimensions.x - 1 + x) * 4, sourceRow + (dimensions.x - 1) * 4, 4);
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+glm::ivec2 ComputeTrimmedPageDimensions(const glm::ivec2& usedDimensions)
+{
+    const auto roundUpToBlockSize = [](const int value)
+    {
+        return std::max(1, (value + ATLAS_PAGE_BLOCK_SIZE - 1)/ATLAS_PAGE_BLOCK_SIZE) * ATLAS_PAGE_BLOCK_SIZE;
+    };
+
+    return glm::ivec2(roundUpToBlockSize(usedDimensions.x), roundUpToBlockSize(usedDimensions.y));
+}
+
+///------------------------------------------------------------------------------------------------
+
+int ComputeMaxMipLevel(const int padding)
+{
+    auto maxMipLevel = 0;
+    while ((padding >> (maxMipLevel + 1)) > 0)
+    {
+        maxMipLevel++;
+    }
+
+    return maxMipLevel;
+}
+
+///------------------------------------------------------------------------------------------------
+
+SheetElementMetadata ComputeUVRect(const glm::ivec2& dimensions, const AtlasPlacement& placement, const glm::ivec2& pageDimensions)
+{
+    // Image rows are stored top down and sampled with a flipped v (see CreateSheetMetadata)
+    SheetElementMetadata uvRect;
+    uvRect.minU = placement.mX/static_cast<float>(pageDimensions.x);
+    uvRect.maxU = (placement.mX + dimensions.x)/static_cast<float>(pageDimensions.x);
+    uvRect.maxV = 1.0f - placement.mY/static_cast<float>(pageDimensions.y);
+    uvRect.minV = 1.0f - (placement.mY + dimensions.y)/static_cast<float>(pageDimensions.y);
+    return uvRect;
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
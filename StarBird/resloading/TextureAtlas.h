@@ -0,0 +1,189 @@
+///------------------------------------------------------------------------------------------------
+///  TextureAtlas.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef TextureAtlas_h
+#define TextureAtlas_h
+
+///------------------------------------------------------------------------------------------------
+
+#include "TextureResource.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+namespace resources
+{
+
+///------------------------------------------------------------------------------------------------
+
+/// Where a single rect ended up after packing. mX & mY point to the top-left
+/// pixel of the (unpadded) rect within its page, with y growing downwards
+/// to match the row order of the uploaded pixel data. A negative page index
+/// denotes a rect that could not fit in a page at all.
+struct AtlasPlacement
+{
+    int mPageIndex;
+    int mX;
+    int mY;
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// Skyline (bottom-left) rect packer. Each rect is surrounded by the given
+/// padding on all sides, and new pages are opened when a rect no longer
+/// fits in any of the existing ones.
+class SkylineAtlasPacker final
+{
+public:
+    SkylineAtlasPacker(const int pageWidth, const int pageHeight, const int padding);
+
+    /// Packs the given rects, tallest first for tighter pages.
+    /// @param[in] rectDimensions the pixel dimensions of the rects to pack.
+    /// @returns the placement of each rect, in the same order as the input.
+    std::vector<AtlasPlacement> Pack(const std::vector<glm::ivec2>& rectDimensions);
+
+    size_t GetPageCount() const;
+
+    /// Computes the bounds of everything packed in to a page (padding included),
+    /// so that the page can be trimmed down to them.
+    /// @param[in] pageIndex the index of the page.
+    /// @returns the width and height actually used in the page.
+    glm::ivec2 GetPageUsedDimensions(const size_t pageIndex) const;
+
+private:
+    struct SkylineNode
+    {
+        int mX;
+        int mY;
+        int mWidth;
+    };
+
+    using Skyline = std::vector<SkylineNode>;
+
+    bool InsertInPage(Skyline& skyline, const int width, const int height, int& outX, int& outY) const;
+    bool FitsAtNode(const Skyline& skyline, const size_t nodeIndex, const int width, const int height, int& outY) const;
+
+private:
+    const int mPageWidth;
+    const int mPageHeight;
+    const int mPadding;
+    std::vector<Skyline> mPages;
+};
+
+///------------------------------------------------------------------------------------------------
+
+struct TextureAtlasEntry
+{
+    size_t mPageIndex;
+    glm::ivec2 mDimensions;
+    SheetElementMetadata mUVRect;
+};
+
+///------------------------------------------------------------------------------------------------
+
+struct TextureAtlasPage
+{
+    GLuint mGLTextureId;
+    glm::ivec2 mDimensions;
+    size_t mGPUMemoryBytes;
+    size_t mRGBA8EquivalentMemoryBytes;
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// A set of GL texture pages holding all the textures listed in an atlas
+/// manifest. It's shared between the TextureResources of its members, so
+/// the pages are released once the last member texture gets unloaded.
+class TextureAtlas final
+{
+public:
+    TextureAtlas() = default;
+    ~TextureAtlas();
+    TextureAtlas(const TextureAtlas&) = delete;
+    const TextureAtlas& operator = (const TextureAtlas&) = delete;
+
+    const TextureAtlasEntry* GetEntry(const std::string& texturePath) const;
+    const TextureAtlasPage& GetPage(const size_t pageIndex) const;
+
+    void AddPage(const TextureAtlasPage& page);
+    void AddEntry(const std::string& texturePath, const TextureAtlasEntry& entry);
+
+private:
+    std::vector<TextureAtlasPage> mPages;
+    std::unordered_map<std::string, TextureAtlasEntry> mEntries;
+};
+
+///------------------------------------------------------------------------------------------------
+
+namespace texture_atlas
+{
+
+///------------------------------------------------------------------------------------------------
+
+inline const std::string ATLAS_MANIFEST_EXTENSION = "atl";
+inline const int ATLAS_PAGE_SIZE = 2048;
+inline const int ATLAS_PAGE_BLOCK_SIZE = 4;
+inline const int ATLAS_PADDING = 4;
+
+///------------------------------------------------------------------------------------------------
+/// Trims a page down to the bounds actually used in it, rounded up to the
+/// compressed block size so that the page can still be block compressed.
+/// @param[in] usedDimensions the bounds used in the page (see SkylineAtlasPacker::GetPageUsedDimensions).
+/// @returns the dimensions the page should be created with.
+glm::ivec2 ComputeTrimmedPageDimensions(const glm::ivec2& usedDimensions);
+
+///------------------------------------------------------------------------------------------------
+/// Computes the last mip level that the given padding still separates packed
+/// images in. Each level halves the padding, so past log2(padding) neighbouring
+/// images start bleeding in to each other.
+/// @param[in] padding the padding used while packing.
+/// @returns the highest mip level that can be sampled from a page.
+int ComputeMaxMipLevel(const int padding);
+
+///------------------------------------------------------------------------------------------------
+/// Parses an atlas manifest (.atl) file, holding one texture path per line
+/// relative to the textures root (e.g. enemies/alien_mm.bmp).
+/// @param[in] manifestFilePath the path to the .atl file.
+/// @param[out] outTexturePaths the texture paths listed in the manifest.
+/// @returns whether the manifest file was found.
+bool ReadAtlasManifestFile(const std::string& manifestFilePath, std::vector<std::string>& outTexturePaths);
+
+///------------------------------------------------------------------------------------------------
+/// Copies the given RGBA8 image in to the page at the given placement, and
+/// extrudes its edge pixels in to the surrounding padding so that linear
+/// filtering (and lower mip levels) don't bleed in neighbouring texels.
+/// @param[in] rgbaPixels tightly packed RGBA8 pixel data of the source image.
+/// @param[in] dimensions the dimensions of the source image.
+/// @param[in] placement the placement of the image in the page.
+/// @param[in] padding the padding used while packing.
+/// @param[in] pageDimensions the dimensions of the page.
+/// @param[out] pagePixels tightly packed RGBA8 pixel data of the page.
+void BlitToPage(const unsigned char* rgbaPixels, const glm::ivec2& dimensions, const AtlasPlacement& placement, const int padding, const glm::ivec2& pageDimensions, std::vector<unsigned char>& pagePixels);
+
+///------------------------------------------------------------------------------------------------
+/// Computes the UV rect of a packed image, in the same convention as the
+/// sprite sheet metadata so that it can be fed to the texture sheet uniforms as is.
+/// @param[in] dimensions the dimensions of the image.
+/// @param[in] placement the placement of the image in the page.
+/// @param[in] pageDimensions the dimensions of the page.
+/// @returns the UV rect of the image.
+SheetElementMetadata ComputeUVRect(const glm::ivec2& dimensions, const AtlasPlacement& placement, const glm::ivec2& pageDimensions);
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* TextureAtlas_h */
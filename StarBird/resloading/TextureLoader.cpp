@@ -5,6 +5,10 @@
 ///  Created by Alex Koukoulas on 20/11/2019.
 ///------------------------------------------------------------------------------------------------
 
+#include "AssetArchive.h"
+#include "CookedTexture.h"
+#include "ResourceLoadingService.h"
+#include "TextureAtlas.h"
 #include "TextureLoader.h"
 #include "TextureResource.h"
 #include "../utils/FileUtils.h"
@@ -14,7 +18,6 @@
 #include "../utils/OpenGL.h"
 
 #include <algorithm>
-#include <fstream>     // ifstream
 #include <SDL.h>
 #include <iostream>
 #include <unordered_map>
@@ -27,50 +30,55 @@ namespace resources
 
 ///------------------------------------------------------------------------------------------------
 
-void TextureLoader::VInitialize()
-{
-}
-
-///------------------------------------------------------------------------------------------------
-
-std::unique_ptr<IResource> TextureLoader::VCreateAndLoadResource(const std::string& resourcePath) const
+static std::unique_ptr<SheetMetadata> CreateSheetMetadata(const std::vector<SheetRowDescriptor>& sheetRows, const int textureWidth, const int textureHeight)
 {
-    std::ifstream file(resourcePath);
-    
-    if (!file.good())
+    if (sheetRows.empty())
     {
-        ospopups::ShowMessageBox(ospopups::MessageBoxType::ERROR, "File could not be found", resourcePath.c_str());
         return nullptr;
     }
     
-    SDL_Surface* loadedSurface = SDL_LoadBMP(resourcePath.c_str());
-    if( loadedSurface == NULL )
-    {
-        ospopups::ShowMessageBox(ospopups::MessageBoxType::ERROR, "Error Loading Texture", resourcePath.c_str());
-        return nullptr;
-    }
+    auto sheetMetadata = std::make_unique<SheetMetadata>();
     
-    // Convert surface to display format
-    auto* pixels = SDL_ConvertSurfaceFormat( loadedSurface, SDL_GetWindowPixelFormat(SDL_GL_GetCurrentWindow()), 0 );
+    float uvCounterX = 0.0f;
+    float uvCounterY = 1.0f;
     
-    // Color key image
-    SDL_SetColorKey(pixels, SDL_TRUE, SDL_MapRGB(pixels->format, 0, 0xFF, 0xFF));
-    
-    const auto fileNameWithoutExtension = fileutils::GetFileNameWithoutExtension(resourcePath);
+    for (const auto& sheetRow: sheetRows)
+    {
+        sheetMetadata->mRowMetadata.emplace_back();
+        auto& currentRow = sheetMetadata->mRowMetadata.back();
+        
+        auto elementNormalizedWidth =  sheetRow.mElementWidth/(float)textureWidth;
+        auto elementNormalizedHeight = sheetRow.mElementHeight/(float)textureHeight;
+        
+        for (auto i = 0; i < sheetRow.mElementCount; ++i)
+        {
+            currentRow.mColMetadata.emplace_back();
+            auto& currentCol = currentRow.mColMetadata.back();
+            
+            currentCol.minU = uvCounterX;
+            currentCol.minV = uvCounterY - elementNormalizedHeight;
+            currentCol.maxU = uvCounterX + elementNormalizedWidth;
+            currentCol.maxV = uvCounterY;
+           
+            uvCounterX += elementNormalizedWidth;
+        }
+        
+        uvCounterX = 0.0f;
+        uvCounterY -= elementNormalizedHeight;
+    }
     
-    bool useMipMap = strutils::StringContains(fileNameWithoutExtension, "mm");
+    return sheetMetadata;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void SetTextureParameters(const std::string& fileNameWithoutExtension, const bool hasMipMaps)
+{
     bool useUWrap  = !strutils::StringContains(fileNameWithoutExtension, "fxx");
     bool useVWrap  = !strutils::StringContains(fileNameWithoutExtension, "fxy");
     
-    // Create texture from surface pixels
-    GLuint glTextureId;
-    GL_CALL(glGenTextures(1, &glTextureId));
-    GL_CALL(glBindTexture(GL_TEXTURE_2D, glTextureId));
-    GL_CALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, pixels->w, pixels->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels->pixels));
-    
-    if (useMipMap)
+    if (hasMipMaps)
     {
-        GL_CALL(glGenerateMipmap(GL_TEXTURE_2D));
         GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
     }
     else
@@ -97,58 +105,463 @@ std::unique_ptr<IResource> TextureLoader::VCreateAndLoadResource(const std::stri
     {
         GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
     }
+}
+
+///------------------------------------------------------------------------------------------------
+
+static GLenum GetGLCompressedFormat(const CookedTextureFormat cookedTextureFormat)
+{
+    switch (cookedTextureFormat)
+    {
+        case CookedTextureFormat::ETC2_RGB8: return GL_COMPRESSED_RGB8_ETC2;
+        case CookedTextureFormat::ETC2_RGBA8_EAC: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+        default: return 0;
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+struct UncompressedUploadFormat
+{
+    GLint mInternalFormat;
+    GLenum mFormat;
+    GLenum mType;
+    GLint mSwizzle[4];
+};
+
+///------------------------------------------------------------------------------------------------
+
+static UncompressedUploadFormat GetGLUncompressedUploadFormat(const CookedTextureFormat cookedTextureFormat)
+{
+    switch (cookedTextureFormat)
+    {
+        case CookedTextureFormat::R8: return { GL_R8, GL_RED, GL_UNSIGNED_BYTE, { GL_RED, GL_RED, GL_RED, GL_ONE } };
+        case CookedTextureFormat::A8: return { GL_R8, GL_RED, GL_UNSIGNED_BYTE, { GL_ONE, GL_ONE, GL_ONE, GL_RED } };
+        case CookedTextureFormat::RG8: return { GL_RG8, GL_RG, GL_UNSIGNED_BYTE, { GL_RED, GL_RED, GL_RED, GL_GREEN } };
+        case CookedTextureFormat::RGB565: return { GL_RGB565, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, { GL_RED, GL_GREEN, GL_BLUE, GL_ONE } };
+        case CookedTextureFormat::RGBA4444: return { GL_RGBA4, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, { GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA } };
+        default: return { GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, { GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA } };
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+static bool IsCompressedFormatSupported(const GLenum compressedFormat)
+{
+    static std::vector<GLint> supportedCompressedFormats;
+    static bool queriedSupportedFormats = false;
     
-    GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+    if (!queriedSupportedFormats)
+    {
+        GLint supportedFormatCount = 0;
+        GL_CALL(glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &supportedFormatCount));
+        supportedCompressedFormats.resize(supportedFormatCount);
+        if (supportedFormatCount > 0)
+        {
+            GL_CALL(glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, &supportedCompressedFormats[0]));
+        }
+        queriedSupportedFormats = true;
+    }
+    
+    return std::find(supportedCompressedFormats.begin(), supportedCompressedFormats.end(), static_cast<GLint>(compressedFormat)) != supportedCompressedFormats.end();
+}
+
+///------------------------------------------------------------------------------------------------
+
+static bool LoadBMPPixels(const std::string& bmpPath, std::vector<unsigned char>& outRGBAPixels, uint32_t& outWidth, uint32_t& outHeight)
+{
+    ResourceFile file(bmpPath);
+    if (!file.IsValid())
+    {
+        ospopups::ShowMessageBox(ospopups::MessageBoxType::ERROR, "File could not be found", bmpPath.c_str());
+        return false;
+    }
+    
+    // Decoded straight out of the file's contents
+    SDL_Surface* loadedSurface = SDL_LoadBMP_RW(SDL_RWFromConstMem(file.GetData(), static_cast<int>(file.GetSize())), 1);
+    if( loadedSurface == NULL )
+    {
+        ospopups::ShowMessageBox(ospopups::MessageBoxType::ERROR, "Error Loading Texture", bmpPath.c_str());
+        return false;
+    }
+    
+    // Convert surface to tightly packed RGBA bytes
+    auto* pixels = SDL_ConvertSurfaceFormat( loadedSurface, SDL_PIXELFORMAT_RGBA32, 0 );
     
-    const auto surfaceWidth = loadedSurface->w;
-    const auto surfaceHeight = loadedSurface->h;
+    // Color key image
+    SDL_SetColorKey(pixels, SDL_TRUE, SDL_MapRGB(pixels->format, 0, 0xFF, 0xFF));
     
+    outWidth = static_cast<uint32_t>(pixels->w);
+    outHeight = static_cast<uint32_t>(pixels->h);
+    
+    const auto* pixelData = static_cast<const unsigned char*>(pixels->pixels);
+    outRGBAPixels.assign(pixelData, pixelData + outWidth * outHeight * 4);
+    
+    SDL_FreeSurface(pixels);
     SDL_FreeSurface(loadedSurface);
     
-    // Check for spritesheet metadata
-    std::unique_ptr<SheetMetadata> sheetMetadata = nullptr;
-    auto metadataFilePath = resourcePath;
-    strutils::StringReplaceAllOccurences("bmp", "mtd", metadataFilePath);
-    std::ifstream metadataFile(metadataFilePath);
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static GLuint UploadCookedTexture(const CookedTexture& texture, const std::string& fileNameWithoutExtension, const bool generateMipMaps, GLint& outGLInternalFormat, size_t& outGPUMemoryBytes, size_t& outRGBA8MemoryBytes)
+{
+    // Headless textures keep their dimensions and metadata, but never make it to the GPU
+    if (ResourceLoadingService::GetInstance().IsHeadless())
+    {
+        outGLInternalFormat = 0;
+        outGPUMemoryBytes = 0;
+        outRGBA8MemoryBytes = 0;
+        return 0;
+    }
+    
+    const auto compressedFormat = GetGLCompressedFormat(texture.mFormat);
+    const auto uploadCompressed = compressedFormat != 0 && IsCompressedFormatSupported(compressedFormat);
     
-    if (metadataFile.good())
+    if (compressedFormat != 0 && !uploadCompressed)
     {
-        std::string line;
-        sheetMetadata = std::make_unique<SheetMetadata>();
+        Log(LogType::WARNING, "Compressed format not supported for %s. Decoding on CPU instead.", fileNameWithoutExtension.c_str());
+    }
+    
+    // Formats falling back to a CPU decode get uploaded as plain RGBA8
+    const auto uploadFormat = (compressedFormat != 0 && !uploadCompressed) ? CookedTextureFormat::RGBA8 : texture.mFormat;
+    const auto uncompressedUploadFormat = GetGLUncompressedUploadFormat(uploadFormat);
+    
+    GLuint glTextureId;
+    GL_CALL(glGenTextures(1, &glTextureId));
+    GL_CALL(glBindTexture(GL_TEXTURE_2D, glTextureId));
+    
+    // Single and dual channel rows are not necessarily 4 byte aligned
+    GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    
+    size_t gpuMemoryBytes = 0;
+    size_t rgba8MemoryBytes = 0;
+    
+    for (size_t mipLevel = 0; mipLevel < texture.mMipLevels.size(); ++mipLevel)
+    {
+        uint32_t mipWidth = 0, mipHeight = 0;
+        texture_cooking::GetMipLevelDimensions(texture, mipLevel, mipWidth, mipHeight);
         
-        float uvCounterX = 0.0f;
-        float uvCounterY = 1.0f;
+        if (uploadCompressed)
+        {
+            const auto& mipLevelData = texture.mMipLevels[mipLevel];
+            GL_CALL(glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(mipLevel), compressedFormat, mipWidth, mipHeight, 0, static_cast<GLsizei>(mipLevelData.size()), mipLevelData.data()));
+        }
+        else if (uploadFormat != texture.mFormat)
+        {
+            const auto rgbaPixels = texture_cooking::DecodeMipLevelToRGBA8(texture, mipLevel);
+            GL_CALL(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(mipLevel), uncompressedUploadFormat.mInternalFormat, mipWidth, mipHeight, 0, uncompressedUploadFormat.mFormat, uncompressedUploadFormat.mType, rgbaPixels.data()));
+        }
+        else
+        {
+            GL_CALL(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(mipLevel), uncompressedUploadFormat.mInternalFormat, mipWidth, mipHeight, 0, uncompressedUploadFormat.mFormat, uncompressedUploadFormat.mType, texture.mMipLevels[mipLevel].data()));
+        }
+        
+        gpuMemoryBytes += texture_cooking::GetMipLevelByteSize(uploadFormat, mipWidth, mipHeight);
+        rgba8MemoryBytes += texture_cooking::GetMipLevelByteSize(CookedTextureFormat::RGBA8, mipWidth, mipHeight);
+    }
+    
+    GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+    
+    // Narrow formats get their channels swizzled back so that shaders can keep on sampling rgba
+    if (!uploadCompressed)
+    {
+        GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, uncompressedUploadFormat.mSwizzle[0]));
+        GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, uncompressedUploadFormat.mSwizzle[1]));
+        GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, uncompressedUploadFormat.mSwizzle[2]));
+        GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, uncompressedUploadFormat.mSwizzle[3]));
+    }
+    
+    const auto hasMipMaps = generateMipMaps || texture.mMipLevels.size() > 1;
+    if (generateMipMaps)
+    {
+        GL_CALL(glGenerateMipmap(GL_TEXTURE_2D));
         
-        while (std::getline(metadataFile, line))
+        // The full chain adds roughly a third on top of the base level
+        gpuMemoryBytes += gpuMemoryBytes/3;
+        rgba8MemoryBytes += rgba8MemoryBytes/3;
+    }
+    else
+    {
+        GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(texture.mMipLevels.size() - 1)));
+    }
+    
+    SetTextureParameters(fileNameWithoutExtension, hasMipMaps);
+    
+    GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+    
+    outGLInternalFormat = uploadCompressed ? static_cast<GLint>(compressedFormat) : uncompressedUploadFormat.mInternalFormat;
+    outGPUMemoryBytes = gpuMemoryBytes;
+    outRGBA8MemoryBytes = rgba8MemoryBytes;
+    
+    return glTextureId;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void TextureLoader::VInitialize()
+{
+    // Index the atlas manifests up front. Atlas pages themselves are only built
+    // once one of their member textures gets loaded.
+    const auto atlasManifestFileNames = ResourceFile::GetFileNamesInDirectory(ResourceLoadingService::RES_ATLASES_ROOT);
+    for (const auto& atlasManifestFileName: atlasManifestFileNames)
+    {
+        if (fileutils::GetFileExtension(atlasManifestFileName) != texture_atlas::ATLAS_MANIFEST_EXTENSION)
         {
-            sheetMetadata->mRowMetadata.emplace_back();
-            auto& currentRow = sheetMetadata->mRowMetadata.back();
-            
-            auto splitByComma = strutils::StringSplit(line, ',');
-            assert(splitByComma.size() == 3);
-            auto elementNormalizedWidth =  std::stoi(splitByComma[0])/(float)surfaceWidth;
-            auto elementNormalizedHeight = std::stoi(splitByComma[1])/(float)surfaceHeight;
-            auto elementCount = std::stoi(splitByComma[2]);
+            continue;
+        }
+        
+        const auto atlasManifestPath = ResourceLoadingService::RES_ATLASES_ROOT + atlasManifestFileName;
+        
+        std::vector<std::string> memberTexturePaths;
+        texture_atlas::ReadAtlasManifestFile(atlasManifestPath, memberTexturePaths);
+        
+        for (const auto& memberTexturePath: memberTexturePaths)
+        {
+            const auto fullTexturePath = ResourceLoadingService::RES_TEXTURES_ROOT + memberTexturePath;
+            const auto fileNameWithoutExtension = fileutils::GetFileNameWithoutExtension(fullTexturePath);
             
-            for (auto i = 0; i < elementCount; ++i)
+            // Sprite sheets and wrapping effect textures need the whole uv space of their own texture
+            if (ResourceFile::Exists(fullTexturePath.substr(0, fullTexturePath.size() - fileutils::GetFileExtension(fullTexturePath).size()) + "mtd") ||
+                strutils::StringContains(fileNameWithoutExtension, "fxx") ||
+                strutils::StringContains(fileNameWithoutExtension, "fxy"))
             {
-                currentRow.mColMetadata.emplace_back();
-                auto& currentCol = currentRow.mColMetadata.back();
-                
-                currentCol.minU = uvCounterX;
-                currentCol.minV = uvCounterY - elementNormalizedHeight;
-                currentCol.maxU = uvCounterX + elementNormalizedWidth;
-                currentCol.maxV = uvCounterY;
-               
-                uvCounterX += elementNormalizedWidth;
+                Log(LogType::WARNING, "Texture %s can't be part of atlas %s", memberTexturePath.c_str(), atlasManifestFileName.c_str());
+                continue;
             }
             
-            uvCounterX = 0.0f;
-            uvCounterY -= elementNormalizedHeight;
+            mTexturePathsToAtlasManifests[fullTexturePath] = atlasManifestPath;
+            mAtlasManifestsToTexturePaths[atlasManifestPath].push_back(fullTexturePath);
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::unique_ptr<IResource> TextureLoader::VCreateAndLoadResource(const std::string& resourcePath) const
+{
+    // Textures listed in an atlas manifest are served from their shared atlas page
+    auto atlasManifestIter = mTexturePathsToAtlasManifests.find(resourcePath);
+    if (atlasManifestIter != mTexturePathsToAtlasManifests.end())
+    {
+        auto atlasTexture = CreateTextureFromAtlas(resourcePath, atlasManifestIter->second);
+        if (atlasTexture)
+        {
+            return atlasTexture;
+        }
+    }
+    
+    const auto fileExtension = fileutils::GetFileExtension(resourcePath);
+    if (fileExtension == texture_cooking::COOKED_TEXTURE_EXTENSION)
+    {
+        auto cookedTextureResource = CreateTextureFromCookedTexture(resourcePath);
+        if (!cookedTextureResource)
+        {
+            ospopups::ShowMessageBox(ospopups::MessageBoxType::ERROR, "Error Loading Cooked Texture", resourcePath.c_str());
+        }
+        
+        return cookedTextureResource;
+    }
+    
+    // Prefer the cooked version of the texture if one has been shipped alongside the source one
+    const auto cookedTexturePath = resourcePath.substr(0, resourcePath.size() - fileExtension.size()) + texture_cooking::COOKED_TEXTURE_EXTENSION;
+    if (ResourceFile::Exists(cookedTexturePath))
+    {
+        auto cookedTextureResource = CreateTextureFromCookedTexture(cookedTexturePath);
+        if (cookedTextureResource)
+        {
+            return cookedTextureResource;
+        }
+        
+        // Stale or truncated container, the source texture is used instead if it was shipped too
+        Log(LogType::WARNING, "Cooked texture %s is invalid, falling back to %s", cookedTexturePath.c_str(), resourcePath.c_str());
+    }
+    
+    std::vector<unsigned char> rgbaPixels;
+    uint32_t surfaceWidth = 0, surfaceHeight = 0;
+    if (!LoadBMPPixels(resourcePath, rgbaPixels, surfaceWidth, surfaceHeight))
+    {
+        return nullptr;
+    }
+    
+    // Textures are cooked offline by the Cook Assets build phase (see Tools/cook_assets.sh), so
+    // a bmp only gets here when that was skipped. It is uploaded uncompressed, as is.
+    Log(LogType::WARNING, "Texture %s has not been cooked", resourcePath.c_str());
+    
+    CookedTexture uncookedTexture;
+    uncookedTexture.mWidth = surfaceWidth;
+    uncookedTexture.mHeight = surfaceHeight;
+    uncookedTexture.mMipLevels.push_back(std::move(rgbaPixels));
+    texture_cooking::ReadSheetMetadataFile(resourcePath.substr(0, resourcePath.size() - fileExtension.size()) + "mtd", uncookedTexture.mSheetRows);
+    
+    const auto fileNameWithoutExtension = fileutils::GetFileNameWithoutExtension(resourcePath);
+    bool useMipMap = strutils::StringContains(fileNameWithoutExtension, "mm");
+    
+    return CreateTextureResource(uncookedTexture, fileNameWithoutExtension, useMipMap);
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::unique_ptr<IResource> TextureLoader::CreateTextureFromCookedTexture(const std::string& cookedTexturePath) const
+{
+    CookedTexture cookedTexture;
+    if (!texture_cooking::ReadCookedTexture(cookedTexturePath, cookedTexture))
+    {
+        return nullptr;
+    }
+    
+    return CreateTextureResource(cookedTexture, fileutils::GetFileNameWithoutExtension(cookedTexturePath), false);
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::unique_ptr<IResource> TextureLoader::CreateTextureResource(const CookedTexture& texture, const std::string& fileNameWithoutExtension, const bool generateMipMaps) const
+{
+    GLint glInternalFormat = 0;
+    size_t gpuMemoryBytes = 0;
+    size_t rgba8MemoryBytes = 0;
+    const auto glTextureId = UploadCookedTexture(texture, fileNameWithoutExtension, generateMipMaps, glInternalFormat, gpuMemoryBytes, rgba8MemoryBytes);
+    
+    const auto textureWidth = static_cast<int>(texture.mWidth);
+    const auto textureHeight = static_cast<int>(texture.mHeight);
+    
+    return std::unique_ptr<IResource>(new TextureResource(textureWidth, textureHeight, GL_RGBA, glInternalFormat, glTextureId, gpuMemoryBytes, rgba8MemoryBytes, CreateSheetMetadata(texture.mSheetRows, textureWidth, textureHeight), nullptr, nullptr));
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::unique_ptr<IResource> TextureLoader::CreateTextureFromAtlas(const std::string& texturePath, const std::string& atlasManifestPath) const
+{
+    auto atlas = mLoadedAtlases[atlasManifestPath].lock();
+    if (!atlas)
+    {
+        atlas = BuildTextureAtlas(atlasManifestPath);
+        mLoadedAtlases[atlasManifestPath] = atlas;
+    }
+    
+    // Textures too large for a page are loaded standalone
+    const auto* atlasEntry = atlas->GetEntry(texturePath);
+    if (!atlasEntry)
+    {
+        return nullptr;
+    }
+    
+    // Attribute each member its share of the page's memory
+    const auto& atlasPage = atlas->GetPage(atlasEntry->mPageIndex);
+    const auto areaRatio = (atlasEntry->mDimensions.x * atlasEntry->mDimensions.y)/static_cast<double>(atlasPage.mDimensions.x * atlasPage.mDimensions.y);
+    const auto gpuMemoryBytes = static_cast<size_t>(atlasPage.mGPUMemoryBytes * areaRatio);
+    const auto rgba8MemoryBytes = static_cast<size_t>(atlasPage.mRGBA8EquivalentMemoryBytes * areaRatio);
+    
+    return std::unique_ptr<IResource>(new TextureResource(atlasEntry->mDimensions.x, atlasEntry->mDimensions.y, GL_RGBA, GL_RGBA, atlasPage.mGLTextureId, gpuMemoryBytes, rgba8MemoryBytes, nullptr, atlas, std::make_unique<SheetElementMetadata>(atlasEntry->mUVRect)));
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::shared_ptr<const TextureAtlas> TextureLoader::BuildTextureAtlas(const std::string& atlasManifestPath) const
+{
+    auto startTime = SDL_GetPerformanceCounter();
+    
+    const auto& memberTexturePaths = mAtlasManifestsToTexturePaths.at(atlasManifestPath);
+    
+    std::vector<std::vector<unsigned char>> memberPixels(memberTexturePaths.size());
+    std::vector<glm::ivec2> memberDimensions(memberTexturePaths.size(), glm::ivec2(0));
+    
+    for (size_t i = 0; i < memberTexturePaths.size(); ++i)
+    {
+        const auto& memberTexturePath = memberTexturePaths[i];
+        const auto cookedTexturePath = memberTexturePath.substr(0, memberTexturePath.size() - fileutils::GetFileExtension(memberTexturePath).size()) + texture_cooking::COOKED_TEXTURE_EXTENSION;
+        
+        CookedTexture cookedTexture;
+        uint32_t width = 0, height = 0;
+        
+        if (texture_cooking::ReadCookedTexture(cookedTexturePath, cookedTexture))
+        {
+            memberPixels[i] = texture_cooking::DecodeMipLevelToRGBA8(cookedTexture, 0);
+            width = cookedTexture.mWidth;
+            height = cookedTexture.mHeight;
+        }
+        else if (!LoadBMPPixels(memberTexturePath, memberPixels[i], width, height))
+        {
+            continue;
         }
+        
+        memberDimensions[i] = glm::ivec2(width, height);
     }
     
-    return std::unique_ptr<IResource>(new TextureResource(surfaceWidth, surfaceHeight, GL_RGBA, GL_RGBA, glTextureId, std::move(sheetMetadata)));
+    SkylineAtlasPacker packer(texture_atlas::ATLAS_PAGE_SIZE, texture_atlas::ATLAS_PAGE_SIZE, texture_atlas::ATLAS_PADDING);
+    const auto placements = packer.Pack(memberDimensions);
+    
+    // Pages are only as large as what got packed in to them
+    std::vector<glm::ivec2> pageDimensions(packer.GetPageCount());
+    std::vector<std::vector<unsigned char>> pagePixels(packer.GetPageCount());
+    for (size_t pageIndex = 0; pageIndex < pageDimensions.size(); ++pageIndex)
+    {
+        pageDimensions[pageIndex] = texture_atlas::ComputeTrimmedPageDimensions(packer.GetPageUsedDimensions(pageIndex));
+        pagePixels[pageIndex].resize(pageDimensions[pageIndex].x * pageDimensions[pageIndex].y * 4, 0);
+    }
+    
+    std::vector<bool> pageNeedsMipMaps(packer.GetPageCount(), false);
+    
+    for (size_t i = 0; i < memberTexturePaths.size(); ++i)
+    {
+        if (placements[i].mPageIndex < 0 || memberPixels[i].empty())
+        {
+            continue;
+        }
+        
+        texture_atlas::BlitToPage(memberPixels[i].data(), memberDimensions[i], placements[i], texture_atlas::ATLAS_PADDING, pageDimensions[placements[i].mPageIndex], pagePixels[placements[i].mPageIndex]);
+        
+        if (strutils::StringContains(fileutils::GetFileNameWithoutExtension(memberTexturePaths[i]), "mm"))
+        {
+            pageNeedsMipMaps[placements[i].mPageIndex] = true;
+        }
+    }
+    
+    auto atlas = std::make_shared<TextureAtlas>();
+    const auto atlasName = fileutils::GetFileNameWithoutExtension(atlasManifestPath);
+    
+    for (size_t pageIndex = 0; pageIndex < pagePixels.size(); ++pageIndex)
+    {
+        const auto format = texture_cooking::SelectNarrowestLosslessFormat(pagePixels[pageIndex].data(), pageDimensions[pageIndex].x, pageDimensions[pageIndex].y);
+        const auto cookedPage = texture_cooking::CookTexture(pagePixels[pageIndex].data(), pageDimensions[pageIndex].x, pageDimensions[pageIndex].y, format, false, {});
+        
+        TextureAtlasPage atlasPage;
+        GLint glInternalFormat = 0;
+        atlasPage.mGLTextureId = UploadCookedTexture(cookedPage, atlasName, pageNeedsMipMaps[pageIndex], glInternalFormat, atlasPage.mGPUMemoryBytes, atlasPage.mRGBA8EquivalentMemoryBytes);
+        atlasPage.mDimensions = pageDimensions[pageIndex];
+        
+        // Lower mips than the padding covers would bleed neighbouring members in to each other
+        if (pageNeedsMipMaps[pageIndex] && atlasPage.mGLTextureId != 0)
+        {
+            GL_CALL(glBindTexture(GL_TEXTURE_2D, atlasPage.mGLTextureId));
+            GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture_atlas::ComputeMaxMipLevel(texture_atlas::ATLAS_PADDING)));
+            GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+        }
+        
+        atlas->AddPage(atlasPage);
+    }
+    
+    for (size_t i = 0; i < memberTexturePaths.size(); ++i)
+    {
+        if (placements[i].mPageIndex < 0 || memberPixels[i].empty())
+        {
+            Log(LogType::WARNING, "Texture %s does not fit in atlas %s", memberTexturePaths[i].c_str(), atlasName.c_str());
+            continue;
+        }
+        
+        atlas->AddEntry(memberTexturePaths[i], { static_cast<size_t>(placements[i].mPageIndex), memberDimensions[i], texture_atlas::ComputeUVRect(memberDimensions[i], placements[i], pageDimensions[placements[i].mPageIndex]) });
+    }
+    
+    auto currTime = SDL_GetPerformanceCounter();
+    
+    double elapsedTime = static_cast<double>(
+      (currTime - startTime) / static_cast<double>(SDL_GetPerformanceFrequency())
+    );
+    
+    Log(LogType::INFO, "Built atlas %s (%zu textures in %zu pages) in %.6f millis", atlasName.c_str(), memberTexturePaths.size(), pagePixels.size(), elapsedTime * 1000.0f);
+    
+    return atlas;
 }
 
 ///------------------------------------------------------------------------------------------------
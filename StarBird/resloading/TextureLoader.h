@@ -15,6 +15,9 @@
 #include <memory>
 #include <SDL_stdinc.h>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 ///------------------------------------------------------------------------------------------------
 
@@ -27,6 +30,11 @@ namespace resources
 
 ///------------------------------------------------------------------------------------------------
 
+struct CookedTexture;
+class TextureAtlas;
+
+///------------------------------------------------------------------------------------------------
+
 class TextureLoader final: public IResourceLoader
 {
     friend class ResourceLoadingService;
@@ -38,6 +46,15 @@ public:
 private:
     TextureLoader() = default;
     
+    std::unique_ptr<IResource> CreateTextureFromCookedTexture(const std::string& cookedTexturePath) const;
+    std::unique_ptr<IResource> CreateTextureResource(const CookedTexture& texture, const std::string& fileNameWithoutExtension, const bool generateMipMaps) const;
+    std::unique_ptr<IResource> CreateTextureFromAtlas(const std::string& texturePath, const std::string& atlasManifestPath) const;
+    std::shared_ptr<const TextureAtlas> BuildTextureAtlas(const std::string& atlasManifestPath) const;
+    
+private:
+    std::unordered_map<std::string, std::string> mTexturePathsToAtlasManifests;
+    std::unordered_map<std::string, std::vector<std::string>> mAtlasManifestsToTexturePaths;
+    mutable std::unordered_map<std::string, std::weak_ptr<const TextureAtlas>> mLoadedAtlases;
 };
 
 ///------------------------------------------------------------------------------------------------
@@ -5,6 +5,7 @@
 ///  Created by Alex Koukoulas on 20/11/2019.
 ///------------------------------------------------------------------------------------------------
 
+#include "TextureAtlas.h"
 #include "TextureResource.h"
 #include "../utils/OpenGL.h"
 
@@ -20,7 +21,11 @@ namespace resources
 
 TextureResource::~TextureResource()
 {
-    GL_CALL(glDeleteTextures(1, &mGLTextureId));
+    // Atlas pages are owned by the atlas itself (and headless textures have no GL texture at all)
+    if (!mAtlas && mGLTextureId != 0)
+    {
+        GL_CALL(glDeleteTextures(1, &mGLTextureId));
+    }
 }
 
 ///------------------------------------------------------------------------------------------------
@@ -54,6 +59,20 @@ glm::vec2 TextureResource::GetSingleTextureFrameDimensions() const
 
 ///------------------------------------------------------------------------------------------------
 
+size_t TextureResource::GetGPUMemoryBytes() const
+{
+    return mGPUMemoryBytes;
+}
+
+///------------------------------------------------------------------------------------------------
+
+size_t TextureResource::GetRGBA8EquivalentMemoryBytes() const
+{
+    return mRGBA8EquivalentMemoryBytes;
+}
+
+///------------------------------------------------------------------------------------------------
+
 SheetMetadata* TextureResource::GetSheetMetadata() const
 {
     if (mSheetMetadata)
@@ -64,6 +83,13 @@ SheetMetadata* TextureResource::GetSheetMetadata() const
 
 ///------------------------------------------------------------------------------------------------
 
+const SheetElementMetadata* TextureResource::GetAtlasRegion() const
+{
+    return mAtlasRegion.get();
+}
+
+///------------------------------------------------------------------------------------------------
+
 TextureResource::TextureResource
 (
     const int width,
@@ -71,13 +97,21 @@ TextureResource::TextureResource
     const int mode,
     const int format,
     GLuint glTextureId,
-    std::unique_ptr<SheetMetadata> sheetMetadata
+    const size_t gpuMemoryBytes,
+    const size_t rgba8EquivalentMemoryBytes,
+    std::unique_ptr<SheetMetadata> sheetMetadata,
+    std::shared_ptr<const TextureAtlas> atlas,
+    std::unique_ptr<SheetElementMetadata> atlasRegion
 )
     : mDimensions(width, height)
     , mMode(mode)
     , mFormat(format)
     , mGLTextureId(glTextureId)
+    , mGPUMemoryBytes(gpuMemoryBytes)
+    , mRGBA8EquivalentMemoryBytes(rgba8EquivalentMemoryBytes)
     , mSheetMetadata(std::move(sheetMetadata))
+    , mAtlas(std::move(atlas))
+    , mAtlasRegion(std::move(atlasRegion))
 {
 }
 
@@ -25,6 +25,7 @@ namespace resources
 ///------------------------------------------------------------------------------------------------
 
 using GLuint = unsigned int;
+class TextureAtlas;
 
 ///------------------------------------------------------------------------------------------------
 
@@ -62,9 +63,16 @@ public:
     GLuint GetGLTextureId() const;
     glm::vec2 GetDimensions() const;
     glm::vec2 GetSingleTextureFrameDimensions() const;
+    size_t GetGPUMemoryBytes() const;
+    size_t GetRGBA8EquivalentMemoryBytes() const;
     
     SheetMetadata* GetSheetMetadata() const;
     
+    /// For textures packed in a texture atlas, returns the region of the shared
+    /// atlas page (bound via GetGLTextureId()) holding this texture.
+    /// @returns the UV rect of the texture in its atlas page, or nullptr if it's not part of an atlas.
+    const SheetElementMetadata* GetAtlasRegion() const;
+    
 private:
     TextureResource
     (
@@ -73,7 +81,11 @@ private:
         const int mode,
         const int format,
         GLuint glTextureId,
-        std::unique_ptr<SheetMetadata> sheetMetadata
+        const size_t gpuMemoryBytes,
+        const size_t rgba8EquivalentMemoryBytes,
+        std::unique_ptr<SheetMetadata> sheetMetadata,
+        std::shared_ptr<const TextureAtlas> atlas,
+        std::unique_ptr<SheetElementMetadata> atlasRegion
     );
     
 private:
@@ -81,7 +93,11 @@ private:
     int mMode;
     int mFormat;
     GLuint mGLTextureId;
+    size_t mGPUMemoryBytes;
+    size_t mRGBA8EquivalentMemoryBytes;
     std::unique_ptr<SheetMetadata> mSheetMetadata;
+    std::shared_ptr<const TextureAtlas> mAtlas;
+    std::unique_ptr<SheetElementMetadata> mAtlasRegion;
 };
 
 ///------------------------------------------------------------------------------------------------
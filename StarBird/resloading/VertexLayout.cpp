@@ -0,0 +1,207 @@
+///------------------------------------------------------------------------------------------------
+///  VertexLayout.cpp
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#include "VertexLayout.h"
+#include "../utils/OpenGL.h"
+
+#include <cassert>
+#include <cstring>
+#include <glm/packing.hpp>
+#include <glm/gtc/packing.hpp>
+
+///------------------------------------------------------------------------------------------------
+
+namespace resources
+{
+
+///------------------------------------------------------------------------------------------------
+
+static GLuint GetAttributeFormatSize(const VertexAttributeFormat format)
+{
+    switch (format)
+    {
+        case VertexAttributeFormat::NONE: return 0;
+        case VertexAttributeFormat::FLOAT_2: return 2 * sizeof(float);
+        case VertexAttributeFormat::FLOAT_3: return 3 * sizeof(float);
+        case VertexAttributeFormat::HALF_FLOAT_2: return sizeof(uint32_t);
+        case VertexAttributeFormat::NORMALIZED_USHORT_2: return sizeof(uint32_t);
+        case VertexAttributeFormat::NORMALIZED_INT_2_10_10_10: return sizeof(uint32_t);
+    }
+
+    return 0;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void WriteAttribute(const VertexAttributeFormat format, const glm::vec3& value, unsigned char* dest)
+{
+    switch (format)
+    {
+        case VertexAttributeFormat::NONE: break;
+        case VertexAttributeFormat::FLOAT_2: std::memcpy(dest, &value.x, 2 * sizeof(float)); break;
+        case VertexAttributeFormat::FLOAT_3: std::memcpy(dest, &value.x, 3 * sizeof(float)); break;
+        case VertexAttributeFormat::HALF_FLOAT_2:
+        {
+            uint32_t packed = glm::packHalf2x16(glm::vec2(value.x, value.y));
+            std::memcpy(dest, &packed, sizeof(uint32_t));
+        } break;
+        case VertexAttributeFormat::NORMALIZED_USHORT_2:
+        {
+            uint32_t packed = glm::packUnorm2x16(glm::vec2(value.x, value.y));
+            std::memcpy(dest, &packed, sizeof(uint32_t));
+        } break;
+        case VertexAttributeFormat::NORMALIZED_INT_2_10_10_10:
+        {
+            const auto normalizedValue = glm::length(value) > 0.0f ? glm::normalize(value) : value;
+            uint32_t packed = glm::packSnorm3x10_1x2(glm::vec4(normalizedValue, 0.0f));
+            std::memcpy(dest, &packed, sizeof(uint32_t));
+        } break;
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void ApplyAttributePointer(const GLuint attributeLocation, const VertexAttributeFormat format, const GLuint stride, const GLuint offset)
+{
+    const auto* attributeOffset = reinterpret_cast<const void*>(static_cast<uintptr_t>(offset));
+
+    switch (format)
+    {
+        case VertexAttributeFormat::NONE:
+        {
+            GL_CALL(glDisableVertexAttribArray(attributeLocation));
+            return;
+        }
+        case VertexAttributeFormat::FLOAT_2: GL_CALL(glVertexAttribPointer(attributeLocation, 2, GL_FLOAT, GL_FALSE, stride, attributeOffset)); break;
+        case VertexAttributeFormat::FLOAT_3: GL_CALL(glVertexAttribPointer(attributeLocation, 3, GL_FLOAT, GL_FALSE, stride, attributeOffset)); break;
+        case VertexAttributeFormat::HALF_FLOAT_2: GL_CALL(glVertexAttribPointer(attributeLocation, 2, GL_HALF_FLOAT, GL_FALSE, stride, attributeOffset)); break;
+        case VertexAttributeFormat::NORMALIZED_USHORT_2: GL_CALL(glVertexAttribPointer(attributeLocation, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, attributeOffset)); break;
+        case VertexAttributeFormat::NORMALIZED_INT_2_10_10_10: GL_CALL(glVertexAttribPointer(attributeLocation, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, attributeOffset)); break;
+    }
+
+    GL_CALL(glEnableVertexAttribArray(attributeLocation));
+}
+
+///------------------------------------------------------------------------------------------------
+
+VertexLayout::VertexLayout(const VertexAttributeFormat positionFormat, const VertexAttributeFormat texCoordFormat, const VertexAttributeFormat normalFormat)
+    : mAttributeFormats({ positionFormat, texCoordFormat, normalFormat })
+    , mStride(0)
+{
+    assert(positionFormat == VertexAttributeFormat::FLOAT_3 && "Positions need to be full precision");
+
+    for (size_t i = 0; i < mAttributeFormats.size(); ++i)
+    {
+        mAttributeOffsets[i] = mStride;
+        mStride += GetAttributeFormatSize(mAttributeFormats[i]);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+VertexLayout VertexLayout::CreateUncompressedLayout()
+{
+    return VertexLayout(VertexAttributeFormat::FLOAT_3, VertexAttributeFormat::FLOAT_2, VertexAttributeFormat::FLOAT_3);
+}
+
+///------------------------------------------------------------------------------------------------
+
+VertexLayout VertexLayout::CreateCompactLayout(const std::vector<glm::vec2>& texCoords, const bool includeNormals)
+{
+    // Normalized shorts offer better precision than half floats across [0,1],
+    // but tiled/repeating tex coords outside that range need the latter.
+    bool texCoordsInUnitRange = true;
+    for (const auto& texCoord: texCoords)
+    {
+        if (texCoord.x < 0.0f || texCoord.x > 1.0f || texCoord.y < 0.0f || texCoord.y > 1.0f)
+        {
+            texCoordsInUnitRange = false;
+            break;
+        }
+    }
+
+    return VertexLayout(VertexAttributeFormat::FLOAT_3, texCoordsInUnitRange ? VertexAttributeFormat::NORMALIZED_USHORT_2 : VertexAttributeFormat::HALF_FLOAT_2, includeNormals ? VertexAttributeFormat::NORMALIZED_INT_2_10_10_10 : VertexAttributeFormat::NONE);
+}
+
+///------------------------------------------------------------------------------------------------
+
+VertexAttributeFormat VertexLayout::GetAttributeFormat(const VertexAttribute attribute) const
+{
+    return mAttributeFormats[static_cast<size_t>(attribute)];
+}
+
+///------------------------------------------------------------------------------------------------
+
+GLuint VertexLayout::GetAttributeOffset(const VertexAttribute attribute) const
+{
+    return mAttributeOffsets[static_cast<size_t>(attribute)];
+}
+
+///------------------------------------------------------------------------------------------------
+
+GLuint VertexLayout::GetStride() const
+{
+    return mStride;
+}
+
+///------------------------------------------------------------------------------------------------
+
+void VertexLayout::PackInterleavedData(const std::vector<glm::vec3>& vertices, const std::vector<glm::vec2>& texCoords, const std::vector<glm::vec3>& normals, std::vector<unsigned char>& outInterleavedData) const
+{
+    assert(texCoords.size() == vertices.size() && normals.size() == vertices.size());
+
+    outInterleavedData.resize(vertices.size() * mStride);
+
+    const auto texCoordFormat = GetAttributeFormat(VertexAttribute::TEX_COORD);
+    const auto normalFormat = GetAttributeFormat(VertexAttribute::NORMAL);
+    const auto texCoordOffset = GetAttributeOffset(VertexAttribute::TEX_COORD);
+    const auto normalOffset = GetAttributeOffset(VertexAttribute::NORMAL);
+
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        auto* vertexStart = &outInterleavedData[i * mStride];
+        std::memcpy(vertexStart, &vertices[i].x, 3 * sizeof(float));
+        WriteAttribute(texCoordFormat, glm::vec3(texCoords[i], 0.0f), vertexStart + texCoordOffset);
+        WriteAttribute(normalFormat, normals[i], vertexStart + normalOffset);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void VertexLayout::ApplyToBoundVertexArrayObject() const
+{
+    for (size_t i = 0; i < mAttributeFormats.size(); ++i)
+    {
+        ApplyAttributePointer(static_cast<GLuint>(i), mAttributeFormats[i], mStride, mAttributeOffsets[i]);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void VertexLayout::PackSeparateAttributeData(const VertexAttributeFormat format, const std::vector<glm::vec3>& values, std::vector<unsigned char>& outPackedData)
+{
+    const auto formatSize = GetAttributeFormatSize(format);
+    outPackedData.resize(values.size() * formatSize);
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        WriteAttribute(format, values[i], &outPackedData[i * formatSize]);
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+void VertexLayout::ApplySeparateAttributeToBoundVertexArrayObject(const VertexAttribute attribute, const VertexAttributeFormat format)
+{
+    ApplyAttributePointer(static_cast<GLuint>(attribute), format, GetAttributeFormatSize(format), 0);
+}
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
@@ -0,0 +1,107 @@
+///------------------------------------------------------------------------------------------------
+///  VertexLayout.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+
+#ifndef VertexLayout_h
+#define VertexLayout_h
+
+///------------------------------------------------------------------------------------------------
+
+#include "../utils/MathUtils.h"
+
+#include <array>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+namespace resources
+{
+
+///------------------------------------------------------------------------------------------------
+
+using GLuint = unsigned int;
+
+///------------------------------------------------------------------------------------------------
+
+enum class VertexAttribute
+{
+    POSITION = 0,
+    TEX_COORD = 1,
+    NORMAL = 2,
+    COUNT = 3
+};
+
+///------------------------------------------------------------------------------------------------
+
+enum class VertexAttributeFormat
+{
+    NONE,                      // Attribute omitted from the vertex. The shader reads the default generic value.
+    FLOAT_2,                   // 8 bytes
+    FLOAT_3,                   // 12 bytes
+    HALF_FLOAT_2,              // 4 bytes
+    NORMALIZED_USHORT_2,       // 4 bytes, only valid for values in [0,1]
+    NORMALIZED_INT_2_10_10_10  // 4 bytes, only valid for values in [-1,1]
+};
+
+///------------------------------------------------------------------------------------------------
+
+/// Describes the in-memory layout of a single interleaved vertex. All
+/// attributes of a mesh live in the same VBO, each one at its own offset
+/// within the vertex stride, with the attribute location given by VertexAttribute.
+class VertexLayout final
+{
+public:
+    VertexLayout(const VertexAttributeFormat positionFormat, const VertexAttributeFormat texCoordFormat, const VertexAttributeFormat normalFormat);
+
+    /// Interleaved, uncompressed layout (pos float3, uv float2, normal float3).
+    static VertexLayout CreateUncompressedLayout();
+
+    /// Picks the most compact layout capable of representing the given attribute data.
+    /// @param[in] texCoords the mesh's tex coords. Normalized shorts are chosen if these all lie in [0,1], half floats otherwise.
+    /// @param[in] includeNormals whether normals should be included (as packed 10-10-10-2) or omitted altogether.
+    /// @returns the compact layout.
+    static VertexLayout CreateCompactLayout(const std::vector<glm::vec2>& texCoords, const bool includeNormals);
+
+    VertexAttributeFormat GetAttributeFormat(const VertexAttribute attribute) const;
+    GLuint GetAttributeOffset(const VertexAttribute attribute) const;
+    GLuint GetStride() const;
+
+    /// Packs the given attribute streams in to a single interleaved buffer following this layout.
+    /// @param[in] vertices the vertex positions.
+    /// @param[in] texCoords the vertex tex coords (same count as vertices).
+    /// @param[in] normals the vertex normals (same count as vertices).
+    /// @param[out] outInterleavedData the resulting interleaved buffer (resized to vertices.size() * stride).
+    void PackInterleavedData(const std::vector<glm::vec3>& vertices, const std::vector<glm::vec2>& texCoords, const std::vector<glm::vec3>& normals, std::vector<unsigned char>& outInterleavedData) const;
+
+    /// Enables and sets up the vertex attribute pointers of all non-omitted
+    /// attributes against the currently bound VAO & GL_ARRAY_BUFFER.
+    void ApplyToBoundVertexArrayObject() const;
+
+    /// Packs a single attribute stream on its own (i.e. not interleaved), for attributes kept out of a layout.
+    /// @param[in] format the format to pack the values in.
+    /// @param[in] values the attribute values.
+    /// @param[out] outPackedData the resulting buffer (resized to values.size() * format size).
+    static void PackSeparateAttributeData(const VertexAttributeFormat format, const std::vector<glm::vec3>& values, std::vector<unsigned char>& outPackedData);
+
+    /// Enables and sets up the vertex attribute pointer of a single, tightly packed attribute
+    /// stream (see PackSeparateAttributeData) against the currently bound VAO & GL_ARRAY_BUFFER.
+    /// @param[in] attribute the attribute the stream holds.
+    /// @param[in] format the format of the stream.
+    static void ApplySeparateAttributeToBoundVertexArrayObject(const VertexAttribute attribute, const VertexAttributeFormat format);
+
+private:
+    std::array<VertexAttributeFormat, static_cast<size_t>(VertexAttribute::COUNT)> mAttributeFormats;
+    std::array<GLuint, static_cast<size_t>(VertexAttribute::COUNT)> mAttributeOffsets;
+    GLuint mStride;
+};
+
+///------------------------------------------------------------------------------------------------
+
+}
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* VertexLayout_h */
@@ -16,14 +16,17 @@ namespace math
 
 ///-----------------------------------------------------------------------------------------------
 
-static int controlledRandomSeed = 0;
+// Random state is per thread, so that game instances running side by side don't interfere with each other's sequences
+static thread_local int controlledRandomSeed = 0;
 static int internalRand();
 
 ///-----------------------------------------------------------------------------------------------
 
-void SetControlSeed(const int seed)
+int SetControlSeed(const int seed)
 {
+    const auto previousSeed = controlledRandomSeed;
     controlledRandomSeed = seed;
+    return previousSeed;
 }
 
 ///-----------------------------------------------------------------------------------------------
@@ -64,8 +67,8 @@ int ControlledIndexSelectionFromDistribution(const ProbabilityDistribution& prob
 
 std::mt19937& GetRandomEngine()
 {
-    static std::random_device rd;
-    static std::mt19937 eng(rd());
+    static thread_local std::random_device rd;
+    static thread_local std::mt19937 eng(rd());
     return eng;
 }
 
@@ -222,6 +225,51 @@ glm::vec3 BezierCurve::ComputePointForT(const float t)
 
 ///------------------------------------------------------------------------------------------------
 
+static const uint64_t SPLITMIX_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t SplitMix64(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+///------------------------------------------------------------------------------------------------
+
+RandomStream RandomStream::Split(const uint64_t key) const
+{
+    return RandomStream(SplitMix64(mSeed ^ SplitMix64(key + SPLITMIX_GAMMA)));
+}
+
+///------------------------------------------------------------------------------------------------
+
+uint64_t RandomStream::NextUInt64()
+{
+    return SplitMix64(mSeed + (++mCounter) * SPLITMIX_GAMMA);
+}
+
+///------------------------------------------------------------------------------------------------
+
+int RandomStream::NextInt(const int min, const int max)
+{
+    assert(min <= max);
+    
+    // Maps the upper 32 bits on to the range with a multiply instead of a modulo
+    const auto range = static_cast<uint64_t>(static_cast<int64_t>(max) - min + 1);
+    return static_cast<int>(min + static_cast<int64_t>(((NextUInt64() >> 32) * range) >> 32));
+}
+
+///------------------------------------------------------------------------------------------------
+
+float RandomStream::NextFloat(const float min /* = 0.0f */, const float max /* = 1.0f */)
+{
+    // 24 random bits are all a float's mantissa can hold
+    const auto unitFloat = static_cast<float>(NextUInt64() >> 40) * (1.0f/16777216.0f);
+    return min + unitFloat * (max - min);
+}
+
+///------------------------------------------------------------------------------------------------
+
 // https://stackoverflow.com/questions/1026327/what-common-algorithms-are-used-for-cs-rand
 int internalRand()
 {
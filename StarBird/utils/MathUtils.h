@@ -12,6 +12,7 @@
 
 #include <Box2D/Common/b2Math.h>
 #include <cmath>                        // powf, sinf, cosf, atan2
+#include <cstdint>                      // uint64_t
 #include <ctime>                        // time
 #include <functional>                   // function
 #include <glm/vec2.hpp>                 // vec2
@@ -102,7 +103,7 @@ inline T Abs(const T val)
 /// @returns the sin of the value.
 inline float Sinf(const float val)
 {
-    return std::sinf(val);
+    return std::sin(val);
 }
 
 ///-----------------------------------------------------------------------------------------------
@@ -111,7 +112,7 @@ inline float Sinf(const float val)
 /// @returns the cosine of the value.
 inline float Cosf(const float val)
 {
-    return std::cosf(val);
+    return std::cos(val);
 }
 
 ///-----------------------------------------------------------------------------------------------
@@ -157,7 +158,7 @@ inline T Slerp(const T x, const T y, const float theta, const float t)
 /// @returns the square root of the value.
 inline float Sqrt(const float val)
 {
-    return std::sqrtf(val);
+    return std::sqrt(val);
 }
 
 ///-----------------------------------------------------------------------------------------------
@@ -265,7 +266,7 @@ inline float LinearFunction(const float t)
 /// @returns the transformed t value quadratically.
 inline float QuadFunction(const float t)
 {
-    return std::powf(t, 2.0f);
+    return std::pow(t, 2.0f);
 }
 
 ///-----------------------------------------------------------------------------------------------
@@ -274,7 +275,7 @@ inline float QuadFunction(const float t)
 /// @returns the transformed t value cubically.
 inline float CubicFunction(const float t)
 {
-    return std::powf(t, 3.0f);
+    return std::pow(t, 3.0f);
 }
 
 ///-----------------------------------------------------------------------------------------------
@@ -283,7 +284,7 @@ inline float CubicFunction(const float t)
 /// @returns the transformed t value quartically.
 inline float QuartFunction(const float t)
 {
-    return std::powf(t, 4.0f);
+    return std::pow(t, 4.0f);
 }
 
 ///-----------------------------------------------------------------------------------------------
@@ -292,7 +293,7 @@ inline float QuartFunction(const float t)
 /// @returns the transformed t value quintically.
 inline float QuintFunction(const float t)
 {
-    return std::powf(t, 5.0f);
+    return std::pow(t, 5.0f);
 }
 
 ///-----------------------------------------------------------------------------------------------
@@ -301,7 +302,7 @@ inline float QuintFunction(const float t)
 /// @returns the transformed t value based on the back function.
 inline float BackFunction(const float t)
 {
-    return std::powf(t, 2.0f) * (2.70158f * t - 1.70158f);
+    return std::pow(t, 2.0f) * (2.70158f * t - 1.70158f);
 }
 
 ///-----------------------------------------------------------------------------------------------
@@ -349,7 +350,8 @@ inline float TweenValue(const float val, const std::function<float(const float)>
 ///-----------------------------------------------------------------------------------------------
 /// Sets a custom seed for a controlled sequence of generated random numbers.
 /// @param[in] seed the seed to start the sequence with
-void SetControlSeed(const int seed);
+/// @returns the state the sequence was in before, which can be passed back here to resume it.
+int SetControlSeed(const int seed);
 
 ///-----------------------------------------------------------------------------------------------
 /// Computes a random int based on the min and max inclusive values provided and the control seed specified at SetCRandomSeed.
@@ -509,12 +511,45 @@ public:
     
     glm::vec3 ComputePointForT(const float t);
     
+    inline const std::vector<glm::vec3>& GetControlPoints() const { return mControlPoints; }
+    
 private:
     std::vector<glm::vec3> mControlPoints;
 };
 
 ///------------------------------------------------------------------------------------------------
 
+/// Counter based (SplitMix64) deterministic random number stream. Unlike the controlled random
+/// functions above it carries no global state, so independent streams can be split off by key
+/// (e.g. per map node) and consumed from any thread, in any order, with identical results.
+class RandomStream
+{
+public:
+    explicit RandomStream(const uint64_t seed)
+        : mSeed(seed)
+        , mCounter(0)
+    {
+    }
+    
+    /// Derives an independent child stream. The result depends only on this stream's seed and
+    /// the given key, not on how many numbers have already been drawn from this stream.
+    RandomStream Split(const uint64_t key) const;
+    
+    uint64_t NextUInt64();
+    
+    /// @returns a random int in the [min, max] range (both inclusive).
+    int NextInt(const int min, const int max);
+    
+    /// @returns a random float in the [min, max) range.
+    float NextFloat(const float min = 0.0f, const float max = 1.0f);
+    
+private:
+    uint64_t mSeed;
+    uint64_t mCounter;
+};
+
+///------------------------------------------------------------------------------------------------
+
 }
 
 ///-----------------------------------------------------------------------------------------------
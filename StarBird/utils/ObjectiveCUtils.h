@@ -16,7 +16,6 @@
 
 namespace objectiveC_utils
 {
-    void UnzipAssets(const char* zippedFolderPath, const char* resFolderPath);
     void Vibrate();
     void PreloadSfx(const std::string& sfxResPath);
     void PlaySound(const std::string& soundResPath, const bool loopedSfx = false);
@@ -10,7 +10,6 @@
 #include "OSMessageBox.h"
 #include "ObjectiveCUtils.h"
 #import "AVAudioPlayerManager.h"
-#import "SSZipArchive.h"
 #import <AudioToolbox/AudioServices.h>
 #import <AudioToolbox/AudioToolbox.h>
 #import <AVFoundation/AVFoundation.h>
@@ -25,20 +24,14 @@ static std::string ROOT_SOUND_RES_PATH;
 
 ///------------------------------------------------------------------------------------------------
 
-void objectiveC_utils::UnzipAssets(const char* zippedFolderPath, const char* resFolderPath)
-{
-    NSString* zipPath = [NSString stringWithCString:zippedFolderPath
-                                       encoding:[NSString defaultCStringEncoding]];
-    NSString* resPath = [NSString stringWithCString:resFolderPath
-                                           encoding:[NSString defaultCStringEncoding]];
-    
-    [SSZipArchive unzipFileAtPath:zipPath toDestination:resPath];
-}
-
-///------------------------------------------------------------------------------------------------
-
 void objectiveC_utils::Vibrate()
 {
+    // Haptics go along with audio (headless runs never initialize either)
+    if (manager == nil)
+    {
+        return;
+    }
+    
     AudioServicesPlaySystemSound(kSystemSoundID_Vibrate);
 }
 
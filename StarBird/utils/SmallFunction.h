@@ -0,0 +1,145 @@
+///------------------------------------------------------------------------------------------------
+///  SmallFunction.h
+///  StarBird
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///-----------------------------------------------------------------------------------------------
+
+#ifndef SmallFunction_h
+#define SmallFunction_h
+
+///-----------------------------------------------------------------------------------------------
+
+#include <cassert>
+#include <cstddef>     // max_align_t, size_t
+#include <new>         // placement new
+#include <type_traits>
+#include <utility>     // forward, move
+
+///-----------------------------------------------------------------------------------------------
+
+template<typename Signature, std::size_t BufferSize = 48>
+class SmallFunction;
+
+///-----------------------------------------------------------------------------------------------
+/// Move only, type erased callable (a std::function replacement) that stores callables of up to
+/// BufferSize bytes in place, with no heap allocation. Bigger callables (or ones that can throw
+/// while being moved) still work, but are allocated on the heap.
+/// @tparam R the return type of the callable.
+/// @tparam Args the argument types of the callable.
+/// @tparam BufferSize the size of the in place storage in bytes.
+template<typename R, typename... Args, std::size_t BufferSize>
+class SmallFunction<R(Args...), BufferSize>
+{
+public:
+    SmallFunction() = default;
+    SmallFunction(std::nullptr_t) {}
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, SmallFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+    SmallFunction(F&& callable)
+    {
+        using CallableT = std::decay_t<F>;
+
+        if constexpr (IsStoredInPlace<CallableT>())
+        {
+            new (mBuffer) CallableT(std::forward<F>(callable));
+            mOperations = &IN_PLACE_OPERATIONS<CallableT>;
+        }
+        else
+        {
+            new (mBuffer) CallableT*(new CallableT(std::forward<F>(callable)));
+            mOperations = &HEAP_OPERATIONS<CallableT>;
+        }
+    }
+
+    SmallFunction(SmallFunction&& other) noexcept
+    {
+        MoveFrom(other);
+    }
+
+    SmallFunction& operator = (SmallFunction&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    SmallFunction(const SmallFunction&) = delete;
+    SmallFunction& operator = (const SmallFunction&) = delete;
+
+    ~SmallFunction()
+    {
+        Reset();
+    }
+
+    R operator()(Args... args)
+    {
+        assert(mOperations);
+        return mOperations->mInvoke(mBuffer, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return mOperations != nullptr; }
+
+    /// @returns whether the given callable type would be stored in place (i.e. without a heap allocation).
+    template<typename CallableT>
+    static constexpr bool IsStoredInPlace()
+    {
+        return sizeof(CallableT) <= BufferSize && alignof(CallableT) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<CallableT>;
+    }
+
+private:
+    struct Operations
+    {
+        R (*mInvoke)(void* buffer, Args&&... args);
+        void (*mMove)(void* destinationBuffer, void* sourceBuffer);
+        void (*mDestroy)(void* buffer);
+    };
+
+    template<typename CallableT>
+    static inline const Operations IN_PLACE_OPERATIONS =
+    {
+        [](void* buffer, Args&&... args) -> R { return (*static_cast<CallableT*>(buffer))(std::forward<Args>(args)...); },
+        [](void* destinationBuffer, void* sourceBuffer) { new (destinationBuffer) CallableT(std::move(*static_cast<CallableT*>(sourceBuffer))); static_cast<CallableT*>(sourceBuffer)->~CallableT(); },
+        [](void* buffer) { static_cast<CallableT*>(buffer)->~CallableT(); }
+    };
+
+    template<typename CallableT>
+    static inline const Operations HEAP_OPERATIONS =
+    {
+        [](void* buffer, Args&&... args) -> R { return (**static_cast<CallableT**>(buffer))(std::forward<Args>(args)...); },
+        [](void* destinationBuffer, void* sourceBuffer) { new (destinationBuffer) CallableT*(*static_cast<CallableT**>(sourceBuffer)); },
+        [](void* buffer) { delete *static_cast<CallableT**>(buffer); }
+    };
+
+    void MoveFrom(SmallFunction& other)
+    {
+        if (other.mOperations)
+        {
+            other.mOperations->mMove(mBuffer, other.mBuffer);
+            mOperations = other.mOperations;
+            other.mOperations = nullptr;
+        }
+    }
+
+    void Reset()
+    {
+        if (mOperations)
+        {
+            mOperations->mDestroy(mBuffer);
+            mOperations = nullptr;
+        }
+    }
+
+private:
+    static_assert(BufferSize >= sizeof(void*), "SmallFunction needs room for at least a pointer to a heap allocated callable");
+
+    alignas(std::max_align_t) unsigned char mBuffer[BufferSize];
+    const Operations* mOperations = nullptr;
+};
+
+///-----------------------------------------------------------------------------------------------
+
+#endif /* SmallFunction_h */
@@ -11,11 +11,17 @@
 ///-----------------------------------------------------------------------------------------------
 
 #include <algorithm>
+#include <cassert>
+#include <array>
 #include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <regex>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 
@@ -26,13 +32,15 @@ namespace strutils
 
 ///-----------------------------------------------------------------------------------------------
 
-static std::hash<std::string> hashFunction;
+// Hashes views rather than strings, so that hashing never needs an allocation. The
+// standard guarantees the same result as std::hash<std::string> for the same characters.
+static std::hash<std::string_view> hashFunction;
 
 ///-----------------------------------------------------------------------------------------------
 /// Compute a unique hash for a given string.
 /// @param[in] s the input string.
 /// @returns the hashed input string.
-inline std::size_t GetStringHash(const std::string& s)
+inline std::size_t GetStringHash(const std::string_view s)
 {
     auto result = hashFunction(s);
     assert(result > 2);
@@ -139,6 +147,112 @@ inline std::vector<std::string> StringSplit(const std::string& s, char delim)
     return elems;
 }
 
+///-----------------------------------------------------------------------------------------------
+/// Non allocating counterpart of StringSplit, walking over views of the given string's components.
+/// Produces the same components as StringSplit (i.e. a trailing empty component is dropped).
+class StringTokenizer final
+{
+public:
+    StringTokenizer(const std::string_view s, const char delim)
+        : mRemaining(s)
+        , mDelim(delim)
+        , mDone(s.empty())
+    {
+    }
+    
+    /// @param[out] outToken the next component, if any.
+    /// @returns whether there was a next component.
+    bool Next(std::string_view& outToken)
+    {
+        if (mDone) return false;
+        
+        const auto delimPos = mRemaining.find(mDelim);
+        if (delimPos == std::string_view::npos)
+        {
+            outToken = mRemaining;
+            mDone = true;
+            return true;
+        }
+        
+        outToken = mRemaining.substr(0, delimPos);
+        mRemaining.remove_prefix(delimPos + 1);
+        mDone = mRemaining.empty();
+        return true;
+    }
+    
+private:
+    std::string_view mRemaining;
+    char mDelim;
+    bool mDone;
+};
+
+///-----------------------------------------------------------------------------------------------
+/// Splits the given string based on a delimiter character, in to a fixed number of views over it.
+/// @param[in] s the input string.
+/// @param[in] delim the delimiter character to split the original string based on.
+/// @param[out] outComponents the string's components. Any components past its capacity are dropped.
+/// @returns the number of components written.
+template<std::size_t MAX_COMPONENTS>
+inline std::size_t StringSplitView(const std::string_view s, const char delim, std::array<std::string_view, MAX_COMPONENTS>& outComponents)
+{
+    StringTokenizer tokenizer(s, delim);
+    
+    std::size_t componentCount = 0;
+    while (componentCount < MAX_COMPONENTS && tokenizer.Next(outComponents[componentCount]))
+    {
+        componentCount++;
+    }
+    
+    return componentCount;
+}
+
+///-----------------------------------------------------------------------------------------------
+/// Skips the leading whitespace (and sign) that std::stof/stoi would accept, but std::from_chars won't.
+inline std::string_view TrimForNumberParsing(std::string_view s)
+{
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+    if (!s.empty() && s.front() == '+') s.remove_prefix(1);
+    return s;
+}
+
+///-----------------------------------------------------------------------------------------------
+/// Allocation free counterpart of std::stof. Parsing stops at the first character that can't be part
+/// of the number (e.g. the f in 1.0f).
+/// @param[in] s the input string.
+/// @returns the parsed number, or 0 if the string doesn't start with one.
+inline float StringToFloat(const std::string_view s)
+{
+    const auto trimmed = TrimForNumberParsing(s);
+    auto result = 0.0f;
+    
+#if defined(__cpp_lib_to_chars)
+    std::from_chars(trimmed.data(), trimmed.data() + trimmed.size(), result);
+#else
+    // Standard libraries without floating point from_chars go through strtof, over a bounded copy
+    // on the stack since the view is not necessarily NUL terminated
+    char buffer[64];
+    const auto length = std::min(trimmed.size(), sizeof(buffer) - 1);
+    std::memcpy(buffer, trimmed.data(), length);
+    buffer[length] = '\0';
+    result = std::strtof(buffer, nullptr);
+#endif
+    
+    return result;
+}
+
+///-----------------------------------------------------------------------------------------------
+/// Allocation free counterpart of std::stoi. Parsing stops at the first character that can't be part
+/// of the number.
+/// @param[in] s the input string.
+/// @returns the parsed number, or 0 if the string doesn't start with one.
+inline int StringToInt(const std::string_view s)
+{
+    const auto trimmed = TrimForNumberParsing(s);
+    auto result = 0;
+    std::from_chars(trimmed.data(), trimmed.data() + trimmed.size(), result);
+    return result;
+}
+
 ///-----------------------------------------------------------------------------------------------
 /// Returns the formatted time string HH:MM from the given number of seconds.
 /// @param[in] seconds the number of seconds to format.
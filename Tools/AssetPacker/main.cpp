@@ -0,0 +1,171 @@
+///------------------------------------------------------------------------------------------------
+///  main.cpp
+///  AssetPacker
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+///  Offline pack step for the game's assets. Walks the given res directory and packs every file
+///  found under it in to a single memory mappable archive (res/assets.pak by default), which
+///  ResourceLoadingService mounts on startup and serves files from in place of the loose ones.
+///  Sounds and music are left out, as the audio players need to be handed actual file paths.
+///
+///  Host build:
+///      c++ -std=c++17 -I../../StarBird -I../../StarBird/utils main.cpp ../../StarBird/resloading/AssetArchive.cpp -o AssetPacker
+///
+///  Usage:
+///      AssetPacker <res_dir> [--verify] [--remove-packed]
+///          --verify         mount the written archive and compare every packed file against its source
+///          --remove-packed  delete the loose copies of the packed files afterwards (used by the
+///                           Cook Assets build phase on the res folder copied in to the app bundle)
+///------------------------------------------------------------------------------------------------
+
+#include "resloading/AssetArchive.h"
+#include "utils/FileUtils.h"
+
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+using namespace resources;
+
+///------------------------------------------------------------------------------------------------
+
+static const std::unordered_set<std::string> EXCLUDED_DIRECTORIES = { "sounds", "music" };
+static const std::unordered_set<std::string> EXCLUDED_FILE_NAMES = { "Thumbs.db", ".DS_Store", asset_archive::ASSET_ARCHIVE_FILE_NAME };
+static const std::unordered_set<std::string> EXCLUDED_EXTENSIONS = { "pdn", "tmp" };
+
+///------------------------------------------------------------------------------------------------
+
+static bool IsDirectory(const std::string& path)
+{
+    DIR* dir = opendir(path.c_str());
+    if (dir)
+    {
+        closedir(dir);
+        return true;
+    }
+    return false;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void CollectFiles(const std::string& rootDirectory, const std::string& relativeDirectory, std::vector<std::string>& outRelativeFilePaths)
+{
+    for (const auto& fileName: fileutils::GetAllFilenamesInDirectory(rootDirectory + relativeDirectory))
+    {
+        const auto relativePath = relativeDirectory + fileName;
+        if (IsDirectory(rootDirectory + relativePath))
+        {
+            if (EXCLUDED_DIRECTORIES.count(fileName) == 0)
+            {
+                CollectFiles(rootDirectory, relativePath + "/", outRelativeFilePaths);
+            }
+        }
+        else if (EXCLUDED_FILE_NAMES.count(fileName) == 0 && EXCLUDED_EXTENSIONS.count(fileutils::GetFileExtension(fileName)) == 0)
+        {
+            outRelativeFilePaths.push_back(relativePath);
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+static int VerifyArchive(const std::string& archivePath, const std::string& rootDirectory, const std::vector<std::string>& relativeFilePaths)
+{
+    if (!AssetArchive::GetInstance().Mount(archivePath, rootDirectory))
+    {
+        printf("[ERROR] Could not mount %s\n", archivePath.c_str());
+        return 1;
+    }
+    
+    int failures = 0;
+    for (const auto& relativePath: relativeFilePaths)
+    {
+        std::ifstream sourceFile(rootDirectory + relativePath, std::ios::binary);
+        const std::string sourceContents((std::istreambuf_iterator<char>(sourceFile)), std::istreambuf_iterator<char>());
+        
+        const char* packedData = nullptr;
+        size_t packedSize = 0;
+        if (!AssetArchive::GetInstance().FindFile(rootDirectory + relativePath, packedData, packedSize) ||
+            packedSize != sourceContents.size() ||
+            std::memcmp(packedData, sourceContents.data(), packedSize) != 0 ||
+            packedData[packedSize] != '\0')
+        {
+            printf("[ERROR] Packed contents of %s do not match the source file\n", relativePath.c_str());
+            failures++;
+        }
+    }
+    
+    AssetArchive::GetInstance().Unmount();
+    return failures;
+}
+
+///------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <res_dir> [--verify] [--remove-packed]\n", argv[0]);
+        return 1;
+    }
+    
+    bool verify = false;
+    bool removePacked = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        verify |= std::string(argv[i]) == "--verify";
+        removePacked |= std::string(argv[i]) == "--remove-packed";
+    }
+    
+    auto rootDirectory = std::string(argv[1]);
+    if (rootDirectory.back() != '/')
+    {
+        rootDirectory += "/";
+    }
+    
+    std::vector<std::string> relativeFilePaths;
+    CollectFiles(rootDirectory, "", relativeFilePaths);
+    
+    const auto archivePath = rootDirectory + asset_archive::ASSET_ARCHIVE_FILE_NAME;
+    std::string error;
+    if (!asset_archive::WriteAssetArchive(archivePath, rootDirectory, relativeFilePaths, error))
+    {
+        printf("[ERROR] Could not write %s: %s\n", archivePath.c_str(), error.c_str());
+        return 1;
+    }
+    
+    std::ifstream archiveFile(archivePath, std::ios::binary | std::ios::ate);
+    printf("[INFO] Packed %zu files in to %s (%lld KB)\n", relativeFilePaths.size(), archivePath.c_str(), static_cast<long long>(archiveFile.tellg())/1024);
+    
+    if (verify)
+    {
+        const auto failures = VerifyArchive(archivePath, rootDirectory, relativeFilePaths);
+        printf("[INFO] Verified %zu files, %d mismatch(es)\n", relativeFilePaths.size(), failures);
+        if (failures != 0)
+        {
+            return 1;
+        }
+    }
+    
+    // The game reads packed files from the archive only, so their loose copies would just ship twice
+    if (removePacked)
+    {
+        for (const auto& relativePath: relativeFilePaths)
+        {
+            std::remove((rootDirectory + relativePath).c_str());
+        }
+        printf("[INFO] Removed %zu packed loose files\n", relativeFilePaths.size());
+    }
+    
+    return 0;
+}
+
+///------------------------------------------------------------------------------------------------
@@ -0,0 +1,194 @@
+///------------------------------------------------------------------------------------------------
+///  main.cpp
+///  DataCompiler
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+///  Offline compile step for the game's XML data files. Walks the data directory of the given res
+///  directory, validates every XML file found under it and compiles them all in to a single binary
+///  bundle (res/data/game_data.bin), which the game mounts on startup and builds its data loaders'
+///  element trees from, instead of parsing the XML. The Cook Assets build phase (Tools/cook_assets.sh)
+///  runs it right before AssetPacker, so that the bundle gets packed too. The XML files remain the
+///  source of truth (and the fallback) during development, and each bundled file records the hash of
+///  the source it was compiled from, so that stale entries are never served.
+///
+///  Host build:
+///      c++ -std=c++17 -I../../StarBird -I../../StarBird/utils -I../../ThirdParty main.cpp ../../StarBird/game/dataloaders/GameDataBundle.cpp ../../StarBird/resloading/AssetArchive.cpp -o DataCompiler
+///
+///  Usage:
+///      DataCompiler <res_dir> [--verify]
+///          --verify  mount the written bundle and compare every file's element tree against its source
+///------------------------------------------------------------------------------------------------
+
+#include "game/dataloaders/GameDataBundle.h"
+#include "utils/FileUtils.h"
+
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+static bool IsDirectory(const std::string& path)
+{
+    DIR* dir = opendir(path.c_str());
+    if (dir)
+    {
+        closedir(dir);
+        return true;
+    }
+    return false;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static void CollectXmlFiles(const std::string& rootDirectory, const std::string& relativeDirectory, std::vector<std::string>& outRelativeFilePaths)
+{
+    for (const auto& fileName: fileutils::GetAllFilenamesInDirectory(rootDirectory + relativeDirectory))
+    {
+        const auto relativePath = relativeDirectory + fileName;
+        if (IsDirectory(rootDirectory + relativePath))
+        {
+            CollectXmlFiles(rootDirectory, relativePath + "/", outRelativeFilePaths);
+        }
+        else if (fileutils::GetFileExtension(fileName) == "xml")
+        {
+            outRelativeFilePaths.push_back(relativePath);
+        }
+    }
+}
+
+///------------------------------------------------------------------------------------------------
+
+static bool AreTreesEqual(const rapidxml::xml_node<>* lhs, const rapidxml::xml_node<>* rhs)
+{
+    if (std::strcmp(lhs->name(), rhs->name()) != 0 || std::strcmp(lhs->value(), rhs->value()) != 0)
+    {
+        return false;
+    }
+
+    auto* lhsAttribute = lhs->first_attribute();
+    auto* rhsAttribute = rhs->first_attribute();
+    for (; lhsAttribute && rhsAttribute; lhsAttribute = lhsAttribute->next_attribute(), rhsAttribute = rhsAttribute->next_attribute())
+    {
+        if (std::strcmp(lhsAttribute->name(), rhsAttribute->name()) != 0 || std::strcmp(lhsAttribute->value(), rhsAttribute->value()) != 0)
+        {
+            return false;
+        }
+    }
+
+    if (lhsAttribute || rhsAttribute)
+    {
+        return false;
+    }
+
+    // The bundle only holds elements, so skip over any other nodes of the source
+    auto nextElement = [](const rapidxml::xml_node<>* node)
+    {
+        while (node && node->type() != rapidxml::node_element) node = node->next_sibling();
+        return node;
+    };
+
+    auto* lhsChild = nextElement(lhs->first_node());
+    auto* rhsChild = nextElement(rhs->first_node());
+    for (; lhsChild && rhsChild; lhsChild = nextElement(lhsChild->next_sibling()), rhsChild = nextElement(rhsChild->next_sibling()))
+    {
+        if (!AreTreesEqual(lhsChild, rhsChild))
+        {
+            return false;
+        }
+    }
+
+    return lhsChild == nullptr && rhsChild == nullptr;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static int VerifyBundle(const std::string& bundlePath, const std::string& dataRootDirectory, const std::vector<std::string>& relativeFilePaths)
+{
+    std::string error;
+    if (!GameDataBundle::GetInstance().Mount(bundlePath, error))
+    {
+        printf("[ERROR] Could not mount %s: %s\n", bundlePath.c_str(), error.c_str());
+        return 1;
+    }
+
+    int failures = 0;
+    for (const auto& relativePath: relativeFilePaths)
+    {
+        std::ifstream sourceFile(dataRootDirectory + relativePath, std::ios::binary);
+        std::vector<char> sourceContents((std::istreambuf_iterator<char>(sourceFile)), std::istreambuf_iterator<char>());
+        sourceContents.push_back('\0');
+
+        rapidxml::xml_document<> sourceDoc;
+        sourceDoc.parse<0>(sourceContents.data());
+
+        rapidxml::xml_document<> bundleDoc;
+        if (!GameDataBundle::GetInstance().BuildDocument(relativePath, bundleDoc) || !AreTreesEqual(sourceDoc.first_node(), bundleDoc.first_node()))
+        {
+            printf("[ERROR] Bundled element tree of %s does not match the source file\n", relativePath.c_str());
+            failures++;
+        }
+    }
+
+    GameDataBundle::GetInstance().Unmount();
+    return failures;
+}
+
+///------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <res_dir> [--verify]\n", argv[0]);
+        return 1;
+    }
+
+    bool verify = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        verify |= std::string(argv[i]) == "--verify";
+    }
+
+    auto dataRootDirectory = std::string(argv[1]);
+    if (dataRootDirectory.back() != '/')
+    {
+        dataRootDirectory += "/";
+    }
+    dataRootDirectory += "data/";
+
+    std::vector<std::string> relativeFilePaths;
+    CollectXmlFiles(dataRootDirectory, "", relativeFilePaths);
+
+    const auto bundlePath = dataRootDirectory + game_data_bundle::GAME_DATA_BUNDLE_FILE_NAME;
+    std::vector<std::string> errors;
+    if (!game_data_bundle::CompileGameDataBundle(bundlePath, dataRootDirectory, relativeFilePaths, errors))
+    {
+        for (const auto& error: errors)
+        {
+            printf("[ERROR] %s\n", error.c_str());
+        }
+
+        printf("[ERROR] Could not compile %s\n", bundlePath.c_str());
+        return 1;
+    }
+
+    std::ifstream bundleFile(bundlePath, std::ios::binary | std::ios::ate);
+    printf("[INFO] Compiled %zu data files in to %s (%lld KB)\n", relativeFilePaths.size(), bundlePath.c_str(), static_cast<long long>(bundleFile.tellg())/1024);
+
+    if (verify)
+    {
+        const auto failures = VerifyBundle(bundlePath, dataRootDirectory, relativeFilePaths);
+        printf("[INFO] Verified %zu files, %d mismatch(es)\n", relativeFilePaths.size(), failures);
+        return failures == 0 ? 0 : 1;
+    }
+
+    return 0;
+}
+
+///------------------------------------------------------------------------------------------------
@@ -0,0 +1,89 @@
+///------------------------------------------------------------------------------------------------
+///  HeadlessInstancesTest.cpp
+///  StarBirdHeadless
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+///  Runs several headless game instances at once, each on its own thread, and checks that every
+///  one of them ends up exactly where the same level ends up when run on its own. Instances share
+///  the process-wide loaded data (resources, definitions, fonts, wave blocks, data bundle), so any
+///  instance stepping on another's shows up as a digest mismatch (or a crash).
+///------------------------------------------------------------------------------------------------
+
+#include "Game.h"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+static const int TEST_SEED = 7;
+static const int TEST_FRAME_COUNT = 1500;
+static const int INSTANCES_PER_LEVEL = 2;
+
+///------------------------------------------------------------------------------------------------
+
+static Game::HeadlessResult RunLevel(const Game::HeadlessParameters& headlessParameters)
+{
+    Game game(headlessParameters);
+    return game.GetHeadlessResult();
+}
+
+///------------------------------------------------------------------------------------------------
+
+static bool AreResultsIdentical(const Game::HeadlessResult& lhs, const Game::HeadlessResult& rhs)
+{
+    return lhs.mSimulatedFrameCount == rhs.mSimulatedFrameCount && lhs.mSceneObjectsDigest == rhs.mSceneObjectsDigest && lhs.mSimulationDigest == rhs.mSimulationDigest;
+}
+
+///------------------------------------------------------------------------------------------------
+
+int main()
+{
+    const std::vector<Game::HeadlessParameters> levels =
+    {
+        { TEST_SEED, TEST_FRAME_COUNT, MapCoord(1, 1), Map::NodeType::NORMAL_ENCOUNTER },
+        { TEST_SEED, TEST_FRAME_COUNT, MapCoord(1, 0), Map::NodeType::HARD_ENCOUNTER },
+        { TEST_SEED, TEST_FRAME_COUNT, MapCoord(3, 2), Map::NodeType::BOSS_ENCOUNTER }
+    };
+    
+    // Reference results, one instance at a time
+    std::vector<Game::HeadlessResult> referenceResults;
+    for (const auto& level: levels)
+    {
+        referenceResults.push_back(RunLevel(level));
+    }
+    
+    // All levels at once, with more than one instance of each so that instances of the same level overlap too
+    std::vector<Game::HeadlessResult> concurrentResults(levels.size() * INSTANCES_PER_LEVEL);
+    std::vector<std::thread> instanceThreads;
+    for (size_t i = 0; i < concurrentResults.size(); ++i)
+    {
+        instanceThreads.emplace_back([&, i]()
+        {
+            concurrentResults[i] = RunLevel(levels[i % levels.size()]);
+        });
+    }
+    
+    for (auto& instanceThread: instanceThreads)
+    {
+        instanceThread.join();
+    }
+    
+    auto failureCount = 0;
+    for (size_t i = 0; i < concurrentResults.size(); ++i)
+    {
+        const auto& referenceResult = referenceResults[i % levels.size()];
+        const auto& concurrentResult = concurrentResults[i];
+        
+        if (!AreResultsIdentical(referenceResult, concurrentResult))
+        {
+            std::printf("FAIL instance %d of level %d diverged from its reference run:\n%s\nvs\n%s\n", static_cast<int>(i / levels.size()), static_cast<int>(i % levels.size()), referenceResult.mReport.c_str(), concurrentResult.mReport.c_str());
+            failureCount++;
+        }
+    }
+    
+    std::printf("%d/%d concurrent instances matched their reference runs\n", static_cast<int>(concurrentResults.size()) - failureCount, static_cast<int>(concurrentResults.size()));
+    return failureCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+///------------------------------------------------------------------------------------------------
+///  ObjectiveCUtilsStub.cpp
+///  StarBirdHeadless
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+///  Stands in for ObjectiveCUtils.mm on non-Apple hosts. Headless runs never initialize audio
+///  or haptics, so all of those are no-ops here.
+///------------------------------------------------------------------------------------------------
+
+#include "ObjectiveCUtils.h"
+
+#include <cstdlib>
+
+///------------------------------------------------------------------------------------------------
+
+void objectiveC_utils::Vibrate()
+{
+}
+
+///------------------------------------------------------------------------------------------------
+
+void objectiveC_utils::PreloadSfx(const std::string&)
+{
+}
+
+///------------------------------------------------------------------------------------------------
+
+void objectiveC_utils::PlaySound(const std::string&, const bool /* = false */)
+{
+}
+
+///------------------------------------------------------------------------------------------------
+
+void objectiveC_utils::InitAudio(const std::string&)
+{
+}
+
+///------------------------------------------------------------------------------------------------
+
+void objectiveC_utils::ResumeAudio()
+{
+}
+
+///------------------------------------------------------------------------------------------------
+
+void objectiveC_utils::PauseMusicOnly()
+{
+}
+
+///------------------------------------------------------------------------------------------------
+
+void objectiveC_utils::PauseSfxOnly()
+{
+}
+
+///------------------------------------------------------------------------------------------------
+
+void objectiveC_utils::PauseAudio()
+{
+}
+
+///------------------------------------------------------------------------------------------------
+
+void objectiveC_utils::UpdateAudio(const float)
+{
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::string objectiveC_utils::GetLocalFileSaveLocation()
+{
+    const auto* homeDirectory = getenv("HOME");
+    return std::string(homeDirectory ? homeDirectory : ".") + "/Documents/";
+}
+
+///------------------------------------------------------------------------------------------------
+
+std::string objectiveC_utils::BuildLocalFileSaveLocation(const std::string& fileName)
+{
+    return GetLocalFileSaveLocation() + fileName;
+}
+
+///------------------------------------------------------------------------------------------------
@@ -0,0 +1,19 @@
+///------------------------------------------------------------------------------------------------
+///  gl.h
+///  StarBirdHeadless
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+///  Maps the iOS OpenGLES framework header on to the Khronos one for non-Apple host builds.
+///------------------------------------------------------------------------------------------------
+
+#ifndef StarBirdHeadless_gl_h
+#define StarBirdHeadless_gl_h
+
+///------------------------------------------------------------------------------------------------
+
+#include <GLES3/gl3.h>
+
+///------------------------------------------------------------------------------------------------
+
+#endif /* StarBirdHeadless_gl_h */
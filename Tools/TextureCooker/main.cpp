@@ -0,0 +1,170 @@
+///------------------------------------------------------------------------------------------------
+///  main.cpp
+///  TextureCooker
+///
+///  Created by Alex Koukoulas on 18/10/2026.
+///------------------------------------------------------------------------------------------------
+///  Offline cook step for the game's textures. Walks the given texture directory and writes a
+///  cooked texture container (.ctx) next to every .bmp found, holding ETC2 (or narrower lossless
+///  formats when possible, or whatever a .fmt sidecar file overrides the format to), the pre-baked
+///  mip chain (for textures flagged with "mm") and the embedded .mtd sprite sheet metadata. At
+///  runtime TextureLoader picks up the .ctx in place of the .bmp whenever one is present.
+///
+///  Host build (requires SDL2):
+///      c++ -std=c++17 -I../../StarBird -I../../StarBird/utils main.cpp ../../StarBird/resloading/CookedTexture.cpp ../../StarBird/resloading/AssetArchive.cpp `sdl2-config --cflags --libs` -o TextureCooker
+///
+///  Usage:
+///      TextureCooker <textures_dir> [--raw] [--verify]
+///          --raw     store uncompressed payloads instead of ETC2
+///          --verify  decode every cooked texture back and report its mean absolute error
+///------------------------------------------------------------------------------------------------
+
+#include "resloading/CookedTexture.h"
+#include "utils/FileUtils.h"
+#include "utils/StringUtils.h"
+
+#include <cmath>
+#include <cstdio>
+#include <dirent.h>
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+///------------------------------------------------------------------------------------------------
+
+using namespace resources;
+
+///------------------------------------------------------------------------------------------------
+
+static bool IsDirectory(const std::string& path)
+{
+    DIR* dir = opendir(path.c_str());
+    if (dir)
+    {
+        closedir(dir);
+        return true;
+    }
+    return false;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static bool CookTextureFile(const std::string& bmpPath, const bool raw, const bool verify)
+{
+    SDL_Surface* loadedSurface = SDL_LoadBMP(bmpPath.c_str());
+    if (!loadedSurface)
+    {
+        printf("[ERROR] Could not load %s: %s\n", bmpPath.c_str(), SDL_GetError());
+        return false;
+    }
+    
+    SDL_Surface* rgbaSurface = SDL_ConvertSurfaceFormat(loadedSurface, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loadedSurface);
+    
+    const auto width = static_cast<uint32_t>(rgbaSurface->w);
+    const auto height = static_cast<uint32_t>(rgbaSurface->h);
+    
+    // Tightly pack the rows (surfaces may have a pitch larger than width * 4)
+    std::vector<unsigned char> rgbaPixels(width * height * 4);
+    bool opaque = true;
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        const auto* row = static_cast<const unsigned char*>(rgbaSurface->pixels) + y * rgbaSurface->pitch;
+        std::copy(row, row + width * 4, &rgbaPixels[y * width * 4]);
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            opaque &= row[x * 4 + 3] == 0xFF;
+        }
+    }
+    SDL_FreeSurface(rgbaSurface);
+    
+    const auto fileNameWithoutExtension = fileutils::GetFileNameWithoutExtension(bmpPath);
+    const auto basePath = bmpPath.substr(0, bmpPath.size() - fileutils::GetFileExtension(bmpPath).size());
+    
+    std::vector<SheetRowDescriptor> sheetRows;
+    texture_cooking::ReadSheetMetadataFile(basePath + "mtd", sheetRows);
+    
+    // Per asset overrides win, followed by any narrower format that stores the texture losslessly
+    // (grayscale masks, font atlases etc..). Anything else gets block compressed.
+    CookedTextureFormat format;
+    if (!texture_cooking::ReadFormatOverrideFile(basePath + texture_cooking::FORMAT_OVERRIDE_EXTENSION, format))
+    {
+        format = texture_cooking::SelectNarrowestLosslessFormat(rgbaPixels.data(), width, height);
+        if (format == CookedTextureFormat::RGBA8 && !raw)
+        {
+            format = opaque ? CookedTextureFormat::ETC2_RGB8 : CookedTextureFormat::ETC2_RGBA8_EAC;
+        }
+    }
+    const auto generateMipMaps = strutils::StringContains(fileNameWithoutExtension, "mm");
+    
+    const auto cookedTexture = texture_cooking::CookTexture(rgbaPixels.data(), width, height, format, generateMipMaps, sheetRows);
+    const auto cookedTexturePath = basePath + texture_cooking::COOKED_TEXTURE_EXTENSION;
+    if (!texture_cooking::WriteCookedTexture(cookedTexturePath, cookedTexture))
+    {
+        printf("[ERROR] Could not write %s\n", cookedTexturePath.c_str());
+        return false;
+    }
+    
+    size_t cookedSize = 0;
+    for (const auto& mipLevel: cookedTexture.mMipLevels) cookedSize += mipLevel.size();
+    
+    printf("[INFO] %s: %ux%u, %zu mip(s), format=%u, %zu KB (RGBA8 base level: %u KB)", cookedTexturePath.c_str(), width, height, cookedTexture.mMipLevels.size(), static_cast<uint32_t>(format), cookedSize/1024, width * height * 4/1024);
+    
+    if (verify)
+    {
+        const auto decodedPixels = texture_cooking::DecodeMipLevelToRGBA8(cookedTexture, 0);
+        double totalError = 0.0;
+        for (size_t i = 0; i < decodedPixels.size(); ++i)
+        {
+            totalError += std::abs(static_cast<int>(decodedPixels[i]) - static_cast<int>(rgbaPixels[i]));
+        }
+        printf(" mean abs error=%.2f", totalError/decodedPixels.size());
+    }
+    
+    printf("\n");
+    return true;
+}
+
+///------------------------------------------------------------------------------------------------
+
+static int CookDirectory(const std::string& directory, const bool raw, const bool verify)
+{
+    int failures = 0;
+    for (const auto& fileName: fileutils::GetAllFilenamesInDirectory(directory))
+    {
+        const auto path = directory + "/" + fileName;
+        if (IsDirectory(path))
+        {
+            failures += CookDirectory(path, raw, verify);
+        }
+        else if (fileutils::GetFileExtension(fileName) == "bmp")
+        {
+            failures += CookTextureFile(path, raw, verify) ? 0 : 1;
+        }
+    }
+    
+    return failures;
+}
+
+///------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <textures_dir> [--raw] [--verify]\n", argv[0]);
+        return 1;
+    }
+    
+    bool raw = false;
+    bool verify = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        raw |= std::string(argv[i]) == "--raw";
+        verify |= std::string(argv[i]) == "--verify";
+    }
+    
+    return CookDirectory(argv[1], raw, verify) == 0 ? 0 : 1;
+}
+
+///------------------------------------------------------------------------------------------------
@@ -0,0 +1,58 @@
+#!/bin/sh
+##------------------------------------------------------------------------------------------------
+##  cook_assets.sh
+##  StarBird
+##
+##  Created by Alex Koukoulas on 18/10/2026.
+##------------------------------------------------------------------------------------------------
+##  Run Script build phase of the StarBird target, run after Copy Bundle Resources. Builds the
+##  offline asset tools for the host and runs them over the res folder copied in to the app
+##  bundle, so that the source res folder is never modified and the bundle only ships the
+##  cooked assets:
+##      1. TextureCooker writes a .ctx next to every .bmp, after which the .bmp files and their
+##         .fmt sidecars are removed from the bundle (the .mtd ones still mark sprite sheets).
+##      2. DataCompiler compiles the XML data files in to res/data/game_data.bin.
+##      3. AssetPacker packs the bundled res folder in to res/assets.pak and removes the loose
+##         copies of everything it packed. Sounds and music stay loose.
+##
+##  Can also be run by hand against an already built bundle:
+##      SRCROOT=<repo> DERIVED_FILE_DIR=<tmp> BUNDLED_RES_DIR=<app>/res sh Tools/cook_assets.sh
+##------------------------------------------------------------------------------------------------
+
+set -e
+
+TOOLS_DIR="${SRCROOT}/Tools"
+TOOLS_BUILD_DIR="${DERIVED_FILE_DIR}/AssetTools"
+BUNDLED_RES_DIR="${BUNDLED_RES_DIR:-${TARGET_BUILD_DIR}/${UNLOCALIZED_RESOURCES_FOLDER_PATH}/res}"
+
+# The tools run on the build machine, not the device
+HOST_CXX="${HOST_CXX:-xcrun --sdk macosx clang++}"
+HOST_CXX_FLAGS="-std=c++17 -O2 -I${SRCROOT}/StarBird -I${SRCROOT}/StarBird/utils"
+
+mkdir -p "${TOOLS_BUILD_DIR}"
+
+##------------------------------------------------------------------------------------------------
+
+# Textures. The cooker decodes the bmps via a host SDL2. Without one the bmps are shipped as is,
+# and TextureLoader uploads them uncompressed.
+if command -v sdl2-config > /dev/null 2>&1; then
+    ${HOST_CXX} ${HOST_CXX_FLAGS} "${TOOLS_DIR}/TextureCooker/main.cpp" "${SRCROOT}/StarBird/resloading/CookedTexture.cpp" "${SRCROOT}/StarBird/resloading/AssetArchive.cpp" $(sdl2-config --cflags --libs) -o "${TOOLS_BUILD_DIR}/TextureCooker"
+    "${TOOLS_BUILD_DIR}/TextureCooker" "${BUNDLED_RES_DIR}/textures"
+    find "${BUNDLED_RES_DIR}/textures" \( -name "*.bmp" -o -name "*.fmt" \) -delete
+else
+    echo "warning: sdl2-config not found, shipping uncooked textures"
+fi
+
+##------------------------------------------------------------------------------------------------
+
+# Game data. The XML sources still get packed next to the bundle, as the fallback while hot
+# reloading and as what the bundle's entries are checked against for staleness.
+${HOST_CXX} ${HOST_CXX_FLAGS} -I"${SRCROOT}/ThirdParty" "${TOOLS_DIR}/DataCompiler/main.cpp" "${SRCROOT}/StarBird/game/dataloaders/GameDataBundle.cpp" "${SRCROOT}/StarBird/resloading/AssetArchive.cpp" -o "${TOOLS_BUILD_DIR}/DataCompiler"
+"${TOOLS_BUILD_DIR}/DataCompiler" "${BUNDLED_RES_DIR}" --verify
+
+##------------------------------------------------------------------------------------------------
+
+# Pack last, so that the archive holds the outputs of all of the steps above
+${HOST_CXX} ${HOST_CXX_FLAGS} "${TOOLS_DIR}/AssetPacker/main.cpp" "${SRCROOT}/StarBird/resloading/AssetArchive.cpp" -o "${TOOLS_BUILD_DIR}/AssetPacker"
+"${TOOLS_BUILD_DIR}/AssetPacker" "${BUNDLED_RES_DIR}" --verify --remove-packed
+find "${BUNDLED_RES_DIR}" \( -name ".DS_Store" -o -name "Thumbs.db" -o -name "*.pdn" \) -delete